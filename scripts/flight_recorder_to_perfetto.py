@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+# Copyright 2026, Collabora, Ltd.
+# SPDX-License-Identifier: BSL-1.0
+"""
+Convert a flight recorder dump (see u_flight_recorder.h) to a JSON trace.
+
+The output uses the Chrome trace event format, which the Perfetto UI at
+https://ui.perfetto.dev opens directly.
+"""
+
+import argparse
+import json
+import struct
+import sys
+from pathlib import Path
+
+HEADER = struct.Struct("<8sIIqq")
+THREAD = struct.Struct("<II16s")
+EVENT = struct.Struct("<qqqIHH")
+
+MAGIC = b"xrtfrec\0"
+VERSION = 1
+
+# Must match enum u_fr_event_type.
+COMP_POINT = 1
+COMP_PRESENT = 2
+COMP_GPU = 3
+APP_POINT = 4
+APP_DELIVERED = 5
+APP_GPU_DONE = 6
+IPC_BEGIN = 7
+IPC_END = 8
+COMP_MISS = 9
+APP_MISS = 10
+
+# Must match enum u_timing_point.
+TIMING_POINTS = ["wake_up", "begin", "submit_begin", "submit_end", "squash_submit_end", "late_warp_wake_up"]
+
+# Synthetic tracks, real threads use their index.
+PID = 1
+GPU_TID = 100000
+PRESENT_TID = 100001
+APP_TID_BASE = 200000
+
+
+def load_ipc_names(proto_path):
+    """Command ids are IPC_ERR followed by the calls in proto.json order."""
+    with open(proto_path, encoding="utf-8") as f:
+        proto = json.load(f)
+    names = ["IPC_ERR"]
+    names.extend(name for name in proto if not name.startswith("$"))
+    return names
+
+
+def read_dump(path):
+    data = Path(path).read_bytes()
+    magic, version, thread_count, trigger_ns, window_ns = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise ValueError("%s is not a flight recorder dump" % path)
+    if version != VERSION:
+        raise ValueError("Unsupported flight recorder version %d" % version)
+
+    offset = HEADER.size
+    threads = []
+    for _ in range(thread_count):
+        index, count, name = THREAD.unpack_from(data, offset)
+        offset += THREAD.size
+        events = [EVENT.unpack_from(data, offset + i * EVENT.size) for i in range(count)]
+        offset += count * EVENT.size
+        threads.append((index, name.split(b"\0", 1)[0].decode(errors="replace"), events))
+
+    return trigger_ns, window_ns, threads
+
+
+def us(ns, base_ns):
+    return (ns - base_ns) / 1000.0
+
+
+def convert(path, ipc_names):
+    trigger_ns, window_ns, threads = read_dump(path)
+    base_ns = trigger_ns - window_ns
+    out = []
+
+    def meta(tid, name):
+        out.append({"ph": "M", "name": "thread_name", "pid": PID, "tid": tid, "args": {"name": name}})
+
+    meta(GPU_TID, "Compositor GPU")
+    meta(PRESENT_TID, "Compositor present")
+    sessions = set()
+
+    for index, name, events in threads:
+        meta(index, name)
+
+        # Sort so begin/end pairs nest properly.
+        for when_ns, frame_id, value, arg, kind, _ in sorted(events, key=lambda e: e[0]):
+            args = {"frame_id": frame_id}
+
+            if kind == COMP_POINT:
+                point = TIMING_POINTS[arg] if arg < len(TIMING_POINTS) else str(arg)
+                out.append({"ph": "i", "s": "t", "name": "comp " + point, "pid": PID, "tid": index,
+                            "ts": us(when_ns, base_ns), "args": args})
+            elif kind == COMP_PRESENT:
+                args["desired_present_ns"] = value
+                out.append({"ph": "X", "name": "present", "pid": PID, "tid": PRESENT_TID,
+                            "ts": us(min(value, when_ns), base_ns), "dur": abs(when_ns - value) / 1000.0,
+                            "args": args})
+            elif kind == COMP_GPU:
+                out.append({"ph": "X", "name": "gpu", "pid": PID, "tid": GPU_TID, "ts": us(when_ns, base_ns),
+                            "dur": (value - when_ns) / 1000.0, "args": args})
+            elif kind in (APP_POINT, APP_DELIVERED, APP_GPU_DONE):
+                tid = APP_TID_BASE + value
+                if value not in sessions:
+                    sessions.add(value)
+                    meta(tid, "App session %d" % value)
+                if kind == APP_POINT:
+                    label = "app " + (TIMING_POINTS[arg] if arg < len(TIMING_POINTS) else str(arg))
+                elif kind == APP_DELIVERED:
+                    label = "app delivered"
+                else:
+                    label = "app gpu done"
+                out.append({"ph": "i", "s": "t", "name": label, "pid": PID, "tid": tid,
+                            "ts": us(when_ns, base_ns), "args": args})
+            elif kind in (IPC_BEGIN, IPC_END):
+                call = ipc_names[arg] if arg < len(ipc_names) else "ipc %d" % arg
+                out.append({"ph": "B" if kind == IPC_BEGIN else "E", "name": call, "pid": PID, "tid": index,
+                            "ts": us(when_ns, base_ns), "args": {"client": value}})
+            elif kind in (COMP_MISS, APP_MISS):
+                args["missed_by_ms"] = value / 1e6
+                if kind == APP_MISS:
+                    args["session_id"] = arg
+                out.append({"ph": "i", "s": "g", "name": "MISS" if kind == COMP_MISS else "APP MISS", "pid": PID,
+                            "tid": index, "ts": us(when_ns, base_ns), "args": args})
+
+    out.append({"ph": "i", "s": "g", "name": "dump trigger", "pid": PID, "tid": 0, "ts": us(trigger_ns, base_ns)})
+
+    return {"traceEvents": out, "displayTimeUnit": "ms"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("dump", help="Flight recorder dump file (.xfr)")
+    parser.add_argument("-o", "--output", help="Output JSON file, defaults to stdout")
+    parser.add_argument("--proto", help="Path to ipc/shared/proto.json, used to name IPC calls",
+                        default=str(Path(__file__).parent.parent / "src/xrt/ipc/shared/proto.json"))
+    args = parser.parse_args()
+
+    ipc_names = []
+    if args.proto and Path(args.proto).exists():
+        ipc_names = load_ipc_names(args.proto)
+
+    trace = convert(args.dump, ipc_names)
+
+    if args.output:
+        with open(args.output, "w", encoding="utf-8") as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
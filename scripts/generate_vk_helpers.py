@@ -67,6 +67,7 @@ def get_device_cmds():
         Cmd("vkCmdSetViewport"),
         Cmd("vkCmdClearColorImage"),
         Cmd("vkCmdEndRenderPass"),
+        Cmd("vkCmdExecuteCommands"),
         Cmd("vkCmdBindDescriptorSets"),
         Cmd("vkCmdBindPipeline"),
         Cmd("vkCmdBindVertexBuffers"),
@@ -24,6 +24,15 @@ PB_BIND(VRuska Engine_metrics_SystemGpuInfo, VRuska Engine_metrics_SystemGpuInfo
 PB_BIND(VRuska Engine_metrics_SystemPresentInfo, VRuska Engine_metrics_SystemPresentInfo, AUTO)
 
 
+PB_BIND(VRuska Engine_metrics_PredictionError, VRuska Engine_metrics_PredictionError, AUTO)
+
+
+PB_BIND(VRuska Engine_metrics_SystemGpuPasses, VRuska Engine_metrics_SystemGpuPasses, AUTO)
+
+
+PB_BIND(VRuska Engine_metrics_SessionPacing, VRuska Engine_metrics_SessionPacing, AUTO)
+
+
 PB_BIND(VRuska Engine_metrics_Record, VRuska Engine_metrics_Record, AUTO)
 
 
@@ -73,6 +73,38 @@ typedef struct _VRuska Engine_metrics_SystemPresentInfo {
     uint64_t earliest_present_time_ns;
 } VRuska Engine_metrics_SystemPresentInfo;
 
+typedef struct _VRuska Engine_metrics_PredictionError {
+    uint64_t history_id;
+    uint32_t model;
+    uint64_t predicted_time_ns;
+    uint64_t horizon_ns;
+    float position_error_m;
+    float orientation_error_rad;
+} VRuska Engine_metrics_PredictionError;
+
+typedef struct _VRuska Engine_metrics_SystemGpuPasses {
+    int64_t frame_id;
+    uint64_t layers_ns;
+    uint64_t distortion_ns;
+    uint64_t clear_ns;
+    uint64_t blit_ns;
+    uint64_t total_ns;
+    float scratch_scale;
+} VRuska Engine_metrics_SystemGpuPasses;
+
+typedef struct _VRuska Engine_metrics_SessionPacing {
+    int64_t session_id;
+    int64_t frame_id;
+    bool percentile;
+    int64_t predicted_wake_up_time_ns;
+    int64_t predicted_display_time_ns;
+    int64_t app_time_ns;
+    int64_t margin_ns;
+    int64_t compositor_time_ns;
+    float miss_target;
+    float miss_rate;
+} VRuska Engine_metrics_SessionPacing;
+
 typedef struct _VRuska Engine_metrics_Record {
     pb_size_t which_record;
     union {
@@ -82,6 +114,9 @@ typedef struct _VRuska Engine_metrics_Record {
         VRuska Engine_metrics_SystemFrame system_frame;
         VRuska Engine_metrics_SystemGpuInfo system_gpu_info;
         VRuska Engine_metrics_SystemPresentInfo system_present_info;
+        VRuska Engine_metrics_PredictionError prediction_error;
+        VRuska Engine_metrics_SystemGpuPasses system_gpu_passes;
+        VRuska Engine_metrics_SessionPacing session_pacing;
     } record;
 } VRuska Engine_metrics_Record;
 
@@ -97,6 +132,9 @@ extern "C" {
 #define VRuska Engine_metrics_SystemFrame_init_default  {0, 0, 0, 0, 0, 0}
 #define VRuska Engine_metrics_SystemGpuInfo_init_default {0, 0, 0, 0}
 #define VRuska Engine_metrics_SystemPresentInfo_init_default {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
+#define VRuska Engine_metrics_PredictionError_init_default {0, 0, 0, 0, 0, 0}
+#define VRuska Engine_metrics_SystemGpuPasses_init_default {0, 0, 0, 0, 0, 0, 0}
+#define VRuska Engine_metrics_SessionPacing_init_default {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
 #define VRuska Engine_metrics_Record_init_default       {0, {VRuska Engine_metrics_Version_init_default}}
 #define VRuska Engine_metrics_Version_init_zero         {0, 0}
 #define VRuska Engine_metrics_SessionFrame_init_zero    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
@@ -104,6 +142,9 @@ extern "C" {
 #define VRuska Engine_metrics_SystemFrame_init_zero     {0, 0, 0, 0, 0, 0}
 #define VRuska Engine_metrics_SystemGpuInfo_init_zero   {0, 0, 0, 0}
 #define VRuska Engine_metrics_SystemPresentInfo_init_zero {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
+#define VRuska Engine_metrics_PredictionError_init_zero {0, 0, 0, 0, 0, 0}
+#define VRuska Engine_metrics_SystemGpuPasses_init_zero {0, 0, 0, 0, 0, 0, 0}
+#define VRuska Engine_metrics_SessionPacing_init_zero {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
 #define VRuska Engine_metrics_Record_init_zero          {0, {VRuska Engine_metrics_Version_init_zero}}
 
 /* Field tags (for use in manual encoding/decoding) */
@@ -152,12 +193,38 @@ extern "C" {
 #define VRuska Engine_metrics_SystemPresentInfo_present_margin_ns_tag 13
 #define VRuska Engine_metrics_SystemPresentInfo_actual_present_time_ns_tag 14
 #define VRuska Engine_metrics_SystemPresentInfo_earliest_present_time_ns_tag 15
+#define VRuska Engine_metrics_PredictionError_history_id_tag 1
+#define VRuska Engine_metrics_PredictionError_model_tag     2
+#define VRuska Engine_metrics_PredictionError_predicted_time_ns_tag 3
+#define VRuska Engine_metrics_PredictionError_horizon_ns_tag 4
+#define VRuska Engine_metrics_PredictionError_position_error_m_tag 5
+#define VRuska Engine_metrics_PredictionError_orientation_error_rad_tag 6
+#define VRuska Engine_metrics_SystemGpuPasses_frame_id_tag 1
+#define VRuska Engine_metrics_SystemGpuPasses_layers_ns_tag 2
+#define VRuska Engine_metrics_SystemGpuPasses_distortion_ns_tag 3
+#define VRuska Engine_metrics_SystemGpuPasses_clear_ns_tag 4
+#define VRuska Engine_metrics_SystemGpuPasses_blit_ns_tag 5
+#define VRuska Engine_metrics_SystemGpuPasses_total_ns_tag 6
+#define VRuska Engine_metrics_SystemGpuPasses_scratch_scale_tag 7
+#define VRuska Engine_metrics_SessionPacing_session_id_tag 1
+#define VRuska Engine_metrics_SessionPacing_frame_id_tag 2
+#define VRuska Engine_metrics_SessionPacing_percentile_tag 3
+#define VRuska Engine_metrics_SessionPacing_predicted_wake_up_time_ns_tag 4
+#define VRuska Engine_metrics_SessionPacing_predicted_display_time_ns_tag 5
+#define VRuska Engine_metrics_SessionPacing_app_time_ns_tag 6
+#define VRuska Engine_metrics_SessionPacing_margin_ns_tag 7
+#define VRuska Engine_metrics_SessionPacing_compositor_time_ns_tag 8
+#define VRuska Engine_metrics_SessionPacing_miss_target_tag 9
+#define VRuska Engine_metrics_SessionPacing_miss_rate_tag 10
 #define VRuska Engine_metrics_Record_version_tag        1
 #define VRuska Engine_metrics_Record_session_frame_tag  2
 #define VRuska Engine_metrics_Record_used_tag           3
 #define VRuska Engine_metrics_Record_system_frame_tag   4
 #define VRuska Engine_metrics_Record_system_gpu_info_tag 5
 #define VRuska Engine_metrics_Record_system_present_info_tag 6
+#define VRuska Engine_metrics_Record_prediction_error_tag 7
+#define VRuska Engine_metrics_Record_system_gpu_passes_tag 8
+#define VRuska Engine_metrics_Record_session_pacing_tag 9
 
 /* Struct field encoding specification for nanopb */
 #define VRuska Engine_metrics_Version_FIELDLIST(X, a) \
@@ -229,13 +296,51 @@ X(a, STATIC,   SINGULAR, UINT64,   earliest_present_time_ns,  15)
 #define VRuska Engine_metrics_SystemPresentInfo_CALLBACK NULL
 #define VRuska Engine_metrics_SystemPresentInfo_DEFAULT NULL
 
+#define VRuska Engine_metrics_PredictionError_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT64,   history_id,        1) \
+X(a, STATIC,   SINGULAR, UINT32,   model,             2) \
+X(a, STATIC,   SINGULAR, UINT64,   predicted_time_ns,   3) \
+X(a, STATIC,   SINGULAR, UINT64,   horizon_ns,        4) \
+X(a, STATIC,   SINGULAR, FLOAT,    position_error_m,   5) \
+X(a, STATIC,   SINGULAR, FLOAT,    orientation_error_rad,   6)
+#define VRuska Engine_metrics_PredictionError_CALLBACK NULL
+#define VRuska Engine_metrics_PredictionError_DEFAULT NULL
+
+#define VRuska Engine_metrics_SystemGpuPasses_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, INT64,    frame_id,          1) \
+X(a, STATIC,   SINGULAR, UINT64,   layers_ns,         2) \
+X(a, STATIC,   SINGULAR, UINT64,   distortion_ns,     3) \
+X(a, STATIC,   SINGULAR, UINT64,   clear_ns,          4) \
+X(a, STATIC,   SINGULAR, UINT64,   blit_ns,           5) \
+X(a, STATIC,   SINGULAR, UINT64,   total_ns,          6) \
+X(a, STATIC,   SINGULAR, FLOAT,    scratch_scale,     7)
+#define VRuska Engine_metrics_SystemGpuPasses_CALLBACK NULL
+#define VRuska Engine_metrics_SystemGpuPasses_DEFAULT NULL
+
+#define VRuska Engine_metrics_SessionPacing_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, INT64,    session_id,        1) \
+X(a, STATIC,   SINGULAR, INT64,    frame_id,          2) \
+X(a, STATIC,   SINGULAR, BOOL,     percentile,        3) \
+X(a, STATIC,   SINGULAR, INT64,    predicted_wake_up_time_ns,   4) \
+X(a, STATIC,   SINGULAR, INT64,    predicted_display_time_ns,   5) \
+X(a, STATIC,   SINGULAR, INT64,    app_time_ns,       6) \
+X(a, STATIC,   SINGULAR, INT64,    margin_ns,         7) \
+X(a, STATIC,   SINGULAR, INT64,    compositor_time_ns,   8) \
+X(a, STATIC,   SINGULAR, FLOAT,    miss_target,       9) \
+X(a, STATIC,   SINGULAR, FLOAT,    miss_rate,        10)
+#define VRuska Engine_metrics_SessionPacing_CALLBACK NULL
+#define VRuska Engine_metrics_SessionPacing_DEFAULT NULL
+
 #define VRuska Engine_metrics_Record_FIELDLIST(X, a) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (record,version,record.version),   1) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (record,session_frame,record.session_frame),   2) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (record,used,record.used),   3) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (record,system_frame,record.system_frame),   4) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (record,system_gpu_info,record.system_gpu_info),   5) \
-X(a, STATIC,   ONEOF,    MESSAGE,  (record,system_present_info,record.system_present_info),   6)
+X(a, STATIC,   ONEOF,    MESSAGE,  (record,system_present_info,record.system_present_info),   6) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (record,prediction_error,record.prediction_error),   7) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (record,system_gpu_passes,record.system_gpu_passes),   8) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (record,session_pacing,record.session_pacing),   9)
 #define VRuska Engine_metrics_Record_CALLBACK NULL
 #define VRuska Engine_metrics_Record_DEFAULT NULL
 #define VRuska Engine_metrics_Record_record_version_MSGTYPE VRuska Engine_metrics_Version
@@ -244,6 +349,9 @@ X(a, STATIC,   ONEOF,    MESSAGE,  (record,system_present_info,record.system_pre
 #define VRuska Engine_metrics_Record_record_system_frame_MSGTYPE VRuska Engine_metrics_SystemFrame
 #define VRuska Engine_metrics_Record_record_system_gpu_info_MSGTYPE VRuska Engine_metrics_SystemGpuInfo
 #define VRuska Engine_metrics_Record_record_system_present_info_MSGTYPE VRuska Engine_metrics_SystemPresentInfo
+#define VRuska Engine_metrics_Record_record_prediction_error_MSGTYPE VRuska Engine_metrics_PredictionError
+#define VRuska Engine_metrics_Record_record_system_gpu_passes_MSGTYPE VRuska Engine_metrics_SystemGpuPasses
+#define VRuska Engine_metrics_Record_record_session_pacing_MSGTYPE VRuska Engine_metrics_SessionPacing
 
 extern const pb_msgdesc_t VRuska Engine_metrics_Version_msg;
 extern const pb_msgdesc_t VRuska Engine_metrics_SessionFrame_msg;
@@ -251,6 +359,9 @@ extern const pb_msgdesc_t VRuska Engine_metrics_Used_msg;
 extern const pb_msgdesc_t VRuska Engine_metrics_SystemFrame_msg;
 extern const pb_msgdesc_t VRuska Engine_metrics_SystemGpuInfo_msg;
 extern const pb_msgdesc_t VRuska Engine_metrics_SystemPresentInfo_msg;
+extern const pb_msgdesc_t VRuska Engine_metrics_PredictionError_msg;
+extern const pb_msgdesc_t VRuska Engine_metrics_SystemGpuPasses_msg;
+extern const pb_msgdesc_t VRuska Engine_metrics_SessionPacing_msg;
 extern const pb_msgdesc_t VRuska Engine_metrics_Record_msg;
 
 /* Defines for backwards compatibility with code written before nanopb-0.4.0 */
@@ -260,13 +371,19 @@ extern const pb_msgdesc_t VRuska Engine_metrics_Record_msg;
 #define VRuska Engine_metrics_SystemFrame_fields &VRuska Engine_metrics_SystemFrame_msg
 #define VRuska Engine_metrics_SystemGpuInfo_fields &VRuska Engine_metrics_SystemGpuInfo_msg
 #define VRuska Engine_metrics_SystemPresentInfo_fields &VRuska Engine_metrics_SystemPresentInfo_msg
+#define VRuska Engine_metrics_PredictionError_fields &VRuska Engine_metrics_PredictionError_msg
+#define VRuska Engine_metrics_SystemGpuPasses_fields &VRuska Engine_metrics_SystemGpuPasses_msg
+#define VRuska Engine_metrics_SessionPacing_fields &VRuska Engine_metrics_SessionPacing_msg
 #define VRuska Engine_metrics_Record_fields &VRuska Engine_metrics_Record_msg
 
 /* Maximum encoded size of messages (where known) */
+#define VRuska Engine_metrics_PredictionError_size      49
 #define VRuska Engine_metrics_Record_size               168
 #define VRuska Engine_metrics_SessionFrame_size         145
+#define VRuska Engine_metrics_SessionPacing_size        89
 #define VRuska Engine_metrics_SystemFrame_size          66
 #define VRuska Engine_metrics_SystemGpuInfo_size        44
+#define VRuska Engine_metrics_SystemGpuPasses_size      71
 #define VRuska Engine_metrics_SystemPresentInfo_size    165
 #define VRuska Engine_metrics_Used_size                 44
 #define VRuska Engine_metrics_Version_size              12
@@ -60,6 +60,56 @@ class PathsByLengthCollector:
         return ret
 
 
+def fnv1a_32(string, seed):
+    """FNV-1a, must match the generated b_fnv1a_32 function."""
+    h = (2166136261 ^ seed) & 0xffffffff
+    for c in string.encode("utf-8"):
+        h ^= c
+        h = (h * 16777619) & 0xffffffff
+    return h
+
+
+class PerfectHash:
+    """Hash and displace minimal perfect hash over a set of strings, lookups
+    are two hashes, one table read and a single strcmp.
+    """
+
+    def __init__(self, keys):
+        self.keys = sorted(set(keys))
+        size = len(self.keys)
+        self.seeds = [0] * size
+        self.slots = [None] * size
+
+        buckets = [[] for _ in range(size)]
+        for key in self.keys:
+            buckets[fnv1a_32(key, 0) % size].append(key)
+
+        # Place the biggest buckets first while there is most room.
+        order = sorted(range(size), key=lambda i: len(buckets[i]), reverse=True)
+        for bucket_index in order:
+            bucket = buckets[bucket_index]
+            if len(bucket) == 0:
+                break
+
+            seed = 1
+            while True:
+                indices = [fnv1a_32(key, seed) % size for key in bucket]
+                if len(set(indices)) == len(indices) and \
+                        all(self.slots[i] is None for i in indices):
+                    break
+                seed += 1
+
+            self.seeds[bucket_index] = seed
+            for key, index in zip(bucket, indices):
+                self.slots[index] = key
+
+    def lookup(self, key):
+        """Same as the generated C lookup, used to self check the table."""
+        size = len(self.keys)
+        seed = self.seeds[fnv1a_32(key, 0) % size]
+        return fnv1a_32(key, seed) % size
+
+
 def dpad_paths(identifier_path, center):
     paths = [
         identifier_path + "/dpad_up",
@@ -675,6 +725,45 @@ oxr_verify_{profile.validation_func_name}_ext(const struct oxr_extension_status
 ''')
 
 
+def write_name_functions(f, kind, names, fallback):
+    """Write the enum to string switch and the perfect hashed string to enum
+    lookup for xrt_input_name or xrt_output_name."""
+    f.write('const char *\n')
+    f.write(f'xrt_{kind}_name_string(enum xrt_{kind}_name {kind})\n')
+    f.write('{\n')
+    f.write(f'\tswitch({kind})\n')
+    f.write('\t{\n')
+    for name in names:
+        f.write(f'\tcase {name}: return "{name}";\n')
+    f.write(f'\tdefault: return "UNKNOWN";\n')
+    f.write('\t}\n')
+    f.write('}\n')
+
+    ph = PerfectHash(names)
+    size = len(ph.keys)
+    for name in names:
+        assert ph.slots[ph.lookup(name)] == name
+
+    f.write(f'\nstatic const uint32_t {kind}_name_seeds[{size}] = {{\n')
+    for i in range(0, size, 16):
+        f.write('\t' + ', '.join(str(seed) for seed in ph.seeds[i:i + 16]) + ',\n')
+    f.write('};\n')
+
+    f.write(f'\nstatic const struct {{ const char *str; enum xrt_{kind}_name value; }} {kind}_name_slots[{size}] = {{\n')
+    for name in ph.slots:
+        f.write(f'\t{{"{name}", {name}}},\n')
+    f.write('};\n\n')
+
+    f.write(f'enum xrt_{kind}_name\n')
+    f.write(f'xrt_{kind}_name_enum(const char *{kind})\n')
+    f.write('{\n')
+    f.write(f'\tuint32_t seed = {kind}_name_seeds[b_fnv1a_32({kind}, 0) % {size}];\n')
+    f.write(f'\tuint32_t index = b_fnv1a_32({kind}, seed) % {size};\n')
+    f.write(f'\tif (strcmp({kind}_name_slots[index].str, {kind}) == 0) return {kind}_name_slots[index].value;\n')
+    f.write(f'\treturn {fallback};\n')
+    f.write('}\n')
+
+
 def generate_bindings_c(file, b):
     """Generate the file to verify subpaths on a interaction profile."""
     f = open(file, "w")
@@ -760,6 +849,21 @@ def generate_bindings_c(file, b):
 
         f.write('\t\t}, // /array of binding_template\n')
 
+        # Flat list of every path of every binding, grouped by path so the
+        # runtime interns each path once and can binary search the result.
+        path_refs = []
+        for idx, component in enumerate(profile.components):
+            for path_index, path in enumerate(component.get_full_openxr_paths()):
+                path_refs.append((path, idx, path_index))
+        path_refs.sort()
+
+        f.write(f'\t\t.path_ref_count = {len(path_refs)},\n')
+        f.write(
+            f'\t\t.path_refs = (struct binding_path_ref_template[]){{ // array of binding_path_ref_template\n')
+        for path, idx, path_index in path_refs:
+            f.write(f'\t\t\t{{"{path}", {idx}, {path_index}}},\n')
+        f.write('\t\t}, // /array of binding_path_ref_template\n')
+
         dpads = []
         for idx, identifier in enumerate(profile.identifiers):
             if identifier.dpad:
@@ -827,43 +931,22 @@ def generate_bindings_c(file, b):
     inputs.add("XRT_INPUT_GENERIC_HAND_TRACKING_RIGHT")
     inputs.add("XRT_INPUT_GENERIC_TRACKER_POSE")
 
-    f.write('const char *\n')
-    f.write('xrt_input_name_string(enum xrt_input_name input)\n')
-    f.write('{\n')
-    f.write('\tswitch(input)\n')
-    f.write('\t{\n')
-    for input in sorted(inputs):
-        f.write(f'\tcase {input}: return "{input}";\n')
-    f.write(f'\tdefault: return "UNKNOWN";\n')
-    f.write('\t}\n')
-    f.write('}\n')
-
-    f.write('enum xrt_input_name\n')
-    f.write('xrt_input_name_enum(const char *input)\n')
-    f.write('{\n')
-    for input in sorted(inputs):
-        f.write(f'\tif(strcmp("{input}", input) == 0) return {input};\n')
-    f.write(f'\treturn XRT_INPUT_GENERIC_TRACKER_POSE;\n')
-    f.write('}\n')
+    f.write('''
+static inline uint32_t
+b_fnv1a_32(const char *str, uint32_t seed)
+{
+	uint32_t h = 2166136261u ^ seed;
+	for (; *str != '\\0'; str++) {
+		h ^= (uint8_t)*str;
+		h *= 16777619u;
+	}
+	return h;
+}
 
-    f.write('const char *\n')
-    f.write('xrt_output_name_string(enum xrt_output_name output)\n')
-    f.write('{\n')
-    f.write('\tswitch(output)\n')
-    f.write('\t{\n')
-    for output in sorted(outputs):
-        f.write(f'\tcase {output}: return "{output}";\n')
-    f.write(f'\tdefault: return "UNKNOWN";\n')
-    f.write('\t}\n')
-    f.write('}\n')
+''')
 
-    f.write('enum xrt_output_name\n')
-    f.write('xrt_output_name_enum(const char *output)\n')
-    f.write('{\n')
-    for output in sorted(outputs):
-        f.write(f'\tif(strcmp("{output}", output) == 0) return {output};\n')
-    f.write(f'\treturn XRT_OUTPUT_NAME_SIMPLE_VIBRATION;\n')
-    f.write('}\n')
+    write_name_functions(f, "input", sorted(inputs), "XRT_INPUT_GENERIC_TRACKER_POSE")
+    write_name_functions(f, "output", sorted(outputs), "XRT_OUTPUT_NAME_SIMPLE_VIBRATION")
 
     f.write(f'''
 
@@ -952,6 +1035,13 @@ struct dpad_emulation
 \tenum xrt_input_name activate; // Can be zero
 }};
 
+struct binding_path_ref_template
+{{
+\tconst char *path;
+\tuint32_t binding_index;
+\tuint32_t path_index;
+}};
+
 struct binding_template
 {{
 \tconst char *subaction_path;
@@ -975,6 +1065,9 @@ struct profile_template
 \tconst char *steamvr_controller_type;
 \tstruct binding_template *bindings;
 \tsize_t binding_count;
+\t//! Every path of every binding, sorted by path string.
+\tstruct binding_path_ref_template *path_refs;
+\tsize_t path_ref_count;
 \tstruct dpad_emulation *dpads;
 \tsize_t dpad_count;
 \tstruct {{
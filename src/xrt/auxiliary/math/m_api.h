@@ -799,6 +799,76 @@ void
 math_pose_transform_point(const struct xrt_pose *transform, const struct xrt_vec3 *point, struct xrt_vec3 *out_point);
 
 
+/*
+ *
+ * Batch functions, these run on arrays using SIMD where available, the best
+ * implementation for the CPU is picked at runtime, see @ref m_batch.h.
+ *
+ */
+
+/*!
+ * Apply the same rigid-body transformation to @p count poses, the result is
+ * the same as calling @ref math_pose_transform on each of them.
+ *
+ * OK if @p poses and @p out_poses are the same array.
+ *
+ * @relates xrt_pose
+ * @ingroup aux_math
+ */
+void
+math_pose_transform_batch(const struct xrt_pose *transform,
+                          const struct xrt_pose *poses,
+                          uint32_t count,
+                          struct xrt_pose *out_poses);
+
+/*!
+ * Rotate @p count quaternions by @p left, the batch version of
+ * @ref math_quat_rotate.
+ *
+ * OK if @p rights and @p out_quats are the same array.
+ *
+ * @relates xrt_quat
+ * @ingroup aux_math
+ */
+void
+math_quat_rotate_batch(const struct xrt_quat *left,
+                       const struct xrt_quat *rights,
+                       uint32_t count,
+                       struct xrt_quat *out_quats);
+
+/*!
+ * Rotate @p count vectors by @p left, the batch version of
+ * @ref math_quat_rotate_vec3.
+ *
+ * OK if @p vecs and @p out_vecs are the same array.
+ *
+ * @relates xrt_quat
+ * @ingroup aux_math
+ */
+void
+math_quat_rotate_vec3_batch(const struct xrt_quat *left,
+                            const struct xrt_vec3 *vecs,
+                            uint32_t count,
+                            struct xrt_vec3 *out_vecs);
+
+/*!
+ * Slerp @p count pairs of quaternions by the same @p t, the batch version of
+ * @ref math_quat_slerp. Uses polynomial approximations of acos and sin, the
+ * results differ from the single version by a few ulp.
+ *
+ * OK if @p out_quats is the same array as one of the inputs.
+ *
+ * @relates xrt_quat
+ * @ingroup aux_math
+ */
+void
+math_quat_slerp_batch(const struct xrt_quat *lefts,
+                      const struct xrt_quat *rights,
+                      float t,
+                      uint32_t count,
+                      struct xrt_quat *out_quats);
+
+
 /*
  *
  * Inline functions.
@@ -0,0 +1,144 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Runtime dispatch of the batch math functions.
+ * @ingroup aux_math
+ */
+
+#include "math/m_api.h"
+#include "math/m_batch.h"
+#include "util/u_debug.h"
+#include "util/u_logging.h"
+
+#include <assert.h>
+#include <string.h>
+
+
+DEBUG_GET_ONCE_OPTION(batch_isa, "MATH_BATCH_ISA", NULL)
+
+#ifdef M_BATCH_HAVE_AVX2
+static bool
+cpu_has_avx2(void)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+	return false;
+#endif
+}
+#endif
+
+static const struct m_batch_funcs *
+pick_best(void)
+{
+	const char *forced = debug_get_option_batch_isa();
+
+	if (forced != NULL) {
+		for (uint32_t i = 0; i < M_BATCH_ISA_COUNT; i++) {
+			const struct m_batch_funcs *funcs = m_batch_get_funcs((enum m_batch_isa)i);
+			if (funcs != NULL && strcmp(funcs->name, forced) == 0) {
+				return funcs;
+			}
+		}
+
+		U_LOG_W("MATH_BATCH_ISA='%s' is not available, ignoring", forced);
+	}
+
+	const enum m_batch_isa order[] = {M_BATCH_ISA_AVX2, M_BATCH_ISA_SSE2, M_BATCH_ISA_NEON};
+	for (uint32_t i = 0; i < ARRAY_SIZE(order); i++) {
+		const struct m_batch_funcs *funcs = m_batch_get_funcs(order[i]);
+		if (funcs != NULL) {
+			return funcs;
+		}
+	}
+
+	return &m_batch_funcs_scalar;
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+const struct m_batch_funcs *
+m_batch_get_funcs(enum m_batch_isa isa)
+{
+	switch (isa) {
+	case M_BATCH_ISA_SCALAR: return &m_batch_funcs_scalar;
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	case M_BATCH_ISA_SSE2: return &m_batch_funcs_sse2;
+#endif
+#ifdef M_BATCH_HAVE_AVX2
+	case M_BATCH_ISA_AVX2: return cpu_has_avx2() ? &m_batch_funcs_avx2 : NULL;
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+	case M_BATCH_ISA_NEON: return &m_batch_funcs_neon;
+#endif
+	default: return NULL;
+	}
+}
+
+const struct m_batch_funcs *
+m_batch_get_best(void)
+{
+	// Same benign race as the DEBUG_GET_ONCE functions, every thread picks the same.
+	static const struct m_batch_funcs *best = NULL;
+
+	if (best == NULL) {
+		best = pick_best();
+	}
+
+	return best;
+}
+
+void
+math_pose_transform_batch(const struct xrt_pose *transform,
+                          const struct xrt_pose *poses,
+                          uint32_t count,
+                          struct xrt_pose *out_poses)
+{
+	assert(transform != NULL);
+	assert(count == 0 || (poses != NULL && out_poses != NULL));
+
+	m_batch_get_best()->pose_transform(transform, poses, count, out_poses);
+}
+
+void
+math_quat_rotate_batch(const struct xrt_quat *left,
+                       const struct xrt_quat *rights,
+                       uint32_t count,
+                       struct xrt_quat *out_quats)
+{
+	assert(left != NULL);
+	assert(count == 0 || (rights != NULL && out_quats != NULL));
+
+	m_batch_get_best()->quat_rotate(left, rights, count, out_quats);
+}
+
+void
+math_quat_rotate_vec3_batch(const struct xrt_quat *left,
+                            const struct xrt_vec3 *vecs,
+                            uint32_t count,
+                            struct xrt_vec3 *out_vecs)
+{
+	assert(left != NULL);
+	assert(count == 0 || (vecs != NULL && out_vecs != NULL));
+
+	m_batch_get_best()->quat_rotate_vec3(left, vecs, count, out_vecs);
+}
+
+void
+math_quat_slerp_batch(const struct xrt_quat *lefts,
+                      const struct xrt_quat *rights,
+                      float t,
+                      uint32_t count,
+                      struct xrt_quat *out_quats)
+{
+	assert(count == 0 || (lefts != NULL && rights != NULL && out_quats != NULL));
+
+	m_batch_get_best()->quat_slerp(lefts, rights, t, count, out_quats);
+}
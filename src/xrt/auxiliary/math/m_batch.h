@@ -0,0 +1,112 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Per instruction set implementations of the batch math functions.
+ *
+ * The batch functions in @ref m_api.h dispatch to one of these tables, which
+ * one is picked once at runtime from what the CPU supports. The pick can be
+ * overridden with the `MATH_BATCH_ISA` environment variable, set it to the
+ * name of one of the tables. Each table is built from the same kernels in
+ * m_batch_kernels.h, the scalar one is always available.
+ *
+ * @ingroup aux_math
+ */
+
+#pragma once
+
+#include "xrt/xrt_defines.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*!
+ * Instruction sets the batch functions can be built for.
+ *
+ * @ingroup aux_math
+ */
+enum m_batch_isa
+{
+	M_BATCH_ISA_SCALAR,
+	M_BATCH_ISA_SSE2,
+	M_BATCH_ISA_AVX2,
+	M_BATCH_ISA_NEON,
+
+	M_BATCH_ISA_COUNT,
+};
+
+/*!
+ * Implementations of the batch functions for one instruction set, the
+ * function pointers have the same semantics as the matching functions in
+ * @ref m_api.h.
+ *
+ * @ingroup aux_math
+ */
+struct m_batch_funcs
+{
+	//! Name as used by the `MATH_BATCH_ISA` environment variable.
+	const char *name;
+
+	//! Number of elements processed per iteration.
+	uint32_t width;
+
+	void (*pose_transform)(const struct xrt_pose *transform,
+	                       const struct xrt_pose *poses,
+	                       uint32_t count,
+	                       struct xrt_pose *out_poses);
+
+	void (*quat_rotate)(const struct xrt_quat *left,
+	                    const struct xrt_quat *rights,
+	                    uint32_t count,
+	                    struct xrt_quat *out_quats);
+
+	void (*quat_rotate_vec3)(const struct xrt_quat *left,
+	                         const struct xrt_vec3 *vecs,
+	                         uint32_t count,
+	                         struct xrt_vec3 *out_vecs);
+
+	void (*quat_slerp)(const struct xrt_quat *lefts,
+	                   const struct xrt_quat *rights,
+	                   float t,
+	                   uint32_t count,
+	                   struct xrt_quat *out_quats);
+};
+
+/*!
+ * The tables, only the ones for the current architecture are built, see
+ * @ref m_batch_get_funcs.
+ *
+ * @ingroup aux_math
+ * @{
+ */
+extern const struct m_batch_funcs m_batch_funcs_scalar;
+extern const struct m_batch_funcs m_batch_funcs_sse2;
+extern const struct m_batch_funcs m_batch_funcs_avx2;
+extern const struct m_batch_funcs m_batch_funcs_neon;
+//! @}
+
+/*!
+ * Get the implementation for the given instruction set.
+ *
+ * @return NULL if it was not built or the CPU does not support it.
+ *
+ * @ingroup aux_math
+ */
+const struct m_batch_funcs *
+m_batch_get_funcs(enum m_batch_isa isa);
+
+/*!
+ * Get the implementation the batch functions in @ref m_api.h use.
+ *
+ * @ingroup aux_math
+ */
+const struct m_batch_funcs *
+m_batch_get_best(void);
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,61 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  AVX2 and FMA batch math, only used when the CPU supports it.
+ *
+ * This file is built with AVX2 and FMA enabled, so nothing in it may be called
+ * without checking for support first, see @ref m_batch_get_funcs.
+ *
+ * @ingroup aux_math
+ */
+
+#include "math/m_batch.h"
+
+#ifdef M_BATCH_HAVE_AVX2
+
+#include <immintrin.h>
+
+
+#define V_WIDTH 8
+#define M_BATCH_FUNCS m_batch_funcs_avx2
+#define M_BATCH_NAME "avx2"
+
+typedef __m256 vf;
+typedef __m256 vm;
+
+// clang-format off
+static inline vf v_set1(float f) { return _mm256_set1_ps(f); }
+static inline vf v_gather(const float *p, uint32_t s) {
+	return _mm256_setr_ps(p[0], p[s], p[2 * s], p[3 * s], p[4 * s], p[5 * s], p[6 * s], p[7 * s]);
+}
+static inline void v_scatter(float *p, uint32_t s, vf a) {
+	const __m128 lo = _mm256_castps256_ps128(a);
+	const __m128 hi = _mm256_extractf128_ps(a, 1);
+	_mm_store_ss(p, lo);
+	_mm_store_ss(p + s, _mm_shuffle_ps(lo, lo, 1));
+	_mm_store_ss(p + 2 * s, _mm_shuffle_ps(lo, lo, 2));
+	_mm_store_ss(p + 3 * s, _mm_shuffle_ps(lo, lo, 3));
+	_mm_store_ss(p + 4 * s, hi);
+	_mm_store_ss(p + 5 * s, _mm_shuffle_ps(hi, hi, 1));
+	_mm_store_ss(p + 6 * s, _mm_shuffle_ps(hi, hi, 2));
+	_mm_store_ss(p + 7 * s, _mm_shuffle_ps(hi, hi, 3));
+}
+static inline vf v_add(vf a, vf b) { return _mm256_add_ps(a, b); }
+static inline vf v_sub(vf a, vf b) { return _mm256_sub_ps(a, b); }
+static inline vf v_mul(vf a, vf b) { return _mm256_mul_ps(a, b); }
+static inline vf v_div(vf a, vf b) { return _mm256_div_ps(a, b); }
+static inline vf v_fmadd(vf a, vf b, vf c) { return _mm256_fmadd_ps(a, b, c); }
+static inline vf v_sqrt(vf a) { return _mm256_sqrt_ps(a); }
+static inline vf v_abs(vf a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+static inline vf v_min(vf a, vf b) { return _mm256_min_ps(a, b); }
+static inline vf v_max(vf a, vf b) { return _mm256_max_ps(a, b); }
+static inline vf v_round(vf a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+static inline vm v_lt(vf a, vf b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+static inline vm v_ge(vf a, vf b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+static inline vf v_select(vm m, vf a, vf b) { return _mm256_blendv_ps(b, a, m); }
+// clang-format on
+
+#include "m_batch_kernels.h"
+
+#endif
@@ -0,0 +1,367 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Batch math kernels, written once against a small vector layer.
+ *
+ * Not a normal header, included by the m_batch_*.c files after they have
+ * defined the vector layer for their instruction set:
+ *
+ * - `vf` a vector of @ref V_WIDTH floats and `vm` a lane mask.
+ * - `v_set1`, `v_gather`, `v_scatter`, `v_add`, `v_sub`, `v_mul`, `v_div`,
+ *   `v_fmadd` (a * b + c), `v_sqrt`, `v_abs`, `v_min`, `v_max`, `v_round`
+ *   (to nearest), `v_lt`, `v_ge` and `v_select`.
+ * - @ref M_BATCH_FUNCS the name of the table to define and
+ *   @ref M_BATCH_NAME its name string.
+ *
+ * Elements are gathered into vectors a block of @ref V_WIDTH at a time, the
+ * last partial block goes through a padded copy on the stack.
+ *
+ * @ingroup aux_math
+ */
+
+#if !defined(V_WIDTH) || !defined(M_BATCH_FUNCS) || !defined(M_BATCH_NAME)
+#error "Must define the vector layer before including this file"
+#endif
+
+#include "math/m_batch.h"
+
+#include <assert.h>
+#include <float.h>
+#include <string.h>
+
+
+#define POSE_STRIDE (sizeof(struct xrt_pose) / sizeof(float))
+#define QUAT_STRIDE (sizeof(struct xrt_quat) / sizeof(float))
+#define VEC3_STRIDE (sizeof(struct xrt_vec3) / sizeof(float))
+
+static_assert(sizeof(struct xrt_pose) == 7 * sizeof(float), "Pose must be tightly packed");
+static_assert(sizeof(struct xrt_quat) == 4 * sizeof(float), "Quat must be tightly packed");
+static_assert(sizeof(struct xrt_vec3) == 3 * sizeof(float), "Vec3 must be tightly packed");
+
+
+/*
+ *
+ * Vector helpers.
+ *
+ */
+
+struct vquat
+{
+	vf x, y, z, w;
+};
+
+struct vvec3
+{
+	vf x, y, z;
+};
+
+static inline struct vquat
+vquat_set1(const struct xrt_quat *q)
+{
+	struct vquat r = {v_set1(q->x), v_set1(q->y), v_set1(q->z), v_set1(q->w)};
+	return r;
+}
+
+static inline struct vvec3
+vvec3_set1(const struct xrt_vec3 *v)
+{
+	struct vvec3 r = {v_set1(v->x), v_set1(v->y), v_set1(v->z)};
+	return r;
+}
+
+static inline struct vquat
+vquat_gather(const float *base, uint32_t stride)
+{
+	struct vquat r = {
+	    v_gather(base + 0, stride),
+	    v_gather(base + 1, stride),
+	    v_gather(base + 2, stride),
+	    v_gather(base + 3, stride),
+	};
+	return r;
+}
+
+static inline struct vvec3
+vvec3_gather(const float *base, uint32_t stride)
+{
+	struct vvec3 r = {
+	    v_gather(base + 0, stride),
+	    v_gather(base + 1, stride),
+	    v_gather(base + 2, stride),
+	};
+	return r;
+}
+
+static inline void
+vquat_scatter(float *base, uint32_t stride, const struct vquat *q)
+{
+	v_scatter(base + 0, stride, q->x);
+	v_scatter(base + 1, stride, q->y);
+	v_scatter(base + 2, stride, q->z);
+	v_scatter(base + 3, stride, q->w);
+}
+
+static inline void
+vvec3_scatter(float *base, uint32_t stride, const struct vvec3 *v)
+{
+	v_scatter(base + 0, stride, v->x);
+	v_scatter(base + 1, stride, v->y);
+	v_scatter(base + 2, stride, v->z);
+}
+
+//! Hamilton product, same as Eigen's quaternion multiplication.
+static inline struct vquat
+vquat_mul(const struct vquat *a, const struct vquat *b)
+{
+	struct vquat r;
+	r.x = v_fmadd(a->w, b->x, v_fmadd(a->x, b->w, v_sub(v_mul(a->y, b->z), v_mul(a->z, b->y))));
+	r.y = v_fmadd(a->w, b->y, v_fmadd(a->y, b->w, v_sub(v_mul(a->z, b->x), v_mul(a->x, b->z))));
+	r.z = v_fmadd(a->w, b->z, v_fmadd(a->z, b->w, v_sub(v_mul(a->x, b->y), v_mul(a->y, b->x))));
+	r.w = v_sub(v_mul(a->w, b->w), v_fmadd(a->x, b->x, v_fmadd(a->y, b->y, v_mul(a->z, b->z))));
+	return r;
+}
+
+//! v + w * t + cross(q, t) where t = 2 * cross(q, v), same as Eigen.
+static inline struct vvec3
+vquat_rotate_vec3(const struct vquat *q, const struct vvec3 *v)
+{
+	const vf two = v_set1(2.0f);
+	const vf tx = v_mul(two, v_sub(v_mul(q->y, v->z), v_mul(q->z, v->y)));
+	const vf ty = v_mul(two, v_sub(v_mul(q->z, v->x), v_mul(q->x, v->z)));
+	const vf tz = v_mul(two, v_sub(v_mul(q->x, v->y), v_mul(q->y, v->x)));
+
+	struct vvec3 r;
+	r.x = v_add(v_fmadd(q->w, tx, v->x), v_sub(v_mul(q->y, tz), v_mul(q->z, ty)));
+	r.y = v_add(v_fmadd(q->w, ty, v->y), v_sub(v_mul(q->z, tx), v_mul(q->x, tz)));
+	r.z = v_add(v_fmadd(q->w, tz, v->z), v_sub(v_mul(q->x, ty), v_mul(q->y, tx)));
+	return r;
+}
+
+/*!
+ * acos for x in [0, 1], Abramowitz and Stegun 4.4.46, absolute error below
+ * 2e-8 before rounding.
+ */
+static inline vf
+v_acos_unit(vf x)
+{
+	vf p = v_set1(-0.0012624911f);
+	p = v_fmadd(p, x, v_set1(0.0066700901f));
+	p = v_fmadd(p, x, v_set1(-0.0170881256f));
+	p = v_fmadd(p, x, v_set1(0.0308918810f));
+	p = v_fmadd(p, x, v_set1(-0.0501743046f));
+	p = v_fmadd(p, x, v_set1(0.0889789874f));
+	p = v_fmadd(p, x, v_set1(-0.2145988016f));
+	p = v_fmadd(p, x, v_set1(1.5707963050f));
+
+	return v_mul(v_sqrt(v_sub(v_set1(1.0f), x)), p);
+}
+
+/*!
+ * sin, reduced to [-pi/2, pi/2] with sin(x - k * pi) = (-1)^k * sin(x) and
+ * then a Taylor series up to x^11.
+ */
+static inline vf
+v_sin(vf x)
+{
+	const vf k = v_round(v_mul(x, v_set1(0.318309886f)));
+
+	// Two part pi so the reduction stays exact for small k.
+	vf r = v_fmadd(k, v_set1(-3.140625f), x);
+	r = v_fmadd(k, v_set1(-9.67653589793e-4f), r);
+
+	// 1 for even k and -1 for odd k.
+	const vf odd = v_abs(v_sub(k, v_mul(v_set1(2.0f), v_round(v_mul(k, v_set1(0.5f))))));
+	const vf sign = v_sub(v_set1(1.0f), v_mul(v_set1(2.0f), odd));
+
+	const vf r2 = v_mul(r, r);
+	vf p = v_set1(-2.5052108e-8f);
+	p = v_fmadd(p, r2, v_set1(2.7557319e-6f));
+	p = v_fmadd(p, r2, v_set1(-1.9841270e-4f));
+	p = v_fmadd(p, r2, v_set1(8.3333333e-3f));
+	p = v_fmadd(p, r2, v_set1(-1.6666667e-1f));
+	p = v_fmadd(p, r2, v_set1(1.0f));
+
+	return v_mul(sign, v_mul(r, p));
+}
+
+
+/*
+ *
+ * Blocks, always exactly V_WIDTH elements, reads everything before writing.
+ *
+ */
+
+static inline void
+pose_transform_block(const struct vquat *tq, const struct vvec3 *tp, const struct xrt_pose *in, struct xrt_pose *out)
+{
+	const float *src = (const float *)in;
+	float *dst = (float *)out;
+
+	struct vquat q = vquat_gather(src + 0, POSE_STRIDE);
+	struct vvec3 p = vvec3_gather(src + 4, POSE_STRIDE);
+
+	struct vquat rq = vquat_mul(tq, &q);
+	struct vvec3 rp = vquat_rotate_vec3(tq, &p);
+	rp.x = v_add(rp.x, tp->x);
+	rp.y = v_add(rp.y, tp->y);
+	rp.z = v_add(rp.z, tp->z);
+
+	vquat_scatter(dst + 0, POSE_STRIDE, &rq);
+	vvec3_scatter(dst + 4, POSE_STRIDE, &rp);
+}
+
+static inline void
+quat_rotate_block(const struct vquat *l, const struct xrt_quat *in, struct xrt_quat *out)
+{
+	struct vquat q = vquat_gather((const float *)in, QUAT_STRIDE);
+	struct vquat r = vquat_mul(l, &q);
+	vquat_scatter((float *)out, QUAT_STRIDE, &r);
+}
+
+static inline void
+quat_rotate_vec3_block(const struct vquat *l, const struct xrt_vec3 *in, struct xrt_vec3 *out)
+{
+	struct vvec3 v = vvec3_gather((const float *)in, VEC3_STRIDE);
+	struct vvec3 r = vquat_rotate_vec3(l, &v);
+	vvec3_scatter((float *)out, VEC3_STRIDE, &r);
+}
+
+//! Same branches as Eigen's slerp, turned into selects.
+static inline void
+quat_slerp_block(vf t, const struct xrt_quat *lefts, const struct xrt_quat *rights, struct xrt_quat *out)
+{
+	const struct vquat a = vquat_gather((const float *)lefts, QUAT_STRIDE);
+	const struct vquat b = vquat_gather((const float *)rights, QUAT_STRIDE);
+
+	const vf zero = v_set1(0.0f);
+	const vf one = v_set1(1.0f);
+
+	const vf d = v_fmadd(a.x, b.x, v_fmadd(a.y, b.y, v_fmadd(a.z, b.z, v_mul(a.w, b.w))));
+	const vf abs_d = v_min(v_abs(d), one);
+
+	// sin(acos(x)) written so that it stays accurate when x is close to one.
+	const vf theta = v_acos_unit(abs_d);
+	const vf sin_theta = v_sqrt(v_max(v_mul(v_sub(one, abs_d), v_add(one, abs_d)), zero));
+
+	const vf one_minus_t = v_sub(one, t);
+	vf scale0 = v_div(v_sin(v_mul(one_minus_t, theta)), sin_theta);
+	vf scale1 = v_div(v_sin(v_mul(t, theta)), sin_theta);
+
+	// Nearly the same orientation, fall back to lerp like Eigen does.
+	const vm linear = v_ge(abs_d, v_set1(1.0f - FLT_EPSILON));
+	scale0 = v_select(linear, one_minus_t, scale0);
+	scale1 = v_select(linear, t, scale1);
+	scale1 = v_select(v_lt(d, zero), v_sub(zero, scale1), scale1);
+
+	struct vquat r;
+	r.x = v_fmadd(scale0, a.x, v_mul(scale1, b.x));
+	r.y = v_fmadd(scale0, a.y, v_mul(scale1, b.y));
+	r.z = v_fmadd(scale0, a.z, v_mul(scale1, b.z));
+	r.w = v_fmadd(scale0, a.w, v_mul(scale1, b.w));
+
+	vquat_scatter((float *)out, QUAT_STRIDE, &r);
+}
+
+
+/*
+ *
+ * Array functions.
+ *
+ */
+
+static void
+pose_transform(const struct xrt_pose *transform,
+               const struct xrt_pose *poses,
+               uint32_t count,
+               struct xrt_pose *out_poses)
+{
+	const struct vquat tq = vquat_set1(&transform->orientation);
+	const struct vvec3 tp = vvec3_set1(&transform->position);
+
+	uint32_t i = 0;
+	for (; i + V_WIDTH <= count; i += V_WIDTH) {
+		pose_transform_block(&tq, &tp, poses + i, out_poses + i);
+	}
+
+	if (i < count) {
+		struct xrt_pose tmp[V_WIDTH];
+		memset(tmp, 0, sizeof(tmp));
+		memcpy(tmp, poses + i, (count - i) * sizeof(*tmp));
+		pose_transform_block(&tq, &tp, tmp, tmp);
+		memcpy(out_poses + i, tmp, (count - i) * sizeof(*tmp));
+	}
+}
+
+static void
+quat_rotate(const struct xrt_quat *left, const struct xrt_quat *rights, uint32_t count, struct xrt_quat *out_quats)
+{
+	const struct vquat l = vquat_set1(left);
+
+	uint32_t i = 0;
+	for (; i + V_WIDTH <= count; i += V_WIDTH) {
+		quat_rotate_block(&l, rights + i, out_quats + i);
+	}
+
+	if (i < count) {
+		struct xrt_quat tmp[V_WIDTH];
+		memset(tmp, 0, sizeof(tmp));
+		memcpy(tmp, rights + i, (count - i) * sizeof(*tmp));
+		quat_rotate_block(&l, tmp, tmp);
+		memcpy(out_quats + i, tmp, (count - i) * sizeof(*tmp));
+	}
+}
+
+static void
+quat_rotate_vec3(const struct xrt_quat *left, const struct xrt_vec3 *vecs, uint32_t count, struct xrt_vec3 *out_vecs)
+{
+	const struct vquat l = vquat_set1(left);
+
+	uint32_t i = 0;
+	for (; i + V_WIDTH <= count; i += V_WIDTH) {
+		quat_rotate_vec3_block(&l, vecs + i, out_vecs + i);
+	}
+
+	if (i < count) {
+		struct xrt_vec3 tmp[V_WIDTH];
+		memset(tmp, 0, sizeof(tmp));
+		memcpy(tmp, vecs + i, (count - i) * sizeof(*tmp));
+		quat_rotate_vec3_block(&l, tmp, tmp);
+		memcpy(out_vecs + i, tmp, (count - i) * sizeof(*tmp));
+	}
+}
+
+static void
+quat_slerp(const struct xrt_quat *lefts,
+           const struct xrt_quat *rights,
+           float t,
+           uint32_t count,
+           struct xrt_quat *out_quats)
+{
+	const vf vt = v_set1(t);
+
+	uint32_t i = 0;
+	for (; i + V_WIDTH <= count; i += V_WIDTH) {
+		quat_slerp_block(vt, lefts + i, rights + i, out_quats + i);
+	}
+
+	if (i < count) {
+		struct xrt_quat tmp_l[V_WIDTH];
+		struct xrt_quat tmp_r[V_WIDTH];
+		memset(tmp_l, 0, sizeof(tmp_l));
+		memset(tmp_r, 0, sizeof(tmp_r));
+		memcpy(tmp_l, lefts + i, (count - i) * sizeof(*tmp_l));
+		memcpy(tmp_r, rights + i, (count - i) * sizeof(*tmp_r));
+		quat_slerp_block(vt, tmp_l, tmp_r, tmp_l);
+		memcpy(out_quats + i, tmp_l, (count - i) * sizeof(*tmp_l));
+	}
+}
+
+const struct m_batch_funcs M_BATCH_FUNCS = {
+    .name = M_BATCH_NAME,
+    .width = V_WIDTH,
+    .pose_transform = pose_transform,
+    .quat_rotate = quat_rotate,
+    .quat_rotate_vec3 = quat_rotate_vec3,
+    .quat_slerp = quat_slerp,
+};
@@ -0,0 +1,52 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  NEON batch math, always available on AArch64.
+ * @ingroup aux_math
+ */
+
+#include "math/m_batch.h"
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+
+#include <arm_neon.h>
+
+
+#define V_WIDTH 4
+#define M_BATCH_FUNCS m_batch_funcs_neon
+#define M_BATCH_NAME "neon"
+
+typedef float32x4_t vf;
+typedef uint32x4_t vm;
+
+// clang-format off
+static inline vf v_set1(float f) { return vdupq_n_f32(f); }
+static inline vf v_gather(const float *p, uint32_t s) {
+	const float v[4] = {p[0], p[s], p[2 * s], p[3 * s]};
+	return vld1q_f32(v);
+}
+static inline void v_scatter(float *p, uint32_t s, vf a) {
+	vst1q_lane_f32(p, a, 0);
+	vst1q_lane_f32(p + s, a, 1);
+	vst1q_lane_f32(p + 2 * s, a, 2);
+	vst1q_lane_f32(p + 3 * s, a, 3);
+}
+static inline vf v_add(vf a, vf b) { return vaddq_f32(a, b); }
+static inline vf v_sub(vf a, vf b) { return vsubq_f32(a, b); }
+static inline vf v_mul(vf a, vf b) { return vmulq_f32(a, b); }
+static inline vf v_div(vf a, vf b) { return vdivq_f32(a, b); }
+static inline vf v_fmadd(vf a, vf b, vf c) { return vfmaq_f32(c, a, b); }
+static inline vf v_sqrt(vf a) { return vsqrtq_f32(a); }
+static inline vf v_abs(vf a) { return vabsq_f32(a); }
+static inline vf v_min(vf a, vf b) { return vminq_f32(a, b); }
+static inline vf v_max(vf a, vf b) { return vmaxq_f32(a, b); }
+static inline vf v_round(vf a) { return vrndnq_f32(a); }
+static inline vm v_lt(vf a, vf b) { return vcltq_f32(a, b); }
+static inline vm v_ge(vf a, vf b) { return vcgeq_f32(a, b); }
+static inline vf v_select(vm m, vf a, vf b) { return vbslq_f32(m, a, b); }
+// clang-format on
+
+#include "m_batch_kernels.h"
+
+#endif
@@ -0,0 +1,41 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Scalar batch math, the fallback for every architecture.
+ * @ingroup aux_math
+ */
+
+#include "math/m_mathinclude.h"
+#include "math/m_batch.h"
+
+#include <stdbool.h>
+
+
+#define V_WIDTH 1
+#define M_BATCH_FUNCS m_batch_funcs_scalar
+#define M_BATCH_NAME "scalar"
+
+typedef float vf;
+typedef bool vm;
+
+// clang-format off
+static inline vf v_set1(float f) { return f; }
+static inline vf v_gather(const float *p, uint32_t stride) { (void)stride; return p[0]; }
+static inline void v_scatter(float *p, uint32_t stride, vf a) { (void)stride; p[0] = a; }
+static inline vf v_add(vf a, vf b) { return a + b; }
+static inline vf v_sub(vf a, vf b) { return a - b; }
+static inline vf v_mul(vf a, vf b) { return a * b; }
+static inline vf v_div(vf a, vf b) { return a / b; }
+static inline vf v_fmadd(vf a, vf b, vf c) { return a * b + c; }
+static inline vf v_sqrt(vf a) { return sqrtf(a); }
+static inline vf v_abs(vf a) { return fabsf(a); }
+static inline vf v_min(vf a, vf b) { return a < b ? a : b; }
+static inline vf v_max(vf a, vf b) { return a > b ? a : b; }
+static inline vf v_round(vf a) { return rintf(a); }
+static inline vm v_lt(vf a, vf b) { return a < b; }
+static inline vm v_ge(vf a, vf b) { return a >= b; }
+static inline vf v_select(vm m, vf a, vf b) { return m ? a : b; }
+// clang-format on
+
+#include "m_batch_kernels.h"
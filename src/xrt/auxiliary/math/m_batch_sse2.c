@@ -0,0 +1,49 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  SSE2 batch math, always available on x86-64.
+ * @ingroup aux_math
+ */
+
+#include "math/m_batch.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+#include <emmintrin.h>
+
+
+#define V_WIDTH 4
+#define M_BATCH_FUNCS m_batch_funcs_sse2
+#define M_BATCH_NAME "sse2"
+
+typedef __m128 vf;
+typedef __m128 vm;
+
+// clang-format off
+static inline vf v_set1(float f) { return _mm_set1_ps(f); }
+static inline vf v_gather(const float *p, uint32_t s) { return _mm_setr_ps(p[0], p[s], p[2 * s], p[3 * s]); }
+static inline void v_scatter(float *p, uint32_t s, vf a) {
+	_mm_store_ss(p, a);
+	_mm_store_ss(p + s, _mm_shuffle_ps(a, a, 1));
+	_mm_store_ss(p + 2 * s, _mm_shuffle_ps(a, a, 2));
+	_mm_store_ss(p + 3 * s, _mm_shuffle_ps(a, a, 3));
+}
+static inline vf v_add(vf a, vf b) { return _mm_add_ps(a, b); }
+static inline vf v_sub(vf a, vf b) { return _mm_sub_ps(a, b); }
+static inline vf v_mul(vf a, vf b) { return _mm_mul_ps(a, b); }
+static inline vf v_div(vf a, vf b) { return _mm_div_ps(a, b); }
+static inline vf v_fmadd(vf a, vf b, vf c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+static inline vf v_sqrt(vf a) { return _mm_sqrt_ps(a); }
+static inline vf v_abs(vf a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+static inline vf v_min(vf a, vf b) { return _mm_min_ps(a, b); }
+static inline vf v_max(vf a, vf b) { return _mm_max_ps(a, b); }
+static inline vf v_round(vf a) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(a)); }
+static inline vm v_lt(vf a, vf b) { return _mm_cmplt_ps(a, b); }
+static inline vm v_ge(vf a, vf b) { return _mm_cmpge_ps(a, b); }
+static inline vf v_select(vm m, vf a, vf b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+// clang-format on
+
+#include "m_batch_kernels.h"
+
+#endif
@@ -5,6 +5,13 @@
  * @brief  A fifo that also lets you dynamically filter.
  * @author Jakob Bornecrantz <jakob@collabora.com>
  * @ingroup aux_math
+ *
+ * Samples are stored as a structure of arrays, one array per component plus
+ * one for the timestamps. Samples are written backwards in the ring, so the
+ * logical index zero (the latest sample) lives at @p latest and the ring is
+ * made up of at most two physical runs, each sorted on time. That lets the
+ * filter functions binary search for the window and then sum plain contiguous
+ * arrays, which the compiler can vectorize.
  */
 
 #include "util/u_misc.h"
@@ -13,6 +20,159 @@
 #include <assert.h>
 
 
+/*
+ *
+ * Shared helpers.
+ *
+ */
+
+//! Translate a logical index, zero being the latest sample, to a ring position.
+static inline size_t
+ring_pos(size_t num, size_t latest, size_t index)
+{
+	size_t pos = latest + index;
+	return pos >= num ? pos - num : pos;
+}
+
+/*!
+ * Returns the first logical index whose timestamp is at or before
+ * @p timestamp_ns, or @p num if there is none. Timestamps are non-increasing
+ * with the logical index.
+ */
+static size_t
+ring_lower_bound(const uint64_t *timestamps_ns, size_t num, size_t latest, uint64_t timestamp_ns)
+{
+	size_t low = 0;
+	size_t high = num;
+
+	while (low < high) {
+		size_t mid = low + (high - low) / 2;
+		if (timestamps_ns[ring_pos(num, latest, mid)] > timestamp_ns) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	return low;
+}
+
+/*!
+ * Finds the logical range [@p out_first, @p out_first + return) of samples
+ * with timestamps within [@p start_ns, @p stop_ns].
+ */
+static size_t
+ring_find_window(const uint64_t *timestamps_ns,
+                 size_t num,
+                 size_t latest,
+                 uint64_t start_ns,
+                 uint64_t stop_ns,
+                 size_t *out_first)
+{
+	// Error, skip averaging.
+	if (start_ns > stop_ns || num == 0) {
+		*out_first = 0;
+		return 0;
+	}
+
+	size_t first = ring_lower_bound(timestamps_ns, num, latest, stop_ns);
+	size_t end = start_ns == 0 ? num : ring_lower_bound(timestamps_ns, num, latest, start_ns - 1);
+
+	*out_first = first;
+	return end - first;
+}
+
+/*!
+ * Splits the logical range into at most two contiguous ring runs, returns the
+ * number of runs.
+ */
+static int
+ring_split(size_t num, size_t latest, size_t first, size_t count, size_t out_start[2], size_t out_count[2])
+{
+	size_t pos = ring_pos(num, latest, first);
+	size_t until_end = num - pos;
+
+	out_start[0] = pos;
+	if (count <= until_end) {
+		out_count[0] = count;
+		return 1;
+	}
+
+	out_count[0] = until_end;
+	out_start[1] = 0;
+	out_count[1] = count - until_end;
+	return 2;
+}
+
+/*
+ * The sum functions keep four independent accumulators, the order of
+ * additions within each lane is fixed so the compiler is free to put the lanes
+ * in one vector register without needing fast-math reassociation.
+ */
+
+static double
+sum_f32(const float *values, size_t count)
+{
+	double acc[4] = {0};
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4) {
+		acc[0] += values[i + 0];
+		acc[1] += values[i + 1];
+		acc[2] += values[i + 2];
+		acc[3] += values[i + 3];
+	}
+	for (; i < count; i++) {
+		acc[0] += values[i];
+	}
+
+	return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+static double
+sum_f64(const double *values, size_t count)
+{
+	double acc[4] = {0};
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4) {
+		acc[0] += values[i + 0];
+		acc[1] += values[i + 1];
+		acc[2] += values[i + 2];
+		acc[3] += values[i + 3];
+	}
+	for (; i < count; i++) {
+		acc[0] += values[i];
+	}
+
+	return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+/*!
+ * Sum of the logical range using inclusive prefix sums, the newest sample in
+ * the range has the largest prefix.
+ */
+static inline double
+prefix_range_sum(const double *prefix, const double *values, size_t newest, size_t oldest)
+{
+	return prefix[newest] - prefix[oldest] + values[oldest];
+}
+
+static inline double
+prefix_range_sum_f32(const double *prefix, const float *values, size_t newest, size_t oldest)
+{
+	return prefix[newest] - prefix[oldest] + (double)values[oldest];
+}
+
+static void
+prefix_rebase(double *prefix, size_t num, double base)
+{
+	for (size_t i = 0; i < num; i++) {
+		prefix[i] -= base;
+	}
+}
+
+
 /*
  *
  * Filter fifo vec3_f32.
@@ -23,8 +183,16 @@ struct m_ff_vec3_f32
 {
 	size_t num;
 	size_t latest;
-	struct xrt_vec3 *samples;
+
+	float *x;
+	float *y;
+	float *z;
 	uint64_t *timestamps_ns;
+
+	//! Optional inclusive running sums per component, NULL if not enabled.
+	double *prefix_x;
+	double *prefix_y;
+	double *prefix_z;
 };
 
 
@@ -35,10 +203,17 @@ struct m_ff_vec3_f32
  */
 
 static void
-vec3_f32_init(struct m_ff_vec3_f32 *ff, size_t num)
+vec3_f32_init(struct m_ff_vec3_f32 *ff, size_t num, bool prefix_sum)
 {
-	ff->samples = U_TYPED_ARRAY_CALLOC(struct xrt_vec3, num);
+	ff->x = U_TYPED_ARRAY_CALLOC(float, num);
+	ff->y = U_TYPED_ARRAY_CALLOC(float, num);
+	ff->z = U_TYPED_ARRAY_CALLOC(float, num);
 	ff->timestamps_ns = U_TYPED_ARRAY_CALLOC(uint64_t, num);
+	if (prefix_sum) {
+		ff->prefix_x = U_TYPED_ARRAY_CALLOC(double, num);
+		ff->prefix_y = U_TYPED_ARRAY_CALLOC(double, num);
+		ff->prefix_z = U_TYPED_ARRAY_CALLOC(double, num);
+	}
 	ff->num = num;
 	ff->latest = 0;
 }
@@ -46,18 +221,15 @@ vec3_f32_init(struct m_ff_vec3_f32 *ff, size_t num)
 static void
 vec3_f32_destroy(struct m_ff_vec3_f32 *ff)
 {
-	if (ff->samples != NULL) {
-		free(ff->samples);
-		ff->samples = NULL;
-	}
-
-	if (ff->timestamps_ns != NULL) {
-		free(ff->timestamps_ns);
-		ff->timestamps_ns = NULL;
-	}
-
-	ff->num = 0;
-	ff->latest = 0;
+	free(ff->x);
+	free(ff->y);
+	free(ff->z);
+	free(ff->timestamps_ns);
+	free(ff->prefix_x);
+	free(ff->prefix_y);
+	free(ff->prefix_z);
+
+	U_ZERO(ff);
 }
 
 
@@ -71,7 +243,15 @@ void
 m_ff_vec3_f32_alloc(struct m_ff_vec3_f32 **ff_out, size_t num)
 {
 	struct m_ff_vec3_f32 *ff = U_TYPED_CALLOC(struct m_ff_vec3_f32);
-	vec3_f32_init(ff, num);
+	vec3_f32_init(ff, num, false);
+	*ff_out = ff;
+}
+
+void
+m_ff_vec3_f32_alloc_prefix_sum(struct m_ff_vec3_f32 **ff_out, size_t num)
+{
+	struct m_ff_vec3_f32 *ff = U_TYPED_CALLOC(struct m_ff_vec3_f32);
+	vec3_f32_init(ff, num, true);
 	*ff_out = ff;
 }
 
@@ -99,11 +279,31 @@ m_ff_vec3_f32_push(struct m_ff_vec3_f32 *ff, const struct xrt_vec3 *sample, uint
 {
 	assert(ff->timestamps_ns[ff->latest] <= timestamp_ns);
 
+	size_t prev = ff->latest;
+
 	// We write samples backwards in the queue.
-	size_t i = ff->latest == 0 ? ff->num - 1 : --ff->latest;
+	size_t i = ff->latest == 0 ? ff->num - 1 : ff->latest - 1;
 	ff->latest = i;
 
-	ff->samples[i] = *sample;
+	if (ff->prefix_x != NULL) {
+		/*
+		 * Once per lap pull the sums back towards zero, only differences
+		 * are ever used so this keeps precision without changing results.
+		 */
+		if (i == ff->num - 1) {
+			prefix_rebase(ff->prefix_x, ff->num, ff->prefix_x[i]);
+			prefix_rebase(ff->prefix_y, ff->num, ff->prefix_y[i]);
+			prefix_rebase(ff->prefix_z, ff->num, ff->prefix_z[i]);
+		}
+
+		ff->prefix_x[i] = ff->prefix_x[prev] + (double)sample->x;
+		ff->prefix_y[i] = ff->prefix_y[prev] + (double)sample->y;
+		ff->prefix_z[i] = ff->prefix_z[prev] + (double)sample->z;
+	}
+
+	ff->x[i] = sample->x;
+	ff->y[i] = sample->y;
+	ff->z[i] = sample->z;
 	ff->timestamps_ns[i] = timestamp_ns;
 }
 
@@ -114,8 +314,10 @@ m_ff_vec3_f32_get(struct m_ff_vec3_f32 *ff, size_t num, struct xrt_vec3 *out_sam
 		return false;
 	}
 
-	size_t pos = (ff->latest + num) % ff->num;
-	*out_sample = ff->samples[pos];
+	size_t pos = ring_pos(ff->num, ff->latest, num);
+	out_sample->x = ff->x[pos];
+	out_sample->y = ff->y[pos];
+	out_sample->z = ff->z[pos];
 	*out_timestamp_ns = ff->timestamps_ns[pos];
 
 	return true;
@@ -124,38 +326,31 @@ m_ff_vec3_f32_get(struct m_ff_vec3_f32 *ff, size_t num, struct xrt_vec3 *out_sam
 size_t
 m_ff_vec3_f32_filter(struct m_ff_vec3_f32 *ff, uint64_t start_ns, uint64_t stop_ns, struct xrt_vec3 *out_average)
 {
-	size_t num_sampled = 0;
-	size_t count = 0;
+	size_t first = 0;
+	size_t num_sampled = ring_find_window(ff->timestamps_ns, ff->num, ff->latest, start_ns, stop_ns, &first);
+
 	// Use double precision internally.
 	double x = 0;
 	double y = 0;
 	double z = 0;
 
-	// Error, skip averaging.
-	if (start_ns > stop_ns) {
-		count = ff->num;
-	}
-
-	while (count < ff->num) {
-		size_t pos = (ff->latest + count) % ff->num;
-
-		// We have not yet reached where to start.
-		if (ff->timestamps_ns[pos] > stop_ns) {
-			count++;
-			continue;
+	if (num_sampled > 0 && ff->prefix_x != NULL) {
+		size_t newest = ring_pos(ff->num, ff->latest, first);
+		size_t oldest = ring_pos(ff->num, ff->latest, first + num_sampled - 1);
+
+		x = prefix_range_sum_f32(ff->prefix_x, ff->x, newest, oldest);
+		y = prefix_range_sum_f32(ff->prefix_y, ff->y, newest, oldest);
+		z = prefix_range_sum_f32(ff->prefix_z, ff->z, newest, oldest);
+	} else if (num_sampled > 0) {
+		size_t starts[2];
+		size_t counts[2];
+		int runs = ring_split(ff->num, ff->latest, first, num_sampled, starts, counts);
+
+		for (int r = 0; r < runs; r++) {
+			x += sum_f32(ff->x + starts[r], counts[r]);
+			y += sum_f32(ff->y + starts[r], counts[r]);
+			z += sum_f32(ff->z + starts[r], counts[r]);
 		}
-
-		// If the sample is before the start we have reach the end.
-		if (ff->timestamps_ns[pos] < start_ns) {
-			count++;
-			break;
-		}
-
-		x += ff->samples[pos].x;
-		y += ff->samples[pos].y;
-		z += ff->samples[pos].z;
-		num_sampled++;
-		count++;
 	}
 
 	// Avoid division by zero.
@@ -185,6 +380,9 @@ struct m_ff_f64
 	size_t latest;
 	double *samples;
 	uint64_t *timestamps_ns;
+
+	//! Optional inclusive running sums, NULL if not enabled.
+	double *prefix;
 };
 
 
@@ -195,10 +393,13 @@ struct m_ff_f64
  */
 
 static void
-ff_f64_init(struct m_ff_f64 *ff, size_t num)
+ff_f64_init(struct m_ff_f64 *ff, size_t num, bool prefix_sum)
 {
 	ff->samples = U_TYPED_ARRAY_CALLOC(double, num);
 	ff->timestamps_ns = U_TYPED_ARRAY_CALLOC(uint64_t, num);
+	if (prefix_sum) {
+		ff->prefix = U_TYPED_ARRAY_CALLOC(double, num);
+	}
 	ff->num = num;
 	ff->latest = 0;
 }
@@ -206,18 +407,11 @@ ff_f64_init(struct m_ff_f64 *ff, size_t num)
 static void
 ff_f64_destroy(struct m_ff_f64 *ff)
 {
-	if (ff->samples != NULL) {
-		free(ff->samples);
-		ff->samples = NULL;
-	}
-
-	if (ff->timestamps_ns != NULL) {
-		free(ff->timestamps_ns);
-		ff->timestamps_ns = NULL;
-	}
+	free(ff->samples);
+	free(ff->timestamps_ns);
+	free(ff->prefix);
 
-	ff->num = 0;
-	ff->latest = 0;
+	U_ZERO(ff);
 }
 
 
@@ -231,7 +425,15 @@ void
 m_ff_f64_alloc(struct m_ff_f64 **ff_out, size_t num)
 {
 	struct m_ff_f64 *ff = U_TYPED_CALLOC(struct m_ff_f64);
-	ff_f64_init(ff, num);
+	ff_f64_init(ff, num, false);
+	*ff_out = ff;
+}
+
+void
+m_ff_f64_alloc_prefix_sum(struct m_ff_f64 **ff_out, size_t num)
+{
+	struct m_ff_f64 *ff = U_TYPED_CALLOC(struct m_ff_f64);
+	ff_f64_init(ff, num, true);
 	*ff_out = ff;
 }
 
@@ -259,10 +461,21 @@ m_ff_f64_push(struct m_ff_f64 *ff, const double *sample, uint64_t timestamp_ns)
 {
 	assert(ff->timestamps_ns[ff->latest] <= timestamp_ns);
 
+	size_t prev = ff->latest;
+
 	// We write samples backwards in the queue.
-	size_t i = ff->latest == 0 ? ff->num - 1 : --ff->latest;
+	size_t i = ff->latest == 0 ? ff->num - 1 : ff->latest - 1;
 	ff->latest = i;
 
+	if (ff->prefix != NULL) {
+		// See m_ff_vec3_f32_push.
+		if (i == ff->num - 1) {
+			prefix_rebase(ff->prefix, ff->num, ff->prefix[i]);
+		}
+
+		ff->prefix[i] = ff->prefix[prev] + *sample;
+	}
+
 	ff->samples[i] = *sample;
 	ff->timestamps_ns[i] = timestamp_ns;
 }
@@ -274,7 +487,7 @@ m_ff_f64_get(struct m_ff_f64 *ff, size_t num, double *out_sample, uint64_t *out_
 		return false;
 	}
 
-	size_t pos = (ff->latest + num) % ff->num;
+	size_t pos = ring_pos(ff->num, ff->latest, num);
 	*out_sample = ff->samples[pos];
 	*out_timestamp_ns = ff->timestamps_ns[pos];
 
@@ -284,33 +497,23 @@ m_ff_f64_get(struct m_ff_f64 *ff, size_t num, double *out_sample, uint64_t *out_
 size_t
 m_ff_f64_filter(struct m_ff_f64 *ff, uint64_t start_ns, uint64_t stop_ns, double *out_average)
 {
-	size_t num_sampled = 0;
-	size_t count = 0;
+	size_t first = 0;
+	size_t num_sampled = ring_find_window(ff->timestamps_ns, ff->num, ff->latest, start_ns, stop_ns, &first);
 	double val = 0;
 
-	// Error, skip averaging.
-	if (start_ns > stop_ns) {
-		count = ff->num;
-	}
+	if (num_sampled > 0 && ff->prefix != NULL) {
+		size_t newest = ring_pos(ff->num, ff->latest, first);
+		size_t oldest = ring_pos(ff->num, ff->latest, first + num_sampled - 1);
 
-	while (count < ff->num) {
-		size_t pos = (ff->latest + count) % ff->num;
+		val = prefix_range_sum(ff->prefix, ff->samples, newest, oldest);
+	} else if (num_sampled > 0) {
+		size_t starts[2];
+		size_t counts[2];
+		int runs = ring_split(ff->num, ff->latest, first, num_sampled, starts, counts);
 
-		// We have not yet reached where to start.
-		if (ff->timestamps_ns[pos] > stop_ns) {
-			count++;
-			continue;
+		for (int r = 0; r < runs; r++) {
+			val += sum_f64(ff->samples + starts[r], counts[r]);
 		}
-
-		// If the sample is before the start we have reach the end.
-		if (ff->timestamps_ns[pos] < start_ns) {
-			count++;
-			break;
-		}
-
-		val += ff->samples[pos];
-		num_sampled++;
-		count++;
 	}
 
 	// Avoid division by zero.
@@ -26,6 +26,14 @@ struct m_ff_vec3_f32;
 void
 m_ff_vec3_f32_alloc(struct m_ff_vec3_f32 **ff_out, size_t num);
 
+/*!
+ * Same as @ref m_ff_vec3_f32_alloc but also keeps running sums of the samples,
+ * making @ref m_ff_vec3_f32_filter O(log n) instead of O(log n + window) at the
+ * cost of some extra work and memory on push.
+ */
+void
+m_ff_vec3_f32_alloc_prefix_sum(struct m_ff_vec3_f32 **ff_out, size_t num);
+
 /*!
  * Frees the given filter fifo and all its samples.
  */
@@ -74,6 +82,13 @@ m_ff_vec3_f32_filter(struct m_ff_vec3_f32 *ff, uint64_t start_ns, uint64_t stop_
 void
 m_ff_f64_alloc(struct m_ff_f64 **ff_out, size_t num);
 
+/*!
+ * Same as @ref m_ff_f64_alloc but also keeps running sums of the samples,
+ * see @ref m_ff_vec3_f32_alloc_prefix_sum.
+ */
+void
+m_ff_f64_alloc_prefix_sum(struct m_ff_f64 **ff_out, size_t num);
+
 /*!
  * Frees the given filter fifo and all its samples.
  */
@@ -0,0 +1,266 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Structure of arrays hand joints and batched relation kernels.
+ * @ingroup aux_math
+ */
+
+#include "math/m_mathinclude.h"
+#include "math/m_hand_joints.h"
+
+#include <assert.h>
+
+
+#define ORI_VALID XRT_SPACE_RELATION_ORIENTATION_VALID_BIT
+#define POS_VALID XRT_SPACE_RELATION_POSITION_VALID_BIT
+#define LIN_VALID XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT
+#define ANG_VALID XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT
+
+//! The flags that survive being resolved in a relation chain.
+#define CHAIN_FLAGS                                                                                                    \
+	(XRT_SPACE_RELATION_ORIENTATION_VALID_BIT | XRT_SPACE_RELATION_POSITION_VALID_BIT |                            \
+	 XRT_SPACE_RELATION_ORIENTATION_TRACKED_BIT | XRT_SPACE_RELATION_POSITION_TRACKED_BIT |                        \
+	 XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT | XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT)
+
+static_assert(M_HAND_JOINTS_SOA_LANES >= XRT_HAND_JOINT_COUNT, "Not enough lanes for a hand");
+
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+/*!
+ * Bitwise select, a plain ternary lets the compiler sink the float math into
+ * branches which it then can't if-convert and vectorize.
+ */
+static inline float
+sel(bool cond, float a, float b)
+{
+	union {
+		float f;
+		uint32_t u;
+	} ua = {a}, ub = {b}, r;
+
+	uint32_t mask = 0u - (uint32_t)cond;
+	r.u = (ua.u & mask) | (ub.u & ~mask);
+
+	return r.f;
+}
+
+static void
+set_lane_zero(struct m_hand_joints_soa *j, uint32_t i)
+{
+	j->px[i] = 0.0f;
+	j->py[i] = 0.0f;
+	j->pz[i] = 0.0f;
+	j->qx[i] = 0.0f;
+	j->qy[i] = 0.0f;
+	j->qz[i] = 0.0f;
+	j->qw[i] = 1.0f;
+	j->lx[i] = 0.0f;
+	j->ly[i] = 0.0f;
+	j->lz[i] = 0.0f;
+	j->ax[i] = 0.0f;
+	j->ay[i] = 0.0f;
+	j->az[i] = 0.0f;
+	j->radius[i] = 0.0f;
+	j->flags[i] = 0;
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+void
+m_hand_joints_soa_from_set(const struct xrt_hand_joint_set *set, struct m_hand_joints_soa *out)
+{
+	const struct xrt_hand_joint_value *values = set->values.hand_joint_set_default;
+
+	for (uint32_t i = 0; i < XRT_HAND_JOINT_COUNT; i++) {
+		const struct xrt_space_relation *r = &values[i].relation;
+
+		out->px[i] = r->pose.position.x;
+		out->py[i] = r->pose.position.y;
+		out->pz[i] = r->pose.position.z;
+		out->qx[i] = r->pose.orientation.x;
+		out->qy[i] = r->pose.orientation.y;
+		out->qz[i] = r->pose.orientation.z;
+		out->qw[i] = r->pose.orientation.w;
+		out->lx[i] = r->linear_velocity.x;
+		out->ly[i] = r->linear_velocity.y;
+		out->lz[i] = r->linear_velocity.z;
+		out->ax[i] = r->angular_velocity.x;
+		out->ay[i] = r->angular_velocity.y;
+		out->az[i] = r->angular_velocity.z;
+		out->radius[i] = values[i].radius;
+		out->flags[i] = (uint32_t)r->relation_flags;
+	}
+
+	for (uint32_t i = XRT_HAND_JOINT_COUNT; i < M_HAND_JOINTS_SOA_LANES; i++) {
+		set_lane_zero(out, i);
+	}
+}
+
+void
+m_hand_joints_soa_get(const struct m_hand_joints_soa *j,
+                      uint32_t i,
+                      struct xrt_space_relation *out_relation,
+                      float *out_radius)
+{
+	assert(i < M_HAND_JOINTS_SOA_LANES);
+
+	out_relation->relation_flags = (enum xrt_space_relation_flags)j->flags[i];
+	out_relation->pose.position.x = j->px[i];
+	out_relation->pose.position.y = j->py[i];
+	out_relation->pose.position.z = j->pz[i];
+	out_relation->pose.orientation.x = j->qx[i];
+	out_relation->pose.orientation.y = j->qy[i];
+	out_relation->pose.orientation.z = j->qz[i];
+	out_relation->pose.orientation.w = j->qw[i];
+	out_relation->linear_velocity.x = j->lx[i];
+	out_relation->linear_velocity.y = j->ly[i];
+	out_relation->linear_velocity.z = j->lz[i];
+	out_relation->angular_velocity.x = j->ax[i];
+	out_relation->angular_velocity.y = j->ay[i];
+	out_relation->angular_velocity.z = j->az[i];
+
+	if (out_radius != NULL) {
+		*out_radius = j->radius[i];
+	}
+}
+
+void
+m_hand_joints_soa_transform(const struct xrt_space_relation *base, struct m_hand_joints_soa *j)
+{
+	const uint32_t bf = (uint32_t)base->relation_flags;
+
+	// A step without any pose makes the whole chain zero.
+	if ((bf & (ORI_VALID | POS_VALID)) == 0) {
+		for (uint32_t i = 0; i < M_HAND_JOINTS_SOA_LANES; i++) {
+			set_lane_zero(j, i);
+		}
+		return;
+	}
+
+	// Invalid components of the base pose are treated as identity.
+	const bool b_ori = (bf & ORI_VALID) != 0;
+	const bool b_pos = (bf & POS_VALID) != 0;
+	const float bqx = b_ori ? base->pose.orientation.x : 0.0f;
+	const float bqy = b_ori ? base->pose.orientation.y : 0.0f;
+	const float bqz = b_ori ? base->pose.orientation.z : 0.0f;
+	const float bqw = b_ori ? base->pose.orientation.w : 1.0f;
+	const float btx = b_pos ? base->pose.position.x : 0.0f;
+	const float bty = b_pos ? base->pose.position.y : 0.0f;
+	const float btz = b_pos ? base->pose.position.z : 0.0f;
+	const float blx = base->linear_velocity.x;
+	const float bly = base->linear_velocity.y;
+	const float blz = base->linear_velocity.z;
+	const float bax = base->angular_velocity.x;
+	const float bay = base->angular_velocity.y;
+	const float baz = base->angular_velocity.z;
+
+	// Orientation only relations get a position, see apply_relation in m_space.cpp.
+	const uint32_t bf_chain = bf | (b_ori ? POS_VALID : 0);
+
+	for (uint32_t i = 0; i < M_HAND_JOINTS_SOA_LANES; i++) {
+		const uint32_t af = j->flags[i];
+		const bool a_ori = (af & ORI_VALID) != 0;
+		const bool a_pos = (af & POS_VALID) != 0;
+		const bool has_pose = (af & (ORI_VALID | POS_VALID)) != 0;
+
+		const uint32_t nf = (af | (a_ori ? POS_VALID : 0)) & bf_chain & CHAIN_FLAGS;
+		const bool has_lin = (nf & LIN_VALID) != 0;
+		const bool has_ang = (nf & ANG_VALID) != 0;
+
+		// Load everything unconditionally so the selects below stay branch free.
+		const float in_qx = j->qx[i];
+		const float in_qy = j->qy[i];
+		const float in_qz = j->qz[i];
+		const float in_qw = j->qw[i];
+		const float in_px = j->px[i];
+		const float in_py = j->py[i];
+		const float in_pz = j->pz[i];
+		const float lx = j->lx[i];
+		const float ly = j->ly[i];
+		const float lz = j->lz[i];
+		const float ax = j->ax[i];
+		const float ay = j->ay[i];
+		const float az = j->az[i];
+
+		const float qx = sel(a_ori, in_qx, 0.0f);
+		const float qy = sel(a_ori, in_qy, 0.0f);
+		const float qz = sel(a_ori, in_qz, 0.0f);
+		const float qw = sel(a_ori, in_qw, 1.0f);
+		const float px = sel(a_pos, in_px, 0.0f);
+		const float py = sel(a_pos, in_py, 0.0f);
+		const float pz = sel(a_pos, in_pz, 0.0f);
+
+		/*
+		 * Rotate by the base orientation, v + w * t + cross(q, t) where
+		 * t = 2 * cross(q, v), same as Eigen does it.
+		 */
+#define ROTATE(VX, VY, VZ, OX, OY, OZ)                                                                                 \
+	do {                                                                                                           \
+		const float tx = 2.0f * (bqy * (VZ)-bqz * (VY));                                                       \
+		const float ty = 2.0f * (bqz * (VX)-bqx * (VZ));                                                       \
+		const float tz = 2.0f * (bqx * (VY)-bqy * (VX));                                                       \
+		OX = (VX) + bqw * tx + (bqy * tz - bqz * ty);                                                          \
+		OY = (VY) + bqw * ty + (bqz * tx - bqx * tz);                                                          \
+		OZ = (VZ) + bqw * tz + (bqx * ty - bqy * tx);                                                          \
+	} while (false)
+
+		float rpx, rpy, rpz;
+		float rlx, rly, rlz;
+		float rax, ray, raz;
+		ROTATE(px, py, pz, rpx, rpy, rpz);
+		ROTATE(lx, ly, lz, rlx, rly, rlz);
+		ROTATE(ax, ay, az, rax, ray, raz);
+
+#undef ROTATE
+
+		// Compose and normalize the orientation.
+		float ox = bqw * qx + bqx * qw + bqy * qz - bqz * qy;
+		float oy = bqw * qy - bqx * qz + bqy * qw + bqz * qx;
+		float oz = bqw * qz + bqx * qy - bqy * qx + bqz * qw;
+		float ow = bqw * qw - bqx * qx - bqy * qy - bqz * qz;
+		const float inv_len = 1.0f / sqrtf(ox * ox + oy * oy + oz * oz + ow * ow);
+		ox *= inv_len;
+		oy *= inv_len;
+		oz *= inv_len;
+		ow *= inv_len;
+
+		// The base angular velocity gives the joint a tangential linear velocity.
+		const float tan_x = bay * rpz - baz * rpy;
+		const float tan_y = baz * rpx - bax * rpz;
+		const float tan_z = bax * rpy - bay * rpx;
+
+		const float lin_x = sel(has_lin, rlx + blx, 0.0f) + sel(has_ang, tan_x, 0.0f);
+		const float lin_y = sel(has_lin, rly + bly, 0.0f) + sel(has_ang, tan_y, 0.0f);
+		const float lin_z = sel(has_lin, rlz + blz, 0.0f) + sel(has_ang, tan_z, 0.0f);
+		const float ang_x = sel(has_ang, rax + bax, 0.0f);
+		const float ang_y = sel(has_ang, ray + bay, 0.0f);
+		const float ang_z = sel(has_ang, raz + baz, 0.0f);
+
+		// Joints without any pose become zero relations.
+		j->px[i] = sel(has_pose, btx + rpx, 0.0f);
+		j->py[i] = sel(has_pose, bty + rpy, 0.0f);
+		j->pz[i] = sel(has_pose, btz + rpz, 0.0f);
+		j->qx[i] = sel(has_pose, ox, 0.0f);
+		j->qy[i] = sel(has_pose, oy, 0.0f);
+		j->qz[i] = sel(has_pose, oz, 0.0f);
+		j->qw[i] = sel(has_pose, ow, 1.0f);
+		j->lx[i] = sel(has_pose, lin_x, 0.0f);
+		j->ly[i] = sel(has_pose, lin_y, 0.0f);
+		j->lz[i] = sel(has_pose, lin_z, 0.0f);
+		j->ax[i] = sel(has_pose, ang_x, 0.0f);
+		j->ay[i] = sel(has_pose, ang_y, 0.0f);
+		j->az[i] = sel(has_pose, ang_z, 0.0f);
+		j->flags[i] = nf & (0u - (uint32_t)has_pose);
+	}
+}
@@ -0,0 +1,98 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Structure of arrays hand joints and batched relation kernels.
+ * @ingroup aux_math
+ */
+
+#pragma once
+
+#include "xrt/xrt_defines.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*!
+ * Number of lanes in @ref m_hand_joints_soa, @ref XRT_HAND_JOINT_COUNT rounded
+ * up so that the kernels always run over whole vectors.
+ *
+ * @ingroup aux_math
+ */
+#define M_HAND_JOINTS_SOA_LANES 32
+
+/*!
+ * A hand joint set stored as structure of arrays, one array per component.
+ * The lanes past @ref XRT_HAND_JOINT_COUNT hold identity relations without any
+ * flags and are never read back.
+ *
+ * @ingroup aux_math
+ */
+struct m_hand_joints_soa
+{
+	float px[M_HAND_JOINTS_SOA_LANES];
+	float py[M_HAND_JOINTS_SOA_LANES];
+	float pz[M_HAND_JOINTS_SOA_LANES];
+
+	float qx[M_HAND_JOINTS_SOA_LANES];
+	float qy[M_HAND_JOINTS_SOA_LANES];
+	float qz[M_HAND_JOINTS_SOA_LANES];
+	float qw[M_HAND_JOINTS_SOA_LANES];
+
+	//! Linear velocity.
+	float lx[M_HAND_JOINTS_SOA_LANES];
+	float ly[M_HAND_JOINTS_SOA_LANES];
+	float lz[M_HAND_JOINTS_SOA_LANES];
+
+	//! Angular velocity.
+	float ax[M_HAND_JOINTS_SOA_LANES];
+	float ay[M_HAND_JOINTS_SOA_LANES];
+	float az[M_HAND_JOINTS_SOA_LANES];
+
+	float radius[M_HAND_JOINTS_SOA_LANES];
+
+	//! @ref xrt_space_relation_flags of each joint.
+	uint32_t flags[M_HAND_JOINTS_SOA_LANES];
+};
+
+/*!
+ * Scatter the joints of @p set into @p out.
+ *
+ * @ingroup aux_math
+ */
+void
+m_hand_joints_soa_from_set(const struct xrt_hand_joint_set *set, struct m_hand_joints_soa *out);
+
+/*!
+ * Read back a single joint.
+ *
+ * @ingroup aux_math
+ */
+void
+m_hand_joints_soa_get(const struct m_hand_joints_soa *joints,
+                      uint32_t index,
+                      struct xrt_space_relation *out_relation,
+                      float *out_radius);
+
+/*!
+ * Put every joint into the space of @p base, the result for each joint is the
+ * same as resolving a @ref xrt_relation_chain of the joint followed by
+ * @p base: poses are composed, velocities are rotated and the lever arm of the
+ * base angular velocity is added, flags are combined and orientations are
+ * normalized. Done in a single branch free pass over all lanes.
+ *
+ * @param      base   Relation to apply to all joints.
+ * @param[in,out] joints Joints to transform.
+ *
+ * @ingroup aux_math
+ */
+void
+m_hand_joints_soa_transform(const struct xrt_space_relation *base, struct m_hand_joints_soa *joints);
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,311 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Integration of IMU samples on top of a tracked pose, with a cache of
+ *         the samples already integrated.
+ * @ingroup aux_math
+ */
+
+#include "m_imu_integration.h"
+
+#include "math/m_api.h"
+#include "math/m_vec3.h"
+#include "math/m_predict.h"
+#include "math/m_filter_fifo.h"
+
+#include "util/u_time.h"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <assert.h>
+#include <stdint.h>
+
+
+//! An IMU sample and the relation after integrating it on top of the previous one.
+struct imu_preintegration_step
+{
+	int64_t ts;
+	xrt_vec3 gyro;
+	xrt_vec3 accel;
+	xrt_space_relation rel;
+};
+
+struct m_imu_preintegration
+{
+	size_t max_steps = 0;
+
+	//! Built from the fifos and kept up to date by pushes.
+	bool valid = false;
+
+	int64_t base_ts = 0;
+	xrt_space_relation base_rel = XRT_SPACE_RELATION_ZERO;
+
+	//! Correction the steps were integrated with.
+	xrt_vec3 gravity_correction{};
+
+	std::vector<imu_preintegration_step> steps;
+};
+
+
+/*
+ *
+ * Helper functions.
+ *
+ */
+
+/*!
+ * Index of the oldest sample taken at or after @p base_ts, -1 if none. If the
+ * fifo doesn't reach back to @p base_ts that is its oldest sample.
+ */
+static int
+find_first_after(struct m_ff_vec3_f32 *gyro_ff, int64_t base_ts)
+{
+	int i = 0;
+	uint64_t imu_ts = UINT64_MAX;
+	xrt_vec3 _;
+	while (m_ff_vec3_f32_get(gyro_ff, i, &_, &imu_ts)) {
+		if ((int64_t)imu_ts < base_ts) {
+			break;
+		}
+		i++;
+	}
+
+	return i - 1;
+}
+
+static void
+get_synced_sample(
+    struct m_ff_vec3_f32 *gyro_ff, struct m_ff_vec3_f32 *accel_ff, int i, xrt_vec3 &g, xrt_vec3 &a, int64_t &ts)
+{
+	uint64_t g_ts{};
+	uint64_t a_ts{};
+	bool got = true;
+	got &= m_ff_vec3_f32_get(gyro_ff, i, &g, &g_ts);
+	got &= m_ff_vec3_f32_get(accel_ff, i, &a, &a_ts);
+	assert(got && g_ts == a_ts && "Failure getting synced gyro and accel samples");
+	(void)got;
+
+	ts = (int64_t)g_ts;
+}
+
+static void
+push_step(m_imu_preintegration &pre, int64_t ts, const xrt_vec3 &gyro, const xrt_vec3 &accel)
+{
+	// The fifos no longer reach back to the base pose.
+	if (pre.steps.size() + 1 >= pre.max_steps) {
+		pre.valid = false;
+		pre.steps.clear();
+		return;
+	}
+
+	const bool empty = pre.steps.empty();
+	int64_t prev_ts = empty ? pre.base_ts : pre.steps.back().ts;
+
+	imu_preintegration_step step{ts, gyro, accel, empty ? pre.base_rel : pre.steps.back().rel};
+	float dt = (float)time_ns_to_s(ts - prev_ts);
+	m_imu_integrate_sample(&gyro, &accel, &pre.gravity_correction, dt, &step.rel);
+
+	pre.steps.push_back(step);
+}
+
+static bool
+rebuild(m_imu_preintegration &pre,
+        struct m_ff_vec3_f32 *gyro_ff,
+        struct m_ff_vec3_f32 *accel_ff,
+        const xrt_vec3 &gravity_correction,
+        const xrt_space_relation &base_rel,
+        int64_t base_ts)
+{
+	pre.valid = false;
+	pre.steps.clear();
+
+	// Unlike the fifo path, give up if the fifos don't reach back to the base pose.
+	int first = find_first_after(gyro_ff, base_ts);
+	if (first + 1 >= (int)m_ff_vec3_f32_get_num(gyro_ff)) {
+		return false;
+	}
+
+	pre.base_ts = base_ts;
+	pre.base_rel = base_rel;
+	pre.gravity_correction = gravity_correction;
+	pre.valid = true;
+
+	for (int i = first; i >= 0; i--) {
+		xrt_vec3 g{};
+		xrt_vec3 a{};
+		int64_t ts = 0;
+		get_synced_sample(gyro_ff, accel_ff, i, g, a, ts);
+
+		push_step(pre, ts, g, a);
+	}
+
+	return pre.valid;
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+extern "C" void
+m_imu_integrate_sample(const struct xrt_vec3 *gyro,
+                       const struct xrt_vec3 *accel,
+                       const struct xrt_vec3 *gravity_correction,
+                       float dt,
+                       struct xrt_space_relation *rel)
+{
+	const xrt_vec3 &g = *gyro;
+	const xrt_vec3 &a = *accel;
+	xrt_quat &o = rel->pose.orientation;
+	xrt_vec3 &p = rel->pose.position;
+	xrt_vec3 &w = rel->angular_velocity;
+	xrt_vec3 &v = rel->linear_velocity;
+
+	// Integrate gyroscope
+	xrt_quat angvel_delta{};
+	xrt_vec3 scaled_half_g = g * dt * 0.5f;
+	math_quat_exp(&scaled_half_g, &angvel_delta); // Same as using math_quat_from_angle_vector(g/dt)
+	math_quat_rotate(&o, &angvel_delta, &o);      // Orientation
+	math_quat_rotate_derivative(&o, &g, &w);      // Angular velocity
+
+	// Integrate accelerometer
+	xrt_vec3 world_accel{};
+	math_quat_rotate_vec3(&o, &a, &world_accel);
+	world_accel += *gravity_correction;
+	v += world_accel * dt;                        // Linear velocity
+	p += v * dt + world_accel * (dt * dt * 0.5f); // Position
+}
+
+extern "C" bool
+m_imu_integration_predict_from_fifos(struct m_ff_vec3_f32 *gyro_ff,
+                                     struct m_ff_vec3_f32 *accel_ff,
+                                     const struct xrt_vec3 *gravity_correction,
+                                     const struct xrt_space_relation *base_rel,
+                                     int64_t base_ts,
+                                     int64_t when_ns,
+                                     struct xrt_space_relation *out_relation)
+{
+	int i = find_first_after(gyro_ff, base_ts);
+	bool had_samples = i >= 0;
+
+	xrt_space_relation integ_rel = *base_rel;
+	int64_t integ_rel_ts = base_ts;
+	bool clamped = false; // If when_ns is older than the latest IMU ts
+
+	for (; i >= 0; i--) { // Decreasing i increases timestamp
+		xrt_vec3 g{};
+		xrt_vec3 a{};
+		int64_t ts = 0;
+		get_synced_sample(gyro_ff, accel_ff, i, g, a, ts);
+
+		if (ts > when_ns) {
+			clamped = true;
+			//! @todo Instead of using same a and g values, do an interpolated sample like this:
+			// a = prev_a + ((when_ns - prev_ts) / (ts - prev_ts)) * (a - prev_a);
+			// g = prev_g + ((when_ns - prev_ts) / (ts - prev_ts)) * (g - prev_g);
+			ts = when_ns; // clamp ts to when_ns
+		}
+		assert(ts >= base_ts && "Accessing imu sample that is older than the base pose");
+
+		// Update time
+		float dt = (float)time_ns_to_s(ts - integ_rel_ts);
+		integ_rel_ts = ts;
+
+		m_imu_integrate_sample(&g, &a, gravity_correction, dt, &integ_rel);
+
+		if (clamped) {
+			break;
+		}
+	}
+
+	// Do the prediction based on the updated relation
+	double last_imu_to_now_dt = time_ns_to_s(when_ns - integ_rel_ts);
+	xrt_space_relation predicted_relation{};
+	m_predict_relation(&integ_rel, last_imu_to_now_dt, &predicted_relation);
+
+	*out_relation = predicted_relation;
+
+	return had_samples;
+}
+
+extern "C" void
+m_imu_preintegration_create(size_t max_steps, struct m_imu_preintegration **out_pre)
+{
+	m_imu_preintegration *pre = new m_imu_preintegration;
+	pre->max_steps = max_steps;
+	pre->steps.reserve(max_steps);
+
+	*out_pre = pre;
+}
+
+extern "C" void
+m_imu_preintegration_destroy(struct m_imu_preintegration **pre_ptr)
+{
+	delete *pre_ptr;
+	*pre_ptr = NULL;
+}
+
+extern "C" void
+m_imu_preintegration_push(struct m_imu_preintegration *pre,
+                          int64_t ts,
+                          const struct xrt_vec3 *gyro,
+                          const struct xrt_vec3 *accel)
+{
+	if (!pre->valid) {
+		return;
+	}
+
+	push_step(*pre, ts, *gyro, *accel);
+}
+
+extern "C" bool
+m_imu_preintegration_predict(struct m_imu_preintegration *pre,
+                             struct m_ff_vec3_f32 *gyro_ff,
+                             struct m_ff_vec3_f32 *accel_ff,
+                             const struct xrt_vec3 *gravity_correction,
+                             const struct xrt_space_relation *base_rel,
+                             int64_t base_ts,
+                             int64_t when_ns,
+                             struct xrt_space_relation *out_relation)
+{
+	const xrt_vec3 &gc = *gravity_correction;
+	const xrt_vec3 &pre_gc = pre->gravity_correction;
+	bool gravity_changed = gc.x != pre_gc.x || gc.y != pre_gc.y || gc.z != pre_gc.z;
+	bool stale = !pre->valid || pre->base_ts != base_ts || gravity_changed;
+	if (stale && !rebuild(*pre, gyro_ff, accel_ff, gc, *base_rel, base_ts)) {
+		return false;
+	}
+
+	// First sample newer than when_ns, it is only integrated up to when_ns.
+	auto next = std::upper_bound(pre->steps.begin(), pre->steps.end(), when_ns,
+	                             [](int64_t ts, const imu_preintegration_step &s) { return ts < s.ts; });
+
+	bool first = next == pre->steps.begin();
+	xrt_space_relation integ_rel = first ? pre->base_rel : std::prev(next)->rel;
+	int64_t integ_rel_ts = first ? pre->base_ts : std::prev(next)->ts;
+
+	if (next != pre->steps.end()) {
+		float dt = (float)time_ns_to_s(when_ns - integ_rel_ts);
+		integ_rel_ts = when_ns;
+		m_imu_integrate_sample(&next->gyro, &next->accel, &pre->gravity_correction, dt, &integ_rel);
+	}
+
+	// Do the prediction based on the updated relation
+	double last_imu_to_now_dt = time_ns_to_s(when_ns - integ_rel_ts);
+	xrt_space_relation predicted_relation{};
+	m_predict_relation(&integ_rel, last_imu_to_now_dt, &predicted_relation);
+
+	*out_relation = predicted_relation;
+
+	return true;
+}
+
+extern "C" size_t
+m_imu_preintegration_get_step_count(const struct m_imu_preintegration *pre)
+{
+	return pre->steps.size();
+}
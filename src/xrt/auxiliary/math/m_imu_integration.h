@@ -0,0 +1,128 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Integration of IMU samples on top of a tracked pose, with a cache of
+ *         the samples already integrated.
+ * @ingroup aux_math
+ */
+
+#pragma once
+
+#include "xrt/xrt_defines.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+struct m_ff_vec3_f32;
+
+/*!
+ * Integrates one IMU sample taken @p dt seconds after @p rel into it, the
+ * @p gravity_correction is added to the accelerometer once in world space.
+ *
+ * @ingroup aux_math
+ */
+void
+m_imu_integrate_sample(const struct xrt_vec3 *gyro,
+                       const struct xrt_vec3 *accel,
+                       const struct xrt_vec3 *gravity_correction,
+                       float dt,
+                       struct xrt_space_relation *rel);
+
+/*!
+ * Integrates every sample in the synced @p gyro_ff and @p accel_ff fifos taken
+ * after @p base_ts on top of @p base_rel. The sample after @p when_ns is only
+ * integrated up to it, then the result is predicted to @p when_ns. If the
+ * fifos don't reach back to @p base_ts the samples start at the oldest one.
+ *
+ * Not thread safe, the caller protects the fifos.
+ *
+ * @return false if there were no samples after @p base_ts, the result is then
+ *         only predicted from @p base_rel.
+ *
+ * @ingroup aux_math
+ */
+bool
+m_imu_integration_predict_from_fifos(struct m_ff_vec3_f32 *gyro_ff,
+                                     struct m_ff_vec3_f32 *accel_ff,
+                                     const struct xrt_vec3 *gravity_correction,
+                                     const struct xrt_space_relation *base_rel,
+                                     int64_t base_ts,
+                                     int64_t when_ns,
+                                     struct xrt_space_relation *out_relation);
+
+/*!
+ * The samples since a base pose, each with the relation after integrating it,
+ * so a prediction only needs to do one partial step instead of integrating
+ * every sample again. Gives the same result as
+ * @ref m_imu_integration_predict_from_fifos, bit for bit.
+ *
+ * Not thread safe, the caller protects it together with the fifos.
+ *
+ * @ingroup aux_math
+ */
+struct m_imu_preintegration;
+
+/*!
+ * Creates an empty preintegration, that gives up once it would hold
+ * @p max_steps samples. Should match the size of the fifos.
+ *
+ * @public @memberof m_imu_preintegration
+ */
+void
+m_imu_preintegration_create(size_t max_steps, struct m_imu_preintegration **out_pre);
+
+/*!
+ * Destroys the preintegration and sets @p pre_ptr to NULL.
+ *
+ * @public @memberof m_imu_preintegration
+ */
+void
+m_imu_preintegration_destroy(struct m_imu_preintegration **pre_ptr);
+
+/*!
+ * Integrates a new sample, pushed to the fifos at the same time. Does nothing
+ * until the next @ref m_imu_preintegration_predict has rebuilt it from the
+ * fifos.
+ *
+ * @public @memberof m_imu_preintegration
+ */
+void
+m_imu_preintegration_push(struct m_imu_preintegration *pre,
+                          int64_t ts,
+                          const struct xrt_vec3 *gyro,
+                          const struct xrt_vec3 *accel);
+
+/*!
+ * Same arguments and result as @ref m_imu_integration_predict_from_fifos.
+ * Rebuilds from the fifos when @p base_ts or @p gravity_correction changed.
+ *
+ * @return false if the fifos don't reach back to @p base_ts, or the samples
+ *         since then don't fit, nothing is written to @p out_relation then.
+ *
+ * @public @memberof m_imu_preintegration
+ */
+bool
+m_imu_preintegration_predict(struct m_imu_preintegration *pre,
+                             struct m_ff_vec3_f32 *gyro_ff,
+                             struct m_ff_vec3_f32 *accel_ff,
+                             const struct xrt_vec3 *gravity_correction,
+                             const struct xrt_space_relation *base_rel,
+                             int64_t base_ts,
+                             int64_t when_ns,
+                             struct xrt_space_relation *out_relation);
+
+/*!
+ * Number of samples integrated since the base pose.
+ *
+ * @public @memberof m_imu_preintegration
+ */
+size_t
+m_imu_preintegration_get_step_count(const struct m_imu_preintegration *pre);
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -73,6 +73,7 @@ do_orientation(const struct xrt_space_relation *rel,
 static void
 do_position(const struct xrt_space_relation *rel,
             enum xrt_space_relation_flags flags,
+            const struct xrt_vec3 *linear_acceleration,
             double delta_s,
             struct xrt_space_relation *out_rel)
 {
@@ -96,6 +97,17 @@ do_position(const struct xrt_space_relation *rel,
 		out_rel->pose.position = m_vec3_add(rel->pose.position, m_vec3_mul_scalar(accum, (float)delta_s));
 	}
 
+	if (valid_linear_velocity && linear_acceleration != NULL) {
+		const struct xrt_vec3 dv = m_vec3_mul_scalar(*linear_acceleration, (float)delta_s);
+
+		if (valid_position) {
+			out_rel->pose.position =
+			    m_vec3_add(out_rel->pose.position, m_vec3_mul_scalar(dv, 0.5f * (float)delta_s));
+		}
+
+		accum = m_vec3_add(accum, dv);
+	}
+
 	// We use the new linear velocity with the acceleration integrated.
 	if (valid_linear_velocity) {
 		out_rel->linear_velocity = accum;
@@ -109,7 +121,33 @@ m_predict_relation(const struct xrt_space_relation *rel, double delta_s, struct
 	enum xrt_space_relation_flags flags = rel->relation_flags;
 
 	do_orientation(rel, flags, delta_s, out_rel);
-	do_position(rel, flags, delta_s, out_rel);
+	do_position(rel, flags, NULL, delta_s, out_rel);
+
+	out_rel->relation_flags = flags;
+}
+
+void
+m_predict_relation_with_acceleration(const struct xrt_space_relation *rel,
+                                     const struct xrt_vec3 *linear_acceleration,
+                                     double delta_s,
+                                     struct xrt_space_relation *out_rel)
+{
+	XRT_TRACE_MARKER();
+	enum xrt_space_relation_flags flags = rel->relation_flags;
+
+	do_orientation(rel, flags, delta_s, out_rel);
+	do_position(rel, flags, linear_acceleration, delta_s, out_rel);
 
 	out_rel->relation_flags = flags;
 }
+
+const char *
+m_predict_model_str(enum m_predict_model model)
+{
+	switch (model) {
+	case M_PREDICT_MODEL_CONSTANT_VELOCITY: return "constant_velocity";
+	case M_PREDICT_MODEL_CONSTANT_ACCELERATION: return "constant_acceleration";
+	case M_PREDICT_MODEL_FILTERED: return "filtered";
+	default: return "unknown";
+	}
+}
@@ -17,6 +17,25 @@ extern "C" {
 #endif
 
 
+/*!
+ * The motion models a predicted relation can be made with, used by
+ * @ref m_relation_history to pick and evaluate how to extrapolate.
+ *
+ * @ingroup aux_math
+ */
+enum m_predict_model
+{
+	//! Extrapolate the velocities of the latest relation, @ref m_predict_relation.
+	M_PREDICT_MODEL_CONSTANT_VELOCITY = 0,
+	//! Also integrate an estimated linear acceleration.
+	M_PREDICT_MODEL_CONSTANT_ACCELERATION,
+	//! Constant velocity with the velocities smoothed over the last samples.
+	M_PREDICT_MODEL_FILTERED,
+
+	M_PREDICT_MODEL_COUNT,
+};
+
+
 /*!
  * Using the given @p xrt_space_relation predicts a new @p xrt_space_relation
  * @p delta_s into the future.
@@ -29,6 +48,29 @@ extern "C" {
 void
 m_predict_relation(const struct xrt_space_relation *rel, double delta_s, struct xrt_space_relation *out_rel);
 
+/*!
+ * Same as @ref m_predict_relation but also integrates @p linear_acceleration
+ * into the position and linear velocity, if the relation has a valid linear
+ * velocity. The angular velocity is kept constant, angular acceleration is way
+ * too noisy to be of use.
+ *
+ * @ingroup aux_math
+ */
+void
+m_predict_relation_with_acceleration(const struct xrt_space_relation *rel,
+                                     const struct xrt_vec3 *linear_acceleration,
+                                     double delta_s,
+                                     struct xrt_space_relation *out_rel);
+
+/*!
+ * Short name of the model, as used by the `XRT_PREDICTION_MODEL` environment
+ * variable.
+ *
+ * @ingroup aux_math
+ */
+const char *
+m_predict_model_str(enum m_predict_model model);
+
 
 #ifdef __cplusplus
 }
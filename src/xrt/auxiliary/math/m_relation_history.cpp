@@ -22,13 +22,20 @@
 #include "os/os_time.h"
 #include "os/os_threading.h"
 
+#include "util/u_var.h"
+#include "util/u_time.h"
+#include "util/u_debug.h"
 #include "util/u_logging.h"
+#include "util/u_metrics.h"
 #include "util/u_trace_marker.h"
-#include "util/u_template_historybuf.hpp"
+#include "util/u_template_historybuf_soa.hpp"
 
 #include <memory>
+#include <atomic>
 #include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <cinttypes>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
@@ -38,6 +45,9 @@
 using namespace xrt::auxiliary::util;
 namespace os = xrt::auxiliary::os;
 
+DEBUG_GET_ONCE_OPTION(prediction_model, "XRT_PREDICTION_MODEL", NULL)
+DEBUG_GET_ONCE_BOOL_OPTION(prediction_eval, "XRT_PREDICTION_EVAL", false)
+
 struct relation_history_entry
 {
 	struct xrt_space_relation relation;
@@ -46,21 +56,402 @@ struct relation_history_entry
 
 static constexpr size_t BufLen = 4096;
 
+//! How many predictions can wait for their sample to arrive at the same time.
+static constexpr size_t PendingLen = 32;
+
+//! Predictions further out than this are not evaluated, nobody should be asking for them.
+static constexpr int64_t MaxEvalHorizonNs = 200 * U_TIME_1MS_IN_NS;
+
+//! Time constant of the smoothing used for the velocities and acceleration.
+static constexpr double MotionTauS = 0.02;
+
+//! Number of bins in the error histograms, the last one also holds everything larger.
+static constexpr int HistBins = 32;
+static constexpr float HistMaxPositionM = 0.05f;
+static constexpr float HistMaxOrientationRad = (float)(5.0 * M_PI / 180.0);
+
+//! Weight of a new error in the running average.
+static constexpr float ErrorAlpha = 0.05f;
+
+//! Orientation errors are weighted as the displacement they cause at this distance, in meters per radian.
+static constexpr float OrientationWeightM = 1.0f;
+
+//! Evaluations needed before the adaptive selection trusts the averages.
+static constexpr uint64_t AdaptiveMinCount = 30;
+
+//! A model needs to be this much better than the current one to switch to it, stops flapping.
+static constexpr float AdaptiveHysteresis = 0.9f;
+
+static std::atomic<uint64_t> g_next_id{1};
+
+/*!
+ * A prediction made by @ref m_relation_history_get with every model, waiting
+ * for the sample at its timestamp to arrive.
+ */
+struct pending_prediction
+{
+	int64_t timestamp;
+	int64_t horizon_ns;
+	struct xrt_space_relation relations[M_PREDICT_MODEL_COUNT];
+};
+
+struct prediction_stats
+{
+	uint64_t count;
+
+	//! Running averages of the errors.
+	float position_error_m;
+	float orientation_error_rad;
+
+	float position_hist[HistBins];
+	float orientation_hist[HistBins];
+
+	struct u_var_histogram_f32 position_hist_var;
+	struct u_var_histogram_f32 orientation_hist_var;
+};
+
 struct m_relation_history
 {
 	mutable os::Mutex mutex;
 
-	HistoryBuffer<struct relation_history_entry, BufLen> impl;
+	//! Timestamps apart from the relations, the lookups only search the timestamps.
+	HistoryBufferSoA<BufLen, struct xrt_space_relation> impl;
 
 	struct m_relation_history_filters *motion_vector_filters;
+
+	//! Tells the histories apart in the metrics.
+	uint64_t id;
+
+	//! The @ref m_predict_model used to predict, an int for the combo box.
+	int model;
+
+	//! Switch to the model with the lowest error, needs @ref evaluate.
+	bool adaptive;
+
+	//! Compare predictions with the samples that later arrive.
+	bool evaluate;
+
+	//! Motion smoothed over the pushed samples, used by the non constant velocity models.
+	struct
+	{
+		struct xrt_vec3 linear_velocity;
+		struct xrt_vec3 angular_velocity;
+		struct xrt_vec3 linear_acceleration;
+	} motion;
+
+	//! Written by the const get function, always under the mutex.
+	mutable struct
+	{
+		struct pending_prediction entries[PendingLen];
+		uint32_t count;
+	} pending;
+
+	struct prediction_stats stats[M_PREDICT_MODEL_COUNT];
+
+	struct u_var_combo model_combo;
 };
 
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+static relation_history_entry
+entry_from_row(const HistoryBufSoARow<true, struct xrt_space_relation> &row)
+{
+	return {row.get(), row.timestamp};
+}
+
+static void
+interpolate(const relation_history_entry &predecessor,
+            const relation_history_entry &successor,
+            int64_t at_timestamp_ns,
+            struct xrt_space_relation *out_relation)
+{
+	int64_t diff_before = static_cast<int64_t>(at_timestamp_ns) - predecessor.timestamp;
+	int64_t diff_after = static_cast<int64_t>(successor.timestamp) - at_timestamp_ns;
+
+	float amount_to_lerp = (float)diff_before / (float)(diff_before + diff_after);
+
+	// Copy intersection of relation flags
+	xrt_space_relation result{};
+	result.relation_flags =
+	    (enum xrt_space_relation_flags)(predecessor.relation.relation_flags & successor.relation.relation_flags);
+	// First-order implementation - lerp between the before and after
+	if (0 != (result.relation_flags & XRT_SPACE_RELATION_POSITION_VALID_BIT)) {
+		result.pose.position =
+		    m_vec3_lerp(predecessor.relation.pose.position, successor.relation.pose.position, amount_to_lerp);
+	}
+	if (0 != (result.relation_flags & XRT_SPACE_RELATION_ORIENTATION_VALID_BIT)) {
+
+		math_quat_slerp(&predecessor.relation.pose.orientation, &successor.relation.pose.orientation,
+		                amount_to_lerp, &result.pose.orientation);
+	}
+
+	//! @todo Does interpolating the velocities make any sense?
+	if (0 != (result.relation_flags & XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT)) {
+		result.angular_velocity = m_vec3_lerp(predecessor.relation.angular_velocity,
+		                                      successor.relation.angular_velocity, amount_to_lerp);
+	}
+	if (0 != (result.relation_flags & XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT)) {
+		result.linear_velocity = m_vec3_lerp(predecessor.relation.linear_velocity,
+		                                     successor.relation.linear_velocity, amount_to_lerp);
+	}
+	*out_relation = result;
+}
+
+static void
+predict(const struct m_relation_history *rh,
+        enum m_predict_model model,
+        double delta_s,
+        struct xrt_space_relation *out_relation)
+{
+	const struct xrt_space_relation &latest = rh->impl.back();
+
+	switch (model) {
+	case M_PREDICT_MODEL_CONSTANT_ACCELERATION:
+		m_predict_relation_with_acceleration(&latest, &rh->motion.linear_acceleration, delta_s, out_relation);
+		break;
+	case M_PREDICT_MODEL_FILTERED: {
+		struct xrt_space_relation filtered = latest;
+		filtered.linear_velocity = rh->motion.linear_velocity;
+		filtered.angular_velocity = rh->motion.angular_velocity;
+		m_predict_relation(&filtered, delta_s, out_relation);
+	} break;
+	default: m_predict_relation(&latest, delta_s, out_relation); break;
+	}
+}
+
+/*!
+ * Update the smoothed motion with a new sample, @p previous is the entry that
+ * was at the back of the buffer before it, if any.
+ */
+static void
+update_motion(struct m_relation_history *rh,
+              const relation_history_entry *previous,
+              const struct xrt_space_relation &relation,
+              int64_t timestamp)
+{
+	const enum xrt_space_relation_flags flags = relation.relation_flags;
+	const bool has_lin = (flags & XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT) != 0;
+	const bool has_ang = (flags & XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT) != 0;
+
+	if (previous == nullptr) {
+		rh->motion.linear_velocity = has_lin ? relation.linear_velocity : xrt_vec3{};
+		rh->motion.angular_velocity = has_ang ? relation.angular_velocity : xrt_vec3{};
+		rh->motion.linear_acceleration = {};
+		return;
+	}
+
+	const enum xrt_space_relation_flags prev_flags = previous->relation.relation_flags;
+	const double dt = time_ns_to_s(timestamp - previous->timestamp);
+	const float alpha = (float)(dt / (MotionTauS + dt));
+
+	if (has_lin && (prev_flags & XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT) != 0) {
+		struct xrt_vec3 accel = (relation.linear_velocity - previous->relation.linear_velocity) / (float)dt;
+		rh->motion.linear_acceleration = m_vec3_lerp(rh->motion.linear_acceleration, accel, alpha);
+		rh->motion.linear_velocity = m_vec3_lerp(rh->motion.linear_velocity, relation.linear_velocity, alpha);
+	} else {
+		rh->motion.linear_velocity = has_lin ? relation.linear_velocity : xrt_vec3{};
+		rh->motion.linear_acceleration = {};
+	}
+
+	if (has_ang && (prev_flags & XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT) != 0) {
+		rh->motion.angular_velocity =
+		    m_vec3_lerp(rh->motion.angular_velocity, relation.angular_velocity, alpha);
+	} else {
+		rh->motion.angular_velocity = has_ang ? relation.angular_velocity : xrt_vec3{};
+	}
+}
+
+static void
+add_pending(const struct m_relation_history *rh, int64_t at_timestamp_ns, int64_t horizon_ns)
+{
+	auto &pending = rh->pending;
+
+	// The same display time is asked for many times, keep the one furthest out.
+	uint32_t oldest = 0;
+	for (uint32_t i = 0; i < pending.count; i++) {
+		if (pending.entries[i].timestamp == at_timestamp_ns) {
+			return;
+		}
+		if (pending.entries[i].timestamp < pending.entries[oldest].timestamp) {
+			oldest = i;
+		}
+	}
+
+	struct pending_prediction *p = nullptr;
+	if (pending.count < PendingLen) {
+		p = &pending.entries[pending.count++];
+	} else {
+		p = &pending.entries[oldest];
+	}
+
+	p->timestamp = at_timestamp_ns;
+	p->horizon_ns = horizon_ns;
+
+	const double delta_s = time_ns_to_s(horizon_ns);
+	for (uint32_t m = 0; m < M_PREDICT_MODEL_COUNT; m++) {
+		predict(rh, (enum m_predict_model)m, delta_s, &p->relations[m]);
+	}
+}
+
+static void
+add_to_hist(float *hist, float value, float max)
+{
+	int bin = (int)(value / max * (float)HistBins);
+	hist[std::min(std::max(bin, 0), HistBins - 1)] += 1.0f;
+}
+
+static float
+score(const struct prediction_stats &stats)
+{
+	return stats.position_error_m + stats.orientation_error_rad * OrientationWeightM;
+}
+
+static void
+select_model(struct m_relation_history *rh)
+{
+	int best = rh->model;
+	for (int m = 0; m < M_PREDICT_MODEL_COUNT; m++) {
+		if (rh->stats[m].count >= AdaptiveMinCount && score(rh->stats[m]) < score(rh->stats[best])) {
+			best = m;
+		}
+	}
+
+	if (best == rh->model || score(rh->stats[best]) >= score(rh->stats[rh->model]) * AdaptiveHysteresis) {
+		return;
+	}
+
+	U_LOG_D("Switching prediction model of history %" PRIu64 " from '%s' to '%s'", rh->id,
+	        m_predict_model_str((enum m_predict_model)rh->model), m_predict_model_str((enum m_predict_model)best));
+
+	rh->model = best;
+}
+
+/*!
+ * Evaluate the pending predictions that @p entry is the first sample at or
+ * after, @p previous is the sample before it. Errors to be written to the
+ * metrics file are returned in @p out_metrics.
+ */
+static uint32_t
+evaluate_pending(struct m_relation_history *rh,
+                 const relation_history_entry &previous,
+                 const relation_history_entry &entry,
+                 struct u_metrics_prediction_error *out_metrics,
+                 uint32_t max_metrics)
+{
+	auto &pending = rh->pending;
+	uint32_t metrics_count = 0;
+	bool evaluated = false;
+
+	for (uint32_t i = 0; i < pending.count;) {
+		const struct pending_prediction &p = pending.entries[i];
+		if (p.timestamp > entry.timestamp) {
+			i++;
+			continue;
+		}
+
+		struct xrt_space_relation truth;
+		if (p.timestamp == entry.timestamp) {
+			truth = entry.relation;
+		} else {
+			interpolate(previous, entry, p.timestamp, &truth);
+		}
+
+		for (uint32_t m = 0; m < M_PREDICT_MODEL_COUNT; m++) {
+			const struct xrt_space_relation &predicted = p.relations[m];
+			const uint32_t flags = truth.relation_flags & predicted.relation_flags;
+			const bool has_pos = (flags & XRT_SPACE_RELATION_POSITION_VALID_BIT) != 0;
+			const bool has_ori = (flags & XRT_SPACE_RELATION_ORIENTATION_VALID_BIT) != 0;
+			if (!has_pos && !has_ori) {
+				continue;
+			}
+
+			struct prediction_stats &stats = rh->stats[m];
+			// The first error starts the running averages.
+			const float alpha = stats.count == 0 ? 1.0f : ErrorAlpha;
+			float pos_error = 0.0f;
+			float ori_error = 0.0f;
+
+			if (has_pos) {
+				pos_error = m_vec3_len(predicted.pose.position - truth.pose.position);
+				stats.position_error_m += (pos_error - stats.position_error_m) * alpha;
+				add_to_hist(stats.position_hist, pos_error, HistMaxPositionM);
+			}
+
+			if (has_ori) {
+				const struct xrt_quat &a = predicted.pose.orientation;
+				const struct xrt_quat &b = truth.pose.orientation;
+				float dot = fabsf(a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w);
+				ori_error = 2.0f * acosf(std::min(dot, 1.0f));
+				stats.orientation_error_rad += (ori_error - stats.orientation_error_rad) * alpha;
+				add_to_hist(stats.orientation_hist, ori_error, HistMaxOrientationRad);
+			}
+
+			stats.count++;
+			evaluated = true;
+
+			if (metrics_count < max_metrics) {
+				out_metrics[metrics_count++] = {
+				    rh->id,                 // history_id
+				    m,                      // model
+				    (uint64_t)p.timestamp,  // predicted_time_ns
+				    (uint64_t)p.horizon_ns, // horizon_ns
+				    pos_error,              // position_error_m
+				    ori_error,              // orientation_error_rad
+				};
+			}
+		}
+
+		// Swap remove, the order doesn't matter.
+		pending.entries[i] = pending.entries[--pending.count];
+	}
+
+	if (evaluated && rh->adaptive) {
+		select_model(rh);
+	}
+
+	return metrics_count;
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
 void
 m_relation_history_create(struct m_relation_history **rh_ptr, struct m_relation_history_filters *motion_vector_filters)
 {
 	auto ret = std::make_unique<m_relation_history>();
 
 	ret->motion_vector_filters = motion_vector_filters;
+	ret->id = g_next_id++;
+	ret->model = M_PREDICT_MODEL_CONSTANT_VELOCITY;
+
+	const char *model = debug_get_option_prediction_model();
+	if (model != NULL) {
+		bool found = false;
+		for (int m = 0; m < M_PREDICT_MODEL_COUNT; m++) {
+			if (strcmp(model, m_predict_model_str((enum m_predict_model)m)) == 0) {
+				ret->model = m;
+				found = true;
+			}
+		}
+		if (strcmp(model, "adaptive") == 0) {
+			ret->adaptive = true;
+			found = true;
+		}
+		if (!found) {
+			U_LOG_W("Unknown XRT_PREDICTION_MODEL '%s', using constant velocity", model);
+		}
+	}
+
+	ret->evaluate = ret->adaptive || debug_get_bool_option_prediction_eval() || u_metrics_is_active();
 
 	*rh_ptr = ret.release();
 }
@@ -73,19 +464,40 @@ m_relation_history_push(struct m_relation_history *rh, struct xrt_space_relation
 	rhe.relation = *in_relation;
 	rhe.timestamp = timestamp;
 	bool ret = false;
+	// Room for every pending prediction to be evaluated with every model.
+	struct u_metrics_prediction_error metrics[PendingLen * M_PREDICT_MODEL_COUNT];
+	uint32_t metrics_count = 0;
 	std::unique_lock<os::Mutex> lock(rh->mutex);
 	try {
 		// if we aren't empty, we can compare against the latest timestamp.
-		if (rh->impl.empty() || rhe.timestamp > rh->impl.back().timestamp) {
+		if (rh->impl.empty() || rhe.timestamp > rh->impl.back_timestamp()) {
+			relation_history_entry previous_entry;
+			const relation_history_entry *previous = nullptr;
+			if (!rh->impl.empty()) {
+				previous_entry = {rh->impl.back(), rh->impl.back_timestamp()};
+				previous = &previous_entry;
+			}
+			if (previous != nullptr && rh->pending.count > 0) {
+				metrics_count = evaluate_pending(rh, *previous, rhe, metrics, ARRAY_SIZE(metrics));
+			}
+			update_motion(rh, previous, rhe.relation, rhe.timestamp);
+
 			// Everything explodes if the timestamps in relation_history aren't monotonically increasing. If
 			// we get a timestamp that's before the most recent timestamp in the buffer, don't put it
 			// in the history.
-			rh->impl.push_back(rhe);
+			rh->impl.push_back(rhe.timestamp, rhe.relation);
 			ret = true;
 		}
 	} catch (std::exception const &e) {
 		U_LOG_E("Caught exception: %s", e.what());
 	}
+	lock.unlock();
+
+	// Don't hold the lock while writing to the file.
+	for (uint32_t i = 0; i < metrics_count; i++) {
+		u_metrics_write_prediction_error(&metrics[i]);
+	}
+
 	return ret;
 }
 
@@ -105,31 +517,32 @@ m_relation_history_get(const struct m_relation_history *rh,
 		const auto b = rh->impl.begin();
 		const auto e = rh->impl.end();
 
-		// Find the first element *not less than* our value. the lambda we pass is the comparison
-		// function, to compare against timestamps.
-		const auto it =
-		    std::lower_bound(b, e, at_timestamp_ns, [](const relation_history_entry &rhe, int64_t timestamp) {
-			    return rhe.timestamp < timestamp;
-		    });
+		// Find the first element *not less than* our value, samples mostly arrive at a fixed rate so
+		// guessing from the timestamps finds it in a probe or two.
+		const auto it = rh->impl.interpolation_lower_bound(at_timestamp_ns);
 
 		if (it == e) {
 			// lower bound is at the end:
 			// The desired timestamp is after what our buffer contains.
 			// (pose-prediction)
 			// Output flags match the most recent buffer entry.
-			int64_t diff_prediction_ns = static_cast<int64_t>(at_timestamp_ns) - rh->impl.back().timestamp;
+			int64_t diff_prediction_ns = static_cast<int64_t>(at_timestamp_ns) - rh->impl.back_timestamp();
 			double delta_s = time_ns_to_s(diff_prediction_ns);
 
 			U_LOG_T("Extrapolating %f s past the back of the buffer!", delta_s);
 
-			m_predict_relation(&rh->impl.back().relation, delta_s, out_relation);
+			if (rh->evaluate && diff_prediction_ns <= MaxEvalHorizonNs) {
+				add_pending(rh, at_timestamp_ns, diff_prediction_ns);
+			}
+
+			predict(rh, (enum m_predict_model)rh->model, delta_s, out_relation);
 			return M_RELATION_HISTORY_RESULT_PREDICTED;
 		}
-		if (at_timestamp_ns == it->timestamp) {
+		if (at_timestamp_ns == it.timestamp()) {
 			// exact match:
 			// Flags copied directly along with everything else.
 			U_LOG_T("Exact match in the buffer!");
-			*out_relation = it->relation;
+			*out_relation = it->get();
 			return M_RELATION_HISTORY_RESULT_EXACT;
 		}
 		if (it == b) {
@@ -137,50 +550,17 @@ m_relation_history_get(const struct m_relation_history *rh,
 			// The desired timestamp is before what our buffer contains.
 			// (an edge case where somebody asks for a really old pose and we do our best)
 			// Output flags are the same as the input flags for the history entry we use
-			int64_t diff_prediction_ns = static_cast<int64_t>(at_timestamp_ns) - rh->impl.front().timestamp;
+			int64_t diff_prediction_ns = static_cast<int64_t>(at_timestamp_ns) - rh->impl.front_timestamp();
 			double delta_s = time_ns_to_s(diff_prediction_ns);
 			U_LOG_T("Extrapolating %f s before the front of the buffer!", delta_s);
-			m_predict_relation(&rh->impl.front().relation, delta_s, out_relation);
+			m_predict_relation(&rh->impl.front(), delta_s, out_relation);
 			return M_RELATION_HISTORY_RESULT_REVERSE_PREDICTED;
 		}
 		U_LOG_T("Interpolating within buffer!");
 
 		// We precede *it and follow *(it - 1) (which we know exists because we already handled
 		// the it = begin() case)
-		const auto &predecessor = *(it - 1);
-		const auto &successor = *it;
-
-		// Do the thing.
-		int64_t diff_before = static_cast<int64_t>(at_timestamp_ns) - predecessor.timestamp;
-		int64_t diff_after = static_cast<int64_t>(successor.timestamp) - at_timestamp_ns;
-
-		float amount_to_lerp = (float)diff_before / (float)(diff_before + diff_after);
-
-		// Copy intersection of relation flags
-		xrt_space_relation result{};
-		result.relation_flags = (enum xrt_space_relation_flags)(predecessor.relation.relation_flags &
-		                                                        successor.relation.relation_flags);
-		// First-order implementation - lerp between the before and after
-		if (0 != (result.relation_flags & XRT_SPACE_RELATION_POSITION_VALID_BIT)) {
-			result.pose.position = m_vec3_lerp(predecessor.relation.pose.position,
-			                                   successor.relation.pose.position, amount_to_lerp);
-		}
-		if (0 != (result.relation_flags & XRT_SPACE_RELATION_ORIENTATION_VALID_BIT)) {
-
-			math_quat_slerp(&predecessor.relation.pose.orientation, &successor.relation.pose.orientation,
-			                amount_to_lerp, &result.pose.orientation);
-		}
-
-		//! @todo Does interpolating the velocities make any sense?
-		if (0 != (result.relation_flags & XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT)) {
-			result.angular_velocity = m_vec3_lerp(predecessor.relation.angular_velocity,
-			                                      successor.relation.angular_velocity, amount_to_lerp);
-		}
-		if (0 != (result.relation_flags & XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT)) {
-			result.linear_velocity = m_vec3_lerp(predecessor.relation.linear_velocity,
-			                                     successor.relation.linear_velocity, amount_to_lerp);
-		}
-		*out_relation = result;
+		interpolate(entry_from_row(*(it - 1)), entry_from_row(*it), at_timestamp_ns, out_relation);
 		return M_RELATION_HISTORY_RESULT_INTERPOLATED;
 
 	} catch (std::exception const &e) {
@@ -283,8 +663,8 @@ m_relation_history_get_latest(const struct m_relation_history *rh,
 	if (rh->impl.empty()) {
 		return false;
 	}
-	*out_relation = rh->impl.back().relation;
-	*out_time_ns = rh->impl.back().timestamp;
+	*out_relation = rh->impl.back();
+	*out_time_ns = rh->impl.back_timestamp();
 	return true;
 }
 
@@ -300,6 +680,86 @@ m_relation_history_clear(struct m_relation_history *rh)
 {
 	std::unique_lock<os::Mutex> lock(rh->mutex);
 	rh->impl.clear();
+	rh->pending.count = 0;
+	rh->motion = {};
+}
+
+void
+m_relation_history_set_prediction_model(struct m_relation_history *rh, enum m_predict_model model, bool adaptive)
+{
+	assert(model < M_PREDICT_MODEL_COUNT);
+
+	std::unique_lock<os::Mutex> lock(rh->mutex);
+	rh->model = model;
+	rh->adaptive = adaptive;
+	rh->evaluate = rh->evaluate || adaptive;
+}
+
+enum m_predict_model
+m_relation_history_get_prediction_model(const struct m_relation_history *rh)
+{
+	std::unique_lock<os::Mutex> lock(rh->mutex);
+	return (enum m_predict_model)rh->model;
+}
+
+void
+m_relation_history_set_prediction_eval(struct m_relation_history *rh, bool enabled)
+{
+	std::unique_lock<os::Mutex> lock(rh->mutex);
+	rh->evaluate = enabled || rh->adaptive;
+	if (!rh->evaluate) {
+		rh->pending.count = 0;
+	}
+}
+
+void
+m_relation_history_get_prediction_stats(const struct m_relation_history *rh,
+                                        struct m_relation_history_prediction_stats out_stats[M_PREDICT_MODEL_COUNT])
+{
+	std::unique_lock<os::Mutex> lock(rh->mutex);
+	for (uint32_t m = 0; m < M_PREDICT_MODEL_COUNT; m++) {
+		out_stats[m].count = rh->stats[m].count;
+		out_stats[m].position_error_m = rh->stats[m].position_error_m;
+		out_stats[m].orientation_error_rad = rh->stats[m].orientation_error_rad;
+	}
+}
+
+void
+m_relation_history_add_vars(struct m_relation_history *rh, void *root, const char *prefix)
+{
+	char tmp[512];
+
+	rh->model_combo.count = M_PREDICT_MODEL_COUNT;
+	rh->model_combo.options = "Constant velocity\0Constant acceleration\0Filtered\0\0";
+	rh->model_combo.value = &rh->model;
+
+	snprintf(tmp, sizeof(tmp), "%sPrediction model", prefix);
+	u_var_add_combo(root, &rh->model_combo, tmp);
+	snprintf(tmp, sizeof(tmp), "%sAdaptive model", prefix);
+	u_var_add_bool(root, &rh->adaptive, tmp);
+	snprintf(tmp, sizeof(tmp), "%sEvaluate predictions", prefix);
+	u_var_add_bool(root, &rh->evaluate, tmp);
+
+	for (uint32_t m = 0; m < M_PREDICT_MODEL_COUNT; m++) {
+		struct prediction_stats &stats = rh->stats[m];
+		const char *name = m_predict_model_str((enum m_predict_model)m);
+
+		stats.position_hist_var.values = stats.position_hist;
+		stats.position_hist_var.count = HistBins;
+		stats.orientation_hist_var.values = stats.orientation_hist;
+		stats.orientation_hist_var.count = HistBins;
+
+		snprintf(tmp, sizeof(tmp), "%s%s.count", prefix, name);
+		u_var_add_ro_u64(root, &stats.count, tmp);
+		snprintf(tmp, sizeof(tmp), "%s%s.position_error_m", prefix, name);
+		u_var_add_ro_f32(root, &stats.position_error_m, tmp);
+		snprintf(tmp, sizeof(tmp), "%s%s.orientation_error_rad", prefix, name);
+		u_var_add_ro_f32(root, &stats.orientation_error_rad, tmp);
+		snprintf(tmp, sizeof(tmp), "%s%s.position_hist (0-50mm)", prefix, name);
+		u_var_add_histogram_f32(root, &stats.position_hist_var, tmp);
+		snprintf(tmp, sizeof(tmp), "%s%s.orientation_hist (0-5deg)", prefix, name);
+		u_var_add_histogram_f32(root, &stats.orientation_hist_var, tmp);
+	}
 }
 
 void
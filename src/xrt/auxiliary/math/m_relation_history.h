@@ -13,6 +13,7 @@
 
 #include "xrt/xrt_defines.h"
 
+#include "math/m_predict.h"
 #include "math/m_filter_one_euro.h"
 
 #ifdef __cplusplus
@@ -22,7 +23,7 @@ extern "C" {
 /**
  * @brief Opaque type for storing the history of a space relation in a ring buffer
  *
- * @note Unlike the bare C++ data structure @ref HistoryBuffer this wraps, **this is a thread safe interface**,
+ * @note Unlike the bare C++ data structure @ref HistoryBufferSoA this wraps, **this is a thread safe interface**,
  * and is safe for concurrent access from multiple threads.
  * (It is using a simple mutex, not a reader/writer lock, but that is fine until proven to be a bottleneck.)
  *
@@ -50,6 +51,24 @@ struct m_relation_history_filters
 	struct m_filter_euro_quat orientation;
 };
 
+/*!
+ * How well one @ref m_predict_model has been predicting, see
+ * @ref m_relation_history_get_prediction_stats.
+ *
+ * @relates m_relation_history
+ */
+struct m_relation_history_prediction_stats
+{
+	//! Number of predictions that have been compared with their sample.
+	uint64_t count;
+
+	//! Running average of the position error, in meters.
+	float position_error_m;
+
+	//! Running average of the orientation error, in radians.
+	float orientation_error_rad;
+};
+
 /*!
  * Creates an opaque relation_history object.
  *
@@ -131,6 +150,59 @@ m_relation_history_get_size(const struct m_relation_history *rh);
 void
 m_relation_history_clear(struct m_relation_history *rh);
 
+/*!
+ * Sets which model is used when predicting past the most recent entry. With
+ * @p adaptive the history switches by itself to the model that has had the
+ * lowest error, which turns on evaluation.
+ *
+ * The default is constant velocity, it can be changed for all histories with
+ * the `XRT_PREDICTION_MODEL` environment variable, set to the name of a model
+ * or to `adaptive`.
+ *
+ * @public @memberof m_relation_history
+ */
+void
+m_relation_history_set_prediction_model(struct m_relation_history *rh, enum m_predict_model model, bool adaptive);
+
+/*!
+ * Returns the model currently used to predict.
+ *
+ * @public @memberof m_relation_history
+ */
+enum m_predict_model
+m_relation_history_get_prediction_model(const struct m_relation_history *rh);
+
+/*!
+ * Turns evaluation of predictions on or off. When on, every prediction past
+ * the most recent entry is also made with every model and compared with the
+ * sample that is later pushed for that time. The errors are collected into
+ * stats and histograms, and written to the metrics file if it is active.
+ *
+ * On by default if `XRT_PREDICTION_EVAL` is set or metrics are being written.
+ *
+ * @public @memberof m_relation_history
+ */
+void
+m_relation_history_set_prediction_eval(struct m_relation_history *rh, bool enabled);
+
+/*!
+ * Get the prediction stats for all models, indexed by @ref m_predict_model.
+ *
+ * @public @memberof m_relation_history
+ */
+void
+m_relation_history_get_prediction_stats(const struct m_relation_history *rh,
+                                        struct m_relation_history_prediction_stats out_stats[M_PREDICT_MODEL_COUNT]);
+
+/*!
+ * Adds the prediction settings, stats and error histograms to the given u_var
+ * root, the history must outlive the root.
+ *
+ * @public @memberof m_relation_history
+ */
+void
+m_relation_history_add_vars(struct m_relation_history *rh, void *root, const char *prefix);
+
 /*!
  * Destroys an opaque relation_history object.
  *
@@ -21,6 +21,7 @@
 #include "math/m_api.h"
 #include "math/m_filter_fifo.h"
 #include "math/m_filter_one_euro.h"
+#include "math/m_imu_integration.h"
 #include "math/m_predict.h"
 #include "math/m_relation_history.h"
 #include "math/m_space.h"
@@ -91,6 +92,7 @@ namespace xrt::auxiliary::tracking::slam {
 constexpr int UI_TIMING_POSE_COUNT = 192;
 constexpr int UI_FEATURES_POSE_COUNT = 192;
 constexpr int UI_GTDIFF_POSE_COUNT = 192;
+constexpr size_t IMU_FIFO_SIZE = 1000; //!< Size of the gyro and accel fifos
 
 using os::Mutex;
 using std::deque;
@@ -249,6 +251,7 @@ struct FeaturesWriter : public CSVWriter<feature_count_sample>
  * @implements xrt_tracked_slam
  * @implements xrt_frame_node
  * @implements xrt_frame_sink
+ * @implements xrt_frame_set_sink
  * @implements xrt_imu_sink
  * @implements xrt_pose_sink
  */
@@ -265,6 +268,7 @@ struct TrackerSlam
 	struct xrt_imu_sink imu_sink = {};                           //!< Sends imu samples to the SLAM system
 	struct xrt_pose_sink gt_sink = {};                           //!< Register groundtruth trajectory for stats
 	struct xrt_hand_masks_sink hand_masks_sink = {};             //!< Register latest masks to ignore
+	struct xrt_frame_set_sink frame_set_sink = {};               //!< Sends all cameras at once
 
 	bool submit;        //!< Whether to submit data pushed to sinks to the SLAM tracker
 	uint32_t cam_count; //!< Number of cameras used for tracking
@@ -299,6 +303,12 @@ struct TrackerSlam
 	//! @todo Should be automatically computed instead of required to be filled manually through the UI.
 	xrt_vec3 gravity_correction{0, 0, -MATH_GRAVITY_M_S2};
 
+	//! IMU samples since the latest SLAM pose already integrated on top of it, so
+	//! that @ref SLAM_PRED_IP_IO_IA_IL does not redo the integration on every
+	//! query. Extended as IMU samples arrive, rebuilt when the SLAM pose or the
+	//! gravity correction changes. Protected by @ref lock_ff.
+	struct m_imu_preintegration *imu_pre = nullptr;
+
 	struct xrt_space_relation last_rel = XRT_SPACE_RELATION_ZERO; //!< Last reported/tracked pose
 	timepoint_ns last_ts;                                         //!< Last reported/tracked pose timestamp
 
@@ -805,7 +815,10 @@ flush_poses(TrackerSlam &t)
 	return true;
 }
 
-//! Integrates IMU samples on top of a base pose and predicts from that
+/*!
+ * Integrates IMU samples on top of a base pose and predicts from that, starting
+ * from the samples already integrated since the base pose when possible.
+ */
 static void
 predict_pose_from_imu(TrackerSlam &t,
                       timepoint_ns when_ns,
@@ -815,85 +828,22 @@ predict_pose_from_imu(TrackerSlam &t,
 {
 	os_mutex_lock(&t.lock_ff);
 
-	// Find oldest imu index i that is newer than latest SLAM pose (or -1)
-	int i = 0;
-	uint64_t imu_ts = UINT64_MAX;
-	xrt_vec3 _;
-	while (m_ff_vec3_f32_get(t.gyro_ff, i, &_, &imu_ts)) {
-		if ((int64_t)imu_ts < base_rel_ts) {
-			i--; // Back to the oldest newer-than-SLAM IMU index (or -1)
-			break;
-		}
-		i++;
-	}
-
-	if (i == -1) {
-		SLAM_WARN("No IMU samples received after latest SLAM pose (and frame)");
-	}
-
-	xrt_space_relation integ_rel = base_rel;
-	timepoint_ns integ_rel_ts = base_rel_ts;
-	xrt_quat &o = integ_rel.pose.orientation;
-	xrt_vec3 &p = integ_rel.pose.position;
-	xrt_vec3 &w = integ_rel.angular_velocity;
-	xrt_vec3 &v = integ_rel.linear_velocity;
-	bool clamped = false; // If when_ns is older than the latest IMU ts
-
-	while (i >= 0) { // Decreasing i increases timestamp
-		// Get samples
-		xrt_vec3 g{};
-		xrt_vec3 a{};
-		uint64_t g_ts{};
-		uint64_t a_ts{};
-		bool got = true;
-		got &= m_ff_vec3_f32_get(t.gyro_ff, i, &g, &g_ts);
-		got &= m_ff_vec3_f32_get(t.accel_ff, i, &a, &a_ts);
-		timepoint_ns ts = g_ts;
-
-
-		// Checks
-		if (ts > when_ns) {
-			clamped = true;
-			//! @todo Instead of using same a and g values, do an interpolated sample like this:
-			// a = prev_a + ((when_ns - prev_ts) / (ts - prev_ts)) * (a - prev_a);
-			// g = prev_g + ((when_ns - prev_ts) / (ts - prev_ts)) * (g - prev_g);
-			ts = when_ns; // clamp ts to when_ns
-		}
-		SLAM_DASSERT(got && g_ts == a_ts, "Failure getting synced gyro and accel samples");
-		SLAM_DASSERT(ts >= base_rel_ts, "Accessing imu sample that is older than latest SLAM pose");
-
-		// Update time
-		float dt = (float)time_ns_to_s(ts - integ_rel_ts);
-		integ_rel_ts = ts;
-
-		// Integrate gyroscope
-		xrt_quat angvel_delta{};
-		xrt_vec3 scaled_half_g = g * dt * 0.5f;
-		math_quat_exp(&scaled_half_g, &angvel_delta); // Same as using math_quat_from_angle_vector(g/dt)
-		math_quat_rotate(&o, &angvel_delta, &o);      // Orientation
-		math_quat_rotate_derivative(&o, &g, &w);      // Angular velocity
-
-		// Integrate accelerometer
-		xrt_vec3 world_accel{};
-		math_quat_rotate_vec3(&o, &a, &world_accel);
-		world_accel += t.gravity_correction;
-		v += world_accel * dt;                        // Linear velocity
-		p += v * dt + world_accel * (dt * dt * 0.5f); // Position
-
-		if (clamped) {
-			break;
-		}
-		i--;
+	bool had_samples;
+	bool cached = m_imu_preintegration_predict(t.imu_pre, t.gyro_ff, t.accel_ff, &t.gravity_correction, &base_rel,
+	                                           base_rel_ts, when_ns, out_relation);
+	if (cached) {
+		had_samples = m_imu_preintegration_get_step_count(t.imu_pre) > 0;
+	} else {
+		// The fifos don't reach back to the base pose, integrate what there is.
+		had_samples = m_imu_integration_predict_from_fifos(t.gyro_ff, t.accel_ff, &t.gravity_correction,
+		                                                   &base_rel, base_rel_ts, when_ns, out_relation);
 	}
 
 	os_mutex_unlock(&t.lock_ff);
 
-	// Do the prediction based on the updated relation
-	double last_imu_to_now_dt = time_ns_to_s(when_ns - integ_rel_ts);
-	xrt_space_relation predicted_relation{};
-	m_predict_relation(&integ_rel, last_imu_to_now_dt, &predicted_relation);
-
-	*out_relation = predicted_relation;
+	if (!had_samples) {
+		SLAM_WARN("No IMU samples received after latest SLAM pose (and frame)");
+	}
 }
 
 //! Return our best guess of the relation at time @p when_ns using all the data the tracker has.
@@ -1031,10 +981,11 @@ setup_ui(TrackerSlam &t)
 		u_sink_debug_init(&t.ui_sink[i]);
 	}
 	os_mutex_init(&t.lock_ff);
-	m_ff_vec3_f32_alloc(&t.gyro_ff, 1000);
-	m_ff_vec3_f32_alloc(&t.accel_ff, 1000);
-	m_ff_vec3_f32_alloc(&t.filter.pos_ff, 1000);
-	m_ff_vec3_f32_alloc(&t.filter.rot_ff, 1000);
+	m_ff_vec3_f32_alloc(&t.gyro_ff, IMU_FIFO_SIZE);
+	m_ff_vec3_f32_alloc(&t.accel_ff, IMU_FIFO_SIZE);
+	m_imu_preintegration_create(IMU_FIFO_SIZE, &t.imu_pre);
+	m_ff_vec3_f32_alloc_prefix_sum(&t.filter.pos_ff, 1000);
+	m_ff_vec3_f32_alloc_prefix_sum(&t.filter.rot_ff, 1000);
 
 	u_var_add_root(&t, "SLAM Tracker", true);
 	u_var_add_log_level(&t, &t.log_level, "Log Level");
@@ -1323,12 +1274,13 @@ t_slam_receive_imu(struct xrt_imu_sink *sink, struct xrt_imu_sample *s)
 	os_mutex_lock(&t.lock_ff);
 	m_ff_vec3_f32_push(t.gyro_ff, &gyro, ts);
 	m_ff_vec3_f32_push(t.accel_ff, &accel, ts);
+	m_imu_preintegration_push(t.imu_pre, ts, &gyro, &accel);
 	os_mutex_unlock(&t.lock_ff);
 }
 
-//! Push the frame to the external SLAM system
+//! Push the frame to the external SLAM system, as taken at @p timestamp
 static void
-receive_frame(TrackerSlam &t, struct xrt_frame *frame, uint32_t cam_index)
+receive_frame(TrackerSlam &t, struct xrt_frame *frame, uint32_t cam_index, int64_t timestamp)
 {
 	XRT_TRACE_MARKER();
 
@@ -1347,7 +1299,7 @@ receive_frame(TrackerSlam &t, struct xrt_frame *frame, uint32_t cam_index)
 
 	// Check monotonically increasing timestamps
 	timepoint_ns &last_ts = t.last_cam_ts[cam_index];
-	timepoint_ns ts = (int64_t)frame->timestamp;
+	timepoint_ns ts = timestamp;
 	SLAM_TRACE("[%" PRId64 "] cam%d frame t=%" PRId64, os_monotonic_get_ns(), cam_index, ts);
 	if (last_ts >= ts) {
 		SLAM_WARN("Frame (%" PRId64 ") is older than last (%" PRId64 ") by %" PRId64 " ns", ts, last_ts,
@@ -1408,7 +1360,7 @@ receive_frame(TrackerSlam &t, struct xrt_frame *frame, uint32_t cam_index)
 	extern "C" void t_slam_receive_cam##cam_id(struct xrt_frame_sink *sink, struct xrt_frame *frame)               \
 	{                                                                                                              \
 		auto &t = *container_of(sink, TrackerSlam, cam_sinks[cam_id]);                                         \
-		receive_frame(t, frame, cam_id);                                                                       \
+		receive_frame(t, frame, cam_id, frame->timestamp);                                                     \
 		u_sink_debug_push_frame(&t.ui_sink[cam_id], frame);                                                    \
 		xrt_sink_push_frame(t.euroc_recorder->cams[cam_id], frame);                                            \
 	}
@@ -1428,6 +1380,30 @@ void (*t_slam_receive_cam[XRT_TRACKING_MAX_SLAM_CAMS])(xrt_frame_sink *, xrt_fra
     t_slam_receive_cam4, //
 };
 
+static_assert(XRT_FRAME_SET_MAX_FRAMES >= XRT_TRACKING_MAX_SLAM_CAMS, "Frame sets must fit all SLAM cameras");
+
+/*!
+ * All cameras of a @ref xrt_frame_set share the set timestamp, as the SLAM
+ * systems expect. The frames themselves are left untouched.
+ */
+extern "C" void
+t_slam_receive_frame_set(struct xrt_frame_set_sink *sink, struct xrt_frame_set *set)
+{
+	auto &t = *container_of(sink, TrackerSlam, frame_set_sink);
+
+	if (set->frame_count != t.cam_count) {
+		SLAM_WARN("Frame set has %u frames but tracker has %u cameras", set->frame_count, t.cam_count);
+		return;
+	}
+
+	for (uint32_t i = 0; i < set->frame_count; i++) {
+		struct xrt_frame *frame = set->frames[i];
+		receive_frame(t, frame, i, set->timestamp);
+		u_sink_debug_push_frame(&t.ui_sink[i], frame);
+		xrt_sink_push_frame(t.euroc_recorder->cams[i], frame);
+	}
+}
+
 
 extern "C" void
 t_slam_node_break_apart(struct xrt_frame_node *node)
@@ -1467,6 +1443,7 @@ t_slam_node_destroy(struct xrt_frame_node *node)
 	}
 	m_ff_vec3_f32_free(&t.gyro_ff);
 	m_ff_vec3_f32_free(&t.accel_ff);
+	m_imu_preintegration_destroy(&t.imu_pre);
 	os_mutex_destroy(&t.lock_ff);
 	m_ff_vec3_f32_free(&t.filter.pos_ff);
 	m_ff_vec3_f32_free(&t.filter.rot_ff);
@@ -1585,6 +1562,9 @@ t_slam_create(struct xrt_frame_context *xfctx,
 	t.hand_masks_sink.push_hand_masks = t_slam_hand_mask_sink_push;
 	t.sinks.hand_masks = &t.hand_masks_sink;
 
+	t.frame_set_sink.push_frame_set = t_slam_receive_frame_set;
+	t.sinks.frame_set = &t.frame_set_sink;
+
 	t.submit = config->submit_from_start;
 	t.cam_count = config->cam_count;
 
@@ -12,6 +12,7 @@
 #include "xrt/xrt_tracking.h"
 
 #include "util/u_debug.h"
+#include "util/u_capture.h"
 #include "util/u_builders.h"
 #include "util/u_system_helpers.h"
 #include "util/u_space_overseer.h"
@@ -20,6 +21,7 @@
 DEBUG_GET_ONCE_FLOAT_OPTION(tracking_origin_offset_x, "XRT_TRACKING_ORIGIN_OFFSET_X", 0.0f)
 DEBUG_GET_ONCE_FLOAT_OPTION(tracking_origin_offset_y, "XRT_TRACKING_ORIGIN_OFFSET_Y", 0.0f)
 DEBUG_GET_ONCE_FLOAT_OPTION(tracking_origin_offset_z, "XRT_TRACKING_ORIGIN_OFFSET_Z", 0.0f)
+DEBUG_GET_ONCE_OPTION(device_capture, "XRT_DEVICE_CAPTURE", NULL)
 
 
 /*
@@ -36,6 +38,49 @@ apply_offset(struct xrt_vec3 *position, struct xrt_vec3 *offset)
 	position->z += offset->z;
 }
 
+static void
+swap_role(struct xrt_device **role, struct xrt_device *from, struct xrt_device *to)
+{
+	if (*role == from) {
+		*role = to;
+	}
+}
+
+/*!
+ * Wraps all devices so their calls are recorded to the given file, the roles
+ * are moved over to the wrapping devices.
+ */
+static void
+wrap_devices_for_capture(const char *path, struct xrt_system_devices *xsysd, struct u_builder_roles_helper *ubrh)
+{
+	struct u_capture_writer *writer = NULL;
+	if (!u_capture_writer_create(path, &writer)) {
+		U_LOG_E("Could not create capture '%s', not capturing", path);
+		return;
+	}
+
+	for (size_t i = 0; i < xsysd->xdev_count; i++) {
+		struct xrt_device *xdev = xsysd->xdevs[i];
+		struct xrt_device *wrapped = NULL;
+
+		if (u_capture_device_wrap(writer, xdev, &wrapped) != XRT_SUCCESS) {
+			continue;
+		}
+
+		xsysd->xdevs[i] = wrapped;
+		swap_role(&ubrh->head, xdev, wrapped);
+		swap_role(&ubrh->left, xdev, wrapped);
+		swap_role(&ubrh->right, xdev, wrapped);
+		swap_role(&ubrh->hand_tracking.left, xdev, wrapped);
+		swap_role(&ubrh->hand_tracking.right, xdev, wrapped);
+	}
+
+	U_LOG_I("Capturing device calls to '%s'", path);
+
+	// The devices hold their own references.
+	u_capture_writer_reference(&writer, NULL);
+}
+
 
 /*
  *
@@ -224,6 +269,11 @@ u_builder_roles_helper_open_system(struct xrt_builder *xb,
 		return xret;
 	}
 
+	const char *capture_path = debug_get_option_device_capture();
+	if (capture_path != NULL) {
+		wrap_devices_for_capture(capture_path, xsysd, &ubrh);
+	}
+
 	/*
 	 * Assign to role(s).
 	 */
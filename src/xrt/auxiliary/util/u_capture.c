@@ -0,0 +1,414 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Binary capture file writer and reader.
+ * @ingroup aux_util
+ */
+
+#include "xrt/xrt_config_os.h"
+
+#include "os/os_time.h"
+#include "os/os_threading.h"
+
+#include "util/u_misc.h"
+#include "util/u_logging.h"
+#include "util/u_capture.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#ifdef XRT_OS_UNIX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+
+static_assert(sizeof(struct u_capture_file_header) % 8 == 0, "Records must stay 8 byte aligned");
+static_assert(sizeof(struct u_capture_record_header) % 8 == 0, "Payloads must be 8 byte aligned");
+static_assert(sizeof(struct u_capture_inputs) % 8 == 0, "Input array must be 8 byte aligned");
+static_assert(sizeof(struct u_capture_input) % 8 == 0, "Input array must be 8 byte aligned");
+
+#define U_CAPTURE_ALIGN(size) (((size) + 7u) & ~(size_t)7u)
+
+//! Big buffer, records are written from the frame and input paths.
+#define U_CAPTURE_WRITE_BUFFER_SIZE (1024 * 1024)
+
+
+/*
+ *
+ * Writer.
+ *
+ */
+
+struct u_capture_writer
+{
+	struct xrt_reference reference;
+
+	//! Protects everything below.
+	struct os_mutex mutex;
+
+	FILE *file;
+
+	uint32_t device_count;
+
+	//! A write came up short, nothing more is written so the file ends at the last complete record.
+	bool failed;
+};
+
+/*!
+ * Write all of @p size bytes, marks the capture failed on a short write.
+ * Called with the mutex held, or before the writer is shared.
+ */
+static bool
+write_locked(struct u_capture_writer *writer, const void *data, size_t size)
+{
+	if (writer->failed) {
+		return false;
+	}
+
+	if (fwrite(data, 1, size, writer->file) != size) {
+		U_LOG_E("Short write to the capture file, stopping the capture");
+		writer->failed = true;
+		return false;
+	}
+
+	return true;
+}
+
+static void
+writer_destroy(struct u_capture_writer *writer)
+{
+	if (fflush(writer->file) != 0 && !writer->failed) {
+		U_LOG_E("Could not flush the capture file, it is incomplete");
+	}
+	fclose(writer->file);
+	os_mutex_destroy(&writer->mutex);
+	free(writer);
+}
+
+bool
+u_capture_writer_create(const char *path, struct u_capture_writer **out_writer)
+{
+	FILE *file = fopen(path, "wb");
+	if (file == NULL) {
+		U_LOG_E("Could not open '%s' for writing", path);
+		return false;
+	}
+
+	struct u_capture_writer *writer = U_TYPED_CALLOC(struct u_capture_writer);
+	writer->file = file;
+	os_mutex_init(&writer->mutex);
+
+	// Fully buffered, the buffer is owned by the stdio implementation.
+	setvbuf(file, NULL, _IOFBF, U_CAPTURE_WRITE_BUFFER_SIZE);
+
+	struct u_capture_file_header header = {0};
+	memcpy(header.magic, U_CAPTURE_MAGIC, sizeof(U_CAPTURE_MAGIC));
+	header.version = U_CAPTURE_VERSION;
+	header.sizeof_relation = sizeof(struct xrt_space_relation);
+	header.sizeof_input = sizeof(struct xrt_input);
+	header.sizeof_hand_joint_set = sizeof(struct xrt_hand_joint_set);
+	header.sizeof_body_joint_set = sizeof(struct xrt_body_joint_set);
+	header.sizeof_output_value = sizeof(struct xrt_output_value);
+	header.start_ns = os_monotonic_get_ns();
+
+	if (!write_locked(writer, &header, sizeof(header))) {
+		writer_destroy(writer);
+		return false;
+	}
+
+	xrt_reference_inc(&writer->reference);
+	*out_writer = writer;
+
+	return true;
+}
+
+void
+u_capture_writer_reference(struct u_capture_writer **dst, struct u_capture_writer *src)
+{
+	struct u_capture_writer *old_dst = *dst;
+
+	if (old_dst == src) {
+		return;
+	}
+
+	if (src) {
+		xrt_reference_inc(&src->reference);
+	}
+
+	*dst = src;
+
+	if (old_dst) {
+		if (xrt_reference_dec_and_is_zero(&old_dst->reference)) {
+			writer_destroy(old_dst);
+		}
+	}
+}
+
+void
+u_capture_writer_write(struct u_capture_writer *writer,
+                       enum u_capture_record_type type,
+                       uint32_t device_index,
+                       int64_t timestamp_ns,
+                       const void *payload,
+                       size_t size)
+{
+	static const uint8_t zeros[8] = {0};
+	size_t padded = U_CAPTURE_ALIGN(size);
+
+	struct u_capture_record_header header = {
+	    .type = type,
+	    .size = (uint32_t)padded,
+	    .device_index = device_index,
+	    .timestamp_ns = timestamp_ns,
+	};
+
+	os_mutex_lock(&writer->mutex);
+
+	bool ok = write_locked(writer, &header, sizeof(header)) && write_locked(writer, payload, size);
+	if (ok && padded > size) {
+		write_locked(writer, zeros, padded - size);
+	}
+
+	os_mutex_unlock(&writer->mutex);
+}
+
+bool
+u_capture_writer_has_failed(struct u_capture_writer *writer)
+{
+	os_mutex_lock(&writer->mutex);
+	bool failed = writer->failed;
+	os_mutex_unlock(&writer->mutex);
+
+	return failed;
+}
+
+bool
+u_capture_writer_add_device(struct u_capture_writer *writer, uint32_t *out_device_index)
+{
+	os_mutex_lock(&writer->mutex);
+
+	bool ret = writer->device_count < U_CAPTURE_MAX_DEVICES;
+	if (ret) {
+		*out_device_index = writer->device_count++;
+	}
+
+	os_mutex_unlock(&writer->mutex);
+
+	return ret;
+}
+
+
+/*
+ *
+ * Reader.
+ *
+ */
+
+static bool
+header_is_valid(const struct u_capture_file_header *header)
+{
+	if (memcmp(header->magic, U_CAPTURE_MAGIC, sizeof(U_CAPTURE_MAGIC)) != 0) {
+		U_LOG_E("Not a capture file");
+		return false;
+	}
+
+	if (header->version != U_CAPTURE_VERSION) {
+		U_LOG_E("Capture version %u not supported, expected %u", header->version, U_CAPTURE_VERSION);
+		return false;
+	}
+
+	if (header->sizeof_relation != sizeof(struct xrt_space_relation) ||
+	    header->sizeof_input != sizeof(struct xrt_input) ||
+	    header->sizeof_hand_joint_set != sizeof(struct xrt_hand_joint_set) ||
+	    header->sizeof_body_joint_set != sizeof(struct xrt_body_joint_set) ||
+	    header->sizeof_output_value != sizeof(struct xrt_output_value)) {
+		U_LOG_E("Capture was made by a build with different struct layouts");
+		return false;
+	}
+
+	return true;
+}
+
+/*!
+ * Is the payload big enough for what its type says is in it.
+ */
+static bool
+payload_is_valid(const struct u_capture_record_header *header, const void *payload)
+{
+	switch (header->type) {
+	case U_CAPTURE_RECORD_DEVICE: {
+		if (header->size < sizeof(struct u_capture_device)) {
+			return false;
+		}
+		const struct u_capture_device *device = payload;
+		uint64_t names = (uint64_t)device->input_count + device->output_count;
+		return names * sizeof(uint32_t) <= header->size - sizeof(struct u_capture_device);
+	}
+	case U_CAPTURE_RECORD_INPUTS: {
+		if (header->size < sizeof(struct u_capture_inputs)) {
+			return false;
+		}
+		const struct u_capture_inputs *inputs = payload;
+		return (uint64_t)inputs->count * sizeof(struct u_capture_input) <=
+		       header->size - sizeof(struct u_capture_inputs);
+	}
+	case U_CAPTURE_RECORD_TRACKED_POSE: return header->size >= sizeof(struct u_capture_tracked_pose);
+	case U_CAPTURE_RECORD_HAND_TRACKING: return header->size >= sizeof(struct u_capture_hand_tracking);
+	case U_CAPTURE_RECORD_VIEW_POSES: return header->size >= sizeof(struct u_capture_view_poses);
+	case U_CAPTURE_RECORD_BODY_JOINTS: return header->size >= sizeof(struct u_capture_body_joints);
+	case U_CAPTURE_RECORD_OUTPUT: return header->size >= sizeof(struct u_capture_output);
+	default: return true; // Unknown records are skipped by the users.
+	}
+}
+
+bool
+u_capture_reader_init_from_memory(const void *data, size_t size, struct u_capture_reader *reader)
+{
+	U_ZERO(reader);
+
+	if (size < sizeof(struct u_capture_file_header)) {
+		U_LOG_E("Capture file too small");
+		return false;
+	}
+
+	const struct u_capture_file_header *header = data;
+	if (!header_is_valid(header)) {
+		return false;
+	}
+
+	reader->data = data;
+	reader->size = size;
+	reader->header = header;
+
+	return true;
+}
+
+bool
+u_capture_reader_open(const char *path, struct u_capture_reader *reader)
+{
+	void *data = NULL;
+	size_t size = 0;
+	bool mapped = false;
+
+#ifdef XRT_OS_UNIX
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		U_LOG_E("Could not open '%s'", path);
+		return false;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		U_LOG_E("Could not stat '%s'", path);
+		close(fd);
+		return false;
+	}
+	size = (size_t)st.st_size;
+
+	data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		U_LOG_E("Could not map '%s'", path);
+		return false;
+	}
+	mapped = true;
+#else
+	FILE *file = fopen(path, "rb");
+	if (file == NULL) {
+		U_LOG_E("Could not open '%s'", path);
+		return false;
+	}
+
+	fseek(file, 0, SEEK_END);
+	long end = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	if (end <= 0) {
+		fclose(file);
+		return false;
+	}
+	size = (size_t)end;
+
+	// malloc alignment is enough for the records.
+	data = malloc(size);
+	size_t read = fread(data, 1, size, file);
+	fclose(file);
+	if (read != size) {
+		free(data);
+		return false;
+	}
+#endif
+
+	if (!u_capture_reader_init_from_memory(data, size, reader)) {
+		// Set again since init zeroes the reader on failure.
+		reader->data = data;
+		reader->size = size;
+		reader->mapped = mapped;
+		u_capture_reader_close(reader);
+		return false;
+	}
+
+	reader->mapped = mapped;
+
+	return true;
+}
+
+bool
+u_capture_reader_next(const struct u_capture_reader *reader,
+                      size_t *offset,
+                      const struct u_capture_record_header **out_header,
+                      const void **out_payload)
+{
+	size_t pos = *offset;
+	if (pos == 0) {
+		pos = sizeof(struct u_capture_file_header);
+	}
+
+	if (pos + sizeof(struct u_capture_record_header) > reader->size) {
+		return false;
+	}
+
+	const struct u_capture_record_header *header = (const void *)(reader->data + pos);
+	pos += sizeof(struct u_capture_record_header);
+
+	// A capture cut short by a crash ends at the last complete record.
+	if (header->size > reader->size - pos || header->size % 8 != 0) {
+		return false;
+	}
+
+	const void *payload = reader->data + pos;
+	if (!payload_is_valid(header, payload)) {
+		U_LOG_W("Malformed capture record of type %u, stopping", header->type);
+		return false;
+	}
+
+	*offset = pos + header->size;
+	*out_header = header;
+	*out_payload = payload;
+
+	return true;
+}
+
+void
+u_capture_reader_close(struct u_capture_reader *reader)
+{
+	if (reader->data == NULL) {
+		return;
+	}
+
+#ifdef XRT_OS_UNIX
+	if (reader->mapped) {
+		munmap((void *)reader->data, reader->size);
+	}
+#else
+	if (!reader->mapped) {
+		free((void *)reader->data);
+	}
+#endif
+
+	U_ZERO(reader);
+}
@@ -0,0 +1,425 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Binary capture of @ref xrt_device calls, for replaying sessions.
+ *
+ * A capture file is a @ref u_capture_file_header followed by records, each a
+ * @ref u_capture_record_header and a payload. Every record is 8 byte aligned
+ * and has a fixed layout for its type, so a reader can map the file and use
+ * the records in place without parsing or copying.
+ *
+ * The payloads embed xrt structs as they are in memory, a capture can only be
+ * replayed by a build with the same struct layouts; the header records the
+ * sizes of the large structs so mismatches are caught when opening.
+ *
+ * @ingroup aux_util
+ */
+
+#pragma once
+
+#include "xrt/xrt_device.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*!
+ * Magic at the start of every capture file.
+ *
+ * @ingroup aux_util
+ */
+#define U_CAPTURE_MAGIC "XRTCAPT"
+
+/*!
+ * Bumped whenever the layout of any record changes.
+ *
+ * @ingroup aux_util
+ */
+#define U_CAPTURE_VERSION (1u)
+
+/*!
+ * Max number of devices in one capture.
+ *
+ * @ingroup aux_util
+ */
+#define U_CAPTURE_MAX_DEVICES (32u)
+
+/*!
+ * Type of a capture record, see the payload structs.
+ *
+ * @ingroup aux_util
+ */
+enum u_capture_record_type
+{
+	//! @ref u_capture_device, always the first record of a device.
+	U_CAPTURE_RECORD_DEVICE = 1,
+	//! @ref u_capture_inputs, the inputs that changed in an update.
+	U_CAPTURE_RECORD_INPUTS = 2,
+	//! @ref u_capture_tracked_pose
+	U_CAPTURE_RECORD_TRACKED_POSE = 3,
+	//! @ref u_capture_hand_tracking
+	U_CAPTURE_RECORD_HAND_TRACKING = 4,
+	//! @ref u_capture_view_poses
+	U_CAPTURE_RECORD_VIEW_POSES = 5,
+	//! @ref u_capture_body_joints
+	U_CAPTURE_RECORD_BODY_JOINTS = 6,
+	//! @ref u_capture_output
+	U_CAPTURE_RECORD_OUTPUT = 7,
+};
+
+/*!
+ * First bytes of a capture file.
+ *
+ * @ingroup aux_util
+ */
+struct u_capture_file_header
+{
+	char magic[8];
+	uint32_t version;
+
+	//! Sizes of embedded structs, must match the reading build.
+	uint32_t sizeof_relation;
+	uint32_t sizeof_input;
+	uint32_t sizeof_hand_joint_set;
+	uint32_t sizeof_body_joint_set;
+	uint32_t sizeof_output_value;
+
+	//! Monotonic time when the capture was started.
+	int64_t start_ns;
+};
+
+/*!
+ * Header of every record, followed by @ref size bytes of payload.
+ *
+ * @ingroup aux_util
+ */
+struct u_capture_record_header
+{
+	//! @ref u_capture_record_type
+	uint32_t type;
+
+	//! Size of the payload, a multiple of 8.
+	uint32_t size;
+
+	//! Which device in the capture, in order of their device records.
+	uint32_t device_index;
+
+	uint32_t _padding;
+
+	//! Monotonic time when the call returned.
+	int64_t timestamp_ns;
+};
+
+/*!
+ * The static parts of a HMD, the distortion is not captured.
+ *
+ * @ingroup aux_util
+ */
+struct u_capture_hmd
+{
+	int32_t screen_w_pixels;
+	int32_t screen_h_pixels;
+	uint64_t nominal_frame_interval_ns;
+
+	uint32_t view_count;
+	uint32_t blend_mode_count;
+	struct xrt_view views[XRT_MAX_VIEWS];
+	uint32_t blend_modes[XRT_MAX_DEVICE_BLEND_MODES];
+	struct xrt_fov fovs[XRT_MAX_VIEWS];
+};
+
+/*!
+ * Payload of @ref U_CAPTURE_RECORD_DEVICE, followed by @ref input_count and
+ * @ref output_count `uint32_t` names, padded to 8 bytes.
+ *
+ * @ingroup aux_util
+ */
+struct u_capture_device
+{
+	uint32_t name;
+	uint32_t device_type;
+	char str[XRT_DEVICE_NAME_LEN];
+	char serial[XRT_DEVICE_NAME_LEN];
+	struct xrt_device_supported supported;
+
+	uint32_t input_count;
+	uint32_t output_count;
+
+	//! Is @ref hmd valid.
+	uint32_t has_hmd;
+	uint32_t _padding;
+
+	struct u_capture_hmd hmd;
+};
+
+/*!
+ * One changed input in a @ref u_capture_inputs.
+ *
+ * @ingroup aux_util
+ */
+struct u_capture_input
+{
+	//! Index into the device's inputs.
+	uint32_t index;
+	uint32_t _padding;
+
+	struct xrt_input input;
+};
+
+/*!
+ * Payload of @ref U_CAPTURE_RECORD_INPUTS, followed by @ref count
+ * @ref u_capture_input.
+ *
+ * @ingroup aux_util
+ */
+struct u_capture_inputs
+{
+	uint32_t count;
+	uint32_t _padding;
+};
+
+/*!
+ * Payload of @ref U_CAPTURE_RECORD_TRACKED_POSE.
+ *
+ * @ingroup aux_util
+ */
+struct u_capture_tracked_pose
+{
+	uint32_t name;
+	int32_t result;
+	int64_t at_timestamp_ns;
+	struct xrt_space_relation relation;
+};
+
+/*!
+ * Payload of @ref U_CAPTURE_RECORD_HAND_TRACKING.
+ *
+ * @ingroup aux_util
+ */
+struct u_capture_hand_tracking
+{
+	uint32_t name;
+	int32_t result;
+	int64_t desired_timestamp_ns;
+	int64_t out_timestamp_ns;
+	struct xrt_hand_joint_set value;
+};
+
+/*!
+ * Payload of @ref U_CAPTURE_RECORD_VIEW_POSES.
+ *
+ * @ingroup aux_util
+ */
+struct u_capture_view_poses
+{
+	int64_t at_timestamp_ns;
+	struct xrt_vec3 default_eye_relation;
+	uint32_t view_count;
+	struct xrt_space_relation head_relation;
+	struct xrt_fov fovs[XRT_MAX_VIEWS];
+	struct xrt_pose poses[XRT_MAX_VIEWS];
+};
+
+/*!
+ * Payload of @ref U_CAPTURE_RECORD_BODY_JOINTS.
+ *
+ * @ingroup aux_util
+ */
+struct u_capture_body_joints
+{
+	uint32_t name;
+	int32_t result;
+	int64_t desired_timestamp_ns;
+	struct xrt_body_joint_set value;
+};
+
+/*!
+ * Payload of @ref U_CAPTURE_RECORD_OUTPUT, pointers of PCM vibrations are
+ * cleared, only the sizes and rate are kept.
+ *
+ * @ingroup aux_util
+ */
+struct u_capture_output
+{
+	uint32_t name;
+	uint32_t _padding;
+	struct xrt_output_value value;
+};
+
+
+/*
+ *
+ * Writer.
+ *
+ */
+
+/*!
+ * Appends records to a capture file, thread safe, reference counted so every
+ * wrapped device can hold on to it.
+ *
+ * @ingroup aux_util
+ */
+struct u_capture_writer;
+
+/*!
+ * Create a new capture file at @p path, truncating any existing file.
+ *
+ * @return false if the file could not be created.
+ *
+ * @ingroup aux_util
+ */
+bool
+u_capture_writer_create(const char *path, struct u_capture_writer **out_writer);
+
+/*!
+ * Update the reference counts on capture writer(s), the file is flushed and
+ * closed when the last reference is dropped.
+ *
+ * @ingroup aux_util
+ */
+void
+u_capture_writer_reference(struct u_capture_writer **dst, struct u_capture_writer *src);
+
+/*!
+ * Append a record, @p size is padded to 8 bytes. After a short write the
+ * capture is marked as failed and later records are dropped.
+ *
+ * @ingroup aux_util
+ */
+void
+u_capture_writer_write(struct u_capture_writer *writer,
+                       enum u_capture_record_type type,
+                       uint32_t device_index,
+                       int64_t timestamp_ns,
+                       const void *payload,
+                       size_t size);
+
+/*!
+ * Has a write to the file come up short, the file then ends at the last
+ * complete record before it.
+ *
+ * @ingroup aux_util
+ */
+bool
+u_capture_writer_has_failed(struct u_capture_writer *writer);
+
+/*!
+ * Hand out the next device index, returns false if the capture is full.
+ *
+ * @ingroup aux_util
+ */
+bool
+u_capture_writer_add_device(struct u_capture_writer *writer, uint32_t *out_device_index);
+
+/*!
+ * Wrap @p target in a device that forwards every call and records the
+ * results into @p writer, the new device takes ownership of @p target and
+ * a reference to @p writer.
+ *
+ * @ingroup aux_util
+ */
+xrt_result_t
+u_capture_device_wrap(struct u_capture_writer *writer, struct xrt_device *target, struct xrt_device **out_xdev);
+
+
+/*
+ *
+ * Reader.
+ *
+ */
+
+/*!
+ * A capture file mapped into memory, records are used in place.
+ *
+ * @ingroup aux_util
+ */
+struct u_capture_reader
+{
+	const uint8_t *data;
+	size_t size;
+
+	const struct u_capture_file_header *header;
+
+	//! How the data was mapped, for closing.
+	bool mapped;
+};
+
+/*!
+ * Map the capture at @p path and validate the header.
+ *
+ * @return false if the file could not be read or is not a valid capture.
+ *
+ * @ingroup aux_util
+ */
+bool
+u_capture_reader_open(const char *path, struct u_capture_reader *reader);
+
+/*!
+ * Create a reader over a capture already in memory, @p data must outlive the
+ * reader and be 8 byte aligned.
+ *
+ * @ingroup aux_util
+ */
+bool
+u_capture_reader_init_from_memory(const void *data, size_t size, struct u_capture_reader *reader);
+
+/*!
+ * Get the record at @p offset and move @p offset to the next one, start with
+ * an offset of zero. Returns false at the end or on a truncated record.
+ *
+ * @ingroup aux_util
+ */
+bool
+u_capture_reader_next(const struct u_capture_reader *reader,
+                      size_t *offset,
+                      const struct u_capture_record_header **out_header,
+                      const void **out_payload);
+
+/*!
+ * Unmap the capture.
+ *
+ * @ingroup aux_util
+ */
+void
+u_capture_reader_close(struct u_capture_reader *reader);
+
+/*!
+ * Names of the inputs of a device record, right after the payload struct.
+ *
+ * @ingroup aux_util
+ */
+static inline const uint32_t *
+u_capture_device_input_names(const struct u_capture_device *device)
+{
+	return (const uint32_t *)(device + 1);
+}
+
+/*!
+ * Names of the outputs of a device record, after the input names.
+ *
+ * @ingroup aux_util
+ */
+static inline const uint32_t *
+u_capture_device_output_names(const struct u_capture_device *device)
+{
+	return u_capture_device_input_names(device) + device->input_count;
+}
+
+/*!
+ * The changed inputs of an inputs record.
+ *
+ * @ingroup aux_util
+ */
+static inline const struct u_capture_input *
+u_capture_inputs_array(const struct u_capture_inputs *inputs)
+{
+	return (const struct u_capture_input *)(inputs + 1);
+}
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,532 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Device wrapper that records every call into a capture file.
+ * @ingroup aux_util
+ */
+
+#include "os/os_time.h"
+
+#include "math/m_api.h"
+
+#include "util/u_misc.h"
+#include "util/u_logging.h"
+#include "util/u_capture.h"
+
+#include <string.h>
+
+
+/*!
+ * Forwards every call to the wrapped device and records the results.
+ *
+ * @implements xrt_device
+ */
+struct u_capture_device_wrapper
+{
+	struct xrt_device base;
+
+	//! The device being recorded, owned.
+	struct xrt_device *target;
+
+	struct u_capture_writer *writer;
+
+	uint32_t device_index;
+
+	//! Inputs as of the last recorded update, to only record changes.
+	struct xrt_input *last_inputs;
+
+	//! Scratch for the inputs record, only used from update_inputs.
+	struct u_capture_inputs *inputs_record;
+};
+
+static inline struct u_capture_device_wrapper *
+u_capture_device_wrapper(struct xrt_device *xdev)
+{
+	return (struct u_capture_device_wrapper *)xdev;
+}
+
+static void
+record(struct u_capture_device_wrapper *d, enum u_capture_record_type type, const void *payload, size_t size)
+{
+	u_capture_writer_write(d->writer, type, d->device_index, os_monotonic_get_ns(), payload, size);
+}
+
+
+/*
+ *
+ * Recorded functions.
+ *
+ */
+
+static xrt_result_t
+capture_update_inputs(struct xrt_device *xdev)
+{
+	struct u_capture_device_wrapper *d = u_capture_device_wrapper(xdev);
+	struct xrt_device *target = d->target;
+
+	xrt_result_t xret = target->update_inputs(target);
+	if (xret != XRT_SUCCESS) {
+		return xret;
+	}
+
+	struct u_capture_input *changed = (struct u_capture_input *)(d->inputs_record + 1);
+	uint32_t count = 0;
+
+	for (size_t i = 0; i < target->input_count; i++) {
+		if (memcmp(&target->inputs[i], &d->last_inputs[i], sizeof(struct xrt_input)) == 0) {
+			continue;
+		}
+
+		d->last_inputs[i] = target->inputs[i];
+		changed[count].index = (uint32_t)i;
+		changed[count].input = target->inputs[i];
+		count++;
+	}
+
+	if (count > 0) {
+		d->inputs_record->count = count;
+		size_t size = sizeof(struct u_capture_inputs) + count * sizeof(struct u_capture_input);
+		record(d, U_CAPTURE_RECORD_INPUTS, d->inputs_record, size);
+	}
+
+	return XRT_SUCCESS;
+}
+
+static xrt_result_t
+capture_get_tracked_pose(struct xrt_device *xdev,
+                         enum xrt_input_name name,
+                         int64_t at_timestamp_ns,
+                         struct xrt_space_relation *out_relation)
+{
+	struct u_capture_device_wrapper *d = u_capture_device_wrapper(xdev);
+	struct xrt_device *target = d->target;
+
+	xrt_result_t xret = target->get_tracked_pose(target, name, at_timestamp_ns, out_relation);
+
+	struct u_capture_tracked_pose rec = {
+	    .name = name,
+	    .result = xret,
+	    .at_timestamp_ns = at_timestamp_ns,
+	};
+
+	// The relation may not have been written on failure.
+	if (xret == XRT_SUCCESS) {
+		rec.relation = *out_relation;
+	}
+	record(d, U_CAPTURE_RECORD_TRACKED_POSE, &rec, sizeof(rec));
+
+	return xret;
+}
+
+static void
+record_hand_tracking(struct u_capture_device_wrapper *d,
+                     enum xrt_input_name name,
+                     xrt_result_t xret,
+                     int64_t desired_timestamp_ns,
+                     const struct xrt_hand_joint_set *value,
+                     int64_t out_timestamp_ns)
+{
+	struct u_capture_hand_tracking rec = {
+	    .name = name,
+	    .result = xret,
+	    .desired_timestamp_ns = desired_timestamp_ns,
+	};
+
+	// The outputs may not have been written on failure.
+	if (xret == XRT_SUCCESS) {
+		rec.out_timestamp_ns = out_timestamp_ns;
+		rec.value = *value;
+	}
+	record(d, U_CAPTURE_RECORD_HAND_TRACKING, &rec, sizeof(rec));
+}
+
+static xrt_result_t
+capture_get_hand_tracking(struct xrt_device *xdev,
+                          enum xrt_input_name name,
+                          int64_t desired_timestamp_ns,
+                          struct xrt_hand_joint_set *out_value,
+                          int64_t *out_timestamp_ns)
+{
+	struct u_capture_device_wrapper *d = u_capture_device_wrapper(xdev);
+	struct xrt_device *target = d->target;
+
+	xrt_result_t xret = target->get_hand_tracking(target, name, desired_timestamp_ns, out_value, out_timestamp_ns);
+
+	int64_t timestamp_ns = xret == XRT_SUCCESS ? *out_timestamp_ns : 0;
+	record_hand_tracking(d, name, xret, desired_timestamp_ns, out_value, timestamp_ns);
+
+	return xret;
+}
+
+static xrt_result_t
+capture_get_hand_tracking_batch(struct xrt_device *xdev,
+                                uint32_t query_count,
+                                const enum xrt_input_name *names,
+                                const int64_t *desired_timestamps_ns,
+                                struct xrt_hand_joint_set *out_values,
+                                int64_t *out_timestamps_ns)
+{
+	struct u_capture_device_wrapper *d = u_capture_device_wrapper(xdev);
+	struct xrt_device *target = d->target;
+
+	xrt_result_t xret = target->get_hand_tracking_batch( //
+	    target,                                         //
+	    query_count,                                    //
+	    names,                                          //
+	    desired_timestamps_ns,                          //
+	    out_values,                                     //
+	    out_timestamps_ns);                             //
+	if (xret != XRT_SUCCESS) {
+		return xret;
+	}
+
+	// Recorded as single queries, replay serves them the same way.
+	for (uint32_t i = 0; i < query_count; i++) {
+		record_hand_tracking(d, names[i], xret, desired_timestamps_ns[i], &out_values[i], out_timestamps_ns[i]);
+	}
+
+	return xret;
+}
+
+static void
+capture_get_view_poses(struct xrt_device *xdev,
+                       const struct xrt_vec3 *default_eye_relation,
+                       int64_t at_timestamp_ns,
+                       uint32_t view_count,
+                       struct xrt_space_relation *out_head_relation,
+                       struct xrt_fov *out_fovs,
+                       struct xrt_pose *out_poses)
+{
+	struct u_capture_device_wrapper *d = u_capture_device_wrapper(xdev);
+	struct xrt_device *target = d->target;
+
+	target->get_view_poses(target, default_eye_relation, at_timestamp_ns, view_count, out_head_relation, out_fovs,
+	                       out_poses);
+
+	struct u_capture_view_poses rec = {
+	    .at_timestamp_ns = at_timestamp_ns,
+	    .default_eye_relation = *default_eye_relation,
+	    .view_count = MIN(view_count, XRT_MAX_VIEWS),
+	    .head_relation = *out_head_relation,
+	};
+	for (uint32_t i = 0; i < rec.view_count; i++) {
+		rec.fovs[i] = out_fovs[i];
+		rec.poses[i] = out_poses[i];
+	}
+	record(d, U_CAPTURE_RECORD_VIEW_POSES, &rec, sizeof(rec));
+}
+
+static xrt_result_t
+capture_get_body_joints(struct xrt_device *xdev,
+                        enum xrt_input_name body_tracking_type,
+                        int64_t desired_timestamp_ns,
+                        struct xrt_body_joint_set *out_value)
+{
+	struct u_capture_device_wrapper *d = u_capture_device_wrapper(xdev);
+	struct xrt_device *target = d->target;
+
+	xrt_result_t xret = target->get_body_joints(target, body_tracking_type, desired_timestamp_ns, out_value);
+
+	struct u_capture_body_joints rec = {
+	    .name = body_tracking_type,
+	    .result = xret,
+	    .desired_timestamp_ns = desired_timestamp_ns,
+	};
+
+	// The value may not have been written on failure.
+	if (xret == XRT_SUCCESS) {
+		rec.value = *out_value;
+	}
+	record(d, U_CAPTURE_RECORD_BODY_JOINTS, &rec, sizeof(rec));
+
+	return xret;
+}
+
+static void
+capture_set_output(struct xrt_device *xdev, enum xrt_output_name name, const struct xrt_output_value *value)
+{
+	struct u_capture_device_wrapper *d = u_capture_device_wrapper(xdev);
+	struct xrt_device *target = d->target;
+
+	target->set_output(target, name, value);
+
+	struct u_capture_output rec = {
+	    .name = name,
+	    .value = *value,
+	};
+
+	// The sample buffer is not captured, pointers would be meaningless.
+	if (rec.value.type == XRT_OUTPUT_VALUE_TYPE_PCM_VIBRATION) {
+		rec.value.pcm_vibration.buffer = NULL;
+		rec.value.pcm_vibration.samples_consumed = NULL;
+	}
+	record(d, U_CAPTURE_RECORD_OUTPUT, &rec, sizeof(rec));
+}
+
+
+/*
+ *
+ * Forwarded functions.
+ *
+ */
+
+static xrt_result_t
+capture_get_face_tracking(struct xrt_device *xdev,
+                          enum xrt_input_name facial_expression_type,
+                          int64_t at_timestamp_ns,
+                          struct xrt_facial_expression_set *out_value)
+{
+	struct xrt_device *target = u_capture_device_wrapper(xdev)->target;
+	return target->get_face_tracking(target, facial_expression_type, at_timestamp_ns, out_value);
+}
+
+static xrt_result_t
+capture_get_body_skeleton(struct xrt_device *xdev,
+                          enum xrt_input_name body_tracking_type,
+                          struct xrt_body_skeleton *out_value)
+{
+	struct xrt_device *target = u_capture_device_wrapper(xdev)->target;
+	return target->get_body_skeleton(target, body_tracking_type, out_value);
+}
+
+static xrt_result_t
+capture_get_output_limits(struct xrt_device *xdev, struct xrt_output_limits *limits)
+{
+	struct xrt_device *target = u_capture_device_wrapper(xdev)->target;
+	return target->get_output_limits(target, limits);
+}
+
+static xrt_result_t
+capture_begin_plane_detection_ext(struct xrt_device *xdev,
+                                  const struct xrt_plane_detector_begin_info_ext *begin_info,
+                                  uint64_t plane_detection_id,
+                                  uint64_t *out_plane_detection_id)
+{
+	struct xrt_device *target = u_capture_device_wrapper(xdev)->target;
+	return target->begin_plane_detection_ext(target, begin_info, plane_detection_id, out_plane_detection_id);
+}
+
+static xrt_result_t
+capture_destroy_plane_detection_ext(struct xrt_device *xdev, uint64_t plane_detection_id)
+{
+	struct xrt_device *target = u_capture_device_wrapper(xdev)->target;
+	return target->destroy_plane_detection_ext(target, plane_detection_id);
+}
+
+static xrt_result_t
+capture_get_plane_detection_state_ext(struct xrt_device *xdev,
+                                      uint64_t plane_detection_id,
+                                      enum xrt_plane_detector_state_ext *out_state)
+{
+	struct xrt_device *target = u_capture_device_wrapper(xdev)->target;
+	return target->get_plane_detection_state_ext(target, plane_detection_id, out_state);
+}
+
+static xrt_result_t
+capture_get_plane_detections_ext(struct xrt_device *xdev,
+                                 uint64_t plane_detection_id,
+                                 struct xrt_plane_detections_ext *out_detections)
+{
+	struct xrt_device *target = u_capture_device_wrapper(xdev)->target;
+	return target->get_plane_detections_ext(target, plane_detection_id, out_detections);
+}
+
+static bool
+capture_compute_distortion(struct xrt_device *xdev, uint32_t view, float u, float v, struct xrt_uv_triplet *out_result)
+{
+	struct xrt_device *target = u_capture_device_wrapper(xdev)->target;
+	return target->compute_distortion(target, view, u, v, out_result);
+}
+
+static xrt_result_t
+capture_get_visibility_mask(struct xrt_device *xdev,
+                            enum xrt_visibility_mask_type type,
+                            uint32_t view_index,
+                            struct xrt_visibility_mask **out_mask)
+{
+	struct xrt_device *target = u_capture_device_wrapper(xdev)->target;
+	return target->get_visibility_mask(target, type, view_index, out_mask);
+}
+
+static xrt_result_t
+capture_ref_space_usage(struct xrt_device *xdev,
+                        enum xrt_reference_space_type type,
+                        enum xrt_input_name name,
+                        bool used)
+{
+	struct xrt_device *target = u_capture_device_wrapper(xdev)->target;
+	return target->ref_space_usage(target, type, name, used);
+}
+
+static bool
+capture_is_form_factor_available(struct xrt_device *xdev, enum xrt_form_factor form_factor)
+{
+	struct xrt_device *target = u_capture_device_wrapper(xdev)->target;
+	return target->is_form_factor_available(target, form_factor);
+}
+
+static xrt_result_t
+capture_get_battery_status(struct xrt_device *xdev, bool *out_present, bool *out_charging, float *out_charge)
+{
+	struct xrt_device *target = u_capture_device_wrapper(xdev)->target;
+	return target->get_battery_status(target, out_present, out_charging, out_charge);
+}
+
+static xrt_result_t
+capture_begin_feature(struct xrt_device *xdev, enum xrt_device_feature_type type)
+{
+	struct xrt_device *target = u_capture_device_wrapper(xdev)->target;
+	return target->begin_feature(target, type);
+}
+
+static xrt_result_t
+capture_end_feature(struct xrt_device *xdev, enum xrt_device_feature_type type)
+{
+	struct xrt_device *target = u_capture_device_wrapper(xdev)->target;
+	return target->end_feature(target, type);
+}
+
+static void
+capture_destroy(struct xrt_device *xdev)
+{
+	struct u_capture_device_wrapper *d = u_capture_device_wrapper(xdev);
+
+	xrt_device_destroy(&d->target);
+	u_capture_writer_reference(&d->writer, NULL);
+
+	free(d->last_inputs);
+	free(d->inputs_record);
+	free(d);
+}
+
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+static void
+record_device(struct u_capture_device_wrapper *d)
+{
+	struct xrt_device *target = d->target;
+
+	size_t name_count = target->input_count + target->output_count;
+	size_t size = sizeof(struct u_capture_device) + name_count * sizeof(uint32_t);
+	struct u_capture_device *rec = calloc(1, size);
+
+	rec->name = target->name;
+	rec->device_type = target->device_type;
+	memcpy(rec->str, target->str, sizeof(rec->str));
+	memcpy(rec->serial, target->serial, sizeof(rec->serial));
+	rec->supported = target->supported;
+	rec->input_count = (uint32_t)target->input_count;
+	rec->output_count = (uint32_t)target->output_count;
+
+	uint32_t *names = (uint32_t *)(rec + 1);
+	for (size_t i = 0; i < target->input_count; i++) {
+		names[i] = target->inputs[i].name;
+	}
+	for (size_t i = 0; i < target->output_count; i++) {
+		names[target->input_count + i] = target->outputs[i].name;
+	}
+
+	struct xrt_hmd_parts *hmd = target->hmd;
+	if (hmd != NULL) {
+		rec->has_hmd = 1;
+		rec->hmd.screen_w_pixels = hmd->screens[0].w_pixels;
+		rec->hmd.screen_h_pixels = hmd->screens[0].h_pixels;
+		rec->hmd.nominal_frame_interval_ns = hmd->screens[0].nominal_frame_interval_ns;
+		rec->hmd.view_count = (uint32_t)MIN(hmd->view_count, XRT_MAX_VIEWS);
+		rec->hmd.blend_mode_count = (uint32_t)MIN(hmd->blend_mode_count, XRT_MAX_DEVICE_BLEND_MODES);
+		for (uint32_t i = 0; i < rec->hmd.view_count; i++) {
+			rec->hmd.views[i] = hmd->views[i];
+			rec->hmd.fovs[i] = hmd->distortion.fov[i];
+		}
+		for (uint32_t i = 0; i < rec->hmd.blend_mode_count; i++) {
+			rec->hmd.blend_modes[i] = hmd->blend_modes[i];
+		}
+	}
+
+	record(d, U_CAPTURE_RECORD_DEVICE, rec, size);
+
+	free(rec);
+}
+
+#define FORWARD_IF_SET(FUNC)                                                                                           \
+	do {                                                                                                           \
+		d->base.FUNC = target->FUNC != NULL ? capture_##FUNC : NULL;                                           \
+	} while (false)
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+xrt_result_t
+u_capture_device_wrap(struct u_capture_writer *writer, struct xrt_device *target, struct xrt_device **out_xdev)
+{
+	uint32_t device_index = 0;
+	if (!u_capture_writer_add_device(writer, &device_index)) {
+		U_LOG_E("Too many devices to capture, not wrapping '%s'", target->str);
+		return XRT_ERROR_ALLOCATION;
+	}
+
+	struct u_capture_device_wrapper *d = U_TYPED_CALLOC(struct u_capture_device_wrapper);
+	d->target = target;
+	d->device_index = device_index;
+	u_capture_writer_reference(&d->writer, writer);
+
+	// Same device to the outside, the inputs and outputs arrays are shared.
+	d->base.name = target->name;
+	d->base.device_type = target->device_type;
+	memcpy(d->base.str, target->str, sizeof(d->base.str));
+	memcpy(d->base.serial, target->serial, sizeof(d->base.serial));
+	d->base.hmd = target->hmd;
+	d->base.tracking_origin = target->tracking_origin;
+	d->base.binding_profile_count = target->binding_profile_count;
+	d->base.binding_profiles = target->binding_profiles;
+	d->base.input_count = target->input_count;
+	d->base.inputs = target->inputs;
+	d->base.output_count = target->output_count;
+	d->base.outputs = target->outputs;
+	d->base.supported = target->supported;
+
+	// Every function is forwarded, keep the ones the target does not have unset.
+	FORWARD_IF_SET(update_inputs);
+	FORWARD_IF_SET(get_tracked_pose);
+	FORWARD_IF_SET(get_hand_tracking);
+	FORWARD_IF_SET(get_hand_tracking_batch);
+	FORWARD_IF_SET(get_face_tracking);
+	FORWARD_IF_SET(get_body_skeleton);
+	FORWARD_IF_SET(get_body_joints);
+	FORWARD_IF_SET(set_output);
+	FORWARD_IF_SET(get_output_limits);
+	FORWARD_IF_SET(begin_plane_detection_ext);
+	FORWARD_IF_SET(destroy_plane_detection_ext);
+	FORWARD_IF_SET(get_plane_detection_state_ext);
+	FORWARD_IF_SET(get_plane_detections_ext);
+	FORWARD_IF_SET(get_view_poses);
+	FORWARD_IF_SET(compute_distortion);
+	FORWARD_IF_SET(get_visibility_mask);
+	FORWARD_IF_SET(ref_space_usage);
+	FORWARD_IF_SET(is_form_factor_available);
+	FORWARD_IF_SET(get_battery_status);
+	FORWARD_IF_SET(begin_feature);
+	FORWARD_IF_SET(end_feature);
+	d->base.destroy = capture_destroy;
+
+	// Start from zeroed inputs so the first update records every input.
+	d->last_inputs = U_TYPED_ARRAY_CALLOC(struct xrt_input, MAX(target->input_count, 1));
+	d->inputs_record = calloc(1, sizeof(struct u_capture_inputs) +
+	                                 MAX(target->input_count, 1) * sizeof(struct u_capture_input));
+
+	record_device(d);
+
+	*out_xdev = &d->base;
+
+	return XRT_SUCCESS;
+}
@@ -0,0 +1,461 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Always on recorder of frame timing events, dumped to file on hitches.
+ * @ingroup aux_util
+ */
+
+#include "os/os_time.h"
+#include "os/os_threading.h"
+
+#include "util/u_misc.h"
+#include "util/u_file.h"
+#include "util/u_time.h"
+#include "util/u_debug.h"
+#include "util/u_logging.h"
+#include "util/u_flight_recorder.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#ifdef XRT_OS_WINDOWS
+#include <windows.h>
+#endif
+
+
+DEBUG_GET_ONCE_BOOL_OPTION(flight_recorder, "XRT_FLIGHT_RECORDER", true)
+DEBUG_GET_ONCE_OPTION(flight_recorder_dir, "XRT_FLIGHT_RECORDER_DIR", NULL)
+DEBUG_GET_ONCE_NUM_OPTION(flight_recorder_seconds, "XRT_FLIGHT_RECORDER_SECONDS", 2)
+DEBUG_GET_ONCE_NUM_OPTION(flight_recorder_events, "XRT_FLIGHT_RECORDER_EVENTS", 16384)
+DEBUG_GET_ONCE_NUM_OPTION(flight_recorder_max_dumps, "XRT_FLIGHT_RECORDER_MAX_DUMPS", 16)
+
+//! Don't dump more often than this, a hitch often comes with friends.
+#define MIN_DUMP_INTERVAL_NS (5 * (int64_t)U_TIME_1S_IN_NS)
+
+//! Wait this long after a trigger so the dump shows what happened after it.
+#define POST_TRIGGER_NS (250 * U_TIME_1MS_IN_NS)
+
+
+/*
+ *
+ * Structs and defines.
+ *
+ */
+
+/*!
+ * Ring of events written by a single thread. The owning thread is the only
+ * writer, the dump thread reads it without locks and uses @p head to detect
+ * events that were overwritten while copying.
+ */
+struct fr_ring
+{
+	struct u_fr_event *events;
+
+	//! Number of events ever written, only written by the owning thread.
+	volatile int64_t head;
+
+	//! Is a live thread using this ring, protected by the list mutex.
+	bool in_use;
+
+	uint32_t index;
+	char name[16];
+
+	struct fr_ring *next;
+};
+
+struct flight_recorder
+{
+	bool active;
+
+	//! Size of every ring, power of two.
+	uint32_t capacity;
+
+	int64_t window_ns;
+
+	//! Used to find the ring for the calling thread, and release it on exit.
+	pthread_key_t key;
+
+	//! Protects the ring list and acquiring/releasing of rings.
+	struct os_mutex list_mutex;
+	struct fr_ring *rings;
+	uint32_t ring_count;
+
+	//! Scratch space for the dump thread.
+	struct u_fr_event *scratch;
+
+	//! Dump thread, state below protected by its lock.
+	struct os_thread_helper oth;
+	bool dump_pending;
+	int64_t dump_trigger_ns;
+	int64_t last_dump_ns;
+	uint32_t dump_count;
+	uint32_t max_dumps;
+};
+
+static struct flight_recorder g_fr;
+
+
+/*
+ *
+ * Atomic helpers.
+ *
+ */
+
+static inline int64_t
+load_acquire_s64(const volatile int64_t *ptr)
+{
+#if defined(__GNUC__)
+	return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#elif defined(_MSC_VER)
+	return InterlockedCompareExchange64((LONG64 volatile *)ptr, 0, 0);
+#else
+#error "compiler not supported"
+#endif
+}
+
+static inline void
+store_release_s64(volatile int64_t *ptr, int64_t value)
+{
+#if defined(__GNUC__)
+	__atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#elif defined(_MSC_VER)
+	InterlockedExchange64((LONG64 volatile *)ptr, value);
+#else
+#error "compiler not supported"
+#endif
+}
+
+
+/*
+ *
+ * Ring functions.
+ *
+ */
+
+static void
+ring_release(void *ptr)
+{
+	struct fr_ring *r = (struct fr_ring *)ptr;
+
+	os_mutex_lock(&g_fr.list_mutex);
+	r->in_use = false;
+	os_mutex_unlock(&g_fr.list_mutex);
+}
+
+static struct fr_ring *
+ring_acquire(void)
+{
+	struct fr_ring *r = NULL;
+
+	os_mutex_lock(&g_fr.list_mutex);
+
+	// Reuse rings of threads that have exited.
+	for (struct fr_ring *it = g_fr.rings; it != NULL; it = it->next) {
+		if (!it->in_use) {
+			r = it;
+			break;
+		}
+	}
+
+	if (r == NULL) {
+		r = U_TYPED_CALLOC(struct fr_ring);
+		r->events = U_TYPED_ARRAY_CALLOC(struct u_fr_event, g_fr.capacity);
+		r->index = g_fr.ring_count++;
+		r->next = g_fr.rings;
+		g_fr.rings = r;
+	}
+
+	// Old events belong to another thread.
+	memset(r->events, 0, sizeof(struct u_fr_event) * g_fr.capacity);
+	r->head = 0;
+	r->in_use = true;
+
+	snprintf(r->name, sizeof(r->name), "thread %u", r->index);
+#if defined(XRT_OS_LINUX) && defined(__GLIBC__)
+	pthread_getname_np(pthread_self(), r->name, sizeof(r->name));
+#endif
+
+	os_mutex_unlock(&g_fr.list_mutex);
+
+	pthread_setspecific(g_fr.key, r);
+
+	return r;
+}
+
+static inline struct fr_ring *
+ring_get(void)
+{
+	struct fr_ring *r = (struct fr_ring *)pthread_getspecific(g_fr.key);
+	if (r == NULL) {
+		r = ring_acquire();
+	}
+
+	return r;
+}
+
+/*!
+ * Copies the events of the ring recorded within the window into scratch,
+ * must be called with the list mutex held.
+ */
+static uint32_t
+ring_snapshot(struct fr_ring *r, int64_t start_ns, struct u_fr_event *out_events)
+{
+	const int64_t capacity = g_fr.capacity;
+	const int64_t mask = capacity - 1;
+
+	int64_t head = load_acquire_s64(&r->head);
+	int64_t first = head > capacity ? head - capacity : 0;
+
+	for (int64_t i = first; i < head; i++) {
+		out_events[i - first] = r->events[i & mask];
+	}
+
+	/*
+	 * The owner kept writing while we copied, anything it could have
+	 * overwritten (including the slot of the event being written) is junk.
+	 */
+	int64_t head_after = load_acquire_s64(&r->head);
+	int64_t first_valid = head_after >= capacity ? head_after - capacity + 1 : 0;
+	int64_t skip = first_valid > first ? first_valid - first : 0;
+
+	uint32_t count = 0;
+	for (int64_t i = skip; i < head - first; i++) {
+		const struct u_fr_event *e = &out_events[i];
+		if (e->type == U_FR_EVENT_NONE || e->when_ns < start_ns) {
+			continue;
+		}
+		out_events[count++] = *e;
+	}
+
+	return count;
+}
+
+
+/*
+ *
+ * Dump functions.
+ *
+ */
+
+static FILE *
+open_dump_file(int64_t trigger_ns)
+{
+	char name[64];
+	snprintf(name, sizeof(name), "flight_recorder_%" PRId64 ".xfr", trigger_ns);
+
+	const char *dir = debug_get_option_flight_recorder_dir();
+	if (dir == NULL) {
+		return u_file_open_file_in_config_dir_subpath("flight_recorder", name, "wb");
+	}
+
+	char path[1024];
+	snprintf(path, sizeof(path), "%s/%s", dir, name);
+
+	return fopen(path, "wb");
+}
+
+static void
+write_dump(int64_t trigger_ns)
+{
+	FILE *file = open_dump_file(trigger_ns);
+	if (file == NULL) {
+		U_LOG_E("Could not open flight recorder dump file!");
+		return;
+	}
+
+	os_mutex_lock(&g_fr.list_mutex);
+
+	struct u_fr_file_header header = {
+	    .magic = U_FR_FILE_MAGIC,
+	    .version = U_FR_FILE_VERSION,
+	    .thread_count = g_fr.ring_count,
+	    .trigger_ns = trigger_ns,
+	    .window_ns = g_fr.window_ns,
+	};
+	fwrite(&header, sizeof(header), 1, file);
+
+	size_t total = 0;
+	for (struct fr_ring *r = g_fr.rings; r != NULL; r = r->next) {
+		uint32_t count = ring_snapshot(r, trigger_ns - g_fr.window_ns, g_fr.scratch);
+
+		struct u_fr_file_thread thread = {
+		    .thread_index = r->index,
+		    .event_count = count,
+		};
+		memcpy(thread.name, r->name, sizeof(thread.name));
+
+		fwrite(&thread, sizeof(thread), 1, file);
+		fwrite(g_fr.scratch, sizeof(struct u_fr_event), count, file);
+		total += count;
+	}
+
+	os_mutex_unlock(&g_fr.list_mutex);
+
+	fclose(file);
+
+	U_LOG_W("Frame deadline missed, wrote %zu flight recorder events", total);
+}
+
+static void *
+run_dump_thread(void *ptr)
+{
+	os_thread_helper_name(&g_fr.oth, "Flight Recorder");
+
+	os_thread_helper_lock(&g_fr.oth);
+
+	while (os_thread_helper_is_running_locked(&g_fr.oth)) {
+		if (!g_fr.dump_pending) {
+			os_thread_helper_wait_locked(&g_fr.oth);
+			continue;
+		}
+
+		int64_t trigger_ns = g_fr.dump_trigger_ns;
+		os_thread_helper_unlock(&g_fr.oth);
+
+		// Let the events right after the hitch land as well.
+		os_nanosleep(POST_TRIGGER_NS);
+		write_dump(trigger_ns);
+
+		os_thread_helper_lock(&g_fr.oth);
+		g_fr.dump_pending = false;
+	}
+
+	os_thread_helper_unlock(&g_fr.oth);
+
+	return NULL;
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+void
+u_fr_init(void)
+{
+	if (g_fr.active || !debug_get_bool_option_flight_recorder()) {
+		return;
+	}
+
+	// Round up to a power of two, masking is cheaper than modulo.
+	uint32_t capacity = 1024;
+	while (capacity < (uint32_t)debug_get_num_option_flight_recorder_events() && capacity < (1u << 24)) {
+		capacity <<= 1;
+	}
+
+	g_fr.capacity = capacity;
+	g_fr.window_ns = debug_get_num_option_flight_recorder_seconds() * (int64_t)U_TIME_1S_IN_NS;
+	g_fr.max_dumps = (uint32_t)debug_get_num_option_flight_recorder_max_dumps();
+	g_fr.scratch = U_TYPED_ARRAY_CALLOC(struct u_fr_event, capacity);
+
+	if (pthread_key_create(&g_fr.key, ring_release) != 0) {
+		U_LOG_E("Failed to create flight recorder thread key!");
+		free(g_fr.scratch);
+		g_fr.scratch = NULL;
+		return;
+	}
+
+	os_mutex_init(&g_fr.list_mutex);
+	os_thread_helper_init(&g_fr.oth);
+	os_thread_helper_start(&g_fr.oth, run_dump_thread, NULL);
+
+	g_fr.active = true;
+
+	U_LOG_D("Flight recorder active, %u events per thread", capacity);
+}
+
+void
+u_fr_close(void)
+{
+	if (!g_fr.active) {
+		return;
+	}
+
+	g_fr.active = false;
+
+	os_thread_helper_destroy(&g_fr.oth);
+
+	/*
+	 * Threads still alive keep their ring pointer in the key, deleting
+	 * the key first means the destructor won't run on freed rings.
+	 */
+	pthread_key_delete(g_fr.key);
+
+	os_mutex_lock(&g_fr.list_mutex);
+	struct fr_ring *r = g_fr.rings;
+	while (r != NULL) {
+		struct fr_ring *next = r->next;
+		free(r->events);
+		free(r);
+		r = next;
+	}
+	g_fr.rings = NULL;
+	g_fr.ring_count = 0;
+	os_mutex_unlock(&g_fr.list_mutex);
+
+	os_mutex_destroy(&g_fr.list_mutex);
+
+	free(g_fr.scratch);
+	U_ZERO(&g_fr);
+}
+
+bool
+u_fr_is_active(void)
+{
+	return g_fr.active;
+}
+
+void
+u_fr_record(enum u_fr_event_type type, int64_t frame_id, int64_t when_ns, int64_t value, uint32_t arg)
+{
+	if (!g_fr.active) {
+		return;
+	}
+
+	struct fr_ring *r = ring_get();
+	int64_t head = r->head;
+
+	struct u_fr_event *e = &r->events[head & (g_fr.capacity - 1)];
+	e->when_ns = when_ns;
+	e->frame_id = frame_id;
+	e->value = value;
+	e->arg = arg;
+	e->type = (uint16_t)type;
+
+	store_release_s64(&r->head, head + 1);
+}
+
+void
+u_fr_record_now(enum u_fr_event_type type, int64_t frame_id, int64_t value, uint32_t arg)
+{
+	if (!g_fr.active) {
+		return;
+	}
+
+	u_fr_record(type, frame_id, os_monotonic_get_ns(), value, arg);
+}
+
+void
+u_fr_trigger_dump(int64_t when_ns)
+{
+	if (!g_fr.active) {
+		return;
+	}
+
+	os_thread_helper_lock(&g_fr.oth);
+
+	bool too_soon = g_fr.dump_count > 0 && when_ns - g_fr.last_dump_ns < MIN_DUMP_INTERVAL_NS;
+	if (!g_fr.dump_pending && !too_soon && g_fr.dump_count < g_fr.max_dumps) {
+		g_fr.dump_pending = true;
+		g_fr.dump_trigger_ns = when_ns;
+		g_fr.last_dump_ns = when_ns;
+		g_fr.dump_count++;
+		os_thread_helper_signal_locked(&g_fr.oth);
+	}
+
+	os_thread_helper_unlock(&g_fr.oth);
+}
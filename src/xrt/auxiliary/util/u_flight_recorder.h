@@ -0,0 +1,189 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Always on recorder of frame timing events, dumped to file on hitches.
+ * @ingroup aux_util
+ */
+
+#pragma once
+
+#include "xrt/xrt_compiler.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * @defgroup aux_flight_recorder Flight recorder
+ * @ingroup aux_util
+ *
+ * @brief Per-thread ring buffers of small binary timing events.
+ *
+ * Recording is a handful of stores into a thread-local ring, so it is left on
+ * in production builds. When a frame misses its deadline the last few seconds
+ * of all rings are written to a file by a background thread, the file can be
+ * converted to a Perfetto loadable JSON trace with
+ * `scripts/flight_recorder_to_perfetto.py`.
+ *
+ * Controlled with the following environment variables:
+ * - `XRT_FLIGHT_RECORDER` enable recording, default on.
+ * - `XRT_FLIGHT_RECORDER_DIR` directory to write dumps to, defaults to the
+ *   `flight_recorder` directory in the config dir.
+ * - `XRT_FLIGHT_RECORDER_SECONDS` how much history to dump, default 2.
+ * - `XRT_FLIGHT_RECORDER_EVENTS` ring size per thread, default 16384.
+ * - `XRT_FLIGHT_RECORDER_MAX_DUMPS` dumps per process, default 16.
+ *
+ * @{
+ */
+
+//! Magic at the start of a flight recorder dump.
+#define U_FR_FILE_MAGIC "xrtfrec"
+
+//! Version of the dump file format.
+#define U_FR_FILE_VERSION 1
+
+/*!
+ * Type of a recorded event, the meaning of the fields in @ref u_fr_event
+ * depends on it.
+ */
+enum u_fr_event_type
+{
+	U_FR_EVENT_NONE = 0,
+
+	//! Compositor @ref u_timing_point, @p arg is the point.
+	U_FR_EVENT_COMP_POINT = 1,
+
+	//! Compositor frame presented, @p when_ns is actual, @p value desired present time.
+	U_FR_EVENT_COMP_PRESENT = 2,
+
+	//! Compositor GPU work, @p when_ns is start, @p value end of GPU work.
+	U_FR_EVENT_COMP_GPU = 3,
+
+	//! App @ref u_timing_point, @p arg is the point, @p value the session id.
+	U_FR_EVENT_APP_POINT = 4,
+
+	//! App frame delivered, @p value is the session id.
+	U_FR_EVENT_APP_DELIVERED = 5,
+
+	//! App GPU work done, @p value is the session id.
+	U_FR_EVENT_APP_GPU_DONE = 6,
+
+	//! IPC call dispatch started, @p arg is the command, @p value the client.
+	U_FR_EVENT_IPC_BEGIN = 7,
+
+	//! IPC call dispatch ended, @p arg is the command, @p value the client.
+	U_FR_EVENT_IPC_END = 8,
+
+	//! Compositor frame missed its deadline, @p value is by how much.
+	U_FR_EVENT_COMP_MISS = 9,
+
+	//! App frame missed its display time, @p value is by how much, @p arg the session id.
+	U_FR_EVENT_APP_MISS = 10,
+};
+
+/*!
+ * A single recorded event, 32 bytes, written as is to dump files.
+ */
+struct u_fr_event
+{
+	int64_t when_ns;
+	int64_t frame_id;
+	int64_t value;
+	uint32_t arg;
+	uint16_t type;
+	uint16_t _pad;
+};
+
+/*!
+ * Header of a dump file, followed by @p thread_count thread blocks.
+ */
+struct u_fr_file_header
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t thread_count;
+	//! Time of the event that triggered the dump.
+	int64_t trigger_ns;
+	//! How much history before @p trigger_ns was requested.
+	int64_t window_ns;
+};
+
+/*!
+ * Header of a per-thread block, followed by @p event_count events.
+ */
+struct u_fr_file_thread
+{
+	uint32_t thread_index;
+	uint32_t event_count;
+	char name[16];
+};
+
+
+/*!
+ * Reads the environment and starts the dump thread, call once at startup.
+ */
+void
+u_fr_init(void);
+
+/*!
+ * Stops the dump thread and frees all rings.
+ */
+void
+u_fr_close(void);
+
+/*!
+ * Is the recorder initialized and recording.
+ */
+bool
+u_fr_is_active(void);
+
+/*!
+ * Record an event into the calling thread's ring.
+ */
+void
+u_fr_record(enum u_fr_event_type type, int64_t frame_id, int64_t when_ns, int64_t value, uint32_t arg);
+
+/*!
+ * Same as @ref u_fr_record but timestamped with the current time, only reads
+ * the clock if the recorder is active.
+ */
+void
+u_fr_record_now(enum u_fr_event_type type, int64_t frame_id, int64_t value, uint32_t arg);
+
+/*!
+ * Ask the dump thread to write out the history leading up to @p when_ns,
+ * cheap and safe to call from any thread, rate limited internally.
+ */
+void
+u_fr_trigger_dump(int64_t when_ns);
+
+/*!
+ * Records a compositor miss and triggers a dump.
+ */
+static inline void
+u_fr_comp_miss(int64_t frame_id, int64_t when_ns, int64_t missed_by_ns)
+{
+	u_fr_record(U_FR_EVENT_COMP_MISS, frame_id, when_ns, missed_by_ns, 0);
+	u_fr_trigger_dump(when_ns);
+}
+
+/*!
+ * Records an app miss and triggers a dump.
+ */
+static inline void
+u_fr_app_miss(int64_t session_id, int64_t frame_id, int64_t when_ns, int64_t missed_by_ns)
+{
+	u_fr_record(U_FR_EVENT_APP_MISS, frame_id, when_ns, missed_by_ns, (uint32_t)session_id);
+	u_fr_trigger_dump(when_ns);
+}
+
+/*!
+ * @}
+ */
+
+
+#ifdef __cplusplus
+}
+#endif
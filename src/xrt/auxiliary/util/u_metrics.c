@@ -18,7 +18,7 @@
 #include <stdio.h>
 
 #define VERSION_MAJOR 1
-#define VERSION_MINOR 1
+#define VERSION_MINOR 5
 
 static FILE *g_file = NULL;
 static struct os_mutex g_file_mutex;
@@ -233,5 +233,65 @@ u_metrics_write_system_present_info(struct u_metrics_system_present_info *umpi)
 #undef COPY
 
 
+	write_record(&record);
+}
+
+void
+u_metrics_write_prediction_error(struct u_metrics_prediction_error *umpe)
+{
+	if (!g_metrics_initialized) {
+		return;
+	}
+
+	VRuska Engine_metrics_Record record = VRuska Engine_metrics_Record_init_default;
+
+	// Select which filed is used.
+	record.which_record = VRuska Engine_metrics_Record_prediction_error_tag;
+
+#define COPY(_0, _1, _2, _3, FIELD, _4) (record.record.prediction_error.FIELD = umpe->FIELD);
+	VRuska Engine_metrics_PredictionError_FIELDLIST(COPY, 0);
+#undef COPY
+
+
+	write_record(&record);
+}
+
+void
+u_metrics_write_system_gpu_passes(struct u_metrics_system_gpu_passes *umgp)
+{
+	if (!g_metrics_initialized) {
+		return;
+	}
+
+	VRuska Engine_metrics_Record record = VRuska Engine_metrics_Record_init_default;
+
+	// Select which filed is used.
+	record.which_record = VRuska Engine_metrics_Record_system_gpu_passes_tag;
+
+#define COPY(_0, _1, _2, _3, FIELD, _4) (record.record.system_gpu_passes.FIELD = umgp->FIELD);
+	VRuska Engine_metrics_SystemGpuPasses_FIELDLIST(COPY, 0);
+#undef COPY
+
+
+	write_record(&record);
+}
+
+void
+u_metrics_write_session_pacing(struct u_metrics_session_pacing *umsp)
+{
+	if (!g_metrics_initialized) {
+		return;
+	}
+
+	VRuska Engine_metrics_Record record = VRuska Engine_metrics_Record_init_default;
+
+	// Select which filed is used.
+	record.which_record = VRuska Engine_metrics_Record_session_pacing_tag;
+
+#define COPY(_0, _1, _2, _3, FIELD, _4) (record.record.session_pacing.FIELD = umsp->FIELD);
+	VRuska Engine_metrics_SessionPacing_FIELDLIST(COPY, 0);
+#undef COPY
+
+
 	write_record(&record);
 }
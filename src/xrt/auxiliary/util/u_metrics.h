@@ -79,6 +79,41 @@ struct u_metrics_system_present_info
 	uint64_t earliest_present_time_ns;
 };
 
+struct u_metrics_prediction_error
+{
+	uint64_t history_id;
+	uint32_t model;
+	uint64_t predicted_time_ns;
+	uint64_t horizon_ns;
+	float position_error_m;
+	float orientation_error_rad;
+};
+
+struct u_metrics_system_gpu_passes
+{
+	int64_t frame_id;
+	uint64_t layers_ns;
+	uint64_t distortion_ns;
+	uint64_t clear_ns;
+	uint64_t blit_ns;
+	uint64_t total_ns;
+	float scratch_scale;
+};
+
+struct u_metrics_session_pacing
+{
+	int64_t session_id;
+	int64_t frame_id;
+	bool percentile;
+	int64_t predicted_wake_up_time_ns;
+	int64_t predicted_display_time_ns;
+	int64_t app_time_ns;
+	int64_t margin_ns;
+	int64_t compositor_time_ns;
+	float miss_target;
+	float miss_rate;
+};
+
 
 void
 u_metrics_init(void);
@@ -104,6 +139,15 @@ u_metrics_write_system_gpu_info(struct u_metrics_system_gpu_info *umgi);
 void
 u_metrics_write_system_present_info(struct u_metrics_system_present_info *umpi);
 
+void
+u_metrics_write_prediction_error(struct u_metrics_prediction_error *umpe);
+
+void
+u_metrics_write_system_gpu_passes(struct u_metrics_system_gpu_passes *umgp);
+
+void
+u_metrics_write_session_pacing(struct u_metrics_session_pacing *umsp);
+
 
 #ifdef __cplusplus
 }
@@ -44,6 +44,12 @@ enum u_timing_point
 
 	//! Finished submitting work to the GPU, only used by the compositor.
 	U_TIMING_POINT_SUBMIT_END,
+
+	//! Finished submitting the layer squashing, only used by the compositor when warping late.
+	U_TIMING_POINT_SQUASH_SUBMIT_END,
+
+	//! The late warp woke up and sampled the head pose, only used by the compositor when warping late.
+	U_TIMING_POINT_LATE_WARP_WAKE_UP,
 };
 
 
@@ -110,6 +116,23 @@ struct u_pacing_compositor
 	                   int64_t frame_id,
 	                   int64_t when_ns);
 
+	/*!
+	 * Predict when the late warp of a frame should wake up.
+	 *
+	 * Used by compositors that squash the layers as soon as the frame is
+	 * begun and then sleep to warp and distort them as late as possible,
+	 * the late warp is marked with @ref U_TIMING_POINT_LATE_WARP_WAKE_UP
+	 * and its submit with @ref U_TIMING_POINT_SUBMIT_BEGIN and
+	 * @ref U_TIMING_POINT_SUBMIT_END.
+	 *
+	 * @param[in]  upc                 The compositor pacing helper.
+	 * @param[in]  frame_id            The frame ID returned by @ref u_pacing_compositor::predict.
+	 * @param[out] out_wake_up_time_ns When the late warp should wake up and sample the head pose.
+	 *
+	 * @see @ref frame-pacing.
+	 */
+	void (*predict_late_warp)(struct u_pacing_compositor *upc, int64_t frame_id, int64_t *out_wake_up_time_ns);
+
 	/*!
 	 * Provide frame timing information about a delivered frame.
 	 *
@@ -241,6 +264,20 @@ u_pc_mark_point(struct u_pacing_compositor *upc, enum u_timing_point point, int6
 	upc->mark_point(upc, point, frame_id, when_ns);
 }
 
+/*!
+ * @copydoc u_pacing_compositor::predict_late_warp
+ *
+ * Helper for calling through the function pointer.
+ *
+ * @public @memberof u_pacing_compositor
+ * @ingroup aux_pacing
+ */
+static inline void
+u_pc_predict_late_warp(struct u_pacing_compositor *upc, int64_t frame_id, int64_t *out_wake_up_time_ns)
+{
+	upc->predict_late_warp(upc, frame_id, out_wake_up_time_ns);
+}
+
 /*!
  * @copydoc u_pacing_compositor::info
  *
@@ -328,12 +365,64 @@ u_pc_destroy(struct u_pacing_compositor **upc_ptr)
 }
 
 
+/*!
+ * Record the GPU time of a compositor frame into the process wide statistics,
+ * called by the @ref u_pacing_compositor implementations from their
+ * @ref u_pacing_compositor::info_gpu function.
+ *
+ * @ingroup aux_pacing
+ */
+void
+u_pc_record_gpu_time(int64_t gpu_start_ns, int64_t gpu_end_ns);
+
+/*!
+ * Filtered GPU time of the compositor frames rendered in this process, zero if
+ * no frame has been rendered yet. Safe to call from any thread.
+ *
+ * @ingroup aux_pacing
+ */
+int64_t
+u_pc_get_gpu_time_ns(void);
+
+
 /*
  *
  * App pacer.
  *
  */
 
+/*!
+ * Running statistics of a @ref u_pacing_app, see @ref u_pacing_app::get_stats.
+ *
+ * @ingroup aux_pacing
+ */
+struct u_pacing_app_stats
+{
+	//! Frames that were delivered and had their GPU work complete.
+	uint64_t delivered_count;
+
+	//! Frames the app discarded.
+	uint64_t discarded_count;
+
+	//! Delivered frames whose GPU work completed after their display time.
+	uint64_t missed_count;
+
+	//! Filtered time between delivered frames.
+	int64_t frame_period_ns;
+
+	//! Filtered time between wait returning and begin being called.
+	int64_t cpu_time_ns;
+
+	//! Filtered time between begin and the frame being delivered.
+	int64_t draw_time_ns;
+
+	//! Filtered time between the frame being delivered and the GPU completing.
+	int64_t gpu_time_ns;
+
+	//! Filtered time between the compositor latching a frame and its display time.
+	int64_t latch_to_display_ns;
+};
+
 /*!
  * This application pacing helper is designed to schedule the rendering time of
  * clients that submit frames to a compositor, which runs its own render loop
@@ -456,6 +545,15 @@ struct u_pacing_app
 	             int64_t predicted_display_period_ns,
 	             int64_t extra_ns);
 
+	/*!
+	 * Get the running statistics of this app pacer, needs the same
+	 * external locking as the other functions.
+	 *
+	 * @param      upa       App pacer struct.
+	 * @param[out] out_stats Statistics.
+	 */
+	void (*get_stats)(struct u_pacing_app *upa, struct u_pacing_app_stats *out_stats);
+
 	/*!
 	 * Destroy this u_pacing_app.
 	 */
@@ -583,6 +681,20 @@ u_pa_retired(struct u_pacing_app *upa, int64_t frame_id, int64_t when_ns)
 	upa->retired(upa, frame_id, when_ns);
 }
 
+/*!
+ * @copydoc u_pacing_app::get_stats
+ *
+ * Helper for calling through the function pointer.
+ *
+ * @public @memberof u_pacing_app
+ * @ingroup aux_pacing
+ */
+static inline void
+u_pa_get_stats(struct u_pacing_app *upa, struct u_pacing_app_stats *out_stats)
+{
+	upa->get_stats(upa, out_stats);
+}
+
 /*!
  * @copydoc u_pacing_app::destroy
  *
@@ -697,9 +809,19 @@ struct u_pc_display_timing_config
 	uint32_t adjust_missed_fraction;
 	//! When not missing frames but adjusting app time at these increments
 	uint32_t adjust_non_miss_fraction;
+	//! The initial estimate of how much time the late warp needs, if used
+	uint32_t late_warp_time_fraction;
 	/*!
 	 * @}
 	 */
+	/*!
+	 * Fit the vblank period and phase to the present feedback and display
+	 * control vblanks, and wake the compositor from the distribution of its
+	 * frame times, instead of stepping the compositor time towards a margin.
+	 */
+	bool fit_model;
+	//! Percentage of frames allowed to miss their present, only used with @ref fit_model.
+	float miss_target_percentage;
 };
 
 /*!
@@ -709,6 +831,46 @@ struct u_pc_display_timing_config
  */
 extern const struct u_pc_display_timing_config U_PC_DISPLAY_TIMING_CONFIG_DEFAULT;
 
+/*!
+ * How a @ref u_pacing_app estimates the time the app needs for a frame.
+ *
+ * @see u_pa_config
+ */
+enum u_pa_mode
+{
+	//! Filtered average of each phase of the frame, plus a fixed margin.
+	U_PA_MODE_IIR,
+	//! Percentiles of recent frames, with a margin picked to meet a miss rate target.
+	U_PA_MODE_PERCENTILE,
+};
+
+/*!
+ * Configuration for the app pacers created by a @ref u_pacing_app_factory.
+ *
+ * @see u_pa_factory_create_with_config
+ */
+struct u_pa_config
+{
+	enum u_pa_mode mode;
+	//! Smallest time given to the app for a frame.
+	float min_app_time_ms;
+	//! Smallest margin between the app's GPU work completing and the compositor.
+	float min_margin_ms;
+	/*!
+	 * Percentage of frames allowed to miss the compositor, the margin is
+	 * grown to cover all other frames. Only used by @ref U_PA_MODE_PERCENTILE.
+	 */
+	float miss_target_percentage;
+};
+
+/*!
+ * Default configuration values for app pacing, the same as used by
+ * @ref u_pa_factory_create when no options are set.
+ *
+ * @see u_pa_config, u_pa_factory_create_with_config
+ */
+extern const struct u_pa_config U_PA_CONFIG_DEFAULT;
+
 
 /*
  *
@@ -753,6 +915,16 @@ u_pc_fake_create(int64_t estimated_frame_period_ns, int64_t now_ns, struct u_pac
 xrt_result_t
 u_pa_factory_create(struct u_pacing_app_factory **out_upaf);
 
+/*!
+ * Creates a new application pacing factory helper, with the given config
+ * instead of the one from the environment.
+ *
+ * @ingroup aux_pacing
+ * @see u_pacing_app, u_pa_config
+ */
+xrt_result_t
+u_pa_factory_create_with_config(const struct u_pa_config *config, struct u_pacing_app_factory **out_upaf);
+
 
 #ifdef __cplusplus
 }
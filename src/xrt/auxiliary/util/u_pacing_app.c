@@ -15,10 +15,13 @@
 #include "util/u_debug.h"
 #include "util/u_pacing.h"
 #include "util/u_metrics.h"
+#include "util/u_flight_recorder.h"
 #include "util/u_logging.h"
 #include "util/u_trace_marker.h"
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
 DEBUG_GET_ONCE_LOG_OPTION(log_level, "U_PACING_APP_LOG", U_LOGGING_WARN)
@@ -26,6 +29,9 @@ DEBUG_GET_ONCE_FLOAT_OPTION(min_app_time_ms, "U_PACING_APP_MIN_TIME_MS", 1.0f)
 DEBUG_GET_ONCE_FLOAT_OPTION(min_margin_ms, "U_PACING_APP_MIN_MARGIN_MS", 2.0f)
 DEBUG_GET_ONCE_BOOL_OPTION(use_min_frame_period, "U_PACING_APP_USE_MIN_FRAME_PERIOD", false)
 DEBUG_GET_ONCE_BOOL_OPTION(immediate_wait_frame_return, "U_PACING_APP_IMMEDIATE_WAIT_FRAME_RETURN", false)
+DEBUG_GET_ONCE_BOOL_OPTION(percentile, "U_PACING_APP_PERCENTILE", false)
+DEBUG_GET_ONCE_FLOAT_OPTION(percentile_min_margin_ms, "U_PACING_APP_PERCENTILE_MIN_MARGIN_MS", 0.5f)
+DEBUG_GET_ONCE_FLOAT_OPTION(miss_target_percentage, "U_PACING_APP_MISS_TARGET_PERCENTAGE", 1.0f)
 
 #define UPA_LOG_T(...) U_LOG_IFL_T(debug_get_log_option_log_level(), __VA_ARGS__)
 #define UPA_LOG_D(...) U_LOG_IFL_D(debug_get_log_option_log_level(), __VA_ARGS__)
@@ -54,6 +60,18 @@ DEBUG_GET_ONCE_BOOL_OPTION(immediate_wait_frame_return, "U_PACING_APP_IMMEDIATE_
  */
 #define FRAME_COUNT (128)
 
+/*!
+ * How many of the latest frames the percentiles are taken over, at a 1%
+ * miss target the margin covers the slowest of them.
+ */
+#define PERCENTILE_WINDOW (128)
+
+/*!
+ * Frames needed before @ref U_PA_MODE_PERCENTILE uses the percentiles, until
+ * then the filtered times are used.
+ */
+#define PERCENTILE_MIN_SAMPLES (16)
+
 enum u_pa_state
 {
 	U_PA_READY,
@@ -102,6 +120,21 @@ struct u_pa_frame
 	enum u_pa_state state;
 };
 
+//! Ring of the latest samples of one phase of the frame.
+struct u_pa_window
+{
+	int64_t samples[PERCENTILE_WINDOW];
+	uint32_t next;
+	uint32_t count;
+};
+
+struct u_pa_percentiles
+{
+	int64_t p50_ns;
+	int64_t p95_ns;
+	int64_t p99_ns;
+};
+
 struct pacing_app
 {
 	struct u_pacing_app base;
@@ -109,6 +142,12 @@ struct pacing_app
 	//! Id for this session.
 	int64_t session_id;
 
+	//! How the app time and margin are picked.
+	enum u_pa_mode mode;
+
+	//! Fraction of frames allowed to miss the compositor, used by @ref U_PA_MODE_PERCENTILE.
+	double miss_target;
+
 	struct u_pa_frame frames[FRAME_COUNT];
 	uint32_t current_frame;
 	uint32_t next_frame;
@@ -148,6 +187,54 @@ struct pacing_app
 		int64_t gpu_time_ns;
 	} app; //!< App statistics.
 
+	struct
+	{
+		struct u_pa_window cpu;
+		struct u_pa_window draw;
+		struct u_pa_window gpu;
+
+		//! From when the app should have woken up to its GPU work completing.
+		struct u_pa_window total;
+
+		//! If the frame missed the compositor, same index as the total samples.
+		bool missed[PERCENTILE_WINDOW];
+
+		struct u_pa_percentiles cpu_ns;
+		struct u_pa_percentiles draw_ns;
+		struct u_pa_percentiles gpu_ns;
+		struct u_pa_percentiles total_ns;
+
+		//! Total time at the miss target, the app time plus this is the margin.
+		int64_t target_ns;
+
+		//! Fraction of the frames in the window that missed the compositor.
+		float miss_rate;
+	} percentile; //!< Latest frames, tracked in all modes but only used by @ref U_PA_MODE_PERCENTILE.
+
+	struct
+	{
+		uint64_t delivered_count;
+		uint64_t discarded_count;
+		uint64_t missed_count;
+
+		//! Filtered time between delivered frames.
+		int64_t frame_period_ns;
+		//! Filtered time between latching a frame and its display time.
+		int64_t latch_to_display_ns;
+
+		//! When the last frame was delivered.
+		int64_t last_delivered_ns;
+		//! Only the first latching of a frame is counted.
+		int64_t last_latched_frame_id;
+
+		//! Display times of delivered frames, frames are reset before they are latched.
+		struct
+		{
+			int64_t frame_id;
+			int64_t display_time_ns;
+		} delivered[FRAME_COUNT];
+	} stats; //!< Running statistics, see @ref u_pacing_app_stats.
+
 	struct
 	{
 		//! The last display time that the thing driving this helper got.
@@ -196,6 +283,8 @@ point_to_str(enum u_timing_point point)
 	case U_TIMING_POINT_BEGIN: return "U_TIMING_POINT_BEGIN";
 	case U_TIMING_POINT_SUBMIT_BEGIN: return "U_TIMING_POINT_SUBMIT_BEGIN";
 	case U_TIMING_POINT_SUBMIT_END: return "U_TIMING_POINT_SUBMIT_END";
+	case U_TIMING_POINT_SQUASH_SUBMIT_END: return "U_TIMING_POINT_SQUASH_SUBMIT_END";
+	case U_TIMING_POINT_LATE_WARP_WAKE_UP: return "U_TIMING_POINT_LATE_WARP_WAKE_UP";
 	default: return "UNKNOWN";
 	}
 }
@@ -220,6 +309,112 @@ do_iir_filter(int64_t *target, double alpha_lt, double alpha_gt, int64_t sample)
 	*target = time_s_to_ns(a + b);
 }
 
+static void
+do_iir_filter_or_set(int64_t *target, int64_t sample)
+{
+	if (*target == 0) {
+		*target = sample;
+	} else {
+		do_iir_filter(target, IIR_ALPHA_LT, IIR_ALPHA_GT, sample);
+	}
+}
+
+static void
+window_push(struct u_pa_window *w, int64_t sample)
+{
+	w->samples[w->next] = sample;
+	w->next = (w->next + 1) % PERCENTILE_WINDOW;
+
+	if (w->count < PERCENTILE_WINDOW) {
+		w->count++;
+	}
+}
+
+static int
+compare_i64(const void *a, const void *b)
+{
+	int64_t x = *(const int64_t *)a;
+	int64_t y = *(const int64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+//! Sorts a copy of the samples into @p sorted, returns how many there are.
+static uint32_t
+window_sort(const struct u_pa_window *w, int64_t sorted[PERCENTILE_WINDOW])
+{
+	// Samples are only overwritten once the window is full.
+	memcpy(sorted, w->samples, sizeof(int64_t) * w->count);
+	qsort(sorted, w->count, sizeof(int64_t), compare_i64);
+
+	return w->count;
+}
+
+//! Nearest rank percentile, the smallest sample that at least @p q of the samples are below or equal to.
+static int64_t
+sorted_quantile(const int64_t *sorted, uint32_t count, double q)
+{
+	if (count == 0) {
+		return 0;
+	}
+
+	// Ceil of the rank, minus one for the index.
+	double rank = q * (double)count;
+	uint32_t index = (uint32_t)rank;
+	if ((double)index == rank && index > 0) {
+		index--;
+	}
+	if (index >= count) {
+		index = count - 1;
+	}
+
+	return sorted[index];
+}
+
+static void
+window_percentiles(const struct u_pa_window *w, struct u_pa_percentiles *out_p, int64_t sorted[PERCENTILE_WINDOW])
+{
+	uint32_t count = window_sort(w, sorted);
+
+	out_p->p50_ns = sorted_quantile(sorted, count, 0.50);
+	out_p->p95_ns = sorted_quantile(sorted, count, 0.95);
+	out_p->p99_ns = sorted_quantile(sorted, count, 0.99);
+}
+
+static void
+update_percentiles(struct pacing_app *pa)
+{
+	int64_t sorted[PERCENTILE_WINDOW];
+
+	window_percentiles(&pa->percentile.cpu, &pa->percentile.cpu_ns, sorted);
+	window_percentiles(&pa->percentile.draw, &pa->percentile.draw_ns, sorted);
+	window_percentiles(&pa->percentile.gpu, &pa->percentile.gpu_ns, sorted);
+
+	// Last so sorted holds the total samples.
+	window_percentiles(&pa->percentile.total, &pa->percentile.total_ns, sorted);
+
+	/*
+	 * The next frame is slower than the k:th slowest of n frames with a
+	 * chance of k / (n + 1), pick the rank from that rather than from the
+	 * percentile of the window, which would miss too often on small windows.
+	 */
+	uint32_t count = pa->percentile.total.count;
+	double q = (1.0 - pa->miss_target) * (double)(count + 1) / (double)count;
+	pa->percentile.target_ns = sorted_quantile(sorted, count, q);
+
+	uint32_t missed = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		missed += pa->percentile.missed[i] ? 1 : 0;
+	}
+	pa->percentile.miss_rate = (float)missed / (float)count;
+}
+
+static bool
+use_percentiles(const struct pacing_app *pa)
+{
+	return pa->mode == U_PA_MODE_PERCENTILE && pa->percentile.total.count >= PERCENTILE_MIN_SAMPLES;
+}
+
 static int64_t
 min_period(const struct pacing_app *pa)
 {
@@ -235,7 +430,17 @@ min_app_time(const struct pacing_app *pa)
 static int64_t
 margin_time(const struct pacing_app *pa)
 {
-	return (int64_t)(pa->min_margin_ms.val * (double)U_TIME_1MS_IN_NS);
+	int64_t min_ns = (int64_t)(pa->min_margin_ms.val * (double)U_TIME_1MS_IN_NS);
+
+	// Enough to cover all but the miss target of the frames.
+	if (use_percentiles(pa)) {
+		int64_t margin_ns = pa->percentile.target_ns - pa->percentile.total_ns.p50_ns;
+		if (margin_ns > min_ns) {
+			return margin_ns;
+		}
+	}
+
+	return min_ns;
 }
 
 static int64_t
@@ -256,6 +461,11 @@ total_app_time_ns(const struct pacing_app *pa)
 	int64_t total_ns = pa->app.cpu_time_ns + pa->app.draw_time_ns + pa->app.gpu_time_ns;
 	int64_t min_ns = min_app_time(pa);
 
+	// The median, slower frames are covered by the margin.
+	if (use_percentiles(pa)) {
+		total_ns = pa->percentile.total_ns.p50_ns;
+	}
+
 	if (total_ns < min_ns) {
 		total_ns = min_ns;
 	}
@@ -361,6 +571,29 @@ do_metrics(struct pacing_app *pa, struct u_pa_frame *f, bool discarded)
 	u_metrics_write_session_frame(&umsf);
 }
 
+static void
+do_pacing_metrics(struct pacing_app *pa, struct u_pa_frame *f)
+{
+	if (!u_metrics_is_active()) {
+		return;
+	}
+
+	struct u_metrics_session_pacing umsp = {
+	    .session_id = pa->session_id,
+	    .frame_id = f->frame_id,
+	    .percentile = use_percentiles(pa),
+	    .predicted_wake_up_time_ns = f->predicted_wake_up_time_ns,
+	    .predicted_display_time_ns = f->predicted_display_time_ns,
+	    .app_time_ns = total_app_time_ns(pa),
+	    .margin_ns = margin_time(pa),
+	    .compositor_time_ns = pa->last_input.extra_ns,
+	    .miss_target = (float)pa->miss_target,
+	    .miss_rate = pa->percentile.miss_rate,
+	};
+
+	u_metrics_write_session_pacing(&umsp);
+}
+
 static void
 do_tracing(struct pacing_app *pa, struct u_pa_frame *f)
 {
@@ -500,8 +733,11 @@ pa_predict(struct u_pacing_app *upa,
 	f->predicted_display_period_ns = period_ns;
 	f->when.predicted_ns = now_ns;
 
+	do_pacing_metrics(pa, f);
+
 #ifdef U_TRACE_TRACY // Uses Tracy specific things.
 	TracyCPlot("App time(ms)", time_ns_to_ms_f(total_app_time_ns(pa)));
+	TracyCPlot("App margin(ms)", time_ns_to_ms_f(margin_time(pa)));
 #endif
 }
 
@@ -517,6 +753,8 @@ pa_mark_point(struct u_pacing_app *upa, int64_t frame_id, enum u_timing_point po
 
 	assert(f->frame_id == frame_id);
 
+	u_fr_record(U_FR_EVENT_APP_POINT, frame_id, when_ns, pa->session_id, point);
+
 	switch (point) {
 	case U_TIMING_POINT_WAKE_UP:
 		assert(f->state == U_RT_PREDICTED);
@@ -552,6 +790,8 @@ pa_mark_discarded(struct u_pacing_app *upa, int64_t frame_id, int64_t when_ns)
 	// Update all data.
 	f->when.delivered_ns = when_ns;
 
+	pa->stats.discarded_count++;
+
 	// Write out metrics data.
 	do_metrics(pa, f, true);
 
@@ -578,6 +818,15 @@ pa_mark_delivered(struct u_pacing_app *upa, int64_t frame_id, int64_t when_ns, i
 	f->when.delivered_ns = when_ns;
 	f->display_time_ns = display_time_ns;
 	f->state = U_RT_DELIVERED;
+
+	u_fr_record(U_FR_EVENT_APP_DELIVERED, frame_id, when_ns, pa->session_id, 0);
+
+	if (pa->stats.last_delivered_ns != 0) {
+		do_iir_filter_or_set(&pa->stats.frame_period_ns, when_ns - pa->stats.last_delivered_ns);
+	}
+	pa->stats.last_delivered_ns = when_ns;
+	pa->stats.delivered[index].frame_id = frame_id;
+	pa->stats.delivered[index].display_time_ns = display_time_ns;
 }
 
 static void
@@ -597,6 +846,13 @@ pa_mark_gpu_done(struct u_pacing_app *upa, int64_t frame_id, int64_t when_ns)
 	f->when.gpu_done_ns = when_ns;
 	f->state = U_RT_GPU_DONE;
 
+	u_fr_record(U_FR_EVENT_APP_GPU_DONE, frame_id, when_ns, pa->session_id, 0);
+	pa->stats.delivered_count++;
+	if (when_ns > f->display_time_ns) {
+		u_fr_app_miss(pa->session_id, frame_id, when_ns, when_ns - f->display_time_ns);
+		pa->stats.missed_count++;
+	}
+
 
 	/*
 	 * Process data.
@@ -629,6 +885,22 @@ pa_mark_gpu_done(struct u_pacing_app *upa, int64_t frame_id, int64_t when_ns)
 	do_iir_filter(&pa->app.draw_time_ns, IIR_ALPHA_LT, IIR_ALPHA_GT, diff_draw_ns);
 	do_iir_filter(&pa->app.gpu_time_ns, IIR_ALPHA_LT, IIR_ALPHA_GT, diff_gpu_ns);
 
+	// Waking up late counts against the frame as much as being slow does.
+	int64_t wake_late_ns = f->when.wait_woke_ns - f->predicted_wake_up_time_ns;
+	if (wake_late_ns < 0) {
+		wake_late_ns = 0;
+	}
+
+	// The compositor needs the frame before the display time.
+	bool missed_compositor = when_ns > f->display_time_ns - pa->last_input.extra_ns;
+
+	pa->percentile.missed[pa->percentile.total.next] = missed_compositor;
+	window_push(&pa->percentile.cpu, diff_cpu_ns);
+	window_push(&pa->percentile.draw, diff_draw_ns);
+	window_push(&pa->percentile.gpu, diff_gpu_ns);
+	window_push(&pa->percentile.total, wake_late_ns + diff_cpu_ns + diff_draw_ns + diff_gpu_ns);
+	update_percentiles(pa);
+
 	// Write out metrics and tracing data.
 	do_metrics(pa, f, false);
 	do_tracing(pa, f);
@@ -655,6 +927,13 @@ pa_latched(struct u_pacing_app *upa, int64_t frame_id, int64_t when_ns, int64_t
 	(void)pa;
 #endif
 
+	size_t stats_index = GET_INDEX_FROM_ID(pa, frame_id);
+	if (frame_id != pa->stats.last_latched_frame_id && pa->stats.delivered[stats_index].frame_id == frame_id) {
+		int64_t display_time_ns = pa->stats.delivered[stats_index].display_time_ns;
+		do_iir_filter_or_set(&pa->stats.latch_to_display_ns, display_time_ns - when_ns);
+		pa->stats.last_latched_frame_id = frame_id;
+	}
+
 	struct u_metrics_used umu = {
 	    .session_id = pa->session_id,
 	    .session_frame_id = frame_id,
@@ -698,6 +977,23 @@ pa_info(struct u_pacing_app *upa,
 	pa->last_input.extra_ns = extra_ns;
 }
 
+static void
+pa_get_stats(struct u_pacing_app *upa, struct u_pacing_app_stats *out_stats)
+{
+	struct pacing_app *pa = pacing_app(upa);
+
+	*out_stats = (struct u_pacing_app_stats){
+	    .delivered_count = pa->stats.delivered_count,
+	    .discarded_count = pa->stats.discarded_count,
+	    .missed_count = pa->stats.missed_count,
+	    .frame_period_ns = pa->stats.frame_period_ns,
+	    .cpu_time_ns = pa->app.cpu_time_ns,
+	    .draw_time_ns = pa->app.draw_time_ns,
+	    .gpu_time_ns = pa->app.gpu_time_ns,
+	    .latch_to_display_ns = pa->stats.latch_to_display_ns,
+	};
+}
+
 static void
 pa_destroy(struct u_pacing_app *upa)
 {
@@ -707,7 +1003,7 @@ pa_destroy(struct u_pacing_app *upa)
 }
 
 static xrt_result_t
-pa_create(int64_t session_id, struct u_pacing_app **out_upa)
+pa_create(int64_t session_id, const struct u_pa_config *config, struct u_pacing_app **out_upa)
 {
 	struct pacing_app *pa = U_TYPED_CALLOC(struct pacing_app);
 	pa->base.predict = pa_predict;
@@ -718,20 +1014,23 @@ pa_create(int64_t session_id, struct u_pacing_app **out_upa)
 	pa->base.latched = pa_latched;
 	pa->base.retired = pa_retired;
 	pa->base.info = pa_info;
+	pa->base.get_stats = pa_get_stats;
 	pa->base.destroy = pa_destroy;
 	pa->session_id = session_id;
+	pa->mode = config->mode;
+	pa->miss_target = config->miss_target_percentage / 100.0;
 	pa->app.cpu_time_ns = U_TIME_1MS_IN_NS * 2;
 	pa->app.draw_time_ns = U_TIME_1MS_IN_NS * 2;
 
 	pa->min_margin_ms = (struct u_var_draggable_f32){
-	    .val = debug_get_float_option_min_margin_ms(),
-	    .min = 1.0, // This can never be negative.
+	    .val = config->min_margin_ms,
+	    .min = 0.0, // This can never be negative.
 	    .step = 1.0,
 	    .max = +120.0, // There are some really slow applications out there.
 	};
 
 	pa->min_app_time_ms = (struct u_var_draggable_f32){
-	    .val = (float)debug_get_float_option_min_app_time_ms(),
+	    .val = config->min_app_time_ms,
 	    .min = 1.0, // This can never be negative.
 	    .step = 1.0,
 	    .max = +120.0, // There are some really slow applications out there.
@@ -742,6 +1041,11 @@ pa_create(int64_t session_id, struct u_pacing_app **out_upa)
 		pa->frames[i].frame_id = -1;
 	}
 
+	pa->stats.last_latched_frame_id = -1;
+	for (size_t i = 0; i < ARRAY_SIZE(pa->stats.delivered); i++) {
+		pa->stats.delivered[i].frame_id = -1;
+	}
+
 	// U variable tracking.
 	u_var_add_root(pa, "App timing info", true);
 	u_var_add_draggable_f32(pa, &pa->min_margin_ms, "Minimum margin(ms)");
@@ -749,6 +1053,21 @@ pa_create(int64_t session_id, struct u_pacing_app **out_upa)
 	u_var_add_ro_i64(pa, &pa->app.cpu_time_ns, "CPU time(ns)");
 	u_var_add_ro_i64(pa, &pa->app.draw_time_ns, "Draw time(ns)");
 	u_var_add_ro_i64(pa, &pa->app.gpu_time_ns, "GPU time(ns)");
+	u_var_add_gui_header(pa, NULL, "Percentiles");
+	u_var_add_ro_i64(pa, &pa->percentile.cpu_ns.p50_ns, "CPU p50(ns)");
+	u_var_add_ro_i64(pa, &pa->percentile.cpu_ns.p95_ns, "CPU p95(ns)");
+	u_var_add_ro_i64(pa, &pa->percentile.cpu_ns.p99_ns, "CPU p99(ns)");
+	u_var_add_ro_i64(pa, &pa->percentile.draw_ns.p50_ns, "Draw p50(ns)");
+	u_var_add_ro_i64(pa, &pa->percentile.draw_ns.p95_ns, "Draw p95(ns)");
+	u_var_add_ro_i64(pa, &pa->percentile.draw_ns.p99_ns, "Draw p99(ns)");
+	u_var_add_ro_i64(pa, &pa->percentile.gpu_ns.p50_ns, "GPU p50(ns)");
+	u_var_add_ro_i64(pa, &pa->percentile.gpu_ns.p95_ns, "GPU p95(ns)");
+	u_var_add_ro_i64(pa, &pa->percentile.gpu_ns.p99_ns, "GPU p99(ns)");
+	u_var_add_ro_i64(pa, &pa->percentile.total_ns.p50_ns, "Total p50(ns)");
+	u_var_add_ro_i64(pa, &pa->percentile.total_ns.p95_ns, "Total p95(ns)");
+	u_var_add_ro_i64(pa, &pa->percentile.total_ns.p99_ns, "Total p99(ns)");
+	u_var_add_ro_i64(pa, &pa->percentile.target_ns, "Total at miss target(ns)");
+	u_var_add_ro_f32(pa, &pa->percentile.miss_rate, "Miss rate");
 
 	*out_upa = &pa->base;
 
@@ -762,12 +1081,21 @@ pa_create(int64_t session_id, struct u_pacing_app **out_upa)
  *
  */
 
+struct pacing_app_factory
+{
+	struct u_pacing_app_factory base;
+
+	//! Given to all created app pacers.
+	struct u_pa_config config;
+};
+
 static xrt_result_t
 paf_create(struct u_pacing_app_factory *upaf, struct u_pacing_app **out_upa)
 {
+	struct pacing_app_factory *paf = (struct pacing_app_factory *)upaf;
 	static int64_t session_id_gen = 0; // For now until global session id is introduced.
 
-	return pa_create(session_id_gen++, out_upa);
+	return pa_create(session_id_gen++, &paf->config, out_upa);
 }
 
 static void
@@ -783,14 +1111,39 @@ paf_destroy(struct u_pacing_app_factory *upaf)
  *
  */
 
+const struct u_pa_config U_PA_CONFIG_DEFAULT = {
+    .mode = U_PA_MODE_IIR,
+    .min_app_time_ms = 1.0f,
+    .min_margin_ms = 2.0f,
+    .miss_target_percentage = 1.0f,
+};
+
 xrt_result_t
 u_pa_factory_create(struct u_pacing_app_factory **out_upaf)
 {
-	struct u_pacing_app_factory *upaf = U_TYPED_CALLOC(struct u_pacing_app_factory);
-	upaf->create = paf_create;
-	upaf->destroy = paf_destroy;
+	struct u_pa_config config = U_PA_CONFIG_DEFAULT;
+	config.min_app_time_ms = debug_get_float_option_min_app_time_ms();
+	config.min_margin_ms = debug_get_float_option_min_margin_ms();
+	config.miss_target_percentage = debug_get_float_option_miss_target_percentage();
+
+	// The margin adapts to the app, so it only needs to cover waking up.
+	if (debug_get_bool_option_percentile()) {
+		config.mode = U_PA_MODE_PERCENTILE;
+		config.min_margin_ms = debug_get_float_option_percentile_min_margin_ms();
+	}
+
+	return u_pa_factory_create_with_config(&config, out_upaf);
+}
+
+xrt_result_t
+u_pa_factory_create_with_config(const struct u_pa_config *config, struct u_pacing_app_factory **out_upaf)
+{
+	struct pacing_app_factory *paf = U_TYPED_CALLOC(struct pacing_app_factory);
+	paf->base.create = paf_create;
+	paf->base.destroy = paf_destroy;
+	paf->config = *config;
 
-	*out_upaf = upaf;
+	*out_upaf = &paf->base;
 
 	return XRT_SUCCESS;
 }
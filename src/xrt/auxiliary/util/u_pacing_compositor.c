@@ -14,10 +14,13 @@
 #include "util/u_debug.h"
 #include "util/u_pacing.h"
 #include "util/u_metrics.h"
+#include "util/u_flight_recorder.h"
 #include "util/u_logging.h"
 #include "util/u_trace_marker.h"
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
 DEBUG_GET_ONCE_LOG_OPTION(log_level, "U_PACING_COMPOSITOR_LOG", U_LOGGING_WARN)
@@ -32,6 +35,30 @@ DEBUG_GET_ONCE_LOG_OPTION(log_level, "U_PACING_COMPOSITOR_LOG", U_LOGGING_WARN)
 
 #define PRESENT_SLOP_NS (U_TIME_HALF_MS_IN_NS)
 
+//! How much of a new sample goes into the process wide GPU time.
+#define GPU_TIME_ALPHA (0.1)
+
+//! How many of the latest vblanks the period and phase are fitted to.
+#define MODEL_VBLANK_COUNT (32)
+
+//! Vblanks needed before the fit is used.
+#define MODEL_MIN_VBLANKS (8)
+
+//! How many of the latest frames the compositor times are taken over.
+#define MODEL_TIME_COUNT (64)
+
+//! Frames needed before the compositor times are used.
+#define MODEL_MIN_TIMES (16)
+
+//! Smallest margin when using the model, however steady the vblanks are.
+#define MODEL_MIN_MARGIN_NS (U_TIME_1MS_IN_NS / 4)
+
+/*!
+ * Process wide filtered compositor GPU time, only written from the compositor
+ * thread, other threads just read the latest value.
+ */
+static volatile int64_t g_gpu_time_ns;
+
 
 /*
  *
@@ -71,6 +98,12 @@ struct frame
 	//! When the compositor finished rendering a frame
 	int64_t when_submitted_ns;
 
+	//! When the layer squashing was submitted, zero if not warping late.
+	int64_t when_squash_submitted_ns;
+
+	//! When the late warp woke up, zero if not warping late.
+	int64_t when_late_warp_woke_ns;
+
 	//! When new frame timing info was last added.
 	int64_t when_infoed_ns;
 
@@ -134,10 +167,58 @@ struct pacing_compositor
 	 */
 	int64_t margin_ns;
 
+	/*!
+	 * The amount of time the late warp needs, from waking up until its GPU
+	 * work is done, only used when the compositor warps late.
+	 */
+	int64_t late_warp_time_ns;
+
 	/*!
 	 * Frame store.
 	 */
 	struct frame frames[NUM_FRAMES];
+
+	/*!
+	 * Fitted model of the display and the compositor, see
+	 * @ref u_pc_display_timing_config::fit_model.
+	 */
+	struct
+	{
+		bool enabled;
+
+		//! Fraction of frames allowed to miss their present.
+		double miss_target;
+
+		//! Latest vblanks, from present feedback and display control.
+		int64_t vblanks_ns[MODEL_VBLANK_COUNT];
+		uint32_t vblank_next;
+		uint32_t vblank_count;
+
+		//! Has the fit enough vblanks to be used.
+		bool fitted;
+
+		//! Fitted, vblanks happen at phase_ns plus a whole number of period_ns.
+		int64_t phase_ns;
+		double period_ns;
+
+		//! Robust standard deviation of the vblanks around the fit.
+		int64_t jitter_ns;
+
+		//! From waking up to submitting, to the GPU being done, and the whole frame from the predicted wake up.
+		int64_t cpu_ns[MODEL_TIME_COUNT];
+		int64_t gpu_ns[MODEL_TIME_COUNT];
+		int64_t total_ns[MODEL_TIME_COUNT];
+		uint32_t time_next;
+		uint32_t time_count;
+
+		int64_t cpu_p50_ns;
+		int64_t cpu_p99_ns;
+		int64_t gpu_p50_ns;
+		int64_t gpu_p99_ns;
+
+		//! Whole frame time at the miss target, what the compositor is given.
+		int64_t total_target_ns;
+	} model;
 };
 
 
@@ -166,10 +247,32 @@ get_percent_of_time(int64_t time_ns, uint32_t fraction_percent)
 	return time_s_to_ns(time_ns_to_s(time_ns) * fraction);
 }
 
+static bool
+use_model(struct pacing_compositor *pc)
+{
+	return pc->model.enabled && pc->model.fitted && pc->model.time_count >= MODEL_MIN_TIMES;
+}
+
+static int64_t
+calc_margin(struct pacing_compositor *pc)
+{
+	if (!use_model(pc)) {
+		return pc->margin_ns;
+	}
+
+	// The frame times are already covered, only the vblanks can surprise us.
+	int64_t margin_ns = pc->model.jitter_ns * 3;
+	if (margin_ns < MODEL_MIN_MARGIN_NS) {
+		margin_ns = MODEL_MIN_MARGIN_NS;
+	}
+
+	return margin_ns;
+}
+
 static int64_t
 calc_total_comp_time(struct pacing_compositor *pc)
 {
-	return pc->comp_time_ns + pc->margin_ns;
+	return pc->comp_time_ns + calc_margin(pc);
 }
 
 static int64_t
@@ -191,6 +294,229 @@ is_within_half_ms(int64_t l, int64_t r)
 	return is_within_of_each_other(l, r, U_TIME_HALF_MS_IN_NS);
 }
 
+static int64_t
+round_to_i64(double value)
+{
+	return (int64_t)(value < 0.0 ? value - 0.5 : value + 0.5);
+}
+
+static int
+compare_i64(const void *a, const void *b)
+{
+	int64_t x = *(const int64_t *)a;
+	int64_t y = *(const int64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+static int
+compare_double(const void *a, const void *b)
+{
+	double x = *(const double *)a;
+	double y = *(const double *)b;
+
+	return (x > y) - (x < y);
+}
+
+static double
+median_of_doubles(double *values, uint32_t count)
+{
+	qsort(values, count, sizeof(double), compare_double);
+
+	if (count % 2 == 0) {
+		return (values[count / 2 - 1] + values[count / 2]) / 2.0;
+	}
+
+	return values[count / 2];
+}
+
+//! Nearest rank percentile of @p count samples, sorts @p samples.
+static int64_t
+quantile_of_samples(int64_t *samples, uint32_t count, double q)
+{
+	qsort(samples, count, sizeof(int64_t), compare_i64);
+
+	double rank = q * (double)count;
+	uint32_t index = (uint32_t)rank;
+	if ((double)index == rank && index > 0) {
+		index--;
+	}
+	if (index >= count) {
+		index = count - 1;
+	}
+
+	return samples[index];
+}
+
+//! The first fitted vblank at or after @p time_ns.
+static int64_t
+model_next_vblank(struct pacing_compositor *pc, int64_t time_ns)
+{
+	double periods = (double)(time_ns - pc->model.phase_ns) / pc->model.period_ns;
+	int64_t k = (int64_t)periods;
+	if ((double)k < periods) {
+		k++;
+	}
+
+	int64_t vblank_ns = pc->model.phase_ns + round_to_i64((double)k * pc->model.period_ns);
+
+	// Rounding of the period.
+	if (vblank_ns < time_ns) {
+		vblank_ns = pc->model.phase_ns + round_to_i64((double)(k + 1) * pc->model.period_ns);
+	}
+
+	return vblank_ns;
+}
+
+static void
+model_reset_vblanks(struct pacing_compositor *pc)
+{
+	pc->model.vblank_next = 0;
+	pc->model.vblank_count = 0;
+	pc->model.fitted = false;
+	pc->model.period_ns = (double)pc->frame_period_ns;
+}
+
+/*!
+ * Fits the period and phase with a Theil-Sen estimator, the median of the
+ * slopes between all pairs of vblanks, so a few late or dropped vblank
+ * reports don't pull the fit like they would a least squares one.
+ */
+static void
+model_fit_vblanks(struct pacing_compositor *pc)
+{
+	uint32_t count = pc->model.vblank_count;
+	if (count < 2) {
+		return;
+	}
+
+	// Number the vblanks by whole periods from the newest.
+	uint32_t newest = (pc->model.vblank_next + MODEL_VBLANK_COUNT - 1) % MODEL_VBLANK_COUNT;
+	int64_t reference_ns = pc->model.vblanks_ns[newest];
+
+	double offsets[MODEL_VBLANK_COUNT];
+	int64_t periods[MODEL_VBLANK_COUNT];
+	for (uint32_t i = 0; i < count; i++) {
+		offsets[i] = (double)(pc->model.vblanks_ns[i] - reference_ns);
+		periods[i] = round_to_i64(offsets[i] / pc->model.period_ns);
+	}
+
+	double slopes[MODEL_VBLANK_COUNT * (MODEL_VBLANK_COUNT - 1) / 2];
+	uint32_t slope_count = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		for (uint32_t k = i + 1; k < count; k++) {
+			if (periods[i] == periods[k]) {
+				continue;
+			}
+			slopes[slope_count++] = (offsets[k] - offsets[i]) / (double)(periods[k] - periods[i]);
+		}
+	}
+
+	if (slope_count == 0) {
+		return;
+	}
+
+	double period_ns = median_of_doubles(slopes, slope_count);
+
+	// Median of where each vblank puts the phase, and how far they are from it.
+	double phases[MODEL_VBLANK_COUNT];
+	for (uint32_t i = 0; i < count; i++) {
+		phases[i] = offsets[i] - (double)periods[i] * period_ns;
+	}
+	double phase = median_of_doubles(phases, count);
+
+	double deviations[MODEL_VBLANK_COUNT];
+	for (uint32_t i = 0; i < count; i++) {
+		double d = offsets[i] - (double)periods[i] * period_ns - phase;
+		deviations[i] = d < 0.0 ? -d : d;
+	}
+	double median_deviation = median_of_doubles(deviations, count);
+
+	pc->model.period_ns = period_ns;
+	pc->model.phase_ns = reference_ns + round_to_i64(phase);
+	// Scaled to a standard deviation for normally distributed jitter.
+	pc->model.jitter_ns = round_to_i64(median_deviation * 1.4826);
+	pc->model.fitted = count >= MODEL_MIN_VBLANKS;
+}
+
+static void
+model_add_vblank(struct pacing_compositor *pc, int64_t vblank_ns)
+{
+	int64_t quarter_ns = (int64_t)(pc->model.period_ns / 4.0);
+
+	// Far off the fit, the display mode has probably changed so start over.
+	if (pc->model.fitted) {
+		int64_t next_ns = model_next_vblank(pc, vblank_ns - quarter_ns);
+		int64_t error_ns = vblank_ns - next_ns;
+		if (error_ns < -quarter_ns || error_ns > quarter_ns) {
+			UPC_LOG_W("Vblank %.2fms off the fitted model, starting over.", ns_to_ms(error_ns));
+			model_reset_vblanks(pc);
+		}
+	}
+
+	// Present feedback and display control often report the same vblank.
+	for (uint32_t i = 0; i < pc->model.vblank_count; i++) {
+		if (is_within_of_each_other(pc->model.vblanks_ns[i], vblank_ns, quarter_ns)) {
+			return;
+		}
+	}
+
+	pc->model.vblanks_ns[pc->model.vblank_next] = vblank_ns;
+	pc->model.vblank_next = (pc->model.vblank_next + 1) % MODEL_VBLANK_COUNT;
+	if (pc->model.vblank_count < MODEL_VBLANK_COUNT) {
+		pc->model.vblank_count++;
+	}
+
+	model_fit_vblanks(pc);
+}
+
+static void
+model_add_frame(struct pacing_compositor *pc, struct frame *f)
+{
+	// When the GPU work was done, as far as the presentation engine is concerned.
+	int64_t ready_ns = f->earliest_present_time_ns - f->present_margin_ns;
+	if (ready_ns <= f->wake_up_time_ns || f->when_submitted_ns <= f->when_woke_ns) {
+		return;
+	}
+
+	int64_t cpu_ns = f->when_submitted_ns - f->when_woke_ns;
+	int64_t gpu_ns = ready_ns > f->when_submitted_ns ? ready_ns - f->when_submitted_ns : 0;
+	int64_t total_ns = ready_ns - f->wake_up_time_ns;
+
+	/*
+	 * The late warp sleeps until its own wake up, so the whole frame only
+	 * needs to cover the squashing and the time the late warp is given.
+	 */
+	if (f->when_late_warp_woke_ns != 0 && f->when_squash_submitted_ns > f->wake_up_time_ns) {
+		total_ns = f->when_squash_submitted_ns - f->wake_up_time_ns + pc->late_warp_time_ns;
+	}
+
+	uint32_t index = pc->model.time_next;
+	pc->model.cpu_ns[index] = cpu_ns;
+	pc->model.gpu_ns[index] = gpu_ns;
+	pc->model.total_ns[index] = total_ns;
+	pc->model.time_next = (index + 1) % MODEL_TIME_COUNT;
+	if (pc->model.time_count < MODEL_TIME_COUNT) {
+		pc->model.time_count++;
+	}
+
+	uint32_t count = pc->model.time_count;
+	int64_t sorted[MODEL_TIME_COUNT];
+
+	memcpy(sorted, pc->model.cpu_ns, sizeof(int64_t) * count);
+	pc->model.cpu_p50_ns = quantile_of_samples(sorted, count, 0.50);
+	pc->model.cpu_p99_ns = quantile_of_samples(sorted, count, 0.99);
+
+	memcpy(sorted, pc->model.gpu_ns, sizeof(int64_t) * count);
+	pc->model.gpu_p50_ns = quantile_of_samples(sorted, count, 0.50);
+	pc->model.gpu_p99_ns = quantile_of_samples(sorted, count, 0.99);
+
+	// The next frame is slower than the k:th slowest of n with a chance of k / (n + 1).
+	double q = (1.0 - pc->model.miss_target) * (double)(count + 1) / (double)count;
+	memcpy(sorted, pc->model.total_ns, sizeof(int64_t) * count);
+	pc->model.total_target_ns = quantile_of_samples(sorted, count, q);
+}
+
 /*!
  * Gets a frame data structure based on the @p frame_id.
  *
@@ -302,6 +628,29 @@ walk_forward_through_frames(struct pacing_compositor *pc, int64_t last_present_t
 	return f;
 }
 
+/*!
+ * Pick the latest fitted vblank that the compositor has time to render for,
+ * and that no earlier frame has been predicted for.
+ */
+static struct frame *
+walk_forward_through_model(struct pacing_compositor *pc, struct frame *last_predicted, int64_t now_ns)
+{
+	int64_t desired_present_time_ns = model_next_vblank(pc, now_ns + calc_total_comp_time(pc) + 1);
+
+	if (last_predicted != NULL) {
+		int64_t after_last_ns = last_predicted->desired_present_time_ns + (int64_t)(pc->model.period_ns / 2.0);
+		if (desired_present_time_ns < after_last_ns) {
+			desired_present_time_ns = model_next_vblank(pc, after_last_ns);
+		}
+	}
+
+	struct frame *f = create_frame(pc, STATE_PREDICTED);
+	f->when_predict_ns = now_ns;
+	f->desired_present_time_ns = desired_present_time_ns;
+
+	return f;
+}
+
 static struct frame *
 predict_next_frame(struct pacing_compositor *pc, int64_t now_ns)
 {
@@ -309,7 +658,9 @@ predict_next_frame(struct pacing_compositor *pc, int64_t now_ns)
 	// Last earliest display time, can be zero.
 	struct frame *last_predicted = get_latest_frame_with_state_at_least(pc, STATE_PREDICTED);
 	struct frame *last_completed = get_latest_frame_with_state_at_least(pc, STATE_INFO);
-	if (last_predicted == NULL && last_completed == NULL) {
+	if (use_model(pc)) {
+		f = walk_forward_through_model(pc, last_predicted, now_ns);
+	} else if (last_predicted == NULL && last_completed == NULL) {
 		f = do_clean_slate_frame(pc, now_ns);
 	} else if (last_completed == last_predicted) {
 		// Very high probability that we missed a frame.
@@ -349,26 +700,61 @@ predict_next_frame(struct pacing_compositor *pc, int64_t now_ns)
 	f->predicted_display_time_ns = calc_display_time_from_present_time(pc, f->desired_present_time_ns);
 	f->wake_up_time_ns = f->desired_present_time_ns - calc_total_comp_time(pc);
 	f->current_comp_time_ns = pc->comp_time_ns;
+	f->when_squash_submitted_ns = 0;
+	f->when_late_warp_woke_ns = 0;
 
 	return f;
 }
 
+static bool
+check_missed(struct pacing_compositor *pc, struct frame *f)
+{
+	if (f->actual_present_time_ns <= f->desired_present_time_ns ||
+	    is_within_half_ms(f->actual_present_time_ns, f->desired_present_time_ns)) {
+		return false;
+	}
+
+	double missed_ms = ns_to_ms(f->actual_present_time_ns - f->desired_present_time_ns);
+	UPC_LOG_W("Frame %" PRIu64 " missed by %.2f!", f->frame_id, missed_ms);
+	u_fr_comp_miss(f->frame_id, f->actual_present_time_ns, f->actual_present_time_ns - f->desired_present_time_ns);
+
+	return true;
+}
+
+static void
+adjust_comp_time_from_model(struct pacing_compositor *pc, struct frame *f)
+{
+	check_missed(pc, f);
+
+	// Misses are in the distribution, so no stepping back and forth.
+	int64_t comp_time_ns = pc->model.total_target_ns;
+	if (comp_time_ns > pc->comp_time_max_ns) {
+		comp_time_ns = pc->comp_time_max_ns;
+	}
+
+	pc->comp_time_ns = comp_time_ns;
+}
+
 static void
 adjust_comp_time(struct pacing_compositor *pc, struct frame *f)
 {
 	int64_t comp_time_ns = pc->comp_time_ns;
 
-	if (f->actual_present_time_ns > f->desired_present_time_ns &&
-	    !is_within_half_ms(f->actual_present_time_ns, f->desired_present_time_ns)) {
-		double missed_ms = ns_to_ms(f->actual_present_time_ns - f->desired_present_time_ns);
-		UPC_LOG_W("Frame %" PRIu64 " missed by %.2f!", f->frame_id, missed_ms);
-
+	if (check_missed(pc, f)) {
 		comp_time_ns += pc->adjust_missed_ns;
 		if (comp_time_ns > pc->comp_time_max_ns) {
 			comp_time_ns = pc->comp_time_max_ns;
 		}
 
 		pc->comp_time_ns = comp_time_ns;
+
+		// The late warp is what the present waited on, give it more time too.
+		if (f->when_late_warp_woke_ns != 0) {
+			pc->late_warp_time_ns += pc->adjust_missed_ns;
+			if (pc->late_warp_time_ns > pc->comp_time_ns) {
+				pc->late_warp_time_ns = pc->comp_time_ns;
+			}
+		}
 		return;
 	}
 
@@ -392,6 +778,30 @@ adjust_comp_time(struct pacing_compositor *pc, struct frame *f)
 	}
 }
 
+static void
+adjust_late_warp_time(struct pacing_compositor *pc, struct frame *f, int64_t gpu_end_ns)
+{
+	if (f->when_late_warp_woke_ns == 0 || gpu_end_ns <= f->when_late_warp_woke_ns) {
+		return;
+	}
+
+	// From waking up to the GPU being done, includes waiting on the squash.
+	int64_t needed_ns = gpu_end_ns - f->when_late_warp_woke_ns;
+
+	// Jump straight up as being late costs a frame, come back down slowly.
+	int64_t late_warp_time_ns = pc->late_warp_time_ns - pc->adjust_non_miss_ns;
+	if (late_warp_time_ns < needed_ns) {
+		late_warp_time_ns = needed_ns;
+	}
+
+	// Never earlier than the compositor itself wakes up.
+	if (late_warp_time_ns > pc->comp_time_ns) {
+		late_warp_time_ns = pc->comp_time_ns;
+	}
+
+	pc->late_warp_time_ns = late_warp_time_ns;
+}
+
 
 /*
  *
@@ -454,6 +864,11 @@ do_tracing(struct pacing_compositor *pc, struct frame *f)
 		TE_END(pc_cpu, f->when_woke_ns);
 	}
 
+	if (f->when_squash_submitted_ns != 0 && f->when_late_warp_woke_ns > f->when_squash_submitted_ns) {
+		TE_BEG(pc_cpu, f->when_squash_submitted_ns, "late-warp-sleep");
+		TE_END(pc_cpu, f->when_late_warp_woke_ns);
+	}
+
 
 	/*
 	 *
@@ -573,6 +988,12 @@ pc_predict(struct u_pacing_compositor *upc,
 	int64_t predicted_display_period_ns = pc->frame_period_ns;
 	int64_t min_display_period_ns = pc->frame_period_ns;
 
+	// The fitted period is closer than the one the display reports.
+	if (use_model(pc)) {
+		predicted_display_period_ns = round_to_i64(pc->model.period_ns);
+		min_display_period_ns = predicted_display_period_ns;
+	}
+
 	*out_frame_id = f->frame_id;
 	*out_wake_up_time_ns = wake_up_time_ns;
 	*out_desired_present_time_ns = desired_present_time_ns;
@@ -596,6 +1017,8 @@ pc_mark_point(struct u_pacing_compositor *upc, enum u_timing_point point, int64_
 		return;
 	}
 
+	u_fr_record(U_FR_EVENT_COMP_POINT, frame_id, when_ns, 0, point);
+
 	switch (point) {
 	case U_TIMING_POINT_WAKE_UP:
 		assert(f->state == STATE_PREDICTED);
@@ -615,10 +1038,39 @@ pc_mark_point(struct u_pacing_compositor *upc, enum u_timing_point point, int64_
 		f->state = STATE_SUBMITTED;
 		f->when_submitted_ns = when_ns;
 		break;
+	case U_TIMING_POINT_SQUASH_SUBMIT_END:
+		assert(f->state == STATE_BEGAN);
+		f->when_squash_submitted_ns = when_ns;
+		break;
+	case U_TIMING_POINT_LATE_WARP_WAKE_UP:
+		assert(f->state == STATE_BEGAN);
+		f->when_late_warp_woke_ns = when_ns;
+		break;
 	default: assert(false);
 	}
 }
 
+static void
+pc_predict_late_warp(struct u_pacing_compositor *upc, int64_t frame_id, int64_t *out_wake_up_time_ns)
+{
+	struct pacing_compositor *pc = pacing_compositor(upc);
+	struct frame *f = get_frame(pc, frame_id);
+	if (f->frame_id != frame_id) {
+		UPC_LOG_W("Late warp prediction for unknown or expired frame_id %" PRIx64, frame_id);
+		*out_wake_up_time_ns = 0;
+		return;
+	}
+
+	int64_t wake_up_time_ns = f->desired_present_time_ns - pc->late_warp_time_ns - calc_margin(pc);
+
+	// The compositor time may have grown since the frame was predicted.
+	if (wake_up_time_ns < f->wake_up_time_ns) {
+		wake_up_time_ns = f->wake_up_time_ns;
+	}
+
+	*out_wake_up_time_ns = wake_up_time_ns;
+}
+
 static void
 pc_info(struct u_pacing_compositor *upc,
         int64_t frame_id,
@@ -652,13 +1104,24 @@ pc_info(struct u_pacing_compositor *upc,
 	f->present_margin_ns = present_margin_ns;
 	f->state = STATE_INFO;
 
+	u_fr_record(U_FR_EVENT_COMP_PRESENT, frame_id, actual_present_time_ns, desired_present_time_ns, 0);
+
 	int64_t since_last_frame_ns = 0;
 	if (last != NULL) {
 		since_last_frame_ns = f->desired_present_time_ns - last->desired_present_time_ns;
 	}
 
+	if (pc->model.enabled) {
+		model_add_vblank(pc, actual_present_time_ns);
+		model_add_frame(pc, f);
+	}
+
 	// Adjust the frame timing.
-	adjust_comp_time(pc, f);
+	if (use_model(pc)) {
+		adjust_comp_time_from_model(pc, f);
+	} else {
+		adjust_comp_time(pc, f);
+	}
 
 	double present_margin_ms = ns_to_ms(present_margin_ns);
 	double since_last_frame_ms = ns_to_ms(since_last_frame_ns);
@@ -697,6 +1160,16 @@ static void
 pc_info_gpu(
     struct u_pacing_compositor *upc, int64_t frame_id, int64_t gpu_start_ns, int64_t gpu_end_ns, int64_t when_ns)
 {
+	struct pacing_compositor *pc = pacing_compositor(upc);
+
+	u_fr_record(U_FR_EVENT_COMP_GPU, frame_id, gpu_start_ns, gpu_end_ns, 0);
+	u_pc_record_gpu_time(gpu_start_ns, gpu_end_ns);
+
+	struct frame *f = get_frame(pc, frame_id);
+	if (f->frame_id == frame_id) {
+		adjust_late_warp_time(pc, f, gpu_end_ns);
+	}
+
 	if (u_metrics_is_active()) {
 		struct u_metrics_system_gpu_info umgi = {
 		    .frame_id = frame_id,
@@ -712,10 +1185,15 @@ pc_info_gpu(
 static void
 pc_update_vblank_from_display_control(struct u_pacing_compositor *upc, int64_t last_vblank_ns)
 {
+	struct pacing_compositor *pc = pacing_compositor(upc);
+
 	/*
-	 * This is a no-op, here in case display control is used at the
-	 * same time as the google extension. We ignore this call.
+	 * Here in case display control is used at the same time as the google
+	 * extension, only the model has any use for the extra vblanks.
 	 */
+	if (pc->model.enabled) {
+		model_add_vblank(pc, last_vblank_ns);
+	}
 }
 
 static void
@@ -747,6 +1225,10 @@ const struct u_pc_display_timing_config U_PC_DISPLAY_TIMING_CONFIG_DEFAULT = {
     .comp_time_max_fraction = 30,
     .adjust_missed_fraction = 4,
     .adjust_non_miss_fraction = 2,
+    // Start by assuming the late warp takes 5% of the frame.
+    .late_warp_time_fraction = 5,
+    .fit_model = false,
+    .miss_target_percentage = 1.0f,
 };
 
 xrt_result_t
@@ -757,6 +1239,7 @@ u_pc_display_timing_create(int64_t estimated_frame_period_ns,
 	struct pacing_compositor *pc = U_TYPED_CALLOC(struct pacing_compositor);
 	pc->base.predict = pc_predict;
 	pc->base.mark_point = pc_mark_point;
+	pc->base.predict_late_warp = pc_predict_late_warp;
 	pc->base.info = pc_info;
 	pc->base.info_gpu = pc_info_gpu;
 	pc->base.update_vblank_from_display_control = pc_update_vblank_from_display_control;
@@ -778,6 +1261,12 @@ u_pc_display_timing_create(int64_t estimated_frame_period_ns,
 	pc->adjust_non_miss_ns = get_percent_of_time(estimated_frame_period_ns, config->adjust_non_miss_fraction);
 	// Extra margin that is added to compositor time.
 	pc->margin_ns = config->margin_ns;
+	// Only used if the compositor warps late, measured from those frames.
+	pc->late_warp_time_ns = get_percent_of_time(estimated_frame_period_ns, config->late_warp_time_fraction);
+	// The model starts from the estimated period.
+	pc->model.enabled = config->fit_model;
+	pc->model.miss_target = config->miss_target_percentage / 100.0;
+	model_reset_vblanks(pc);
 
 	*out_upc = &pc->base;
 
@@ -786,3 +1275,25 @@ u_pc_display_timing_create(int64_t estimated_frame_period_ns,
 
 	return XRT_SUCCESS;
 }
+
+void
+u_pc_record_gpu_time(int64_t gpu_start_ns, int64_t gpu_end_ns)
+{
+	int64_t sample_ns = gpu_end_ns - gpu_start_ns;
+	if (sample_ns < 0) {
+		return;
+	}
+
+	int64_t old_ns = g_gpu_time_ns;
+	if (old_ns == 0) {
+		g_gpu_time_ns = sample_ns;
+	} else {
+		g_gpu_time_ns = old_ns + (int64_t)((double)(sample_ns - old_ns) * GPU_TIME_ALPHA);
+	}
+}
+
+int64_t
+u_pc_get_gpu_time_ns(void)
+{
+	return g_gpu_time_ns;
+}
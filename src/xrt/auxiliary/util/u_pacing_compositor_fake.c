@@ -15,6 +15,7 @@
 #include "util/u_debug.h"
 #include "util/u_pacing.h"
 #include "util/u_metrics.h"
+#include "util/u_flight_recorder.h"
 #include "util/u_logging.h"
 #include "util/u_live_stats.h"
 #include "util/u_trace_marker.h"
@@ -114,6 +115,9 @@ struct fake_timing
 	//! The amount of time that the application needs to render frame.
 	int64_t comp_time_ns;
 
+	//! The part of @ref comp_time_ns given to the late warp, if used.
+	int64_t late_warp_time_ns;
+
 	//! This won't run out, trust me.
 	int64_t frame_id_generator;
 
@@ -332,6 +336,8 @@ pc_mark_point(struct u_pacing_compositor *upc, enum u_timing_point point, int64_
 		return;
 	}
 
+	u_fr_record(U_FR_EVENT_COMP_POINT, frame_id, when_ns, 0, point);
+
 	// To help validate calling code.
 	switch (point) {
 	case U_TIMING_POINT_WAKE_UP: f->when_woke_ns = when_ns; break;
@@ -341,10 +347,28 @@ pc_mark_point(struct u_pacing_compositor *upc, enum u_timing_point point, int64_
 		f->when_submit_end_ns = when_ns;
 		calc_frame_stats(ft, f);
 		break;
+	case U_TIMING_POINT_SQUASH_SUBMIT_END:
+	case U_TIMING_POINT_LATE_WARP_WAKE_UP:
+		// Nothing to learn from these without feedback.
+		break;
 	default: assert(false);
 	}
 }
 
+static void
+pc_predict_late_warp(struct u_pacing_compositor *upc, int64_t frame_id, int64_t *out_wake_up_time_ns)
+{
+	struct fake_timing *ft = fake_timing(upc);
+	struct frame *f = get_frame_or_null(ft, frame_id);
+
+	if (f == NULL) {
+		*out_wake_up_time_ns = 0;
+		return;
+	}
+
+	*out_wake_up_time_ns = f->predicted_present_time_ns - ft->late_warp_time_ns;
+}
+
 static void
 pc_info(struct u_pacing_compositor *upc,
         int64_t frame_id,
@@ -366,9 +390,17 @@ pc_info_gpu(
 {
 	struct fake_timing *ft = fake_timing(upc);
 
+	u_fr_record(U_FR_EVENT_COMP_GPU, frame_id, gpu_start_ns, gpu_end_ns, 0);
+	u_pc_record_gpu_time(gpu_start_ns, gpu_end_ns);
+
 	struct frame *f = get_frame_or_null(ft, frame_id);
 	if (f != NULL) {
 		calc_gpu_stats(ft, f, gpu_start_ns, gpu_end_ns);
+
+		// No present feedback, finishing after the present is the best miss detection we have.
+		if (gpu_end_ns > f->predicted_present_time_ns) {
+			u_fr_comp_miss(frame_id, gpu_end_ns, gpu_end_ns - f->predicted_present_time_ns);
+		}
 	}
 
 	if (u_metrics_is_active()) {
@@ -446,6 +478,7 @@ u_pc_fake_create(int64_t estimated_frame_period_ns, int64_t now_ns, struct u_pac
 	struct fake_timing *ft = U_TYPED_CALLOC(struct fake_timing);
 	ft->base.predict = pc_predict;
 	ft->base.mark_point = pc_mark_point;
+	ft->base.predict_late_warp = pc_predict_late_warp;
 	ft->base.info = pc_info;
 	ft->base.info_gpu = pc_info_gpu;
 	ft->base.update_vblank_from_display_control = pc_update_vblank_from_display_control;
@@ -485,6 +518,9 @@ u_pc_fake_create(int64_t estimated_frame_period_ns, int64_t now_ns, struct u_pac
 		ft->comp_time_ns = min_comp_time_ns;
 	}
 
+	// No feedback, so the late warp gets a fixed half of the compositor time.
+	ft->late_warp_time_ns = ft->comp_time_ns / 2;
+
 	// Make the next present time be in the future.
 	ft->last_present_time_ns = now_ns + U_TIME_1MS_IN_NS * 50;
 
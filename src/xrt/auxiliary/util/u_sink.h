@@ -176,6 +176,72 @@ u_sink_force_genlock_create(struct xrt_frame_context *xfctx,
                             struct xrt_frame_sink **out_left_xfs,
                             struct xrt_frame_sink **out_right_xfs);
 
+/*!
+ * Statistics of a @ref u_sink_sync_create sink.
+ */
+struct u_sink_sync_stats
+{
+	//! Frame sets matched and queued for the consumer.
+	uint64_t sets;
+
+	//! Frames that were never part of a set.
+	uint64_t dropped_frames;
+
+	//! Matched sets dropped because the consumer fell behind.
+	uint64_t dropped_sets;
+
+	//! Skew of the last set, newest minus oldest frame timestamp.
+	int64_t last_skew_ns;
+
+	//! Largest skew seen.
+	int64_t max_skew_ns;
+
+	//! Mean skew of all sets.
+	double mean_skew_ns;
+};
+
+/*!
+ * Matches frames from @p frame_count cameras by timestamp and pushes each
+ * match as a @ref xrt_frame_set to @p downstream. A set is made when every
+ * camera has a frame within @p tolerance_ns of the others, frames that can
+ * never be matched are dropped. The frames are only referenced, never copied
+ * or changed; the set carries the common timestamp.
+ *
+ * Generalizes @ref u_sink_force_genlock_create to any number of cameras.
+ *
+ * @param      xfctx        Context for frame transport.
+ * @param      frame_count  Number of cameras, at most @ref XRT_FRAME_SET_MAX_FRAMES.
+ * @param      tolerance_ns Largest allowed timestamp difference within a set.
+ * @param      downstream   Receives the sets, on a thread of this sink.
+ * @param[out] out_xfss     Array of @p frame_count sinks, one per camera.
+ *
+ * @public @memberof xrt_frame_sink
+ * @see xrt_frame_context
+ */
+bool
+u_sink_sync_create(struct xrt_frame_context *xfctx,
+                   uint32_t frame_count,
+                   int64_t tolerance_ns,
+                   struct xrt_frame_set_sink *downstream,
+                   struct xrt_frame_sink **out_xfss);
+
+/*!
+ * Get the statistics of the sync sink that @p xfs is one of the inputs of.
+ */
+void
+u_sink_sync_get_stats(struct xrt_frame_sink *xfs, struct u_sink_sync_stats *out_stats);
+
+/*!
+ * @public @memberof xrt_frame_set_sink
+ * @see xrt_frame_context
+ * Takes a frame set and pushes it to two sinks
+ */
+void
+u_sink_frame_set_split_create(struct xrt_frame_context *xfctx,
+                              struct xrt_frame_set_sink *one,
+                              struct xrt_frame_set_sink *two,
+                              struct xrt_frame_set_sink **out_xfss);
+
 
 /*
  *
@@ -2,7 +2,7 @@
 // SPDX-License-Identifier: BSL-1.0
 /*!
  * @file
- * @brief  An @ref xrt_frame_sink splitter.
+ * @brief  An @ref xrt_frame_sink and @ref xrt_frame_set_sink splitter.
  * @author Jakob Bornecrantz <jakob@collabora.com>
  * @ingroup aux_util
  */
@@ -26,6 +26,20 @@ struct u_sink_split
 	struct xrt_frame_sink *right;
 };
 
+/*!
+ * An @ref xrt_frame_set_sink splitter.
+ * @implements xrt_frame_set_sink
+ * @implements xrt_frame_node
+ */
+struct u_sink_frame_set_split
+{
+	struct xrt_frame_set_sink base;
+	struct xrt_frame_node node;
+
+	struct xrt_frame_set_sink *one;
+	struct xrt_frame_set_sink *two;
+};
+
 static void
 split_frame(struct xrt_frame_sink *xfs, struct xrt_frame *xf)
 {
@@ -51,6 +65,25 @@ split_destroy(struct xrt_frame_node *node)
 	free(s);
 }
 
+static void
+split_frame_set(struct xrt_frame_set_sink *xfss, struct xrt_frame_set *set)
+{
+	SINK_TRACE_MARKER();
+
+	struct u_sink_frame_set_split *s = (struct u_sink_frame_set_split *)xfss;
+
+	xrt_sink_push_frame_set(s->one, set);
+	xrt_sink_push_frame_set(s->two, set);
+}
+
+static void
+split_frame_set_destroy(struct xrt_frame_node *node)
+{
+	struct u_sink_frame_set_split *s = container_of(node, struct u_sink_frame_set_split, node);
+
+	free(s);
+}
+
 
 /*
  *
@@ -76,3 +109,22 @@ u_sink_split_create(struct xrt_frame_context *xfctx,
 
 	*out_xfs = &s->base;
 }
+
+void
+u_sink_frame_set_split_create(struct xrt_frame_context *xfctx,
+                              struct xrt_frame_set_sink *one,
+                              struct xrt_frame_set_sink *two,
+                              struct xrt_frame_set_sink **out_xfss)
+{
+	struct u_sink_frame_set_split *s = U_TYPED_CALLOC(struct u_sink_frame_set_split);
+
+	s->base.push_frame_set = split_frame_set;
+	s->node.break_apart = split_break_apart;
+	s->node.destroy = split_frame_set_destroy;
+	s->one = one;
+	s->two = two;
+
+	xrt_frame_context_add(xfctx, &s->node);
+
+	*out_xfss = &s->base;
+}
@@ -0,0 +1,434 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  An @ref xrt_frame_sink that matches frames from N cameras into @ref xrt_frame_set.
+ * @ingroup aux_util
+ */
+
+#include "os/os_threading.h"
+
+#include "util/u_var.h"
+#include "util/u_misc.h"
+#include "util/u_sink.h"
+#include "util/u_logging.h"
+#include "util/u_trace_marker.h"
+
+#include <inttypes.h>
+
+
+/*!
+ * How many frames each input holds while waiting for the other cameras.
+ */
+#define U_SINK_SYNC_QUEUE_DEPTH (4)
+
+/*!
+ * How many matched sets can wait for the worker thread before the oldest is
+ * dropped.
+ */
+#define U_SINK_SYNC_PENDING_DEPTH (4)
+
+/*!
+ * Most frames that a single push can release: every queued frame, the one
+ * pushed out of a full queue and the frames of a dropped pending set.
+ */
+#define U_SINK_SYNC_MAX_RELEASE (XRT_FRAME_SET_MAX_FRAMES * (U_SINK_SYNC_QUEUE_DEPTH + 1) + 1)
+
+struct u_sink_sync;
+
+/*!
+ * One camera input of @ref u_sink_sync.
+ *
+ * @implements xrt_frame_sink
+ */
+struct u_sink_sync_input
+{
+	struct xrt_frame_sink base;
+
+	struct u_sink_sync *sync;
+
+	//! Frames in arrival order, oldest at @ref head.
+	struct xrt_frame *queue[U_SINK_SYNC_QUEUE_DEPTH];
+	uint32_t head;
+	uint32_t count;
+};
+
+/*!
+ * An @ref xrt_frame_sink per camera that pushes a @ref xrt_frame_set
+ * downstream once every camera has a frame within the tolerance of the
+ * others. Only references are taken, the frames are never copied or modified.
+ *
+ * Matching happens on the pushing thread and is cheap, the downstream push is
+ * done on a worker thread so slow consumers don't block the camera drivers.
+ *
+ * @implements xrt_frame_node
+ */
+struct u_sink_sync
+{
+	struct u_sink_sync_input inputs[XRT_FRAME_SET_MAX_FRAMES];
+	uint32_t input_count;
+
+	//! For tracking on the frame context.
+	struct xrt_frame_node node;
+
+	//! The consumer of the matched sets.
+	struct xrt_frame_set_sink *consumer;
+
+	//! Largest allowed difference between the frames of a set.
+	int64_t tolerance_ns;
+
+	//! Matched sets waiting for the worker, oldest at pending_head.
+	struct xrt_frame_set pending[U_SINK_SYNC_PENDING_DEPTH];
+	uint32_t pending_head;
+	uint32_t pending_count;
+
+	//! Timestamp of the last matched set.
+	int64_t last_ts;
+
+	//! Protected by the thread helper lock.
+	struct u_sink_sync_stats stats;
+
+	//! Lock protects all of the queues, pending sets and stats.
+	struct os_thread_helper oth;
+};
+
+
+/*
+ *
+ * Helper functions.
+ *
+ */
+
+static struct xrt_frame *
+input_pop_locked(struct u_sink_sync_input *in)
+{
+	assert(in->count > 0);
+
+	struct xrt_frame *xf = in->queue[in->head];
+	in->queue[in->head] = NULL;
+	in->head = (in->head + 1) % U_SINK_SYNC_QUEUE_DEPTH;
+	in->count--;
+
+	return xf;
+}
+
+static struct xrt_frame *
+input_front_locked(struct u_sink_sync_input *in)
+{
+	return in->queue[in->head];
+}
+
+static void
+update_skew_stats_locked(struct u_sink_sync *s, int64_t skew_ns)
+{
+	struct u_sink_sync_stats *st = &s->stats;
+
+	st->sets++;
+	st->last_skew_ns = skew_ns;
+	if (skew_ns > st->max_skew_ns) {
+		st->max_skew_ns = skew_ns;
+	}
+
+	// Running mean, exact enough for a statistic.
+	st->mean_skew_ns += ((double)skew_ns - st->mean_skew_ns) / (double)st->sets;
+}
+
+/*!
+ * Adds a set to the pending queue, returns the frames of a dropped set in
+ * @p release if it was full.
+ */
+static void
+pending_push_locked(struct u_sink_sync *s,
+                    const struct xrt_frame_set *set,
+                    struct xrt_frame **release,
+                    uint32_t *count)
+{
+	if (s->pending_count == U_SINK_SYNC_PENDING_DEPTH) {
+		struct xrt_frame_set *old = &s->pending[s->pending_head];
+		for (uint32_t i = 0; i < old->frame_count; i++) {
+			release[(*count)++] = old->frames[i];
+		}
+		U_ZERO(old);
+
+		s->pending_head = (s->pending_head + 1) % U_SINK_SYNC_PENDING_DEPTH;
+		s->pending_count--;
+		s->stats.dropped_sets++;
+	}
+
+	uint32_t index = (s->pending_head + s->pending_count) % U_SINK_SYNC_PENDING_DEPTH;
+	s->pending[index] = *set;
+	s->pending_count++;
+}
+
+/*!
+ * Matches the fronts of all input queues, the frames that are released are
+ * put in @p release so they can be unreferenced without holding the lock.
+ */
+static void
+match_locked(struct u_sink_sync *s, struct xrt_frame **release, uint32_t *count)
+{
+	while (true) {
+		uint32_t oldest = 0;
+		int64_t min_ts = INT64_MAX;
+		int64_t max_ts = INT64_MIN;
+
+		for (uint32_t i = 0; i < s->input_count; i++) {
+			if (s->inputs[i].count == 0) {
+				return;
+			}
+
+			int64_t ts = input_front_locked(&s->inputs[i])->timestamp;
+			if (ts < min_ts) {
+				min_ts = ts;
+				oldest = i;
+			}
+			if (ts > max_ts) {
+				max_ts = ts;
+			}
+		}
+
+		/*
+		 * The newest front can only be matched by later frames, so the
+		 * oldest front will never be part of a set, drop it and retry.
+		 */
+		if (max_ts - min_ts > s->tolerance_ns) {
+			release[(*count)++] = input_pop_locked(&s->inputs[oldest]);
+			s->stats.dropped_frames++;
+			continue;
+		}
+
+		struct xrt_frame_set set = {0};
+		set.frame_count = s->input_count;
+
+		int64_t offset_sum = 0;
+		for (uint32_t i = 0; i < s->input_count; i++) {
+			set.frames[i] = input_pop_locked(&s->inputs[i]);
+			offset_sum += set.frames[i]->timestamp - min_ts;
+		}
+
+		// Offsets are bounded by the tolerance, no overflow unlike summing timestamps.
+		set.timestamp = min_ts + offset_sum / (int64_t)s->input_count;
+		set.skew_ns = max_ts - min_ts;
+
+		if (set.timestamp <= s->last_ts) {
+			U_LOG_W("Frame set is not newer than the last one! Old: %" PRId64 "; New: %" PRId64, s->last_ts,
+			        set.timestamp);
+			for (uint32_t i = 0; i < set.frame_count; i++) {
+				release[(*count)++] = set.frames[i];
+			}
+			s->stats.dropped_frames += set.frame_count;
+			continue;
+		}
+
+		s->last_ts = set.timestamp;
+		update_skew_stats_locked(s, set.skew_ns);
+		pending_push_locked(s, &set, release, count);
+
+		os_thread_helper_signal_locked(&s->oth);
+	}
+}
+
+static void
+release_frames(struct xrt_frame **release, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++) {
+		xrt_frame_reference(&release[i], NULL);
+	}
+}
+
+
+/*
+ *
+ * Thread and sink functions.
+ *
+ */
+
+static void *
+sync_mainloop(void *ptr)
+{
+	U_TRACE_SET_THREAD_NAME("Sink Sync");
+
+	struct u_sink_sync *s = (struct u_sink_sync *)ptr;
+
+	os_thread_helper_lock(&s->oth);
+
+	while (os_thread_helper_is_running_locked(&s->oth)) {
+		if (s->pending_count == 0) {
+			os_thread_helper_wait_locked(&s->oth);
+
+			// Re-check running and spurious wakeups.
+			continue;
+		}
+
+		// Move the set out, the references are now ours.
+		struct xrt_frame_set set = s->pending[s->pending_head];
+		U_ZERO(&s->pending[s->pending_head]);
+		s->pending_head = (s->pending_head + 1) % U_SINK_SYNC_PENDING_DEPTH;
+		s->pending_count--;
+
+		// Don't hold the lock while the consumer does its work.
+		os_thread_helper_unlock(&s->oth);
+
+		SINK_TRACE_IDENT(sync_frame_set);
+
+		xrt_sink_push_frame_set(s->consumer, &set);
+
+		release_frames(set.frames, set.frame_count);
+
+		os_thread_helper_lock(&s->oth);
+	}
+
+	os_thread_helper_unlock(&s->oth);
+
+	return NULL;
+}
+
+static void
+sync_push_frame(struct xrt_frame_sink *xfs, struct xrt_frame *xf)
+{
+	SINK_TRACE_MARKER();
+
+	struct u_sink_sync_input *in = container_of(xfs, struct u_sink_sync_input, base);
+	struct u_sink_sync *s = in->sync;
+
+	struct xrt_frame *release[U_SINK_SYNC_MAX_RELEASE] = {0};
+	uint32_t release_count = 0;
+
+	os_thread_helper_lock(&s->oth);
+
+	// Only take new frames if we are running.
+	if (!os_thread_helper_is_running_locked(&s->oth)) {
+		os_thread_helper_unlock(&s->oth);
+		return;
+	}
+
+	// A camera running ahead of the others pushes out its oldest frame.
+	if (in->count == U_SINK_SYNC_QUEUE_DEPTH) {
+		release[release_count++] = input_pop_locked(in);
+		s->stats.dropped_frames++;
+	}
+
+	uint32_t index = (in->head + in->count) % U_SINK_SYNC_QUEUE_DEPTH;
+	xrt_frame_reference(&in->queue[index], xf);
+	in->count++;
+
+	match_locked(s, release, &release_count);
+
+	os_thread_helper_unlock(&s->oth);
+
+	// Don't hold the lock while releasing the frames.
+	release_frames(release, release_count);
+}
+
+static void
+sync_break_apart(struct xrt_frame_node *node)
+{
+	struct u_sink_sync *s = container_of(node, struct u_sink_sync, node);
+
+	// Stop the thread, after this no new frames are taken.
+	os_thread_helper_stop_and_wait(&s->oth);
+
+	for (uint32_t i = 0; i < s->input_count; i++) {
+		struct u_sink_sync_input *in = &s->inputs[i];
+		while (in->count > 0) {
+			struct xrt_frame *xf = input_pop_locked(in);
+			xrt_frame_reference(&xf, NULL);
+		}
+	}
+
+	while (s->pending_count > 0) {
+		struct xrt_frame_set *set = &s->pending[s->pending_head];
+		release_frames(set->frames, set->frame_count);
+		s->pending_head = (s->pending_head + 1) % U_SINK_SYNC_PENDING_DEPTH;
+		s->pending_count--;
+	}
+
+	U_LOG_D("Frame sets: %" PRIu64 ", dropped frames: %" PRIu64 ", dropped sets: %" PRIu64
+	        ", skew mean/max: %.0f/%" PRId64 " ns",
+	        s->stats.sets, s->stats.dropped_frames, s->stats.dropped_sets, s->stats.mean_skew_ns,
+	        s->stats.max_skew_ns);
+}
+
+static void
+sync_destroy(struct xrt_frame_node *node)
+{
+	struct u_sink_sync *s = container_of(node, struct u_sink_sync, node);
+
+	u_var_remove_root(s);
+
+	os_thread_helper_destroy(&s->oth);
+	free(s);
+}
+
+
+/*
+ *
+ * Exported functions.
+ *
+ */
+
+bool
+u_sink_sync_create(struct xrt_frame_context *xfctx,
+                   uint32_t frame_count,
+                   int64_t tolerance_ns,
+                   struct xrt_frame_set_sink *downstream,
+                   struct xrt_frame_sink **out_xfss)
+{
+	if (frame_count == 0 || frame_count > XRT_FRAME_SET_MAX_FRAMES) {
+		U_LOG_E("Invalid frame count %u, max is %u", frame_count, XRT_FRAME_SET_MAX_FRAMES);
+		return false;
+	}
+
+	struct u_sink_sync *s = U_TYPED_CALLOC(struct u_sink_sync);
+
+	for (uint32_t i = 0; i < frame_count; i++) {
+		s->inputs[i].base.push_frame = sync_push_frame;
+		s->inputs[i].sync = s;
+	}
+	s->input_count = frame_count;
+	s->node.break_apart = sync_break_apart;
+	s->node.destroy = sync_destroy;
+	s->consumer = downstream;
+	s->tolerance_ns = tolerance_ns;
+	s->last_ts = INT64_MIN;
+
+	int ret = os_thread_helper_init(&s->oth);
+	if (ret != 0) {
+		free(s);
+		return false;
+	}
+
+	ret = os_thread_helper_start(&s->oth, sync_mainloop, s);
+	if (ret != 0) {
+		os_thread_helper_destroy(&s->oth);
+		free(s);
+		return false;
+	}
+
+	xrt_frame_context_add(xfctx, &s->node);
+
+	u_var_add_root(s, "Frame sync sink", true);
+	u_var_add_ro_u64(s, &s->stats.sets, "Frame sets");
+	u_var_add_ro_u64(s, &s->stats.dropped_frames, "Dropped frames");
+	u_var_add_ro_u64(s, &s->stats.dropped_sets, "Dropped sets");
+	u_var_add_ro_i64(s, &s->stats.last_skew_ns, "Last skew (ns)");
+	u_var_add_ro_i64(s, &s->stats.max_skew_ns, "Max skew (ns)");
+	u_var_add_ro_f64(s, &s->stats.mean_skew_ns, "Mean skew (ns)");
+
+	for (uint32_t i = 0; i < frame_count; i++) {
+		out_xfss[i] = &s->inputs[i].base;
+	}
+
+	return true;
+}
+
+void
+u_sink_sync_get_stats(struct xrt_frame_sink *xfs, struct u_sink_sync_stats *out_stats)
+{
+	struct u_sink_sync_input *in = container_of(xfs, struct u_sink_sync_input, base);
+	struct u_sink_sync *s = in->sync;
+
+	os_thread_helper_lock(&s->oth);
+	*out_stats = s->stats;
+	os_thread_helper_unlock(&s->oth);
+}
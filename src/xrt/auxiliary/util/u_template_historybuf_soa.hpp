@@ -0,0 +1,507 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Structure of arrays ring buffer of timestamped values.
+ * @ingroup aux_util
+ */
+
+#pragma once
+
+#include "u_template_historybuf_impl_helpers.hpp"
+#include "u_iterator_base.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+#include <stdint.h>
+#include <tuple>
+#include <type_traits>
+
+#if defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+
+namespace xrt::auxiliary::util {
+
+namespace detail {
+	template <bool IsConst, size_t MaxSize, typename... Columns> class HistoryBufSoAIterator;
+
+	//! Hint that @p ptr will be read soon.
+	static inline void
+	prefetch_for_read(const void *ptr) noexcept
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		__builtin_prefetch(ptr, 0);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		_mm_prefetch(static_cast<const char *>(ptr), _MM_HINT_T0);
+#else
+		(void)ptr;
+#endif
+	}
+} // namespace detail
+
+/*!
+ * @brief A view of one entry of a @ref HistoryBufferSoA, what its iterators dereference to.
+ *
+ * Only valid until the buffer is modified.
+ */
+template <bool IsConst, typename... Columns> class HistoryBufSoARow
+{
+public:
+	template <size_t Col> using column_type = std::tuple_element_t<Col, std::tuple<Columns...>>;
+
+	//! Timestamp of the entry.
+	int64_t timestamp;
+
+	//! Get the value of column @p Col of the entry.
+	template <size_t Col = 0>
+	std::conditional_t<IsConst, const column_type<Col>, column_type<Col>> &
+	get() const noexcept
+	{
+		return *std::get<Col>(ptrs_);
+	}
+
+	//! For use by the buffer.
+	HistoryBufSoARow(int64_t ts, std::tuple<std::conditional_t<IsConst, const Columns, Columns> *...> ptrs)
+	    : timestamp(ts), ptrs_(ptrs)
+	{}
+
+private:
+	std::tuple<std::conditional_t<IsConst, const Columns, Columns> *...> ptrs_;
+};
+
+/*!
+ * @brief Stores timestamped values in a ring buffer like @ref HistoryBuffer, but as a structure of arrays.
+ *
+ * The timestamps live in their own contiguous array and each of the @p Columns in another, so searching by time only
+ * touches the timestamps instead of pulling in whole entries. The timestamps must be pushed in non-decreasing order
+ * for the searches to work.
+ *
+ * The iterators dereference to a @ref HistoryBufSoARow view of the entry.
+ *
+ * @note Like @ref HistoryBuffer this is **not inherently safe for concurrent/threaded use**: there are no locks
+ * built-in.
+ *
+ * @tparam MaxSize Number of entries, the oldest is overwritten when full.
+ * @tparam Columns Value types stored with each timestamp.
+ */
+template <size_t MaxSize, typename... Columns> class HistoryBufferSoA
+{
+public:
+	static_assert(sizeof...(Columns) > 0, "Need at least one column");
+	static_assert(MaxSize > 0, "Need room for at least one element");
+
+	template <size_t Col> using column_type = std::tuple_element_t<Col, std::tuple<Columns...>>;
+
+	using row = HistoryBufSoARow<false, Columns...>;
+	using const_row = HistoryBufSoARow<true, Columns...>;
+	using iterator = detail::HistoryBufSoAIterator<false, MaxSize, Columns...>;
+	using const_iterator = detail::HistoryBufSoAIterator<true, MaxSize, Columns...>;
+
+	//! Is the buffer empty?
+	bool
+	empty() const noexcept
+	{
+		return helper_.empty();
+	}
+
+	//! How many elements are in the buffer?
+	size_t
+	size() const noexcept
+	{
+		return helper_.size();
+	}
+
+	/*!
+	 * @brief Put an entry at the back, overwriting whatever was at the front if necessary.
+	 *
+	 * This is permitted to invalidate iterators.
+	 */
+	void
+	push_back(int64_t timestamp, const Columns &...values)
+	{
+		const size_t inner_index = helper_.push_back_location();
+		timestamps_[inner_index] = timestamp;
+		store(inner_index, std::index_sequence_for<Columns...>{}, values...);
+	}
+
+	//! Logically remove the newest element from the buffer, see @ref HistoryBuffer::pop_back.
+	bool
+	pop_back() noexcept
+	{
+		return helper_.pop_back();
+	}
+
+	//! Logically remove the oldest element from the buffer, see @ref HistoryBuffer::pop_front.
+	void
+	pop_front() noexcept
+	{
+		helper_.pop_front();
+	}
+
+	void
+	clear()
+	{
+		helper_.clear();
+	}
+
+	/*!
+	 * @brief The timestamp at a given index, where 0 is the least-recent value still stored (chronological
+	 * order).
+	 *
+	 * Out of bounds accesses will return nullptr.
+	 */
+	const int64_t *
+	timestamp_at_index(size_t index) const noexcept
+	{
+		size_t inner_index = 0;
+		return helper_.index_to_inner_index(index, inner_index) ? &timestamps_[inner_index] : nullptr;
+	}
+
+	/*!
+	 * @brief The timestamp at a given age, where age 0 is the most recent value (reverse chronological order).
+	 *
+	 * Out of bounds accesses will return nullptr.
+	 */
+	const int64_t *
+	timestamp_at_age(size_t age) const noexcept
+	{
+		size_t inner_index = 0;
+		return helper_.age_to_inner_index(age, inner_index) ? &timestamps_[inner_index] : nullptr;
+	}
+
+	/*!
+	 * @brief Column @p Col at a given index, see @ref timestamp_at_index.
+	 *
+	 * Out of bounds accesses will return nullptr.
+	 */
+	template <size_t Col = 0>
+	column_type<Col> *
+	get_at_index(size_t index) noexcept
+	{
+		size_t inner_index = 0;
+		return helper_.index_to_inner_index(index, inner_index) ? &column<Col>()[inner_index] : nullptr;
+	}
+
+	//! @overload
+	template <size_t Col = 0>
+	const column_type<Col> *
+	get_at_index(size_t index) const noexcept
+	{
+		size_t inner_index = 0;
+		return helper_.index_to_inner_index(index, inner_index) ? &column<Col>()[inner_index] : nullptr;
+	}
+
+	/*!
+	 * @brief Column @p Col at a given age, see @ref timestamp_at_age.
+	 *
+	 * Out of bounds accesses will return nullptr.
+	 */
+	template <size_t Col = 0>
+	column_type<Col> *
+	get_at_age(size_t age) noexcept
+	{
+		size_t inner_index = 0;
+		return helper_.age_to_inner_index(age, inner_index) ? &column<Col>()[inner_index] : nullptr;
+	}
+
+	//! @overload
+	template <size_t Col = 0>
+	const column_type<Col> *
+	get_at_age(size_t age) const noexcept
+	{
+		size_t inner_index = 0;
+		return helper_.age_to_inner_index(age, inner_index) ? &column<Col>()[inner_index] : nullptr;
+	}
+
+	/*!
+	 * @brief Timestamp of the front (oldest) element in the buffer.
+	 * @throws std::logic_error if buffer is empty
+	 */
+	int64_t
+	front_timestamp() const
+	{
+		return timestamps_[checked_front()];
+	}
+
+	/*!
+	 * @brief Timestamp of the back (newest) element in the buffer.
+	 * @throws std::logic_error if buffer is empty
+	 */
+	int64_t
+	back_timestamp() const
+	{
+		return timestamps_[checked_back()];
+	}
+
+	/*!
+	 * @brief Column @p Col of the front (oldest) element in the buffer.
+	 * @throws std::logic_error if buffer is empty
+	 */
+	template <size_t Col = 0>
+	column_type<Col> &
+	front()
+	{
+		return column<Col>()[checked_front()];
+	}
+
+	//! @overload
+	template <size_t Col = 0>
+	const column_type<Col> &
+	front() const
+	{
+		return column<Col>()[checked_front()];
+	}
+
+	/*!
+	 * @brief Column @p Col of the back (newest) element in the buffer.
+	 * @throws std::logic_error if buffer is empty
+	 */
+	template <size_t Col = 0>
+	column_type<Col> &
+	back()
+	{
+		return column<Col>()[checked_back()];
+	}
+
+	//! @overload
+	template <size_t Col = 0>
+	const column_type<Col> &
+	back() const
+	{
+		return column<Col>()[checked_back()];
+	}
+
+	/*!
+	 * @brief Index of the first element whose timestamp is not less than @p timestamp, or size() if there is
+	 * none.
+	 *
+	 * Branchless binary search that prefetches both possible next probes.
+	 */
+	size_t
+	lower_bound_index(int64_t timestamp) const noexcept
+	{
+		return binary_search(0, size(), timestamp);
+	}
+
+	/*!
+	 * @brief Same result as @ref lower_bound_index, but guesses the position from the timestamps at the ends of
+	 * the searched range.
+	 *
+	 * Needs a single probe or two for evenly spaced timestamps, as from a sensor at a fixed rate. Falls back to
+	 * the binary search if the guesses don't converge quickly.
+	 */
+	size_t
+	interpolation_lower_bound_index(int64_t timestamp) const noexcept;
+
+	//! Iterator version of @ref lower_bound_index.
+	const_iterator
+	lower_bound(int64_t timestamp) const noexcept
+	{
+		return cbegin() + static_cast<std::ptrdiff_t>(lower_bound_index(timestamp));
+	}
+
+	//! Iterator version of @ref interpolation_lower_bound_index.
+	const_iterator
+	interpolation_lower_bound(int64_t timestamp) const noexcept
+	{
+		return cbegin() + static_cast<std::ptrdiff_t>(interpolation_lower_bound_index(timestamp));
+	}
+
+	//! Get a const iterator for the oldest element.
+	const_iterator
+	cbegin() const noexcept;
+
+	//! Get a "past the end" (past the newest) const iterator
+	const_iterator
+	cend() const noexcept;
+
+	//! Get a const iterator for the oldest element.
+	const_iterator
+	begin() const noexcept
+	{
+		return cbegin();
+	}
+
+	//! Get a "past the end" (past the newest) const iterator
+	const_iterator
+	end() const noexcept
+	{
+		return cend();
+	}
+
+	//! Get an iterator for the oldest element.
+	iterator
+	begin() noexcept;
+
+	//! Get a "past the end" (past the newest) iterator
+	iterator
+	end() noexcept;
+
+private:
+	friend class detail::HistoryBufSoAIterator<false, MaxSize, Columns...>;
+	friend class detail::HistoryBufSoAIterator<true, MaxSize, Columns...>;
+
+	// Make sure all valid indices can be represented in a signed integer of the same size
+	static_assert(MaxSize < (std::numeric_limits<size_t>::max() >> 1), "Cannot use most significant bit");
+
+	template <size_t Col>
+	std::array<column_type<Col>, MaxSize> &
+	column() noexcept
+	{
+		return std::get<Col>(columns_);
+	}
+
+	template <size_t Col>
+	const std::array<column_type<Col>, MaxSize> &
+	column() const noexcept
+	{
+		return std::get<Col>(columns_);
+	}
+
+	template <size_t... Cols>
+	void
+	store(size_t inner_index, std::index_sequence<Cols...>, const Columns &...values)
+	{
+		((std::get<Cols>(columns_)[inner_index] = values), ...);
+	}
+
+	size_t
+	checked_front() const
+	{
+		if (empty()) {
+			throw std::logic_error("Cannot get the front of an empty buffer");
+		}
+		return helper_.front_inner_index();
+	}
+
+	size_t
+	checked_back() const
+	{
+		if (empty()) {
+			throw std::logic_error("Cannot get the back of an empty buffer");
+		}
+		return helper_.back_inner_index();
+	}
+
+	//! Map an in bounds index to an inner index, @p front is from RingBufferHelper::front_inner_index.
+	static size_t
+	wrap(size_t front, size_t index) noexcept
+	{
+		const size_t inner = front + index;
+		return inner >= MaxSize ? inner - MaxSize : inner;
+	}
+
+	//! Lower bound within the @p count elements starting at index @p first.
+	size_t
+	binary_search(size_t first, size_t count, int64_t timestamp) const noexcept;
+
+	//! Row for the element at @p index, must be in bounds.
+	const_row
+	row_at(size_t index) const noexcept
+	{
+		return make_row<const_row>(*this, index, std::index_sequence_for<Columns...>{});
+	}
+
+	//! @overload
+	row
+	row_at(size_t index) noexcept
+	{
+		return make_row<row>(*this, index, std::index_sequence_for<Columns...>{});
+	}
+
+	template <typename Row, typename Self, size_t... Cols>
+	static Row
+	make_row(Self &self, size_t index, std::index_sequence<Cols...>) noexcept
+	{
+		size_t inner_index = 0;
+		self.helper_.index_to_inner_index(index, inner_index);
+		return {self.timestamps_[inner_index], std::make_tuple(&std::get<Cols>(self.columns_)[inner_index]...)};
+	}
+
+	std::array<int64_t, MaxSize> timestamps_{};
+	std::tuple<std::array<Columns, MaxSize>...> columns_{};
+	detail::RingBufferHelper helper_{MaxSize};
+};
+
+
+template <size_t MaxSize, typename... Columns>
+inline size_t
+HistoryBufferSoA<MaxSize, Columns...>::binary_search(size_t first, size_t count, int64_t timestamp) const noexcept
+{
+	if (count == 0) {
+		return first;
+	}
+
+	const size_t front = helper_.front_inner_index();
+	const int64_t *ts = timestamps_.data();
+	size_t base = first;
+
+	while (count > 1) {
+		const size_t half = count / 2;
+		const size_t next_count = count - half;
+
+		// Whichever way this goes, the next probe is at one of these.
+		detail::prefetch_for_read(&ts[wrap(front, base + next_count / 2)]);
+		detail::prefetch_for_read(&ts[wrap(front, base + half + next_count / 2)]);
+
+		base = ts[wrap(front, base + half)] < timestamp ? base + half : base;
+		count = next_count;
+	}
+
+	return base + (ts[wrap(front, base)] < timestamp ? 1 : 0);
+}
+
+template <size_t MaxSize, typename... Columns>
+inline size_t
+HistoryBufferSoA<MaxSize, Columns...>::interpolation_lower_bound_index(int64_t timestamp) const noexcept
+{
+	// Give up guessing after this many probes, the timestamps are not evenly spread.
+	constexpr int max_guesses = 4;
+
+	const size_t n = size();
+	if (n == 0) {
+		return 0;
+	}
+
+	const size_t front = helper_.front_inner_index();
+	const int64_t *ts = timestamps_.data();
+
+	size_t lo = 0;
+	size_t hi = n - 1;
+	int64_t lo_ts = ts[wrap(front, lo)];
+	int64_t hi_ts = ts[wrap(front, hi)];
+
+	if (timestamp <= lo_ts) {
+		return 0;
+	}
+	if (timestamp > hi_ts) {
+		return n;
+	}
+
+	// The answer is in (lo, hi]: ts[lo] < timestamp <= ts[hi].
+	for (int i = 0; i < max_guesses && hi - lo > 1; i++) {
+		const double fraction = (double)(timestamp - lo_ts) / (double)(hi_ts - lo_ts);
+		size_t guess = lo + static_cast<size_t>(fraction * (double)(hi - lo));
+		guess = std::clamp(guess, lo + 1, hi - 1);
+
+		const int64_t guess_ts = ts[wrap(front, guess)];
+		if (guess_ts < timestamp) {
+			lo = guess;
+			lo_ts = guess_ts;
+		} else {
+			hi = guess;
+			hi_ts = guess_ts;
+		}
+	}
+
+	return binary_search(lo + 1, hi - lo, timestamp);
+}
+
+
+} // namespace xrt::auxiliary::util
+
+#include "u_template_historybuf_soa_iterator.inl"
@@ -0,0 +1,252 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief iterator and const_iterator details for the structure of arrays ring buffer
+ * @ingroup aux_util
+ */
+#pragma once
+
+// IWYU pragma: private, include "util/u_template_historybuf_soa.hpp"
+
+#include <stddef.h>
+#include <type_traits>
+
+namespace xrt::auxiliary::util {
+template <size_t MaxSize, typename... Columns> class HistoryBufferSoA;
+
+namespace detail {
+	/**
+	 * @brief Class template for iterator and const_iterator for HistoryBufferSoA
+	 *
+	 * Dereferences to a @ref HistoryBufSoARow by value, there is no element type to point at.
+	 *
+	 * @tparam IsConst Is this the const_iterator.
+	 * @tparam MaxSize Maximum number of elements - must match HistoryBufferSoA
+	 * @tparam Columns Column types - must match HistoryBufferSoA
+	 */
+	template <bool IsConst, size_t MaxSize, typename... Columns>
+	class HistoryBufSoAIterator : public RandomAccessIteratorBase<const RingBufferHelper>
+	{
+		using base = RandomAccessIteratorBase<const RingBufferHelper>;
+		friend class HistoryBufferSoA<MaxSize, Columns...>;
+		friend class HistoryBufSoAIterator<!IsConst, MaxSize, Columns...>;
+
+	public:
+		using Self = HistoryBufSoAIterator<IsConst, MaxSize, Columns...>;
+		using container_type = std::conditional_t<IsConst,
+		                                          const HistoryBufferSoA<MaxSize, Columns...>,
+		                                          HistoryBufferSoA<MaxSize, Columns...>>;
+		using typename base::difference_type;
+		using typename base::iterator_category;
+		using value_type = HistoryBufSoARow<IsConst, Columns...>;
+		using reference = value_type;
+
+		//! Lets `it->timestamp` work even though rows are returned by value.
+		struct pointer
+		{
+			value_type row;
+
+			const value_type *
+			operator->() const noexcept
+			{
+				return &row;
+			}
+		};
+
+		//! Default-construct an (invalid) iterator.
+		HistoryBufSoAIterator() = default;
+
+		// copy and move as you wish
+		HistoryBufSoAIterator(HistoryBufSoAIterator const &) = default;
+		HistoryBufSoAIterator(HistoryBufSoAIterator &&) noexcept = default;
+		HistoryBufSoAIterator &
+		operator=(HistoryBufSoAIterator const &) = default;
+		HistoryBufSoAIterator &
+		operator=(HistoryBufSoAIterator &&) noexcept = default;
+
+		//! Implicit conversion from a non-const iterator
+		template <bool OtherIsConst, typename = std::enable_if_t<IsConst && !OtherIsConst>>
+		HistoryBufSoAIterator(const HistoryBufSoAIterator<OtherIsConst, MaxSize, Columns...> &other)
+		    : base(other), container_(other.container_)
+		{}
+
+		//! Is this iterator valid?
+		bool
+		valid() const noexcept
+		{
+			return container_ != nullptr && base::valid();
+		}
+
+		//! Is this iterator valid?
+		explicit operator bool() const noexcept
+		{
+			return valid();
+		}
+
+		//! Get the associated container: for internal use
+		container_type *
+		container() const noexcept
+		{
+			return container_;
+		}
+
+		//! Dereference operator: throws std::out_of_range if invalid
+		reference
+		operator*() const
+		{
+			if (!valid()) {
+				throw std::out_of_range("Iterator index out of range");
+			}
+			return container_->row_at(base::index());
+		}
+
+		//! Smart pointer operator: throws std::out_of_range if invalid
+		pointer
+		operator->() const
+		{
+			return {**this};
+		}
+
+		//! Timestamp of the element, without making a row: throws std::out_of_range if invalid
+		int64_t
+		timestamp() const
+		{
+			const int64_t *ptr =
+			    container_ != nullptr ? container_->timestamp_at_index(base::index()) : nullptr;
+			if (ptr == nullptr) {
+				throw std::out_of_range("Iterator index out of range");
+			}
+			return *ptr;
+		}
+
+		//! Pre-increment: Advance, then return self.
+		Self &
+		operator++()
+		{
+			this->increment_n(1);
+			return *this;
+		}
+
+		//! Post-increment: return a copy of initial state after incrementing self
+		// NOLINTNEXTLINE(cert-dcl21-cpp)
+		Self
+		operator++(int) &
+		{
+			Self tmp = *this;
+			this->increment_n(1);
+			return tmp;
+		}
+
+		//! Pre-decrement: Subtract, then return self.
+		Self &
+		operator--()
+		{
+			this->decrement_n(1);
+			return *this;
+		}
+
+		//! Post-decrement: return a copy of initial state after decrementing self
+		// NOLINTNEXTLINE(cert-dcl21-cpp)
+		Self
+		operator--(int) &
+		{
+			Self tmp = *this;
+			this->decrement_n(1);
+			return tmp;
+		}
+
+		// Use the base class implementation of subtracting one iterator from another
+		using base::operator-;
+
+		//! Increment by an arbitrary amount.
+		Self &
+		operator+=(std::ptrdiff_t n) noexcept
+		{
+			static_cast<base &>(*this) += n;
+			return *this;
+		}
+
+		//! Decrement by an arbitrary amount.
+		Self &
+		operator-=(std::ptrdiff_t n) noexcept
+		{
+			static_cast<base &>(*this) -= n;
+			return *this;
+		}
+
+		//! Increment a copy of the iterator by an arbitrary amount.
+		Self
+		operator+(std::ptrdiff_t n) const noexcept
+		{
+			Self ret(*this);
+			ret += n;
+			return ret;
+		}
+
+		//! Decrement a copy of the iterator by an arbitrary amount.
+		Self
+		operator-(std::ptrdiff_t n) const noexcept
+		{
+			Self ret(*this);
+			ret -= n;
+			return ret;
+		}
+
+	private:
+		//! Factory for a "begin" iterator from a container and its helper: mostly for internal use.
+		static Self
+		begin(container_type &container, const RingBufferHelper &helper)
+		{
+			return {&container, base::begin(helper)};
+		}
+
+		//! Construct the "past the end" iterator that can be decremented safely
+		static Self
+		end(container_type &container, const RingBufferHelper &helper)
+		{
+			return {&container, base::end(helper)};
+		}
+
+		// for use internally
+		HistoryBufSoAIterator(container_type *container, base &&iter_base)
+		    : base(iter_base), container_(container)
+		{}
+		container_type *container_{nullptr};
+	};
+} // namespace detail
+
+// HistoryBufferSoA method implementations that depend on iterator availability
+
+template <size_t MaxSize, typename... Columns>
+inline typename HistoryBufferSoA<MaxSize, Columns...>::const_iterator
+HistoryBufferSoA<MaxSize, Columns...>::cbegin() const noexcept
+{
+	static_assert(std::is_same<typename std::iterator_traits<const_iterator>::iterator_category,
+	                           std::random_access_iterator_tag>::value,
+	              "Iterator should be random access");
+	return const_iterator::begin(*this, helper_);
+}
+
+template <size_t MaxSize, typename... Columns>
+inline typename HistoryBufferSoA<MaxSize, Columns...>::const_iterator
+HistoryBufferSoA<MaxSize, Columns...>::cend() const noexcept
+{
+	return const_iterator::end(*this, helper_);
+}
+
+template <size_t MaxSize, typename... Columns>
+inline typename HistoryBufferSoA<MaxSize, Columns...>::iterator
+HistoryBufferSoA<MaxSize, Columns...>::begin() noexcept
+{
+	return iterator::begin(*this, helper_);
+}
+
+template <size_t MaxSize, typename... Columns>
+inline typename HistoryBufferSoA<MaxSize, Columns...>::iterator
+HistoryBufferSoA<MaxSize, Columns...>::end() noexcept
+{
+	return iterator::end(*this, helper_);
+}
+
+} // namespace xrt::auxiliary::util
@@ -27,6 +27,7 @@ PERCETTO_CATEGORY_DEFINE(U_TRACE_CATEGORIES)
 PERCETTO_TRACK_DEFINE(pc_cpu, PERCETTO_TRACK_EVENTS);
 PERCETTO_TRACK_DEFINE(pc_allotted, PERCETTO_TRACK_EVENTS);
 PERCETTO_TRACK_DEFINE(pc_gpu, PERCETTO_TRACK_EVENTS);
+PERCETTO_TRACK_DEFINE(pc_gpu_passes, PERCETTO_TRACK_EVENTS);
 PERCETTO_TRACK_DEFINE(pc_margin, PERCETTO_TRACK_EVENTS);
 PERCETTO_TRACK_DEFINE(pc_error, PERCETTO_TRACK_EVENTS);
 PERCETTO_TRACK_DEFINE(pc_info, PERCETTO_TRACK_EVENTS);
@@ -47,6 +48,7 @@ u_trace_marker_setup(enum u_trace_which which)
 	I_PERCETTO_TRACK_PTR(pc_cpu)->name = "PC 1 Sleep";
 	I_PERCETTO_TRACK_PTR(pc_allotted)->name = "PC 2 Allotted time";
 	I_PERCETTO_TRACK_PTR(pc_gpu)->name = "PC 3 GPU";
+	I_PERCETTO_TRACK_PTR(pc_gpu_passes)->name = "PC 3a GPU passes";
 	I_PERCETTO_TRACK_PTR(pc_margin)->name = "PC 4 Margin";
 	I_PERCETTO_TRACK_PTR(pc_error)->name = "PC 5 Error";
 	I_PERCETTO_TRACK_PTR(pc_info)->name = "PC 6 Info";
@@ -78,6 +80,7 @@ u_trace_marker_init(void)
 		PERCETTO_REGISTER_TRACK(pc_cpu);
 		PERCETTO_REGISTER_TRACK(pc_allotted);
 		PERCETTO_REGISTER_TRACK(pc_gpu);
+		PERCETTO_REGISTER_TRACK(pc_gpu_passes);
 		PERCETTO_REGISTER_TRACK(pc_margin);
 		PERCETTO_REGISTER_TRACK(pc_error);
 		PERCETTO_REGISTER_TRACK(pc_info);
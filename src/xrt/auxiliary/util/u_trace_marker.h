@@ -329,6 +329,7 @@ PERCETTO_CATEGORY_DECLARE(U_TRACE_CATEGORIES)
 PERCETTO_TRACK_DECLARE(pc_cpu);
 PERCETTO_TRACK_DECLARE(pc_allotted);
 PERCETTO_TRACK_DECLARE(pc_gpu);
+PERCETTO_TRACK_DECLARE(pc_gpu_passes);
 PERCETTO_TRACK_DECLARE(pc_margin);
 PERCETTO_TRACK_DECLARE(pc_error);
 PERCETTO_TRACK_DECLARE(pc_info);
@@ -206,6 +206,7 @@ vk_get_device_functions(struct vk_bundle *vk)
 	vk->vkCmdSetViewport                            = GET_DEV_PROC(vk, vkCmdSetViewport);
 	vk->vkCmdClearColorImage                        = GET_DEV_PROC(vk, vkCmdClearColorImage);
 	vk->vkCmdEndRenderPass                          = GET_DEV_PROC(vk, vkCmdEndRenderPass);
+	vk->vkCmdExecuteCommands                        = GET_DEV_PROC(vk, vkCmdExecuteCommands);
 	vk->vkCmdBindDescriptorSets                     = GET_DEV_PROC(vk, vkCmdBindDescriptorSets);
 	vk->vkCmdBindPipeline                           = GET_DEV_PROC(vk, vkCmdBindPipeline);
 	vk->vkCmdBindVertexBuffers                      = GET_DEV_PROC(vk, vkCmdBindVertexBuffers);
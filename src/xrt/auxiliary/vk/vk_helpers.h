@@ -326,6 +326,7 @@ struct vk_bundle
 	PFN_vkCmdSetViewport vkCmdSetViewport;
 	PFN_vkCmdClearColorImage vkCmdClearColorImage;
 	PFN_vkCmdEndRenderPass vkCmdEndRenderPass;
+	PFN_vkCmdExecuteCommands vkCmdExecuteCommands;
 	PFN_vkCmdBindDescriptorSets vkCmdBindDescriptorSets;
 	PFN_vkCmdBindPipeline vkCmdBindPipeline;
 	PFN_vkCmdBindVertexBuffers vkCmdBindVertexBuffers;
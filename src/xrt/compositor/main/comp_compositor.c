@@ -957,7 +957,20 @@ compositor_init_render_resources(struct comp_compositor *c)
 		return false;
 	}
 
-	if (!render_resources_init(&c->nr, &c->shaders, get_vk(c), c->xdev)) {
+	enum render_distortion_format distortion_format = RENDER_DISTORTION_FORMAT_FLOAT32;
+	if (c->settings.distortion_half_float) {
+		distortion_format = RENDER_DISTORTION_FORMAT_PACKED_FLOAT16;
+	}
+
+	if (!render_resources_init(&c->nr, &c->shaders, get_vk(c), c->xdev, distortion_format)) {
+		return false;
+	}
+
+	if (c->settings.visibility_cull) {
+		render_resources_visibility_init(&c->nr, c->xdev);
+	}
+
+	if (c->settings.parallel_record && !render_resources_parallel_init(&c->nr, c->xdev->hmd->view_count)) {
 		return false;
 	}
 
@@ -1188,5 +1201,11 @@ comp_main_create_system_compositor(struct xrt_device *xdev,
 	assert(xret == XRT_SUCCESS && upaf != NULL);
 	(void)xret;
 
-	return comp_multi_create_system_compositor(&c->base.base, upaf, sys_info, !c->deferred_surface, out_xsysc);
+	return comp_multi_create_system_compositor( //
+	    &c->base.base,                          //
+	    upaf,                                   //
+	    sys_info,                               //
+	    !c->deferred_surface,                   //
+	    &comp_base_swapchain_pool_funcs,        //
+	    out_xsysc);                             //
 }
@@ -302,6 +302,12 @@ comp_mirror_init(struct comp_mirror_to_debug_gui *m,
 
 	VK_NAME_COMMAND_POOL(vk, m->cmd_pool.pool, "comp_mirror_to_debug_gui command pool");
 
+	// Only the blit is timed.
+	if (!render_timing_init(&m->timing, vk, 1)) {
+		comp_mirror_fini(m, vk);
+		return VK_ERROR_INITIALIZATION_FAILED;
+	}
+
 	struct vk_descriptor_pool_info blit_pool_info = {
 	    .uniform_per_descriptor_count = 0,
 	    .sampler_per_descriptor_count = 1,
@@ -464,6 +470,15 @@ comp_mirror_do_blit(struct comp_mirror_to_debug_gui *m,
 
 	VK_NAME_COMMAND_BUFFER(vk, cmd, "comp_mirror_to_debug_ui command buffer");
 
+	render_timing_reset(&m->timing, vk, cmd);
+
+	uint32_t scope = render_timing_begin( //
+	    &m->timing,                       //
+	    vk,                               //
+	    cmd,                              //
+	    RENDER_TIMING_PASS_BLIT,          //
+	    RENDER_TIMING_NO_LAYER);          //
+
 	// Barrier arguments.
 	VkImageSubresourceRange first_color_level_subresource_range = {
 	    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
@@ -622,6 +637,8 @@ comp_mirror_do_blit(struct comp_mirror_to_debug_gui *m,
 	    VK_PIPELINE_STAGE_HOST_BIT,           // dstStageMask
 	    first_color_level_subresource_range); // subresourceRange
 
+	render_timing_end(&m->timing, vk, cmd, scope);
+
 	// This takes a long time so make sure to trace it.
 	COMP_TRACE_BEGIN(submit_and_wait);
 
@@ -655,7 +672,7 @@ comp_mirror_do_blit(struct comp_mirror_to_debug_gui *m,
 
 	// Tidies the descriptor we created.
 	vk->vkResetDescriptorPool(vk->device, m->blit.descriptor_pool, 0);
-	return XRT_ERROR_VULKAN;
+	return XRT_SUCCESS;
 }
 
 void
@@ -675,6 +692,9 @@ comp_mirror_fini(struct comp_mirror_to_debug_gui *m, struct vk_bundle *vk)
 	// Command pool for readback code.
 	vk_cmd_pool_destroy(vk, &m->cmd_pool);
 
+	// Blit timing query pool.
+	render_timing_fini(&m->timing, vk);
+
 	// Destroy blit shader Vulkan resources.
 	D(Pipeline, m->blit.pipeline);
 	D(PipelineLayout, m->blit.pipeline_layout);
@@ -73,6 +73,9 @@ struct comp_mirror_to_debug_gui
 	} blit;
 
 	struct vk_cmd_pool cmd_pool;
+
+	//! Times the blit, read back by the renderer after @ref comp_mirror_do_blit.
+	struct render_timing timing;
 };
 
 /*!
@@ -27,9 +27,13 @@
 #include "util/u_distortion_mesh.h"
 #include "util/u_sink.h"
 #include "util/u_var.h"
+#include "util/u_metrics.h"
 #include "util/u_frame_times_widget.h"
+#include "util/u_wait.h"
 
 #include "util/comp_render.h"
+#include "util/comp_layer_cache.h"
+#include "util/comp_dynamic_resolution.h"
 
 #include "main/comp_frame.h"
 #include "main/comp_mirror_to_debug_gui.h"
@@ -116,6 +120,43 @@ struct comp_renderer
 		} views[XRT_MAX_VIEWS];
 	} scratch;
 
+	//! Cache of static layers for the graphics layer squasher.
+	struct comp_layer_cache layer_cache;
+
+	//! Is @ref layer_cache initialized and used.
+	bool layer_cache_enabled;
+
+	//! GPU time of each pass of the last frame, shown in the debug UI.
+	struct render_timing_results gpu_timing;
+
+	//! Picks how much of the scratch images to render to.
+	struct comp_dynamic_resolution dynres;
+
+	/*!
+	 * Squashes the layers as soon as the frame begins, then sleeps and
+	 * late-latches the poses for the distortion just before present, see
+	 * @ref comp_settings::late_warp. Both stages run on the render thread,
+	 * which already has realtime priority.
+	 */
+	struct
+	{
+		//! Is the two stage mode used, only by the graphics path.
+		bool enabled;
+
+		//! Sleeps until the late warp should start.
+		struct os_precise_sleeper sleeper;
+
+		//! Signaled when the layer squashing is done on the GPU.
+		VkFence squash_fence;
+
+		//! GPU time of the layer squashing of the last frame, zero if not squashed early.
+		uint64_t squash_gpu_ns;
+
+		//! How far ahead of display the poses were sampled, shown in the debug UI.
+		float squash_pose_ms;
+		float distortion_pose_ms;
+	} late_warp;
+
 	//! @}
 
 	//! @name Image-dependent members
@@ -551,6 +592,32 @@ renderer_ensure_images_and_renderings(struct comp_renderer *r, bool force_recrea
 	return true;
 }
 
+static bool
+renderer_late_warp_init(struct comp_renderer *r)
+{
+	struct vk_bundle *vk = &r->c->base.vk;
+
+	VkFenceCreateInfo fence_info = {
+	    .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+	};
+
+	VkResult ret = vk->vkCreateFence( //
+	    vk->device,                   //
+	    &fence_info,                  //
+	    NULL,                         //
+	    &r->late_warp.squash_fence);  //
+	if (ret != VK_SUCCESS) {
+		COMP_ERROR(r->c, "vkCreateFence: %s", vk_result_string(ret));
+		return false;
+	}
+
+	VK_NAME_FENCE(vk, r->late_warp.squash_fence, "Comp Renderer squash");
+
+	os_precise_sleeper_init(&r->late_warp.sleeper);
+
+	return true;
+}
+
 //! Create renderer and initialize non-image-dependent members
 static void
 renderer_init(struct comp_renderer *r, struct comp_compositor *c, VkExtent2D scratch_extent)
@@ -592,6 +659,22 @@ renderer_init(struct comp_renderer *r, struct comp_compositor *c, VkExtent2D scr
 		}
 	}
 
+	/*
+	 * Only the graphics path can squash more than once per view and frame.
+	 * The squasher picks the swapchain of a projection layer by left and
+	 * right, so the cache is limited to two views.
+	 */
+	if (!r->settings->use_compute && r->settings->layer_cache && c->nr.view_count <= 2) {
+		r->layer_cache_enabled = comp_layer_cache_init( //
+		    &r->layer_cache,                            //
+		    &r->c->nr,                                  //
+		    &r->scratch_render_pass,                    //
+		    scratch_extent);                            //
+		if (!r->layer_cache_enabled) {
+			COMP_ERROR(c, "comp_layer_cache_init: false, layer cache disabled");
+		}
+	}
+
 	// Try to early-allocate these, in case we can.
 	renderer_ensure_images_and_renderings(r, false);
 
@@ -606,6 +689,25 @@ renderer_init(struct comp_renderer *r, struct comp_compositor *c, VkExtent2D scr
 		COMP_ERROR(c, "comp_mirror_init: %s", vk_result_string(ret));
 		assert(false && "Whelp, can't return a error. But should never really fail.");
 	}
+
+	// Both are enabled if the device supports timestamps.
+	c->nr.timing.enabled = c->nr.timing.enabled && r->settings->gpu_timing;
+	r->mirror_to_debug_gui.timing.enabled = r->mirror_to_debug_gui.timing.enabled && r->settings->gpu_timing;
+
+	// The scratch images are already full size, levels only pick a region of them.
+	comp_dynamic_resolution_init(                         //
+	    &r->dynres,                                       //
+	    r->settings->dynamic_resolution,                  // enabled
+	    (float)r->settings->dynamic_resolution_min_scale, // min_scale
+	    COMP_DYNAMIC_RESOLUTION_MAX_LEVELS);              // level_count
+
+	if (r->settings->late_warp) {
+		if (r->settings->use_compute) {
+			COMP_WARN(c, "Late warp is only supported by the graphics path, not using it.");
+		} else {
+			r->late_warp.enabled = renderer_late_warp_init(r);
+		}
+	}
 }
 
 static void
@@ -816,6 +918,18 @@ renderer_fini(struct comp_renderer *r)
 {
 	struct vk_bundle *vk = &r->c->base.vk;
 
+	// Remove u_var roots as early as possible.
+	u_var_remove_root(&r->gpu_timing);
+	u_var_remove_root(&r->dynres);
+	u_var_remove_root(&r->late_warp);
+
+	if (r->late_warp.enabled) {
+		os_precise_sleeper_deinit(&r->late_warp.sleeper);
+		vk->vkDestroyFence(vk->device, r->late_warp.squash_fence, NULL);
+		r->late_warp.squash_fence = VK_NULL_HANDLE;
+		r->late_warp.enabled = false;
+	}
+
 	// Command buffers
 	renderer_close_renderings_and_fences(r);
 
@@ -829,6 +943,12 @@ renderer_fini(struct comp_renderer *r)
 		}
 	}
 
+	// Uses the scratch render pass.
+	if (r->layer_cache_enabled) {
+		comp_layer_cache_fini(&r->layer_cache);
+		r->layer_cache_enabled = false;
+	}
+
 	// Do this after the layer renderer and targert resources.
 	render_gfx_render_pass_fini(&r->scratch_render_pass);
 }
@@ -836,27 +956,161 @@ renderer_fini(struct comp_renderer *r)
 
 /*
  *
- * Graphics
+ * GPU timing.
  *
  */
 
+static const char *
+renderer_timing_pass_name(enum render_timing_pass pass)
+{
+	switch (pass) {
+	case RENDER_TIMING_PASS_LAYERS: return "layers";
+	case RENDER_TIMING_PASS_DISTORTION: return "distortion";
+	case RENDER_TIMING_PASS_CLEAR: return "clear";
+	case RENDER_TIMING_PASS_BLIT: return "blit";
+	default: return "unknown";
+	}
+}
+
+static void
+renderer_trace_gpu_timing(struct render_timing *rt, const struct render_timing_results *res, int64_t frame_id)
+{
+#ifdef U_TRACE_PERCETTO // Uses Percetto specific things.
+	if (!U_TRACE_CATEGORY_IS_ENABLED(timing) || !res->has_host_times) {
+		return;
+	}
+
+	for (uint32_t i = 0; i < rt->scope_count; i++) {
+		uint64_t start_ns = res->host_ns[i][0];
+		uint64_t end_ns = res->host_ns[i][1];
+		if (start_ns == 0 || end_ns < start_ns) {
+			continue;
+		}
+
+		const char *name = renderer_timing_pass_name(rt->scopes[i].pass);
+		U_TRACE_EVENT_BEGIN_ON_TRACK_DATA(timing, pc_gpu_passes, start_ns, name, PERCETTO_I(frame_id));
+		U_TRACE_EVENT_END_ON_TRACK(timing, pc_gpu_passes, end_ns);
+	}
+#else
+	(void)rt;
+	(void)res;
+	(void)frame_id;
+#endif
+}
+
 /*!
- * @pre render_gfx_init(render, &c->nr)
+ * Reads back the per pass timestamps of the frame, the GPU must be idle. The
+ * mirror blit has its own query pool as it is submitted separately.
  */
-static XRT_CHECK_RESULT VkResult
-dispatch_graphics(struct comp_renderer *r,
-                  struct render_gfx *render,
-                  struct comp_render_scratch_state *crss,
-                  enum comp_target_fov_source fov_source)
+static bool
+renderer_get_gpu_timing(struct comp_renderer *r, int64_t frame_id, bool did_blit)
 {
 	COMP_TRACE_MARKER();
 
 	struct comp_compositor *c = r->c;
 	struct vk_bundle *vk = &c->base.vk;
-	VkResult ret;
+	struct render_timing_results *res = &r->gpu_timing;
+
+	if (!c->nr.timing.enabled) {
+		return false;
+	}
+
+	if (!render_timing_get_results(&c->nr.timing, vk, res)) {
+		return false;
+	}
+
+	renderer_trace_gpu_timing(&c->nr.timing, res, frame_id);
+
+	struct render_timing *blit_rt = &r->mirror_to_debug_gui.timing;
+	if (did_blit && blit_rt->enabled) {
+		struct render_timing_results blit_res;
+		if (render_timing_get_results(blit_rt, vk, &blit_res)) {
+			renderer_trace_gpu_timing(blit_rt, &blit_res, frame_id);
+
+			res->pass_ns[RENDER_TIMING_PASS_BLIT] = blit_res.pass_ns[RENDER_TIMING_PASS_BLIT];
+			res->total_ns += blit_res.total_ns;
+		}
+	}
+
+	return true;
+}
+
+/*!
+ * Feeds the GPU time of the frame to the dynamic resolution controller, only
+ * frames where layers were squashed into the scratch images are affected by
+ * the scale so only those count.
+ */
+static void
+renderer_update_dynamic_resolution(struct comp_renderer *r, bool scratch_used)
+{
+	struct comp_compositor *c = r->c;
+
+	if (!scratch_used) {
+		return;
+	}
+
+	uint64_t gpu_ns = 0;
+	if (!render_resources_get_duration(&c->nr, &gpu_ns)) {
+		return;
+	}
+
+	// When warping late the timestamps only cover the distortion.
+	gpu_ns += r->late_warp.squash_gpu_ns;
+
+	uint64_t budget_ns = (uint64_t)((double)c->frame_interval_ns * r->settings->dynamic_resolution_budget);
+
+	if (comp_dynamic_resolution_update(&r->dynres, gpu_ns, budget_ns)) {
+		COMP_DEBUG(c, "Scratch scale now %.3f", comp_dynamic_resolution_get_scale(&r->dynres));
+	}
+}
+
+static void
+renderer_write_gpu_metrics(struct comp_renderer *r, int64_t frame_id, bool have_timing, float scratch_scale)
+{
+	if (!u_metrics_is_active() || (!have_timing && !r->dynres.enabled)) {
+		return;
+	}
+
+	struct u_metrics_system_gpu_passes umgp = {
+	    .frame_id = frame_id,
+	    .scratch_scale = scratch_scale,
+	};
+
+	if (have_timing) {
+		const struct render_timing_results *res = &r->gpu_timing;
+		umgp.layers_ns = res->pass_ns[RENDER_TIMING_PASS_LAYERS];
+		umgp.distortion_ns = res->pass_ns[RENDER_TIMING_PASS_DISTORTION];
+		umgp.clear_ns = res->pass_ns[RENDER_TIMING_PASS_CLEAR];
+		umgp.blit_ns = res->pass_ns[RENDER_TIMING_PASS_BLIT];
+		umgp.total_ns = res->total_ns;
+	}
+
+	u_metrics_write_system_gpu_passes(&umgp);
+}
+
+
+/*
+ *
+ * Graphics
+ *
+ */
+
+/*!
+ * Samples the view poses and fills in the dispatch data for the graphics path,
+ * the scratch images are picked by @p crss.
+ */
+static void
+fill_gfx_dispatch_data(struct comp_renderer *r,
+                       struct render_gfx *render,
+                       struct comp_render_scratch_state *crss,
+                       enum comp_target_fov_source fov_source,
+                       struct comp_render_dispatch_data *data)
+{
+	COMP_TRACE_MARKER();
+
+	struct comp_compositor *c = r->c;
 
 	// Basics
-	const struct comp_layer *layers = c->base.layer_accum.layers;
 	uint32_t layer_count = c->base.layer_accum.layer_count;
 	bool fast_path = c->base.frame_params.one_projection_layer_fast_path;
 	bool do_timewarp = !c->debug.atw_off;
@@ -889,12 +1143,14 @@ dispatch_graphics(struct comp_renderer *r,
 
 
 	// The arguments for the dispatch function.
-	struct comp_render_dispatch_data data;
 	comp_render_gfx_initial_init( //
-	    &data,                    // data
+	    data,                     // data
 	    rtr,                      // rtr
 	    fast_path,                // fast_path
 	    do_timewarp);             // do_timewarp
+	if (r->layer_cache_enabled) {
+		data->gfx.layer_cache = &r->layer_cache;
+	}
 	for (uint32_t i = 0; i < render->r->view_count; i++) {
 		// Which image of the scratch images for this view are we using.
 		uint32_t scratch_index = crss->views[i].index;
@@ -908,19 +1164,18 @@ dispatch_graphics(struct comp_renderer *r,
 		// Scratch color image.
 		struct render_scratch_color_image *rsci = &scratch_view->images[scratch_index];
 
-		// Use the whole scratch image.
-		struct render_viewport_data layer_viewport_data = {
-		    .x = 0,
-		    .y = 0,
-		    .w = scratch_view->info.width,
-		    .h = scratch_view->info.height,
-		};
-
-		// Scratch image covers the whole image.
-		struct xrt_normalized_rect layer_norm_rect = {.x = 0.0f, .y = 0.0f, .w = 1.0f, .h = 1.0f};
+		// Only render to and sample from the part of the scratch image picked by the scale.
+		VkExtent2D scratch_extent = {scratch_view->info.width, scratch_view->info.height};
+		struct render_viewport_data layer_viewport_data;
+		struct xrt_normalized_rect layer_norm_rect;
+		comp_dynamic_resolution_get_region( //
+		    &r->dynres,                     //
+		    scratch_extent,                 //
+		    &layer_viewport_data,           //
+		    &layer_norm_rect);              //
 
 		comp_render_gfx_add_view( //
-		    &data,                //
+		    data,                 //
 		    &world_poses[i],      //
 		    &eye_poses[i],        //
 		    &fovs[i],             //
@@ -938,6 +1193,208 @@ dispatch_graphics(struct comp_renderer *r,
 			crss->views[i].used = !fast_path;
 		}
 	}
+}
+
+//! How far ahead of the predicted display time poses sampled at @p sampled_ns are.
+static float
+pose_ahead_ms(struct comp_renderer *r, int64_t sampled_ns)
+{
+	return (float)time_ns_to_ms_f(r->c->frame.rendering.predicted_display_time_ns - sampled_ns);
+}
+
+/*!
+ * Submits the layer squashing of a frame that is warped late, it signals
+ * nothing but the squash fence as the late warp waits on that.
+ */
+static XRT_CHECK_RESULT VkResult
+renderer_submit_squash(struct comp_renderer *r, VkCommandBuffer cmd)
+{
+	COMP_TRACE_MARKER();
+
+	struct vk_bundle *vk = &r->c->base.vk;
+	int64_t frame_id = r->c->frame.rendering.id;
+	VkResult ret;
+
+	ret = vk->vkResetFences(vk->device, 1, &r->late_warp.squash_fence);
+	VK_CHK_AND_RET(ret, "vkResetFences");
+
+	VkSubmitInfo submit_info = {
+	    .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+	    .commandBufferCount = 1,
+	    .pCommandBuffers = &cmd,
+	};
+
+	// Same as in renderer_submit_queue, only the render thread uses the pool.
+	ret = vk_cmd_submit_locked(vk, 1, &submit_info, r->late_warp.squash_fence);
+
+	// Mark even if we failed, so the frame timing stays in order.
+	comp_target_mark_squash_submit_end(r->c->target, frame_id, os_monotonic_get_ns());
+
+	VK_CHK_AND_RET(ret, "vk_cmd_submit_locked");
+
+	return ret;
+}
+
+/*!
+ * Sleeps until the target wants the late warp to start, then samples new poses
+ * and records and submits the distortion. If @p squashed_poses is NULL the
+ * layers were not squashed and the whole dispatch is done here.
+ *
+ * @pre render_gfx_init(render, &c->nr)
+ */
+static XRT_CHECK_RESULT VkResult
+renderer_late_warp(struct comp_renderer *r,
+                   struct render_gfx *render,
+                   struct comp_render_scratch_state *crss,
+                   enum comp_target_fov_source fov_source,
+                   const struct xrt_pose *squashed_poses)
+{
+	COMP_TRACE_MARKER();
+
+	struct comp_compositor *c = r->c;
+	struct comp_target *ct = c->target;
+	struct vk_bundle *vk = &c->base.vk;
+	bool squashed = squashed_poses != NULL;
+	int64_t frame_id = c->frame.rendering.id;
+	VkResult ret;
+
+	int64_t wake_up_time_ns = 0;
+	comp_target_calc_late_warp_pacing(ct, frame_id, &wake_up_time_ns);
+
+	u_wait_until(&r->late_warp.sleeper, (uint64_t)wake_up_time_ns);
+
+	comp_target_mark_late_warp_wake_up(ct, frame_id, os_monotonic_get_ns());
+
+	if (squashed) {
+		ret = vk->vkWaitForFences(vk->device, 1, &r->late_warp.squash_fence, VK_TRUE, UINT64_MAX);
+		VK_CHK_AND_RET(ret, "vkWaitForFences");
+
+		// Read before the late warp restarts the timestamps.
+		if (!render_resources_get_duration(&c->nr, &r->late_warp.squash_gpu_ns)) {
+			r->late_warp.squash_gpu_ns = 0;
+		}
+	}
+
+	// As late as possible, this is what the late warp is all about.
+	int64_t sampled_ns = os_monotonic_get_ns();
+	struct comp_render_dispatch_data data;
+	fill_gfx_dispatch_data(r, render, crss, fov_source, &data);
+	r->late_warp.distortion_pose_ms = pose_ahead_ms(r, sampled_ns);
+
+	if (squashed) {
+		render_gfx_begin_late(render);
+
+		comp_render_gfx_late_warp( //
+		    render,                //
+		    squashed_poses,        //
+		    &data);                //
+	} else {
+		// Fast path or nothing to squash, only distortion or clearing to do.
+		render_gfx_begin(render);
+
+		comp_render_gfx_dispatch(            //
+		    render,                          //
+		    c->base.layer_accum.layers,      //
+		    c->base.layer_accum.layer_count, //
+		    &data);                          //
+	}
+
+	render_gfx_end(render);
+
+	ret = renderer_submit_queue(r, render->r->cmd, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+	VK_CHK_AND_RET(ret, "renderer_submit_queue");
+
+	return ret;
+}
+
+/*!
+ * Squashes the layers and submits them straight away, so the GPU works on them
+ * while the render thread sleeps, then late-latches the poses for the warp.
+ *
+ * @pre render_gfx_init(render, &c->nr)
+ */
+static XRT_CHECK_RESULT VkResult
+dispatch_graphics_late_warp(struct comp_renderer *r,
+                            struct render_gfx *render,
+                            struct comp_render_scratch_state *crss,
+                            enum comp_target_fov_source fov_source)
+{
+	COMP_TRACE_MARKER();
+
+	struct comp_compositor *c = r->c;
+	struct vk_bundle *vk = &c->base.vk;
+	VkResult ret;
+
+	// Basics
+	const struct comp_layer *layers = c->base.layer_accum.layers;
+	uint32_t layer_count = c->base.layer_accum.layer_count;
+	bool fast_path = c->base.frame_params.one_projection_layer_fast_path;
+
+	// The fast path reads the app images directly, so there is nothing to squash.
+	bool squash = layer_count > 0 && !fast_path;
+
+	r->late_warp.squash_gpu_ns = 0;
+
+	struct xrt_pose squashed_poses[XRT_MAX_VIEWS];
+
+	if (squash) {
+		int64_t sampled_ns = os_monotonic_get_ns();
+		struct comp_render_dispatch_data data;
+		fill_gfx_dispatch_data(r, render, crss, fov_source, &data);
+		r->late_warp.squash_pose_ms = pose_ahead_ms(r, sampled_ns);
+
+		render_gfx_begin(render);
+
+		comp_render_gfx_squash( //
+		    render,             //
+		    layers,             //
+		    layer_count,        //
+		    &data);             //
+
+		render_gfx_end(render);
+
+		ret = renderer_submit_squash(r, render->r->cmd);
+		VK_CHK_AND_RET(ret, "renderer_submit_squash");
+
+		for (uint32_t i = 0; i < data.view_count; i++) {
+			squashed_poses[i] = data.views[i].world_pose;
+		}
+	} else {
+		r->late_warp.squash_pose_ms = 0.0f;
+	}
+
+	return renderer_late_warp(r, render, crss, fov_source, squash ? squashed_poses : NULL);
+}
+
+/*!
+ * @pre render_gfx_init(render, &c->nr)
+ */
+static XRT_CHECK_RESULT VkResult
+dispatch_graphics(struct comp_renderer *r,
+                  struct render_gfx *render,
+                  struct comp_render_scratch_state *crss,
+                  enum comp_target_fov_source fov_source)
+{
+	COMP_TRACE_MARKER();
+
+	struct comp_compositor *c = r->c;
+	struct vk_bundle *vk = &c->base.vk;
+	VkResult ret;
+
+	if (r->late_warp.enabled) {
+		return dispatch_graphics_late_warp(r, render, crss, fov_source);
+	}
+
+	// Basics
+	const struct comp_layer *layers = c->base.layer_accum.layers;
+	uint32_t layer_count = c->base.layer_accum.layer_count;
+
+	// The arguments for the dispatch function.
+	int64_t sampled_ns = os_monotonic_get_ns();
+	struct comp_render_dispatch_data data;
+	fill_gfx_dispatch_data(r, render, crss, fov_source, &data);
+	r->late_warp.distortion_pose_ms = pose_ahead_ms(r, sampled_ns);
+	r->late_warp.squash_pose_ms = r->late_warp.distortion_pose_ms;
 
 	// Start the graphics pipeline.
 	render_gfx_begin(render);
@@ -1026,16 +1483,15 @@ dispatch_compute(struct comp_renderer *r,
 		// Scratch color image.
 		struct render_scratch_color_image *rsci = &scratch_view->images[scratch_index];
 
-		// Use the whole scratch image.
-		struct render_viewport_data layer_viewport_data = {
-		    .x = 0,
-		    .y = 0,
-		    .w = scratch_view->info.width,
-		    .h = scratch_view->info.height,
-		};
-
-		// Scratch image covers the whole image.
-		struct xrt_normalized_rect layer_norm_rect = {.x = 0.0f, .y = 0.0f, .w = 1.0f, .h = 1.0f};
+		// Only render to and sample from the part of the scratch image picked by the scale.
+		VkExtent2D scratch_extent = {scratch_view->info.width, scratch_view->info.height};
+		struct render_viewport_data layer_viewport_data;
+		struct xrt_normalized_rect layer_norm_rect;
+		comp_dynamic_resolution_get_region( //
+		    &r->dynres,                     //
+		    scratch_extent,                 //
+		    &layer_viewport_data,           //
+		    &layer_norm_rect);              //
 
 		comp_render_cs_add_view(  //
 		    &data,                //
@@ -1188,6 +1644,7 @@ comp_renderer_draw(struct comp_renderer *r)
 	comp_frame_clear_locked(&c->frame.rendering);
 
 	xrt_result_t xret = XRT_SUCCESS;
+	bool did_blit = false;
 	comp_mirror_fixup_ui_state(&r->mirror_to_debug_gui, c);
 	if (comp_mirror_is_ready_and_active(&r->mirror_to_debug_gui, c, predicted_display_time_ns)) {
 
@@ -1198,8 +1655,11 @@ comp_renderer_draw(struct comp_renderer *r)
 		// Used for both, want clamp to edge to no bring in black.
 		VkSampler clamp_to_edge = c->nr.samplers.clamp_to_edge;
 
-		// Covers the whole view.
-		struct xrt_normalized_rect rect = {0, 0, 1.0f, 1.0f};
+		// The part of the view that was rendered to.
+		VkExtent2D scratch_extent = {view->info.width, view->info.height};
+		struct render_viewport_data unused;
+		struct xrt_normalized_rect rect;
+		comp_dynamic_resolution_get_region(&r->dynres, scratch_extent, &unused, &rect);
 
 		xret = comp_mirror_do_blit(    //
 		    &r->mirror_to_debug_gui,   //
@@ -1211,6 +1671,7 @@ comp_renderer_draw(struct comp_renderer *r)
 		    clamp_to_edge,             //
 		    extent,                    //
 		    rect);                     //
+		did_blit = xret == XRT_SUCCESS;
 	}
 
 	/*
@@ -1236,6 +1697,15 @@ comp_renderer_draw(struct comp_renderer *r)
 			uint64_t now_ns = os_monotonic_get_ns();
 			comp_target_info_gpu(ct, frame_id, gpu_start_ns, gpu_end_ns, now_ns);
 		}
+
+		// Per pass timings.
+		bool have_timing = renderer_get_gpu_timing(r, frame_id, did_blit);
+
+		// Scale used by this frame, before the next one is picked.
+		float scratch_scale = comp_dynamic_resolution_get_scale(&r->dynres);
+		renderer_update_dynamic_resolution(r, crss.views[0].used);
+
+		renderer_write_gpu_metrics(r, frame_id, have_timing, scratch_scale);
 	}
 
 
@@ -1318,4 +1788,28 @@ comp_renderer_add_debug_vars(struct comp_renderer *self)
 	struct comp_renderer *r = self;
 
 	comp_mirror_add_debug_vars(&r->mirror_to_debug_gui, r->c);
+
+	struct render_timing_results *res = &r->gpu_timing;
+	u_var_add_root(res, "Compositor GPU timing", false);
+	u_var_add_ro_u64(res, &res->pass_ns[RENDER_TIMING_PASS_LAYERS], "Layers (ns)");
+	u_var_add_ro_u64(res, &res->pass_ns[RENDER_TIMING_PASS_DISTORTION], "Distortion (ns)");
+	u_var_add_ro_u64(res, &res->pass_ns[RENDER_TIMING_PASS_CLEAR], "Clear (ns)");
+	u_var_add_ro_u64(res, &res->pass_ns[RENDER_TIMING_PASS_BLIT], "Mirror blit (ns)");
+	u_var_add_ro_u64(res, &res->total_ns, "Total (ns)");
+	u_var_add_ro_u32(res, &res->scope_count, "Scopes");
+	u_var_add_ro_u32(res, &res->dropped_count, "Dropped scopes");
+
+	struct comp_dynamic_resolution *cdr = &r->dynres;
+	u_var_add_root(cdr, "Compositor dynamic resolution", false);
+	u_var_add_bool(cdr, &cdr->enabled, "Enabled");
+	u_var_add_ro_f32(cdr, &cdr->stats.scale, "Scale");
+	u_var_add_ro_f32(cdr, &cdr->stats.gpu_ms, "GPU time (ms)");
+	u_var_add_ro_f32(cdr, &cdr->stats.budget_ms, "Budget (ms)");
+	u_var_add_ro_u64(cdr, &cdr->stats.scale_downs, "Scaled down");
+	u_var_add_ro_u64(cdr, &cdr->stats.scale_ups, "Scaled up");
+
+	u_var_add_root(&r->late_warp, "Compositor late warp", false);
+	u_var_add_ro_f32(&r->late_warp, &r->late_warp.squash_pose_ms, "Squash pose ahead of display (ms)");
+	u_var_add_ro_f32(&r->late_warp, &r->late_warp.distortion_pose_ms, "Distortion pose ahead of display (ms)");
+	u_var_add_ro_u64(&r->late_warp, &r->late_warp.squash_gpu_ns, "Squash GPU (ns)");
 }
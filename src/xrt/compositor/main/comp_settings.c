@@ -30,6 +30,15 @@ DEBUG_GET_ONCE_BOOL_OPTION(xcb_fullscreen, "XRT_COMPOSITOR_XCB_FULLSCREEN", fals
 DEBUG_GET_ONCE_NUM_OPTION(xcb_display, "XRT_COMPOSITOR_XCB_DISPLAY", -1)
 DEBUG_GET_ONCE_NUM_OPTION(default_framerate, "XRT_COMPOSITOR_DEFAULT_FRAMERATE", 60)
 DEBUG_GET_ONCE_BOOL_OPTION(compute, "XRT_COMPOSITOR_COMPUTE", USE_COMPUTE_DEFAULT)
+DEBUG_GET_ONCE_BOOL_OPTION(layer_cache, "XRT_COMPOSITOR_LAYER_CACHE", true)
+DEBUG_GET_ONCE_BOOL_OPTION(gpu_timing, "XRT_COMPOSITOR_GPU_TIMING", true)
+DEBUG_GET_ONCE_BOOL_OPTION(dynamic_resolution, "XRT_COMPOSITOR_DYNAMIC_RESOLUTION", false)
+DEBUG_GET_ONCE_NUM_OPTION(dynamic_resolution_min, "XRT_COMPOSITOR_DYNAMIC_RESOLUTION_MIN_PERCENTAGE", 50)
+DEBUG_GET_ONCE_NUM_OPTION(dynamic_resolution_budget, "XRT_COMPOSITOR_DYNAMIC_RESOLUTION_BUDGET_PERCENTAGE", 40)
+DEBUG_GET_ONCE_BOOL_OPTION(distortion_half_float, "XRT_COMPOSITOR_DISTORTION_HALF_FLOAT", false)
+DEBUG_GET_ONCE_TRISTATE_OPTION(parallel_record, "XRT_COMPOSITOR_PARALLEL_RECORD")
+DEBUG_GET_ONCE_BOOL_OPTION(late_warp, "XRT_COMPOSITOR_LATE_WARP", false)
+DEBUG_GET_ONCE_BOOL_OPTION(visibility_cull, "XRT_COMPOSITOR_VISIBILITY_CULL", true)
 // clang-format on
 
 static inline void
@@ -65,6 +74,24 @@ comp_settings_init(struct comp_settings *s, struct xrt_device *xdev)
 	}
 
 	s->use_compute = debug_get_bool_option_compute();
+	s->layer_cache = debug_get_bool_option_layer_cache();
+	s->gpu_timing = debug_get_bool_option_gpu_timing();
+	s->dynamic_resolution = debug_get_bool_option_dynamic_resolution();
+	s->dynamic_resolution_min_scale = debug_get_num_option_dynamic_resolution_min() / 100.0;
+	s->dynamic_resolution_budget = debug_get_num_option_dynamic_resolution_budget() / 100.0;
+	s->distortion_half_float = debug_get_bool_option_distortion_half_float();
+	s->late_warp = debug_get_bool_option_late_warp();
+	s->visibility_cull = debug_get_bool_option_visibility_cull();
+
+	enum debug_tristate_option parallel_record = debug_get_tristate_option_parallel_record();
+	if (parallel_record == DEBUG_TRISTATE_OFF) {
+		s->parallel_record = false;
+	} else if (parallel_record == DEBUG_TRISTATE_ON) {
+		s->parallel_record = true;
+	} else {
+		// Only worth handing off to threads with more than two views.
+		s->parallel_record = xdev->hmd->view_count > 2;
+	}
 
 	if (s->use_compute) {
 		// This was the default before, keep it first.
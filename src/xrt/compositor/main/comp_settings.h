@@ -49,6 +49,33 @@ struct comp_settings
 
 	bool use_compute;
 
+	//! Cache static layers when squashing, only used by the graphics path.
+	bool layer_cache;
+
+	//! Write per pass GPU timestamps, reported through u_var, metrics and tracing.
+	bool gpu_timing;
+
+	//! Lower the resolution layers are squashed at when the GPU is over budget.
+	bool dynamic_resolution;
+
+	//! Store the compute distortion images as packed half float offsets.
+	bool distortion_half_float;
+
+	//! Record the layer squashing of each view on its own thread, only used by the graphics path.
+	bool parallel_record;
+
+	//! Squash layers early and late-latch the poses for the warp before present, only used by the graphics path.
+	bool late_warp;
+
+	//! Skip shading the parts of the views that the device visibility mask hides.
+	bool visibility_cull;
+
+	//! Smallest scale of each axis for @ref dynamic_resolution.
+	double dynamic_resolution_min_scale;
+
+	//! GPU time budget for @ref dynamic_resolution, fraction of the frame interval.
+	double dynamic_resolution_budget;
+
 	VkFormat formats[XRT_MAX_SWAPCHAIN_FORMATS];
 	uint32_t format_count;
 
@@ -40,6 +40,12 @@ enum comp_target_timing_point
 
 	//! Just after submitting work to the GPU.
 	COMP_TARGET_TIMING_POINT_SUBMIT_END,
+
+	//! Just after submitting the layer squashing to the GPU, when warping late.
+	COMP_TARGET_TIMING_POINT_SQUASH_SUBMIT_END,
+
+	//! The late warp woke up after sleeping, when warping late.
+	COMP_TARGET_TIMING_POINT_LATE_WARP_WAKE_UP,
 };
 
 /*!
@@ -247,6 +253,13 @@ struct comp_target
 	                          int64_t *out_present_slop_ns,
 	                          int64_t *out_predicted_display_time_ns);
 
+	/*!
+	 * Predict when the late warp of the frame should wake up to sample the
+	 * head pose, only used when the compositor squashes the layers early
+	 * and warps them on a separate thread just before present.
+	 */
+	void (*calc_late_warp_pacing)(struct comp_target *ct, int64_t frame_id, int64_t *out_wake_up_time_ns);
+
 	/*!
 	 * The compositor tells the target a timing information about a single
 	 * timing point on the frames lifecycle.
@@ -476,6 +489,20 @@ comp_target_calc_frame_pacing(struct comp_target *ct,
 	    out_predicted_display_time_ns); //
 }
 
+/*!
+ * @copydoc comp_target::calc_late_warp_pacing
+ *
+ * @public @memberof comp_target
+ * @ingroup comp_main
+ */
+static inline void
+comp_target_calc_late_warp_pacing(struct comp_target *ct, int64_t frame_id, int64_t *out_wake_up_time_ns)
+{
+	COMP_TRACE_MARKER();
+
+	ct->calc_late_warp_pacing(ct, frame_id, out_wake_up_time_ns);
+}
+
 /*!
  * Quick helper for marking wake up.
  * @copydoc comp_target::mark_timing_point
@@ -536,6 +563,36 @@ comp_target_mark_submit_end(struct comp_target *ct, int64_t frame_id, int64_t wh
 	ct->mark_timing_point(ct, COMP_TARGET_TIMING_POINT_SUBMIT_END, frame_id, when_submit_end_ns);
 }
 
+/*!
+ * Quick helper for marking the layer squashing submit end.
+ * @copydoc comp_target::mark_timing_point
+ *
+ * @public @memberof comp_target
+ * @ingroup comp_main
+ */
+static inline void
+comp_target_mark_squash_submit_end(struct comp_target *ct, int64_t frame_id, int64_t when_submit_end_ns)
+{
+	COMP_TRACE_MARKER();
+
+	ct->mark_timing_point(ct, COMP_TARGET_TIMING_POINT_SQUASH_SUBMIT_END, frame_id, when_submit_end_ns);
+}
+
+/*!
+ * Quick helper for marking the late warp wake up.
+ * @copydoc comp_target::mark_timing_point
+ *
+ * @public @memberof comp_target
+ * @ingroup comp_main
+ */
+static inline void
+comp_target_mark_late_warp_wake_up(struct comp_target *ct, int64_t frame_id, int64_t when_woke_ns)
+{
+	COMP_TRACE_MARKER();
+
+	ct->mark_timing_point(ct, COMP_TARGET_TIMING_POINT_LATE_WARP_WAKE_UP, frame_id, when_woke_ns);
+}
+
 /*!
  * @copydoc comp_target::update_timings
  *
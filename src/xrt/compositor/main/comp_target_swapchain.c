@@ -47,6 +47,12 @@
  */
 DEBUG_GET_ONCE_NUM_OPTION(preferred_at_least_image_count, "XRT_COMPOSITOR_PREFERRED_IMAGE_COUNT", 2)
 
+/*!
+ * Fit the vblanks and the compositor frame times when pacing from display
+ * timing, see @ref u_pc_display_timing_config::fit_model.
+ */
+DEBUG_GET_ONCE_BOOL_OPTION(pacing_model, "XRT_COMPOSITOR_PACING_MODEL", false)
+
 static inline struct vk_bundle *
 get_vk(struct comp_target_swapchain *cts)
 {
@@ -644,7 +650,9 @@ comp_target_swapchain_create_images(struct comp_target *ct, const struct comp_ta
 	// Some platforms really don't like the pacing_compositor code.
 	bool use_display_timing_if_available = cts->timing_usage == COMP_TARGET_USE_DISPLAY_IF_AVAILABLE;
 	if (cts->upc == NULL && use_display_timing_if_available && vk->has_GOOGLE_display_timing) {
-		u_pc_display_timing_create(ct->c->frame_interval_ns, &U_PC_DISPLAY_TIMING_CONFIG_DEFAULT, &cts->upc);
+		struct u_pc_display_timing_config config = U_PC_DISPLAY_TIMING_CONFIG_DEFAULT;
+		config.fit_model = debug_get_bool_option_pacing_model();
+		u_pc_display_timing_create(ct->c->frame_interval_ns, &config, &cts->upc);
 	} else if (cts->upc == NULL) {
 		u_pc_fake_create(ct->c->frame_interval_ns, now_ns, &cts->upc);
 	}
@@ -969,6 +977,15 @@ comp_target_swapchain_calc_frame_pacing(struct comp_target *ct,
 	*out_present_slop_ns = present_slop_ns;
 }
 
+static void
+comp_target_swapchain_calc_late_warp_pacing(struct comp_target *ct, int64_t frame_id, int64_t *out_wake_up_time_ns)
+{
+	struct comp_target_swapchain *cts = (struct comp_target_swapchain *)ct;
+	assert(frame_id == cts->current_frame_id);
+
+	u_pc_predict_late_warp(cts->upc, frame_id, out_wake_up_time_ns);
+}
+
 static void
 comp_target_swapchain_mark_timing_point(struct comp_target *ct,
                                         enum comp_target_timing_point point,
@@ -991,6 +1008,12 @@ comp_target_swapchain_mark_timing_point(struct comp_target *ct,
 	case COMP_TARGET_TIMING_POINT_SUBMIT_END:
 		u_pc_mark_point(cts->upc, U_TIMING_POINT_SUBMIT_END, cts->current_frame_id, when_ns);
 		break;
+	case COMP_TARGET_TIMING_POINT_SQUASH_SUBMIT_END:
+		u_pc_mark_point(cts->upc, U_TIMING_POINT_SQUASH_SUBMIT_END, cts->current_frame_id, when_ns);
+		break;
+	case COMP_TARGET_TIMING_POINT_LATE_WARP_WAKE_UP:
+		u_pc_mark_point(cts->upc, U_TIMING_POINT_LATE_WARP_WAKE_UP, cts->current_frame_id, when_ns);
+		break;
 	default: assert(false);
 	}
 }
@@ -1091,6 +1114,7 @@ comp_target_swapchain_init_and_set_fnptrs(struct comp_target_swapchain *cts,
 	cts->base.acquire = comp_target_swapchain_acquire_next_image;
 	cts->base.present = comp_target_swapchain_present;
 	cts->base.calc_frame_pacing = comp_target_swapchain_calc_frame_pacing;
+	cts->base.calc_late_warp_pacing = comp_target_swapchain_calc_late_warp_pacing;
 	cts->base.mark_timing_point = comp_target_swapchain_mark_timing_point;
 	cts->base.update_timings = comp_target_swapchain_update_timings;
 	cts->base.info_gpu = comp_target_swapchain_info_gpu;
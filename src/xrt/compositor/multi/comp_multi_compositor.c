@@ -22,6 +22,7 @@
 #include "util/u_distortion_mesh.h"
 
 #include "multi/comp_multi_private.h"
+#include "multi/comp_multi_interface.h"
 
 #include <math.h>
 #include <stdio.h>
@@ -423,6 +424,10 @@ multi_compositor_create_swapchain(struct xrt_compositor *xc,
 
 	struct multi_compositor *mc = multi_compositor(xc);
 
+	if (mc->swapchain_pool != NULL) {
+		return mc->msc->pool_funcs->create_swapchain(mc->msc->xcn, mc->swapchain_pool, info, out_xsc);
+	}
+
 	return xrt_comp_create_swapchain(&mc->msc->xcn->base, info, out_xsc);
 }
 
@@ -905,6 +910,11 @@ multi_compositor_destroy(struct xrt_compositor *xc)
 	// Does null checking.
 	u_pa_destroy(&mc->upa);
 
+	// Swapchains still alive hold their own reference to the pool.
+	if (mc->swapchain_pool != NULL) {
+		mc->msc->pool_funcs->unref(mc->msc->xcn, &mc->swapchain_pool);
+	}
+
 	os_precise_sleeper_deinit(&mc->frame_sleeper);
 	os_precise_sleeper_deinit(&mc->scheduled_sleeper);
 
@@ -1015,6 +1025,15 @@ multi_compositor_create(struct multi_system_compositor *msc,
 	// This is safe to do without a lock since we are not on the list yet.
 	u_paf_create(msc->upaf, &mc->upa);
 
+	// Each client gets its own pool so images never cross between clients.
+	if (msc->pool_funcs != NULL) {
+		xrt_result_t xret = msc->pool_funcs->create(msc->xcn, &mc->swapchain_pool);
+		if (xret != XRT_SUCCESS) {
+			U_LOG_W("Failed to create swapchain pool, not pooling swapchain images for this client.");
+			mc->swapchain_pool = NULL;
+		}
+	}
+
 	os_mutex_lock(&msc->list_and_timing_lock);
 
 	// If we have too many clients, just ignore it.
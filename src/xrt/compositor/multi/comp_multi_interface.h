@@ -17,6 +17,31 @@ extern "C" {
 #endif
 
 struct u_pacing_app_factory;
+struct comp_swapchain_pool;
+
+/*!
+ * Hooks the native compositor provides so each @ref multi_compositor can own
+ * a swapchain image pool, the multi client code itself is graphics agnostic.
+ *
+ * Swapchains created from a pool hold a reference to it, so the pool lives
+ * until both the client and all of its swapchains are gone.
+ *
+ * @ingroup comp_multi
+ */
+struct comp_multi_swapchain_pool_funcs
+{
+	//! Create a pool for a new client, setting it to NULL means no pooling.
+	xrt_result_t (*create)(struct xrt_compositor_native *xcn, struct comp_swapchain_pool **out_pool);
+
+	//! Create a swapchain on @p xcn that allocates from and recycles into @p pool.
+	xrt_result_t (*create_swapchain)(struct xrt_compositor_native *xcn,
+	                                 struct comp_swapchain_pool *pool,
+	                                 const struct xrt_swapchain_create_info *info,
+	                                 struct xrt_swapchain **out_xsc);
+
+	//! Drop the client's reference to the pool and set the pointer to NULL.
+	void (*unref)(struct xrt_compositor_native *xcn, struct comp_swapchain_pool **pool_ptr);
+};
 
 
 /*!
@@ -29,6 +54,7 @@ struct u_pacing_app_factory;
  * @param upaf          App pacing factory, one pacer created per client.
  * @param xsci          Information to be exposed.
  * @param do_warm_start Should we always submit a frame at startup.
+ * @param pool_funcs    Per client swapchain pool hooks, NULL to not pool.
  * @param out_xsysc     Created @ref xrt_system_compositor.
  *
  * @public @memberof multi_system_compositor
@@ -38,6 +64,7 @@ comp_multi_create_system_compositor(struct xrt_compositor_native *xcn,
                                     struct u_pacing_app_factory *upaf,
                                     const struct xrt_system_compositor_info *xsci,
                                     bool do_warm_start,
+                                    const struct comp_multi_swapchain_pool_funcs *pool_funcs,
                                     struct xrt_system_compositor **out_xsysc);
 
 
@@ -23,6 +23,8 @@
 extern "C" {
 #endif
 
+struct comp_swapchain_pool;
+struct comp_multi_swapchain_pool_funcs;
 
 /*!
  * Number of max active clients.
@@ -185,6 +187,9 @@ struct multi_compositor
 
 	struct u_pacing_app *upa;
 
+	//! Swapchain image pool owned by this client, NULL if not pooling.
+	struct comp_swapchain_pool *swapchain_pool;
+
 	float current_refresh_rate_hz;
 };
 
@@ -336,6 +341,9 @@ struct multi_system_compositor
 	 */
 	struct u_pacing_app_factory *upaf;
 
+	//! Hooks for per client swapchain pools, NULL if not pooling.
+	const struct comp_multi_swapchain_pool_funcs *pool_funcs;
+
 	//! Render loop thread.
 	struct os_thread_helper oth;
 
@@ -675,6 +675,35 @@ system_compositor_notify_display_refresh_changed(struct xrt_system_compositor *x
 	return multi_compositor_push_event(mc, &xse);
 }
 
+static xrt_result_t
+system_compositor_get_frame_stats(struct xrt_system_compositor *xsc,
+                                  struct xrt_compositor *xc,
+                                  struct xrt_compositor_frame_stats *out_stats)
+{
+	struct multi_system_compositor *msc = multi_system_compositor(xsc);
+	struct multi_compositor *mc = multi_compositor(xc);
+
+	struct u_pacing_app_stats stats;
+
+	// Same lock as all other app pacer calls.
+	os_mutex_lock(&msc->list_and_timing_lock);
+	u_pa_get_stats(mc->upa, &stats);
+	os_mutex_unlock(&msc->list_and_timing_lock);
+
+	*out_stats = (struct xrt_compositor_frame_stats){
+	    .delivered_count = stats.delivered_count,
+	    .discarded_count = stats.discarded_count,
+	    .missed_count = stats.missed_count,
+	    .frame_period_ns = stats.frame_period_ns,
+	    .cpu_time_ns = stats.cpu_time_ns,
+	    .draw_time_ns = stats.draw_time_ns,
+	    .gpu_time_ns = stats.gpu_time_ns,
+	    .latch_to_display_ns = stats.latch_to_display_ns,
+	};
+
+	return XRT_SUCCESS;
+}
+
 
 /*
  *
@@ -741,6 +770,7 @@ comp_multi_create_system_compositor(struct xrt_compositor_native *xcn,
                                     struct u_pacing_app_factory *upaf,
                                     const struct xrt_system_compositor_info *xsci,
                                     bool do_warm_start,
+                                    const struct comp_multi_swapchain_pool_funcs *pool_funcs,
                                     struct xrt_system_compositor **out_xsysc)
 {
 	struct multi_system_compositor *msc = U_TYPED_CALLOC(struct multi_system_compositor);
@@ -752,10 +782,12 @@ comp_multi_create_system_compositor(struct xrt_compositor_native *xcn,
 	msc->xmcc.notify_loss_pending = system_compositor_notify_loss_pending;
 	msc->xmcc.notify_lost = system_compositor_notify_lost;
 	msc->xmcc.notify_display_refresh_changed = system_compositor_notify_display_refresh_changed;
+	msc->xmcc.get_frame_stats = system_compositor_get_frame_stats;
 	msc->base.xmcc = &msc->xmcc;
 	msc->base.info = *xsci;
 	msc->upaf = upaf;
 	msc->xcn = xcn;
+	msc->pool_funcs = pool_funcs;
 	msc->sessions.active_count = 0;
 	msc->sessions.state = do_warm_start ? MULTI_SYSTEM_STATE_INIT_WARM_START : MULTI_SYSTEM_STATE_STOPPED;
 
@@ -42,6 +42,7 @@ static const uint64_t MAX_VIEW_WIDTH = 1920;
 static const uint64_t MAX_VIEW_HEIGHT = 1080;
 
 DEBUG_GET_ONCE_LOG_OPTION(log, "XRT_COMPOSITOR_LOG", U_LOGGING_INFO)
+DEBUG_GET_ONCE_NUM_OPTION(frame_rate, "XRT_COMPOSITOR_NULL_FRAME_RATE", 20)
 
 
 /*
@@ -548,9 +549,15 @@ null_compositor_create_system(struct xrt_device *xdev, struct xrt_system_composi
 	c->settings.log_level = debug_get_log_option_log();
 	c->frame.waited.id = -1;
 	c->frame.rendering.id = -1;
-	c->settings.frame_interval_ns = U_TIME_1S_IN_NS / 20; // 20 FPS
 	c->xdev = xdev;
 
+	// Defaults to 20 FPS, benchmarks want something closer to a real headset.
+	long frame_rate = debug_get_num_option_frame_rate();
+	if (frame_rate <= 0) {
+		frame_rate = 20;
+	}
+	c->settings.frame_interval_ns = (uint64_t)(U_TIME_1S_IN_NS / frame_rate);
+
 	NULL_DEBUG(c, "Doing init %p", (void *)c);
 
 	NULL_INFO(c,
@@ -590,5 +597,11 @@ null_compositor_create_system(struct xrt_device *xdev, struct xrt_system_composi
 	XRT_MAYBE_UNUSED xrt_result_t xret = u_pa_factory_create(&upaf);
 	assert(xret == XRT_SUCCESS && upaf != NULL);
 
-	return comp_multi_create_system_compositor(&c->base.base, upaf, &c->sys_info, false, out_xsysc);
+	return comp_multi_create_system_compositor( //
+	    &c->base.base,                          //
+	    upaf,                                   //
+	    &c->sys_info,                           //
+	    false,                                  //
+	    &comp_base_swapchain_pool_funcs,        //
+	    out_xsysc);                             //
 }
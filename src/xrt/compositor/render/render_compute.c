@@ -171,8 +171,14 @@ update_compute_shared_descriptor_set(struct vk_bundle *vk,
 
 	VkDescriptorImageInfo distortion_image_info[3 * XRT_MAX_VIEWS];
 	for (uint32_t i = 0; i < 3 * view_count; ++i) {
+		// The packed format leaves the last images unused, alias the first ones to keep all descriptors valid.
+		VkImageView image_view = distortion_image_views[i];
+		if (image_view == VK_NULL_HANDLE) {
+			image_view = distortion_image_views[i % view_count];
+		}
+
 		distortion_image_info[i].sampler = distortion_samplers[i];
-		distortion_image_info[i].imageView = distortion_image_views[i];
+		distortion_image_info[i].imageView = image_view;
 		distortion_image_info[i].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 	}
 
@@ -343,6 +349,8 @@ render_compute_begin(struct render_compute *render)
 	    0,                     // firstQuery
 	    2);                    // queryCount
 
+	render_timing_reset(&render->r->timing, vk, render->r->cmd);
+
 	vk->vkCmdWriteTimestamp(               //
 	    render->r->cmd,                    //
 	    VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, // pipelineStage
@@ -488,6 +496,7 @@ render_compute_projection_timewarp(struct render_compute *render,
 		data->pre_transforms[i] = r->distortion.uv_to_tanangle[i];
 		data->transforms[i] = time_warp_matrix[i];
 		data->post_transforms[i] = src_norm_rects[i];
+		data->visibility[i] = r->visibility.spans[i];
 	}
 
 	/*
@@ -611,6 +620,7 @@ render_compute_projection(struct render_compute *render,
 	for (uint32_t i = 0; i < render->r->view_count; ++i) {
 		data->views[i] = views[i];
 		data->post_transforms[i] = src_norm_rects[i];
+		data->visibility[i] = r->visibility.spans[i];
 	}
 
 
@@ -17,6 +17,8 @@
 
 #include "render/render_interface.h"
 
+#include <string.h>
+
 
 /*
  *
@@ -24,14 +26,91 @@
  *
  */
 
+/*!
+ * Rounds to nearest even, too large values become infinity and too small zero.
+ */
+static uint16_t
+float_to_half(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+
+	uint32_t sign = (bits >> 16) & 0x8000;
+	uint32_t float_exponent = (bits >> 23) & 0xff;
+	uint32_t mantissa = bits & 0x7fffff;
+	int32_t exponent = (int32_t)float_exponent - 127 + 15;
+
+	// NaN and infinity.
+	if (float_exponent == 0xff) {
+		return (uint16_t)(sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0));
+	}
+
+	if (exponent >= 31) {
+		return (uint16_t)(sign | 0x7c00);
+	}
+
+	// Smaller than half of the smallest subnormal.
+	if (exponent < -10) {
+		return (uint16_t)sign;
+	}
+
+	uint32_t shift = 13;
+	uint32_t half = 0;
+
+	if (exponent <= 0) {
+		// Subnormal, the implicit one becomes part of the mantissa.
+		mantissa |= 0x800000;
+		shift = (uint32_t)(14 - exponent);
+	} else {
+		half = (uint32_t)exponent << 10;
+	}
+
+	half |= mantissa >> shift;
+
+	// A carry into the exponent is still correctly rounded, even to infinity.
+	uint32_t rest = mantissa & ((1u << shift) - 1);
+	uint32_t halfway = 1u << (shift - 1);
+	if (rest > halfway || (rest == halfway && (half & 1) != 0)) {
+		half++;
+	}
+
+	return (uint16_t)(sign | half);
+}
+
+//! Number of images per view, the packed format leaves the last group unused.
+static uint32_t
+get_group_count(enum render_distortion_format format)
+{
+	return format == RENDER_DISTORTION_FORMAT_PACKED_FLOAT16 ? 2 : 3;
+}
+
+//! Format and size of a texel of the images in @p group, see @ref render_distortion_format.
+static void
+get_group_format(enum render_distortion_format format,
+                 uint32_t group,
+                 VkFormat *out_format,
+                 VkDeviceSize *out_texel_size)
+{
+	if (format != RENDER_DISTORTION_FORMAT_PACKED_FLOAT16) {
+		*out_format = VK_FORMAT_R32G32_SFLOAT;
+		*out_texel_size = sizeof(float) * 2;
+	} else if (group == 0) {
+		*out_format = VK_FORMAT_R16G16B16A16_SFLOAT;
+		*out_texel_size = sizeof(uint16_t) * 4;
+	} else {
+		*out_format = VK_FORMAT_R16G16_SFLOAT;
+		*out_texel_size = sizeof(uint16_t) * 2;
+	}
+}
+
 XRT_CHECK_RESULT static VkResult
 create_distortion_image_and_view(struct vk_bundle *vk,
                                  VkExtent2D extent,
+                                 VkFormat format,
                                  VkDeviceMemory *out_device_memory,
                                  VkImage *out_image,
                                  VkImageView *out_image_view)
 {
-	VkFormat format = VK_FORMAT_R32G32_SFLOAT;
 	VkImage image = VK_NULL_HANDLE;
 	VkDeviceMemory device_memory = VK_NULL_HANDLE;
 	VkImageView image_view = VK_NULL_HANDLE;
@@ -144,6 +223,7 @@ create_and_queue_upload_locked(struct vk_bundle *vk,
                                struct vk_cmd_pool *pool,
                                VkCommandBuffer cmd,
                                VkBuffer src_buffer,
+                               VkFormat format,
                                VkDeviceMemory *out_image_device_memory,
                                VkImage *out_image,
                                VkImageView *out_image_view)
@@ -157,6 +237,7 @@ create_and_queue_upload_locked(struct vk_bundle *vk,
 	ret = create_distortion_image_and_view( //
 	    vk,                                 // vk_bundle
 	    extent,                             // extent
+	    format,                             // format
 	    &device_memory,                     // out_device_memory
 	    &image,                             // out_image
 	    &image_view);                       // out_image_view
@@ -184,6 +265,18 @@ struct texture
 	struct xrt_vec2 pixels[RENDER_DISTORTION_IMAGE_DIMENSIONS][RENDER_DISTORTION_IMAGE_DIMENSIONS];
 };
 
+//! Red and green offsets of @ref RENDER_DISTORTION_FORMAT_PACKED_FLOAT16.
+struct half_texture_rg
+{
+	uint16_t pixels[RENDER_DISTORTION_IMAGE_DIMENSIONS][RENDER_DISTORTION_IMAGE_DIMENSIONS][4];
+};
+
+//! Blue offsets of @ref RENDER_DISTORTION_FORMAT_PACKED_FLOAT16.
+struct half_texture_b
+{
+	uint16_t pixels[RENDER_DISTORTION_IMAGE_DIMENSIONS][RENDER_DISTORTION_IMAGE_DIMENSIONS][2];
+};
+
 struct tan_angles_transforms
 {
 	struct xrt_vec2 offset;
@@ -193,14 +286,14 @@ struct tan_angles_transforms
 XRT_CHECK_RESULT static VkResult
 create_and_fill_in_distortion_buffer_for_view(struct vk_bundle *vk,
                                               struct xrt_device *xdev,
-                                              struct render_buffer *r_buffer,
-                                              struct render_buffer *g_buffer,
-                                              struct render_buffer *b_buffer,
+                                              enum render_distortion_format format,
+                                              struct render_buffer *buffers[3],
                                               uint32_t view,
                                               bool pre_rotate)
 {
 	VkBufferUsageFlags usage_flags = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
 	VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+	uint32_t group_count = get_group_count(format);
 	VkResult ret;
 
 	struct xrt_matrix_2x2 rot = xdev->hmd->views[view].rot;
@@ -217,28 +310,21 @@ create_and_fill_in_distortion_buffer_for_view(struct vk_bundle *vk,
 		m_mat2x2_multiply(&rot, &rotation_90_cw, &rot);
 	}
 
-	VkDeviceSize size = sizeof(struct texture);
-
-	ret = render_buffer_init(vk, r_buffer, usage_flags, properties, size);
-	VK_CHK_WITH_GOTO(ret, "render_buffer_init", err_buffers);
-	VK_NAME_BUFFER(vk, r_buffer->buffer, "distortion r_buffer");
-	ret = render_buffer_init(vk, g_buffer, usage_flags, properties, size);
-	VK_CHK_WITH_GOTO(ret, "render_buffer_init", err_buffers);
-	VK_NAME_BUFFER(vk, g_buffer->buffer, "distortion g_buffer");
-	ret = render_buffer_init(vk, b_buffer, usage_flags, properties, size);
-	VK_CHK_WITH_GOTO(ret, "render_buffer_init", err_buffers);
-	VK_NAME_BUFFER(vk, b_buffer->buffer, "distortion b_buffer");
-
-	ret = render_buffer_map(vk, r_buffer);
-	VK_CHK_WITH_GOTO(ret, "render_buffer_map", err_buffers);
-	ret = render_buffer_map(vk, g_buffer);
-	VK_CHK_WITH_GOTO(ret, "render_buffer_map", err_buffers);
-	ret = render_buffer_map(vk, b_buffer);
-	VK_CHK_WITH_GOTO(ret, "render_buffer_map", err_buffers);
-
-	struct texture *r = r_buffer->mapped;
-	struct texture *g = g_buffer->mapped;
-	struct texture *b = b_buffer->mapped;
+	for (uint32_t i = 0; i < group_count; i++) {
+		VkFormat unused;
+		VkDeviceSize texel_size;
+		get_group_format(format, i, &unused, &texel_size);
+
+		VkDeviceSize texel_count = RENDER_DISTORTION_IMAGE_DIMENSIONS * RENDER_DISTORTION_IMAGE_DIMENSIONS;
+		VkDeviceSize size = texel_size * texel_count;
+
+		ret = render_buffer_init(vk, buffers[i], usage_flags, properties, size);
+		VK_CHK_WITH_GOTO(ret, "render_buffer_init", err_buffers);
+		VK_NAME_BUFFER(vk, buffers[i]->buffer, "distortion buffer");
+
+		ret = render_buffer_map(vk, buffers[i]);
+		VK_CHK_WITH_GOTO(ret, "render_buffer_map", err_buffers);
+	}
 
 	const double dim_minus_one_f64 = RENDER_DISTORTION_IMAGE_DIMENSIONS - 1;
 
@@ -259,22 +345,37 @@ create_and_fill_in_distortion_buffer_for_view(struct vk_bundle *vk,
 			struct xrt_uv_triplet result;
 			xrt_device_compute_distortion(xdev, view, uv.x, uv.y, &result);
 
-			r->pixels[row][col] = result.r;
-			g->pixels[row][col] = result.g;
-			b->pixels[row][col] = result.b;
+			if (format == RENDER_DISTORTION_FORMAT_PACKED_FLOAT16) {
+				// Offsets are from where the texel is in the image, not the rotated position.
+				struct xrt_vec2 grid_uv = {u, v};
+				struct half_texture_rg *rg = buffers[0]->mapped;
+				struct half_texture_b *b = buffers[1]->mapped;
+				render_distortion_pack_half( //
+				    &result,                 // result
+				    &grid_uv,                // grid_uv
+				    rg->pixels[row][col],    // out_rg
+				    b->pixels[row][col]);    // out_b
+			} else {
+				struct texture *r = buffers[0]->mapped;
+				struct texture *g = buffers[1]->mapped;
+				struct texture *b = buffers[2]->mapped;
+				r->pixels[row][col] = result.r;
+				g->pixels[row][col] = result.g;
+				b->pixels[row][col] = result.b;
+			}
 		}
 	}
 
-	render_buffer_unmap(vk, r_buffer);
-	render_buffer_unmap(vk, g_buffer);
-	render_buffer_unmap(vk, b_buffer);
+	for (uint32_t i = 0; i < group_count; i++) {
+		render_buffer_unmap(vk, buffers[i]);
+	}
 
 	return VK_SUCCESS;
 
 err_buffers:
-	render_buffer_fini(vk, r_buffer);
-	render_buffer_fini(vk, g_buffer);
-	render_buffer_fini(vk, b_buffer);
+	for (uint32_t i = 0; i < group_count; i++) {
+		render_buffer_fini(vk, buffers[i]);
+	}
 
 	return ret;
 }
@@ -285,13 +386,17 @@ render_distortion_buffer_init(struct render_resources *r,
                               struct xrt_device *xdev,
                               bool pre_rotate)
 {
-	struct render_buffer bufs[RENDER_DISTORTION_IMAGES_SIZE];
-	VkDeviceMemory device_memories[RENDER_DISTORTION_IMAGES_SIZE];
-	VkImage images[RENDER_DISTORTION_IMAGES_SIZE];
-	VkImageView image_views[RENDER_DISTORTION_IMAGES_SIZE];
+	enum render_distortion_format format = r->distortion.format;
+	struct render_buffer bufs[RENDER_DISTORTION_IMAGES_SIZE] = {0};
+	VkDeviceMemory device_memories[RENDER_DISTORTION_IMAGES_SIZE] = {0};
+	VkImage images[RENDER_DISTORTION_IMAGES_SIZE] = {0};
+	VkImageView image_views[RENDER_DISTORTION_IMAGES_SIZE] = {0};
 	VkCommandBuffer upload_buffer = VK_NULL_HANDLE;
 	VkResult ret;
 
+	// Only the used groups, unused images are left as VK_NULL_HANDLE.
+	uint32_t image_count = get_group_count(format) * r->view_count;
+
 
 	/*
 	 * Basics
@@ -305,10 +410,16 @@ render_distortion_buffer_init(struct render_resources *r,
 	 * Buffers with data to upload.
 	 * view_count=2,RRGGBB
 	 * view_count=3,RRRGGGBBB
+	 * Packed: view_count=2,(RG)(RG)BB
 	 */
 	for (uint32_t i = 0; i < r->view_count; ++i) {
-		ret = create_and_fill_in_distortion_buffer_for_view(vk, xdev, &bufs[i], &bufs[r->view_count + i],
-		                                                    &bufs[2 * r->view_count + i], i, pre_rotate);
+		struct render_buffer *view_bufs[3] = {
+		    &bufs[i],
+		    &bufs[r->view_count + i],
+		    &bufs[2 * r->view_count + i],
+		};
+
+		ret = create_and_fill_in_distortion_buffer_for_view(vk, xdev, format, view_bufs, i, pre_rotate);
 		VK_CHK_WITH_GOTO(ret, "create_and_fill_in_distortion_buffer_for_view", err_resources);
 	}
 
@@ -324,12 +435,17 @@ render_distortion_buffer_init(struct render_resources *r,
 	VK_CHK_WITH_GOTO(ret, "vk_cmd_pool_create_and_begin_cmd_buffer_locked", err_unlock);
 	VK_NAME_COMMAND_BUFFER(vk, upload_buffer, "render_resources distortion command buffer");
 
-	for (uint32_t i = 0; i < RENDER_DISTORTION_IMAGES_COUNT(r); i++) {
+	for (uint32_t i = 0; i < image_count; i++) {
+		VkFormat image_format;
+		VkDeviceSize unused;
+		get_group_format(format, i / r->view_count, &image_format, &unused);
+
 		ret = create_and_queue_upload_locked( //
 		    vk,                               // vk_bundle
 		    pool,                             // pool
 		    upload_buffer,                    // cmd
 		    bufs[i].buffer,                   // src_buffer
+		    image_format,                     // format
 		    &device_memories[i],              // out_image_device_memory
 		    &images[i],                       // out_image
 		    &image_views[i]);                 // out_image_view
@@ -389,6 +505,20 @@ err_resources:
  *
  */
 
+void
+render_distortion_pack_half(const struct xrt_uv_triplet *result,
+                            const struct xrt_vec2 *grid_uv,
+                            uint16_t out_rg[4],
+                            uint16_t out_b[2])
+{
+	out_rg[0] = float_to_half(result->r.x - grid_uv->x);
+	out_rg[1] = float_to_half(result->r.y - grid_uv->y);
+	out_rg[2] = float_to_half(result->g.x - grid_uv->x);
+	out_rg[3] = float_to_half(result->g.y - grid_uv->y);
+	out_b[0] = float_to_half(result->b.x - grid_uv->x);
+	out_b[1] = float_to_half(result->b.y - grid_uv->y);
+}
+
 void
 render_distortion_images_fini(struct render_resources *r)
 {
@@ -39,6 +39,40 @@ vk_from_render(struct render_gfx *render)
 	return render->r->vk;
 }
 
+/*!
+ * Begins the command buffer, resets the frame timestamps and writes the first.
+ */
+static bool
+begin_cmd_and_timestamp(struct render_gfx *render)
+{
+	struct vk_bundle *vk = vk_from_render(render);
+	VkResult ret;
+
+	VkCommandBufferBeginInfo begin_info = {
+	    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+	    .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+	};
+
+	ret = vk->vkBeginCommandBuffer( //
+	    render->r->cmd,             //
+	    &begin_info);               //
+	VK_CHK_WITH_RET(ret, "vkBeginCommandBuffer", false);
+
+	vk->vkCmdResetQueryPool(   //
+	    render->r->cmd,        //
+	    render->r->query_pool, //
+	    0,                     // firstQuery
+	    2);                    // queryCount
+
+	vk->vkCmdWriteTimestamp(               //
+	    render->r->cmd,                    //
+	    VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, // pipelineStage
+	    render->r->query_pool,             //
+	    0);                                // query
+
+	return true;
+}
+
 XRT_CHECK_RESULT static VkResult
 create_implicit_render_pass(struct vk_bundle *vk,
                             VkFormat format,
@@ -151,7 +185,8 @@ begin_render_pass(struct vk_bundle *vk,
                   VkFramebuffer framebuffer,
                   uint32_t width,
                   uint32_t height,
-                  const VkClearColorValue *color)
+                  const VkClearColorValue *color,
+                  VkSubpassContents contents)
 {
 	VkClearValue clear_color[1] = {{
 	    .color = *color,
@@ -178,7 +213,7 @@ begin_render_pass(struct vk_bundle *vk,
 	    .pClearValues = clear_color,
 	};
 
-	vk->vkCmdBeginRenderPass(command_buffer, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
+	vk->vkCmdBeginRenderPass(command_buffer, &render_pass_begin_info, contents);
 }
 
 /// Update descriptor set for a layer to reference the parameter UBO and the source (layer) image.
@@ -301,7 +336,7 @@ dispatch_no_vbo(struct render_gfx *render, uint32_t vertex_count, VkPipeline pip
 
 	VkDescriptorSet descriptor_sets[1] = {descriptor_set};
 	vk->vkCmdBindDescriptorSets(             //
-	    r->cmd,                              //
+	    render->cmd,                         //
 	    VK_PIPELINE_BIND_POINT_GRAPHICS,     // pipelineBindPoint
 	    r->gfx.layer.shared.pipeline_layout, // layout
 	    0,                                   // firstSet
@@ -311,14 +346,14 @@ dispatch_no_vbo(struct render_gfx *render, uint32_t vertex_count, VkPipeline pip
 	    NULL);                               // pDynamicOffsets
 
 	vk->vkCmdBindPipeline(               //
-	    r->cmd,                          //
+	    render->cmd,                     //
 	    VK_PIPELINE_BIND_POINT_GRAPHICS, // pipelineBindPoint
 	    pipeline);                       //
 
 	// This pipeline doesn't have any VBO input or indices.
 
 	vk->vkCmdDraw(    //
-	    r->cmd,       //
+	    render->cmd,  //
 	    vertex_count, // vertexCount
 	    1,            // instanceCount
 	    0,            // firstVertex
@@ -961,6 +996,7 @@ render_gfx_init(struct render_gfx *render, struct render_resources *r)
 {
 	// Init fields.
 	render->r = r;
+	render->cmd = r->cmd;
 
 	// Used to sub-allocate UBOs from, restart from scratch each frame.
 	render_sub_alloc_tracker_init(&render->ubo_tracker, &r->gfx.shared_ubo);
@@ -977,30 +1013,33 @@ render_gfx_begin(struct render_gfx *render)
 	ret = vk->vkResetCommandPool(vk->device, render->r->cmd_pool, 0);
 	VK_CHK_WITH_RET(ret, "vkResetCommandPool", false);
 
+	// Frees the secondary command buffers of the last frame, no tasks are running.
+	for (uint32_t i = 0; i < render->r->parallel.cmd_pool_count; i++) {
+		ret = vk->vkResetCommandPool(vk->device, render->r->parallel.cmd_pools[i].pool, 0);
+		VK_CHK_WITH_RET(ret, "vkResetCommandPool", false);
+	}
 
-	VkCommandBufferBeginInfo begin_info = {
-	    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-	    .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
-	};
+	if (!begin_cmd_and_timestamp(render)) {
+		return false;
+	}
 
-	ret = vk->vkBeginCommandBuffer( //
-	    render->r->cmd,             //
-	    &begin_info);               //
-	VK_CHK_WITH_RET(ret, "vkResetCommandPool", false);
+	render_timing_reset(&render->r->timing, vk, render->r->cmd);
 
-	vk->vkCmdResetQueryPool(   //
-	    render->r->cmd,        //
-	    render->r->query_pool, //
-	    0,                     // firstQuery
-	    2);                    // queryCount
+	return true;
+}
 
-	vk->vkCmdWriteTimestamp(               //
-	    render->r->cmd,                    //
-	    VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, // pipelineStage
-	    render->r->query_pool,             //
-	    0);                                // query
+bool
+render_gfx_begin_late(struct render_gfx *render)
+{
+	struct vk_bundle *vk = vk_from_render(render);
+	VkResult ret;
 
-	return true;
+	// The first command buffer has completed, the secondaries are freed by the next frame.
+	ret = vk->vkResetCommandPool(vk->device, render->r->cmd_pool, 0);
+	VK_CHK_WITH_RET(ret, "vkResetCommandPool", false);
+
+	// Timing scopes are not reset, so they cover both command buffers.
+	return begin_cmd_and_timestamp(render);
 }
 
 bool
@@ -1021,6 +1060,77 @@ render_gfx_end(struct render_gfx *render)
 	return true;
 }
 
+bool
+render_gfx_begin_secondary(struct render_gfx *sub,
+                           struct render_resources *r,
+                           struct render_gfx_target_resources *rtr,
+                           uint32_t pool_index)
+{
+	struct vk_bundle *vk = r->vk;
+	struct vk_cmd_pool *pool = &r->parallel.cmd_pools[pool_index];
+	VkCommandBuffer cmd = VK_NULL_HANDLE;
+	VkResult ret;
+
+	assert(pool_index < r->parallel.cmd_pool_count);
+
+	U_ZERO(sub);
+	sub->r = r;
+
+	VkCommandBufferAllocateInfo cmd_buffer_info = {
+	    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+	    .commandPool = pool->pool,
+	    .level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+	    .commandBufferCount = 1,
+	};
+
+	vk_cmd_pool_lock(pool);
+	ret = vk->vkAllocateCommandBuffers( //
+	    vk->device,                     // device
+	    &cmd_buffer_info,               // pAllocateInfo
+	    &cmd);                          // pCommandBuffers
+	vk_cmd_pool_unlock(pool);
+	VK_CHK_WITH_RET(ret, "vkAllocateCommandBuffers", false);
+
+	// Continues the first subpass of the render pass begun on the primary.
+	VkCommandBufferInheritanceInfo inheritance_info = {
+	    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+	    .renderPass = rtr->rgrp->render_pass,
+	    .subpass = 0,
+	    .framebuffer = rtr->framebuffer,
+	};
+
+	VkCommandBufferBeginInfo begin_info = {
+	    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+	    .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+	    .pInheritanceInfo = &inheritance_info,
+	};
+
+	ret = vk->vkBeginCommandBuffer( //
+	    cmd,                        //
+	    &begin_info);               //
+	VK_CHK_WITH_RET(ret, "vkBeginCommandBuffer", false);
+
+	sub->cmd = cmd;
+	sub->rtr = rtr;
+
+	return true;
+}
+
+bool
+render_gfx_end_secondary(struct render_gfx *sub)
+{
+	struct vk_bundle *vk = vk_from_render(sub);
+	VkResult ret;
+
+	assert(sub->rtr != NULL);
+	sub->rtr = NULL;
+
+	ret = vk->vkEndCommandBuffer(sub->cmd);
+	VK_CHK_WITH_RET(ret, "vkEndCommandBuffer", false);
+
+	return true;
+}
+
 void
 render_gfx_fini(struct render_gfx *render)
 {
@@ -1058,18 +1168,59 @@ render_gfx_begin_target(struct render_gfx *render,
 	VkFramebuffer framebuffer = rtr->framebuffer;
 	VkExtent2D extent = rtr->extent;
 
-	begin_render_pass(  //
-	    vk,             //
-	    render->r->cmd, //
-	    render_pass,    //
-	    framebuffer,    //
-	    extent.width,   //
-	    extent.height,  //
-	    color);         //
+	begin_render_pass(               //
+	    vk,                          //
+	    render->cmd,                 //
+	    render_pass,                 //
+	    framebuffer,                 //
+	    extent.width,                //
+	    extent.height,               //
+	    color,                       //
+	    VK_SUBPASS_CONTENTS_INLINE); // contents
+
+	return true;
+}
+
+bool
+render_gfx_begin_target_secondaries(struct render_gfx *render,
+                                    struct render_gfx_target_resources *rtr,
+                                    const VkClearColorValue *color)
+{
+	struct vk_bundle *vk = vk_from_render(render);
+
+	assert(render->rtr == NULL);
+	render->rtr = rtr;
+
+	VkRenderPass render_pass = rtr->rgrp->render_pass;
+	VkFramebuffer framebuffer = rtr->framebuffer;
+	VkExtent2D extent = rtr->extent;
+
+	begin_render_pass(                                  //
+	    vk,                                             //
+	    render->cmd,                                    //
+	    render_pass,                                    //
+	    framebuffer,                                    //
+	    extent.width,                                   //
+	    extent.height,                                  //
+	    color,                                          //
+	    VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS); // contents
 
 	return true;
 }
 
+void
+render_gfx_execute_secondary(struct render_gfx *render, VkCommandBuffer cmd)
+{
+	struct vk_bundle *vk = vk_from_render(render);
+
+	assert(render->rtr != NULL);
+
+	vk->vkCmdExecuteCommands( //
+	    render->cmd,          // commandBuffer
+	    1,                    // commandBufferCount
+	    &cmd);                // pCommandBuffers
+}
+
 void
 render_gfx_end_target(struct render_gfx *render)
 {
@@ -1079,7 +1230,7 @@ render_gfx_end_target(struct render_gfx *render)
 	render->rtr = NULL;
 
 	// Stop the [shared] render pass.
-	vk->vkCmdEndRenderPass(render->r->cmd);
+	vk->vkCmdEndRenderPass(render->cmd);
 }
 
 void
@@ -1087,8 +1238,7 @@ render_gfx_begin_view(struct render_gfx *render, uint32_t view, const struct ren
 {
 	struct vk_bundle *vk = vk_from_render(render);
 
-	// We currently only support two views.
-	assert(view == 0 || view == 1);
+	assert(view < XRT_MAX_VIEWS);
 	assert(render->rtr != NULL);
 
 
@@ -1105,10 +1255,10 @@ render_gfx_begin_view(struct render_gfx *render, uint32_t view, const struct ren
 	    .maxDepth = 1.0f,
 	};
 
-	vk->vkCmdSetViewport(render->r->cmd, //
-	                     0,              // firstViewport
-	                     1,              // viewportCount
-	                     &viewport);     //
+	vk->vkCmdSetViewport(render->cmd, //
+	                     0,           // firstViewport
+	                     1,           // viewportCount
+	                     &viewport);  //
 
 	/*
 	 * Scissor
@@ -1127,10 +1277,10 @@ render_gfx_begin_view(struct render_gfx *render, uint32_t view, const struct ren
 	        },
 	};
 
-	vk->vkCmdSetScissor(render->r->cmd, //
-	                    0,              // firstScissor
-	                    1,              // scissorCount
-	                    &scissor);      //
+	vk->vkCmdSetScissor(render->cmd, //
+	                    0,           // firstScissor
+	                    1,           // scissorCount
+	                    &scissor);   //
 }
 
 void
@@ -1175,7 +1325,7 @@ render_gfx_mesh_draw(struct render_gfx *render, uint32_t mesh_index, VkDescripto
 
 	VkDescriptorSet descriptor_sets[1] = {descriptor_set};
 	vk->vkCmdBindDescriptorSets(         //
-	    r->cmd,                          //
+	    render->cmd,                     //
 	    VK_PIPELINE_BIND_POINT_GRAPHICS, // pipelineBindPoint
 	    r->mesh.pipeline_layout,         // layout
 	    0,                               // firstSet
@@ -1189,7 +1339,7 @@ render_gfx_mesh_draw(struct render_gfx *render, uint32_t mesh_index, VkDescripto
 	    do_timewarp ? render->rtr->rgrp->mesh.pipeline_timewarp : render->rtr->rgrp->mesh.pipeline;
 
 	vk->vkCmdBindPipeline(               //
-	    r->cmd,                          //
+	    render->cmd,                     //
 	    VK_PIPELINE_BIND_POINT_GRAPHICS, // pipelineBindPoint
 	    pipeline);                       // pipeline
 
@@ -1203,7 +1353,7 @@ render_gfx_mesh_draw(struct render_gfx *render, uint32_t mesh_index, VkDescripto
 	assert(ARRAY_SIZE(buffers) == ARRAY_SIZE(offsets));
 
 	vk->vkCmdBindVertexBuffers( //
-	    r->cmd,                 //
+	    render->cmd,            //
 	    0,                      // firstBinding
 	    ARRAY_SIZE(buffers),    // bindingCount
 	    buffers,                // pBuffers
@@ -1216,13 +1366,13 @@ render_gfx_mesh_draw(struct render_gfx *render, uint32_t mesh_index, VkDescripto
 
 	if (r->mesh.index_count_total > 0) {
 		vk->vkCmdBindIndexBuffer(  //
-		    r->cmd,                //
+		    render->cmd,           //
 		    r->mesh.ibo.buffer,    // buffer
 		    0,                     // offset
 		    VK_INDEX_TYPE_UINT32); // indexType
 
 		vk->vkCmdDrawIndexed(                  //
-		    r->cmd,                            //
+		    render->cmd,                       //
 		    r->mesh.index_counts[mesh_index],  // indexCount
 		    1,                                 // instanceCount
 		    r->mesh.index_offsets[mesh_index], // firstIndex
@@ -1230,7 +1380,7 @@ render_gfx_mesh_draw(struct render_gfx *render, uint32_t mesh_index, VkDescripto
 		    0);                                // firstInstance
 	} else {
 		vk->vkCmdDraw(            //
-		    r->cmd,               //
+		    render->cmd,          //
 		    r->mesh.vertex_count, // vertexCount
 		    1,                    // instanceCount
 		    0,                    // firstVertex
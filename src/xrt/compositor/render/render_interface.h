@@ -21,6 +21,10 @@
 extern "C" {
 #endif
 
+struct u_worker_thread_pool;
+struct u_worker_group;
+struct xrt_visibility_mask;
+
 
 /*!
  * @defgroup comp_render Compositor render code
@@ -77,7 +81,10 @@ extern "C" {
 //! Distortion image dimension in pixels
 #define RENDER_DISTORTION_IMAGE_DIMENSIONS (128)
 
-//! How many distortion images we have, one for each channel (3 rgb) and per view.
+/*!
+ * How many distortion images we have, one for each channel (3 rgb) and per
+ * view. The packed format only uses the first two per view.
+ */
 #define RENDER_DISTORTION_IMAGES_SIZE (3 * XRT_MAX_VIEWS)
 #define RENDER_DISTORTION_IMAGES_COUNT(RENDER_RESOURCES) (3 * RENDER_RESOURCES->view_count)
 
@@ -339,6 +346,339 @@ render_sub_alloc_ubo_alloc_and_write(struct vk_bundle *vk,
                                      struct render_sub_alloc *out_rsa);
 
 
+/*
+ *
+ * Distortion.
+ *
+ */
+
+/*!
+ * How the compute distortion lookup images are stored.
+ */
+enum render_distortion_format
+{
+	/*!
+	 * One RG32F image per channel and view, each holding the absolute
+	 * source UV for that channel.
+	 */
+	RENDER_DISTORTION_FORMAT_FLOAT32,
+
+	/*!
+	 * Per view one RGBA16F image holding the red and green offsets and one
+	 * RG16F image holding the blue offset. Offsets are from the position of
+	 * the texel in the image, which keeps them small enough for half
+	 * floats, so it uses half the memory and one fetch less per pixel.
+	 */
+	RENDER_DISTORTION_FORMAT_PACKED_FLOAT16,
+};
+
+/*!
+ * Packs the distortion of one texel for
+ * @ref RENDER_DISTORTION_FORMAT_PACKED_FLOAT16.
+ *
+ * @param[in]  result  Source UVs the device returned for the texel.
+ * @param[in]  grid_uv Position of the texel in the image, [0, 1] inclusive.
+ * @param[out] out_rg  Half float red and green offsets.
+ * @param[out] out_b   Half float blue offset.
+ */
+void
+render_distortion_pack_half(const struct xrt_uv_triplet *result,
+                            const struct xrt_vec2 *grid_uv,
+                            uint16_t out_rg[4],
+                            uint16_t out_b[2]);
+
+
+/*
+ *
+ * Visibility.
+ *
+ */
+
+//! Number of row bands the visible area of a view is split into.
+#define RENDER_VISIBILITY_ROWS (64)
+
+//! Number of steps across a view the visible spans are given in.
+#define RENDER_VISIBILITY_STEPS (256)
+
+/*!
+ * How far in UV the visible area is grown on all sides, covers the distance
+ * the squashed images move when warped again after squashing, by the late warp
+ * or when reusing the layer cache.
+ */
+#define RENDER_VISIBILITY_MARGIN (0.01f)
+
+/*!
+ * The part of a view that can be seen through the lens, as one visible span
+ * per row band, used to skip shading the pixels that are never seen. Spans are
+ * in the UV space of the view, the same as the scratch images, with the first
+ * band at the top.
+ *
+ * Each band is 16 bits, the first visible step in the low byte and the last
+ * visible step in the high byte, a first step after the last step means that
+ * nothing in the band is visible. Two bands are packed per value so that the
+ * array is a std140 `uvec4[8]`, see `visibility.inc.glsl`.
+ */
+struct render_visibility_spans
+{
+	uint32_t packed[RENDER_VISIBILITY_ROWS / 2];
+};
+
+/*!
+ * Makes the whole view visible, used when there is no visibility mask.
+ *
+ * @public @memberof render_visibility_spans
+ */
+void
+render_visibility_spans_init_full(struct render_visibility_spans *spans);
+
+/*!
+ * Calculates the spans from the triangles of a
+ * @ref XRT_VISIBILITY_MASK_TYPE_VISIBLE_TRIANGLE_MESH mask. Each band gets the
+ * horizontal extent of all triangles overlapping it, which is conservative,
+ * no visible pixel is ever hidden.
+ *
+ * @param[in]  mask      Visible triangle mesh, in tangent lengths of @p fov.
+ * @param[in]  fov       Fov of the view, the mask is relative to it.
+ * @param[in]  margin    How far in UV to grow the visible area on all sides.
+ * @param[out] out_spans Spans of the view, fully visible on failure.
+ *
+ * @return False if the mask has no triangles.
+ *
+ * @public @memberof render_visibility_spans
+ */
+bool
+render_visibility_spans_calc(const struct xrt_visibility_mask *mask,
+                             const struct xrt_fov *fov,
+                             float margin,
+                             struct render_visibility_spans *out_spans);
+
+/*!
+ * Is the point at @p uv hidden, same test as the shaders. Points outside of the
+ * view are never hidden, they are left to the samplers.
+ *
+ * @public @memberof render_visibility_spans
+ */
+bool
+render_visibility_spans_is_hidden(const struct render_visibility_spans *spans, const struct xrt_vec2 *uv);
+
+/*!
+ * Fraction of the view that is hidden, which is roughly how much of the
+ * shading work is skipped.
+ *
+ * @public @memberof render_visibility_spans
+ */
+float
+render_visibility_spans_hidden_fraction(const struct render_visibility_spans *spans);
+
+
+/*
+ *
+ * Timing.
+ *
+ */
+
+/*!
+ * Max number of timed scopes per frame, one per layer and view plus a few for
+ * the distortion, clear and blit passes.
+ */
+#define RENDER_TIMING_MAX_SCOPES (RENDER_MAX_LAYERS * XRT_MAX_VIEWS + 8)
+
+//! Used as layer index for scopes that are not about a single layer.
+#define RENDER_TIMING_NO_LAYER (UINT32_MAX)
+
+//! Returned by @ref render_timing_begin when the scope is not timed.
+#define RENDER_TIMING_INVALID_SCOPE (UINT32_MAX)
+
+/*!
+ * The passes that GPU time is reported for.
+ *
+ * @see render_timing
+ */
+enum render_timing_pass
+{
+	//! Drawing layers, either squashing or directly to the target.
+	RENDER_TIMING_PASS_LAYERS,
+	//! Distortion of the scratch images to the target.
+	RENDER_TIMING_PASS_DISTORTION,
+	//! Clearing the target when there is nothing to draw.
+	RENDER_TIMING_PASS_CLEAR,
+	//! Blitting to the debug mirror image.
+	RENDER_TIMING_PASS_BLIT,
+
+	RENDER_TIMING_PASS_COUNT,
+};
+
+/*!
+ * What a timed scope measured.
+ *
+ * @see render_timing
+ */
+struct render_timing_scope
+{
+	enum render_timing_pass pass;
+
+	//! Index of the layer being drawn, or @ref RENDER_TIMING_NO_LAYER.
+	uint32_t layer_index;
+};
+
+/*!
+ * Resolved GPU durations of one frame, see @ref render_timing_get_results.
+ *
+ * @see render_timing
+ */
+struct render_timing_results
+{
+	//! Time spent in each pass, summed over all scopes of that pass.
+	uint64_t pass_ns[RENDER_TIMING_PASS_COUNT];
+
+	//! Time spent on each layer, summed over all views.
+	uint64_t layer_ns[RENDER_MAX_LAYERS];
+
+	//! Sum of all passes.
+	uint64_t total_ns;
+
+	//! Number of scopes that had results.
+	uint32_t scope_count;
+
+	//! Scopes that were not timed because the pool was full.
+	uint32_t dropped_count;
+
+	/*!
+	 * Start and end of each scope in the same time domain as
+	 * @ref os_monotonic_get_ns, only valid if @p has_host_times is set.
+	 */
+	uint64_t host_ns[RENDER_TIMING_MAX_SCOPES][2];
+
+	//! The device supports converting timestamps to the host time domain.
+	bool has_host_times;
+};
+
+/*!
+ * Per pass GPU profiler, writes a pair of timestamps around each pass into its
+ * own query pool. The timestamps are only read back after the GPU is done with
+ * the frame, so it does not stall the GPU and is cheap enough to always leave
+ * on. Writing timestamps is skipped if the queue does not support them.
+ *
+ * Like @ref render_resources it is only safe to have one frame in flight per
+ * timing struct.
+ */
+struct render_timing
+{
+	//! Two timestamp queries per scope, start and end.
+	VkQueryPool query_pool;
+
+	//! Number of scopes the pool has room for.
+	uint32_t max_scopes;
+
+	//! Write timestamps, if false only @ref render_timing_reset does anything.
+	bool enabled;
+
+	//! What each scope in the current frame measured.
+	struct render_timing_scope scopes[RENDER_TIMING_MAX_SCOPES];
+
+	//! Number of scopes started in the current frame.
+	uint32_t scope_count;
+
+	//! Scopes that could not be started in the current frame.
+	uint32_t dropped_count;
+};
+
+/*!
+ * Creates the query pool, @p max_scopes is clamped to
+ * @ref RENDER_TIMING_MAX_SCOPES. Enabled if the device supports timestamps.
+ *
+ * @public @memberof render_timing
+ */
+bool
+render_timing_init(struct render_timing *rt, struct vk_bundle *vk, uint32_t max_scopes);
+
+/*!
+ * Frees the query pool, safe to call on a zeroed struct.
+ *
+ * @public @memberof render_timing
+ */
+void
+render_timing_fini(struct render_timing *rt, struct vk_bundle *vk);
+
+/*!
+ * Resets the query pool and starts a new frame, must be recorded before any
+ * scopes, outside of a render pass.
+ *
+ * @public @memberof render_timing
+ */
+void
+render_timing_reset(struct render_timing *rt, struct vk_bundle *vk, VkCommandBuffer cmd);
+
+/*!
+ * Writes the start timestamp of a scope, returns the scope to pass to
+ * @ref render_timing_end or @ref RENDER_TIMING_INVALID_SCOPE if not timed.
+ *
+ * @public @memberof render_timing
+ */
+uint32_t
+render_timing_begin(struct render_timing *rt,
+                    struct vk_bundle *vk,
+                    VkCommandBuffer cmd,
+                    enum render_timing_pass pass,
+                    uint32_t layer_index);
+
+/*!
+ * Takes a scope without recording anything, the start timestamp is written
+ * later with @ref render_timing_write_begin. Lets the scopes be handed out in
+ * order on one thread while the commands are recorded on others.
+ *
+ * @public @memberof render_timing
+ */
+uint32_t
+render_timing_reserve(struct render_timing *rt, enum render_timing_pass pass, uint32_t layer_index);
+
+/*!
+ * Writes the start timestamp of a scope from @ref render_timing_reserve, does
+ * nothing for @ref RENDER_TIMING_INVALID_SCOPE. Only reads @p rt, so it may be
+ * called from multiple threads for different scopes.
+ *
+ * @public @memberof render_timing
+ */
+void
+render_timing_write_begin(const struct render_timing *rt, struct vk_bundle *vk, VkCommandBuffer cmd, uint32_t scope);
+
+/*!
+ * Writes the end timestamp of a scope, does nothing for
+ * @ref RENDER_TIMING_INVALID_SCOPE. Only reads @p rt, like
+ * @ref render_timing_write_begin.
+ *
+ * @public @memberof render_timing
+ */
+void
+render_timing_end(const struct render_timing *rt, struct vk_bundle *vk, VkCommandBuffer cmd, uint32_t scope);
+
+/*!
+ * Reads back the timestamps of the last frame and resolves them, the GPU must
+ * be done with the frame. Scopes without results are skipped.
+ *
+ * @public @memberof render_timing
+ */
+bool
+render_timing_get_results(struct render_timing *rt, struct vk_bundle *vk, struct render_timing_results *out_results);
+
+/*!
+ * Turns pairs of start and end ticks into durations, only uses the lower
+ * @p valid_bits of each tick so that wrapping counters are handled. The
+ * @p ticks array holds two entries per scope, if @p available is not null
+ * scopes with it set to false are skipped. Does not touch the host times.
+ *
+ * @public @memberof render_timing
+ */
+void
+render_timing_resolve(const struct render_timing_scope *scopes,
+                      uint32_t scope_count,
+                      const uint64_t *ticks,
+                      const bool *available,
+                      uint32_t valid_bits,
+                      float period_ns,
+                      struct render_timing_results *out_results);
+
+
 /*
  *
  * Resources
@@ -378,6 +718,40 @@ struct render_resources
 
 	VkQueryPool query_pool;
 
+	//! Per pass timestamps, reset by @ref render_gfx and @ref render_compute.
+	struct render_timing timing;
+
+	/*!
+	 * Used to record one secondary command buffer per view on worker
+	 * threads, only set up by @ref render_resources_parallel_init.
+	 */
+	struct
+	{
+		//! Worker threads, NULL if recording is done on the calling thread.
+		struct u_worker_thread_pool *pool;
+
+		//! Group all recording tasks are pushed to.
+		struct u_worker_group *group;
+
+		/*!
+		 * One pool per view so no two threads ever use the same pool at
+		 * the same time, reset by @ref render_gfx_begin.
+		 */
+		struct vk_cmd_pool cmd_pools[XRT_MAX_VIEWS];
+
+		//! Number of valid entries in @ref cmd_pools.
+		uint32_t cmd_pool_count;
+	} parallel;
+
+	/*!
+	 * Parts of each view that can be seen through the lens, all visible
+	 * unless set up by @ref render_resources_visibility_init.
+	 */
+	struct
+	{
+		struct render_visibility_spans spans[XRT_MAX_VIEWS];
+	} visibility;
+
 
 	/*
 	 * Static
@@ -553,6 +927,9 @@ struct render_resources
 
 		//! Whether distortion images have been pre-rotated 90 degrees.
 		bool pre_rotated;
+
+		//! Format of the images, fixed at init as the pipelines depend on it.
+		enum render_distortion_format format;
 	} distortion;
 };
 
@@ -567,7 +944,8 @@ bool
 render_resources_init(struct render_resources *r,
                       struct render_shaders *shaders,
                       struct vk_bundle *vk,
-                      struct xrt_device *xdev);
+                      struct xrt_device *xdev,
+                      enum render_distortion_format distortion_format);
 
 /*!
  * Free all pools and static resources, does not free the struct itself.
@@ -577,6 +955,40 @@ render_resources_init(struct render_resources *r,
 void
 render_resources_fini(struct render_resources *r);
 
+/*!
+ * Creates the worker threads and per view command pools used to record the
+ * layer squashing of each view on its own thread, call after a successful
+ * @ref render_resources_init. Cleaned up by @ref render_resources_parallel_fini.
+ *
+ * @param r          Self.
+ * @param view_count Number of views, one pool and one thread per view.
+ *
+ * @public @memberof render_resources
+ */
+bool
+render_resources_parallel_init(struct render_resources *r, uint32_t view_count);
+
+/*!
+ * Joins the worker threads and frees the per view command pools, safe to call
+ * if @ref render_resources_parallel_init was never called. Also done by
+ * @ref render_resources_fini.
+ *
+ * @public @memberof render_resources
+ */
+void
+render_resources_parallel_fini(struct render_resources *r);
+
+/*!
+ * Fetches the visible area of each view from the device, so that the layer
+ * squashers and compute distortion skip the pixels that the lenses never show.
+ * Call after a successful @ref render_resources_init, views without a mask
+ * are left fully visible.
+ *
+ * @public @memberof render_resources
+ */
+void
+render_resources_visibility_init(struct render_resources *r, struct xrt_device *xdev);
+
 /*!
  * Creates or recreates the compute distortion textures if necessary.
  *
@@ -854,6 +1266,13 @@ struct render_gfx
 
 	//! The current target we are rendering to, can change during command building.
 	struct render_gfx_target_resources *rtr;
+
+	/*!
+	 * Command buffer the draw functions record into, the primary
+	 * @ref render_resources::cmd or a secondary from
+	 * @ref render_gfx_begin_secondary.
+	 */
+	VkCommandBuffer cmd;
 };
 
 /*!
@@ -872,6 +1291,18 @@ render_gfx_init(struct render_gfx *render, struct render_resources *r);
 bool
 render_gfx_begin(struct render_gfx *render);
 
+/*!
+ * Begins the second command buffer of a frame that is split in two, the first
+ * was recorded between @ref render_gfx_begin and @ref render_gfx_end and must
+ * have completed on the GPU. The timestamps read by
+ * @ref render_resources_get_timestamps are restarted so they only cover the
+ * second, the @ref render_timing scopes are kept so they cover both.
+ *
+ * @public @memberof render_gfx
+ */
+bool
+render_gfx_begin_late(struct render_gfx *render);
+
 /*!
  * Frees any unneeded resources and ends the command buffer so it can be used,
  * also unlocks the vk_bundle's pool lock that was taken by begin.
@@ -911,6 +1342,27 @@ struct render_gfx_mesh_ubo_data
 	struct xrt_matrix_4x4 transform;
 };
 
+/*!
+ * Offset of @ref render_gfx_layer_visibility_data in all of the layer UBOs,
+ * the same in all of them so the fragment shaders can share the declaration.
+ */
+#define RENDER_GFX_LAYER_VISIBILITY_OFFSET (112)
+
+/*!
+ * UBO data that all of the layer fragment shaders use to skip the pixels of
+ * the view that can not be seen through the lens.
+ *
+ * @relates render_gfx
+ */
+struct render_gfx_layer_visibility_data
+{
+	//! Viewport of the view in pixels, as x, y, 1 / w and 1 / h.
+	struct xrt_normalized_rect viewport;
+
+	//! Visible parts of the view.
+	struct render_visibility_spans spans;
+};
+
 /*!
  * UBO data that is sent to the layer cylinder shader.
  *
@@ -924,6 +1376,8 @@ struct render_gfx_layer_cylinder_data
 	float central_angle;
 	float aspect_ratio;
 	float _pad;
+	float _pad_visibility[4];
+	struct render_gfx_layer_visibility_data visibility;
 };
 
 /*!
@@ -943,6 +1397,8 @@ struct render_gfx_layer_equirect2_data
 	float central_horizontal_angle;
 	float upper_vertical_angle;
 	float lower_vertical_angle;
+
+	struct render_gfx_layer_visibility_data visibility;
 };
 
 /*!
@@ -955,6 +1411,8 @@ struct render_gfx_layer_projection_data
 	struct xrt_normalized_rect post_transform;
 	struct xrt_normalized_rect to_tanget;
 	struct xrt_matrix_4x4 mvp;
+	float _pad_visibility[4];
+	struct render_gfx_layer_visibility_data visibility;
 };
 
 /*!
@@ -966,6 +1424,8 @@ struct render_gfx_layer_quad_data
 {
 	struct xrt_normalized_rect post_transform;
 	struct xrt_matrix_4x4 mvp;
+	float _pad_visibility[8];
+	struct render_gfx_layer_visibility_data visibility;
 };
 
 /*!
@@ -1072,6 +1532,61 @@ render_gfx_begin_target(struct render_gfx *render,
 void
 render_gfx_end_target(struct render_gfx *render);
 
+/*!
+ * Like @ref render_gfx_begin_target but the render pass contents come from
+ * secondary command buffers, the only draw function that may be called before
+ * @ref render_gfx_end_target is @ref render_gfx_execute_secondary.
+ *
+ * @public @memberof render_gfx
+ */
+bool
+render_gfx_begin_target_secondaries(struct render_gfx *render,
+                                    struct render_gfx_target_resources *rtr,
+                                    const VkClearColorValue *color);
+
+/*!
+ * Executes a secondary command buffer ended with @ref render_gfx_end_secondary.
+ *
+ * @pre successful @ref render_gfx_begin_target_secondaries call
+ * @public @memberof render_gfx
+ */
+void
+render_gfx_execute_secondary(struct render_gfx *render, VkCommandBuffer cmd);
+
+/*!
+ * Sets up @p sub to record the inside of the render pass of @p rtr into a new
+ * secondary command buffer from @ref render_resources::parallel, the draw
+ * functions are then called on @p sub starting with
+ * @ref render_gfx_begin_view. Only the draw functions may be used on @p sub,
+ * all descriptor sets and UBOs must be allocated up front on the primary
+ * @ref render_gfx as allocation is not thread safe.
+ *
+ * Secondaries from different pools can be recorded on different threads at
+ * the same time, they are freed by the next @ref render_gfx_begin.
+ *
+ * @param sub        Zeroed and set up by this function, not to be finalised.
+ * @param r          Resources with @ref render_resources_parallel_init done.
+ * @param rtr        Target that the secondary will be executed in.
+ * @param pool_index Which of the per view pools to allocate from.
+ *
+ * @public @memberof render_gfx
+ */
+bool
+render_gfx_begin_secondary(struct render_gfx *sub,
+                           struct render_resources *r,
+                           struct render_gfx_target_resources *rtr,
+                           uint32_t pool_index);
+
+/*!
+ * Ends the secondary command buffer, which is then found in @p sub's cmd field.
+ *
+ * @pre successful @ref render_gfx_begin_secondary call,
+ *   no @ref render_gfx_begin_view without matching @ref render_gfx_end_view
+ * @public @memberof render_gfx
+ */
+bool
+render_gfx_end_secondary(struct render_gfx *sub);
+
 /*!
  * @pre successful @ref render_gfx_begin_target call
  * @public @memberof render_gfx
@@ -1204,6 +1719,9 @@ struct render_compute_layer_ubo_data
 		uint32_t padding[3];
 	} layer_count;
 
+	//! Parts of the view that can be seen through the lens.
+	struct render_visibility_spans visibility;
+
 	struct xrt_normalized_rect pre_transform;
 	struct xrt_normalized_rect post_transforms[RENDER_MAX_LAYERS];
 
@@ -1295,6 +1813,9 @@ struct render_compute_distortion_ubo_data
 	struct xrt_normalized_rect pre_transforms[XRT_MAX_VIEWS];
 	struct xrt_normalized_rect post_transforms[XRT_MAX_VIEWS];
 	struct xrt_matrix_4x4 transforms[XRT_MAX_VIEWS];
+
+	//! Parts of each view that can be seen through the lens.
+	struct render_visibility_spans visibility[XRT_MAX_VIEWS];
 };
 
 /*!
@@ -14,12 +14,17 @@
 #include "math/m_matrix_2x2.h"
 #include "math/m_vec2.h"
 
+#include "util/u_worker.h"
+#include "util/u_visibility_mask.h"
+
 #include "vk/vk_mini_helpers.h"
 
 #include "render/render_interface.h"
 
 
+#include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 
 /*
@@ -299,6 +304,7 @@ struct compute_distortion_params
 {
 	uint32_t distortion_texel_count;
 	VkBool32 do_timewarp;
+	VkBool32 packed_half;
 };
 
 XRT_CHECK_RESULT static VkResult
@@ -355,9 +361,10 @@ create_compute_distortion_pipeline(struct vk_bundle *vk,
 	    sizeof(params->FIELD),                                                                                     \
 	}
 
-	VkSpecializationMapEntry entries[2] = {
+	VkSpecializationMapEntry entries[3] = {
 	    ENTRY(0, distortion_texel_count),
 	    ENTRY(1, do_timewarp),
+	    ENTRY(2, packed_half),
 	};
 #undef ENTRY
 
@@ -509,7 +516,8 @@ bool
 render_resources_init(struct render_resources *r,
                       struct render_shaders *shaders,
                       struct vk_bundle *vk,
-                      struct xrt_device *xdev)
+                      struct xrt_device *xdev,
+                      enum render_distortion_format distortion_format)
 {
 	VkResult ret;
 	bool bret;
@@ -541,6 +549,12 @@ render_resources_init(struct render_resources *r,
 	r->compute.distortion_binding = 1;
 	r->compute.target_binding = 2;
 	r->compute.ubo_binding = 3;
+	r->distortion.format = distortion_format;
+
+	// Everything is visible until render_resources_visibility_init is called.
+	for (uint32_t i = 0; i < ARRAY_SIZE(r->visibility.spans); i++) {
+		render_visibility_spans_init_full(&r->visibility.spans[i]);
+	}
 
 	r->compute.layer.image_array_size =
 	    MIN(vk->features.max_per_stage_descriptor_sampled_images, RENDER_MAX_IMAGES_COUNT(r));
@@ -733,6 +747,26 @@ render_resources_init(struct render_resources *r,
 
 		// We currently use the aligmnent as max UBO size.
 		static_assert(sizeof(struct render_gfx_mesh_ubo_data) <= RENDER_ALWAYS_SAFE_UBO_ALIGNMENT, "MAX");
+		static_assert(sizeof(struct render_gfx_layer_cylinder_data) <= RENDER_ALWAYS_SAFE_UBO_ALIGNMENT, "MAX");
+		static_assert(sizeof(struct render_gfx_layer_equirect2_data) <= RENDER_ALWAYS_SAFE_UBO_ALIGNMENT,
+		              "MAX");
+		static_assert(sizeof(struct render_gfx_layer_projection_data) <= RENDER_ALWAYS_SAFE_UBO_ALIGNMENT,
+		              "MAX");
+		static_assert(sizeof(struct render_gfx_layer_quad_data) <= RENDER_ALWAYS_SAFE_UBO_ALIGNMENT, "MAX");
+
+		// The layer fragment shaders share the declaration of the visibility data.
+		static_assert(offsetof(struct render_gfx_layer_cylinder_data, visibility) ==
+		                  RENDER_GFX_LAYER_VISIBILITY_OFFSET,
+		              "Offset");
+		static_assert(offsetof(struct render_gfx_layer_equirect2_data, visibility) ==
+		                  RENDER_GFX_LAYER_VISIBILITY_OFFSET,
+		              "Offset");
+		static_assert(offsetof(struct render_gfx_layer_projection_data, visibility) ==
+		                  RENDER_GFX_LAYER_VISIBILITY_OFFSET,
+		              "Offset");
+		static_assert(offsetof(struct render_gfx_layer_quad_data, visibility) ==
+		                  RENDER_GFX_LAYER_VISIBILITY_OFFSET,
+		              "Offset");
 
 		// Calculate size.
 		VkDeviceSize size = buffer_count * RENDER_ALWAYS_SAFE_UBO_ALIGNMENT;
@@ -957,6 +991,7 @@ render_resources_init(struct render_resources *r,
 	struct compute_distortion_params distortion_params = {
 	    .distortion_texel_count = RENDER_DISTORTION_IMAGE_DIMENSIONS,
 	    .do_timewarp = false,
+	    .packed_half = r->distortion.format == RENDER_DISTORTION_FORMAT_PACKED_FLOAT16,
 	};
 
 	ret = create_compute_distortion_pipeline(  //
@@ -973,6 +1008,7 @@ render_resources_init(struct render_resources *r,
 	struct compute_distortion_params distortion_timewarp_params = {
 	    .distortion_texel_count = RENDER_DISTORTION_IMAGE_DIMENSIONS,
 	    .do_timewarp = true,
+	    .packed_half = r->distortion.format == RENDER_DISTORTION_FORMAT_PACKED_FLOAT16,
 	};
 
 	ret = create_compute_distortion_pipeline(      //
@@ -1071,6 +1107,11 @@ render_resources_init(struct render_resources *r,
 
 	VK_NAME_QUERY_POOL(vk, r->query_pool, "render_resources query pool");
 
+	bret = render_timing_init(&r->timing, vk, RENDER_TIMING_MAX_SCOPES);
+	if (!bret) {
+		return false;
+	}
+
 	/*
 	 * Done
 	 */
@@ -1080,6 +1121,117 @@ render_resources_init(struct render_resources *r,
 	return true;
 }
 
+bool
+render_resources_parallel_init(struct render_resources *r, uint32_t view_count)
+{
+	struct vk_bundle *vk = r->vk;
+	VkResult ret;
+
+	assert(r->parallel.pool == NULL);
+
+	if (view_count > XRT_MAX_VIEWS) {
+		view_count = XRT_MAX_VIEWS;
+	}
+	if (view_count < 2) {
+		U_LOG_I("Only %u view(s), not recording views in parallel.", view_count);
+		return true;
+	}
+
+	for (uint32_t i = 0; i < view_count; i++) {
+		ret = vk_cmd_pool_init(vk, &r->parallel.cmd_pools[i], VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+		VK_CHK_WITH_GOTO(ret, "vk_cmd_pool_init", err_pools);
+
+		r->parallel.cmd_pool_count++;
+
+		VK_NAME_COMMAND_POOL(vk, r->parallel.cmd_pools[i].pool, "render_resources parallel command pool");
+	}
+
+	// The render thread donates itself while waiting, so all views can be recorded at once.
+	r->parallel.pool = u_worker_thread_pool_create(view_count - 1, view_count, "Render Record");
+	if (r->parallel.pool == NULL) {
+		U_LOG_E("u_worker_thread_pool_create failed");
+		goto err_pools;
+	}
+
+	r->parallel.group = u_worker_group_create(r->parallel.pool);
+	if (r->parallel.group == NULL) {
+		U_LOG_E("u_worker_group_create failed");
+		goto err_pools;
+	}
+
+	U_LOG_I("Recording %u views in parallel.", view_count);
+
+	return true;
+
+err_pools:
+	render_resources_parallel_fini(r);
+
+	return false;
+}
+
+void
+render_resources_parallel_fini(struct render_resources *r)
+{
+	// Waits for any tasks, then joins the threads.
+	u_worker_group_reference(&r->parallel.group, NULL);
+	u_worker_thread_pool_reference(&r->parallel.pool, NULL);
+
+	for (uint32_t i = 0; i < r->parallel.cmd_pool_count; i++) {
+		vk_cmd_pool_destroy(r->vk, &r->parallel.cmd_pools[i]);
+	}
+	r->parallel.cmd_pool_count = 0;
+}
+
+void
+render_resources_visibility_init(struct render_resources *r, struct xrt_device *xdev)
+{
+	for (uint32_t i = 0; i < r->view_count; i++) {
+		struct render_visibility_spans *spans = &r->visibility.spans[i];
+		struct xrt_visibility_mask *mask = NULL;
+
+		xrt_result_t xret = XRT_ERROR_NOT_IMPLEMENTED;
+		if (xdev->get_visibility_mask != NULL) {
+			xret = xrt_device_get_visibility_mask(              //
+			    xdev,                                           //
+			    XRT_VISIBILITY_MASK_TYPE_VISIBLE_TRIANGLE_MESH, //
+			    i,                                              // view_index
+			    &mask);                                         // out_mask
+		}
+
+		// Same default as the state tracker and the IPC server hand out to apps.
+		if (xret == XRT_ERROR_NOT_IMPLEMENTED) {
+			u_visibility_mask_get_default(                      //
+			    XRT_VISIBILITY_MASK_TYPE_VISIBLE_TRIANGLE_MESH, //
+			    &xdev->hmd->distortion.fov[i],                  //
+			    &mask);                                         // out_mask
+			xret = XRT_SUCCESS;
+		}
+
+		if (xret != XRT_SUCCESS || mask == NULL) {
+			U_LOG_I("No visibility mask for view %u, shading all of it.", i);
+			render_visibility_spans_init_full(spans);
+			free(mask);
+			continue;
+		}
+
+		// The squashers render the view at the distortion fov.
+		bool bret = render_visibility_spans_calc( //
+		    mask,                                 //
+		    &xdev->hmd->distortion.fov[i],        //
+		    RENDER_VISIBILITY_MARGIN,             //
+		    spans);                               // out_spans
+		free(mask);
+
+		if (!bret) {
+			U_LOG_I("Empty visibility mask for view %u, shading all of it.", i);
+			continue;
+		}
+
+		U_LOG_I("Skipping %.1f%% of view %u hidden by the lens.",
+		        render_visibility_spans_hidden_fraction(spans) * 100.0f, i);
+	}
+}
+
 void
 render_resources_fini(struct render_resources *r)
 {
@@ -1109,6 +1261,7 @@ render_resources_fini(struct render_resources *r)
 	D(PipelineLayout, r->mesh.pipeline_layout);
 	D(PipelineCache, r->pipeline_cache);
 	D(QueryPool, r->query_pool);
+	render_timing_fini(&r->timing, vk);
 	render_buffer_fini(vk, &r->mesh.vbo);
 	render_buffer_fini(vk, &r->mesh.ibo);
 	for (uint32_t i = 0; i < r->view_count; ++i) {
@@ -1136,6 +1289,7 @@ render_resources_fini(struct render_resources *r)
 	}
 	render_buffer_fini(vk, &r->compute.distortion.ubo);
 
+	render_resources_parallel_fini(r);
 	vk_cmd_pool_destroy(vk, &r->distortion_pool);
 	D(CommandPool, r->cmd_pool);
 
@@ -0,0 +1,279 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Per pass GPU timestamp profiling.
+ * @ingroup comp_render
+ */
+
+#include "util/u_misc.h"
+
+#include "vk/vk_mini_helpers.h"
+#include "render/render_interface.h"
+
+#include <assert.h>
+#include <string.h>
+
+
+/*
+ *
+ * Helper functions.
+ *
+ */
+
+static uint64_t
+ticks_mask(uint32_t valid_bits)
+{
+	if (valid_bits >= 64) {
+		return UINT64_MAX;
+	}
+
+	return (UINT64_C(1) << valid_bits) - 1;
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+bool
+render_timing_init(struct render_timing *rt, struct vk_bundle *vk, uint32_t max_scopes)
+{
+	VkResult ret;
+
+	U_ZERO(rt);
+
+	if (max_scopes > RENDER_TIMING_MAX_SCOPES) {
+		max_scopes = RENDER_TIMING_MAX_SCOPES;
+	}
+
+	VkQueryPoolCreateInfo pool_info = {
+	    .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+	    .pNext = NULL,
+	    .flags = 0, // Reserved.
+	    .queryType = VK_QUERY_TYPE_TIMESTAMP,
+	    .queryCount = max_scopes * 2, // Start & end
+	    .pipelineStatistics = 0,      // Not used.
+	};
+
+	ret = vk->vkCreateQueryPool( //
+	    vk->device,              // device
+	    &pool_info,              // pCreateInfo
+	    NULL,                    // pAllocator
+	    &rt->query_pool);        // pQueryPool
+	VK_CHK_WITH_RET(ret, "vkCreateQueryPool", false);
+
+	VK_NAME_QUERY_POOL(vk, rt->query_pool, "render_timing query pool");
+
+	rt->max_scopes = max_scopes;
+
+	// Queues without timestamp support have zero valid bits.
+	rt->enabled = vk->features.timestamp_valid_bits != 0;
+
+	return true;
+}
+
+void
+render_timing_fini(struct render_timing *rt, struct vk_bundle *vk)
+{
+	D(QueryPool, rt->query_pool);
+
+	U_ZERO(rt);
+}
+
+void
+render_timing_reset(struct render_timing *rt, struct vk_bundle *vk, VkCommandBuffer cmd)
+{
+	rt->scope_count = 0;
+	rt->dropped_count = 0;
+
+	if (!rt->enabled || rt->query_pool == VK_NULL_HANDLE) {
+		return;
+	}
+
+	vk->vkCmdResetQueryPool( //
+	    cmd,                 // commandBuffer
+	    rt->query_pool,      // queryPool
+	    0,                   // firstQuery
+	    rt->max_scopes * 2); // queryCount
+}
+
+uint32_t
+render_timing_begin(struct render_timing *rt,
+                    struct vk_bundle *vk,
+                    VkCommandBuffer cmd,
+                    enum render_timing_pass pass,
+                    uint32_t layer_index)
+{
+	uint32_t scope = render_timing_reserve(rt, pass, layer_index);
+
+	render_timing_write_begin(rt, vk, cmd, scope);
+
+	return scope;
+}
+
+uint32_t
+render_timing_reserve(struct render_timing *rt, enum render_timing_pass pass, uint32_t layer_index)
+{
+	if (!rt->enabled || rt->query_pool == VK_NULL_HANDLE) {
+		return RENDER_TIMING_INVALID_SCOPE;
+	}
+
+	if (rt->scope_count >= rt->max_scopes) {
+		rt->dropped_count++;
+		return RENDER_TIMING_INVALID_SCOPE;
+	}
+
+	uint32_t scope = rt->scope_count++;
+	rt->scopes[scope].pass = pass;
+	rt->scopes[scope].layer_index = layer_index;
+
+	return scope;
+}
+
+void
+render_timing_write_begin(const struct render_timing *rt, struct vk_bundle *vk, VkCommandBuffer cmd, uint32_t scope)
+{
+	if (scope == RENDER_TIMING_INVALID_SCOPE) {
+		return;
+	}
+
+	assert(scope < rt->scope_count);
+
+	vk->vkCmdWriteTimestamp(               //
+	    cmd,                               // commandBuffer
+	    VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, // pipelineStage
+	    rt->query_pool,                    // queryPool
+	    scope * 2);                        // query
+}
+
+void
+render_timing_end(const struct render_timing *rt, struct vk_bundle *vk, VkCommandBuffer cmd, uint32_t scope)
+{
+	if (scope == RENDER_TIMING_INVALID_SCOPE) {
+		return;
+	}
+
+	assert(scope < rt->scope_count);
+
+	vk->vkCmdWriteTimestamp(                  //
+	    cmd,                                  // commandBuffer
+	    VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, // pipelineStage
+	    rt->query_pool,                       // queryPool
+	    scope * 2 + 1);                       // query
+}
+
+bool
+render_timing_get_results(struct render_timing *rt, struct vk_bundle *vk, struct render_timing_results *out_results)
+{
+	VkResult ret;
+
+	U_ZERO(out_results);
+	out_results->dropped_count = rt->dropped_count;
+
+	uint32_t scope_count = rt->scope_count;
+	if (scope_count == 0) {
+		return true;
+	}
+
+	/*
+	 * Every query has its value followed by its availability. Not waiting,
+	 * the caller has already waited for the GPU and any scope that was
+	 * started but never ended would otherwise block forever.
+	 */
+	uint64_t data[RENDER_TIMING_MAX_SCOPES * 2][2];
+	VkQueryResultFlags flags = VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT;
+	size_t data_size = sizeof(data[0]) * scope_count * 2;
+
+	ret = vk->vkGetQueryPoolResults( //
+	    vk->device,                  // device
+	    rt->query_pool,              // queryPool
+	    0,                           // firstQuery
+	    scope_count * 2,             // queryCount
+	    data_size,                   // dataSize
+	    data,                        // pData
+	    sizeof(data[0]),             // stride
+	    flags);                      // flags
+	if (ret != VK_SUCCESS && ret != VK_NOT_READY) {
+		VK_ERROR(vk, "vkGetQueryPoolResults: %s", vk_result_string(ret));
+		return false;
+	}
+
+	uint64_t ticks[RENDER_TIMING_MAX_SCOPES * 2];
+	bool available[RENDER_TIMING_MAX_SCOPES];
+
+	for (uint32_t i = 0; i < scope_count; i++) {
+		ticks[i * 2 + 0] = data[i * 2 + 0][0];
+		ticks[i * 2 + 1] = data[i * 2 + 1][0];
+		available[i] = data[i * 2 + 0][1] != 0 && data[i * 2 + 1][1] != 0;
+	}
+
+	render_timing_resolve(                 //
+	    rt->scopes,                        //
+	    scope_count,                       //
+	    ticks,                             //
+	    available,                         //
+	    vk->features.timestamp_valid_bits, //
+	    vk->features.timestamp_period,     //
+	    out_results);                      //
+	out_results->dropped_count = rt->dropped_count;
+
+#if defined(VK_EXT_calibrated_timestamps)
+	if (vk->has_EXT_calibrated_timestamps) {
+		/*
+		 * Convert from GPU context to CPU context, has to be
+		 * done fairly quickly after timestamps has been made.
+		 */
+		ret = vk_convert_timestamps_to_host_ns(vk, scope_count * 2, ticks);
+		if (ret == VK_SUCCESS) {
+			for (uint32_t i = 0; i < scope_count; i++) {
+				out_results->host_ns[i][0] = available[i] ? ticks[i * 2 + 0] : 0;
+				out_results->host_ns[i][1] = available[i] ? ticks[i * 2 + 1] : 0;
+			}
+			out_results->has_host_times = true;
+		}
+	}
+#endif
+
+	return true;
+}
+
+void
+render_timing_resolve(const struct render_timing_scope *scopes,
+                      uint32_t scope_count,
+                      const uint64_t *ticks,
+                      const bool *available,
+                      uint32_t valid_bits,
+                      float period_ns,
+                      struct render_timing_results *out_results)
+{
+	uint64_t mask = ticks_mask(valid_bits);
+
+	memset(out_results->pass_ns, 0, sizeof(out_results->pass_ns));
+	memset(out_results->layer_ns, 0, sizeof(out_results->layer_ns));
+	out_results->total_ns = 0;
+	out_results->scope_count = 0;
+
+	for (uint32_t i = 0; i < scope_count; i++) {
+		if (available != NULL && !available[i]) {
+			continue;
+		}
+
+		// Only the valid bits count, unsigned wrap handles a rollover in between.
+		uint64_t delta_ticks = (ticks[i * 2 + 1] - ticks[i * 2 + 0]) & mask;
+		uint64_t ns = (uint64_t)((double)delta_ticks * (double)period_ns);
+
+		const struct render_timing_scope *scope = &scopes[i];
+		if (scope->pass < RENDER_TIMING_PASS_COUNT) {
+			out_results->pass_ns[scope->pass] += ns;
+		}
+		if (scope->layer_index < RENDER_MAX_LAYERS) {
+			out_results->layer_ns[scope->layer_index] += ns;
+		}
+
+		out_results->total_ns += ns;
+		out_results->scope_count++;
+	}
+}
@@ -0,0 +1,211 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Visible spans of views, calculated from device visibility masks.
+ * @ingroup comp_render
+ */
+
+#include "xrt/xrt_visibility_mask.h"
+
+#include "math/m_mathinclude.h"
+
+#include "render/render_interface.h"
+
+
+/*
+ *
+ * Helper functions.
+ *
+ */
+
+//! Both steps inclusive, everything is hidden if @p first is after @p last.
+static void
+set_span(struct render_visibility_spans *spans, uint32_t row, uint32_t first, uint32_t last)
+{
+	uint32_t shift = (row % 2) * 16;
+	uint32_t value = (first & 0xff) | ((last & 0xff) << 8);
+
+	spans->packed[row / 2] &= ~(0xffffu << shift);
+	spans->packed[row / 2] |= value << shift;
+}
+
+static void
+get_span(const struct render_visibility_spans *spans, uint32_t row, uint32_t *out_first, uint32_t *out_last)
+{
+	uint32_t value = spans->packed[row / 2] >> ((row % 2) * 16);
+
+	*out_first = value & 0xff;
+	*out_last = (value >> 8) & 0xff;
+}
+
+static uint32_t
+to_step(float x)
+{
+	float step = floorf(x * (float)RENDER_VISIBILITY_STEPS);
+
+	if (!(step >= 0.0f)) {
+		return 0;
+	}
+	if (step > (float)(RENDER_VISIBILITY_STEPS - 1)) {
+		return RENDER_VISIBILITY_STEPS - 1;
+	}
+
+	return (uint32_t)step;
+}
+
+static void
+extend(float x, bool *hit, float *min_x, float *max_x)
+{
+	if (!*hit || x < *min_x) {
+		*min_x = x;
+	}
+	if (!*hit || x > *max_x) {
+		*max_x = x;
+	}
+	*hit = true;
+}
+
+/*!
+ * Grows the range to cover the part of the triangle between @p top and
+ * @p bottom, the extremes of the clipped triangle are either corners of the
+ * triangle or where its edges cross the top and bottom.
+ */
+static void
+extend_with_triangle(const struct xrt_vec2 tri[3], float top, float bottom, bool *hit, float *min_x, float *max_x)
+{
+	for (uint32_t i = 0; i < 3; i++) {
+		const struct xrt_vec2 p = tri[i];
+		const struct xrt_vec2 q = tri[(i + 1) % 3];
+
+		if (p.y >= top && p.y <= bottom) {
+			extend(p.x, hit, min_x, max_x);
+		}
+
+		const float edges[2] = {top, bottom};
+		for (uint32_t k = 0; k < 2; k++) {
+			float y = edges[k];
+			if ((p.y < y && q.y > y) || (p.y > y && q.y < y)) {
+				float t = (y - p.y) / (q.y - p.y);
+				extend(p.x + (q.x - p.x) * t, hit, min_x, max_x);
+			}
+		}
+	}
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+void
+render_visibility_spans_init_full(struct render_visibility_spans *spans)
+{
+	for (uint32_t row = 0; row < RENDER_VISIBILITY_ROWS; row++) {
+		set_span(spans, row, 0, RENDER_VISIBILITY_STEPS - 1);
+	}
+}
+
+bool
+render_visibility_spans_calc(const struct xrt_visibility_mask *mask,
+                             const struct xrt_fov *fov,
+                             float margin,
+                             struct render_visibility_spans *out_spans)
+{
+	render_visibility_spans_init_full(out_spans);
+
+	uint32_t triangle_count = mask->index_count / 3;
+	if (triangle_count == 0) {
+		return false;
+	}
+
+	const uint32_t *indices = xrt_visibility_mask_get_indices(mask);
+	const struct xrt_vec2 *vertices = xrt_visibility_mask_get_vertices(mask);
+
+	// The mask is in tangent lengths with y going down, see u_visibility_mask.c.
+	const float tan_left = tanf(fov->angle_left);
+	const float tan_right = tanf(fov->angle_right);
+	const float tan_up = tanf(fov->angle_up);
+	const float tan_down = tanf(fov->angle_down);
+
+	const float width = tan_right - tan_left;
+	const float height = tan_up - tan_down;
+
+	for (uint32_t row = 0; row < RENDER_VISIBILITY_ROWS; row++) {
+		float top = (float)row / (float)RENDER_VISIBILITY_ROWS - margin;
+		float bottom = (float)(row + 1) / (float)RENDER_VISIBILITY_ROWS + margin;
+
+		bool hit = false;
+		float min_x = 0.0f;
+		float max_x = 0.0f;
+
+		for (uint32_t i = 0; i < triangle_count; i++) {
+			struct xrt_vec2 tri[3];
+			for (uint32_t k = 0; k < 3; k++) {
+				uint32_t index = indices[i * 3 + k];
+				if (index >= mask->vertex_count) {
+					render_visibility_spans_init_full(out_spans);
+					return false;
+				}
+
+				tri[k].x = (vertices[index].x - tan_left) / width;
+				tri[k].y = (vertices[index].y + tan_up) / height;
+			}
+
+			extend_with_triangle(tri, top, bottom, &hit, &min_x, &max_x);
+		}
+
+		min_x -= margin;
+		max_x += margin;
+
+		if (!hit || max_x < 0.0f || min_x >= 1.0f) {
+			set_span(out_spans, row, RENDER_VISIBILITY_STEPS - 1, 0);
+			continue;
+		}
+
+		set_span(out_spans, row, to_step(min_x), to_step(max_x));
+	}
+
+	return true;
+}
+
+bool
+render_visibility_spans_is_hidden(const struct render_visibility_spans *spans, const struct xrt_vec2 *uv)
+{
+	if (!(uv->x >= 0.0f && uv->x < 1.0f && uv->y >= 0.0f && uv->y < 1.0f)) {
+		return false;
+	}
+
+	uint32_t row = (uint32_t)(uv->y * (float)RENDER_VISIBILITY_ROWS);
+	if (row >= RENDER_VISIBILITY_ROWS) {
+		row = RENDER_VISIBILITY_ROWS - 1;
+	}
+
+	uint32_t first, last;
+	get_span(spans, row, &first, &last);
+
+	float x = uv->x * (float)RENDER_VISIBILITY_STEPS;
+
+	return x < (float)first || x >= (float)(last + 1);
+}
+
+float
+render_visibility_spans_hidden_fraction(const struct render_visibility_spans *spans)
+{
+	uint32_t visible_steps = 0;
+
+	for (uint32_t row = 0; row < RENDER_VISIBILITY_ROWS; row++) {
+		uint32_t first, last;
+		get_span(spans, row, &first, &last);
+
+		if (first <= last) {
+			visible_steps += last - first + 1;
+		}
+	}
+
+	float total = (float)(RENDER_VISIBILITY_ROWS * RENDER_VISIBILITY_STEPS);
+
+	return 1.0f - (float)visible_steps / total;
+}
@@ -8,6 +8,9 @@
 // SPDX-License-Identifier: BSL-1.0
 
 #version 460
+#extension GL_GOOGLE_include_directive : require
+
+#include "visibility.inc.glsl"
 
 layout (binding = 0, std140) uniform Config
 {
@@ -18,6 +21,8 @@ layout (binding = 0, std140) uniform Config
 	float central_horizontal_angle;
 	float upper_vertical_angle;
 	float lower_vertical_angle;
+	vec4 visibility_viewport;
+	uvec4 visibility_spans[VISIBILITY_ROWS / 8];
 } ubo;
 
 layout (binding = 1) uniform sampler2D image;
@@ -50,6 +55,13 @@ vec2 sphere_intersect(vec3 ray_origin, vec3 ray_direction, vec3 sphere_center, f
 
 void main ()
 {
+	// Never seen through the lens, leave the background.
+	vec2 view_uv = (gl_FragCoord.xy - ubo.visibility_viewport.xy) * ubo.visibility_viewport.zw;
+	uint word_index = visibility_word_index(view_uv);
+	if (visibility_is_hidden(ubo.visibility_spans[word_index / 4u][word_index % 4u], view_uv)) {
+		discard;
+	}
+
 	vec3 ray_origin = in_camera_position;
 	vec3 ray_dir = normalize(in_camera_ray_unnormalized);
 
@@ -6,7 +6,17 @@
 // SPDX-License-Identifier: BSL-1.0
 
 #version 460
+#extension GL_GOOGLE_include_directive : require
 
+#include "visibility.inc.glsl"
+
+
+// Only the visibility data, at RENDER_GFX_LAYER_VISIBILITY_OFFSET in all layer UBOs.
+layout (binding = 0, std140) uniform Config
+{
+	layout (offset = 112) vec4 visibility_viewport;
+	uvec4 visibility_spans[VISIBILITY_ROWS / 8];
+} ubo;
 
 layout (binding = 1) uniform sampler2D image;
 
@@ -16,5 +26,16 @@ layout (location = 0) out vec4 out_color;
 
 void main ()
 {
-	out_color = texture(image, uv);
+	// Taken before discarding, neighbouring fragments might be discarded.
+	vec2 uv_dx = dFdx(uv);
+	vec2 uv_dy = dFdy(uv);
+
+	// Never seen through the lens, leave the background.
+	vec2 view_uv = (gl_FragCoord.xy - ubo.visibility_viewport.xy) * ubo.visibility_viewport.zw;
+	uint word_index = visibility_word_index(view_uv);
+	if (visibility_is_hidden(ubo.visibility_spans[word_index / 4u][word_index % 4u], view_uv)) {
+		discard;
+	}
+
+	out_color = textureGrad(image, uv, uv_dx, uv_dy);
 }
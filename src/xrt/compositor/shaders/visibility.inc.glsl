@@ -0,0 +1,35 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+
+// Visible spans of a view, packed as in struct render_visibility_spans, two
+// row bands per uint and so eight uvec4 per view.
+
+// Must match RENDER_VISIBILITY_ROWS and RENDER_VISIBILITY_STEPS.
+#define VISIBILITY_ROWS 64
+#define VISIBILITY_STEPS 256
+
+
+uint visibility_row(vec2 uv)
+{
+	return uint(clamp(int(floor(uv.y * float(VISIBILITY_ROWS))), 0, VISIBILITY_ROWS - 1));
+}
+
+// Index of the uint holding the span of the row band that uv is in.
+uint visibility_word_index(vec2 uv)
+{
+	return visibility_row(uv) / 2u;
+}
+
+// Is uv hidden by the lens, word is the uint at visibility_word_index(uv).
+bool visibility_is_hidden(uint word, vec2 uv)
+{
+	// Outside of the view is left to the samplers.
+	if (any(lessThan(uv, vec2(0.0))) || any(greaterThanEqual(uv, vec2(1.0)))) {
+		return false;
+	}
+
+	uint span = (word >> ((visibility_row(uv) & 1u) * 16u)) & 0xffffu;
+	float x = uv.x * float(VISIBILITY_STEPS);
+
+	return x < float(span & 0xffu) || x >= float((span >> 8u) + 1u);
+}
@@ -12,13 +12,21 @@
 #include "util/comp_layer_accum.h"
 #include "util/comp_sync.h"
 #include "util/u_wait.h"
+#include "util/u_debug.h"
 #include "util/u_trace_marker.h"
 
 #include "util/comp_base.h"
 #include "util/comp_semaphore.h"
+#include "util/comp_swapchain_pool.h"
 #include "xrt/xrt_compositor.h"
 
 
+/*!
+ * Budget of each client's swapchain image pool, zero turns pooling off.
+ */
+DEBUG_GET_ONCE_NUM_OPTION(swapchain_pool_mb, "XRT_COMPOSITOR_SWAPCHAIN_POOL_MB", 256)
+
+
 /*
  *
  * Helper function.
@@ -56,7 +64,7 @@ base_create_swapchain(struct xrt_compositor *xc,
 	struct xrt_swapchain_create_properties xsccp = {0};
 	xrt_comp_get_swapchain_create_properties(xc, info, &xsccp);
 
-	return comp_swapchain_create(&cb->vk, &cb->cscs, info, &xsccp, out_xsc);
+	return comp_swapchain_create(&cb->vk, &cb->cscs, NULL, info, &xsccp, out_xsc);
 }
 
 //! Delegates to code in `comp_swapchain`
@@ -243,3 +251,51 @@ comp_base_fini(struct comp_base *cb)
 
 	u_threading_stack_fini(&cb->cscs.destroy_swapchains);
 }
+
+
+/*
+ *
+ * comp_multi_swapchain_pool_funcs functions.
+ *
+ */
+
+static xrt_result_t
+base_pool_create(struct xrt_compositor_native *xcn, struct comp_swapchain_pool **out_pool)
+{
+	struct comp_base *cb = comp_base(&xcn->base);
+
+	VkDeviceSize max_bytes = (VkDeviceSize)debug_get_num_option_swapchain_pool_mb() * 1024 * 1024;
+	if (max_bytes == 0) {
+		*out_pool = NULL;
+		return XRT_SUCCESS;
+	}
+
+	return comp_swapchain_pool_create(&cb->vk, max_bytes, out_pool);
+}
+
+static xrt_result_t
+base_pool_create_swapchain(struct xrt_compositor_native *xcn,
+                           struct comp_swapchain_pool *pool,
+                           const struct xrt_swapchain_create_info *info,
+                           struct xrt_swapchain **out_xsc)
+{
+	struct comp_base *cb = comp_base(&xcn->base);
+
+	// Same as base_create_swapchain, dispatch in case it has been overridden.
+	struct xrt_swapchain_create_properties xsccp = {0};
+	xrt_comp_get_swapchain_create_properties(&xcn->base, info, &xsccp);
+
+	return comp_swapchain_create(&cb->vk, &cb->cscs, pool, info, &xsccp, out_xsc);
+}
+
+static void
+base_pool_unref(struct xrt_compositor_native *xcn, struct comp_swapchain_pool **pool_ptr)
+{
+	comp_swapchain_pool_reference(pool_ptr, NULL);
+}
+
+const struct comp_multi_swapchain_pool_funcs comp_base_swapchain_pool_funcs = {
+    .create = base_pool_create,
+    .create_swapchain = base_pool_create_swapchain,
+    .unref = base_pool_unref,
+};
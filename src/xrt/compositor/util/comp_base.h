@@ -14,6 +14,8 @@
 #include "util/comp_swapchain.h"
 #include "util/comp_layer_accum.h"
 
+#include "multi/comp_multi_interface.h"
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -133,6 +135,15 @@ comp_base_init(struct comp_base *cb);
 void
 comp_base_fini(struct comp_base *cb);
 
+/*!
+ * Per client swapchain pool hooks for @ref comp_multi_create_system_compositor,
+ * the native compositor passed to it must be a @ref comp_base. The budget of
+ * each pool is set with `XRT_COMPOSITOR_SWAPCHAIN_POOL_MB`, zero disables it.
+ *
+ * @ingroup comp_util
+ */
+extern const struct comp_multi_swapchain_pool_funcs comp_base_swapchain_pool_funcs;
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,163 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Scales the region of the scratch images that is rendered to from GPU time.
+ * @ingroup comp_util
+ */
+
+#include "util/u_misc.h"
+#include "util/u_time.h"
+
+#include "util/comp_dynamic_resolution.h"
+
+#include <math.h>
+
+
+/*
+ *
+ * Helper functions.
+ *
+ */
+
+static void
+set_level(struct comp_dynamic_resolution *cdr, uint32_t level)
+{
+	cdr->level = level;
+	cdr->frames_over = 0;
+	cdr->frames_under = 0;
+	cdr->stats.scale = cdr->scales[level];
+}
+
+static uint32_t
+scale_size(uint32_t size, float scale)
+{
+	uint32_t scaled = (uint32_t)lroundf((float)size * scale);
+
+	if (scaled < 1) {
+		return 1;
+	}
+	if (scaled > size) {
+		return size;
+	}
+
+	return scaled;
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+void
+comp_dynamic_resolution_init(struct comp_dynamic_resolution *cdr, bool enabled, float min_scale, uint32_t level_count)
+{
+	U_ZERO(cdr);
+
+	if (!(min_scale >= 0.1f)) {
+		min_scale = 0.1f;
+	}
+	if (min_scale > 1.0f) {
+		min_scale = 1.0f;
+	}
+	if (level_count < 1) {
+		level_count = 1;
+	}
+	if (level_count > COMP_DYNAMIC_RESOLUTION_MAX_LEVELS) {
+		level_count = COMP_DYNAMIC_RESOLUTION_MAX_LEVELS;
+	}
+
+	cdr->scales[0] = 1.0f;
+	for (uint32_t i = 1; i < level_count; i++) {
+		float t = (float)i / (float)(level_count - 1);
+		cdr->scales[i] = 1.0f + (min_scale - 1.0f) * t;
+	}
+
+	cdr->level_count = level_count;
+	cdr->enabled = enabled;
+
+	set_level(cdr, 0);
+}
+
+bool
+comp_dynamic_resolution_update(struct comp_dynamic_resolution *cdr, uint64_t gpu_ns, uint64_t budget_ns)
+{
+	cdr->stats.gpu_ms = (float)time_ns_to_ms_f((int64_t)gpu_ns);
+	cdr->stats.budget_ms = (float)time_ns_to_ms_f((int64_t)budget_ns);
+
+	if (!cdr->enabled || budget_ns == 0) {
+		if (cdr->level != 0) {
+			set_level(cdr, 0);
+			return true;
+		}
+		return false;
+	}
+
+	double gpu = (double)gpu_ns;
+	double budget = (double)budget_ns;
+
+	// Over budget, scale down quickly.
+	if (gpu > budget * COMP_DYNAMIC_RESOLUTION_DOWN_FRACTION) {
+		cdr->frames_under = 0;
+
+		if (++cdr->frames_over < COMP_DYNAMIC_RESOLUTION_DOWN_FRAMES || cdr->level + 1 >= cdr->level_count) {
+			return false;
+		}
+
+		set_level(cdr, cdr->level + 1);
+		cdr->stats.scale_downs++;
+		return true;
+	}
+
+	cdr->frames_over = 0;
+
+	if (cdr->level == 0) {
+		cdr->frames_under = 0;
+		return false;
+	}
+
+	/*
+	 * Assume the time scales with the pixel count, which overestimates as
+	 * the distortion pass does not scale, so going up is conservative.
+	 */
+	double ratio = cdr->scales[cdr->level - 1] / cdr->scales[cdr->level];
+	double estimated = gpu * ratio * ratio;
+
+	if (estimated >= budget * COMP_DYNAMIC_RESOLUTION_UP_FRACTION) {
+		cdr->frames_under = 0;
+		return false;
+	}
+
+	if (++cdr->frames_under < COMP_DYNAMIC_RESOLUTION_UP_FRAMES) {
+		return false;
+	}
+
+	set_level(cdr, cdr->level - 1);
+	cdr->stats.scale_ups++;
+	return true;
+}
+
+void
+comp_dynamic_resolution_get_region(const struct comp_dynamic_resolution *cdr,
+                                   VkExtent2D extent,
+                                   struct render_viewport_data *out_viewport_data,
+                                   struct xrt_normalized_rect *out_norm_rect)
+{
+	float scale = comp_dynamic_resolution_get_scale(cdr);
+
+	uint32_t w = scale_size(extent.width, scale);
+	uint32_t h = scale_size(extent.height, scale);
+
+	out_viewport_data->x = 0;
+	out_viewport_data->y = 0;
+	out_viewport_data->w = w;
+	out_viewport_data->h = h;
+
+	// Use the exact pixel ratio, not the scale, so sampling lines up with the pixels.
+	out_norm_rect->x = 0.0f;
+	out_norm_rect->y = 0.0f;
+	out_norm_rect->w = extent.width > 0 ? (float)w / (float)extent.width : 1.0f;
+	out_norm_rect->h = extent.height > 0 ? (float)h / (float)extent.height : 1.0f;
+}
@@ -0,0 +1,163 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Scales the region of the scratch images that is rendered to from GPU time.
+ * @ingroup comp_util
+ */
+
+#pragma once
+
+#include "xrt/xrt_defines.h"
+
+#include "render/render_interface.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*
+ *
+ * Defines.
+ *
+ */
+
+//! Max number of scale levels, including the full size level.
+#define COMP_DYNAMIC_RESOLUTION_MAX_LEVELS (8)
+
+//! Scale down when GPU time is over this fraction of the budget.
+#define COMP_DYNAMIC_RESOLUTION_DOWN_FRACTION (0.9)
+
+//! Frames in a row over budget before scaling down.
+#define COMP_DYNAMIC_RESOLUTION_DOWN_FRAMES (2)
+
+//! Scale up when the GPU time estimated at the next level is under this fraction of the budget.
+#define COMP_DYNAMIC_RESOLUTION_UP_FRACTION (0.75)
+
+//! Frames in a row with headroom before scaling up.
+#define COMP_DYNAMIC_RESOLUTION_UP_FRAMES (45)
+
+
+/*
+ *
+ * Structs.
+ *
+ */
+
+/*!
+ * Statistics of a @ref comp_dynamic_resolution, exposed via u_var.
+ *
+ * @ingroup comp_util
+ */
+struct comp_dynamic_resolution_stats
+{
+	//! Current scale of each axis.
+	float scale;
+
+	//! Last GPU time given to the controller.
+	float gpu_ms;
+
+	//! Last budget given to the controller.
+	float budget_ms;
+
+	//! Number of times the scale was lowered.
+	uint64_t scale_downs;
+
+	//! Number of times the scale was raised.
+	uint64_t scale_ups;
+};
+
+/*!
+ * Picks how much of the scratch images the layer squasher renders to. The
+ * scratch images are allocated at full size once, each level is a region in
+ * the top left corner of them, so changing level never reallocates anything.
+ * The distortion pass samples only that region via the layer norm rect.
+ *
+ * Levels are spaced evenly between full size and the smallest scale, level
+ * zero is full size. The level is lowered as soon as the GPU time has been
+ * over budget for a few frames, and raised only when the GPU time estimated
+ * at the next level up has had headroom for a longer while.
+ *
+ * @ingroup comp_util
+ */
+struct comp_dynamic_resolution
+{
+	//! Scale of each axis for each level, first is 1.0.
+	float scales[COMP_DYNAMIC_RESOLUTION_MAX_LEVELS];
+
+	//! Number of valid entries in @ref scales.
+	uint32_t level_count;
+
+	//! Current level, index into @ref scales.
+	uint32_t level;
+
+	//! Consecutive frames over budget.
+	uint32_t frames_over;
+
+	//! Consecutive frames with enough headroom to scale up.
+	uint32_t frames_under;
+
+	//! If false the level is kept at full size.
+	bool enabled;
+
+	struct comp_dynamic_resolution_stats stats;
+};
+
+
+/*
+ *
+ * Functions.
+ *
+ */
+
+/*!
+ * Set up the levels, @p min_scale is clamped to [0.1, 1.0] and
+ * @p level_count to [1, @ref COMP_DYNAMIC_RESOLUTION_MAX_LEVELS].
+ *
+ * @ingroup comp_util
+ */
+void
+comp_dynamic_resolution_init(struct comp_dynamic_resolution *cdr, bool enabled, float min_scale, uint32_t level_count);
+
+/*!
+ * Feed the GPU time of the last frame that used the scratch images, returns
+ * true if the level changed.
+ *
+ * @param cdr       Self.
+ * @param gpu_ns    How long the GPU took for the frame.
+ * @param budget_ns How long the GPU may take.
+ *
+ * @ingroup comp_util
+ */
+bool
+comp_dynamic_resolution_update(struct comp_dynamic_resolution *cdr, uint64_t gpu_ns, uint64_t budget_ns);
+
+/*!
+ * Current scale of each axis.
+ *
+ * @ingroup comp_util
+ */
+static inline float
+comp_dynamic_resolution_get_scale(const struct comp_dynamic_resolution *cdr)
+{
+	return cdr->scales[cdr->level];
+}
+
+/*!
+ * The region of a scratch image of size @p extent to render to, and the rect
+ * the distortion should sample from it.
+ *
+ * @ingroup comp_util
+ */
+void
+comp_dynamic_resolution_get_region(const struct comp_dynamic_resolution *cdr,
+                                   VkExtent2D extent,
+                                   struct render_viewport_data *out_viewport_data,
+                                   struct xrt_normalized_rect *out_norm_rect);
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,320 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Cache of pre-squashed static layers for the layer squasher.
+ * @ingroup comp_util
+ */
+
+#include "math/m_vec3.h"
+#include "math/m_mathinclude.h"
+
+#include "util/u_misc.h"
+#include "util/u_var.h"
+
+#include "util/comp_render.h"
+#include "util/comp_render_helpers.h"
+#include "util/comp_layer_cache.h"
+
+#include <string.h>
+
+
+/*
+ *
+ * Helper functions.
+ *
+ */
+
+#define FNV_OFFSET_BASIS (0xcbf29ce484222325ULL)
+#define FNV_PRIME (0x100000001b3ULL)
+
+static uint64_t
+hash_bytes(uint64_t hash, const void *ptr, size_t size)
+{
+	const uint8_t *bytes = (const uint8_t *)ptr;
+
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= FNV_PRIME;
+	}
+
+	return hash;
+}
+
+static bool
+is_cacheable_type(enum xrt_layer_type type)
+{
+	switch (type) {
+	case XRT_LAYER_QUAD:
+	case XRT_LAYER_CYLINDER:
+	case XRT_LAYER_EQUIRECT2: return true;
+	default: return false;
+	}
+}
+
+static bool
+pose_within(const struct xrt_pose *a, const struct xrt_pose *b)
+{
+	const struct xrt_quat *qa = &a->orientation;
+	const struct xrt_quat *qb = &b->orientation;
+
+	// Angle between the two is 2 * acos(|dot|).
+	float dot = qa->x * qb->x + qa->y * qb->y + qa->z * qb->z + qa->w * qb->w;
+	if (fabsf(dot) < cosf(COMP_LAYER_CACHE_MAX_ANGLE * 0.5f)) {
+		return false;
+	}
+
+	return m_vec3_len(m_vec3_sub(a->position, b->position)) <= COMP_LAYER_CACHE_MAX_DISTANCE;
+}
+
+static bool
+fov_equal(const struct xrt_fov *a, const struct xrt_fov *b)
+{
+	return a->angle_left == b->angle_left &&   //
+	       a->angle_right == b->angle_right && //
+	       a->angle_up == b->angle_up &&       //
+	       a->angle_down == b->angle_down;
+}
+
+static void
+update_keys(struct comp_layer_cache *cache, const struct comp_layer *layers, uint32_t layer_count)
+{
+	for (uint32_t i = 0; i < layer_count; i++) {
+		uint64_t key = comp_layer_cache_layer_key(&layers[i]);
+
+		if (i < cache->key_count && cache->keys[i] == key) {
+			if (cache->stable_frames[i] < UINT32_MAX) {
+				cache->stable_frames[i]++;
+			}
+		} else {
+			cache->keys[i] = key;
+			cache->stable_frames[i] = 0;
+
+			// Cached content is stale even if the layer becomes static again.
+			if (i < cache->cached_count) {
+				cache->cached_count = 0;
+			}
+		}
+	}
+
+	cache->key_count = layer_count;
+}
+
+static bool
+is_cache_valid(const struct comp_layer_cache *cache, uint32_t count, const struct comp_render_dispatch_data *d)
+{
+	if (count != cache->cached_count) {
+		return false;
+	}
+
+	for (uint32_t i = 0; i < d->view_count; i++) {
+		const struct comp_layer_cache_view *view = &cache->views[i];
+
+		if (!fov_equal(&view->fov, &d->views[i].fov)) {
+			return false;
+		}
+
+		if (cache->cached_view_space) {
+			if (!pose_within(&view->eye_pose, &d->views[i].eye_pose)) {
+				return false;
+			}
+		} else {
+			if (!pose_within(&view->world_pose, &d->views[i].world_pose)) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+static bool
+is_head_at_rest(const struct comp_layer_cache *cache, const struct comp_render_dispatch_data *d)
+{
+	for (uint32_t i = 0; i < d->view_count; i++) {
+		if (!pose_within(&cache->last_world_poses[i], &d->views[i].world_pose)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+bool
+comp_layer_cache_init(struct comp_layer_cache *cache,
+                      struct render_resources *r,
+                      struct render_gfx_render_pass *rgrp,
+                      VkExtent2D extent)
+{
+	if (!render_scratch_images_ensure(r, &cache->images, extent)) {
+		return false;
+	}
+
+	cache->r = r;
+
+	for (uint32_t i = 0; i < r->view_count; i++) {
+		struct comp_layer_cache_view *view = &cache->views[i];
+
+		render_gfx_target_resources_init(     //
+		    &view->rtr,                       //
+		    r,                                //
+		    rgrp,                             //
+		    cache->images.color[i].srgb_view, //
+		    extent);                          //
+
+		// The cache is opaque, so both alpha and no alpha views are the same.
+		view->image_view = cache->images.color[i].srgb_view;
+		view->sc.images[0].views.alpha = &view->image_view;
+		view->sc.images[0].views.no_alpha = &view->image_view;
+		view->sc.images[0].array_size = 1;
+		view->sc.base.base.image_count = 1;
+	}
+
+	u_var_add_root(cache, "Compositor layer cache", false);
+	u_var_add_ro_u64(cache, &cache->stats.hits, "Hits");
+	u_var_add_ro_u64(cache, &cache->stats.refreshes, "Refreshes");
+	u_var_add_ro_u64(cache, &cache->stats.bypasses, "Bypasses");
+	u_var_add_ro_u32(cache, &cache->stats.layer_count, "Layers cached");
+
+	return true;
+}
+
+void
+comp_layer_cache_fini(struct comp_layer_cache *cache)
+{
+	if (cache->r == NULL) {
+		return;
+	}
+
+	u_var_remove_root(cache);
+
+	for (uint32_t i = 0; i < cache->r->view_count; i++) {
+		render_gfx_target_resources_fini(&cache->views[i].rtr);
+	}
+
+	render_scratch_images_fini(cache->r, &cache->images);
+
+	U_ZERO(cache);
+}
+
+uint64_t
+comp_layer_cache_layer_key(const struct comp_layer *layer)
+{
+	// The timestamp changes every frame without changing what is drawn.
+	struct xrt_layer_data data = layer->data;
+	data.timestamp = 0;
+
+	uint64_t hash = hash_bytes(FNV_OFFSET_BASIS, &data, sizeof(data));
+
+	for (uint32_t i = 0; i < ARRAY_SIZE(layer->sc_array); i++) {
+		if (layer->sc_array[i] == NULL) {
+			continue;
+		}
+
+		struct comp_swapchain *sc = comp_swapchain(layer->sc_array[i]);
+		uint64_t id = sc->base.limited_unique_id.data;
+		int32_t release_count = sc->release_count;
+
+		hash = hash_bytes(hash, &id, sizeof(id));
+		hash = hash_bytes(hash, &release_count, sizeof(release_count));
+	}
+
+	return hash;
+}
+
+void
+comp_layer_cache_plan(struct comp_layer_cache *cache,
+                      const struct comp_layer *layers,
+                      uint32_t layer_count,
+                      const struct comp_render_dispatch_data *d,
+                      struct comp_layer_cache_plan *out_plan)
+{
+	update_keys(cache, layers, layer_count);
+
+	// The bottom-most run of static layers.
+	uint32_t count = 0;
+	bool view_space = true;
+	for (; count < layer_count; count++) {
+		const struct xrt_layer_data *data = &layers[count].data;
+		if (!is_cacheable_type(data->type) || cache->stable_frames[count] < COMP_LAYER_CACHE_STABLE_FRAMES) {
+			break;
+		}
+		view_space = view_space && is_layer_view_space(data);
+	}
+
+	struct comp_layer_cache_plan plan = {COMP_LAYER_CACHE_ACTION_NONE, 0};
+
+	if (count == 0) {
+		cache->cached_count = 0;
+	} else if (is_cache_valid(cache, count, d)) {
+		plan.action = COMP_LAYER_CACHE_ACTION_USE;
+		plan.layer_count = count;
+		cache->stats.hits++;
+	} else if (layer_count < RENDER_MAX_LAYERS && (view_space || is_head_at_rest(cache, d))) {
+		/*
+		 * Squashing a moving head's view into the cache would only be
+		 * used once. Refreshing draws one layer more than there are, so
+		 * needs room for it in the per view descriptors and UBOs.
+		 */
+		for (uint32_t i = 0; i < d->view_count; i++) {
+			cache->views[i].world_pose = d->views[i].world_pose;
+			cache->views[i].eye_pose = d->views[i].eye_pose;
+			cache->views[i].fov = d->views[i].fov;
+		}
+
+		cache->cached_count = count;
+		cache->cached_view_space = view_space;
+
+		plan.action = COMP_LAYER_CACHE_ACTION_REFRESH;
+		plan.layer_count = count;
+		cache->stats.refreshes++;
+	} else {
+		if (count != cache->cached_count) {
+			cache->cached_count = 0;
+		}
+		cache->stats.bypasses++;
+	}
+
+	for (uint32_t i = 0; i < d->view_count; i++) {
+		cache->last_world_poses[i] = d->views[i].world_pose;
+	}
+
+	cache->stats.layer_count = cache->cached_count;
+
+	*out_plan = plan;
+}
+
+void
+comp_layer_cache_get_layer(struct comp_layer_cache *cache, uint32_t view_count, struct comp_layer *out_layer)
+{
+	U_ZERO(out_layer);
+
+	struct xrt_layer_data *data = &out_layer->data;
+	data->type = XRT_LAYER_PROJECTION;
+	data->name = XRT_INPUT_GENERIC_HEAD_POSE;
+	data->flags = cache->cached_view_space ? XRT_LAYER_COMPOSITION_VIEW_SPACE_BIT : 0;
+	data->view_count = view_count;
+
+	for (uint32_t i = 0; i < view_count; i++) {
+		const struct comp_layer_cache_view *view = &cache->views[i];
+		struct xrt_layer_projection_view_data *vd = &data->proj.v[i];
+
+		out_layer->sc_array[i] = &cache->views[i].sc.base.base;
+
+		vd->pose = cache->cached_view_space ? view->eye_pose : view->world_pose;
+		vd->fov = view->fov;
+		vd->sub.image_index = 0;
+		vd->sub.array_index = 0;
+		vd->sub.norm_rect.x = 0.0f;
+		vd->sub.norm_rect.y = 0.0f;
+		vd->sub.norm_rect.w = 1.0f;
+		vd->sub.norm_rect.h = 1.0f;
+	}
+}
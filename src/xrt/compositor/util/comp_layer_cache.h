@@ -0,0 +1,240 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Cache of pre-squashed static layers for the layer squasher.
+ * @ingroup comp_util
+ */
+
+#pragma once
+
+#include "xrt/xrt_defines.h"
+
+#include "render/render_interface.h"
+
+#include "util/comp_swapchain.h"
+#include "util/comp_layer_accum.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct comp_render_dispatch_data;
+
+
+/*
+ *
+ * Defines.
+ *
+ */
+
+//! Frames a layer needs to be unchanged for before it is cached.
+#define COMP_LAYER_CACHE_STABLE_FRAMES (2)
+
+//! How far the head may turn, in radians, before cached world space layers are squashed again, half a degree.
+#define COMP_LAYER_CACHE_MAX_ANGLE (0.0087266f)
+
+//! How far the head may move, in meters, before cached world space layers are squashed again.
+#define COMP_LAYER_CACHE_MAX_DISTANCE (0.002f)
+
+
+/*
+ *
+ * Structs.
+ *
+ */
+
+/*!
+ * What the layer squasher should do with the cache this frame.
+ *
+ * @ingroup comp_util
+ */
+enum comp_layer_cache_action
+{
+	//! Squash all layers as normal, the cache is not used.
+	COMP_LAYER_CACHE_ACTION_NONE,
+
+	//! The cache is up to date, draw it in place of the cached layers.
+	COMP_LAYER_CACHE_ACTION_USE,
+
+	//! Squash the cached layers into the cache first, then use it.
+	COMP_LAYER_CACHE_ACTION_REFRESH,
+};
+
+/*!
+ * Returned by @ref comp_layer_cache_plan.
+ *
+ * @ingroup comp_util
+ */
+struct comp_layer_cache_plan
+{
+	enum comp_layer_cache_action action;
+
+	//! Number of layers, from the bottom, that are held by the cache.
+	uint32_t layer_count;
+};
+
+/*!
+ * Statistics of a @ref comp_layer_cache.
+ *
+ * @ingroup comp_util
+ */
+struct comp_layer_cache_stats
+{
+	//! Frames where cached layers were only re-projected.
+	uint64_t hits;
+
+	//! Frames where the cache was squashed again.
+	uint64_t refreshes;
+
+	//! Frames where the cache was out of date and the head moving.
+	uint64_t bypasses;
+
+	//! Layers currently in the cache.
+	uint32_t layer_count;
+};
+
+/*!
+ * Per view cache target.
+ *
+ * @ingroup comp_util
+ */
+struct comp_layer_cache_view
+{
+	//! Target resources for squashing into the cache image.
+	struct render_gfx_target_resources rtr;
+
+	//! Used for both views of the swapchain below.
+	VkImageView image_view;
+
+	/*!
+	 * Exposes the cache image to the squasher as a one image swapchain,
+	 * only the views of the first image are set.
+	 */
+	struct comp_swapchain sc;
+
+	//! Poses and fov the cache was squashed with.
+	struct xrt_pose world_pose;
+	struct xrt_pose eye_pose;
+	struct xrt_fov fov;
+};
+
+/*!
+ * Holds the bottom-most run of static quad, cylinder and equirect2 layers
+ * squashed into their own per view images. A layer is static when its data,
+ * apart from the timestamp, and the release counts of its swapchains did not
+ * change for @ref COMP_LAYER_CACHE_STABLE_FRAMES frames. While the run stays
+ * static the squasher draws the cache as a single projection layer, which is
+ * re-projected like any other projection layer, instead of all of the layers.
+ *
+ * Only the bottom-most run is cached: the layer pipelines do not produce a
+ * coverage alpha, so the cache can replace the background but can not be
+ * blended over dynamic layers below it.
+ *
+ * World space layers are squashed again once the head has moved more than
+ * @ref COMP_LAYER_CACHE_MAX_ANGLE or @ref COMP_LAYER_CACHE_MAX_DISTANCE, and
+ * only when the head is at rest, while moving the cache is bypassed.
+ *
+ * @ingroup comp_util
+ */
+struct comp_layer_cache
+{
+	struct render_resources *r;
+
+	//! Cache images, one per view.
+	struct render_scratch_images images;
+
+	struct comp_layer_cache_view views[XRT_MAX_VIEWS];
+
+	//! Content key of each layer in the last frame.
+	uint64_t keys[RENDER_MAX_LAYERS];
+
+	//! Frames each layer has had the same key.
+	uint32_t stable_frames[RENDER_MAX_LAYERS];
+
+	//! Number of valid entries in @ref keys and @ref stable_frames.
+	uint32_t key_count;
+
+	//! Number of layers in the cache, zero if empty.
+	uint32_t cached_count;
+
+	//! All cached layers are in view space, so not affected by head motion.
+	bool cached_view_space;
+
+	//! World poses of the last frame, to tell if the head is at rest.
+	struct xrt_pose last_world_poses[XRT_MAX_VIEWS];
+
+	//! Layers handed to the squasher on frames the cache is used.
+	struct comp_layer layers[RENDER_MAX_LAYERS];
+
+	struct comp_layer_cache_stats stats;
+};
+
+
+/*
+ *
+ * Functions.
+ *
+ */
+
+/*!
+ * Create the cache images and targets, the cache must be zero initialized.
+ * Nothing needs to be cleaned up if this fails.
+ *
+ * @param cache  Self.
+ * @param r      Render resources, also gives the number of views.
+ * @param rgrp   Render pass to squash with, same as used for the scratch images.
+ * @param extent Size of the scratch images.
+ *
+ * @ingroup comp_util
+ */
+bool
+comp_layer_cache_init(struct comp_layer_cache *cache,
+                      struct render_resources *r,
+                      struct render_gfx_render_pass *rgrp,
+                      VkExtent2D extent);
+
+/*!
+ * Free all resources, the GPU must be done with them.
+ *
+ * @ingroup comp_util
+ */
+void
+comp_layer_cache_fini(struct comp_layer_cache *cache);
+
+/*!
+ * Content key of a layer, changes if anything that is drawn changes, hashes
+ * the layer data and the id and release count of its swapchains.
+ *
+ * @ingroup comp_util
+ */
+uint64_t
+comp_layer_cache_layer_key(const struct comp_layer *layer);
+
+/*!
+ * Decide what to do with the cache this frame, must be called exactly once
+ * per frame the layer squasher runs. Updates the cache state assuming the
+ * returned action is carried out.
+ *
+ * @ingroup comp_util
+ */
+void
+comp_layer_cache_plan(struct comp_layer_cache *cache,
+                      const struct comp_layer *layers,
+                      uint32_t layer_count,
+                      const struct comp_render_dispatch_data *d,
+                      struct comp_layer_cache_plan *out_plan);
+
+/*!
+ * Fill out the projection layer that draws the cache images.
+ *
+ * @ingroup comp_util
+ */
+void
+comp_layer_cache_get_layer(struct comp_layer_cache *cache, uint32_t view_count, struct comp_layer *out_layer);
+
+
+#ifdef __cplusplus
+}
+#endif
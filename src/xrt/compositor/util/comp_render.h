@@ -24,6 +24,7 @@ extern "C" {
 #endif
 
 struct comp_layer;
+struct comp_layer_cache;
 struct render_compute;
 struct render_gfx;
 struct render_gfx_target_resources;
@@ -152,6 +153,9 @@ struct comp_render_dispatch_data
 	{
 		//! The resources needed for the target.
 		struct render_gfx_target_resources *rtr;
+
+		//! Cache of static layers for the layer squasher, NULL if disabled.
+		struct comp_layer_cache *layer_cache;
 	} gfx;
 
 	//! Members used only by CS @ref comp_render_cs
@@ -389,6 +393,48 @@ comp_render_gfx_dispatch(struct render_gfx *render,
                          const uint32_t layer_count,
                          const struct comp_render_dispatch_data *d);
 
+/*!
+ * Writes the layer squashing half of @ref comp_render_gfx_dispatch, used when
+ * the distortion is recorded separately with @ref comp_render_gfx_late_warp.
+ * Always squashes into the scratch images, ignoring the fast path.
+ *
+ * Expected layouts:
+ *
+ * - Layer images: `VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL`
+ * - Scratch images: Any (as per the @ref render_gfx_render_pass)
+ *
+ * After call layouts:
+ *
+ * - Layer images: `VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL`
+ * - Scratch images: `VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL`
+ *
+ * @param render GFX render object
+ * @param[in] layers Layers to render, must be at least one.
+ * @param[in] layer_count Number of elements in @p layers array.
+ * @param[in] d Common render dispatch data
+ */
+void
+comp_render_gfx_squash(struct render_gfx *render,
+                       const struct comp_layer *layers,
+                       const uint32_t layer_count,
+                       const struct comp_render_dispatch_data *d);
+
+/*!
+ * Writes the distortion half of @ref comp_render_gfx_dispatch, reading the
+ * scratch images squashed by @ref comp_render_gfx_squash. If
+ * @p comp_render_dispatch_data::do_timewarp is set the images are warped from
+ * @p squashed_poses, the world poses the layers were squashed with, to the
+ * world poses of @p d which may have been sampled later.
+ *
+ * @param render GFX render object
+ * @param[in] squashed_poses World pose of each view the layers were squashed with.
+ * @param[in] d Common render dispatch data, same scratch images as the squash.
+ */
+void
+comp_render_gfx_late_warp(struct render_gfx *render,
+                          const struct xrt_pose squashed_poses[XRT_MAX_VIEWS],
+                          const struct comp_render_dispatch_data *d);
+
 /* end of comp_render_gfx group */
 
 /*! @} */
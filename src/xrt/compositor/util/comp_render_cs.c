@@ -342,12 +342,20 @@ crc_clear_output(struct render_compute *render, const struct comp_render_dispatc
 		target_viewport_datas[i] = d->views[i].target_viewport_data;
 	}
 
+	uint32_t scope = render_timing_begin( //
+	    &render->r->timing,               //
+	    render->r->vk,                    //
+	    render->r->cmd,                   //
+	    RENDER_TIMING_PASS_CLEAR,         //
+	    RENDER_TIMING_NO_LAYER);          //
 
 	render_compute_clear(        //
 	    render,                  //
 	    d->cs.target_image,      //
 	    d->cs.target_unorm_view, // target_image_view
 	    target_viewport_datas);  // views
+
+	render_timing_end(&render->r->timing, render->r->vk, render->r->cmd, scope);
 }
 
 /*
@@ -391,6 +399,13 @@ crc_distortion_after_squash(struct render_compute *render, const struct comp_ren
 		target_viewport_datas[i] = viewport_data;
 	}
 
+	uint32_t scope = render_timing_begin( //
+	    &render->r->timing,               //
+	    render->r->vk,                    //
+	    render->r->cmd,                   //
+	    RENDER_TIMING_PASS_DISTORTION,    //
+	    RENDER_TIMING_NO_LAYER);          //
+
 	render_compute_projection(   //
 	    render,                  //
 	    src_samplers,            //
@@ -399,6 +414,8 @@ crc_distortion_after_squash(struct render_compute *render, const struct comp_ren
 	    d->cs.target_image,      //
 	    d->cs.target_unorm_view, // target_image_view
 	    target_viewport_datas);  // views
+
+	render_timing_end(&render->r->timing, render->r->vk, render->r->cmd, scope);
 }
 
 /// Fast path
@@ -463,6 +480,13 @@ crc_distortion_fast_path(struct render_compute *render,
 		world_poses[i] = world_pose;
 	}
 
+	uint32_t scope = render_timing_begin( //
+	    &render->r->timing,               //
+	    render->r->vk,                    //
+	    render->r->cmd,                   //
+	    RENDER_TIMING_PASS_DISTORTION,    //
+	    RENDER_TIMING_NO_LAYER);          //
+
 	if (!d->do_timewarp) {
 		render_compute_projection(   //
 		    render,                  //
@@ -485,6 +509,8 @@ crc_distortion_fast_path(struct render_compute *render,
 		    d->cs.target_unorm_view,        //
 		    target_viewport_datas);         //
 	}
+
+	render_timing_end(&render->r->timing, render->r->vk, render->r->cmd, scope);
 }
 
 
@@ -527,6 +553,7 @@ comp_render_cs_layer(struct render_compute *render,
 	VkImageView src_image_views[RENDER_MAX_IMAGES_SIZE];
 
 	ubo_data->view = *target_view;
+	ubo_data->visibility = render->r->visibility.spans[view_index];
 	ubo_data->pre_transform = *pre_transform;
 
 	for (uint32_t c_layer_i = 0; c_layer_i < layer_count; c_layer_i++) {
@@ -686,6 +713,14 @@ comp_render_cs_layers(struct render_compute *render,
 	for (uint32_t view_index = 0; view_index < d->view_count; view_index++) {
 		const struct comp_render_view_data *view = &d->views[view_index];
 
+		// All layers of a view are drawn in one dispatch, so only timed per view.
+		uint32_t scope = render_timing_begin( //
+		    &render->r->timing,               //
+		    render->r->vk,                    //
+		    render->r->cmd,                   //
+		    RENDER_TIMING_PASS_LAYERS,        //
+		    RENDER_TIMING_NO_LAYER);          //
+
 		comp_render_cs_layer(            //
 		    render,                      //
 		    view_index,                  //
@@ -698,6 +733,8 @@ comp_render_cs_layers(struct render_compute *render,
 		    view->cs.unorm_view,         //
 		    &view->layer_viewport_data,  //
 		    d->do_timewarp);             //
+
+		render_timing_end(&render->r->timing, render->r->vk, render->r->cmd, scope);
 	}
 
 	cmd_barrier_view_images(                   //
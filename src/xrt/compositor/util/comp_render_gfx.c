@@ -14,6 +14,7 @@
 #include "math/m_api.h"
 #include "math/m_mathinclude.h"
 
+#include "util/u_worker.h"
 #include "util/u_trace_marker.h"
 
 #include "vk/vk_helpers.h"
@@ -22,6 +23,7 @@
 
 #include "util/comp_render.h"
 #include "util/comp_render_helpers.h"
+#include "util/comp_layer_cache.h"
 
 
 /*
@@ -44,9 +46,18 @@ struct gfx_layer_view_state
 	/// Is the alpha premultipled, false means unpremultiplied.
 	bool premultiplied_alphas[RENDER_MAX_LAYERS];
 
+	/// Index of the layer in the layers given to the squasher, for timing.
+	uint32_t layer_indices[RENDER_MAX_LAYERS];
+
+	/// Timing scope of each layer, reserved before any commands are written.
+	uint32_t timing_scopes[RENDER_MAX_LAYERS];
+
 	/// To go to this view's tangent lengths.
 	struct xrt_normalized_rect to_tangent;
 
+	/// Used by all layers to skip the pixels hidden by the lens.
+	struct render_gfx_layer_visibility_data visibility;
+
 	/// Number of layers filled in.
 	/// TODO move to parent struct
 	uint32_t layer_count;
@@ -75,6 +86,24 @@ struct gfx_layer_state
 	struct gfx_layer_view_state views[XRT_MAX_VIEWS];
 };
 
+/*
+ * One view of the layer squashing recorded into a secondary command buffer.
+ */
+struct gfx_layer_view_task
+{
+	struct render_resources *r;
+	struct render_gfx_target_resources *rtr;
+	const struct render_viewport_data *viewport_data;
+	const struct gfx_layer_view_state *state;
+	uint32_t view;
+
+	/// Holds the secondary command buffer after the task ran.
+	struct render_gfx sub;
+
+	/// Was the secondary command buffer recorded, written by the task.
+	bool success;
+};
+
 /*
  * Internal state for the mesh rendering step.
  */
@@ -284,6 +313,8 @@ do_cylinder_layer(struct render_gfx *render,
 		data.aspect_ratio = c->aspect_ratio;
 	}
 
+	data.visibility = state->visibility;
+
 	// Can fail if we have too many layers.
 	VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
 	ret = render_gfx_layer_cylinder_alloc_and_write( //
@@ -349,6 +380,7 @@ do_equirect2_layer(struct render_gfx *render,
 	data.central_horizontal_angle = eq2->central_horizontal_angle;
 	data.upper_vertical_angle = eq2->upper_vertical_angle;
 	data.lower_vertical_angle = eq2->lower_vertical_angle;
+	data.visibility = state->visibility;
 
 	// Can fail if we have too many layers.
 	VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
@@ -414,6 +446,8 @@ do_projection_layer(struct render_gfx *render,
 	struct xrt_vec3 scale = {1, 1, 1};
 	calc_mvp_rot_only(state, layer_data, &vd->pose, &scale, &data.mvp);
 
+	data.visibility = state->visibility;
+
 	// Can fail if we have too many layers.
 	VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
 	ret = render_gfx_layer_projection_alloc_and_write( //
@@ -467,6 +501,8 @@ do_quad_layer(struct render_gfx *render,
 	struct xrt_vec3 scale = {q->size.x, q->size.y, 1};
 	calc_mvp_full(state, layer_data, &q->pose, &scale, &data.mvp);
 
+	data.visibility = state->visibility;
+
 	// Can fail if we have too many layers.
 	VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
 	ret = render_gfx_layer_quad_alloc_and_write( //
@@ -487,12 +523,23 @@ do_quad_layer(struct render_gfx *render,
 static void
 crg_clear_output(struct render_gfx *render, const struct comp_render_dispatch_data *d)
 {
+	struct vk_bundle *vk = render->r->vk;
+
+	uint32_t scope = render_timing_begin( //
+	    &render->r->timing,               //
+	    vk,                               //
+	    render->r->cmd,                   //
+	    RENDER_TIMING_PASS_CLEAR,         //
+	    RENDER_TIMING_NO_LAYER);          //
+
 	render_gfx_begin_target(     //
 	    render,                  //
 	    d->gfx.rtr,              //
 	    &background_color_idle); //
 
 	render_gfx_end_target(render);
+
+	render_timing_end(&render->r->timing, vk, render->r->cmd, scope);
 }
 
 /*
@@ -553,6 +600,13 @@ crg_distortion_common(struct render_gfx *render,
 	 * Do command writing here.
 	 */
 
+	uint32_t scope = render_timing_begin( //
+	    &render->r->timing,               //
+	    vk,                               //
+	    render->r->cmd,                   //
+	    RENDER_TIMING_PASS_DISTORTION,    //
+	    RENDER_TIMING_NO_LAYER);          //
+
 	render_gfx_begin_target(       //
 	    render,                    //
 	    d->gfx.rtr,                //
@@ -578,6 +632,8 @@ crg_distortion_common(struct render_gfx *render,
 
 	render_gfx_end_target(render);
 
+	render_timing_end(&render->r->timing, vk, render->r->cmd, scope);
+
 	return;
 
 err_no_memory:
@@ -666,6 +722,159 @@ crg_distortion_fast_path(struct render_gfx *render,
 	    d);                //
 }
 
+/// Layer squashing with the bottom-most static layers drawn from the cache.
+static void
+crg_layers_cached(struct render_gfx *render,
+                  const struct comp_layer *layers,
+                  uint32_t layer_count,
+                  const struct comp_render_dispatch_data *d,
+                  VkImageLayout transition_to)
+{
+	struct comp_layer_cache *cache = d->gfx.layer_cache;
+
+	struct comp_layer_cache_plan plan;
+	comp_layer_cache_plan(cache, layers, layer_count, d, &plan);
+
+	if (plan.action == COMP_LAYER_CACHE_ACTION_NONE) {
+		comp_render_gfx_layers( //
+		    render,             //
+		    layers,             //
+		    layer_count,        //
+		    d,                  //
+		    transition_to);     //
+		return;
+	}
+
+	if (plan.action == COMP_LAYER_CACHE_ACTION_REFRESH) {
+		// Same views, but targeting the cache images.
+		struct comp_render_dispatch_data cd = *d;
+		for (uint32_t i = 0; i < cd.view_count; i++) {
+			struct comp_render_view_data *view = &cd.views[i];
+
+			view->image = cache->images.color[i].image;
+			view->srgb_view = cache->images.color[i].srgb_view;
+			view->gfx.rtr = &cache->views[i].rtr;
+			view->layer_viewport_data = (struct render_viewport_data){
+			    .x = 0,
+			    .y = 0,
+			    .w = cache->images.extent.width,
+			    .h = cache->images.extent.height,
+			};
+		}
+
+		comp_render_gfx_layers(                        //
+		    render,                                    //
+		    layers,                                    //
+		    plan.layer_count,                          //
+		    &cd,                                       //
+		    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL); // transition_to
+	}
+
+	// The cache replaces the layers it holds.
+	uint32_t rest_count = layer_count - plan.layer_count;
+	comp_layer_cache_get_layer(cache, d->view_count, &cache->layers[0]);
+	for (uint32_t i = 0; i < rest_count; i++) {
+		cache->layers[1 + i] = layers[plan.layer_count + i];
+	}
+
+	comp_render_gfx_layers( //
+	    render,             //
+	    cache->layers,      //
+	    1 + rest_count,     //
+	    d,                  //
+	    transition_to);     //
+}
+
+
+/*
+ *
+ * Layer squashing recording helpers.
+ *
+ */
+
+/*
+ * Writes the draws of all layers of one view, into the primary or a secondary
+ * command buffer depending on what @p render records into.
+ */
+static void
+write_view_layer_commands(struct render_gfx *render,
+                          uint32_t view,
+                          const struct render_viewport_data *viewport_data,
+                          const struct gfx_layer_view_state *state)
+{
+	struct vk_bundle *vk = render->r->vk;
+
+	render_gfx_begin_view( //
+	    render,            //
+	    view,              // view_index
+	    viewport_data);    // viewport_data
+
+	for (uint32_t i = 0; i < state->layer_count; i++) {
+		render_timing_write_begin(&render->r->timing, vk, render->cmd, state->timing_scopes[i]);
+
+		switch (state->types[i]) {
+		case XRT_LAYER_CYLINDER:
+			render_gfx_layer_cylinder(          //
+			    render,                         //
+			    state->premultiplied_alphas[i], //
+			    state->descriptor_sets[i]);     //
+			break;
+		case XRT_LAYER_EQUIRECT2:
+			render_gfx_layer_equirect2(         //
+			    render,                         //
+			    state->premultiplied_alphas[i], //
+			    state->descriptor_sets[i]);     //
+			break;
+		case XRT_LAYER_PROJECTION:
+		case XRT_LAYER_PROJECTION_DEPTH:
+			render_gfx_layer_projection(        //
+			    render,                         //
+			    state->premultiplied_alphas[i], //
+			    state->descriptor_sets[i]);     //
+			break;
+		case XRT_LAYER_QUAD:
+			render_gfx_layer_quad(              //
+			    render,                         //
+			    state->premultiplied_alphas[i], //
+			    state->descriptor_sets[i]);     //
+			break;
+		default: break;
+		}
+
+		render_timing_end(&render->r->timing, vk, render->cmd, state->timing_scopes[i]);
+	}
+
+	render_gfx_end_view(render);
+}
+
+static bool
+use_parallel_recording(const struct render_resources *r, uint32_t view_count)
+{
+	return r->parallel.group != NULL && view_count > 1 && view_count <= r->parallel.cmd_pool_count;
+}
+
+/// Worker function, records one view into a secondary command buffer.
+static void
+record_view_task(void *ptr)
+{
+	COMP_TRACE_MARKER();
+
+	struct gfx_layer_view_task *task = (struct gfx_layer_view_task *)ptr;
+
+	task->success = render_gfx_begin_secondary( //
+	    &task->sub,                             //
+	    task->r,                                //
+	    task->rtr,                              //
+	    task->view);                            // pool_index
+	if (!task->success) {
+		return;
+	}
+
+	write_view_layer_commands(&task->sub, task->view, task->viewport_data, task->state);
+
+	task->success = render_gfx_end_secondary(&task->sub);
+}
+
 
 /*
  *
@@ -702,6 +911,16 @@ comp_render_gfx_layers(struct render_gfx *render,
 		// Used to go from UV to tangent space.
 		render_calc_uv_to_tangent_lengths_rect(&new_fov, &state->to_tangent);
 
+		// The fragment shaders go from pixels to UV in the view.
+		const struct render_viewport_data *vp = &d->views[view].layer_viewport_data;
+		state->visibility.viewport = (struct xrt_normalized_rect){
+		    .x = (float)vp->x,
+		    .y = (float)vp->y,
+		    .w = 1.0f / (float)vp->w,
+		    .h = 1.0f / (float)vp->h,
+		};
+		state->visibility.spans = render->r->visibility.spans[view];
+
 		// Projection
 		struct xrt_matrix_4x4 p;
 		math_matrix_4x4_projection_vulkan_infinite_reverse(&new_fov, 0.1, &p);
@@ -750,6 +969,9 @@ comp_render_gfx_layers(struct render_gfx *render,
 				continue;
 			}
 
+			// Written before add_layer takes the slot, overwritten if no layer is added.
+			state->layer_indices[state->layer_count] = i;
+
 			switch (data->type) {
 			case XRT_LAYER_CYLINDER:
 				ret = do_cylinder_layer(   //
@@ -804,56 +1026,64 @@ comp_render_gfx_layers(struct render_gfx *render,
 
 	const VkClearColorValue *color = layer_count == 0 ? &background_color_idle : &background_color_active;
 
+	// Scopes are handed out here in order, the timestamps are written by whoever records the view.
 	for (uint32_t view = 0; view < d->view_count; view++) {
+		struct gfx_layer_view_state *state = &ls.views[view];
 
-		// Convenience.
-		const struct render_viewport_data *viewport_data = &d->views[view].layer_viewport_data;
+		for (uint32_t i = 0; i < state->layer_count; i++) {
+			state->timing_scopes[i] = render_timing_reserve( //
+			    &render->r->timing,                          //
+			    RENDER_TIMING_PASS_LAYERS,                   //
+			    state->layer_indices[i]);                    //
+		}
+	}
 
-		render_gfx_begin_target(    //
-		    render,                 //
-		    d->views[view].gfx.rtr, //
-		    color);                 //
+	struct gfx_layer_view_task tasks[XRT_MAX_VIEWS] = XRT_STRUCT_INIT;
+	bool parallel = use_parallel_recording(render->r, d->view_count);
 
-		render_gfx_begin_view( //
-		    render,            //
-		    view,              // view_index
-		    viewport_data);    // viewport_data
+	if (parallel) {
+		for (uint32_t view = 0; view < d->view_count; view++) {
+			tasks[view].r = render->r;
+			tasks[view].rtr = d->views[view].gfx.rtr;
+			tasks[view].viewport_data = &d->views[view].layer_viewport_data;
+			tasks[view].state = &ls.views[view];
+			tasks[view].view = view;
 
-		// Only source for data here, read only.
-		const struct gfx_layer_view_state *state = &ls.views[view];
+			u_worker_group_push(render->r->parallel.group, record_view_task, &tasks[view]);
+		}
 
-		for (uint32_t i = 0; i < state->layer_count; i++) {
-			switch (state->types[i]) {
-			case XRT_LAYER_CYLINDER:
-				render_gfx_layer_cylinder(          //
-				    render,                         //
-				    state->premultiplied_alphas[i], //
-				    state->descriptor_sets[i]);     //
-				break;
-			case XRT_LAYER_EQUIRECT2:
-				render_gfx_layer_equirect2(         //
-				    render,                         //
-				    state->premultiplied_alphas[i], //
-				    state->descriptor_sets[i]);     //
-				break;
-			case XRT_LAYER_PROJECTION:
-			case XRT_LAYER_PROJECTION_DEPTH:
-				render_gfx_layer_projection(        //
-				    render,                         //
-				    state->premultiplied_alphas[i], //
-				    state->descriptor_sets[i]);     //
-				break;
-			case XRT_LAYER_QUAD:
-				render_gfx_layer_quad(              //
-				    render,                         //
-				    state->premultiplied_alphas[i], //
-				    state->descriptor_sets[i]);     //
-				break;
-			default: break;
-			}
+		// Donates this thread, letting one more worker run while waiting.
+		u_worker_group_wait_all(render->r->parallel.group);
+	}
+
+	for (uint32_t view = 0; view < d->view_count; view++) {
+
+		if (parallel && tasks[view].success) {
+			render_gfx_begin_target_secondaries( //
+			    render,                          //
+			    d->views[view].gfx.rtr,          //
+			    color);                          //
+
+			render_gfx_execute_secondary(render, tasks[view].sub.cmd);
+
+			render_gfx_end_target(render);
+			continue;
 		}
 
-		render_gfx_end_view(render);
+		if (parallel) {
+			VK_ERROR(vk, "Failed to record view %u in parallel, recording it inline.", view);
+		}
+
+		render_gfx_begin_target(    //
+		    render,                 //
+		    d->views[view].gfx.rtr, //
+		    color);                 //
+
+		write_view_layer_commands(               //
+		    render,                              //
+		    view,                                //
+		    &d->views[view].layer_viewport_data, //
+		    &ls.views[view]);                    //
 
 		render_gfx_end_target(render);
 	}
@@ -879,6 +1109,67 @@ err_layer:
 
 
 
+void
+comp_render_gfx_squash(struct render_gfx *render,
+                       const struct comp_layer *layers,
+                       const uint32_t layer_count,
+                       const struct comp_render_dispatch_data *d)
+{
+	// We want to read from the images afterwards.
+	VkImageLayout transition_to = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+	assert(layer_count >= 1);
+
+	if (d->gfx.layer_cache != NULL) {
+		crg_layers_cached(  //
+		    render,         //
+		    layers,         //
+		    layer_count,    //
+		    d,              //
+		    transition_to); //
+	} else {
+		comp_render_gfx_layers( //
+		    render,             //
+		    layers,             //
+		    layer_count,        //
+		    d,                  //
+		    transition_to);     //
+	}
+}
+
+void
+comp_render_gfx_late_warp(struct render_gfx *render,
+                          const struct xrt_pose squashed_poses[XRT_MAX_VIEWS],
+                          const struct comp_render_dispatch_data *d)
+{
+	// Shared between all views.
+	VkSampler clamp_to_border_black = render->r->samplers.clamp_to_border_black;
+
+	struct gfx_mesh_data md = XRT_STRUCT_INIT;
+	for (uint32_t i = 0; i < d->view_count; i++) {
+		struct xrt_pose src_pose = squashed_poses[i];
+		struct xrt_fov src_fov = d->views[i].fov;
+		VkImageView src_image_view = d->views[i].srgb_view;
+		struct xrt_normalized_rect src_norm_rect = d->views[i].layer_norm_rect;
+
+		gfx_mesh_add_view(         //
+		    &md,                   //
+		    i,                     // view_index
+		    &src_pose,             //
+		    &src_fov,              //
+		    &src_norm_rect,        //
+		    clamp_to_border_black, // src_sampler
+		    src_image_view);       //
+	}
+
+	// Warp from the poses squashed with to the ones in the dispatch data.
+	crg_distortion_common( //
+	    render,            //
+	    d->do_timewarp,    //
+	    &md,               //
+	    d);                //
+}
+
 void
 comp_render_gfx_dispatch(struct render_gfx *render,
                          const struct comp_layer *layers,
@@ -894,9 +1185,6 @@ comp_render_gfx_dispatch(struct render_gfx *render,
 	// Consistency check.
 	assert(!fast_path || layer_count >= 1);
 
-	// We want to read from the images afterwards.
-	VkImageLayout transition_to = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
 	if (fast_path && layer->data.type == XRT_LAYER_PROJECTION) {
 		// Fast path.
 		const struct xrt_layer_projection_data *proj = &layer->data.proj;
@@ -932,12 +1220,11 @@ comp_render_gfx_dispatch(struct render_gfx *render,
 		/*
 		 * Layer squashing.
 		 */
-		comp_render_gfx_layers( //
+		comp_render_gfx_squash( //
 		    render,             //
 		    layers,             //
 		    layer_count,        //
-		    d,                  //
-		    transition_to);     //
+		    d);                 //
 
 		/*
 		 * Distortion.
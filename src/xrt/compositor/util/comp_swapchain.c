@@ -208,6 +208,7 @@ swapchain_release_image(struct xrt_swapchain *xsc, uint32_t index)
 	int res = u_index_fifo_push(&sc->fifo, index);
 
 	if (res >= 0) {
+		xrt_atomic_s32_inc_return(&sc->release_count);
 		return XRT_SUCCESS;
 	}
 	// FIFO full
@@ -304,14 +305,10 @@ cleanup_post_create_vulkan_setup(struct vk_bundle *vk, struct comp_swapchain *sc
 	}
 }
 
-static XRT_CHECK_RESULT xrt_result_t
-do_post_create_vulkan_setup(struct vk_bundle *vk,
-                            const struct xrt_swapchain_create_info *info,
-                            struct comp_swapchain *sc)
+static XRT_CHECK_RESULT VkResult
+create_image_views(struct vk_bundle *vk, const struct xrt_swapchain_create_info *info, struct comp_swapchain *sc)
 {
-	xrt_result_t xret = XRT_SUCCESS;
 	uint32_t image_count = sc->vkic.image_count;
-	VkCommandBuffer cmd_buffer;
 	VkResult ret;
 
 	VkComponentMapping components = {
@@ -332,9 +329,7 @@ do_post_create_vulkan_setup(struct vk_bundle *vk,
 		sc->images[i].views.no_alpha = U_TYPED_ARRAY_CALLOC(VkImageView, info->array_size);
 
 		if (!sc->images[i].views.alpha || !sc->images[i].views.no_alpha) {
-			cleanup_post_create_vulkan_setup(vk, sc);
-			//! @todo actually out of memory
-			return XRT_ERROR_VULKAN;
+			return VK_ERROR_OUT_OF_HOST_MEMORY;
 		}
 
 		sc->images[i].array_size = info->array_size;
@@ -356,7 +351,7 @@ do_post_create_vulkan_setup(struct vk_bundle *vk,
 			    subresource_range,                  // subresource_range
 			    &sc->images[i].views.alpha[layer]); // out_view
 
-			VK_CHK_WITH_GOTO(ret, "vk_create_view", error);
+			VK_CHK_AND_RET(ret, "vk_create_view");
 
 			VK_NAME_IMAGE_VIEW(vk, sc->images[i].views.alpha[layer], "comp_swapchain views alpha layer");
 
@@ -369,13 +364,39 @@ do_post_create_vulkan_setup(struct vk_bundle *vk,
 			    components,                            // components
 			    &sc->images[i].views.no_alpha[layer]); // out_view
 
-			VK_CHK_WITH_GOTO(ret, "vk_create_view_swizzle", error);
+			VK_CHK_AND_RET(ret, "vk_create_view_swizzle");
 
 			VK_NAME_IMAGE_VIEW(vk, sc->images[i].views.no_alpha[layer],
 			                   "comp_swapchain views no alpha layer");
 		}
 	}
 
+	return VK_SUCCESS;
+}
+
+/*!
+ * Creates the views unless @p views_from_pool is set, in which case they came
+ * with the recycled images, then does the rest of the setup for both cases.
+ */
+static XRT_CHECK_RESULT xrt_result_t
+do_post_create_vulkan_setup(struct vk_bundle *vk,
+                            const struct xrt_swapchain_create_info *info,
+                            struct comp_swapchain *sc,
+                            bool views_from_pool)
+{
+	xrt_result_t xret = XRT_SUCCESS;
+	uint32_t image_count = sc->vkic.image_count;
+	VkCommandBuffer cmd_buffer;
+	VkResult ret;
+
+	if (!views_from_pool) {
+		ret = create_image_views(vk, info, sc);
+		VK_CHK_WITH_GOTO(ret, "create_image_views", error);
+	}
+
+	// This is the format for the image view, it's not adjusted.
+	VkFormat image_view_format = (VkFormat)info->format;
+
 	// Prime the fifo
 	for (uint32_t i = 0; i < image_count; i++) {
 		u_index_fifo_push(&sc->fifo, i);
@@ -466,6 +487,67 @@ error:
 	return XRT_ERROR_VULKAN;
 }
 
+static bool
+take_from_pool(struct comp_swapchain *sc,
+               struct comp_swapchain_pool *image_pool,
+               const struct xrt_swapchain_create_info *info,
+               uint32_t image_count)
+{
+	if (image_pool == NULL) {
+		return false;
+	}
+
+	struct comp_swapchain_pool_entry entry;
+	if (!comp_swapchain_pool_take(image_pool, info, image_count, &entry)) {
+		return false;
+	}
+
+	sc->vkic = entry.vkic;
+	for (uint32_t i = 0; i < image_count; i++) {
+		sc->images[i].views.alpha = entry.views[i].alpha;
+		sc->images[i].views.no_alpha = entry.views[i].no_alpha;
+		sc->images[i].array_size = entry.array_size;
+	}
+
+	return true;
+}
+
+/*!
+ * Moves the images, memory and views to the pool, leaving nothing for the rest
+ * of teardown to free. The client is done with the images at this point, its
+ * imports were released when it destroyed the swapchain.
+ */
+static void
+give_to_pool(struct comp_swapchain *sc)
+{
+	struct vk_bundle *vk = sc->vk;
+	uint32_t image_count = sc->vkic.image_count;
+
+	// Same as image_cleanup, make sure no pending commands refer to the images.
+	os_mutex_lock(&vk->queue_mutex);
+	vk->vkDeviceWaitIdle(vk->device);
+	os_mutex_unlock(&vk->queue_mutex);
+
+	struct comp_swapchain_pool_entry entry = {
+	    .vkic = sc->vkic,
+	    .array_size = sc->images[0].array_size,
+	};
+
+	for (uint32_t i = 0; i < image_count; i++) {
+		entry.views[i].alpha = sc->images[i].views.alpha;
+		entry.views[i].no_alpha = sc->images[i].views.no_alpha;
+		entry.size += sc->vkic.images[i].size;
+
+		sc->images[i].views.alpha = NULL;
+		sc->images[i].views.no_alpha = NULL;
+		sc->images[i].array_size = 0;
+	}
+
+	U_ZERO(&sc->vkic);
+
+	comp_swapchain_pool_give(sc->image_pool, vk, &entry);
+}
+
 /*!
  * Swapchain destruct is delayed until it is safe to destroy them, this function
  * does the actual destruction and is called from @ref
@@ -494,6 +576,7 @@ comp_swapchain_create_init(struct comp_swapchain *sc,
                            comp_swapchain_destroy_func_t destroy_func,
                            struct vk_bundle *vk,
                            struct comp_swapchain_shared *cscs,
+                           struct comp_swapchain_pool *image_pool,
                            const struct xrt_swapchain_create_info *info,
                            const struct xrt_swapchain_create_properties *xsccp)
 {
@@ -513,8 +596,11 @@ comp_swapchain_create_init(struct comp_swapchain *sc,
 
 	set_common_fields(sc, destroy_func, vk, cscs, xsccp->image_count);
 
+	// Images of a destroyed swapchain with the same info skip allocation and view creation.
+	bool from_pool = take_from_pool(sc, image_pool, info, xsccp->image_count);
+
 	// Use the image helper to allocate the images.
-	ret = vk_ic_allocate(vk, info, xsccp->image_count, &sc->vkic);
+	ret = from_pool ? VK_SUCCESS : vk_ic_allocate(vk, info, xsccp->image_count, &sc->vkic);
 	if (ret == VK_ERROR_FEATURE_NOT_PRESENT) {
 		return XRT_ERROR_SWAPCHAIN_FLAG_VALID_BUT_UNSUPPORTED;
 	}
@@ -530,6 +616,9 @@ comp_swapchain_create_init(struct comp_swapchain *sc,
 	ret = vk_ic_get_handles(vk, &sc->vkic, ARRAY_SIZE(handles), handles);
 	if (ret != VK_SUCCESS) {
 		VK_ERROR(vk, "Failed to get native handles for images.");
+		if (from_pool) {
+			cleanup_post_create_vulkan_setup(vk, sc);
+		}
 		vk_ic_destroy(vk, &sc->vkic);
 		return XRT_ERROR_VULKAN;
 	}
@@ -539,12 +628,15 @@ comp_swapchain_create_init(struct comp_swapchain *sc,
 		sc->base.images[i].use_dedicated_allocation = sc->vkic.images[i].use_dedicated_allocation;
 	}
 
-	xrt_result_t res = do_post_create_vulkan_setup(vk, info, sc);
+	xrt_result_t res = do_post_create_vulkan_setup(vk, info, sc, from_pool);
 	if (res != XRT_SUCCESS) {
 		vk_ic_destroy(vk, &sc->vkic);
 		return res;
 	}
 
+	// Allocated by us, so safe to hand to another swapchain of the same client once destroyed.
+	comp_swapchain_pool_reference(&sc->image_pool, image_pool);
+
 	return XRT_SUCCESS;
 }
 
@@ -578,7 +670,7 @@ comp_swapchain_import_init(struct comp_swapchain *sc,
 		return XRT_ERROR_VULKAN;
 	}
 
-	xrt_result_t res = do_post_create_vulkan_setup(vk, info, sc);
+	xrt_result_t res = do_post_create_vulkan_setup(vk, info, sc, false);
 	if (res != XRT_SUCCESS) {
 		vk_ic_destroy(vk, &sc->vkic);
 		return res;
@@ -599,6 +691,8 @@ comp_swapchain_teardown(struct comp_swapchain *sc)
 		if (sc->images[i].use_count != 0) {
 			VK_ERROR(vk, "swapchain destroy while image %d use count %d", i, sc->images[i].use_count);
 			assert(false);
+			// Don't hand out images that are still in use.
+			comp_swapchain_pool_reference(&sc->image_pool, NULL);
 			continue; // leaking better than crashing?
 		}
 
@@ -606,8 +700,13 @@ comp_swapchain_teardown(struct comp_swapchain *sc)
 		pthread_cond_destroy(&sc->images[i].use_cond);
 	}
 
-	for (uint32_t i = 0; i < sc->base.base.image_count; i++) {
-		image_cleanup(vk, &sc->images[i]);
+	if (sc->image_pool != NULL) {
+		give_to_pool(sc);
+		comp_swapchain_pool_reference(&sc->image_pool, NULL);
+	} else {
+		for (uint32_t i = 0; i < sc->base.base.image_count; i++) {
+			image_cleanup(vk, &sc->images[i]);
+		}
 	}
 
 	for (uint32_t i = 0; i < sc->base.base.image_count; i++) {
@@ -679,6 +778,7 @@ comp_swapchain_get_create_properties(const struct xrt_swapchain_create_info *inf
 xrt_result_t
 comp_swapchain_create(struct vk_bundle *vk,
                       struct comp_swapchain_shared *cscs,
+                      struct comp_swapchain_pool *image_pool,
                       const struct xrt_swapchain_create_info *info,
                       const struct xrt_swapchain_create_properties *xsccp,
                       struct xrt_swapchain **out_xsc)
@@ -691,6 +791,7 @@ comp_swapchain_create(struct vk_bundle *vk,
 	    really_destroy,                //
 	    vk,                            //
 	    cscs,                          //
+	    image_pool,                    //
 	    info,                          //
 	    xsccp);                        //
 	if (xret != XRT_SUCCESS) {
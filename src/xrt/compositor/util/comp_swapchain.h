@@ -13,6 +13,8 @@
 #include "vk/vk_image_allocator.h"
 #include "vk/vk_cmd_pool.h"
 
+#include "util/comp_swapchain_pool.h"
+
 #include "util/u_threading.h"
 #include "util/u_index_fifo.h"
 
@@ -106,6 +108,16 @@ struct comp_swapchain
 
 	//! Virtual real destroy function.
 	comp_swapchain_destroy_func_t real_destroy;
+
+	/*!
+	 * Pool the images go back to on destroy, a reference is held so it
+	 * outlives the client that owns it. NULL if the images were imported or
+	 * the client does not pool them.
+	 */
+	struct comp_swapchain_pool *image_pool;
+
+	//! Number of successful image releases, changes whenever new content is released.
+	xrt_atomic_s32_t release_count;
 };
 
 
@@ -146,6 +158,7 @@ comp_swapchain_create_init(struct comp_swapchain *sc,
                            comp_swapchain_destroy_func_t destroy_func,
                            struct vk_bundle *vk,
                            struct comp_swapchain_shared *cscs,
+                           struct comp_swapchain_pool *image_pool,
                            const struct xrt_swapchain_create_info *info,
                            const struct xrt_swapchain_create_properties *xsccp);
 
@@ -222,13 +235,15 @@ comp_swapchain_get_create_properties(const struct xrt_swapchain_create_info *inf
                                      struct xrt_swapchain_create_properties *xsccp);
 
 /*!
- * A compositor function that is implemented in the swapchain code.
+ * A compositor function that is implemented in the swapchain code, the images
+ * are taken from and given back to @p image_pool if it is not NULL.
  *
  * @ingroup comp_util
  */
 xrt_result_t
 comp_swapchain_create(struct vk_bundle *vk,
                       struct comp_swapchain_shared *cscs,
+                      struct comp_swapchain_pool *image_pool,
                       const struct xrt_swapchain_create_info *info,
                       const struct xrt_swapchain_create_properties *xsccp,
                       struct xrt_swapchain **out_xsc);
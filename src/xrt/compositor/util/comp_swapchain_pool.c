@@ -0,0 +1,283 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Pool of swapchain images and views kept across destroy and create.
+ * @ingroup comp_util
+ */
+
+#include "util/u_misc.h"
+#include "util/u_var.h"
+
+#include "vk/vk_helpers.h"
+
+#include "util/comp_swapchain_pool.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+
+/*
+ *
+ * Helper functions.
+ *
+ */
+
+static bool
+info_matches(const struct xrt_swapchain_create_info *a, const struct xrt_swapchain_create_info *b)
+{
+	if (a->create != b->create ||             //
+	    a->bits != b->bits ||                 //
+	    a->format != b->format ||             //
+	    a->sample_count != b->sample_count || //
+	    a->width != b->width ||               //
+	    a->height != b->height ||             //
+	    a->face_count != b->face_count ||     //
+	    a->array_size != b->array_size ||     //
+	    a->mip_count != b->mip_count ||       //
+	    a->format_count != b->format_count) {
+		return false;
+	}
+
+	return memcmp(a->formats, b->formats, sizeof(a->formats[0]) * a->format_count) == 0;
+}
+
+static void
+view_array_destroy(struct vk_bundle *vk, size_t array_size, VkImageView **views_ptr)
+{
+	VkImageView *views = *views_ptr;
+
+	if (views == NULL) {
+		return;
+	}
+
+	for (size_t i = 0; i < array_size; i++) {
+		if (views[i] != VK_NULL_HANDLE) {
+			vk->vkDestroyImageView(vk->device, views[i], NULL);
+		}
+	}
+
+	free(views);
+
+	*views_ptr = NULL;
+}
+
+//! Remove the entry at @p index by moving the last entry into its place.
+static void
+remove_locked(struct comp_swapchain_pool *pool, uint32_t index, struct comp_swapchain_pool_entry *out_entry)
+{
+	*out_entry = pool->entries[index];
+
+	pool->stats.bytes -= out_entry->size;
+	pool->entry_count--;
+
+	if (index != pool->entry_count) {
+		pool->entries[index] = pool->entries[pool->entry_count];
+	}
+	U_ZERO(&pool->entries[pool->entry_count]);
+
+	pool->stats.entry_count = pool->entry_count;
+}
+
+static void
+evict_oldest_locked(struct comp_swapchain_pool *pool, struct vk_bundle *vk)
+{
+	uint32_t oldest = 0;
+	for (uint32_t i = 1; i < pool->entry_count; i++) {
+		if (pool->entries[i].last_used < pool->entries[oldest].last_used) {
+			oldest = i;
+		}
+	}
+
+	struct comp_swapchain_pool_entry entry;
+	remove_locked(pool, oldest, &entry);
+	comp_swapchain_pool_entry_destroy(vk, &entry);
+
+	pool->stats.evicted++;
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+void
+comp_swapchain_pool_init(struct comp_swapchain_pool *pool, VkDeviceSize max_bytes)
+{
+	U_ZERO(pool);
+	os_mutex_init(&pool->mutex);
+	pool->max_bytes = max_bytes;
+
+	if (max_bytes == 0) {
+		return;
+	}
+
+	// One per client, so number them.
+	u_var_add_root(pool, "Compositor swapchain pool", true);
+	u_var_add_ro_u64(pool, &pool->stats.hits, "Hits");
+	u_var_add_ro_u64(pool, &pool->stats.misses, "Misses");
+	u_var_add_ro_u64(pool, &pool->stats.recycled, "Recycled");
+	u_var_add_ro_u64(pool, &pool->stats.evicted, "Evicted");
+	u_var_add_ro_u64(pool, &pool->stats.bytes, "Bytes held");
+	u_var_add_ro_u32(pool, &pool->stats.entry_count, "Swapchains held");
+}
+
+void
+comp_swapchain_pool_fini(struct comp_swapchain_pool *pool, struct vk_bundle *vk)
+{
+	if (pool->max_bytes != 0) {
+		u_var_remove_root(pool);
+	}
+
+	os_mutex_lock(&pool->mutex);
+
+	while (pool->entry_count > 0) {
+		struct comp_swapchain_pool_entry entry;
+		remove_locked(pool, pool->entry_count - 1, &entry);
+		comp_swapchain_pool_entry_destroy(vk, &entry);
+	}
+
+	os_mutex_unlock(&pool->mutex);
+
+	os_mutex_destroy(&pool->mutex);
+}
+
+xrt_result_t
+comp_swapchain_pool_create(struct vk_bundle *vk, VkDeviceSize max_bytes, struct comp_swapchain_pool **out_pool)
+{
+	struct comp_swapchain_pool *pool = U_TYPED_CALLOC(struct comp_swapchain_pool);
+	comp_swapchain_pool_init(pool, max_bytes);
+	pool->vk = vk;
+
+	comp_swapchain_pool_reference(out_pool, pool);
+
+	return XRT_SUCCESS;
+}
+
+void
+comp_swapchain_pool_reference(struct comp_swapchain_pool **dst, struct comp_swapchain_pool *src)
+{
+	struct comp_swapchain_pool *old_dst = *dst;
+
+	if (old_dst == src) {
+		return;
+	}
+
+	if (src) {
+		xrt_reference_inc(&src->reference);
+	}
+
+	*dst = src;
+
+	if (old_dst == NULL || !xrt_reference_dec_and_is_zero(&old_dst->reference)) {
+		return;
+	}
+
+	struct vk_bundle *vk = old_dst->vk;
+	struct comp_swapchain_pool_stats stats;
+	comp_swapchain_pool_get_stats(old_dst, &stats);
+
+	VK_DEBUG(vk, "Swapchain pool: %" PRIu64 " hits, %" PRIu64 " misses, %" PRIu64 " recycled, %" PRIu64 " evicted",
+	         stats.hits, stats.misses, stats.recycled, stats.evicted);
+
+	comp_swapchain_pool_fini(old_dst, vk);
+	free(old_dst);
+}
+
+bool
+comp_swapchain_pool_take(struct comp_swapchain_pool *pool,
+                         const struct xrt_swapchain_create_info *info,
+                         uint32_t image_count,
+                         struct comp_swapchain_pool_entry *out_entry)
+{
+	if (pool->max_bytes == 0) {
+		return false;
+	}
+
+	os_mutex_lock(&pool->mutex);
+
+	// Most recently given back first, the same app tends to recreate the same swapchain.
+	int64_t found = -1;
+	for (uint32_t i = 0; i < pool->entry_count; i++) {
+		const struct comp_swapchain_pool_entry *e = &pool->entries[i];
+		if (e->vkic.image_count != image_count || !info_matches(&e->vkic.info, info)) {
+			continue;
+		}
+		if (found < 0 || e->last_used > pool->entries[found].last_used) {
+			found = i;
+		}
+	}
+
+	if (found >= 0) {
+		remove_locked(pool, (uint32_t)found, out_entry);
+		pool->stats.hits++;
+	} else {
+		pool->stats.misses++;
+	}
+
+	os_mutex_unlock(&pool->mutex);
+
+	return found >= 0;
+}
+
+bool
+comp_swapchain_pool_give(struct comp_swapchain_pool *pool,
+                         struct vk_bundle *vk,
+                         struct comp_swapchain_pool_entry *entry)
+{
+	if (pool->max_bytes == 0) {
+		comp_swapchain_pool_entry_destroy(vk, entry);
+		return false;
+	}
+
+	os_mutex_lock(&pool->mutex);
+
+	if (entry->size > pool->max_bytes) {
+		pool->stats.evicted++;
+		os_mutex_unlock(&pool->mutex);
+
+		comp_swapchain_pool_entry_destroy(vk, entry);
+		return false;
+	}
+
+	while (pool->entry_count >= COMP_SWAPCHAIN_POOL_MAX_ENTRIES ||
+	       pool->stats.bytes + entry->size > pool->max_bytes) {
+		evict_oldest_locked(pool, vk);
+	}
+
+	entry->last_used = ++pool->counter;
+	pool->entries[pool->entry_count++] = *entry;
+	pool->stats.bytes += entry->size;
+	pool->stats.entry_count = pool->entry_count;
+	pool->stats.recycled++;
+
+	os_mutex_unlock(&pool->mutex);
+
+	// Now owned by the pool.
+	U_ZERO(entry);
+
+	return true;
+}
+
+void
+comp_swapchain_pool_entry_destroy(struct vk_bundle *vk, struct comp_swapchain_pool_entry *entry)
+{
+	for (uint32_t i = 0; i < entry->vkic.image_count; i++) {
+		view_array_destroy(vk, entry->array_size, &entry->views[i].alpha);
+		view_array_destroy(vk, entry->array_size, &entry->views[i].no_alpha);
+	}
+
+	vk_ic_destroy(vk, &entry->vkic);
+
+	U_ZERO(entry);
+}
+
+void
+comp_swapchain_pool_get_stats(struct comp_swapchain_pool *pool, struct comp_swapchain_pool_stats *out_stats)
+{
+	os_mutex_lock(&pool->mutex);
+	*out_stats = pool->stats;
+	os_mutex_unlock(&pool->mutex);
+}
@@ -0,0 +1,220 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Pool of swapchain images and views kept across destroy and create.
+ * @ingroup comp_util
+ */
+
+#pragma once
+
+#include "os/os_threading.h"
+
+#include "vk/vk_image_allocator.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*
+ *
+ * Defines.
+ *
+ */
+
+//! Max number of swapchains worth of images held by the pool.
+#define COMP_SWAPCHAIN_POOL_MAX_ENTRIES (16)
+
+
+/*
+ *
+ * Structs.
+ *
+ */
+
+/*!
+ * The images, memory and views of one destroyed swapchain, ready to back a
+ * new swapchain with the exact same create info and image count.
+ *
+ * @ingroup comp_util
+ */
+struct comp_swapchain_pool_entry
+{
+	//! Images and their exportable memory, also holds the create info.
+	struct vk_image_collection vkic;
+
+	//! Views for each image, same layout as on @ref comp_swapchain_image.
+	struct
+	{
+		VkImageView *alpha;
+		VkImageView *no_alpha;
+	} views[XRT_MAX_SWAPCHAIN_IMAGES];
+
+	//! Number of views per image, the array size of the swapchain.
+	size_t array_size;
+
+	//! Total memory size of all images.
+	VkDeviceSize size;
+
+	//! When this entry was last given back, for evicting.
+	uint64_t last_used;
+};
+
+/*!
+ * Statistics of a @ref comp_swapchain_pool.
+ *
+ * @ingroup comp_util
+ */
+struct comp_swapchain_pool_stats
+{
+	//! Creates that got their images from the pool.
+	uint64_t hits;
+
+	//! Creates that had to allocate.
+	uint64_t misses;
+
+	//! Destroyed swapchains whose images were kept.
+	uint64_t recycled;
+
+	//! Kept images freed to make room, or too large to keep at all.
+	uint64_t evicted;
+
+	//! Memory currently held.
+	uint64_t bytes;
+
+	//! Swapchains worth of images currently held.
+	uint32_t entry_count;
+};
+
+/*!
+ * Holds on to the images of destroyed swapchains, up to a memory budget, so
+ * that apps recreating swapchains do not pay for the allocations, exports
+ * and views every time. The least recently given back entry is evicted
+ * first. Thread safe.
+ *
+ * The images of a swapchain are exported to the client as whole allocations,
+ * so recycling is done at the granularity of whole swapchains. Recycled
+ * images keep their old contents, so a pool must only ever be used by the
+ * swapchains of one client.
+ *
+ * Either embedded and used with @ref comp_swapchain_pool_init, or created
+ * with @ref comp_swapchain_pool_create and reference counted, each swapchain
+ * holds a reference as it gives its images back after the client is gone.
+ *
+ * @ingroup comp_util
+ */
+struct comp_swapchain_pool
+{
+	//! Only used by created pools.
+	struct xrt_reference reference;
+
+	//! Frees the held images when the last reference goes, only used by created pools.
+	struct vk_bundle *vk;
+
+	struct os_mutex mutex;
+
+	struct comp_swapchain_pool_entry entries[COMP_SWAPCHAIN_POOL_MAX_ENTRIES];
+	uint32_t entry_count;
+
+	//! Max memory held, zero disables the pool.
+	VkDeviceSize max_bytes;
+
+	//! Used to order entries for eviction.
+	uint64_t counter;
+
+	struct comp_swapchain_pool_stats stats;
+};
+
+
+/*
+ *
+ * Functions.
+ *
+ */
+
+/*!
+ * Init the pool, a @p max_bytes of zero disables it. Only enabled pools show
+ * up in the debug UI.
+ *
+ * @ingroup comp_util
+ */
+void
+comp_swapchain_pool_init(struct comp_swapchain_pool *pool, VkDeviceSize max_bytes);
+
+/*!
+ * Allocate and init a reference counted pool, @p vk has to outlive it.
+ *
+ * @ingroup comp_util
+ */
+XRT_CHECK_RESULT xrt_result_t
+comp_swapchain_pool_create(struct vk_bundle *vk, VkDeviceSize max_bytes, struct comp_swapchain_pool **out_pool);
+
+/*!
+ * Update the reference counts on created pools, the last reference frees the
+ * pool and all images held by it.
+ *
+ * @param[in,out] dst Pointer to a object reference, if the object reference is
+ *                    non-null will decrement its counter. The reference that
+ *                    @p dst points to will be set to @p src.
+ * @param[in] src New object for @p dst to refer to (may be null).
+ *                If non-null, will have its refcount increased.
+ * @ingroup comp_util
+ */
+void
+comp_swapchain_pool_reference(struct comp_swapchain_pool **dst, struct comp_swapchain_pool *src);
+
+/*!
+ * Free all held images and views, the images must not be in use on the GPU.
+ *
+ * @ingroup comp_util
+ */
+void
+comp_swapchain_pool_fini(struct comp_swapchain_pool *pool, struct vk_bundle *vk);
+
+/*!
+ * Take the images of a destroyed swapchain with the same @p info and
+ * @p image_count, returns false and counts a miss if there are none.
+ *
+ * @ingroup comp_util
+ */
+bool
+comp_swapchain_pool_take(struct comp_swapchain_pool *pool,
+                         const struct xrt_swapchain_create_info *info,
+                         uint32_t image_count,
+                         struct comp_swapchain_pool_entry *out_entry);
+
+/*!
+ * Give the images of a destroyed swapchain to the pool, always takes
+ * ownership: they are either kept, or freed if they do not fit the budget.
+ * The images must not be in use on the GPU.
+ *
+ * @return true if the images were kept.
+ * @ingroup comp_util
+ */
+bool
+comp_swapchain_pool_give(struct comp_swapchain_pool *pool,
+                         struct vk_bundle *vk,
+                         struct comp_swapchain_pool_entry *entry);
+
+/*!
+ * Free the images and views of an entry that is not in a pool.
+ *
+ * @ingroup comp_util
+ */
+void
+comp_swapchain_pool_entry_destroy(struct vk_bundle *vk, struct comp_swapchain_pool_entry *entry);
+
+/*!
+ * Get a copy of the statistics.
+ *
+ * @ingroup comp_util
+ */
+void
+comp_swapchain_pool_get_stats(struct comp_swapchain_pool *pool, struct comp_swapchain_pool_stats *out_stats);
+
+
+#ifdef __cplusplus
+}
+#endif
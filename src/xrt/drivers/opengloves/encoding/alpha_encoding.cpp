@@ -7,15 +7,17 @@
  * @ingroup drv_opengloves
  */
 
-#include <string>
-#include <stdexcept>
-
-#include <map>
 #include "util/u_logging.h"
 
 #include "alpha_encoding.h"
 #include "encoding.h"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
 enum opengloves_alpha_encoding_key
 {
 	OPENGLOVES_ALPHA_ENCODING_FinThumb,
@@ -80,17 +82,19 @@ enum opengloves_alpha_encoding_key
 	OPENGLOVES_ALPHA_ENCODING_MAX
 };
 
-#define OPENGLOVES_ALPHA_ENCODING_VAL_IN_MAP_E_0
-
-static const std::string opengloves_alpha_encoding_key_characters = "ABCDEFGHIJKLMNOPQRSTUVWXYZ()";
+/*!
+ * Values above this are clamped while parsing, well outside of what any
+ * firmware sends but keeps the accumulator from overflowing on junk.
+ */
+#define OPENGLOVES_ALPHA_ENCODING_MAX_PARSED_VALUE 99999999u
 
-static bool
-opengloves_alpha_encoding_is_key_character(const char character)
+struct opengloves_alpha_encoding_key_entry
 {
-	return opengloves_alpha_encoding_key_characters.find(character) != std::string::npos;
-}
+	std::string_view str;
+	enum opengloves_alpha_encoding_key key;
+};
 
-static const std::map<std::string, int> opengloves_alpha_encoding_input_key_string{
+static constexpr opengloves_alpha_encoding_key_entry opengloves_alpha_encoding_input_keys[] = {
     {"A", OPENGLOVES_ALPHA_ENCODING_FinThumb},         // whole thumb curl (default curl value for thumb joints)
     {"(AB)", OPENGLOVES_ALPHA_ENCODING_FinSplayThumb}, // whole thumb splay thumb joint 3 (doesn't exist, but keeps
                                                        // consistency with the other fingers
@@ -137,138 +141,242 @@ static const std::map<std::string, int> opengloves_alpha_encoding_input_key_stri
     {"N", OPENGLOVES_ALPHA_ENCODING_BtnMenu},             // system button pressed (opens SteamVR menu)
     {"O", OPENGLOVES_ALPHA_ENCODING_BtnCalib},            // calibration button
     {"P", OPENGLOVES_ALPHA_ENCODING_TrgValue},            // analog trigger value
-    {"", OPENGLOVES_ALPHA_ENCODING_MAX}                   // Junk key
 };
 
-static const std::map<int, std::string> opengloves_alpha_encoding_output_key_string{
-    {OPENGLOVES_ALPHA_ENCODING_FinThumb, "A"},  // thumb force feedback
-    {OPENGLOVES_ALPHA_ENCODING_FinIndex, "B"},  // index force feedback
-    {OPENGLOVES_ALPHA_ENCODING_FinMiddle, "C"}, // middle force feedback
-    {OPENGLOVES_ALPHA_ENCODING_FinRing, "D"},   // ring force feedback
-    {OPENGLOVES_ALPHA_ENCODING_FinPinky, "E"},  // pinky force feedback
-};
+//! Force feedback keys, indexed by finger.
+static constexpr char opengloves_alpha_encoding_output_keys[5] = {'A', 'B', 'C', 'D', 'E'};
+
+static constexpr bool
+opengloves_alpha_encoding_is_key_character(char c)
+{
+	return (c >= 'A' && c <= 'Z') || c == '(' || c == ')';
+}
 
-static std::map<int, std::string>
-opengloves_alpha_encoding_parse_to_map(const std::string &str)
+static constexpr bool
+opengloves_alpha_encoding_is_digit(char c)
 {
-	std::map<int, std::string> result;
+	return c >= '0' && c <= '9';
+}
 
+/*!
+ * Packs a key of up to 8 characters into an integer, so that long keys can be
+ * compared with a single instruction, longer keys pack to zero which is never
+ * a valid key.
+ */
+static constexpr uint64_t
+opengloves_alpha_encoding_pack(const char *str, size_t len)
+{
+	if (len > sizeof(uint64_t)) {
+		return 0;
+	}
+
+	uint64_t packed = 0;
+	for (size_t i = 0; i < len; i++) {
+		packed = (packed << 8) | (uint8_t)str[i];
+	}
+	return packed;
+}
+
+//! Single letter keys, indexed by letter.
+static constexpr auto opengloves_alpha_encoding_short_keys = [] {
+	std::array<uint8_t, 26> table = {};
+	for (auto &t : table) {
+		t = OPENGLOVES_ALPHA_ENCODING_MAX;
+	}
+	for (const auto &e : opengloves_alpha_encoding_input_keys) {
+		if (e.str.size() == 1) {
+			table[e.str[0] - 'A'] = (uint8_t)e.key;
+		}
+	}
+	return table;
+}();
+
+struct opengloves_alpha_encoding_long_key
+{
+	uint64_t packed;
+	enum opengloves_alpha_encoding_key key;
+};
+
+static constexpr size_t opengloves_alpha_encoding_long_key_count = [] {
+	size_t count = 0;
+	for (const auto &e : opengloves_alpha_encoding_input_keys) {
+		count += e.str.size() > 1 ? 1 : 0;
+	}
+	return count;
+}();
+
+//! Bracketed keys, packed and sorted for binary search.
+static constexpr auto opengloves_alpha_encoding_long_keys = [] {
+	std::array<opengloves_alpha_encoding_long_key, opengloves_alpha_encoding_long_key_count> table = {};
 	size_t i = 0;
-	while (i < str.length()) {
-		// Advance until we get an alphabetic character (no point in looking at values that don't have a key
+	for (const auto &e : opengloves_alpha_encoding_input_keys) {
+		if (e.str.size() > 1) {
+			table[i++] = {opengloves_alpha_encoding_pack(e.str.data(), e.str.size()), e.key};
+		}
+	}
+	std::sort(table.begin(), table.end(), [](const auto &a, const auto &b) { return a.packed < b.packed; });
+	return table;
+}();
+
+static_assert(OPENGLOVES_ALPHA_ENCODING_MAX < UINT8_MAX, "Key must fit in the short key table");
+static_assert(opengloves_alpha_encoding_short_keys['P' - 'A'] == OPENGLOVES_ALPHA_ENCODING_TrgValue);
+static_assert(opengloves_alpha_encoding_short_keys['Z' - 'A'] == OPENGLOVES_ALPHA_ENCODING_MAX);
+
+static enum opengloves_alpha_encoding_key
+opengloves_alpha_encoding_lookup(const char *str, size_t len)
+{
+	if (len == 1) {
+		if (str[0] < 'A' || str[0] > 'Z') {
+			return OPENGLOVES_ALPHA_ENCODING_MAX;
+		}
+		return (enum opengloves_alpha_encoding_key)opengloves_alpha_encoding_short_keys[str[0] - 'A'];
+	}
+
+	uint64_t packed = opengloves_alpha_encoding_pack(str, len);
+	const auto &table = opengloves_alpha_encoding_long_keys;
+	auto it = std::lower_bound(table.begin(), table.end(), packed,
+	                           [](const auto &e, uint64_t p) { return e.packed < p; });
+	if (it == table.end() || it->packed != packed) {
+		return OPENGLOVES_ALPHA_ENCODING_MAX;
+	}
+
+	return it->key;
+}
+
+/*!
+ * Everything found in one packet, lives on the stack.
+ */
+struct opengloves_alpha_encoding_packet
+{
+	float value[OPENGLOVES_ALPHA_ENCODING_MAX];
+
+	//! The key had digits after it, only these are used for analog values.
+	bool has_value[OPENGLOVES_ALPHA_ENCODING_MAX];
+
+	//! The key was in the packet at all, buttons are only sent when pressed.
+	bool present[OPENGLOVES_ALPHA_ENCODING_MAX];
+};
+
+/*!
+ * Single pass over the packet, a key is either a single letter or a bracketed
+ * run of key characters, optionally followed by a decimal value. Anything else
+ * between keys is skipped, later keys override earlier ones.
+ */
+static void
+opengloves_alpha_encoding_tokenize(const char *data, struct opengloves_alpha_encoding_packet *pkt)
+{
+	const char *p = data;
+
+	while (*p != '\0') {
+		// Advance until we get a key character (no point in looking at values that don't have a key
 		// associated with them)
+		if (!opengloves_alpha_encoding_is_key_character(*p)) {
+			p++;
+			continue;
+		}
 
-		if (str[i] >= 0 && opengloves_alpha_encoding_is_key_character(str[i])) {
-			std::string key = {str[i]};
-			i++;
-
-			// we're going to be parsing a "long key", i.e. (AB) for thumb finger splay. Long keys must
-			// always be enclosed in brackets
-			if (key[0] == '(') {
-				while (str[i] >= 0 && opengloves_alpha_encoding_is_key_character(str[i]) &&
-				       i < str.length()) {
-					key += str[i];
-					i++;
-				}
-			}
+		const char *key = p++;
 
-			std::string value;
-			while (str[i] >= 0 && isdigit(str[i]) && i < str.length()) {
-				value += str[i];
-				i++;
+		// we're going to be parsing a "long key", i.e. (AB) for thumb finger splay. Long keys must
+		// always be enclosed in brackets
+		if (*key == '(') {
+			while (opengloves_alpha_encoding_is_key_character(*p)) {
+				p++;
+			}
+		}
+		size_t key_len = (size_t)(p - key);
+
+		bool has_value = false;
+		uint32_t value = 0;
+		while (opengloves_alpha_encoding_is_digit(*p)) {
+			value = value * 10 + (uint32_t)(*p - '0');
+			if (value > OPENGLOVES_ALPHA_ENCODING_MAX_PARSED_VALUE) {
+				value = OPENGLOVES_ALPHA_ENCODING_MAX_PARSED_VALUE;
 			}
+			has_value = true;
+			p++;
+		}
 
-			// Even if the value is empty we still want to use the key, it means that we have a button that
-			// is pressed (it only appears in the packet if it is)
-			if (opengloves_alpha_encoding_input_key_string.find(key) !=
-			    opengloves_alpha_encoding_input_key_string.end())
-				result.insert_or_assign(opengloves_alpha_encoding_input_key_string.at(key), value);
-			else
-				U_LOG_W("Unable to insert key: %s into input map as it was not found", key.c_str());
-		} else
-			i++;
-	}
+		enum opengloves_alpha_encoding_key k = opengloves_alpha_encoding_lookup(key, key_len);
+		if (k == OPENGLOVES_ALPHA_ENCODING_MAX) {
+			U_LOG_W("Unable to insert key: %.*s into input map as it was not found", (int)key_len, key);
+			continue;
+		}
 
-	return result;
+		// Even if the value is empty we still want to use the key, it means that we have a button that
+		// is pressed (it only appears in the packet if it is)
+		pkt->present[k] = true;
+		pkt->has_value[k] = has_value;
+		pkt->value[k] = (float)value;
+	}
 }
 
 
 void
 opengloves_alpha_encoding_decode(const char *data, struct opengloves_input *out)
 {
-	std::map<int, std::string> input_map = opengloves_alpha_encoding_parse_to_map(data);
-
-	try {
-		// five fingers, 2 (curl + splay)
-		for (int i = 0; i < 5; i++) {
-			int enum_position = i * 2;
-			// curls
-			if (input_map.find(enum_position) != input_map.end()) {
-				float fin_curl_value = std::stof(input_map.at(enum_position));
-				std::fill(std::begin(out->flexion[i]), std::begin(out->flexion[i]) + 4,
-				          fin_curl_value / OPENGLOVES_ENCODING_MAX_ANALOG_VALUE);
+	struct opengloves_alpha_encoding_packet pkt = {};
+	opengloves_alpha_encoding_tokenize(data, &pkt);
+
+	// five fingers, 2 (curl + splay)
+	for (int i = 0; i < 5; i++) {
+		int enum_position = i * 2;
+		// curls
+		if (pkt.has_value[enum_position]) {
+			float fin_curl_value = pkt.value[enum_position] / OPENGLOVES_ENCODING_MAX_ANALOG_VALUE;
+			for (int j = 0; j < 4; j++) {
+				out->flexion[i][j] = fin_curl_value;
 			}
+		}
 
-			// splay
-			if (input_map.find(enum_position + 1) != input_map.end())
-				out->splay[i] =
-				    (std::stof(input_map.at(enum_position + 1)) / OPENGLOVES_ENCODING_MAX_ANALOG_VALUE -
-				     0.5f) *
-				    2.0f;
+		// splay
+		if (pkt.has_value[enum_position + 1]) {
+			out->splay[i] = (pkt.value[enum_position + 1] / OPENGLOVES_ENCODING_MAX_ANALOG_VALUE - 0.5f) * 2.0f;
 		}
+	}
 
-		int current_finger_joint = OPENGLOVES_ALPHA_ENCODING_FinJointThumb0;
-		for (int i = 0; i < 5; i++) {
-			for (int j = 0; j < 4; j++) {
-				// individual joint curls
-				out->flexion[i][j] = input_map.find(current_finger_joint) != input_map.end()
-				                         ? (std::stof(input_map.at(current_finger_joint)) /
-				                            OPENGLOVES_ENCODING_MAX_ANALOG_VALUE)
-				                         // use the curl of the previous joint
-				                         : out->flexion[i][j > 0 ? j - 1 : 0];
-				current_finger_joint++;
-			}
+	int current_finger_joint = OPENGLOVES_ALPHA_ENCODING_FinJointThumb0;
+	for (int i = 0; i < 5; i++) {
+		for (int j = 0; j < 4; j++) {
+			// individual joint curls
+			out->flexion[i][j] = pkt.has_value[current_finger_joint]
+			                         ? pkt.value[current_finger_joint] / OPENGLOVES_ENCODING_MAX_ANALOG_VALUE
+			                         // use the curl of the previous joint
+			                         : out->flexion[i][j > 0 ? j - 1 : 0];
+			current_finger_joint++;
 		}
+	}
 
-		// joysticks
-		if (input_map.find(OPENGLOVES_ALPHA_ENCODING_JoyX) != input_map.end())
-			out->joysticks.main.x = 2 * std::stof(input_map.at(OPENGLOVES_ALPHA_ENCODING_JoyX)) /
-			                            OPENGLOVES_ENCODING_MAX_ANALOG_VALUE -
-			                        1;
-		if (input_map.find(OPENGLOVES_ALPHA_ENCODING_JoyY) != input_map.end())
-			out->joysticks.main.y = 2 * std::stof(input_map.at(OPENGLOVES_ALPHA_ENCODING_JoyY)) /
-			                            OPENGLOVES_ENCODING_MAX_ANALOG_VALUE -
-			                        1;
-		out->joysticks.main.pressed = input_map.find(OPENGLOVES_ALPHA_ENCODING_JoyBtn) != input_map.end();
-
-	} catch (std::invalid_argument &e) {
-		U_LOG_E("Error parsing input string: %s", e.what());
+	// joysticks
+	if (pkt.has_value[OPENGLOVES_ALPHA_ENCODING_JoyX]) {
+		out->joysticks.main.x =
+		    2 * pkt.value[OPENGLOVES_ALPHA_ENCODING_JoyX] / OPENGLOVES_ENCODING_MAX_ANALOG_VALUE - 1;
 	}
+	if (pkt.has_value[OPENGLOVES_ALPHA_ENCODING_JoyY]) {
+		out->joysticks.main.y =
+		    2 * pkt.value[OPENGLOVES_ALPHA_ENCODING_JoyY] / OPENGLOVES_ENCODING_MAX_ANALOG_VALUE - 1;
+	}
+	out->joysticks.main.pressed = pkt.present[OPENGLOVES_ALPHA_ENCODING_JoyBtn];
 
-	if (input_map.find(OPENGLOVES_ALPHA_ENCODING_TrgValue) != input_map.end())
+	if (pkt.has_value[OPENGLOVES_ALPHA_ENCODING_TrgValue]) {
 		out->buttons.trigger.value =
-		    std::stof(input_map.at(OPENGLOVES_ALPHA_ENCODING_TrgValue)) / OPENGLOVES_ENCODING_MAX_ANALOG_VALUE;
-	out->buttons.trigger.pressed = input_map.find(OPENGLOVES_ALPHA_ENCODING_BtnTrg) != input_map.end();
-
-	out->buttons.A.pressed = input_map.find(OPENGLOVES_ALPHA_ENCODING_BtnA) != input_map.end();
-	out->buttons.B.pressed = input_map.find(OPENGLOVES_ALPHA_ENCODING_BtnB) != input_map.end();
-	out->gestures.grab.activated = input_map.find(OPENGLOVES_ALPHA_ENCODING_GesGrab) != input_map.end();
-	out->gestures.pinch.activated = input_map.find(OPENGLOVES_ALPHA_ENCODING_GesPinch) != input_map.end();
-	out->buttons.menu.pressed = input_map.find(OPENGLOVES_ALPHA_ENCODING_BtnMenu) != input_map.end();
+		    pkt.value[OPENGLOVES_ALPHA_ENCODING_TrgValue] / OPENGLOVES_ENCODING_MAX_ANALOG_VALUE;
+	}
+	out->buttons.trigger.pressed = pkt.present[OPENGLOVES_ALPHA_ENCODING_BtnTrg];
+
+	out->buttons.A.pressed = pkt.present[OPENGLOVES_ALPHA_ENCODING_BtnA];
+	out->buttons.B.pressed = pkt.present[OPENGLOVES_ALPHA_ENCODING_BtnB];
+	out->gestures.grab.activated = pkt.present[OPENGLOVES_ALPHA_ENCODING_GesGrab];
+	out->gestures.pinch.activated = pkt.present[OPENGLOVES_ALPHA_ENCODING_GesPinch];
+	out->buttons.menu.pressed = pkt.present[OPENGLOVES_ALPHA_ENCODING_BtnMenu];
 }
 
 void
 opengloves_alpha_encoding_encode(const struct opengloves_output *output, char *out_buff)
 {
-	sprintf(out_buff, "%s%d%s%d%s%d%s%d%s%d\n",
-	        opengloves_alpha_encoding_output_key_string.at(OPENGLOVES_ALPHA_ENCODING_FinThumb).c_str(),
-	        (int)(output->force_feedback.thumb * 1000),
-	        opengloves_alpha_encoding_output_key_string.at(OPENGLOVES_ALPHA_ENCODING_FinIndex).c_str(),
-	        (int)(output->force_feedback.index * 1000),
-	        opengloves_alpha_encoding_output_key_string.at(OPENGLOVES_ALPHA_ENCODING_FinMiddle).c_str(),
-	        (int)(output->force_feedback.middle * 1000),
-	        opengloves_alpha_encoding_output_key_string.at(OPENGLOVES_ALPHA_ENCODING_FinRing).c_str(),
-	        (int)(output->force_feedback.ring * 1000),
-	        opengloves_alpha_encoding_output_key_string.at(OPENGLOVES_ALPHA_ENCODING_FinPinky).c_str(),
-	        (int)(output->force_feedback.little * 1000));
+	const char *k = opengloves_alpha_encoding_output_keys;
+
+	sprintf(out_buff, "%c%d%c%d%c%d%c%d%c%d\n", k[0], (int)(output->force_feedback.thumb * 1000), k[1],
+	        (int)(output->force_feedback.index * 1000), k[2], (int)(output->force_feedback.middle * 1000), k[3],
+	        (int)(output->force_feedback.ring * 1000), k[4], (int)(output->force_feedback.little * 1000));
 }
@@ -0,0 +1,633 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Devices serving the calls recorded in a capture file.
+ * @ingroup drv_replay
+ */
+
+#include "os/os_time.h"
+#include "os/os_threading.h"
+
+#include "math/m_api.h"
+
+#include "util/u_misc.h"
+#include "util/u_debug.h"
+#include "util/u_device.h"
+#include "util/u_logging.h"
+#include "util/u_capture.h"
+#include "util/u_distortion_mesh.h"
+
+#include "replay_interface.h"
+
+#include <stdio.h>
+#include <string.h>
+
+
+DEBUG_GET_ONCE_LOG_OPTION(replay_log, "REPLAY_LOG", U_LOGGING_INFO)
+
+
+/*
+ *
+ * Structs and defines.
+ *
+ */
+
+/*!
+ * The mapped capture, shared by all devices created from it.
+ */
+struct replay_session
+{
+	struct xrt_reference reference;
+
+	struct u_capture_reader reader;
+
+	//! All devices share one origin, the recorded poses are already in it.
+	struct xrt_tracking_origin origin;
+
+	enum replay_mode mode;
+
+	//! Added to recorded times to get the current clock, zero in fast mode.
+	int64_t offset_ns;
+};
+
+/*!
+ * All records of one call and name on a device, in capture order.
+ */
+struct replay_stream
+{
+	enum u_capture_record_type type;
+	uint32_t name;
+
+	const struct u_capture_record_header **records;
+	uint32_t record_count;
+
+	//! Number of records counted in the first pass, the size of @ref records.
+	uint32_t record_capacity;
+
+	/*!
+	 * In realtime mode the latest record that has happened, for inputs the
+	 * next record to apply. In fast mode the next record to serve.
+	 */
+	uint32_t cursor;
+};
+
+/*!
+ * A device from a capture.
+ *
+ * @implements xrt_device
+ */
+struct replay_device
+{
+	struct xrt_device base;
+
+	struct replay_session *session;
+
+	enum u_logging_level log_level;
+
+	//! Protects the stream cursors.
+	struct os_mutex mutex;
+
+	struct replay_stream *streams;
+	uint32_t stream_count;
+};
+
+static inline struct replay_device *
+replay_device(struct xrt_device *xdev)
+{
+	return (struct replay_device *)xdev;
+}
+
+
+/*
+ *
+ * Session functions.
+ *
+ */
+
+static void
+session_reference(struct replay_session **dst, struct replay_session *src)
+{
+	struct replay_session *old_dst = *dst;
+
+	if (old_dst == src) {
+		return;
+	}
+
+	if (src) {
+		xrt_reference_inc(&src->reference);
+	}
+
+	*dst = src;
+
+	if (old_dst) {
+		if (xrt_reference_dec_and_is_zero(&old_dst->reference)) {
+			u_capture_reader_close(&old_dst->reader);
+			free(old_dst);
+		}
+	}
+}
+
+static inline int64_t
+session_recorded_now(struct replay_session *session)
+{
+	return os_monotonic_get_ns() - session->offset_ns;
+}
+
+
+/*
+ *
+ * Stream functions.
+ *
+ */
+
+static struct replay_stream *
+find_stream(struct replay_device *d, enum u_capture_record_type type, uint32_t name)
+{
+	for (uint32_t i = 0; i < d->stream_count; i++) {
+		if (d->streams[i].type == type && d->streams[i].name == name) {
+			return &d->streams[i];
+		}
+	}
+
+	return NULL;
+}
+
+static struct replay_stream *
+find_or_add_stream(struct replay_device *d, enum u_capture_record_type type, uint32_t name)
+{
+	struct replay_stream *stream = find_stream(d, type, name);
+	if (stream != NULL) {
+		return stream;
+	}
+
+	U_ARRAY_REALLOC_OR_FREE(d->streams, struct replay_stream, d->stream_count + 1);
+	stream = &d->streams[d->stream_count++];
+	U_ZERO(stream);
+	stream->type = type;
+	stream->name = name;
+
+	return stream;
+}
+
+/*!
+ * Pick the record to serve for a query on this stream, NULL if there is
+ * none, must be called with the device mutex held.
+ */
+static const void *
+stream_pick_locked(struct replay_device *d, struct replay_stream *stream)
+{
+	if (stream == NULL || stream->record_count == 0) {
+		return NULL;
+	}
+
+	uint32_t index;
+	if (d->session->mode == REPLAY_MODE_FAST) {
+		// Serve every record once, then keep serving the last.
+		index = MIN(stream->cursor, stream->record_count - 1);
+		if (stream->cursor < stream->record_count) {
+			stream->cursor++;
+		}
+	} else {
+		// Time only moves forward, so does the cursor.
+		int64_t recorded_now = session_recorded_now(d->session);
+		while (stream->cursor + 1 < stream->record_count &&
+		       stream->records[stream->cursor + 1]->timestamp_ns <= recorded_now) {
+			stream->cursor++;
+		}
+		index = stream->cursor;
+	}
+
+	return stream->records[index] + 1;
+}
+
+/*!
+ * Copy the record to serve for a query into @p out, returns false if the
+ * stream does not exist or has no records.
+ */
+static bool
+pick(struct replay_device *d, enum u_capture_record_type type, uint32_t name, void *out, size_t size)
+{
+	os_mutex_lock(&d->mutex);
+
+	const void *payload = stream_pick_locked(d, find_stream(d, type, name));
+	if (payload != NULL) {
+		memcpy(out, payload, size);
+	}
+
+	os_mutex_unlock(&d->mutex);
+
+	return payload != NULL;
+}
+
+/*!
+ * Is this a record that is served back by the devices.
+ */
+static bool
+is_replayed_record(const struct u_capture_record_header *header, uint32_t device_count)
+{
+	if (header->device_index >= device_count) {
+		return false;
+	}
+
+	switch (header->type) {
+	case U_CAPTURE_RECORD_INPUTS:
+	case U_CAPTURE_RECORD_TRACKED_POSE:
+	case U_CAPTURE_RECORD_HAND_TRACKING:
+	case U_CAPTURE_RECORD_VIEW_POSES:
+	case U_CAPTURE_RECORD_BODY_JOINTS: return true;
+	default: return false;
+	}
+}
+
+/*!
+ * The name the stream of this record is keyed on, named records start with it.
+ */
+static uint32_t
+get_stream_name(const struct u_capture_record_header *header, const void *payload)
+{
+	switch (header->type) {
+	case U_CAPTURE_RECORD_INPUTS:
+	case U_CAPTURE_RECORD_VIEW_POSES: return 0;
+	default: return *(const uint32_t *)payload;
+	}
+}
+
+static void
+apply_inputs(struct replay_device *d, const struct u_capture_inputs *rec)
+{
+	const struct u_capture_input *inputs = u_capture_inputs_array(rec);
+
+	for (uint32_t i = 0; i < rec->count; i++) {
+		if (inputs[i].index >= d->base.input_count) {
+			continue;
+		}
+
+		struct xrt_input *input = &d->base.inputs[inputs[i].index];
+		input->active = inputs[i].input.active;
+		input->timestamp = inputs[i].input.timestamp + d->session->offset_ns;
+		input->value = inputs[i].input.value;
+	}
+}
+
+
+/*
+ *
+ * Member functions.
+ *
+ */
+
+static xrt_result_t
+replay_update_inputs(struct xrt_device *xdev)
+{
+	struct replay_device *d = replay_device(xdev);
+
+	os_mutex_lock(&d->mutex);
+
+	struct replay_stream *stream = find_stream(d, U_CAPTURE_RECORD_INPUTS, 0);
+	if (stream == NULL) {
+		os_mutex_unlock(&d->mutex);
+		return XRT_SUCCESS;
+	}
+
+	if (d->session->mode == REPLAY_MODE_FAST) {
+		// One recorded update per update.
+		if (stream->cursor < stream->record_count) {
+			apply_inputs(d, (const void *)(stream->records[stream->cursor++] + 1));
+		}
+	} else {
+		// Every update that has happened by now.
+		int64_t recorded_now = session_recorded_now(d->session);
+		while (stream->cursor < stream->record_count &&
+		       stream->records[stream->cursor]->timestamp_ns <= recorded_now) {
+			apply_inputs(d, (const void *)(stream->records[stream->cursor++] + 1));
+		}
+	}
+
+	os_mutex_unlock(&d->mutex);
+
+	return XRT_SUCCESS;
+}
+
+static xrt_result_t
+replay_get_tracked_pose(struct xrt_device *xdev,
+                        enum xrt_input_name name,
+                        int64_t at_timestamp_ns,
+                        struct xrt_space_relation *out_relation)
+{
+	struct replay_device *d = replay_device(xdev);
+	struct u_capture_tracked_pose rec;
+
+	if (!pick(d, U_CAPTURE_RECORD_TRACKED_POSE, name, &rec, sizeof(rec))) {
+		U_LOG_XDEV_UNSUPPORTED_INPUT(&d->base, d->log_level, name);
+		return XRT_ERROR_INPUT_UNSUPPORTED;
+	}
+
+	*out_relation = rec.relation;
+
+	return rec.result;
+}
+
+static xrt_result_t
+replay_get_hand_tracking(struct xrt_device *xdev,
+                         enum xrt_input_name name,
+                         int64_t desired_timestamp_ns,
+                         struct xrt_hand_joint_set *out_value,
+                         int64_t *out_timestamp_ns)
+{
+	struct replay_device *d = replay_device(xdev);
+	struct u_capture_hand_tracking rec;
+
+	if (!pick(d, U_CAPTURE_RECORD_HAND_TRACKING, name, &rec, sizeof(rec))) {
+		U_LOG_XDEV_UNSUPPORTED_INPUT(&d->base, d->log_level, name);
+		return XRT_ERROR_INPUT_UNSUPPORTED;
+	}
+
+	*out_value = rec.value;
+	*out_timestamp_ns = rec.out_timestamp_ns + d->session->offset_ns;
+
+	return rec.result;
+}
+
+static xrt_result_t
+replay_get_body_skeleton(struct xrt_device *xdev,
+                         enum xrt_input_name body_tracking_type,
+                         struct xrt_body_skeleton *out_value)
+{
+	// Not captured.
+	return XRT_ERROR_NOT_IMPLEMENTED;
+}
+
+static xrt_result_t
+replay_get_body_joints(struct xrt_device *xdev,
+                       enum xrt_input_name body_tracking_type,
+                       int64_t desired_timestamp_ns,
+                       struct xrt_body_joint_set *out_value)
+{
+	struct replay_device *d = replay_device(xdev);
+	struct u_capture_body_joints rec;
+
+	if (!pick(d, U_CAPTURE_RECORD_BODY_JOINTS, body_tracking_type, &rec, sizeof(rec))) {
+		U_LOG_XDEV_UNSUPPORTED_INPUT(&d->base, d->log_level, body_tracking_type);
+		return XRT_ERROR_INPUT_UNSUPPORTED;
+	}
+
+	*out_value = rec.value;
+
+	return rec.result;
+}
+
+static void
+replay_set_output(struct xrt_device *xdev, enum xrt_output_name name, const struct xrt_output_value *value)
+{
+	// Nothing to drive, outputs are only captured for inspection.
+}
+
+static void
+replay_get_view_poses(struct xrt_device *xdev,
+                      const struct xrt_vec3 *default_eye_relation,
+                      int64_t at_timestamp_ns,
+                      uint32_t view_count,
+                      struct xrt_space_relation *out_head_relation,
+                      struct xrt_fov *out_fovs,
+                      struct xrt_pose *out_poses)
+{
+	struct replay_device *d = replay_device(xdev);
+	struct u_capture_view_poses rec;
+
+	if (!pick(d, U_CAPTURE_RECORD_VIEW_POSES, 0, &rec, sizeof(rec)) || rec.view_count < view_count) {
+		// Never recorded, build them from the head pose and views.
+		u_device_get_view_poses(xdev, default_eye_relation, at_timestamp_ns, view_count, out_head_relation,
+		                        out_fovs, out_poses);
+		return;
+	}
+
+	*out_head_relation = rec.head_relation;
+	for (uint32_t i = 0; i < view_count; i++) {
+		out_fovs[i] = rec.fovs[i];
+		out_poses[i] = rec.poses[i];
+	}
+}
+
+static void
+replay_destroy(struct xrt_device *xdev)
+{
+	struct replay_device *d = replay_device(xdev);
+
+	for (uint32_t i = 0; i < d->stream_count; i++) {
+		free(d->streams[i].records);
+	}
+	free(d->streams);
+
+	os_mutex_destroy(&d->mutex);
+	session_reference(&d->session, NULL);
+
+	u_device_free(&d->base);
+}
+
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+static void
+setup_hmd(struct replay_device *d, const struct u_capture_hmd *hmd)
+{
+	struct xrt_hmd_parts *parts = d->base.hmd;
+
+	parts->screens[0].w_pixels = hmd->screen_w_pixels;
+	parts->screens[0].h_pixels = hmd->screen_h_pixels;
+	parts->screens[0].nominal_frame_interval_ns = hmd->nominal_frame_interval_ns;
+
+	parts->view_count = MIN(hmd->view_count, XRT_MAX_VIEWS);
+	for (size_t i = 0; i < parts->view_count; i++) {
+		parts->views[i] = hmd->views[i];
+		parts->distortion.fov[i] = hmd->fovs[i];
+	}
+
+	parts->blend_mode_count = MIN(hmd->blend_mode_count, XRT_MAX_DEVICE_BLEND_MODES);
+	for (size_t i = 0; i < parts->blend_mode_count; i++) {
+		parts->blend_modes[i] = (enum xrt_blend_mode)hmd->blend_modes[i];
+	}
+
+	// The distortion is not captured, the compositor output is not what is being replayed.
+	u_distortion_mesh_set_none(&d->base);
+
+	d->base.get_view_poses = replay_get_view_poses;
+	d->base.get_visibility_mask = u_device_get_visibility_mask;
+}
+
+static struct replay_device *
+create_device(struct replay_session *session, const struct u_capture_device *rec)
+{
+	enum u_device_alloc_flags flags = rec->has_hmd ? U_DEVICE_ALLOC_HMD : U_DEVICE_ALLOC_NO_FLAGS;
+	struct replay_device *d =
+	    U_DEVICE_ALLOCATE(struct replay_device, flags, rec->input_count, rec->output_count);
+
+	d->log_level = debug_get_log_option_replay_log();
+	os_mutex_init(&d->mutex);
+	session_reference(&d->session, session);
+
+	d->base.name = (enum xrt_device_name)rec->name;
+	d->base.device_type = (enum xrt_device_type)rec->device_type;
+	snprintf(d->base.str, XRT_DEVICE_NAME_LEN, "%s", rec->str);
+	snprintf(d->base.serial, XRT_DEVICE_NAME_LEN, "%s", rec->serial);
+	d->base.tracking_origin = &session->origin;
+
+	// Only what can be served from the capture.
+	d->base.supported = rec->supported;
+	d->base.supported.ref_space_usage = false;
+	d->base.supported.form_factor_check = false;
+	d->base.supported.face_tracking = false;
+	d->base.supported.battery_status = false;
+	d->base.supported.planes = false;
+	d->base.supported.plane_capability_flags = 0;
+
+	const uint32_t *input_names = u_capture_device_input_names(rec);
+	for (uint32_t i = 0; i < rec->input_count; i++) {
+		d->base.inputs[i].name = (enum xrt_input_name)input_names[i];
+	}
+
+	const uint32_t *output_names = u_capture_device_output_names(rec);
+	for (uint32_t i = 0; i < rec->output_count; i++) {
+		d->base.outputs[i].name = (enum xrt_output_name)output_names[i];
+	}
+
+	d->base.update_inputs = replay_update_inputs;
+	d->base.get_tracked_pose = replay_get_tracked_pose;
+	d->base.get_hand_tracking = replay_get_hand_tracking;
+	d->base.get_body_skeleton = replay_get_body_skeleton;
+	d->base.get_body_joints = replay_get_body_joints;
+	d->base.set_output = replay_set_output;
+	d->base.destroy = replay_destroy;
+
+	if (rec->has_hmd) {
+		setup_hmd(d, &rec->hmd);
+	}
+
+	return d;
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+xrt_result_t
+replay_create_devices(const char *path,
+                      enum replay_mode mode,
+                      struct xrt_device **out_xdevs,
+                      uint32_t max_xdev_count,
+                      uint32_t *out_xdev_count)
+{
+	struct replay_session *session = U_TYPED_CALLOC(struct replay_session);
+
+	if (!u_capture_reader_open(path, &session->reader)) {
+		free(session);
+		return XRT_ERROR_DEVICE_CREATION_FAILED;
+	}
+
+	session->mode = mode;
+	session->origin.type = XRT_TRACKING_TYPE_OTHER;
+	session->origin.initial_offset = (struct xrt_pose)XRT_POSE_IDENTITY;
+	snprintf(session->origin.name, XRT_TRACKING_NAME_LEN, "Replay");
+
+	struct replay_device *devices[U_CAPTURE_MAX_DEVICES] = {0};
+	uint32_t device_count = 0;
+	uint32_t limit = MIN(max_xdev_count, U_CAPTURE_MAX_DEVICES);
+
+	const struct u_capture_record_header *header = NULL;
+	const void *payload = NULL;
+	size_t offset = 0;
+
+	// First pass creates the devices and counts the records of every stream.
+	while (u_capture_reader_next(&session->reader, &offset, &header, &payload)) {
+		if (header->type == U_CAPTURE_RECORD_DEVICE) {
+			if (header->device_index == device_count && device_count < limit) {
+				devices[device_count++] = create_device(session, payload);
+			}
+			continue;
+		}
+
+		// The second pass would take it as belonging to a later device record.
+		if (header->device_index >= device_count && is_replayed_record(header, limit)) {
+			U_LOG_E("Record for device %u before its device record in capture '%s'", header->device_index,
+			        path);
+			goto err_destroy;
+		}
+
+		if (!is_replayed_record(header, device_count)) {
+			continue;
+		}
+
+		struct replay_device *d = devices[header->device_index];
+		find_or_add_stream(d, header->type, get_stream_name(header, payload))->record_count++;
+	}
+
+	for (uint32_t i = 0; i < device_count; i++) {
+		struct replay_device *d = devices[i];
+		for (uint32_t k = 0; k < d->stream_count; k++) {
+			struct replay_stream *stream = &d->streams[k];
+			stream->records = U_TYPED_ARRAY_CALLOC(const struct u_capture_record_header *,
+			                                       stream->record_count);
+			stream->record_capacity = stream->record_count;
+			stream->record_count = 0;
+		}
+	}
+
+	// Second pass fills in the records, pointing into the mapped capture.
+	offset = 0;
+	while (u_capture_reader_next(&session->reader, &offset, &header, &payload)) {
+		if (!is_replayed_record(header, device_count)) {
+			continue;
+		}
+
+		struct replay_device *d = devices[header->device_index];
+		struct replay_stream *stream = find_stream(d, header->type, get_stream_name(header, payload));
+
+		// Both passes see the same records, unless the capture is malformed.
+		if (stream == NULL || stream->record_count >= stream->record_capacity) {
+			U_LOG_E("Malformed capture '%s', records don't match the first pass", path);
+			goto err_destroy;
+		}
+
+		stream->records[stream->record_count++] = header;
+	}
+
+	if (device_count == 0) {
+		U_LOG_E("No devices in capture '%s'", path);
+		goto err_destroy;
+	}
+
+	// Recorded time zero is now, fast mode keeps the recorded times.
+	if (mode == REPLAY_MODE_REALTIME) {
+		session->offset_ns = os_monotonic_get_ns() - session->reader.header->start_ns;
+	}
+
+	for (uint32_t i = 0; i < device_count; i++) {
+		out_xdevs[i] = &devices[i]->base;
+	}
+	*out_xdev_count = device_count;
+
+	U_LOG_I("Replaying %u device(s) from '%s'", device_count, path);
+
+	return XRT_SUCCESS;
+
+err_destroy:
+	// The devices hold the only references to the session.
+	for (uint32_t i = 0; i < device_count; i++) {
+		struct xrt_device *xdev = &devices[i]->base;
+		xrt_device_destroy(&xdev);
+	}
+
+	if (device_count == 0) {
+		u_capture_reader_close(&session->reader);
+		free(session);
+	}
+
+	return XRT_ERROR_DEVICE_CREATION_FAILED;
+}
@@ -0,0 +1,70 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Interface to the replay driver.
+ * @ingroup drv_replay
+ */
+
+#pragma once
+
+#include "xrt/xrt_device.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*!
+ * @defgroup drv_replay Replay driver
+ * @ingroup drv
+ *
+ * @brief Serves devices recorded into a capture file, see @ref u_capture.h.
+ */
+
+/*!
+ * @dir drivers/replay
+ *
+ * @brief @ref drv_replay files.
+ */
+
+/*!
+ * How the replay advances through the capture.
+ *
+ * @ingroup drv_replay
+ */
+enum replay_mode
+{
+	/*!
+	 * Follow the monotonic clock, every call returns what the recorded
+	 * device returned at the same time into the capture, timestamps are
+	 * moved onto the current clock.
+	 */
+	REPLAY_MODE_REALTIME,
+
+	/*!
+	 * Every call returns the next recorded result for that call, with the
+	 * recorded timestamps untouched, for running captures through the
+	 * pipeline as fast as possible.
+	 */
+	REPLAY_MODE_FAST,
+};
+
+/*!
+ * Create one device per device in the capture at @p path, the devices keep
+ * the capture mapped until the last one is destroyed.
+ *
+ * @ingroup drv_replay
+ */
+xrt_result_t
+replay_create_devices(const char *path,
+                      enum replay_mode mode,
+                      struct xrt_device **out_xdevs,
+                      uint32_t max_xdev_count,
+                      uint32_t *out_xdev_count);
+
+
+#ifdef __cplusplus
+}
+#endif
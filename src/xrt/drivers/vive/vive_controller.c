@@ -173,6 +173,9 @@ vive_controller_device_destroy(struct xrt_device *xdev)
 	// Now that the thread is not running we can destroy the lock.
 	os_mutex_destroy(&d->lock);
 
+	// Remove the variable tracking, before the history it points into.
+	u_var_remove_root(d);
+
 	os_mutex_destroy(&d->fusion.mutex);
 	m_relation_history_destroy(&d->fusion.relation_hist);
 	m_imu_3dof_close(&d->fusion.i3dof);
@@ -1023,6 +1026,8 @@ vive_controller_setup_ui(struct vive_controller_device *d)
 
 	u_var_add_gui_header(d, NULL, "3DoF Tracking");
 	m_imu_3dof_add_vars(&d->fusion.i3dof, d, "");
+	u_var_add_gui_header(d, NULL, "Prediction");
+	m_relation_history_add_vars(d->fusion.relation_hist, d, "");
 	u_var_add_gui_header(d, NULL, "Calibration");
 	u_var_add_vec3_f32(d, &d->config.imu.acc_scale, "acc_scale");
 	u_var_add_vec3_f32(d, &d->config.imu.acc_bias, "acc_bias");
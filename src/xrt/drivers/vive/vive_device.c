@@ -87,11 +87,11 @@ vive_device_destroy(struct xrt_device *xdev)
 
 	vive_config_teardown(&d->config);
 
-	m_relation_history_destroy(&d->fusion.relation_hist);
-
-	// Remove the variable tracking.
+	// Remove the variable tracking, before the history it points into.
 	u_var_remove_root(d);
 
+	m_relation_history_destroy(&d->fusion.relation_hist);
+
 	u_device_free(&d->base);
 }
 
@@ -955,6 +955,8 @@ vive_device_setup_ui(struct vive_device *d)
 
 	u_var_add_gui_header(d, NULL, "3DoF Tracking");
 	m_imu_3dof_add_vars(&d->fusion.i3dof, d, "");
+	u_var_add_gui_header(d, NULL, "Prediction");
+	m_relation_history_add_vars(d->fusion.relation_hist, d, "");
 	u_var_add_gui_header(d, NULL, "Calibration");
 	u_var_add_vec3_f32(d, &d->config.imu.acc_scale, "acc_scale");
 	u_var_add_vec3_f32(d, &d->config.imu.acc_bias, "acc_bias");
@@ -2353,6 +2353,39 @@ struct xrt_system_compositor_info
 
 struct xrt_system_compositor;
 
+/*!
+ * Frame timing statistics of a single session/client, as seen by a system
+ * compositor that paces multiple clients.
+ *
+ * @see xrt_multi_compositor_control::get_frame_stats
+ */
+struct xrt_compositor_frame_stats
+{
+	//! Frames delivered with their GPU work completed.
+	uint64_t delivered_count;
+
+	//! Frames discarded by the client.
+	uint64_t discarded_count;
+
+	//! Delivered frames that completed after their display time.
+	uint64_t missed_count;
+
+	//! Filtered time between delivered frames.
+	int64_t frame_period_ns;
+
+	//! Filtered time between the client waking up and beginning the frame.
+	int64_t cpu_time_ns;
+
+	//! Filtered time between the client beginning and delivering the frame.
+	int64_t draw_time_ns;
+
+	//! Filtered time between the frame being delivered and the client's GPU work completing.
+	int64_t gpu_time_ns;
+
+	//! Filtered time between the system compositor latching a frame and its display time.
+	int64_t latch_to_display_ns;
+};
+
 /*!
  * @interface xrt_multi_compositor_control
  * Special functions to control multi session/clients.
@@ -2407,6 +2440,14 @@ struct xrt_multi_compositor_control
 	                                               struct xrt_compositor *xc,
 	                                               float from_display_refresh_rate_hz,
 	                                               float to_display_refresh_rate_hz);
+
+	/*!
+	 * Get the frame timing statistics of this client/session, cheap
+	 * enough to be called once per frame.
+	 */
+	xrt_result_t (*get_frame_stats)(struct xrt_system_compositor *xsc,
+	                                struct xrt_compositor *xc,
+	                                struct xrt_compositor_frame_stats *out_stats);
 };
 
 /*!
@@ -2583,6 +2624,28 @@ xrt_syscomp_notify_display_refresh_changed(struct xrt_system_compositor *xsc,
 	                                                 to_display_refresh_rate_hz);
 }
 
+/*!
+ * @copydoc xrt_multi_compositor_control::get_frame_stats
+ *
+ * Helper for calling through the function pointer.
+ *
+ * If the system compositor @p xsc does not implement @ref xrt_multi_compositor_control,
+ * this returns @ref XRT_ERROR_MULTI_SESSION_NOT_IMPLEMENTED.
+ *
+ * @public @memberof xrt_system_compositor
+ */
+static inline xrt_result_t
+xrt_syscomp_get_frame_stats(struct xrt_system_compositor *xsc,
+                            struct xrt_compositor *xc,
+                            struct xrt_compositor_frame_stats *out_stats)
+{
+	if (xsc->xmcc == NULL) {
+		return XRT_ERROR_MULTI_SESSION_NOT_IMPLEMENTED;
+	}
+
+	return xsc->xmcc->get_frame_stats(xsc, xc, out_stats);
+}
+
 /*!
  * @copydoc xrt_system_compositor::create_native_compositor
  *
@@ -385,6 +385,32 @@ struct xrt_device
 	                                  struct xrt_hand_joint_set *out_value,
 	                                  int64_t *out_timestamp_ns);
 
+	/*!
+	 * @brief Get several hand joint sets in one call, any mix of hands and
+	 * timestamps may be asked for, out of process this is a single round
+	 * trip instead of one per query.
+	 *
+	 * Optional, use @ref xrt_device_get_hand_tracking_batch which falls
+	 * back to @ref get_hand_tracking if this is NULL.
+	 *
+	 * @param[in] xdev                  The device.
+	 * @param[in] query_count           Number of queries.
+	 * @param[in] names                 Input name for each query, see
+	 *                                  @ref get_hand_tracking.
+	 * @param[in] desired_timestamps_ns Timestamp for each query.
+	 * @param[out] out_values           Array of @p query_count joint sets.
+	 * @param[out] out_timestamps_ns    Array of @p query_count timestamps of
+	 *                                  the data being returned.
+	 *
+	 * @see xrt_input_name
+	 */
+	xrt_result_t (*get_hand_tracking_batch)(struct xrt_device *xdev,
+	                                        uint32_t query_count,
+	                                        const enum xrt_input_name *names,
+	                                        const int64_t *desired_timestamps_ns,
+	                                        struct xrt_hand_joint_set *out_values,
+	                                        int64_t *out_timestamps_ns);
+
 	/*!
 	 * @brief Get the requested blend shape properties & weights for a face tracker
 	 *
@@ -687,6 +713,43 @@ xrt_device_get_hand_tracking(struct xrt_device *xdev,
 	return xdev->get_hand_tracking(xdev, name, desired_timestamp_ns, out_value, out_timestamp_ns);
 }
 
+/*!
+ * Helper function for @ref xrt_device::get_hand_tracking_batch, calls
+ * @ref xrt_device::get_hand_tracking once per query if the device doesn't
+ * implement it.
+ *
+ * @copydoc xrt_device::get_hand_tracking_batch
+ *
+ * @public @memberof xrt_device
+ */
+static inline xrt_result_t
+xrt_device_get_hand_tracking_batch(struct xrt_device *xdev,
+                                   uint32_t query_count,
+                                   const enum xrt_input_name *names,
+                                   const int64_t *desired_timestamps_ns,
+                                   struct xrt_hand_joint_set *out_values,
+                                   int64_t *out_timestamps_ns)
+{
+	if (xdev->get_hand_tracking_batch != NULL) {
+		return xdev->get_hand_tracking_batch(xdev, query_count, names, desired_timestamps_ns, out_values,
+		                                     out_timestamps_ns);
+	}
+
+	for (uint32_t i = 0; i < query_count; i++) {
+		xrt_result_t xret = xdev->get_hand_tracking( //
+		    xdev,                                    //
+		    names[i],                                //
+		    desired_timestamps_ns[i],                //
+		    &out_values[i],                          //
+		    &out_timestamps_ns[i]);                  //
+		if (xret != XRT_SUCCESS) {
+			return xret;
+		}
+	}
+
+	return XRT_SUCCESS;
+}
+
 /*!
  * Helper function for @ref xrt_device::get_face_tracking.
  *
@@ -75,6 +75,65 @@ xrt_sink_push_frame(struct xrt_frame_sink *sink, struct xrt_frame *frame)
 	sink->push_frame(sink, frame);
 }
 
+/*!
+ * Max number of frames in a @ref xrt_frame_set.
+ *
+ * @ingroup xrt_iface
+ */
+#define XRT_FRAME_SET_MAX_FRAMES (5)
+
+/*!
+ * Frames from several cameras that were captured at the same time, holds
+ * pointers to the original frames and never copies their data.
+ *
+ * @ingroup xrt_iface
+ */
+struct xrt_frame_set
+{
+	//! Number of valid entries in @ref frames.
+	uint32_t frame_count;
+
+	//! One frame per camera, in camera order.
+	struct xrt_frame *frames[XRT_FRAME_SET_MAX_FRAMES];
+
+	//! Common timestamp of the set, the mean of the frame timestamps.
+	int64_t timestamp;
+
+	//! Newest minus oldest frame timestamp in the set.
+	int64_t skew_ns;
+};
+
+/*!
+ * @interface xrt_frame_set_sink
+ *
+ * A object that is sent sets of synchronized frames, see @ref xrt_frame_set.
+ *
+ * Same rules as @ref xrt_frame_sink, the sink must take a reference on any
+ * frame in the set that it wants to keep after the push returns.
+ *
+ * @ingroup xrt_iface
+ */
+struct xrt_frame_set_sink
+{
+	/*!
+	 * Push a set of frames into the sink.
+	 */
+	void (*push_frame_set)(struct xrt_frame_set_sink *sink, struct xrt_frame_set *set);
+};
+
+/*!
+ * @copydoc xrt_frame_set_sink::push_frame_set
+ *
+ * Helper for calling through the function pointer.
+ *
+ * @public @memberof xrt_frame_set_sink
+ */
+static inline void
+xrt_sink_push_frame_set(struct xrt_frame_set_sink *sink, struct xrt_frame_set *set)
+{
+	sink->push_frame_set(sink, set);
+}
+
 /*!
  * @interface xrt_frame_node
  *
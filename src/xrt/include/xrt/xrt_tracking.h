@@ -205,6 +205,7 @@ struct xrt_slam_sinks
 	struct xrt_imu_sink *imu;
 	struct xrt_pose_sink *gt; //!< Can receive ground truth poses if available
 	struct xrt_hand_masks_sink *hand_masks;
+	struct xrt_frame_set_sink *frame_set; //!< All of @ref cams at once, may be NULL if not supported
 };
 
 /*!
@@ -21,12 +21,21 @@
 #include "util/u_debug.h"
 #include "util/u_device.h"
 
+#include "shared/ipc_joints_packed.h"
+
 #include "client/ipc_client.h"
 #include "client/ipc_client_connection.h"
 #include "client/ipc_client_xdev.h"
 #include "ipc_client_generated.h"
 
 
+/*!
+ * Fetch hand and body joints with the packed calls, which quantize the joints
+ * relative to the root, off by default so apps get full precision unless asked.
+ */
+DEBUG_GET_ONCE_BOOL_OPTION(packed_joints, "IPC_PACKED_JOINTS", false)
+
+
 /*
  *
  * Functions from xrt_device.
@@ -67,17 +76,84 @@ ipc_client_xdev_get_hand_tracking(struct xrt_device *xdev,
                                   int64_t *out_timestamp_ns)
 {
 	struct ipc_client_xdev *icx = ipc_client_xdev(xdev);
+	xrt_result_t xret;
 
-	xrt_result_t xret = ipc_call_device_get_hand_tracking( //
-	    icx->ipc_c,                                        //
-	    icx->device_id,                                    //
-	    name,                                              //
-	    at_timestamp_ns,                                   //
-	    out_value,                                         //
-	    out_timestamp_ns);                                 //
+	if (debug_get_bool_option_packed_joints()) {
+		struct ipc_packed_hand_joint_set packed;
+
+		xret = ipc_call_device_get_hand_tracking_packed( //
+		    icx->ipc_c,                                  //
+		    icx->device_id,                              //
+		    name,                                        //
+		    at_timestamp_ns,                             //
+		    &packed,                                     //
+		    out_timestamp_ns);                           //
+		if (xret == XRT_SUCCESS) {
+			ipc_unpack_hand_joint_set(&packed, out_value);
+		}
+		IPC_CHK_ALWAYS_RET(icx->ipc_c, xret, "ipc_call_device_get_hand_tracking_packed");
+	}
+
+	xret = ipc_call_device_get_hand_tracking( //
+	    icx->ipc_c,                           //
+	    icx->device_id,                       //
+	    name,                                 //
+	    at_timestamp_ns,                      //
+	    out_value,                            //
+	    out_timestamp_ns);                    //
 	IPC_CHK_ALWAYS_RET(icx->ipc_c, xret, "ipc_call_device_get_hand_tracking");
 }
 
+static xrt_result_t
+ipc_client_xdev_get_hand_tracking_batch(struct xrt_device *xdev,
+                                        uint32_t query_count,
+                                        const enum xrt_input_name *names,
+                                        const int64_t *desired_timestamps_ns,
+                                        struct xrt_hand_joint_set *out_values,
+                                        int64_t *out_timestamps_ns)
+{
+	struct ipc_client_xdev *icx = ipc_client_xdev(xdev);
+	struct ipc_hand_tracking_batch_result batch;
+	struct ipc_packed_hand_tracking_batch_result packed_batch;
+	const bool packed = debug_get_bool_option_packed_joints();
+	xrt_result_t xret = XRT_SUCCESS;
+
+	// One round trip per IPC_MAX_HAND_TRACKING_QUERIES, normally just one.
+	for (uint32_t first = 0; first < query_count; first += IPC_MAX_HAND_TRACKING_QUERIES) {
+		struct ipc_hand_tracking_batch_query query = {0};
+		query.query_count = MIN(query_count - first, IPC_MAX_HAND_TRACKING_QUERIES);
+		for (uint32_t i = 0; i < query.query_count; i++) {
+			query.names[i] = names[first + i];
+			query.desired_timestamps_ns[i] = desired_timestamps_ns[first + i];
+		}
+
+		if (packed) {
+			xret = ipc_call_device_get_hand_tracking_batch_packed( //
+			    icx->ipc_c,                                        //
+			    icx->device_id,                                    //
+			    &query,                                            //
+			    &packed_batch);                                    //
+		} else {
+			xret = ipc_call_device_get_hand_tracking_batch(icx->ipc_c, icx->device_id, &query, &batch);
+		}
+		if (xret != XRT_SUCCESS) {
+			break;
+		}
+
+		for (uint32_t i = 0; i < query.query_count; i++) {
+			if (packed) {
+				ipc_unpack_hand_joint_set(&packed_batch.values[i], &out_values[first + i]);
+				out_timestamps_ns[first + i] = packed_batch.timestamps_ns[i];
+			} else {
+				out_values[first + i] = batch.values[i];
+				out_timestamps_ns[first + i] = batch.timestamps_ns[i];
+			}
+		}
+	}
+
+	IPC_CHK_ALWAYS_RET(icx->ipc_c, xret, "ipc_call_device_get_hand_tracking_batch");
+}
+
 static xrt_result_t
 ipc_client_xdev_get_face_tracking(struct xrt_device *xdev,
                                   enum xrt_input_name facial_expression_type,
@@ -117,13 +193,29 @@ ipc_client_xdev_get_body_joints(struct xrt_device *xdev,
                                 struct xrt_body_joint_set *out_value)
 {
 	struct ipc_client_xdev *icx = ipc_client_xdev(xdev);
+	xrt_result_t xret;
+
+	if (debug_get_bool_option_packed_joints()) {
+		struct ipc_packed_body_joint_set packed;
+
+		xret = ipc_call_device_get_body_joints_packed( //
+		    icx->ipc_c,                                //
+		    icx->device_id,                            //
+		    body_tracking_type,                        //
+		    desired_timestamp_ns,                      //
+		    &packed);                                  //
+		if (xret == XRT_SUCCESS) {
+			ipc_unpack_body_joint_set(&packed, out_value);
+		}
+		IPC_CHK_ALWAYS_RET(icx->ipc_c, xret, "ipc_call_device_get_body_joints_packed");
+	}
 
-	xrt_result_t xret = ipc_call_device_get_body_joints( //
-	    icx->ipc_c,                                      //
-	    icx->device_id,                                  //
-	    body_tracking_type,                              //
-	    desired_timestamp_ns,                            //
-	    out_value);                                      //
+	xret = ipc_call_device_get_body_joints( //
+	    icx->ipc_c,                         //
+	    icx->device_id,                     //
+	    body_tracking_type,                 //
+	    desired_timestamp_ns,               //
+	    out_value);                         //
 	IPC_CHK_ALWAYS_RET(icx->ipc_c, xret, "ipc_call_device_get_body_joints");
 }
 
@@ -368,6 +460,7 @@ ipc_client_xdev_init(struct ipc_client_xdev *icx,
 	icx->base.update_inputs = ipc_client_xdev_update_inputs;
 	icx->base.get_tracked_pose = ipc_client_xdev_get_tracked_pose;
 	icx->base.get_hand_tracking = ipc_client_xdev_get_hand_tracking;
+	icx->base.get_hand_tracking_batch = ipc_client_xdev_get_hand_tracking_batch;
 	icx->base.get_face_tracking = ipc_client_xdev_get_face_tracking;
 	icx->base.get_body_skeleton = ipc_client_xdev_get_body_skeleton;
 	icx->base.get_body_joints = ipc_client_xdev_get_body_joints;
@@ -366,6 +366,12 @@ struct ipc_server
 	struct ipc_shared_memory *ism;
 	xrt_shmem_handle_t ism_handle;
 
+	//! Telemetry page, written by the client threads.
+	struct ipc_telemetry *telemetry;
+	xrt_shmem_handle_t telemetry_handle;
+	//! Read only handle to the telemetry page, given to clients.
+	xrt_shmem_handle_t telemetry_ro_handle;
+
 	struct ipc_server_mainloop ml;
 
 	// Is the mainloop supposed to run.
@@ -15,6 +15,8 @@
 #include "util/u_visibility_mask.h"
 #include "util/u_trace_marker.h"
 
+#include "shared/ipc_joints_packed.h"
+
 #include "server/ipc_server.h"
 #include "ipc_server_generated.h"
 
@@ -1518,6 +1520,23 @@ ipc_handle_system_get_clients(volatile struct ipc_client_state *_ics, struct ipc
 	return XRT_SUCCESS;
 }
 
+xrt_result_t
+ipc_handle_system_get_telemetry_shm_fd(volatile struct ipc_client_state *ics,
+                                       uint32_t max_handle_capacity,
+                                       xrt_shmem_handle_t *out_handles,
+                                       uint32_t *out_handle_count)
+{
+	IPC_TRACE_MARKER();
+
+	assert(max_handle_capacity >= 1);
+
+	// Only the read only handle is ever given out.
+	out_handles[0] = ics->server->telemetry_ro_handle;
+	*out_handle_count = 1;
+
+	return XRT_SUCCESS;
+}
+
 xrt_result_t
 ipc_handle_system_get_properties(volatile struct ipc_client_state *_ics, struct xrt_system_properties *out_properties)
 {
@@ -1962,6 +1981,72 @@ ipc_handle_device_get_hand_tracking(volatile struct ipc_client_state *ics,
 	return xrt_device_get_hand_tracking(xdev, name, at_timestamp, out_value, out_timestamp);
 }
 
+xrt_result_t
+ipc_handle_device_get_hand_tracking_batch(volatile struct ipc_client_state *ics,
+                                          uint32_t id,
+                                          const struct ipc_hand_tracking_batch_query *query,
+                                          struct ipc_hand_tracking_batch_result *out_batch)
+{
+	// To make the code a bit more readable.
+	uint32_t device_id = id;
+	struct xrt_device *xdev = get_xdev(ics, device_id);
+
+	if (query->query_count == 0 || query->query_count > IPC_MAX_HAND_TRACKING_QUERIES) {
+		IPC_ERROR(ics->server, "Client asked for zero or too many hand tracking queries! (%u)",
+		          query->query_count);
+		return XRT_ERROR_IPC_FAILURE;
+	}
+
+	return xrt_device_get_hand_tracking_batch( //
+	    xdev,                                  //
+	    query->query_count,                    //
+	    query->names,                          //
+	    query->desired_timestamps_ns,          //
+	    out_batch->values,                     //
+	    out_batch->timestamps_ns);             //
+}
+
+xrt_result_t
+ipc_handle_device_get_hand_tracking_packed(volatile struct ipc_client_state *ics,
+                                           uint32_t id,
+                                           enum xrt_input_name name,
+                                           int64_t at_timestamp,
+                                           struct ipc_packed_hand_joint_set *out_value,
+                                           int64_t *out_timestamp)
+{
+	struct xrt_hand_joint_set value = XRT_STRUCT_INIT;
+
+	xrt_result_t xret = ipc_handle_device_get_hand_tracking(ics, id, name, at_timestamp, &value, out_timestamp);
+	if (xret != XRT_SUCCESS) {
+		return xret;
+	}
+
+	ipc_pack_hand_joint_set(&value, out_value);
+
+	return XRT_SUCCESS;
+}
+
+xrt_result_t
+ipc_handle_device_get_hand_tracking_batch_packed(volatile struct ipc_client_state *ics,
+                                                 uint32_t id,
+                                                 const struct ipc_hand_tracking_batch_query *query,
+                                                 struct ipc_packed_hand_tracking_batch_result *out_batch)
+{
+	struct ipc_hand_tracking_batch_result batch = XRT_STRUCT_INIT;
+
+	xrt_result_t xret = ipc_handle_device_get_hand_tracking_batch(ics, id, query, &batch);
+	if (xret != XRT_SUCCESS) {
+		return xret;
+	}
+
+	for (uint32_t i = 0; i < query->query_count; i++) {
+		ipc_pack_hand_joint_set(&batch.values[i], &out_batch->values[i]);
+		out_batch->timestamps_ns[i] = batch.timestamps_ns[i];
+	}
+
+	return XRT_SUCCESS;
+}
+
 xrt_result_t
 ipc_handle_device_get_view_poses(volatile struct ipc_client_state *ics,
                                  uint32_t id,
@@ -2513,6 +2598,30 @@ ipc_handle_device_get_body_joints(volatile struct ipc_client_state *ics,
 	return xrt_device_get_body_joints(xdev, body_tracking_type, desired_timestamp_ns, out_value);
 }
 
+xrt_result_t
+ipc_handle_device_get_body_joints_packed(volatile struct ipc_client_state *ics,
+                                         uint32_t id,
+                                         enum xrt_input_name body_tracking_type,
+                                         int64_t desired_timestamp_ns,
+                                         struct ipc_packed_body_joint_set *out_value)
+{
+	struct xrt_body_joint_set value = XRT_STRUCT_INIT;
+
+	xrt_result_t xret = ipc_handle_device_get_body_joints( //
+	    ics,                                               //
+	    id,                                                //
+	    body_tracking_type,                                //
+	    desired_timestamp_ns,                              //
+	    &value);                                           //
+	if (xret != XRT_SUCCESS) {
+		return xret;
+	}
+
+	ipc_pack_body_joint_set(&value, ipc_body_joint_count(body_tracking_type), out_value);
+
+	return XRT_SUCCESS;
+}
+
 xrt_result_t
 ipc_handle_device_get_battery_status(
     volatile struct ipc_client_state *ics, uint32_t id, bool *out_present, bool *out_charging, float *out_charge)
@@ -8,10 +8,15 @@
  * @ingroup ipc_server
  */
 
+#include "os/os_time.h"
+
 #include "util/u_misc.h"
+#include "util/u_pacing.h"
+#include "util/u_flight_recorder.h"
 #include "util/u_trace_marker.h"
 
 #include "shared/ipc_utils.h"
+#include "shared/ipc_telemetry.h"
 #include "server/ipc_server.h"
 #include "ipc_server_generated.h"
 
@@ -58,9 +63,77 @@ delayed_exit_thread(void *_server)
 	return NULL;
 }
 
+static struct ipc_telemetry_client *
+get_telemetry_client(volatile struct ipc_client_state *ics)
+{
+	return &ics->server->telemetry->clients[ics->server_thread_index];
+}
+
+static void
+telemetry_client_connected(volatile struct ipc_client_state *ics)
+{
+	struct ipc_telemetry_client *tc = get_telemetry_client(ics);
+
+	ipc_telemetry_client_write_begin(tc);
+
+	tc->active = 1;
+	tc->id = ics->client_state.id;
+	tc->connected_ns = os_monotonic_get_ns();
+	U_ZERO(&tc->frame);
+	U_ZERO_ARRAY(tc->commands);
+
+	ipc_telemetry_client_write_end(tc);
+}
+
+static void
+telemetry_client_disconnected(volatile struct ipc_client_state *ics)
+{
+	struct ipc_telemetry_client *tc = get_telemetry_client(ics);
+
+	ipc_telemetry_client_write_begin(tc);
+	tc->active = 0;
+	ipc_telemetry_client_write_end(tc);
+}
+
+static void
+telemetry_record_call(volatile struct ipc_client_state *ics, ipc_command_t cmd, int64_t duration_ns)
+{
+	if ((uint32_t)cmd >= IPC_COMMAND_COUNT) {
+		return;
+	}
+
+	struct ipc_server *s = ics->server;
+	struct ipc_telemetry_client *tc = get_telemetry_client(ics);
+
+	// Once per frame, fetched before the write so the slot is locked as short as possible.
+	struct xrt_compositor_frame_stats stats;
+	bool have_stats = false;
+	if (cmd == IPC_COMPOSITOR_WAIT_WOKE && ics->xc != NULL) {
+		have_stats = xrt_syscomp_get_frame_stats(s->xsysc, ics->xc, &stats) == XRT_SUCCESS;
+		s->telemetry->compositor_gpu_time_ns = u_pc_get_gpu_time_ns();
+	}
+
+	ipc_telemetry_client_write_begin(tc);
+
+	struct ipc_telemetry_command *tcmd = &tc->commands[cmd];
+	tcmd->count++;
+	tcmd->total_ns += (uint64_t)duration_ns;
+	if ((uint64_t)duration_ns > tcmd->max_ns) {
+		tcmd->max_ns = (uint64_t)duration_ns;
+	}
+
+	if (have_stats) {
+		tc->frame = stats;
+	}
+
+	ipc_telemetry_client_write_end(tc);
+}
+
 static void
 common_shutdown(volatile struct ipc_client_state *ics)
 {
+	telemetry_client_disconnected(ics);
+
 	/*
 	 * Remove the thread from the server.
 	 */
@@ -203,6 +276,8 @@ client_loop(volatile struct ipc_client_state *ics)
 		return;
 	}
 
+	telemetry_client_connected(ics);
+
 	while (ics->server->running) {
 		const int half_a_second_ms = 500;
 		struct epoll_event event = XRT_STRUCT_INIT;
@@ -256,8 +331,14 @@ client_loop(volatile struct ipc_client_state *ics)
 		// Check the first 4 bytes of the message and dispatch.
 		ipc_command_t *ipc_command = (ipc_command_t *)buf;
 
+		ipc_command_t cmd_id = *ipc_command;
+
 		IPC_TRACE_BEGIN(ipc_dispatch);
+		u_fr_record_now(U_FR_EVENT_IPC_BEGIN, -1, ics->server_thread_index, cmd_id);
+		int64_t dispatch_start_ns = os_monotonic_get_ns();
 		xrt_result_t result = ipc_dispatch(ics, ipc_command);
+		telemetry_record_call(ics, cmd_id, os_monotonic_get_ns() - dispatch_start_ns);
+		u_fr_record_now(U_FR_EVENT_IPC_END, -1, ics->server_thread_index, cmd_id);
 		IPC_TRACE_END(ipc_dispatch);
 
 		if (result != XRT_SUCCESS) {
@@ -294,6 +375,8 @@ client_loop(volatile struct ipc_client_state *ics)
 
 	IPC_INFO(ics->server, "Client connected");
 
+	telemetry_client_connected(ics);
+
 	while (ics->server->running) {
 		uint8_t buf[IPC_BUF_SIZE] = {0};
 		DWORD len = 0;
@@ -340,7 +423,11 @@ client_loop(volatile struct ipc_client_state *ics)
 		}
 
 		IPC_TRACE_BEGIN(ipc_dispatch);
+		u_fr_record_now(U_FR_EVENT_IPC_BEGIN, -1, ics->server_thread_index, cmd);
+		int64_t dispatch_start_ns = os_monotonic_get_ns();
 		xrt_result_t result = ipc_dispatch(ics, cmd_ptr);
+		telemetry_record_call(ics, cmd, os_monotonic_get_ns() - dispatch_start_ns);
+		u_fr_record_now(U_FR_EVENT_IPC_END, -1, ics->server_thread_index, cmd);
 		IPC_TRACE_END(ipc_dispatch);
 
 		if (result != XRT_SUCCESS) {
@@ -31,6 +31,7 @@
 #include "util/u_git_tag.h"
 
 #include "shared/ipc_shmem.h"
+#include "shared/ipc_telemetry.h"
 #include "server/ipc_server.h"
 #include "server/ipc_server_interface.h"
 
@@ -213,6 +214,11 @@ teardown_all(struct ipc_server *s)
 
 	ipc_shmem_destroy(&s->ism_handle, (void **)&s->ism, sizeof(struct ipc_shared_memory));
 
+	if (s->telemetry != NULL) {
+		ipc_shmem_destroy(&s->telemetry_ro_handle, NULL, 0);
+		ipc_shmem_destroy(&s->telemetry_handle, (void **)&s->telemetry, sizeof(struct ipc_telemetry));
+	}
+
 	// Destroyed last.
 	os_mutex_destroy(&s->global_state.lock);
 }
@@ -456,6 +462,30 @@ init_server_state(struct ipc_server *s)
 	}
 }
 
+static int
+init_telemetry(struct ipc_server *s)
+{
+	const size_t size = sizeof(struct ipc_telemetry);
+	xrt_result_t result = ipc_shmem_create_with_read_only( //
+	    size,                                              //
+	    &s->telemetry_handle,                              //
+	    &s->telemetry_ro_handle,                           //
+	    (void **)&s->telemetry);                           //
+	if (result != XRT_SUCCESS) {
+		s->telemetry = NULL;
+		return -1;
+	}
+
+	struct ipc_telemetry *t = s->telemetry;
+	U_ZERO(t);
+
+	t->version = IPC_TELEMETRY_VERSION;
+	t->command_count = IPC_COMMAND_COUNT;
+	t->startup_timestamp = s->ism->startup_timestamp;
+
+	return 0;
+}
+
 static int
 init_all(struct ipc_server *s, enum u_logging_level log_level)
 {
@@ -524,6 +554,13 @@ init_all(struct ipc_server *s, enum u_logging_level log_level)
 		return ret;
 	}
 
+	ret = init_telemetry(s);
+	if (ret < 0) {
+		IPC_ERROR(s, "Could not init telemetry shared memory!");
+		teardown_all(s);
+		return ret;
+	}
+
 	ret = ipc_server_mainloop_init(&s->ml);
 	if (ret < 0) {
 		IPC_ERROR(s, "Failed to init ipc main loop!");
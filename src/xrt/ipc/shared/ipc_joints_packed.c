@@ -0,0 +1,363 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Quantized wire format for hand and body joint sets.
+ * @ingroup ipc_shared
+ */
+
+#include "math/m_api.h"
+#include "util/u_misc.h"
+
+#include "shared/ipc_joints_packed.h"
+
+#include <assert.h>
+#include <math.h>
+
+
+#define MAX_JOINTS (XRT_FULL_BODY_JOINT_COUNT_META)
+
+static_assert(XRT_HAND_JOINT_COUNT <= MAX_JOINTS, "Hand joints must fit");
+static_assert((int)XRT_BODY_JOINT_COUNT_FB <= (int)MAX_JOINTS, "Body joints must fit");
+static_assert((int)XRT_BODY_JOINT_HIPS_FB == (int)XRT_FULL_BODY_JOINT_HIPS_META, "Same root for both body joint sets");
+
+//! The smallest three components of a unit quaternion are within ±1/sqrt(2).
+#define SMALLEST_THREE_INV_SCALE ((float)INT16_MAX * 1.41421356f)
+
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+static inline bool
+has_flags(enum xrt_space_relation_flags flags, uint32_t bits)
+{
+	return ((uint32_t)flags & bits) == bits;
+}
+
+static int16_t
+quantize(float value, float inv_scale)
+{
+	float f = roundf(value * inv_scale);
+
+	// Also catches NaN.
+	if (!(f > (float)-INT16_MAX)) {
+		return f != f ? 0 : -INT16_MAX;
+	}
+	if (f > (float)INT16_MAX) {
+		return INT16_MAX;
+	}
+
+	return (int16_t)f;
+}
+
+static void
+quantize_vec3(const struct xrt_vec3 *v, float inv_scale, int16_t out[3])
+{
+	out[0] = quantize(v->x, inv_scale);
+	out[1] = quantize(v->y, inv_scale);
+	out[2] = quantize(v->z, inv_scale);
+}
+
+static struct xrt_vec3
+dequantize_vec3(const int16_t v[3], float scale)
+{
+	return (struct xrt_vec3){v[0] * scale, v[1] * scale, v[2] * scale};
+}
+
+static void
+update_max_abs(const struct xrt_vec3 *v, float *inout_max)
+{
+	const float c[3] = {v->x, v->y, v->z};
+
+	// Non finite values are clamped when quantized, don't let them blow up the scale.
+	for (uint32_t i = 0; i < 3; i++) {
+		if (isfinite(c[i])) {
+			*inout_max = fmaxf(*inout_max, fabsf(c[i]));
+		}
+	}
+}
+
+static float
+scale_from_max_abs(float max_abs)
+{
+	return max_abs > 0.f ? max_abs / (float)INT16_MAX : 1.f;
+}
+
+static uint32_t
+pack_quat(const struct xrt_quat *q, int16_t out[3])
+{
+	const float c[4] = {q->x, q->y, q->z, q->w};
+
+	uint32_t dropped = 0;
+	for (uint32_t i = 1; i < 4; i++) {
+		if (fabsf(c[i]) > fabsf(c[dropped])) {
+			dropped = i;
+		}
+	}
+
+	// q and -q are the same rotation, make the dropped component positive.
+	const float sign = c[dropped] < 0.f ? -1.f : 1.f;
+
+	for (uint32_t i = 0, k = 0; i < 4; i++) {
+		if (i != dropped) {
+			out[k++] = quantize(c[i] * sign, SMALLEST_THREE_INV_SCALE);
+		}
+	}
+
+	return dropped;
+}
+
+static struct xrt_quat
+unpack_quat(const int16_t v[3], uint32_t dropped)
+{
+	float c[4];
+	float sum = 0.f;
+
+	for (uint32_t i = 0, k = 0; i < 4; i++) {
+		if (i != dropped) {
+			c[i] = v[k++] / SMALLEST_THREE_INV_SCALE;
+			sum += c[i] * c[i];
+		}
+	}
+	c[dropped] = sqrtf(fmaxf(0.f, 1.f - sum));
+
+	struct xrt_quat q = {c[0], c[1], c[2], c[3]};
+	math_quat_normalize(&q);
+
+	return q;
+}
+
+static void
+pack_joints(const struct xrt_space_relation *relations,
+            const float *radii,
+            uint32_t count,
+            uint32_t root_index,
+            struct ipc_packed_joint_root *out_root,
+            struct ipc_packed_joint *out_joints)
+{
+	assert(count <= MAX_JOINTS);
+	assert(root_index < count);
+
+	struct xrt_pose root = XRT_POSE_IDENTITY;
+	const uint32_t pose_valid = XRT_SPACE_RELATION_ORIENTATION_VALID_BIT | XRT_SPACE_RELATION_POSITION_VALID_BIT;
+	if (has_flags(relations[root_index].relation_flags, pose_valid)) {
+		root = relations[root_index].pose;
+		math_quat_normalize(&root.orientation);
+	}
+
+	struct xrt_pose poses[MAX_JOINTS];
+	for (uint32_t i = 0; i < count; i++) {
+		poses[i] = relations[i].pose;
+	}
+
+	// Move all joints into the root's frame, keeps the positions small.
+	struct xrt_pose inv_root;
+	math_pose_invert(&root, &inv_root);
+	math_pose_transform_batch(&inv_root, poses, count, poses);
+
+	float max_position = 0.f;
+	float max_linear = 0.f;
+	float max_angular = 0.f;
+	for (uint32_t i = 0; i < count; i++) {
+		const enum xrt_space_relation_flags flags = relations[i].relation_flags;
+
+		if (has_flags(flags, XRT_SPACE_RELATION_POSITION_VALID_BIT)) {
+			update_max_abs(&poses[i].position, &max_position);
+		}
+		if (has_flags(flags, XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT)) {
+			update_max_abs(&relations[i].linear_velocity, &max_linear);
+		}
+		if (has_flags(flags, XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT)) {
+			update_max_abs(&relations[i].angular_velocity, &max_angular);
+		}
+	}
+
+	out_root->pose = root;
+	out_root->position_scale = scale_from_max_abs(max_position);
+	out_root->linear_velocity_scale = scale_from_max_abs(max_linear);
+	out_root->angular_velocity_scale = scale_from_max_abs(max_angular);
+
+	const float inv_position = 1.f / out_root->position_scale;
+	const float inv_linear = 1.f / out_root->linear_velocity_scale;
+	const float inv_angular = 1.f / out_root->angular_velocity_scale;
+
+	for (uint32_t i = 0; i < count; i++) {
+		const enum xrt_space_relation_flags flags = relations[i].relation_flags;
+		struct ipc_packed_joint *j = &out_joints[i];
+
+		U_ZERO(j);
+
+		uint32_t dropped = 3; // Identity, all zero.
+		if (has_flags(flags, XRT_SPACE_RELATION_ORIENTATION_VALID_BIT)) {
+			math_quat_normalize(&poses[i].orientation);
+			dropped = pack_quat(&poses[i].orientation, j->orientation);
+		}
+		if (has_flags(flags, XRT_SPACE_RELATION_POSITION_VALID_BIT)) {
+			quantize_vec3(&poses[i].position, inv_position, j->position);
+		}
+		if (has_flags(flags, XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT)) {
+			quantize_vec3(&relations[i].linear_velocity, inv_linear, j->linear_velocity);
+		}
+		if (has_flags(flags, XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT)) {
+			quantize_vec3(&relations[i].angular_velocity, inv_angular, j->angular_velocity);
+		}
+
+		if (radii != NULL) {
+			float r = roundf(radii[i] / IPC_PACKED_JOINT_RADIUS_SCALE);
+			j->radius = (uint16_t)(r > 0.f ? fminf(r, (float)UINT16_MAX) : 0.f);
+		}
+
+		j->flags = (uint16_t)(((uint32_t)flags & IPC_PACKED_JOINT_RELATION_FLAGS_MASK) |
+		                      (dropped << IPC_PACKED_JOINT_DROPPED_SHIFT));
+	}
+}
+
+static void
+unpack_joints(const struct ipc_packed_joint_root *root,
+              const struct ipc_packed_joint *joints,
+              uint32_t count,
+              struct xrt_space_relation *out_relations,
+              float *out_radii)
+{
+	assert(count <= MAX_JOINTS);
+
+	struct xrt_pose poses[MAX_JOINTS] = XRT_STRUCT_INIT;
+	for (uint32_t i = 0; i < count; i++) {
+		const struct ipc_packed_joint *j = &joints[i];
+		const uint32_t dropped = (j->flags >> IPC_PACKED_JOINT_DROPPED_SHIFT) & 0x3u;
+
+		poses[i].orientation = unpack_quat(j->orientation, dropped);
+		poses[i].position = dequantize_vec3(j->position, root->position_scale);
+	}
+
+	math_pose_transform_batch(&root->pose, poses, count, poses);
+
+	for (uint32_t i = 0; i < count; i++) {
+		const struct ipc_packed_joint *j = &joints[i];
+		const uint32_t flags = j->flags & IPC_PACKED_JOINT_RELATION_FLAGS_MASK;
+		struct xrt_space_relation rel = XRT_SPACE_RELATION_ZERO;
+
+		rel.relation_flags = (enum xrt_space_relation_flags)flags;
+		if (has_flags(rel.relation_flags, XRT_SPACE_RELATION_ORIENTATION_VALID_BIT)) {
+			rel.pose.orientation = poses[i].orientation;
+		}
+		if (has_flags(rel.relation_flags, XRT_SPACE_RELATION_POSITION_VALID_BIT)) {
+			rel.pose.position = poses[i].position;
+		}
+		if (has_flags(rel.relation_flags, XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT)) {
+			rel.linear_velocity = dequantize_vec3(j->linear_velocity, root->linear_velocity_scale);
+		}
+		if (has_flags(rel.relation_flags, XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT)) {
+			rel.angular_velocity = dequantize_vec3(j->angular_velocity, root->angular_velocity_scale);
+		}
+
+		out_relations[i] = rel;
+		if (out_radii != NULL) {
+			out_radii[i] = j->radius * IPC_PACKED_JOINT_RADIUS_SCALE;
+		}
+	}
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+void
+ipc_pack_hand_joint_set(const struct xrt_hand_joint_set *set, struct ipc_packed_hand_joint_set *out)
+{
+	struct xrt_space_relation relations[XRT_HAND_JOINT_COUNT];
+	float radii[XRT_HAND_JOINT_COUNT];
+
+	for (uint32_t i = 0; i < XRT_HAND_JOINT_COUNT; i++) {
+		relations[i] = set->values.hand_joint_set_default[i].relation;
+		radii[i] = set->values.hand_joint_set_default[i].radius;
+	}
+
+	U_ZERO(out);
+	out->hand_pose = set->hand_pose;
+	out->is_active = set->is_active;
+
+	pack_joints(relations, radii, XRT_HAND_JOINT_COUNT, XRT_HAND_JOINT_WRIST, &out->root, out->joints);
+}
+
+void
+ipc_unpack_hand_joint_set(const struct ipc_packed_hand_joint_set *packed, struct xrt_hand_joint_set *out)
+{
+	struct xrt_space_relation relations[XRT_HAND_JOINT_COUNT];
+	float radii[XRT_HAND_JOINT_COUNT];
+
+	unpack_joints(&packed->root, packed->joints, XRT_HAND_JOINT_COUNT, relations, radii);
+
+	for (uint32_t i = 0; i < XRT_HAND_JOINT_COUNT; i++) {
+		out->values.hand_joint_set_default[i].relation = relations[i];
+		out->values.hand_joint_set_default[i].radius = radii[i];
+	}
+
+	out->hand_pose = packed->hand_pose;
+	out->is_active = packed->is_active != 0;
+}
+
+uint32_t
+ipc_body_joint_count(enum xrt_input_name body_tracking_type)
+{
+	switch (body_tracking_type) {
+	case XRT_INPUT_FB_BODY_TRACKING: return XRT_BODY_JOINT_COUNT_FB;
+	case XRT_INPUT_META_FULL_BODY_TRACKING: return XRT_FULL_BODY_JOINT_COUNT_META;
+	default: return MAX_JOINTS;
+	}
+}
+
+void
+ipc_pack_body_joint_set(const struct xrt_body_joint_set *set,
+                        uint32_t joint_count,
+                        struct ipc_packed_body_joint_set *out)
+{
+	// All joint sets in the union share the layout of the largest one.
+	const struct xrt_full_body_joint_set_meta *full = &set->full_body_joint_set_meta;
+	struct xrt_space_relation relations[MAX_JOINTS];
+
+	joint_count = MIN(joint_count, MAX_JOINTS);
+	for (uint32_t i = 0; i < joint_count; i++) {
+		relations[i] = full->joint_locations[i].relation;
+	}
+
+	U_ZERO(out);
+	out->body_pose = set->body_pose;
+	out->sample_time_ns = full->base.sample_time_ns;
+	out->confidence = full->base.confidence;
+	out->skeleton_changed_count = full->base.skeleton_changed_count;
+	out->is_active = full->base.is_active;
+	out->joint_count = joint_count;
+
+	if (joint_count > 0) {
+		const uint32_t root_index = MIN(XRT_BODY_JOINT_HIPS_FB, joint_count - 1);
+		pack_joints(relations, NULL, joint_count, root_index, &out->root, out->joints);
+	}
+}
+
+void
+ipc_unpack_body_joint_set(const struct ipc_packed_body_joint_set *packed, struct xrt_body_joint_set *out)
+{
+	struct xrt_full_body_joint_set_meta *full = &out->full_body_joint_set_meta;
+	struct xrt_space_relation relations[MAX_JOINTS];
+	const uint32_t joint_count = MIN(packed->joint_count, MAX_JOINTS);
+
+	unpack_joints(&packed->root, packed->joints, joint_count, relations, NULL);
+
+	U_ZERO(out);
+	for (uint32_t i = 0; i < joint_count; i++) {
+		full->joint_locations[i].relation = relations[i];
+	}
+
+	full->base.sample_time_ns = packed->sample_time_ns;
+	full->base.confidence = packed->confidence;
+	full->base.skeleton_changed_count = packed->skeleton_changed_count;
+	full->base.is_active = packed->is_active != 0;
+	out->body_pose = packed->body_pose;
+}
@@ -0,0 +1,106 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Quantized wire format for hand and body joint sets.
+ *
+ * Joint sets are large and fetched every frame, so besides the plain calls
+ * the protocol has packed versions that roughly halve the bytes sent. A
+ * packed set is a full precision root pose, the pose of the wrist or hips
+ * joint, and per joint:
+ *
+ * - The rotation relative to the root as the smallest three components of the
+ *   quaternion, the index of the dropped one is in the flags.
+ * - The position relative to the root, in the root's frame, as 16 bit values
+ *   scaled to fit the furthest joint of the set.
+ * - Linear and angular velocities as 16 bit values scaled per set.
+ * - The radius in units of @ref IPC_PACKED_JOINT_RADIUS_SCALE.
+ * - The @ref xrt_space_relation_flags in the low bits of the flags.
+ *
+ * Only components that the flags mark as valid are carried, the others are
+ * zero or identity after unpacking.
+ *
+ * @ingroup ipc_shared
+ */
+
+#pragma once
+
+#include "shared/ipc_protocol.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*!
+ * Meters per unit of @ref ipc_packed_joint::radius.
+ *
+ * @ingroup ipc_shared
+ */
+#define IPC_PACKED_JOINT_RADIUS_SCALE (1e-5f)
+
+/*!
+ * Mask of the @ref xrt_space_relation_flags in @ref ipc_packed_joint::flags.
+ *
+ * @ingroup ipc_shared
+ */
+#define IPC_PACKED_JOINT_RELATION_FLAGS_MASK (0x3fu)
+
+/*!
+ * Shift of the index of the dropped quaternion component, 0-3 for x, y, z and
+ * w, in @ref ipc_packed_joint::flags.
+ *
+ * @ingroup ipc_shared
+ */
+#define IPC_PACKED_JOINT_DROPPED_SHIFT (6u)
+
+/*!
+ * Pack @p set into @p out.
+ *
+ * @ingroup ipc_shared
+ */
+void
+ipc_pack_hand_joint_set(const struct xrt_hand_joint_set *set, struct ipc_packed_hand_joint_set *out);
+
+/*!
+ * Unpack @p packed into @p out.
+ *
+ * @ingroup ipc_shared
+ */
+void
+ipc_unpack_hand_joint_set(const struct ipc_packed_hand_joint_set *packed, struct xrt_hand_joint_set *out);
+
+/*!
+ * Number of joints in a @ref xrt_body_joint_set for the given body tracking
+ * input, unknown inputs get the largest count.
+ *
+ * @ingroup ipc_shared
+ */
+uint32_t
+ipc_body_joint_count(enum xrt_input_name body_tracking_type);
+
+/*!
+ * Pack the first @p joint_count joints of @p set into @p out, see
+ * @ref ipc_body_joint_count.
+ *
+ * @ingroup ipc_shared
+ */
+void
+ipc_pack_body_joint_set(const struct xrt_body_joint_set *set,
+                        uint32_t joint_count,
+                        struct ipc_packed_body_joint_set *out);
+
+/*!
+ * Unpack @p packed into @p out, joints past the packed count are left as zero
+ * relations.
+ *
+ * @ingroup ipc_shared
+ */
+void
+ipc_unpack_body_joint_set(const struct ipc_packed_body_joint_set *packed, struct xrt_body_joint_set *out);
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -38,6 +38,7 @@
 #define IPC_MAX_SLOTS 128
 #define IPC_MAX_CLIENTS 8
 #define IPC_MAX_RAW_VIEWS 32 // Max views that we can get, artificial limit.
+#define IPC_MAX_HAND_TRACKING_QUERIES 4 // Max queries per hand tracking batch call, two hands at two times.
 #define IPC_EVENT_QUEUE_SIZE 32
 
 #define IPC_SHARED_MAX_INPUTS 1024
@@ -364,6 +365,133 @@ struct ipc_info_get_view_poses_2
 static_assert(sizeof(struct ipc_info_get_view_poses_2) == 144,
               "invalid structure size, maybe different 32/64 bits sizes or padding");
 
+/*!
+ * Arguments for xrt_device::get_hand_tracking_batch.
+ */
+struct ipc_hand_tracking_batch_query
+{
+	int64_t desired_timestamps_ns[IPC_MAX_HAND_TRACKING_QUERIES];
+	enum xrt_input_name names[IPC_MAX_HAND_TRACKING_QUERIES];
+	uint32_t query_count;
+	uint32_t _pad;
+};
+
+static_assert(sizeof(struct ipc_hand_tracking_batch_query) == 56,
+              "invalid structure size, maybe different 32/64 bits sizes or padding");
+
+/*!
+ * Results for xrt_device::get_hand_tracking_batch.
+ */
+struct ipc_hand_tracking_batch_result
+{
+	struct xrt_hand_joint_set values[IPC_MAX_HAND_TRACKING_QUERIES];
+	int64_t timestamps_ns[IPC_MAX_HAND_TRACKING_QUERIES];
+};
+
+/*!
+ * Root of a packed joint set, the joints are stored relative to @p pose.
+ *
+ * @see ipc_joints_packed.h
+ * @ingroup ipc
+ */
+struct ipc_packed_joint_root
+{
+	struct xrt_pose pose;
+
+	//! Meters per unit of @ref ipc_packed_joint::position.
+	float position_scale;
+
+	//! Meters per second per unit of @ref ipc_packed_joint::linear_velocity.
+	float linear_velocity_scale;
+
+	//! Radians per second per unit of @ref ipc_packed_joint::angular_velocity.
+	float angular_velocity_scale;
+};
+
+static_assert(sizeof(struct ipc_packed_joint_root) == 40,
+              "invalid structure size, maybe different 32/64 bits sizes or padding");
+
+/*!
+ * A single quantized joint.
+ *
+ * @see ipc_joints_packed.h
+ * @ingroup ipc
+ */
+struct ipc_packed_joint
+{
+	//! Smallest three components of the rotation relative to the root.
+	int16_t orientation[3];
+
+	//! Position relative to the root, in the root's frame.
+	int16_t position[3];
+
+	int16_t linear_velocity[3];
+	int16_t angular_velocity[3];
+
+	//! In units of @ref IPC_PACKED_JOINT_RADIUS_SCALE.
+	uint16_t radius;
+
+	//! Bit field, see @ref ipc_joints_packed.h.
+	uint16_t flags;
+};
+
+static_assert(sizeof(struct ipc_packed_joint) == 28,
+              "invalid structure size, maybe different 32/64 bits sizes or padding");
+
+/*!
+ * Packed version of @ref xrt_hand_joint_set.
+ *
+ * @ingroup ipc
+ */
+struct ipc_packed_hand_joint_set
+{
+	struct xrt_space_relation hand_pose;
+	struct ipc_packed_joint_root root;
+	struct ipc_packed_joint joints[XRT_HAND_JOINT_COUNT];
+	uint32_t is_active;
+	uint32_t _pad;
+};
+
+static_assert(sizeof(struct ipc_packed_hand_joint_set) == 832,
+              "invalid structure size, maybe different 32/64 bits sizes or padding");
+
+/*!
+ * Packed results for xrt_device::get_hand_tracking_batch.
+ *
+ * @ingroup ipc
+ */
+struct ipc_packed_hand_tracking_batch_result
+{
+	struct ipc_packed_hand_joint_set values[IPC_MAX_HAND_TRACKING_QUERIES];
+	int64_t timestamps_ns[IPC_MAX_HAND_TRACKING_QUERIES];
+};
+
+static_assert(sizeof(struct ipc_packed_hand_tracking_batch_result) == 3360,
+              "invalid structure size, maybe different 32/64 bits sizes or padding");
+
+/*!
+ * Packed version of @ref xrt_body_joint_set, holds up to
+ * @ref XRT_FULL_BODY_JOINT_COUNT_META joints.
+ *
+ * @ingroup ipc
+ */
+struct ipc_packed_body_joint_set
+{
+	struct xrt_space_relation body_pose;
+	struct ipc_packed_joint_root root;
+	int64_t sample_time_ns;
+	float confidence;
+	uint32_t skeleton_changed_count;
+	uint32_t is_active;
+
+	//! Number of valid entries in @p joints.
+	uint32_t joint_count;
+	struct ipc_packed_joint joints[XRT_FULL_BODY_JOINT_COUNT_META];
+};
+
+static_assert(sizeof(struct ipc_packed_body_joint_set) == 2472,
+              "invalid structure size, maybe different 32/64 bits sizes or padding");
+
 struct ipc_pcm_haptic_buffer
 {
 	uint32_t num_samples;
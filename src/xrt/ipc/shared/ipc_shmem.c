@@ -49,12 +49,40 @@ ipc_shmem_create(size_t size, xrt_shmem_handle_t *out_handle, void **out_map)
 	return XRT_SUCCESS;
 }
 
+xrt_result_t
+ipc_shmem_create_with_read_only(size_t size,
+                                xrt_shmem_handle_t *out_handle,
+                                xrt_shmem_handle_t *out_ro_handle,
+                                void **out_map)
+{
+	xrt_result_t result = ipc_shmem_create(size, out_handle, out_map);
+	if (result != XRT_SUCCESS) {
+		return result;
+	}
+
+	int ro_fd = dup(*out_handle);
+	if (ro_fd < 0) {
+		ipc_shmem_destroy(out_handle, out_map, size);
+		return XRT_ERROR_IPC_FAILURE;
+	}
+
+	// Restricts all future mappings of the region, our mapping stays writable.
+	if (ASharedMemory_setProt(ro_fd, PROT_READ) != 0) {
+		close(ro_fd);
+		ipc_shmem_destroy(out_handle, out_map, size);
+		return XRT_ERROR_IPC_FAILURE;
+	}
+
+	*out_ro_handle = ro_fd;
+	return XRT_SUCCESS;
+}
+
 #elif defined(XRT_OS_UNIX)
 
 #define VRuska Engine_SHMEM_NAME "/VRuska Engine_shm"
-// Impl for non-Android Unix.
-xrt_result_t
-ipc_shmem_create(size_t size, xrt_shmem_handle_t *out_handle, void **out_map)
+// Impl for non-Android Unix, @p out_ro_handle is optional.
+static xrt_result_t
+create_unix(size_t size, xrt_shmem_handle_t *out_handle, xrt_shmem_handle_t *out_ro_handle, void **out_map)
 {
 	*out_handle = -1;
 	int fd = shm_open(VRuska Engine_SHMEM_NAME, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
@@ -64,20 +92,55 @@ ipc_shmem_create(size_t size, xrt_shmem_handle_t *out_handle, void **out_map)
 
 	if (ftruncate(fd, size) < 0) {
 		close(fd);
+		shm_unlink(VRuska Engine_SHMEM_NAME);
 		return XRT_ERROR_IPC_FAILURE;
 	}
+
+	// Only possible while the name entry exists, the mode of the fd can't be changed later.
+	int ro_fd = -1;
+	if (out_ro_handle != NULL) {
+		ro_fd = shm_open(VRuska Engine_SHMEM_NAME, O_RDONLY, 0);
+		if (ro_fd < 0) {
+			close(fd);
+			shm_unlink(VRuska Engine_SHMEM_NAME);
+			return XRT_ERROR_IPC_FAILURE;
+		}
+	}
+
 	xrt_result_t result = ipc_shmem_map(fd, size, out_map);
 	if (result != XRT_SUCCESS) {
 		close(fd);
+		if (ro_fd >= 0) {
+			close(ro_fd);
+		}
+		shm_unlink(VRuska Engine_SHMEM_NAME);
 		return result;
 	}
 
 	// Don't need the name entry anymore, we can share the FD.
 	shm_unlink(VRuska Engine_SHMEM_NAME);
 	*out_handle = fd;
+	if (out_ro_handle != NULL) {
+		*out_ro_handle = ro_fd;
+	}
 	return XRT_SUCCESS;
 }
 
+xrt_result_t
+ipc_shmem_create(size_t size, xrt_shmem_handle_t *out_handle, void **out_map)
+{
+	return create_unix(size, out_handle, NULL, out_map);
+}
+
+xrt_result_t
+ipc_shmem_create_with_read_only(size_t size,
+                                xrt_shmem_handle_t *out_handle,
+                                xrt_shmem_handle_t *out_ro_handle,
+                                void **out_map)
+{
+	return create_unix(size, out_handle, out_ro_handle, out_map);
+}
+
 #elif defined(XRT_OS_WINDOWS)
 
 xrt_result_t
@@ -100,6 +163,28 @@ ipc_shmem_create(size_t size, xrt_shmem_handle_t *out_handle, void **out_map)
 	return XRT_SUCCESS;
 }
 
+xrt_result_t
+ipc_shmem_create_with_read_only(size_t size,
+                                xrt_shmem_handle_t *out_handle,
+                                xrt_shmem_handle_t *out_ro_handle,
+                                void **out_map)
+{
+	xrt_result_t result = ipc_shmem_create(size, out_handle, out_map);
+	if (result != XRT_SUCCESS) {
+		return result;
+	}
+
+	HANDLE process = GetCurrentProcess();
+	HANDLE ro_handle = NULL;
+	if (!DuplicateHandle(process, *out_handle, process, &ro_handle, FILE_MAP_READ, FALSE, 0)) {
+		ipc_shmem_destroy(out_handle, out_map, size);
+		return XRT_ERROR_IPC_FAILURE;
+	}
+
+	*out_ro_handle = ro_handle;
+	return XRT_SUCCESS;
+}
+
 #else
 #error "OS not yet supported"
 #endif
@@ -137,6 +222,17 @@ ipc_shmem_map(xrt_shmem_handle_t handle, size_t size, void **out_map)
 	return XRT_SUCCESS;
 }
 
+xrt_result_t
+ipc_shmem_map_read_only(xrt_shmem_handle_t handle, size_t size, const void **out_map)
+{
+	void *ptr = mmap(NULL, size, PROT_READ, MAP_SHARED, handle, 0);
+	if (ptr == MAP_FAILED) {
+		return XRT_ERROR_IPC_FAILURE;
+	}
+	*out_map = ptr;
+	return XRT_SUCCESS;
+}
+
 void
 ipc_shmem_unmap(void **map_ptr, size_t size)
 {
@@ -174,6 +270,17 @@ ipc_shmem_map(xrt_shmem_handle_t handle, size_t size, void **out_map)
 	return XRT_SUCCESS;
 }
 
+xrt_result_t
+ipc_shmem_map_read_only(xrt_shmem_handle_t handle, size_t size, const void **out_map)
+{
+	void *ptr = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, size);
+	if (ptr == NULL) {
+		return XRT_ERROR_IPC_FAILURE;
+	}
+	*out_map = ptr;
+	return XRT_SUCCESS;
+}
+
 void
 ipc_shmem_unmap(void **map_ptr, size_t size)
 {
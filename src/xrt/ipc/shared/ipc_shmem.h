@@ -52,6 +52,40 @@ ipc_shmem_create(size_t size, xrt_shmem_handle_t *out_handle, void **out_map);
 xrt_result_t
 ipc_shmem_map(xrt_shmem_handle_t handle, size_t size, void **out_map);
 
+/*!
+ * Create and map a shared memory region, also giving a second handle that can
+ * only be mapped read only, for handing out to processes that should not be
+ * able to write to the region.
+ *
+ * @param[in] size Desired size of region
+ * @param[in,out] out_handle Pointer to the handle to populate, same as for
+ * @ref ipc_shmem_create.
+ * @param[in,out] out_ro_handle Pointer to the read only handle to populate.
+ * @param[in,out] out_map Pointer to the pointer to populate with the writable
+ * mapping of this shared memory region.
+ *
+ * @public @memberof xrt_shmem_handle_t
+ */
+xrt_result_t
+ipc_shmem_create_with_read_only(size_t size,
+                                xrt_shmem_handle_t *out_handle,
+                                xrt_shmem_handle_t *out_ro_handle,
+                                void **out_map);
+
+/*!
+ * Map a shared memory region read only, works with handles from
+ * @ref ipc_shmem_create_with_read_only.
+ *
+ * @param[in] handle Handle for region
+ * @param[in] size Size of region
+ * @param[in,out] out_map Pointer to the pointer to populate with the mapping of
+ * this shared memory region.
+ *
+ * @public @memberof xrt_shmem_handle_t
+ */
+xrt_result_t
+ipc_shmem_map_read_only(xrt_shmem_handle_t handle, size_t size, const void **out_map);
+
 /*!
  * Unmap a shared memory region.
  *
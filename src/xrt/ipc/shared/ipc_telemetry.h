@@ -0,0 +1,162 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Layout of the read only telemetry shared memory page.
+ * @ingroup ipc_shared
+ */
+
+#pragma once
+
+#include "xrt/xrt_compiler.h"
+
+#include "shared/ipc_protocol.h"
+#include "ipc_protocol_generated.h"
+
+#include <string.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*!
+ * Bumped whenever the layout of @ref ipc_telemetry changes.
+ *
+ * @ingroup ipc_shared
+ */
+#define IPC_TELEMETRY_VERSION 1
+
+/*!
+ * Calls to a single IPC command.
+ *
+ * @ingroup ipc_shared
+ */
+struct ipc_telemetry_command
+{
+	uint64_t count;
+	uint64_t total_ns;
+	uint64_t max_ns;
+};
+
+/*!
+ * Counters of a single connected client, written only by the server thread
+ * handling the client. Guarded by @p seq which is odd while the slot is being
+ * written, use @ref ipc_telemetry_client_read to get a consistent copy.
+ *
+ * @ingroup ipc_shared
+ */
+struct ipc_telemetry_client
+{
+	volatile uint32_t seq;
+
+	//! Is a client connected to this slot.
+	uint32_t active;
+
+	//! Id of the client, same as in @ref ipc_client_list.
+	uint32_t id;
+
+	uint32_t _pad;
+
+	//! When the client connected.
+	int64_t connected_ns;
+
+	//! Frame statistics of the client's session, see @ref xrt_compositor_frame_stats.
+	struct xrt_compositor_frame_stats frame;
+
+	//! Indexed by @ref ipc_command.
+	struct ipc_telemetry_command commands[IPC_COMMAND_COUNT];
+};
+
+/*!
+ * The telemetry page, mapped read only by clients such as libmonado so they
+ * can poll statistics without making any IPC calls.
+ *
+ * @ingroup ipc_shared
+ */
+struct ipc_telemetry
+{
+	//! @ref IPC_TELEMETRY_VERSION of the server.
+	uint32_t version;
+
+	//! @ref IPC_COMMAND_COUNT of the server.
+	uint32_t command_count;
+
+	//! When the server started.
+	int64_t startup_timestamp;
+
+	//! Filtered GPU time of the compositor, updated on each client frame.
+	volatile int64_t compositor_gpu_time_ns;
+
+	//! Indexed by the server thread handling the client.
+	struct ipc_telemetry_client clients[IPC_MAX_CLIENTS];
+};
+
+static inline void
+ipc_telemetry_barrier(void)
+{
+#if defined(__GNUC__)
+	__sync_synchronize();
+#elif defined(_MSC_VER)
+	MemoryBarrier();
+#else
+#error "compiler not supported"
+#endif
+}
+
+/*!
+ * Start writing to @p tc, only the owning server thread may call this.
+ *
+ * @ingroup ipc_shared
+ */
+static inline void
+ipc_telemetry_client_write_begin(struct ipc_telemetry_client *tc)
+{
+	tc->seq++;
+	ipc_telemetry_barrier();
+}
+
+/*!
+ * Done writing to @p tc.
+ *
+ * @ingroup ipc_shared
+ */
+static inline void
+ipc_telemetry_client_write_end(struct ipc_telemetry_client *tc)
+{
+	ipc_telemetry_barrier();
+	tc->seq++;
+}
+
+/*!
+ * Copy @p tc into @p out, retrying a few times if a write is in progress.
+ *
+ * @return false if no consistent copy could be made.
+ * @ingroup ipc_shared
+ */
+static inline bool
+ipc_telemetry_client_read(const struct ipc_telemetry_client *tc, struct ipc_telemetry_client *out)
+{
+	for (int i = 0; i < 16; i++) {
+		uint32_t before = tc->seq;
+		if ((before & 1) != 0) {
+			continue;
+		}
+
+		ipc_telemetry_barrier();
+		memcpy(out, (const void *)tc, sizeof(*out));
+		ipc_telemetry_barrier();
+
+		if (tc->seq == before) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+#ifdef __cplusplus
+}
+#endif
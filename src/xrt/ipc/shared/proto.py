@@ -158,6 +158,9 @@ struct ipc_connection;
         f.write("\n\t" + call.id + ",")
     f.write("\n} ipc_command_t;\n")
 
+    f.write('\n//! Number of commands, including @ref IPC_ERR.')
+    f.write('\n#define IPC_COMMAND_COUNT (%d)\n' % (len(p.calls) + 1))
+
     f.write('''
 struct ipc_command_msg
 {
@@ -93,15 +93,15 @@ gui_scene_hand_tracking_demo(struct gui_program *p)
 
 	xsysd->xdevs[xsysd->xdev_count++] = ht_dev;
 
-	struct xrt_slam_sinks gen_lock = {0};
-	u_sink_force_genlock_create( //
+	struct xrt_slam_sinks sync = {0};
+	u_sink_sync_create(          //
 	    &usysd->xfctx,           //
-	    hand_sinks->cams[0],     //
-	    hand_sinks->cams[1],     //
-	    &gen_lock.cams[0],       //
-	    &gen_lock.cams[1]);      //
+	    2,                       //
+	    U_TIME_1MS_IN_NS,        //
+	    hand_sinks->frame_set,   //
+	    sync.cams);              //
 
-	xrt_fs_slam_stream_start(the_fs, &gen_lock);
+	xrt_fs_slam_stream_start(the_fs, &sync);
 
 	p->xsysd = xsysd;
 
@@ -19,6 +19,7 @@
 #include "oxr_subaction.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 
 
 static void
@@ -44,6 +45,129 @@ setup_paths(struct oxr_logger *log,
 	}
 }
 
+static int
+cmp_path_ref(const void *a_ptr, const void *b_ptr)
+{
+	const struct oxr_binding_path_ref *a = (const struct oxr_binding_path_ref *)a_ptr;
+	const struct oxr_binding_path_ref *b = (const struct oxr_binding_path_ref *)b_ptr;
+
+	if (a->path != b->path) {
+		return a->path < b->path ? -1 : 1;
+	}
+	if (a->binding_index != b->binding_index) {
+		return a->binding_index < b->binding_index ? -1 : 1;
+	}
+	if (a->path_index != b->path_index) {
+		return a->path_index < b->path_index ? -1 : 1;
+	}
+	return 0;
+}
+
+static int
+cmp_act_key_ref(const void *a_ptr, const void *b_ptr)
+{
+	const struct oxr_binding_act_key_ref *a = (const struct oxr_binding_act_key_ref *)a_ptr;
+	const struct oxr_binding_act_key_ref *b = (const struct oxr_binding_act_key_ref *)b_ptr;
+
+	if (a->act_key != b->act_key) {
+		return a->act_key < b->act_key ? -1 : 1;
+	}
+	if (a->binding_index != b->binding_index) {
+		return a->binding_index < b->binding_index ? -1 : 1;
+	}
+	return 0;
+}
+
+/*!
+ * Builds the path lookup table from the generated flat list of template
+ * paths, the paths have already been interned by @ref setup_paths.
+ */
+static void
+setup_path_refs(struct oxr_interaction_profile *p, const struct profile_template *templ)
+{
+	p->path_ref_count = templ->path_ref_count;
+	p->path_refs = U_TYPED_ARRAY_CALLOC(struct oxr_binding_path_ref, p->path_ref_count);
+
+	for (size_t x = 0; x < templ->path_ref_count; x++) {
+		const struct binding_path_ref_template *t = &templ->path_refs[x];
+		struct oxr_binding_path_ref *ref = &p->path_refs[x];
+
+		assert(t->binding_index < p->binding_count);
+		assert(t->path_index < p->bindings[t->binding_index].path_count);
+
+		ref->path = p->bindings[t->binding_index].paths[t->path_index];
+		ref->binding_index = t->binding_index;
+		ref->path_index = t->path_index;
+	}
+
+	qsort(p->path_refs, p->path_ref_count, sizeof(*p->path_refs), cmp_path_ref);
+}
+
+/*!
+ * Returns the first of all path refs for the given path, and the number of
+ * them, in binding order.
+ */
+static const struct oxr_binding_path_ref *
+find_path_refs(const struct oxr_interaction_profile *p, XrPath path, size_t *out_count)
+{
+	size_t low = 0;
+	size_t high = p->path_ref_count;
+
+	// Lower bound.
+	while (low < high) {
+		size_t mid = low + (high - low) / 2;
+		if (p->path_refs[mid].path < path) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	size_t count = 0;
+	while (low + count < p->path_ref_count && p->path_refs[low + count].path == path) {
+		count++;
+	}
+
+	*out_count = count;
+
+	return &p->path_refs[low];
+}
+
+/*!
+ * Rebuilds the action key lookup table, must be called after the action
+ * keys of any binding has been changed.
+ */
+static void
+setup_act_key_refs(struct oxr_interaction_profile *p)
+{
+	free(p->act_key_refs);
+	p->act_key_refs = NULL;
+	p->act_key_ref_count = 0;
+
+	size_t count = 0;
+	for (size_t x = 0; x < p->binding_count; x++) {
+		count += p->bindings[x].act_key_count;
+	}
+
+	if (count == 0) {
+		return;
+	}
+
+	p->act_key_refs = U_TYPED_ARRAY_CALLOC(struct oxr_binding_act_key_ref, count);
+
+	for (size_t x = 0; x < p->binding_count; x++) {
+		const struct oxr_binding *b = &p->bindings[x];
+
+		for (size_t y = 0; y < b->act_key_count; y++) {
+			struct oxr_binding_act_key_ref *ref = &p->act_key_refs[p->act_key_ref_count++];
+			ref->act_key = b->act_keys[y];
+			ref->binding_index = (uint32_t)x;
+		}
+	}
+
+	qsort(p->act_key_refs, p->act_key_ref_count, sizeof(*p->act_key_refs), cmp_act_key_ref);
+}
+
 static bool
 interaction_profile_find_in_array(struct oxr_logger *log,
                                   const size_t profile_count,
@@ -115,12 +239,9 @@ interaction_profile_find_or_create_in_instance(struct oxr_logger *log,
 
 	struct profile_template *templ = NULL;
 
+	// The template paths are interned at instance creation, compare ids.
 	for (size_t x = 0; x < OXR_BINDINGS_PROFILE_TEMPLATE_COUNT; x++) {
-		XrPath t_path = XR_NULL_PATH;
-
-		oxr_path_get_or_create(log, inst, profile_templates[x].path, strlen(profile_templates[x].path),
-		                       &t_path);
-		if (t_path == path) {
+		if (profile_templates[x].path_cache == path) {
 			templ = &profile_templates[x];
 			break;
 		}
@@ -183,6 +304,8 @@ interaction_profile_find_or_create_in_instance(struct oxr_logger *log,
 		d->activate = t->activate;
 	}
 
+	setup_path_refs(p, templ);
+
 	// Add to the list of currently created interaction profiles.
 	U_ARRAY_REALLOC_OR_FREE(inst->profiles, struct oxr_interaction_profile *, (inst->profile_count + 1));
 	inst->profiles[inst->profile_count++] = p;
@@ -210,64 +333,60 @@ reset_all_keys(struct oxr_binding *bindings, size_t binding_count)
 	}
 }
 
+static void
+add_act_key(struct oxr_binding *b, uint32_t act_key, uint32_t preferred_path_index)
+{
+	U_ARRAY_REALLOC_OR_FREE(b->act_keys, uint32_t, (b->act_key_count + 1));
+	U_ARRAY_REALLOC_OR_FREE(b->preferred_binding_path_index, uint32_t, (b->act_key_count + 1));
+	b->preferred_binding_path_index[b->act_key_count] = preferred_path_index;
+	b->act_keys[b->act_key_count++] = act_key;
+}
+
 static bool
-ends_with(const char *str, const char *suffix)
+binding_has_component(struct oxr_logger *log,
+                      struct oxr_instance *inst,
+                      const struct oxr_binding *b,
+                      enum oxr_path_component component)
 {
-	size_t len = strlen(str);
-	size_t suffix_len = strlen(suffix);
+	for (uint32_t y = 0; y < b->path_count; y++) {
+		if (oxr_path_get_component(log, inst, b->paths[y]) == component) {
+			return true;
+		}
+	}
 
-	return (len >= suffix_len) && (0 == strcmp(str + (len - suffix_len), suffix));
+	return false;
 }
 
 static bool
 try_add_by_component(struct oxr_logger *log,
                      struct oxr_instance *inst,
-                     struct oxr_binding *bindings,
-                     size_t binding_count,
+                     struct oxr_interaction_profile *p,
                      XrPath path,
                      struct oxr_action *act,
-                     const char **components,
+                     const enum oxr_path_component *components,
                      size_t component_count)
 {
+	size_t ref_count = 0;
+	const struct oxr_binding_path_ref *refs = find_path_refs(p, path, &ref_count);
+
 	for (uint32_t component_index = 0; component_index < component_count; component_index++) {
 		// once we found everything for a component like click we don't want to keep going to add to a component
 		// like /value
 		// component is the outer loop so that we finish everything for a component in one go.
 		bool found_all_for_component = false;
 
-		for (size_t i = 0; i < binding_count; i++) {
-			struct oxr_binding *b = &bindings[i];
+		// Only bindings that contain the path, in binding order.
+		for (size_t i = 0; i < ref_count; i++) {
+			struct oxr_binding *b = &p->bindings[refs[i].binding_index];
 
-			bool path_found = false;
 			// search for path and component together and only add to the first found binding that has both
-			bool component_found = false;
-
-			uint32_t preferred_path_index;
-			for (uint32_t y = 0; y < b->path_count; y++) {
-				if (b->paths[y] == path) {
-					path_found = true;
-					// we preserve the info which path the app selected instead of pretending it
-					// selected /click, /value, etc. if it did not
-					preferred_path_index = y;
-				}
-
-				const char *str;
-				size_t len;
-				oxr_path_get_string(log, inst, b->paths[y], &str, &len);
-				if (ends_with(str, components[component_index])) {
-					component_found = true;
-				}
-			}
-
-
-			if (!(path_found && component_found)) {
+			if (!binding_has_component(log, inst, b, components[component_index])) {
 				continue;
 			}
 
-			U_ARRAY_REALLOC_OR_FREE(b->act_keys, uint32_t, (b->act_key_count + 1));
-			U_ARRAY_REALLOC_OR_FREE(b->preferred_binding_path_index, uint32_t, (b->act_key_count + 1));
-			b->preferred_binding_path_index[b->act_key_count] = preferred_path_index;
-			b->act_keys[b->act_key_count++] = act->act_key;
+			// we preserve the info which path the app selected instead of pretending it
+			// selected /click, /value, etc. if it did not
+			add_act_key(b, act->act_key, refs[i].path_index);
 			found_all_for_component = true;
 		}
 
@@ -281,32 +400,15 @@ try_add_by_component(struct oxr_logger *log,
 static bool
 add_direct(struct oxr_logger *log,
            struct oxr_instance *inst,
-           struct oxr_binding *bindings,
-           size_t binding_count,
+           struct oxr_interaction_profile *p,
            XrPath path,
            struct oxr_action *act)
 {
-	for (size_t i = 0; i < binding_count; i++) {
-		struct oxr_binding *b = &bindings[i];
+	size_t ref_count = 0;
+	const struct oxr_binding_path_ref *refs = find_path_refs(p, path, &ref_count);
 
-		bool found = false;
-		uint32_t preferred_path_index;
-		for (uint32_t y = 0; y < b->path_count; y++) {
-			if (b->paths[y] == path) {
-				found = true;
-				preferred_path_index = y;
-				break;
-			}
-		}
-
-		if (!found) {
-			continue;
-		}
-
-		U_ARRAY_REALLOC_OR_FREE(b->act_keys, uint32_t, (b->act_key_count + 1));
-		U_ARRAY_REALLOC_OR_FREE(b->preferred_binding_path_index, uint32_t, (b->act_key_count + 1));
-		b->preferred_binding_path_index[b->act_key_count] = preferred_path_index;
-		b->act_keys[b->act_key_count++] = act->act_key;
+	for (size_t i = 0; i < ref_count; i++) {
+		add_act_key(&p->bindings[refs[i].binding_index], act->act_key, refs[i].path_index);
 	}
 
 	return true;
@@ -315,33 +417,30 @@ add_direct(struct oxr_logger *log,
 static void
 add_act_key_to_matching_bindings(struct oxr_logger *log,
                                  struct oxr_instance *inst,
-                                 struct oxr_binding *bindings,
-                                 size_t binding_count,
+                                 struct oxr_interaction_profile *p,
                                  XrPath path,
                                  struct oxr_action *act)
 {
 	XrActionType xr_act_type = act->data->action_type;
-
-	const char *str;
-	size_t len;
-	oxr_path_get_string(log, inst, path, &str, &len);
+	enum oxr_path_component component = oxr_path_get_component(log, inst, path);
 
 	bool added = false;
 
 	// check if we need to select a child, e.g. suggested str is */trigger for a bool action, or */trigger for a
 	// float action
-	if (xr_act_type == XR_ACTION_TYPE_BOOLEAN_INPUT && !ends_with(str, "/click") && !ends_with(str, "/touch")) {
-		const char *components[2] = {"click", "value"};
-		added = try_add_by_component(log, inst, bindings, binding_count, path, act, components, 2);
-	} else if (xr_act_type == XR_ACTION_TYPE_FLOAT_INPUT && !ends_with(str, "/value") &&
-	           !ends_with(str, "/click")) {
-		const char *components[2] = {"value", "click"};
-		added = try_add_by_component(log, inst, bindings, binding_count, path, act, components, 2);
+	if (xr_act_type == XR_ACTION_TYPE_BOOLEAN_INPUT && component != OXR_PATH_COMPONENT_CLICK &&
+	    component != OXR_PATH_COMPONENT_TOUCH) {
+		const enum oxr_path_component components[2] = {OXR_PATH_COMPONENT_CLICK, OXR_PATH_COMPONENT_VALUE};
+		added = try_add_by_component(log, inst, p, path, act, components, 2);
+	} else if (xr_act_type == XR_ACTION_TYPE_FLOAT_INPUT && component != OXR_PATH_COMPONENT_VALUE &&
+	           component != OXR_PATH_COMPONENT_CLICK) {
+		const enum oxr_path_component components[2] = {OXR_PATH_COMPONENT_VALUE, OXR_PATH_COMPONENT_CLICK};
+		added = try_add_by_component(log, inst, p, path, act, components, 2);
 	}
 
 	// if the suggested str was not one of the ones that require us to select a child, fall back to the default case
 	if (!added) {
-		add_direct(log, inst, bindings, binding_count, path, act);
+		add_direct(log, inst, p, path, act);
 	}
 }
 
@@ -364,37 +463,8 @@ get_subaction_path_from_path(struct oxr_logger *log,
                              XrPath path,
                              enum oxr_subaction_path *out_subaction_path)
 {
-	const char *str = NULL;
-	size_t length = 0;
-	XrResult ret;
-
-	ret = oxr_path_get_string(log, inst, path, &str, &length);
-	if (ret != XR_SUCCESS) {
-		return false;
-	}
-
-	if (length >= 10 && strncmp("/user/head", str, 10) == 0) {
-		*out_subaction_path = OXR_SUB_ACTION_PATH_HEAD;
-		return true;
-	}
-	if (length >= 15 && strncmp("/user/hand/left", str, 15) == 0) {
-		*out_subaction_path = OXR_SUB_ACTION_PATH_LEFT;
-		return true;
-	}
-	if (length >= 16 && strncmp("/user/hand/right", str, 16) == 0) {
-		*out_subaction_path = OXR_SUB_ACTION_PATH_RIGHT;
-		return true;
-	}
-	if (length >= 13 && strncmp("/user/gamepad", str, 13) == 0) {
-		*out_subaction_path = OXR_SUB_ACTION_PATH_GAMEPAD;
-		return true;
-	}
-	if (length >= 14 && strncmp("/user/eyes_ext", str, 14) == 0) {
-		*out_subaction_path = OXR_SUB_ACTION_PATH_EYES;
-		return true;
-	}
-
-	return false;
+	// Classified once when the path was interned.
+	return oxr_path_get_subaction_path(log, inst, path, out_subaction_path);
 }
 
 static const char *
@@ -520,18 +590,26 @@ oxr_binding_find_bindings_from_act_key(struct oxr_logger *log,
 	// How many bindings are we returning?
 	size_t binding_count = 0;
 
+	// Lower bound of the key in the sorted action key table.
+	size_t low = 0;
+	size_t high = profile->act_key_ref_count;
+	while (low < high) {
+		size_t mid = low + (high - low) / 2;
+		if (profile->act_key_refs[mid].act_key < key) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
 	/*
-	 * Loop over all app provided bindings for this profile
-	 * and return those matching the action.
+	 * Return all app provided bindings for this profile matching the
+	 * action, in binding order and only once per binding.
 	 */
-	for (size_t binding_index = 0; binding_index < profile->binding_count; binding_index++) {
-		struct oxr_binding *profile_binding = &profile->bindings[binding_index];
-
-		for (size_t key_index = 0; key_index < profile_binding->act_key_count; key_index++) {
-			if (profile_binding->act_keys[key_index] == key) {
-				out_bindings[binding_count++] = profile_binding;
-				break;
-			}
+	for (size_t i = low; i < profile->act_key_ref_count && profile->act_key_refs[i].act_key == key; i++) {
+		const struct oxr_binding_act_key_ref *ref = &profile->act_key_refs[i];
+		if (i > low && ref->binding_index == profile->act_key_refs[i - 1].binding_index) {
+			continue;
 		}
 
 		//! @todo Should return total count instead of fixed max.
@@ -539,6 +617,8 @@ oxr_binding_find_bindings_from_act_key(struct oxr_logger *log,
 			oxr_warn(log, "Internal limit reached, action has too many bindings!");
 			break;
 		}
+
+		out_bindings[binding_count++] = &profile->bindings[ref->binding_index];
 	}
 
 	assert(binding_count <= max_binding_count);
@@ -598,6 +678,25 @@ oxr_clone_profile(const struct oxr_interaction_profile *src_profile)
 		}
 	}
 
+	dst_profile->path_ref_count = 0;
+	dst_profile->path_refs = NULL;
+	if (src_profile->path_refs && src_profile->path_ref_count > 0) {
+		dst_profile->path_ref_count = src_profile->path_ref_count;
+		dst_profile->path_refs = U_TYPED_ARRAY_CALLOC(struct oxr_binding_path_ref, src_profile->path_ref_count);
+		memcpy(dst_profile->path_refs, src_profile->path_refs,
+		       sizeof(struct oxr_binding_path_ref) * src_profile->path_ref_count);
+	}
+
+	dst_profile->act_key_ref_count = 0;
+	dst_profile->act_key_refs = NULL;
+	if (src_profile->act_key_refs && src_profile->act_key_ref_count > 0) {
+		dst_profile->act_key_ref_count = src_profile->act_key_ref_count;
+		dst_profile->act_key_refs =
+		    U_TYPED_ARRAY_CALLOC(struct oxr_binding_act_key_ref, src_profile->act_key_ref_count);
+		memcpy(dst_profile->act_key_refs, src_profile->act_key_refs,
+		       sizeof(struct oxr_binding_act_key_ref) * src_profile->act_key_ref_count);
+	}
+
 	dst_profile->dpad_count = 0;
 	dst_profile->dpads = NULL;
 	if (src_profile->dpads && src_profile->dpad_count > 0) {
@@ -657,6 +756,9 @@ oxr_destroy_profiles(struct oxr_interaction_profile **profiles, const size_t pro
 		p->bindings = NULL;
 		p->binding_count = 0;
 
+		free(p->path_refs);
+		free(p->act_key_refs);
+
 		free(p->dpads);
 
 		oxr_dpad_state_deinit(&p->dpad_state);
@@ -706,11 +808,8 @@ oxr_action_suggest_interaction_profile_bindings(struct oxr_logger *log,
 		goto out;
 	}
 
-	struct oxr_binding *bindings = p->bindings;
-	size_t binding_count = p->binding_count;
-
 	// Everything is now valid, reset the keys.
-	reset_all_keys(bindings, binding_count);
+	reset_all_keys(p->bindings, p->binding_count);
 	// Transfer ownership of dpad state to profile
 	oxr_dpad_state_deinit(&p->dpad_state);
 	p->dpad_state = *dpad_state;
@@ -720,9 +819,11 @@ oxr_action_suggest_interaction_profile_bindings(struct oxr_logger *log,
 		const XrActionSuggestedBinding *s = &suggestedBindings->suggestedBindings[i];
 		struct oxr_action *act = XRT_CAST_OXR_HANDLE_TO_PTR(struct oxr_action *, s->action);
 
-		add_act_key_to_matching_bindings(log, inst, bindings, binding_count, s->binding, act);
+		add_act_key_to_matching_bindings(log, inst, p, s->binding, act);
 	}
 
+	setup_act_key_refs(p);
+
 out:
 	oxr_dpad_state_deinit(dpad_state); // if it hasn't been moved
 
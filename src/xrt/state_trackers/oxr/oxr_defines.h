@@ -69,6 +69,23 @@ enum oxr_subaction_path
 	OXR_SUB_ACTION_PATH_EYES,
 };
 
+/*!
+ * Well known last component of a path, classified once when the path is
+ * interned so binding code can compare enums instead of string suffixes.
+ *
+ * @ingroup oxr_main
+ */
+enum oxr_path_component
+{
+	OXR_PATH_COMPONENT_NONE = 0,
+	OXR_PATH_COMPONENT_CLICK,
+	OXR_PATH_COMPONENT_TOUCH,
+	OXR_PATH_COMPONENT_VALUE,
+	OXR_PATH_COMPONENT_FORCE,
+	OXR_PATH_COMPONENT_POSE,
+	OXR_PATH_COMPONENT_HAPTIC,
+};
+
 /*!
  * Region of a dpad binding that an input is mapped to
  *
@@ -123,6 +123,7 @@ struct oxr_action_output;
 struct oxr_dpad_state;
 struct oxr_binding;
 struct oxr_interaction_profile;
+struct oxr_path_store;
 struct oxr_action_set_ref;
 struct oxr_action_ref;
 struct oxr_hand_tracker;
@@ -362,6 +363,30 @@ XrResult
 oxr_path_get_string(
     struct oxr_logger *log, const struct oxr_instance *inst, XrPath path, const char **out_str, size_t *out_length);
 
+/*!
+ * Get the classified last component of the path, for instance
+ * "/user/hand/left/input/trigger/click" returns @ref OXR_PATH_COMPONENT_CLICK.
+ * Returns @ref OXR_PATH_COMPONENT_NONE for unknown components and invalid
+ * paths.
+ *
+ * @public @memberof oxr_instance
+ */
+enum oxr_path_component
+oxr_path_get_component(struct oxr_logger *log, const struct oxr_instance *inst, XrPath path);
+
+/*!
+ * Get which top level user path the given path starts with, classified once
+ * when the path was interned.
+ *
+ * @return false if the path is invalid or doesn't start with a valid subaction path.
+ * @public @memberof oxr_instance
+ */
+bool
+oxr_path_get_subaction_path(struct oxr_logger *log,
+                            const struct oxr_instance *inst,
+                            XrPath path,
+                            enum oxr_subaction_path *out_subaction_path);
+
 /*!
  * Destroy the path system and all paths that the instance has created.
  *
@@ -1683,14 +1708,8 @@ struct oxr_instance
 		struct u_hashset *loc_store;
 	} action_sets;
 
-	//! Path store, for looking up paths.
-	struct u_hashset *path_store;
-	//! Mapping from ID to path.
-	struct oxr_path **path_array;
-	//! Total length of path array.
-	size_t path_array_length;
-	//! Number of paths in the array (0 is always null).
-	size_t path_num;
+	//! Arena backed path interner, lookups are lock free, see oxr_path.c.
+	struct oxr_path_store *path_store;
 
 	// Event queue.
 	struct
@@ -1822,6 +1841,26 @@ struct oxr_session
 	 */
 	struct os_precise_sleeper sleeper;
 
+	/*!
+	 * When both hands come from the same device, locating one hand fetches
+	 * the other one in the same batch call and keeps it here until it is
+	 * located, see oxr_session_hand_joints.
+	 */
+	struct
+	{
+		struct os_mutex mutex;
+
+		//! Last time each hand was located, indexed by XrHandEXT - 1.
+		int64_t last_located_ns[2];
+
+		//! Device and input of the prefetched hand, NULL if none.
+		struct xrt_device *xdev;
+		enum xrt_input_name name;
+		int64_t at_timestamp_ns;
+		int64_t fetched_ns;
+		struct xrt_hand_joint_set value;
+	} hand_prefetch;
+
 	/*!
 	 * An array of action set attachments that this session owns.
 	 *
@@ -2002,6 +2041,27 @@ struct oxr_dpad_emulation
 	enum xrt_input_name activate; // Can be zero
 };
 
+/*!
+ * Refers to a path in a binding of a @ref oxr_interaction_profile, used to
+ * find all bindings a path is part of with a binary search.
+ */
+struct oxr_binding_path_ref
+{
+	XrPath path;
+	uint32_t binding_index;
+	uint32_t path_index;
+};
+
+/*!
+ * Refers to a action key on a binding of a @ref oxr_interaction_profile, used
+ * to find all bindings a action is bound to with a binary search.
+ */
+struct oxr_binding_act_key_ref
+{
+	uint32_t act_key;
+	uint32_t binding_index;
+};
+
 /*!
  * A single interaction profile.
  */
@@ -2018,6 +2078,14 @@ struct oxr_interaction_profile
 	struct oxr_binding *bindings;
 	size_t binding_count;
 
+	//! Every path of every binding, sorted by path then binding index.
+	struct oxr_binding_path_ref *path_refs;
+	size_t path_ref_count;
+
+	//! Action keys of all bindings, sorted by key then binding index.
+	struct oxr_binding_act_key_ref *act_key_refs;
+	size_t act_key_ref_count;
+
 	struct oxr_dpad_emulation *dpads;
 	size_t dpad_count;
 
@@ -13,14 +13,35 @@
 
 #include "math/m_api.h"
 #include "util/u_misc.h"
+#include "os/os_threading.h"
 
 #include "oxr_objects.h"
 #include "oxr_logger.h"
 
 
 /*!
- * Internal representation of a path, item follows this struct in memory and
- * that in turn is followed by the string.
+ * Size of each arena block, paths longer then this gets their own block.
+ */
+#define OXR_PATH_ARENA_BLOCK_SIZE (16 * 1024)
+
+/*!
+ * The id to path table is split up into fixed sized chunks, a chunk is never
+ * moved once allocated, which is what allows lock free lookups of ids.
+ */
+#define OXR_PATH_CHUNK_SHIFT (8)
+#define OXR_PATH_CHUNK_SIZE (1u << OXR_PATH_CHUNK_SHIFT)
+#define OXR_PATH_CHUNK_MASK (OXR_PATH_CHUNK_SIZE - 1)
+#define OXR_PATH_MAX_CHUNKS (4096)
+
+/*!
+ * Starting size of the string to path hash table, must be a power of two.
+ */
+#define OXR_PATH_TABLE_START_SIZE (1024)
+
+
+/*!
+ * Internal representation of a path, allocated from the arena of the store
+ * and directly followed by the null terminated string.
  *
  * @ingroup oxr_main
  */
@@ -29,9 +50,107 @@ struct oxr_path
 	uint64_t debug;
 	XrPath id;
 	void *attached;
+
+	//! Precomputed hash of the full string.
+	size_t hash;
+
+	//! Length of the string, not including null terminator.
+	uint32_t length;
+
+	//! Offset to the first character after the last '/'.
+	uint32_t leaf_offset;
+
+	//! Classified last component, for quick binding lookups.
+	enum oxr_path_component component;
+
+	//! Is @ref subaction_path valid.
+	bool has_subaction_path;
+
+	//! Which top level user path this path starts with.
+	enum oxr_subaction_path subaction_path;
+
+	char str[];
+};
+
+/*!
+ * A single block of the path arena, paths are never freed individually.
+ */
+struct oxr_path_arena_block
+{
+	struct oxr_path_arena_block *next;
+	size_t used;
+	size_t size;
+	uint8_t data[];
+};
+
+/*!
+ * Open addressed string to path table, old tables are kept alive until the
+ * store is destroyed so that lock free readers never touch freed memory.
+ */
+struct oxr_path_table
+{
+	struct oxr_path_table *prev;
+	size_t mask;
+	size_t count;
+	struct oxr_path *slots[];
+};
+
+/*!
+ * The instance path store, writers are serialized with the mutex while
+ * readers only use acquire loads.
+ *
+ * @ingroup oxr_main
+ */
+struct oxr_path_store
+{
+	//! Serializes creation of paths.
+	struct os_mutex mutex;
+
+	//! Current head of the arena, only touched with the lock held.
+	struct oxr_path_arena_block *arena;
+
+	//! Chunks of id to path mappings, see @ref OXR_PATH_CHUNK_SIZE.
+	struct oxr_path **chunks[OXR_PATH_MAX_CHUNKS];
+
+	//! Number of ids handed out (0 is always null), only touched with the lock held.
+	size_t num;
+
+	//! Current string to path table.
+	struct oxr_path_table *table;
 };
 
 
+/*
+ *
+ * Atomic helpers.
+ *
+ */
+
+static inline void *
+load_acquire_ptr(void *const volatile *ptr)
+{
+#if defined(__GNUC__)
+	return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#elif defined(_MSC_VER)
+	return InterlockedCompareExchangePointer((PVOID volatile *)ptr, NULL, NULL);
+#else
+#error "compiler not supported"
+#endif
+}
+
+static inline void
+store_release_ptr(void *volatile *ptr, void *value)
+{
+#if defined(__GNUC__)
+	__atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#elif defined(_MSC_VER)
+	InterlockedExchangePointer((PVOID volatile *)ptr, value);
+#else
+#error "compiler not supported"
+#endif
+}
+
+
 /*
  *
  * Helpers
@@ -44,104 +163,252 @@ to_xr_path(struct oxr_path *path)
 	return path->id;
 }
 
-static inline struct u_hashset_item *
-get_item(struct oxr_path *path)
+static enum oxr_path_component
+classify_component(const char *leaf, size_t length)
 {
-	return (struct u_hashset_item *)&path[1];
+#define CHECK(STR, COMPONENT)                                                                                          \
+	if (length == sizeof(STR) - 1 && memcmp(leaf, STR, length) == 0) {                                             \
+		return COMPONENT;                                                                                      \
+	}
+
+	CHECK("click", OXR_PATH_COMPONENT_CLICK);
+	CHECK("touch", OXR_PATH_COMPONENT_TOUCH);
+	CHECK("value", OXR_PATH_COMPONENT_VALUE);
+	CHECK("force", OXR_PATH_COMPONENT_FORCE);
+	CHECK("pose", OXR_PATH_COMPONENT_POSE);
+	CHECK("haptic", OXR_PATH_COMPONENT_HAPTIC);
+
+#undef CHECK
+
+	return OXR_PATH_COMPONENT_NONE;
 }
 
-static inline struct oxr_path *
-from_item(struct u_hashset_item *item)
+static bool
+classify_subaction_path(const char *str, size_t length, enum oxr_subaction_path *out_subaction_path)
 {
-	return &((struct oxr_path *)item)[-1];
+#define CHECK(LOWER, CAP, PATH)                                                                                        \
+	if (length >= sizeof(PATH) - 1 && strncmp(PATH, str, sizeof(PATH) - 1) == 0) {                                \
+		*out_subaction_path = OXR_SUB_ACTION_PATH_##CAP;                                                       \
+		return true;                                                                                           \
+	}
+
+	OXR_FOR_EACH_VALID_SUBACTION_PATH_DETAILED(CHECK)
+
+#undef CHECK
+
+	return false;
 }
 
+static void *
+arena_alloc(struct oxr_path_store *store, size_t size)
+{
+	// Keep every allocation aligned for the path struct.
+	size = (size + (sizeof(uint64_t) - 1)) & ~(sizeof(uint64_t) - 1);
 
-/*
- *
- * Static functions.
- *
- */
+	struct oxr_path_arena_block *block = store->arena;
+	if (block == NULL || block->size - block->used < size) {
+		size_t block_size = size > OXR_PATH_ARENA_BLOCK_SIZE ? size : OXR_PATH_ARENA_BLOCK_SIZE;
 
-static XrResult
-oxr_ensure_array_length(struct oxr_logger *log, struct oxr_instance *inst, XrPath *out_id)
+		block = U_CALLOC_WITH_CAST(struct oxr_path_arena_block, sizeof(*block) + block_size);
+		if (block == NULL) {
+			return NULL;
+		}
+
+		block->size = block_size;
+		block->next = store->arena;
+		store->arena = block;
+	}
+
+	void *ptr = &block->data[block->used];
+	block->used += size;
+
+	return ptr;
+}
+
+static struct oxr_path_table *
+table_create(size_t size)
 {
-	size_t num = inst->path_num + 1;
+	struct oxr_path_table *table =
+	    U_CALLOC_WITH_CAST(struct oxr_path_table, sizeof(*table) + sizeof(struct oxr_path *) * size);
+	if (table == NULL) {
+		return NULL;
+	}
 
-	if (num < inst->path_array_length) {
-		*out_id = inst->path_num++;
-		return XR_SUCCESS;
+	table->mask = size - 1;
+
+	return table;
+}
+
+static void
+table_insert(struct oxr_path_table *table, struct oxr_path *path)
+{
+	size_t i = path->hash & table->mask;
+	while (table->slots[i] != NULL) {
+		i = (i + 1) & table->mask;
 	}
 
-	size_t new_size = inst->path_array_length;
-	while (new_size < num) {
-		new_size += 64;
+	// Publish the fully written path to any lock free readers.
+	store_release_ptr((void *volatile *)&table->slots[i], path);
+	table->count++;
+}
+
+static struct oxr_path *
+table_find(const struct oxr_path_table *table, const char *str, size_t length, size_t hash)
+{
+	size_t i = hash & table->mask;
+	while (true) {
+		struct oxr_path *path = load_acquire_ptr((void *const volatile *)&table->slots[i]);
+		if (path == NULL) {
+			return NULL;
+		}
+
+		if (path->hash == hash && path->length == length && memcmp(path->str, str, length) == 0) {
+			return path;
+		}
+
+		i = (i + 1) & table->mask;
 	}
+}
 
-	U_ARRAY_REALLOC_OR_FREE(inst->path_array, struct oxr_path *, new_size);
-	inst->path_array_length = new_size;
+static struct oxr_path *
+store_find(struct oxr_path_store *store, const char *str, size_t length, size_t hash)
+{
+	struct oxr_path_table *table = load_acquire_ptr((void *const volatile *)&store->table);
 
-	*out_id = inst->path_num++;
+	return table_find(table, str, length, hash);
+}
 
-	return XR_SUCCESS;
+/*!
+ * Grows the table if needed, must be called with the lock held.
+ */
+static bool
+store_ensure_table_space(struct oxr_path_store *store)
+{
+	struct oxr_path_table *old = store->table;
+
+	// Keep load factor at or below one half.
+	if ((old->count + 1) * 2 <= old->mask + 1) {
+		return true;
+	}
+
+	struct oxr_path_table *table = table_create((old->mask + 1) * 2);
+	if (table == NULL) {
+		return false;
+	}
+
+	for (size_t i = 0; i <= old->mask; i++) {
+		if (old->slots[i] != NULL) {
+			table_insert(table, old->slots[i]);
+		}
+	}
+
+	// Readers may still be using the old table, keep it alive.
+	table->prev = old;
+	store_release_ptr((void *volatile *)&store->table, table);
+
+	return true;
+}
+
+/*!
+ * Hands out the next id, must be called with the lock held.
+ */
+static bool
+store_ensure_id(struct oxr_path_store *store, XrPath *out_id)
+{
+	size_t id = store->num;
+	size_t chunk = id >> OXR_PATH_CHUNK_SHIFT;
+
+	if (chunk >= OXR_PATH_MAX_CHUNKS) {
+		return false;
+	}
+
+	if (store->chunks[chunk] == NULL) {
+		struct oxr_path **ptr = U_TYPED_ARRAY_CALLOC(struct oxr_path *, OXR_PATH_CHUNK_SIZE);
+		if (ptr == NULL) {
+			return false;
+		}
+
+		store_release_ptr((void *volatile *)&store->chunks[chunk], ptr);
+	}
+
+	store->num++;
+	*out_id = id;
+
+	return true;
 }
 
 static XrResult
-oxr_allocate_path(
-    struct oxr_logger *log, struct oxr_instance *inst, const char *str, size_t length, struct oxr_path **out_path)
+oxr_allocate_path(struct oxr_logger *log,
+                  struct oxr_instance *inst,
+                  const char *str,
+                  size_t length,
+                  size_t hash,
+                  struct oxr_path **out_path)
 {
-	struct u_hashset_item *item = NULL;
+	struct oxr_path_store *store = inst->path_store;
 	struct oxr_path *path = NULL;
-	size_t size = 0;
-	int ret;
+	XrPath id = XR_NULL_PATH;
 
-	size += sizeof(struct oxr_path);       // Main path object.
-	size += sizeof(struct u_hashset_item); // Embedded hashset item.
-	size += length;                        // String.
-	size += 1;                             // Null terminate it.
+	if (length > UINT32_MAX) {
+		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE, "Path too long");
+	}
 
-	// Now allocate and setup the path.
-	path = U_CALLOC_WITH_CAST(struct oxr_path, size);
+	if (!store_ensure_table_space(store)) {
+		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE, "Failed to grow path table");
+	}
+
+	if (!store_ensure_id(store, &id)) {
+		return oxr_error(log, XR_ERROR_PATH_COUNT_EXCEEDED, "Too many paths");
+	}
+
+	path = arena_alloc(store, sizeof(struct oxr_path) + length + 1);
 	if (path == NULL) {
 		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE, "Failed to allocate path");
 	}
-	path->debug = OXR_XR_DEBUG_PATH;
 
-	// Setup the item.
-	item = get_item(path);
-	item->hash = math_hash_string(str, length);
-	item->length = length;
+	path->debug = OXR_XR_DEBUG_PATH;
+	path->id = id;
+	path->hash = hash;
+	path->length = (uint32_t)length;
 
-	// Yes a const cast! D:
-	char *store = (char *)item->c_str;
-	for (size_t i = 0; i < length; i++) {
-		store[i] = str[i];
-	}
-	store[length] = '\0';
+	memcpy(path->str, str, length);
+	path->str[length] = '\0';
 
-	// Insert and return.
-	ret = u_hashset_insert_item(inst->path_store, item);
-	if (ret) {
-		free(path);
-		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE, "Failed to insert item");
+	// Split out the last component.
+	size_t leaf_offset = length;
+	while (leaf_offset > 0 && str[leaf_offset - 1] != '/') {
+		leaf_offset--;
 	}
+	path->leaf_offset = (uint32_t)leaf_offset;
+	path->component = classify_component(str + leaf_offset, length - leaf_offset);
+	path->has_subaction_path = classify_subaction_path(str, length, &path->subaction_path);
 
-	oxr_ensure_array_length(log, inst, &path->id);
-	inst->path_array[path->id] = path;
+	// Make the path visible by id and then by string.
+	struct oxr_path **chunk = store->chunks[id >> OXR_PATH_CHUNK_SHIFT];
+	store_release_ptr((void *volatile *)&chunk[id & OXR_PATH_CHUNK_MASK], path);
+	table_insert(store->table, path);
 
 	*out_path = path;
 
 	return XR_SUCCESS;
 }
 
-struct oxr_path *
+static struct oxr_path *
 get_path_or_null(struct oxr_logger *log, const struct oxr_instance *inst, XrPath xr_path)
 {
-	if (xr_path >= inst->path_array_length) {
+	const struct oxr_path_store *store = inst->path_store;
+
+	if (xr_path == XR_NULL_PATH || (xr_path >> OXR_PATH_CHUNK_SHIFT) >= OXR_PATH_MAX_CHUNKS) {
+		return NULL;
+	}
+
+	struct oxr_path **const *chunk_ptr = &store->chunks[xr_path >> OXR_PATH_CHUNK_SHIFT];
+	struct oxr_path **chunk = load_acquire_ptr((void *const volatile *)chunk_ptr);
+	if (chunk == NULL) {
 		return NULL;
 	}
 
-	return inst->path_array[xr_path];
+	return load_acquire_ptr((void *const volatile *)&chunk[xr_path & OXR_PATH_CHUNK_MASK]);
 }
 
 
@@ -172,20 +439,29 @@ XrResult
 oxr_path_get_or_create(
     struct oxr_logger *log, struct oxr_instance *inst, const char *str, size_t length, XrPath *out_path)
 {
-	struct u_hashset_item *item;
+	struct oxr_path_store *store = inst->path_store;
 	struct oxr_path *path = NULL;
-	XrResult ret;
-	int h_ret;
+	XrResult ret = XR_SUCCESS;
+
+	size_t hash = math_hash_string(str, length);
 
-	// Look it up the instance path store.
-	h_ret = u_hashset_find_str(inst->path_store, str, length, &item);
-	if (h_ret == 0) {
-		*out_path = to_xr_path(from_item(item));
+	// Lock free fast path, most paths are created once and looked up many times.
+	path = store_find(store, str, length, hash);
+	if (path != NULL) {
+		*out_path = to_xr_path(path);
 		return XR_SUCCESS;
 	}
 
-	// Create the path since it was not found.
-	ret = oxr_allocate_path(log, inst, str, length, &path);
+	os_mutex_lock(&store->mutex);
+
+	// Somebody might have created it while we waited for the lock.
+	path = store_find(store, str, length, hash);
+	if (path == NULL) {
+		ret = oxr_allocate_path(log, inst, str, length, hash, &path);
+	}
+
+	os_mutex_unlock(&store->mutex);
+
 	if (ret != XR_SUCCESS) {
 		return ret;
 	}
@@ -198,13 +474,9 @@ oxr_path_get_or_create(
 XrResult
 oxr_path_only_get(struct oxr_logger *log, struct oxr_instance *inst, const char *str, size_t length, XrPath *out_path)
 {
-	struct u_hashset_item *item;
-	int h_ret;
-
-	// Look it up the instance path store.
-	h_ret = u_hashset_find_str(inst->path_store, str, length, &item);
-	if (h_ret == 0) {
-		*out_path = to_xr_path(from_item(item));
+	struct oxr_path *path = store_find(inst->path_store, str, length, math_hash_string(str, length));
+	if (path != NULL) {
+		*out_path = to_xr_path(path);
 		return XR_SUCCESS;
 	}
 
@@ -221,32 +493,69 @@ oxr_path_get_string(
 		return XR_ERROR_PATH_INVALID;
 	}
 
-	*out_str = get_item(path)->c_str;
-	*out_length = get_item(path)->length;
+	*out_str = path->str;
+	*out_length = path->length;
 
 	return XR_SUCCESS;
 }
 
-void
-destroy_callback(struct u_hashset_item *item, void *priv)
+enum oxr_path_component
+oxr_path_get_component(struct oxr_logger *log, const struct oxr_instance *inst, XrPath xr_path)
 {
-	struct oxr_path *path = from_item(item);
+	struct oxr_path *path = get_path_or_null(log, inst, xr_path);
+	if (path == NULL) {
+		return OXR_PATH_COMPONENT_NONE;
+	}
 
-	free(path);
+	return path->component;
+}
+
+bool
+oxr_path_get_subaction_path(struct oxr_logger *log,
+                            const struct oxr_instance *inst,
+                            XrPath xr_path,
+                            enum oxr_subaction_path *out_subaction_path)
+{
+	struct oxr_path *path = get_path_or_null(log, inst, xr_path);
+	if (path == NULL || !path->has_subaction_path) {
+		return false;
+	}
+
+	*out_subaction_path = path->subaction_path;
+
+	return true;
 }
 
 XrResult
 oxr_path_init(struct oxr_logger *log, struct oxr_instance *inst)
 {
-	int h_ret = u_hashset_create(&inst->path_store);
-	if (h_ret != 0) {
-		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE, "Failed to create hashset");
+	struct oxr_path_store *store = U_TYPED_CALLOC(struct oxr_path_store);
+	if (store == NULL) {
+		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE, "Failed to allocate path store");
+	}
+
+	if (os_mutex_init(&store->mutex) != 0) {
+		free(store);
+		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE, "Failed to init path store mutex");
+	}
+
+	store->table = table_create(OXR_PATH_TABLE_START_SIZE);
+	if (store->table == NULL) {
+		os_mutex_destroy(&store->mutex);
+		free(store);
+		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE, "Failed to create path table");
+	}
+
+	// Reserve space for XR_NULL_PATH
+	XrPath null_path;
+	if (!store_ensure_id(store, &null_path)) {
+		free(store->table);
+		os_mutex_destroy(&store->mutex);
+		free(store);
+		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE, "Failed to reserve null path");
 	}
 
-	size_t new_size = 64;
-	U_ARRAY_REALLOC_OR_FREE(inst->path_array, struct oxr_path *, new_size);
-	inst->path_array_length = new_size;
-	inst->path_num = 1; // Reserve space for XR_NULL_PATH
+	inst->path_store = store;
 
 	return XR_SUCCESS;
 }
@@ -254,18 +563,29 @@ oxr_path_init(struct oxr_logger *log, struct oxr_instance *inst)
 void
 oxr_path_destroy(struct oxr_logger *log, struct oxr_instance *inst)
 {
-	if (inst->path_array != NULL) {
-		free(inst->path_array);
+	struct oxr_path_store *store = inst->path_store;
+	if (store == NULL) {
+		return;
 	}
 
-	inst->path_array = NULL;
-	inst->path_num = 0;
-	inst->path_array_length = 0;
+	for (size_t i = 0; i < OXR_PATH_MAX_CHUNKS; i++) {
+		free(store->chunks[i]);
+	}
 
-	if (inst->path_store == NULL) {
-		return;
+	while (store->table != NULL) {
+		struct oxr_path_table *prev = store->table->prev;
+		free(store->table);
+		store->table = prev;
+	}
+
+	while (store->arena != NULL) {
+		struct oxr_path_arena_block *next = store->arena->next;
+		free(store->arena);
+		store->arena = next;
 	}
 
-	u_hashset_clear_and_call_for_each(inst->path_store, destroy_callback, inst);
-	u_hashset_destroy(&inst->path_store);
+	os_mutex_destroy(&store->mutex);
+	free(store);
+
+	inst->path_store = NULL;
 }
@@ -34,6 +34,7 @@
 #include "util/u_verify.h"
 
 #include "math/m_api.h"
+#include "math/m_hand_joints.h"
 #include "math/m_mathinclude.h"
 #include "math/m_space.h"
 
@@ -786,7 +787,22 @@ oxr_session_frame_wait(struct oxr_logger *log, struct oxr_session *sess, XrFrame
 
 	struct xrt_compositor *xc = sess->compositor;
 	if (xc == NULL) {
+		/*
+		 * Headless, nothing to pace against, but xrBeginFrame and
+		 * xrEndFrame still expect the waited frame to be accounted for.
+		 */
+		XrResult sync_ret = oxr_frame_sync_wait_frame(&sess->frame_sync);
+		if (XR_SUCCESS != sync_ret) {
+			// session not running
+			return sync_ret;
+		}
+
+		os_mutex_lock(&sess->active_wait_frames_lock);
+		sess->active_wait_frames++;
+		os_mutex_unlock(&sess->active_wait_frames_lock);
+
 		frameState->shouldRender = XR_FALSE;
+		frameState->predictedDisplayTime = now;
 		return oxr_session_success_result(sess);
 	}
 
@@ -949,6 +965,7 @@ oxr_session_destroy(struct oxr_logger *log, struct oxr_handle_base *hb)
 	os_precise_sleeper_deinit(&sess->sleeper);
 	oxr_frame_sync_fini(&sess->frame_sync);
 	os_mutex_destroy(&sess->active_wait_frames_lock);
+	os_mutex_destroy(&sess->hand_prefetch.mutex);
 
 	free(sess);
 
@@ -978,6 +995,7 @@ oxr_session_allocate_and_init(struct oxr_logger *log,
 
 	sess->active_wait_frames = 0;
 	os_mutex_init(&sess->active_wait_frames_lock);
+	os_mutex_init(&sess->hand_prefetch.mutex);
 
 	// Debug and user options.
 	sess->ipd_meters = debug_get_num_option_ipd() / 1000.0f;
@@ -1283,6 +1301,81 @@ xrt_to_xr_pose(struct xrt_pose *xrt_pose, XrPosef *xr_pose)
 	xr_pose->position.z = xrt_pose->position.z;
 }
 
+/*!
+ * A prefetched hand is only used if it was fetched this recently.
+ */
+#define OXR_HAND_PREFETCH_MAX_AGE_NS (4 * U_TIME_1MS_IN_NS)
+
+/*!
+ * The other hand is only prefetched if it has been located this recently.
+ */
+#define OXR_HAND_PREFETCH_IN_USE_NS (U_TIME_1S_IN_NS)
+
+static xrt_result_t
+get_hand_joint_set(struct oxr_session *sess,
+                   struct oxr_hand_tracker *hand_tracker,
+                   int64_t at_timestamp_ns,
+                   struct xrt_hand_joint_set *out_value)
+{
+	struct xrt_device *xdev = hand_tracker->xdev;
+	enum xrt_input_name name = hand_tracker->input_name;
+	int64_t now_ns = os_monotonic_get_ns();
+	int64_t ignored;
+
+	bool is_left = hand_tracker->hand == XR_HAND_LEFT_EXT;
+	struct xrt_device *other_xdev =
+	    is_left ? GET_XDEV_BY_ROLE(sess->sys, hand_tracking_right) : GET_XDEV_BY_ROLE(sess->sys, hand_tracking_left);
+	enum xrt_input_name other_name =
+	    is_left ? XRT_INPUT_GENERIC_HAND_TRACKING_RIGHT : XRT_INPUT_GENERIC_HAND_TRACKING_LEFT;
+
+	os_mutex_lock(&sess->hand_prefetch.mutex);
+
+	sess->hand_prefetch.last_located_ns[is_left ? 0 : 1] = now_ns;
+	bool other_in_use = now_ns - sess->hand_prefetch.last_located_ns[is_left ? 1 : 0] < OXR_HAND_PREFETCH_IN_USE_NS;
+
+	bool hit = sess->hand_prefetch.xdev == xdev &&                      //
+	           sess->hand_prefetch.name == name &&                      //
+	           sess->hand_prefetch.at_timestamp_ns == at_timestamp_ns && //
+	           now_ns - sess->hand_prefetch.fetched_ns < OXR_HAND_PREFETCH_MAX_AGE_NS;
+	if (hit) {
+		*out_value = sess->hand_prefetch.value;
+		sess->hand_prefetch.xdev = NULL;
+	}
+
+	os_mutex_unlock(&sess->hand_prefetch.mutex);
+
+	if (hit) {
+		return XRT_SUCCESS;
+	}
+
+	// Only the one hand, the other one is on a different device or unused.
+	if (other_xdev != xdev || !other_in_use || name == other_name) {
+		return xrt_device_get_hand_tracking(xdev, name, at_timestamp_ns, out_value, &ignored);
+	}
+
+	enum xrt_input_name names[2] = {name, other_name};
+	int64_t timestamps_ns[2] = {at_timestamp_ns, at_timestamp_ns};
+	struct xrt_hand_joint_set values[2];
+	int64_t out_timestamps_ns[2];
+
+	xrt_result_t xret = xrt_device_get_hand_tracking_batch(xdev, 2, names, timestamps_ns, values, out_timestamps_ns);
+	if (xret != XRT_SUCCESS) {
+		return xret;
+	}
+
+	*out_value = values[0];
+
+	os_mutex_lock(&sess->hand_prefetch.mutex);
+	sess->hand_prefetch.xdev = xdev;
+	sess->hand_prefetch.name = other_name;
+	sess->hand_prefetch.at_timestamp_ns = at_timestamp_ns;
+	sess->hand_prefetch.fetched_ns = now_ns;
+	sess->hand_prefetch.value = values[1];
+	os_mutex_unlock(&sess->hand_prefetch.mutex);
+
+	return XRT_SUCCESS;
+}
+
 XrResult
 oxr_session_hand_joints(struct oxr_logger *log,
                         struct oxr_hand_tracker *hand_tracker,
@@ -1303,7 +1396,6 @@ oxr_session_hand_joints(struct oxr_logger *log,
 	}
 
 	struct xrt_device *xdev = hand_tracker->xdev;
-	enum xrt_input_name name = hand_tracker->input_name;
 
 	XrTime at_time = locateInfo->time;
 
@@ -1311,9 +1403,8 @@ oxr_session_hand_joints(struct oxr_logger *log,
 	int64_t at_timestamp_ns = time_state_ts_to_monotonic_ns(inst->timekeeping, at_time);
 
 	struct xrt_hand_joint_set value;
-	int64_t ignored;
 
-	xrt_result_t xret = xrt_device_get_hand_tracking(xdev, name, at_timestamp_ns, &value, &ignored);
+	xrt_result_t xret = get_hand_joint_set(sess, hand_tracker, at_timestamp_ns, &value);
 	OXR_CHECK_XRET(log, sess, xret, xrt_device_get_hand_tracking);
 
 	// The hand pose is returned in the xdev's space.
@@ -1358,40 +1449,49 @@ oxr_session_hand_joints(struct oxr_logger *log,
 	// We know we are active.
 	locations->isActive = true;
 
-	for (uint32_t i = 0; i < locations->jointCount; i++) {
-		locations->jointLocations[i].locationFlags =
-		    xrt_to_xr_space_location_flags(value.values.hand_joint_set_default[i].relation.relation_flags);
-		locations->jointLocations[i].radius = value.values.hand_joint_set_default[i].radius;
-
-		struct xrt_space_relation r = value.values.hand_joint_set_default[i].relation;
+	// Put all joints into the base space in one pass.
+	struct m_hand_joints_soa joints;
+	m_hand_joints_soa_from_set(&value, &joints);
+	m_hand_joints_soa_transform(&T_base_hand, &joints);
 
-		struct xrt_space_relation result;
-		struct xrt_relation_chain chain = {0};
-		m_relation_chain_push_relation(&chain, &r);
-		m_relation_chain_push_relation(&chain, &T_base_hand);
-		m_relation_chain_resolve(&chain, &result);
+	uint32_t joint_count = MIN(locations->jointCount, XRT_HAND_JOINT_COUNT);
 
-		xrt_to_xr_pose(&result.pose, &locations->jointLocations[i].pose);
+	for (uint32_t i = 0; i < joint_count; i++) {
+		XrHandJointLocationEXT *l = &locations->jointLocations[i];
 
-		if (vel) {
-			XrHandJointVelocityEXT *v = &vel->jointVelocities[i];
+		l->locationFlags = xrt_to_xr_space_location_flags((enum xrt_space_relation_flags)joints.flags[i]);
+		l->radius = joints.radius[i];
+		l->pose.orientation.x = joints.qx[i];
+		l->pose.orientation.y = joints.qy[i];
+		l->pose.orientation.z = joints.qz[i];
+		l->pose.orientation.w = joints.qw[i];
+		l->pose.position.x = joints.px[i];
+		l->pose.position.y = joints.py[i];
+		l->pose.position.z = joints.pz[i];
+	}
 
-			v->velocityFlags = 0;
-			if ((result.relation_flags & XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT)) {
-				v->velocityFlags |= XR_SPACE_VELOCITY_LINEAR_VALID_BIT;
-			}
-			if ((result.relation_flags & XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT)) {
-				v->velocityFlags |= XR_SPACE_VELOCITY_ANGULAR_VALID_BIT;
-			}
+	if (vel == NULL) {
+		return XR_SUCCESS;
+	}
 
-			v->linearVelocity.x = result.linear_velocity.x;
-			v->linearVelocity.y = result.linear_velocity.y;
-			v->linearVelocity.z = result.linear_velocity.z;
+	for (uint32_t i = 0; i < joint_count; i++) {
+		XrHandJointVelocityEXT *v = &vel->jointVelocities[i];
 
-			v->angularVelocity.x = result.angular_velocity.x;
-			v->angularVelocity.y = result.angular_velocity.y;
-			v->angularVelocity.z = result.angular_velocity.z;
+		v->velocityFlags = 0;
+		if ((joints.flags[i] & XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT)) {
+			v->velocityFlags |= XR_SPACE_VELOCITY_LINEAR_VALID_BIT;
+		}
+		if ((joints.flags[i] & XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT)) {
+			v->velocityFlags |= XR_SPACE_VELOCITY_ANGULAR_VALID_BIT;
 		}
+
+		v->linearVelocity.x = joints.lx[i];
+		v->linearVelocity.y = joints.ly[i];
+		v->linearVelocity.z = joints.lz[i];
+
+		v->angularVelocity.x = joints.ax[i];
+		v->angularVelocity.y = joints.ay[i];
+		v->angularVelocity.z = joints.az[i];
 	}
 
 	return XR_SUCCESS;
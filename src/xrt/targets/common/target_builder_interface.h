@@ -39,6 +39,10 @@
 #define T_BUILDER_QWERTY
 #endif
 
+#if defined(XRT_BUILD_DRIVER_REPLAY) || defined(XRT_DOXYGEN)
+#define T_BUILDER_REPLAY
+#endif
+
 #if defined(XRT_BUILD_DRIVER_PSMV) || defined(XRT_BUILD_DRIVER_PSVR) || defined(XRT_DOXYGEN)
 #define T_BUILDER_RGB_TRACKING
 #endif
@@ -110,6 +114,14 @@ struct xrt_builder *
 t_builder_remote_create(void);
 #endif
 
+#ifdef T_BUILDER_REPLAY
+/*!
+ * Builder for @ref drv_replay devices.
+ */
+struct xrt_builder *
+t_builder_replay_create(void);
+#endif
+
 #ifdef T_BUILDER_RGB_TRACKING
 /*!
  * RGB tracking based drivers, like @ref drv_psmv and @ref drv_psvr.
@@ -337,36 +337,23 @@ ns_setup_depthai_device(struct ns_builder *nsb,
 	}
 #endif
 
-	struct xrt_slam_sinks entry_sinks = {0};
-	struct xrt_frame_sink *entry_left_sink = NULL;
-	struct xrt_frame_sink *entry_right_sink = NULL;
+	struct xrt_frame_set_sink *entry_set_sink = NULL;
 
 #ifdef XRT_BUILD_DRIVER_HANDTRACKING
-	u_sink_split_create(xfctx, slam_sinks->cams[0], hand_sinks->cams[0], &entry_left_sink);
-	u_sink_split_create(xfctx, slam_sinks->cams[1], hand_sinks->cams[1], &entry_right_sink);
+	u_sink_frame_set_split_create(xfctx, slam_sinks->frame_set, hand_sinks->frame_set, &entry_set_sink);
 #else
-	entry_left_sink = slam_sinks->cams[0];
-	entry_right_sink = slam_sinks->cams[1];
+	entry_set_sink = slam_sinks->frame_set;
 #endif
 
-	entry_sinks = (struct xrt_slam_sinks){
-	    .cams[0] = entry_left_sink,
-	    .cams[1] = entry_right_sink,
-	    .imu = slam_sinks->imu,
-	    .gt = slam_sinks->gt,
-	};
-
-	struct xrt_slam_sinks unused_slam_sinks = {0};
-	unused_slam_sinks.imu = entry_sinks.imu;
+	struct xrt_slam_sinks entry_sinks = {0};
+	entry_sinks.imu = slam_sinks->imu;
 
-	u_sink_force_genlock_create(     //
-	    xfctx,                       //
-	    entry_sinks.cams[0],         //
-	    entry_sinks.cams[1],         //
-	    &unused_slam_sinks.cams[0],  //
-	    &unused_slam_sinks.cams[1]); //
+	// Pairs up the cameras, both trackers get references to the same frames.
+	if (!u_sink_sync_create(xfctx, 2, U_TIME_1MS_IN_NS, entry_set_sink, entry_sinks.cams)) {
+		return XRT_ERROR_DEVICE_CREATION_FAILED;
+	}
 
-	xrt_fs_slam_stream_start(the_fs, &unused_slam_sinks);
+	xrt_fs_slam_stream_start(the_fs, &entry_sinks);
 
 	return XRT_SUCCESS;
 }
@@ -0,0 +1,166 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Builder for devices replayed from a capture file.
+ * @ingroup xrt_iface
+ */
+
+#include "xrt/xrt_config_drivers.h"
+#include "xrt/xrt_prober.h"
+
+#include "util/u_misc.h"
+#include "util/u_debug.h"
+#include "util/u_builders.h"
+#include "util/u_config_json.h"
+#include "util/u_system_helpers.h"
+
+#include "target_builder_interface.h"
+
+#include "replay/replay_interface.h"
+
+#include <assert.h>
+
+
+#ifndef XRT_BUILD_DRIVER_REPLAY
+#error "Must only be built with XRT_BUILD_DRIVER_REPLAY set"
+#endif
+
+DEBUG_GET_ONCE_OPTION(replay_file, "REPLAY_FILE", NULL)
+DEBUG_GET_ONCE_BOOL_OPTION(replay_fast, "REPLAY_FAST", false)
+
+
+/*
+ *
+ * Helper functions.
+ *
+ */
+
+static const char *driver_list[] = {
+    "replay",
+};
+
+
+/*
+ *
+ * Member functions.
+ *
+ */
+
+static xrt_result_t
+replay_estimate_system(struct xrt_builder *xb,
+                       cJSON *config,
+                       struct xrt_prober *xp,
+                       struct xrt_builder_estimate *estimate)
+{
+	// Roles depend on what was captured, only known once the file is read.
+	estimate->maybe.head = true;
+	estimate->maybe.left = true;
+	estimate->maybe.right = true;
+	estimate->priority = -25;
+
+	return XRT_SUCCESS;
+}
+
+static xrt_result_t
+replay_open_system_impl(struct xrt_builder *xb,
+                        cJSON *config,
+                        struct xrt_prober *xp,
+                        struct xrt_tracking_origin *origin,
+                        struct xrt_system_devices *xsysd,
+                        struct xrt_frame_context *xfctx,
+                        struct u_builder_roles_helper *ubrh)
+{
+	const char *path = debug_get_option_replay_file();
+	if (path == NULL) {
+		U_LOG_E("No capture to replay, set REPLAY_FILE");
+		return XRT_ERROR_DEVICE_CREATION_FAILED;
+	}
+
+	enum replay_mode mode = debug_get_bool_option_replay_fast() ? REPLAY_MODE_FAST : REPLAY_MODE_REALTIME;
+
+	uint32_t count = 0;
+	xrt_result_t xret = replay_create_devices( //
+	    path,                                  //
+	    mode,                                  //
+	    xsysd->xdevs,                          //
+	    ARRAY_SIZE(xsysd->xdevs),              //
+	    &count);                               //
+	if (xret != XRT_SUCCESS) {
+		return xret;
+	}
+	xsysd->xdev_count = count;
+
+	// Assign to role(s) based on what the captured devices were.
+	for (uint32_t i = 0; i < count; i++) {
+		struct xrt_device *xdev = xsysd->xdevs[i];
+
+		switch (xdev->device_type) {
+		case XRT_DEVICE_TYPE_HMD:
+			if (ubrh->head == NULL) {
+				ubrh->head = xdev;
+			}
+			break;
+		case XRT_DEVICE_TYPE_LEFT_HAND_CONTROLLER:
+			if (ubrh->left == NULL) {
+				ubrh->left = xdev;
+			}
+			break;
+		case XRT_DEVICE_TYPE_RIGHT_HAND_CONTROLLER:
+			if (ubrh->right == NULL) {
+				ubrh->right = xdev;
+			}
+			break;
+		case XRT_DEVICE_TYPE_HAND_TRACKER:
+			if (ubrh->hand_tracking.left == NULL) {
+				ubrh->hand_tracking.left = xdev;
+			}
+			if (ubrh->hand_tracking.right == NULL) {
+				ubrh->hand_tracking.right = xdev;
+			}
+			break;
+		default: break;
+		}
+	}
+
+	if (ubrh->head == NULL) {
+		U_LOG_E("No HMD in capture '%s'", path);
+		return XRT_ERROR_DEVICE_CREATION_FAILED;
+	}
+
+	return XRT_SUCCESS;
+}
+
+static void
+replay_destroy(struct xrt_builder *xb)
+{
+	free(xb);
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+struct xrt_builder *
+t_builder_replay_create(void)
+{
+	struct u_builder *ub = U_TYPED_CALLOC(struct u_builder);
+
+	// xrt_builder fields.
+	ub->base.estimate_system = replay_estimate_system;
+	ub->base.open_system = u_builder_open_system_static_roles;
+	ub->base.destroy = replay_destroy;
+	ub->base.identifier = "replay";
+	ub->base.name = "Replay of captured devices builder";
+	ub->base.driver_identifiers = driver_list;
+	ub->base.driver_identifier_count = ARRAY_SIZE(driver_list);
+	ub->base.exclude_from_automatic_discovery = debug_get_option_replay_file() == NULL;
+
+	// u_builder fields.
+	ub->open_system_static_roles = replay_open_system_impl;
+
+	return &ub->base;
+}
@@ -116,6 +116,10 @@ xrt_builder_create_func_t target_builder_list[] = {
     t_builder_simulated_create,
 #endif // T_BUILDER_SIMULATED
 
+#ifdef T_BUILDER_REPLAY // High up to override any real hardware.
+    t_builder_replay_create,
+#endif // T_BUILDER_REPLAY
+
 #ifdef XRT_BUILD_DRIVER_RIFT_S
     rift_s_builder_create,
 #endif // XRT_BUILD_DRIVER_RIFT_S
@@ -0,0 +1,1113 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Frame loop benchmark, runs the runtime in process with the null
+ *         compositor and simulated devices.
+ *
+ * Each client is a thread with its own XrInstance and session that runs a
+ * wait/begin/locate/sync/end loop, timing every OpenXR call. By default the
+ * session is a Vulkan one that submits a projection layer, and optionally
+ * quad layers, every frame, so the client compositor, the multi compositor
+ * and the null compositor are all on the frame path. The clients never
+ * record any GPU work into the swapchain images.
+ *
+ * With zero layers the session is a headless one instead, which only covers
+ * the state tracker, the space overseer and the devices.
+ *
+ * Every client has its own instance and so its own null compositor, many
+ * clients sharing a single compositor needs the service and is not covered.
+ */
+
+#include "xrt/xrt_openxr_includes.h"
+
+#include "os/os_time.h"
+#include "os/os_threading.h"
+
+#include "util/u_misc.h"
+#include "util/u_time.h"
+
+#include "oxr/oxr_api_funcs.h"
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+#include <ctype.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+
+#define P(...) fprintf(stdout, __VA_ARGS__)
+#define PE(...) fprintf(stderr, __VA_ARGS__)
+
+#define MAX_CLIENTS 64
+#define MAX_ACTIONS 64
+#define MAX_SPACES 64
+#define MAX_LAYERS 16
+#define MAX_VIEWS 2
+#define MAX_QUEUE_FAMILIES 16
+
+#define QUAD_EXTENT 256
+
+
+/*
+ *
+ * Structs and defines.
+ *
+ */
+
+/*!
+ * The OpenXR calls that are timed, each gets its own set of samples.
+ */
+enum bench_call
+{
+	BENCH_CALL_WAIT_FRAME,
+	BENCH_CALL_BEGIN_FRAME,
+	BENCH_CALL_LOCATE_VIEWS,
+	BENCH_CALL_SYNC_ACTIONS,
+	BENCH_CALL_GET_ACTION_STATE,
+	BENCH_CALL_LOCATE_SPACE,
+	BENCH_CALL_END_FRAME,
+	BENCH_CALL_POLL_EVENT,
+	BENCH_CALL_SWAPCHAIN_IMAGE,
+	BENCH_CALL_FRAME,
+	BENCH_CALL_COUNT,
+};
+
+static const char *call_names[BENCH_CALL_COUNT] = {
+    "xrWaitFrame",   "xrBeginFrame",          "xrLocateViews",
+    "xrSyncActions", "xrGetActionStateFloat", "xrLocateSpace",
+    "xrEndFrame",    "xrPollEvent",           "xrAcquire/Wait/Release",
+    "whole frame",
+};
+
+struct bench_args
+{
+	uint32_t clients;
+	uint32_t frames;
+	uint32_t actions;
+	uint32_t spaces;
+	uint32_t layers;
+};
+
+struct bench_samples
+{
+	uint64_t *values_ns;
+	size_t count;
+	size_t capacity;
+};
+
+struct bench_client
+{
+	uint32_t index;
+	const struct bench_args *args;
+	struct os_thread thread;
+
+	XrInstance instance;
+	XrSystemId system_id;
+	XrSession session;
+	XrActionSet action_set;
+	XrAction actions[MAX_ACTIONS];
+	XrAction pose_action;
+	XrSpace local_space;
+	XrSpace spaces[MAX_SPACES];
+	XrPath hand_paths[2];
+
+	VkInstance vk_instance;
+	VkPhysicalDevice vk_physical_device;
+	VkDevice vk_device;
+	uint32_t vk_queue_family_index;
+
+	uint32_t view_count;
+	XrExtent2Di view_extents[MAX_VIEWS];
+	XrSwapchain view_swapchains[MAX_VIEWS];
+	XrSwapchain quad_swapchain;
+
+	struct bench_samples samples[BENCH_CALL_COUNT];
+
+	//! Thread CPU usage for the frame loop only.
+	struct rusage usage;
+	uint64_t loop_ns;
+
+	//! Syscalls made by the thread during the frame loop, if they could be counted.
+	uint64_t syscalls;
+	bool has_syscalls;
+	int syscalls_errno;
+
+	bool failed;
+};
+
+//! Setting up instances is done one at a time, only the frame loops overlap.
+static struct os_mutex setup_mutex;
+
+//! Id of the raw_syscalls:sys_enter tracepoint, negative if not found.
+static int syscall_tracepoint_id = -1;
+
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+#define CHECK_XR(CLIENT, CALL)                                                                                         \
+	do {                                                                                                           \
+		XrResult _ret = CALL;                                                                                  \
+		if (XR_FAILED(_ret)) {                                                                                 \
+			PE("client %u: %s failed: %i\n", (CLIENT)->index, #CALL, _ret);                                 \
+			(CLIENT)->failed = true;                                                                       \
+			return false;                                                                                  \
+		}                                                                                                      \
+	} while (false)
+
+#define CHECK_VK(CLIENT, RET, WHAT)                                                                                    \
+	do {                                                                                                           \
+		if ((RET) != VK_SUCCESS) {                                                                             \
+			PE("client %u: %s failed: %i\n", (CLIENT)->index, WHAT, (RET));                                 \
+			(CLIENT)->failed = true;                                                                       \
+			return false;                                                                                  \
+		}                                                                                                      \
+	} while (false)
+
+static void
+samples_init(struct bench_samples *s, size_t capacity)
+{
+	s->values_ns = U_TYPED_ARRAY_CALLOC(uint64_t, capacity);
+	s->capacity = capacity;
+	s->count = 0;
+}
+
+static inline void
+samples_add(struct bench_samples *s, uint64_t value_ns)
+{
+	if (s->count < s->capacity) {
+		s->values_ns[s->count++] = value_ns;
+	}
+}
+
+static void
+samples_fini(struct bench_samples *s)
+{
+	free(s->values_ns);
+	U_ZERO(s);
+}
+
+static int
+cmp_u64(const void *a, const void *b)
+{
+	uint64_t l = *(const uint64_t *)a;
+	uint64_t r = *(const uint64_t *)b;
+	return l < r ? -1 : (l > r ? 1 : 0);
+}
+
+//! Nearest rank percentile on sorted values.
+static uint64_t
+percentile(const uint64_t *sorted, size_t count, double p)
+{
+	if (count == 0) {
+		return 0;
+	}
+
+	size_t rank = (size_t)(p / 100.0 * (double)count + 0.5);
+	if (rank > 0) {
+		rank--;
+	}
+	if (rank >= count) {
+		rank = count - 1;
+	}
+
+	return sorted[rank];
+}
+
+static double
+timeval_to_ms(const struct timeval *tv)
+{
+	return (double)tv->tv_sec * 1000.0 + (double)tv->tv_usec / 1000.0;
+}
+
+
+/*
+ *
+ * Syscall counting.
+ *
+ */
+
+static int
+read_syscall_tracepoint_id(void)
+{
+	const char *paths[] = {
+	    "/sys/kernel/tracing/events/raw_syscalls/sys_enter/id",
+	    "/sys/kernel/debug/tracing/events/raw_syscalls/sys_enter/id",
+	};
+
+	for (size_t i = 0; i < ARRAY_SIZE(paths); i++) {
+		FILE *file = fopen(paths[i], "r");
+		if (file == NULL) {
+			continue;
+		}
+
+		int id = -1;
+		int count = fscanf(file, "%i", &id);
+		fclose(file);
+
+		if (count == 1 && id >= 0) {
+			return id;
+		}
+	}
+
+	return -1;
+}
+
+/*!
+ * Counts every syscall entry made by the calling thread, the kernel side of
+ * the tracepoint has to be included for it to fire at all.
+ */
+static int
+syscall_counter_open(struct bench_client *c)
+{
+	if (syscall_tracepoint_id < 0) {
+		c->syscalls_errno = ENOENT;
+		return -1;
+	}
+
+	struct perf_event_attr attr;
+	U_ZERO(&attr);
+	attr.type = PERF_TYPE_TRACEPOINT;
+	attr.size = sizeof(attr);
+	attr.config = (uint64_t)syscall_tracepoint_id;
+	attr.disabled = 1;
+	attr.exclude_hv = 1;
+
+	int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+	if (fd < 0) {
+		c->syscalls_errno = errno;
+	}
+
+	return fd;
+}
+
+static void
+syscall_counter_close(struct bench_client *c, int fd)
+{
+	if (fd < 0) {
+		return;
+	}
+
+	uint64_t count = 0;
+	if (ioctl(fd, PERF_EVENT_IOC_DISABLE, 0) == 0 && read(fd, &count, sizeof(count)) == sizeof(count)) {
+		c->syscalls = count;
+		c->has_syscalls = true;
+	} else {
+		c->syscalls_errno = errno;
+	}
+
+	close(fd);
+}
+
+
+
+/*
+ *
+ * Client setup.
+ *
+ */
+
+static bool
+client_create_instance(struct bench_client *c)
+{
+	// Without layers there is nothing to render, so no graphics API is needed.
+	const char *extensions[] = {
+	    c->args->layers == 0 ? XR_MND_HEADLESS_EXTENSION_NAME : XR_KHR_VULKAN_ENABLE2_EXTENSION_NAME,
+	};
+
+	XrInstanceCreateInfo create_info = {
+	    .type = XR_TYPE_INSTANCE_CREATE_INFO,
+	    .applicationInfo =
+	        {
+	            .applicationVersion = 1,
+	            .engineVersion = 1,
+	            .apiVersion = XR_API_VERSION_1_0,
+	        },
+	    .enabledExtensionCount = ARRAY_SIZE(extensions),
+	    .enabledExtensionNames = extensions,
+	};
+	snprintf(create_info.applicationInfo.applicationName, XR_MAX_APPLICATION_NAME_SIZE, "frame-bench-%u",
+	         c->index);
+	snprintf(create_info.applicationInfo.engineName, XR_MAX_ENGINE_NAME_SIZE, "frame-bench");
+
+	CHECK_XR(c, oxr_xrCreateInstance(&create_info, &c->instance));
+
+	XrSystemGetInfo system_info = {
+	    .type = XR_TYPE_SYSTEM_GET_INFO,
+	    .formFactor = XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY,
+	};
+	CHECK_XR(c, oxr_xrGetSystem(c->instance, &system_info, &c->system_id));
+
+	CHECK_XR(c, oxr_xrStringToPath(c->instance, "/user/hand/left", &c->hand_paths[0]));
+	CHECK_XR(c, oxr_xrStringToPath(c->instance, "/user/hand/right", &c->hand_paths[1]));
+
+	return true;
+}
+
+static bool
+client_create_actions(struct bench_client *c)
+{
+	XrActionSetCreateInfo set_info = {
+	    .type = XR_TYPE_ACTION_SET_CREATE_INFO,
+	    .actionSetName = "bench",
+	    .localizedActionSetName = "Bench",
+	};
+	CHECK_XR(c, oxr_xrCreateActionSet(c->instance, &set_info, &c->action_set));
+
+	XrActionSuggestedBinding bindings[MAX_ACTIONS * 2 + 2];
+	uint32_t binding_count = 0;
+
+	// All value actions bind to select and menu, many actions on one input.
+	for (uint32_t i = 0; i < c->args->actions; i++) {
+		XrActionCreateInfo info = {
+		    .type = XR_TYPE_ACTION_CREATE_INFO,
+		    .actionType = XR_ACTION_TYPE_FLOAT_INPUT,
+		    .countSubactionPaths = ARRAY_SIZE(c->hand_paths),
+		    .subactionPaths = c->hand_paths,
+		};
+		snprintf(info.actionName, XR_MAX_ACTION_NAME_SIZE, "value_%u", i);
+		snprintf(info.localizedActionName, XR_MAX_LOCALIZED_ACTION_NAME_SIZE, "Value %u", i);
+		CHECK_XR(c, oxr_xrCreateAction(c->action_set, &info, &c->actions[i]));
+
+		const char *input = (i % 2) == 0 ? "select/click" : "menu/click";
+		for (uint32_t h = 0; h < 2; h++) {
+			char str[XR_MAX_PATH_LENGTH];
+			snprintf(str, sizeof(str), "/user/hand/%s/input/%s", h == 0 ? "left" : "right", input);
+
+			bindings[binding_count].action = c->actions[i];
+			CHECK_XR(c, oxr_xrStringToPath(c->instance, str, &bindings[binding_count].binding));
+			binding_count++;
+		}
+	}
+
+	XrActionCreateInfo pose_info = {
+	    .type = XR_TYPE_ACTION_CREATE_INFO,
+	    .actionName = "pose",
+	    .localizedActionName = "Pose",
+	    .actionType = XR_ACTION_TYPE_POSE_INPUT,
+	    .countSubactionPaths = ARRAY_SIZE(c->hand_paths),
+	    .subactionPaths = c->hand_paths,
+	};
+	CHECK_XR(c, oxr_xrCreateAction(c->action_set, &pose_info, &c->pose_action));
+
+	for (uint32_t h = 0; h < 2; h++) {
+		const char *str = h == 0 ? "/user/hand/left/input/grip/pose" : "/user/hand/right/input/grip/pose";
+
+		bindings[binding_count].action = c->pose_action;
+		CHECK_XR(c, oxr_xrStringToPath(c->instance, str, &bindings[binding_count].binding));
+		binding_count++;
+	}
+
+	XrInteractionProfileSuggestedBinding suggested = {
+	    .type = XR_TYPE_INTERACTION_PROFILE_SUGGESTED_BINDING,
+	    .countSuggestedBindings = binding_count,
+	    .suggestedBindings = bindings,
+	};
+	CHECK_XR(c, oxr_xrStringToPath(c->instance, "/interaction_profiles/khr/simple_controller",
+	                               &suggested.interactionProfile));
+	CHECK_XR(c, oxr_xrSuggestInteractionProfileBindings(c->instance, &suggested));
+
+	return true;
+}
+
+static bool
+client_create_vulkan(struct bench_client *c)
+{
+	XrGraphicsRequirementsVulkan2KHR requirements = {.type = XR_TYPE_GRAPHICS_REQUIREMENTS_VULKAN2_KHR};
+	CHECK_XR(c, oxr_xrGetVulkanGraphicsRequirements2KHR(c->instance, c->system_id, &requirements));
+
+	XrVersion min_version = requirements.minApiVersionSupported;
+	VkApplicationInfo app_info = {
+	    .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+	    .pApplicationName = "frame-bench",
+	    .applicationVersion = 1,
+	    .pEngineName = "frame-bench",
+	    .engineVersion = 1,
+	    .apiVersion = VK_MAKE_API_VERSION(0, XR_VERSION_MAJOR(min_version), XR_VERSION_MINOR(min_version), 0),
+	};
+	VkInstanceCreateInfo instance_info = {
+	    .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+	    .pApplicationInfo = &app_info,
+	};
+	XrVulkanInstanceCreateInfoKHR xr_instance_info = {
+	    .type = XR_TYPE_VULKAN_INSTANCE_CREATE_INFO_KHR,
+	    .systemId = c->system_id,
+	    .pfnGetInstanceProcAddr = vkGetInstanceProcAddr,
+	    .vulkanCreateInfo = &instance_info,
+	};
+	VkResult vk_ret = VK_SUCCESS;
+	CHECK_XR(c, oxr_xrCreateVulkanInstanceKHR(c->instance, &xr_instance_info, &c->vk_instance, &vk_ret));
+	CHECK_VK(c, vk_ret, "vkCreateInstance");
+
+	XrVulkanGraphicsDeviceGetInfoKHR device_get_info = {
+	    .type = XR_TYPE_VULKAN_GRAPHICS_DEVICE_GET_INFO_KHR,
+	    .systemId = c->system_id,
+	    .vulkanInstance = c->vk_instance,
+	};
+	CHECK_XR(c, oxr_xrGetVulkanGraphicsDevice2KHR(c->instance, &device_get_info, &c->vk_physical_device));
+
+	VkQueueFamilyProperties families[MAX_QUEUE_FAMILIES];
+	uint32_t family_count = ARRAY_SIZE(families);
+	vkGetPhysicalDeviceQueueFamilyProperties(c->vk_physical_device, &family_count, families);
+
+	c->vk_queue_family_index = UINT32_MAX;
+	for (uint32_t i = 0; i < family_count; i++) {
+		if ((families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0) {
+			c->vk_queue_family_index = i;
+			break;
+		}
+	}
+	if (c->vk_queue_family_index == UINT32_MAX) {
+		PE("client %u: No graphics queue family found\n", c->index);
+		c->failed = true;
+		return false;
+	}
+
+	float priority = 0.0f;
+	VkDeviceQueueCreateInfo queue_info = {
+	    .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+	    .queueFamilyIndex = c->vk_queue_family_index,
+	    .queueCount = 1,
+	    .pQueuePriorities = &priority,
+	};
+	VkDeviceCreateInfo device_info = {
+	    .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+	    .queueCreateInfoCount = 1,
+	    .pQueueCreateInfos = &queue_info,
+	};
+	XrVulkanDeviceCreateInfoKHR xr_device_info = {
+	    .type = XR_TYPE_VULKAN_DEVICE_CREATE_INFO_KHR,
+	    .systemId = c->system_id,
+	    .pfnGetInstanceProcAddr = vkGetInstanceProcAddr,
+	    .vulkanPhysicalDevice = c->vk_physical_device,
+	    .vulkanCreateInfo = &device_info,
+	};
+	CHECK_XR(c, oxr_xrCreateVulkanDeviceKHR(c->instance, &xr_device_info, &c->vk_device, &vk_ret));
+	CHECK_VK(c, vk_ret, "vkCreateDevice");
+
+	return true;
+}
+
+static bool
+client_create_swapchain(struct bench_client *c, int64_t format, int32_t width, int32_t height, XrSwapchain *out)
+{
+	XrSwapchainCreateInfo info = {
+	    .type = XR_TYPE_SWAPCHAIN_CREATE_INFO,
+	    .usageFlags = XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT | XR_SWAPCHAIN_USAGE_SAMPLED_BIT,
+	    .format = format,
+	    .sampleCount = 1,
+	    .width = (uint32_t)width,
+	    .height = (uint32_t)height,
+	    .faceCount = 1,
+	    .arraySize = 1,
+	    .mipCount = 1,
+	};
+	CHECK_XR(c, oxr_xrCreateSwapchain(c->session, &info, out));
+
+	return true;
+}
+
+static bool
+client_create_swapchains(struct bench_client *c)
+{
+	XrViewConfigurationView views[MAX_VIEWS] = {
+	    {.type = XR_TYPE_VIEW_CONFIGURATION_VIEW},
+	    {.type = XR_TYPE_VIEW_CONFIGURATION_VIEW},
+	};
+	CHECK_XR(c, oxr_xrEnumerateViewConfigurationViews(c->instance, c->system_id,
+	                                                  XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO, ARRAY_SIZE(views),
+	                                                  &c->view_count, views));
+
+	uint32_t format_count = 0;
+	CHECK_XR(c, oxr_xrEnumerateSwapchainFormats(c->session, 0, &format_count, NULL));
+	if (format_count == 0) {
+		PE("client %u: No swapchain formats\n", c->index);
+		c->failed = true;
+		return false;
+	}
+
+	int64_t *formats = U_TYPED_ARRAY_CALLOC(int64_t, format_count);
+	XrResult ret = oxr_xrEnumerateSwapchainFormats(c->session, format_count, &format_count, formats);
+	// The first format is the one the runtime prefers.
+	int64_t format = formats[0];
+	free(formats);
+	CHECK_XR(c, ret);
+
+	for (uint32_t i = 0; i < c->view_count; i++) {
+		c->view_extents[i].width = (int32_t)views[i].recommendedImageRectWidth;
+		c->view_extents[i].height = (int32_t)views[i].recommendedImageRectHeight;
+
+		if (!client_create_swapchain(c, format, c->view_extents[i].width, c->view_extents[i].height,
+		                             &c->view_swapchains[i])) {
+			return false;
+		}
+	}
+
+	// All quads share one swapchain, like a HUD drawn once and placed many times.
+	if (c->args->layers > 1 && !client_create_swapchain(c, format, QUAD_EXTENT, QUAD_EXTENT, &c->quad_swapchain)) {
+		return false;
+	}
+
+	return true;
+}
+
+static bool
+client_create_session(struct bench_client *c)
+{
+	XrGraphicsBindingVulkan2KHR binding = {
+	    .type = XR_TYPE_GRAPHICS_BINDING_VULKAN2_KHR,
+	    .instance = c->vk_instance,
+	    .physicalDevice = c->vk_physical_device,
+	    .device = c->vk_device,
+	    .queueFamilyIndex = c->vk_queue_family_index,
+	    .queueIndex = 0,
+	};
+	XrSessionCreateInfo session_info = {
+	    .type = XR_TYPE_SESSION_CREATE_INFO,
+	    .next = c->args->layers > 0 ? &binding : NULL,
+	    .systemId = c->system_id,
+	};
+	CHECK_XR(c, oxr_xrCreateSession(c->instance, &session_info, &c->session));
+
+	if (c->args->layers > 0 && !client_create_swapchains(c)) {
+		return false;
+	}
+
+	XrSessionActionSetsAttachInfo attach_info = {
+	    .type = XR_TYPE_SESSION_ACTION_SETS_ATTACH_INFO,
+	    .countActionSets = 1,
+	    .actionSets = &c->action_set,
+	};
+	CHECK_XR(c, oxr_xrAttachSessionActionSets(c->session, &attach_info));
+
+	XrReferenceSpaceCreateInfo local_info = {
+	    .type = XR_TYPE_REFERENCE_SPACE_CREATE_INFO,
+	    .referenceSpaceType = XR_REFERENCE_SPACE_TYPE_LOCAL,
+	    .poseInReferenceSpace = {.orientation = {0, 0, 0, 1}},
+	};
+	CHECK_XR(c, oxr_xrCreateReferenceSpace(c->session, &local_info, &c->local_space));
+
+	// Alternate between the hands and the view space.
+	for (uint32_t i = 0; i < c->args->spaces; i++) {
+		if (i % 3 == 2) {
+			XrReferenceSpaceCreateInfo info = {
+			    .type = XR_TYPE_REFERENCE_SPACE_CREATE_INFO,
+			    .referenceSpaceType = XR_REFERENCE_SPACE_TYPE_VIEW,
+			    .poseInReferenceSpace = {.orientation = {0, 0, 0, 1}},
+			};
+			CHECK_XR(c, oxr_xrCreateReferenceSpace(c->session, &info, &c->spaces[i]));
+		} else {
+			XrActionSpaceCreateInfo info = {
+			    .type = XR_TYPE_ACTION_SPACE_CREATE_INFO,
+			    .action = c->pose_action,
+			    .subactionPath = c->hand_paths[i % 3],
+			    .poseInActionSpace = {.orientation = {0, 0, 0, 1}},
+			};
+			CHECK_XR(c, oxr_xrCreateActionSpace(c->session, &info, &c->spaces[i]));
+		}
+	}
+
+	return true;
+}
+
+static bool
+client_wait_for_state(struct bench_client *c, XrSessionState state)
+{
+	for (uint32_t tries = 0; tries < 1000; tries++) {
+		XrEventDataBuffer event = {.type = XR_TYPE_EVENT_DATA_BUFFER};
+		XrResult ret = oxr_xrPollEvent(c->instance, &event);
+		if (ret == XR_EVENT_UNAVAILABLE) {
+			os_nanosleep(U_TIME_1MS_IN_NS);
+			continue;
+		}
+		CHECK_XR(c, ret);
+
+		if (event.type == XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED &&
+		    ((XrEventDataSessionStateChanged *)&event)->state == state) {
+			return true;
+		}
+	}
+
+	PE("client %u: Timed out waiting for session state %i\n", c->index, state);
+	c->failed = true;
+	return false;
+}
+
+static bool
+client_setup(struct bench_client *c)
+{
+	if (!client_create_instance(c) || !client_create_actions(c)) {
+		return false;
+	}
+
+	if (c->args->layers > 0 && !client_create_vulkan(c)) {
+		return false;
+	}
+
+	if (!client_create_session(c) || !client_wait_for_state(c, XR_SESSION_STATE_READY)) {
+		return false;
+	}
+
+	// Headless sessions ignore the view configuration type.
+	XrSessionBeginInfo begin_info = {
+	    .type = XR_TYPE_SESSION_BEGIN_INFO,
+	    .primaryViewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO,
+	};
+	CHECK_XR(c, oxr_xrBeginSession(c->session, &begin_info));
+
+	return true;
+}
+
+static void
+client_teardown(struct bench_client *c)
+{
+	if (c->instance != XR_NULL_HANDLE) {
+		// Destroys all child handles, the session has to go before the device.
+		oxr_xrDestroyInstance(c->instance);
+		c->instance = XR_NULL_HANDLE;
+	}
+
+	if (c->vk_device != VK_NULL_HANDLE) {
+		vkDestroyDevice(c->vk_device, NULL);
+		c->vk_device = VK_NULL_HANDLE;
+	}
+
+	if (c->vk_instance != VK_NULL_HANDLE) {
+		vkDestroyInstance(c->vk_instance, NULL);
+		c->vk_instance = VK_NULL_HANDLE;
+	}
+}
+
+
+/*
+ *
+ * Frame loop.
+ *
+ */
+
+#define TIME_CALL(CLIENT, KIND, CALL)                                                                                  \
+	do {                                                                                                           \
+		uint64_t _then_ns = os_monotonic_get_ns();                                                             \
+		XrResult _ret = CALL;                                                                                  \
+		samples_add(&(CLIENT)->samples[KIND], os_monotonic_get_ns() - _then_ns);                               \
+		if (XR_FAILED(_ret)) {                                                                                 \
+			PE("client %u: %s failed: %i\n", (CLIENT)->index, #CALL, _ret);                                 \
+			(CLIENT)->failed = true;                                                                       \
+			return false;                                                                                  \
+		}                                                                                                      \
+	} while (false)
+
+//! The clients don't render, the images only go through the motions.
+static bool
+client_cycle_swapchain(struct bench_client *c, XrSwapchain swapchain)
+{
+	uint64_t then_ns = os_monotonic_get_ns();
+
+	uint32_t index = 0;
+	XrSwapchainImageAcquireInfo acquire_info = {.type = XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO};
+	CHECK_XR(c, oxr_xrAcquireSwapchainImage(swapchain, &acquire_info, &index));
+
+	XrSwapchainImageWaitInfo wait_info = {
+	    .type = XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO,
+	    .timeout = XR_INFINITE_DURATION,
+	};
+	CHECK_XR(c, oxr_xrWaitSwapchainImage(swapchain, &wait_info));
+
+	XrSwapchainImageReleaseInfo release_info = {.type = XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO};
+	CHECK_XR(c, oxr_xrReleaseSwapchainImage(swapchain, &release_info));
+
+	samples_add(&c->samples[BENCH_CALL_SWAPCHAIN_IMAGE], os_monotonic_get_ns() - then_ns);
+
+	return true;
+}
+
+static bool
+client_frame(struct bench_client *c)
+{
+	uint64_t frame_start_ns = os_monotonic_get_ns();
+
+	// Drain the event queue like a normal application would.
+	XrResult ret;
+	do {
+		XrEventDataBuffer event = {.type = XR_TYPE_EVENT_DATA_BUFFER};
+		uint64_t then_ns = os_monotonic_get_ns();
+		ret = oxr_xrPollEvent(c->instance, &event);
+		samples_add(&c->samples[BENCH_CALL_POLL_EVENT], os_monotonic_get_ns() - then_ns);
+	} while (ret == XR_SUCCESS);
+
+	XrFrameWaitInfo wait_info = {.type = XR_TYPE_FRAME_WAIT_INFO};
+	XrFrameState frame_state = {.type = XR_TYPE_FRAME_STATE};
+	TIME_CALL(c, BENCH_CALL_WAIT_FRAME, oxr_xrWaitFrame(c->session, &wait_info, &frame_state));
+
+	XrFrameBeginInfo begin_info = {.type = XR_TYPE_FRAME_BEGIN_INFO};
+	TIME_CALL(c, BENCH_CALL_BEGIN_FRAME, oxr_xrBeginFrame(c->session, &begin_info));
+
+	// Headless sessions predict the display time to be now, the null compositor paces like a display.
+	XrTime time = frame_state.predictedDisplayTime;
+
+	XrViewLocateInfo locate_info = {
+	    .type = XR_TYPE_VIEW_LOCATE_INFO,
+	    .viewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO,
+	    .displayTime = time,
+	    .space = c->local_space,
+	};
+	XrViewState view_state = {.type = XR_TYPE_VIEW_STATE};
+	XrView views[MAX_VIEWS] = {{.type = XR_TYPE_VIEW}, {.type = XR_TYPE_VIEW}};
+	uint32_t view_count = 0;
+	TIME_CALL(c, BENCH_CALL_LOCATE_VIEWS,
+	          oxr_xrLocateViews(c->session, &locate_info, &view_state, ARRAY_SIZE(views), &view_count, views));
+
+	XrActiveActionSet active_set = {.actionSet = c->action_set};
+	XrActionsSyncInfo sync_info = {
+	    .type = XR_TYPE_ACTIONS_SYNC_INFO,
+	    .countActiveActionSets = 1,
+	    .activeActionSets = &active_set,
+	};
+	TIME_CALL(c, BENCH_CALL_SYNC_ACTIONS, oxr_xrSyncActions(c->session, &sync_info));
+
+	for (uint32_t i = 0; i < c->args->actions; i++) {
+		XrActionStateGetInfo get_info = {
+		    .type = XR_TYPE_ACTION_STATE_GET_INFO,
+		    .action = c->actions[i],
+		};
+		XrActionStateFloat state = {.type = XR_TYPE_ACTION_STATE_FLOAT};
+		TIME_CALL(c, BENCH_CALL_GET_ACTION_STATE, oxr_xrGetActionStateFloat(c->session, &get_info, &state));
+	}
+
+	for (uint32_t i = 0; i < c->args->spaces; i++) {
+		XrSpaceLocation location = {.type = XR_TYPE_SPACE_LOCATION};
+		TIME_CALL(c, BENCH_CALL_LOCATE_SPACE, oxr_xrLocateSpace(c->spaces[i], c->local_space, time, &location));
+	}
+
+	XrCompositionLayerProjectionView projection_views[MAX_VIEWS];
+	XrCompositionLayerProjection projection;
+	XrCompositionLayerQuad quads[MAX_LAYERS];
+	const XrCompositionLayerBaseHeader *layers[MAX_LAYERS];
+	uint32_t layer_count = 0;
+
+	if (c->args->layers > 0 && frame_state.shouldRender) {
+		if (view_count > c->view_count) {
+			view_count = c->view_count;
+		}
+		for (uint32_t i = 0; i < view_count; i++) {
+			if (!client_cycle_swapchain(c, c->view_swapchains[i])) {
+				return false;
+			}
+
+			projection_views[i] = (XrCompositionLayerProjectionView){
+			    .type = XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW,
+			    .pose = views[i].pose,
+			    .fov = views[i].fov,
+			    .subImage =
+			        {
+			            .swapchain = c->view_swapchains[i],
+			            .imageRect = {.extent = c->view_extents[i]},
+			        },
+			};
+		}
+
+		projection = (XrCompositionLayerProjection){
+		    .type = XR_TYPE_COMPOSITION_LAYER_PROJECTION,
+		    .space = c->local_space,
+		    .viewCount = view_count,
+		    .views = projection_views,
+		};
+		layers[layer_count++] = (const XrCompositionLayerBaseHeader *)&projection;
+
+		if (c->args->layers > 1 && !client_cycle_swapchain(c, c->quad_swapchain)) {
+			return false;
+		}
+
+		// Stack the quads in front of the viewer, all from the same image.
+		for (uint32_t i = 0; i + 1 < c->args->layers; i++) {
+			quads[i] = (XrCompositionLayerQuad){
+			    .type = XR_TYPE_COMPOSITION_LAYER_QUAD,
+			    .layerFlags = XR_COMPOSITION_LAYER_BLEND_TEXTURE_SOURCE_ALPHA_BIT,
+			    .space = c->local_space,
+			    .eyeVisibility = XR_EYE_VISIBILITY_BOTH,
+			    .subImage =
+			        {
+			            .swapchain = c->quad_swapchain,
+			            .imageRect = {.extent = {QUAD_EXTENT, QUAD_EXTENT}},
+			        },
+			    .pose =
+			        {
+			            .orientation = {0, 0, 0, 1},
+			            .position = {0, 0, -1.0f - 0.1f * (float)i},
+			        },
+			    .size = {0.5f, 0.5f},
+			};
+			layers[layer_count++] = (const XrCompositionLayerBaseHeader *)&quads[i];
+		}
+	}
+
+	XrFrameEndInfo end_info = {
+	    .type = XR_TYPE_FRAME_END_INFO,
+	    .displayTime = time,
+	    .environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE,
+	    .layerCount = layer_count,
+	    .layers = layers,
+	};
+	TIME_CALL(c, BENCH_CALL_END_FRAME, oxr_xrEndFrame(c->session, &end_info));
+
+	samples_add(&c->samples[BENCH_CALL_FRAME], os_monotonic_get_ns() - frame_start_ns);
+
+	return true;
+}
+
+static void *
+client_run(void *ptr)
+{
+	struct bench_client *c = (struct bench_client *)ptr;
+
+	os_mutex_lock(&setup_mutex);
+	bool ok = client_setup(c);
+	os_mutex_unlock(&setup_mutex);
+
+	if (ok) {
+		int syscall_fd = syscall_counter_open(c);
+
+		struct rusage before, after;
+		getrusage(RUSAGE_THREAD, &before);
+		uint64_t then_ns = os_monotonic_get_ns();
+		if (syscall_fd >= 0) {
+			ioctl(syscall_fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+
+		for (uint32_t i = 0; i < c->args->frames && client_frame(c); i++) {
+		}
+
+		syscall_counter_close(c, syscall_fd);
+		c->loop_ns = os_monotonic_get_ns() - then_ns;
+		getrusage(RUSAGE_THREAD, &after);
+
+		timersub(&after.ru_utime, &before.ru_utime, &c->usage.ru_utime);
+		timersub(&after.ru_stime, &before.ru_stime, &c->usage.ru_stime);
+		c->usage.ru_nvcsw = after.ru_nvcsw - before.ru_nvcsw;
+		c->usage.ru_nivcsw = after.ru_nivcsw - before.ru_nivcsw;
+	}
+
+	os_mutex_lock(&setup_mutex);
+	client_teardown(c);
+	os_mutex_unlock(&setup_mutex);
+
+	return NULL;
+}
+
+
+/*
+ *
+ * Reporting.
+ *
+ */
+
+static void
+print_report(struct bench_client *clients, const struct bench_args *args)
+{
+	uint32_t frames = 0;
+	double user_ms = 0;
+	double sys_ms = 0;
+	long vcsw = 0;
+	long ivcsw = 0;
+	uint64_t syscalls = 0;
+	bool has_syscalls = true;
+	int syscalls_errno = 0;
+
+	P("\n%-10s %10s %10s %10s %10s %10s %8s %8s\n", "client", "frames", "wall ms", "user ms", "sys ms", "syscalls",
+	  "vcsw", "ivcsw");
+	for (uint32_t i = 0; i < args->clients; i++) {
+		struct bench_client *c = &clients[i];
+		uint32_t f = (uint32_t)c->samples[BENCH_CALL_FRAME].count;
+
+		char syscalls_str[32] = "n/a";
+		if (c->has_syscalls) {
+			snprintf(syscalls_str, sizeof(syscalls_str), "%" PRIu64, c->syscalls);
+		}
+
+		P("%-10u %10u %10.2f %10.2f %10.2f %10s %8ld %8ld\n", i, f, (double)c->loop_ns / 1e6,
+		  timeval_to_ms(&c->usage.ru_utime), timeval_to_ms(&c->usage.ru_stime), syscalls_str, c->usage.ru_nvcsw,
+		  c->usage.ru_nivcsw);
+
+		frames += f;
+		user_ms += timeval_to_ms(&c->usage.ru_utime);
+		sys_ms += timeval_to_ms(&c->usage.ru_stime);
+		vcsw += c->usage.ru_nvcsw;
+		ivcsw += c->usage.ru_nivcsw;
+		syscalls += c->syscalls;
+		has_syscalls = has_syscalls && c->has_syscalls;
+		if (!c->has_syscalls) {
+			syscalls_errno = c->syscalls_errno;
+		}
+	}
+
+	if (frames > 0) {
+		P("\nPer frame: %.2fus user, %.2fus sys, %.3f voluntary and %.3f involuntary context switches\n",
+		  user_ms * 1000.0 / frames, sys_ms * 1000.0 / frames, (double)vcsw / frames, (double)ivcsw / frames);
+
+		// Only the client threads are counted, not the compositor threads working for them.
+		if (has_syscalls) {
+			P("Per frame: %.2f syscalls made by the client thread\n", (double)syscalls / frames);
+		} else {
+			P("Per frame: syscalls not counted, perf raw_syscalls:sys_enter tracepoint unavailable (%s)\n",
+			  strerror(syscalls_errno));
+		}
+	}
+
+	P("\n%-24s %10s %10s %10s %10s %10s\n", "call", "count", "mean us", "p50 us", "p99 us", "max us");
+	for (uint32_t k = 0; k < BENCH_CALL_COUNT; k++) {
+		size_t total = 0;
+		for (uint32_t i = 0; i < args->clients; i++) {
+			total += clients[i].samples[k].count;
+		}
+		if (total == 0) {
+			continue;
+		}
+
+		// Merge all clients, the distribution is what matters.
+		uint64_t *all = U_TYPED_ARRAY_CALLOC(uint64_t, total);
+		size_t pos = 0;
+		double sum = 0;
+		for (uint32_t i = 0; i < args->clients; i++) {
+			const struct bench_samples *s = &clients[i].samples[k];
+			memcpy(all + pos, s->values_ns, s->count * sizeof(uint64_t));
+			pos += s->count;
+		}
+		qsort(all, total, sizeof(uint64_t), cmp_u64);
+		for (size_t i = 0; i < total; i++) {
+			sum += (double)all[i];
+		}
+
+		P("%-24s %10zu %10.2f %10.2f %10.2f %10.2f\n", call_names[k], total, sum / (double)total / 1e3,
+		  (double)percentile(all, total, 50) / 1e3, (double)percentile(all, total, 99) / 1e3,
+		  (double)all[total - 1] / 1e3);
+
+		free(all);
+	}
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+static void
+print_usage(void)
+{
+	PE("Usage: frame-bench [-c clients] [-f frames] [-a actions] [-s spaces] [-l layers]\n");
+	PE("    -c <n>: Number of concurrent clients, default 1, max %u\n", MAX_CLIENTS);
+	PE("    -f <n>: Frames to run per client, default 1000\n");
+	PE("    -a <n>: Float actions queried per frame, default 4, max %u\n", MAX_ACTIONS);
+	PE("    -s <n>: Spaces located per frame, default 4, max %u\n", MAX_SPACES);
+	PE("    -l <n>: Layers submitted per frame, a projection layer and n - 1 quads, default 1, max %u\n"
+	   "            0 uses a headless session that never touches the compositor\n",
+	   MAX_LAYERS);
+	PE("\n");
+	PE("Counting syscalls needs a mounted tracefs and perf access to its tracepoints, usually root.\n");
+}
+
+int
+main(int argc, char *argv[])
+{
+	struct bench_args args = {
+	    .clients = 1,
+	    .frames = 1000,
+	    .actions = 4,
+	    .spaces = 4,
+	    .layers = 1,
+	};
+
+	int c;
+	opterr = 0;
+	while ((c = getopt(argc, argv, "c:f:a:s:l:h")) != -1) {
+		switch (c) {
+		case 'c': args.clients = (uint32_t)atoi(optarg); break;
+		case 'f': args.frames = (uint32_t)atoi(optarg); break;
+		case 'a': args.actions = (uint32_t)atoi(optarg); break;
+		case 's': args.spaces = (uint32_t)atoi(optarg); break;
+		case 'l': args.layers = (uint32_t)atoi(optarg); break;
+		case 'h': print_usage(); return 0;
+		case '?':
+			if (isprint(optopt)) {
+				PE("Option `-%c' unknown or missing argument.\n", optopt);
+			} else {
+				PE("Option `\\x%x' unknown.\n", optopt);
+			}
+			print_usage();
+			return 1;
+		default: return 1;
+		}
+	}
+
+	if (args.clients == 0 || args.clients > MAX_CLIENTS || args.actions > MAX_ACTIONS ||
+	    args.spaces > MAX_SPACES || args.layers > MAX_LAYERS) {
+		print_usage();
+		return 1;
+	}
+
+	// Don't override what the user asked for, but default to no hardware at a headset like rate.
+	setenv("XRT_COMPOSITOR_NULL", "true", 0);
+	setenv("XRT_COMPOSITOR_NULL_FRAME_RATE", "90", 0);
+	setenv("SIMULATED_ENABLE", "true", 0);
+
+	syscall_tracepoint_id = read_syscall_tracepoint_id();
+
+	P("Running %u client(s), %u frames, %u actions, %u spaces, %u layers%s\n", args.clients, args.frames,
+	  args.actions, args.spaces, args.layers, args.layers == 0 ? " (headless)" : "");
+
+	struct bench_client *clients = U_TYPED_ARRAY_CALLOC(struct bench_client, args.clients);
+	os_mutex_init(&setup_mutex);
+
+	for (uint32_t i = 0; i < args.clients; i++) {
+		struct bench_client *cl = &clients[i];
+		cl->index = i;
+		cl->args = &args;
+
+		samples_init(&cl->samples[BENCH_CALL_WAIT_FRAME], args.frames);
+		samples_init(&cl->samples[BENCH_CALL_BEGIN_FRAME], args.frames);
+		samples_init(&cl->samples[BENCH_CALL_LOCATE_VIEWS], args.frames);
+		samples_init(&cl->samples[BENCH_CALL_SYNC_ACTIONS], args.frames);
+		samples_init(&cl->samples[BENCH_CALL_GET_ACTION_STATE], (size_t)args.frames * args.actions);
+		samples_init(&cl->samples[BENCH_CALL_LOCATE_SPACE], (size_t)args.frames * args.spaces);
+		samples_init(&cl->samples[BENCH_CALL_END_FRAME], args.frames);
+		samples_init(&cl->samples[BENCH_CALL_POLL_EVENT], (size_t)args.frames * 2);
+		samples_init(&cl->samples[BENCH_CALL_SWAPCHAIN_IMAGE], (size_t)args.frames * (MAX_VIEWS + 1));
+		samples_init(&cl->samples[BENCH_CALL_FRAME], args.frames);
+
+		os_thread_init(&cl->thread);
+		os_thread_start(&cl->thread, client_run, cl);
+	}
+
+	int ret = 0;
+	for (uint32_t i = 0; i < args.clients; i++) {
+		os_thread_join(&clients[i].thread);
+		os_thread_destroy(&clients[i].thread);
+		if (clients[i].failed) {
+			ret = 1;
+		}
+	}
+
+	print_report(clients, &args);
+
+	for (uint32_t i = 0; i < args.clients; i++) {
+		for (uint32_t k = 0; k < BENCH_CALL_COUNT; k++) {
+			samples_fini(&clients[i].samples[k]);
+		}
+	}
+	free(clients);
+	os_mutex_destroy(&setup_mutex);
+
+	return ret;
+}
@@ -6,9 +6,36 @@
 # Author: Korcan Hussein <korcan.hussein@collabora.com>
 
 import argparse
+import time
 from monado import Monado, MonadoLibraryNotFoundError, MonadoHeaderNotFoundError
 
 
+def print_telemetry(m, seconds):
+    # Only the first update makes a call to the service, after that it's just shared memory reads.
+    for _ in range(seconds):
+        m.update_clients()
+        m.update_telemetry()
+
+        print(f"Compositor GPU: {m.get_compositor_gpu_time_ms():.2f}ms")
+        for x in range(m.client_count):
+            ident = m.get_client_id_at_index(x)
+            try:
+                f = m.get_client_frame_stats(ident)
+                calls = m.get_client_ipc_call_stats(ident)
+            except Exception:
+                # Client connected or disconnected between the updates.
+                continue
+
+            print(f"\tid: {ident:4d}, fps: {f.frame_rate_hz:6.2f}, delivered: {f.delivered}, "
+                  f"missed: {f.missed}, discarded: {f.discarded}, cpu: {f.app_cpu_ms:.2f}ms, "
+                  f"draw: {f.app_draw_ms:.2f}ms, gpu: {f.app_gpu_ms:.2f}ms, "
+                  f"latch-to-display: {f.latch_to_display_ms:.2f}ms")
+            for c in calls:
+                print(f"\t\t{c.name}: calls: {c.count}, total: {c.total_ms:.2f}ms, max: {c.max_ms:.2f}ms")
+
+        time.sleep(1)
+
+
 def main():
     parser = argparse.ArgumentParser(description='libmonado Python example.')
     parser.add_argument("-f", "--focused", type=int, metavar='CLIENT_ID',
@@ -17,6 +44,8 @@ def main():
                         help="Set primary client")
     parser.add_argument("-i", "--input", type=int, metavar='CLIENT_ID',
                         help="Toggle whether client receives input")
+    parser.add_argument("-t", "--telemetry", type=int, metavar='SECONDS',
+                        help="Print client telemetry once a second for this many seconds")
     args = parser.parse_args()
 
     try:
@@ -58,6 +87,9 @@ def main():
     for role_name, dev_id in roles_map.items():
         print(f"\trole: {role_name},\tdevice-index: {dev_id:4d}")
 
+    if args.telemetry:
+        print_telemetry(m, args.telemetry)
+
     m.destroy()
 
 
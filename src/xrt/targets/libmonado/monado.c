@@ -18,6 +18,8 @@
 #include "util/u_logging.h"
 
 #include "shared/ipc_protocol.h"
+#include "shared/ipc_shmem.h"
+#include "shared/ipc_telemetry.h"
 
 #include "client/ipc_client_connection.h"
 #include "client/ipc_client.h"
@@ -37,6 +39,17 @@ struct mnd_root
 
 	/// State of most recent app asked about
 	struct ipc_app_state app_state;
+
+	//! Read only telemetry page, mapped on first update.
+	const struct ipc_telemetry *telemetry;
+	xrt_shmem_handle_t telemetry_handle;
+
+	//! Copy of the telemetry from the last update.
+	struct
+	{
+		int64_t compositor_gpu_time_ns;
+		struct ipc_telemetry_client clients[IPC_MAX_CLIENTS];
+	} telemetry_copy;
 };
 
 #define P(...) fprintf(stdout, __VA_ARGS__)
@@ -98,6 +111,54 @@ get_client_info(mnd_root_t *root, uint32_t client_id)
 	return MND_SUCCESS;
 }
 
+static mnd_result_t
+map_telemetry(mnd_root_t *root)
+{
+	xrt_shmem_handle_t handle;
+	xrt_result_t xret = ipc_call_system_get_telemetry_shm_fd(&root->ipc_c, &handle, 1);
+	if (xret != XRT_SUCCESS) {
+		PE("Failed to get telemetry shm handle!\n");
+		return MND_ERROR_OPERATION_FAILED;
+	}
+
+	const size_t size = sizeof(struct ipc_telemetry);
+	const void *map = NULL;
+	xret = ipc_shmem_map_read_only(handle, size, &map);
+	if (xret != XRT_SUCCESS) {
+		PE("Failed to map telemetry shm!\n");
+		ipc_shmem_destroy(&handle, NULL, 0);
+		return MND_ERROR_OPERATION_FAILED;
+	}
+
+	root->telemetry = map;
+	root->telemetry_handle = handle;
+
+	// Same git tag is checked on connect, but the layout must really match.
+	if (root->telemetry->version != IPC_TELEMETRY_VERSION ||
+	    root->telemetry->command_count != IPC_COMMAND_COUNT) {
+		PE("Telemetry layout mismatch!\n");
+		ipc_shmem_destroy(&root->telemetry_handle, (void **)&root->telemetry, size);
+		return MND_ERROR_OPERATION_FAILED;
+	}
+
+	return MND_SUCCESS;
+}
+
+static const struct ipc_telemetry_client *
+find_telemetry_client(mnd_root_t *root, uint32_t client_id)
+{
+	for (uint32_t i = 0; i < IPC_MAX_CLIENTS; i++) {
+		const struct ipc_telemetry_client *tc = &root->telemetry_copy.clients[i];
+		if (tc->active && tc->id == client_id) {
+			return tc;
+		}
+	}
+
+	PE("No telemetry for client id: %u.\n", client_id);
+
+	return NULL;
+}
+
 
 /*
  *
@@ -154,6 +215,10 @@ mnd_root_destroy(mnd_root_t **root_ptr)
 		return;
 	}
 
+	if (r->telemetry != NULL) {
+		ipc_shmem_destroy(&r->telemetry_handle, (void **)&r->telemetry, sizeof(struct ipc_telemetry));
+	}
+
 	ipc_client_connection_fini(&r->ipc_c);
 	free(r);
 
@@ -586,3 +651,135 @@ mnd_root_get_device_battery_status(
 	default: PE("Internal error, shouldn't get here"); return MND_ERROR_OPERATION_FAILED;
 	}
 }
+
+mnd_result_t
+mnd_root_update_telemetry(mnd_root_t *root)
+{
+	CHECK_NOT_NULL(root);
+
+	if (root->telemetry == NULL) {
+		mnd_result_t ret = map_telemetry(root);
+		if (ret != MND_SUCCESS) {
+			return ret;
+		}
+	}
+
+	root->telemetry_copy.compositor_gpu_time_ns = root->telemetry->compositor_gpu_time_ns;
+
+	for (uint32_t i = 0; i < IPC_MAX_CLIENTS; i++) {
+		struct ipc_telemetry_client *tc = &root->telemetry_copy.clients[i];
+		if (!ipc_telemetry_client_read(&root->telemetry->clients[i], tc)) {
+			// Being written to constantly, skip it for this update.
+			tc->active = 0;
+		}
+	}
+
+	return MND_SUCCESS;
+}
+
+mnd_result_t
+mnd_root_get_client_frame_stats(mnd_root_t *root, uint32_t client_id, mnd_client_frame_stats_t *out_stats)
+{
+	CHECK_NOT_NULL(root);
+	CHECK_NOT_NULL(out_stats);
+	CHECK_CLIENT_ID(client_id);
+
+	const struct ipc_telemetry_client *tc = find_telemetry_client(root, client_id);
+	if (tc == NULL) {
+		return MND_ERROR_INVALID_VALUE;
+	}
+
+	const struct xrt_compositor_frame_stats *frame = &tc->frame;
+
+	float frame_rate_hz = 0.0f;
+	if (frame->frame_period_ns > 0) {
+		frame_rate_hz = (float)(1000000000.0 / (double)frame->frame_period_ns);
+	}
+
+	*out_stats = (mnd_client_frame_stats_t){
+	    .delivered_count = frame->delivered_count,
+	    .discarded_count = frame->discarded_count,
+	    .missed_count = frame->missed_count,
+	    .frame_rate_hz = frame_rate_hz,
+	    .app_cpu_time_ns = frame->cpu_time_ns,
+	    .app_draw_time_ns = frame->draw_time_ns,
+	    .app_gpu_time_ns = frame->gpu_time_ns,
+	    .latch_to_display_ns = frame->latch_to_display_ns,
+	};
+
+	return MND_SUCCESS;
+}
+
+mnd_result_t
+mnd_root_get_ipc_command_count(mnd_root_t *root, uint32_t *out_count)
+{
+	CHECK_NOT_NULL(root);
+	CHECK_NOT_NULL(out_count);
+
+	*out_count = IPC_COMMAND_COUNT;
+
+	return MND_SUCCESS;
+}
+
+mnd_result_t
+mnd_root_get_ipc_command_name(mnd_root_t *root, uint32_t command, const char **out_name)
+{
+	CHECK_NOT_NULL(root);
+	CHECK_NOT_NULL(out_name);
+
+	if (command >= IPC_COMMAND_COUNT) {
+		PE("Invalid command index (%u)", command);
+		return MND_ERROR_INVALID_VALUE;
+	}
+
+	*out_name = ipc_cmd_to_str((ipc_command_t)command);
+
+	return MND_SUCCESS;
+}
+
+mnd_result_t
+mnd_root_get_client_ipc_call_stats(mnd_root_t *root,
+                                   uint32_t client_id,
+                                   uint32_t command,
+                                   uint64_t *out_count,
+                                   uint64_t *out_total_ns,
+                                   uint64_t *out_max_ns)
+{
+	CHECK_NOT_NULL(root);
+	CHECK_NOT_NULL(out_count);
+	CHECK_NOT_NULL(out_total_ns);
+	CHECK_NOT_NULL(out_max_ns);
+	CHECK_CLIENT_ID(client_id);
+
+	if (command >= IPC_COMMAND_COUNT) {
+		PE("Invalid command index (%u)", command);
+		return MND_ERROR_INVALID_VALUE;
+	}
+
+	const struct ipc_telemetry_client *tc = find_telemetry_client(root, client_id);
+	if (tc == NULL) {
+		return MND_ERROR_INVALID_VALUE;
+	}
+
+	*out_count = tc->commands[command].count;
+	*out_total_ns = tc->commands[command].total_ns;
+	*out_max_ns = tc->commands[command].max_ns;
+
+	return MND_SUCCESS;
+}
+
+mnd_result_t
+mnd_root_get_compositor_gpu_time(mnd_root_t *root, int64_t *out_gpu_time_ns)
+{
+	CHECK_NOT_NULL(root);
+	CHECK_NOT_NULL(out_gpu_time_ns);
+
+	if (root->telemetry == NULL) {
+		PE("Telemetry not updated!");
+		return MND_ERROR_OPERATION_FAILED;
+	}
+
+	*out_gpu_time_ns = root->telemetry_copy.compositor_gpu_time_ns;
+
+	return MND_SUCCESS;
+}
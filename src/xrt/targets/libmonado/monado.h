@@ -25,7 +25,7 @@ extern "C" {
 //! Major version of the API.
 #define MND_API_VERSION_MAJOR 1
 //! Minor version of the API.
-#define MND_API_VERSION_MINOR 4
+#define MND_API_VERSION_MINOR 5
 //! Patch version of the API.
 #define MND_API_VERSION_PATCH 0
 
@@ -112,6 +112,31 @@ typedef enum mnd_reference_space_type
 	MND_SPACE_REFERENCE_TYPE_UNBOUNDED,
 } mnd_reference_space_type_t;
 
+/*!
+ * Frame timing statistics of a client, see @ref mnd_root_get_client_frame_stats.
+ *
+ * Supported in version 1.5 and above.
+ */
+typedef struct mnd_client_frame_stats
+{
+	//! Frames delivered with their GPU work completed.
+	uint64_t delivered_count;
+	//! Frames discarded by the client.
+	uint64_t discarded_count;
+	//! Delivered frames that completed after their display time.
+	uint64_t missed_count;
+	//! Filtered rate of delivered frames, zero if unknown.
+	float frame_rate_hz;
+	//! Filtered time between the app waking up from wait frame and beginning the frame.
+	int64_t app_cpu_time_ns;
+	//! Filtered time between the app beginning and delivering the frame.
+	int64_t app_draw_time_ns;
+	//! Filtered time between the frame being delivered and the app's GPU work completing.
+	int64_t app_gpu_time_ns;
+	//! Filtered time between the compositor latching a frame and its display time.
+	int64_t latch_to_display_ns;
+} mnd_client_frame_stats_t;
+
 /*
  *
  * Functions
@@ -481,6 +506,108 @@ mnd_result_t
 mnd_root_get_device_battery_status(
     mnd_root_t *root, uint32_t device_index, bool *out_present, bool *out_charging, float *out_charge);
 
+/*!
+ * Update our local cached copy of the telemetry, this does not make any calls
+ * to the service except for the first time when the telemetry shared memory
+ * is mapped, so it is cheap enough to be polled.
+ *
+ * Supported in version 1.5 and above.
+ *
+ * @param root The libVRuska Engine state.
+ *
+ * @return MND_SUCCESS on success
+ */
+mnd_result_t
+mnd_root_update_telemetry(mnd_root_t *root);
+
+/*!
+ * Get the frame timing statistics of a client.
+ *
+ * This result only changes on calls to @ref mnd_root_update_telemetry
+ *
+ * Supported in version 1.5 and above.
+ *
+ * @param root           The libVRuska Engine state.
+ * @param client_id      ID of client to retrieve statistics from.
+ * @param[out] out_stats Pointer to populate with the statistics.
+ *
+ * @pre Called @ref mnd_root_update_telemetry at least once
+ *
+ * @return MND_SUCCESS on success
+ */
+mnd_result_t
+mnd_root_get_client_frame_stats(mnd_root_t *root, uint32_t client_id, mnd_client_frame_stats_t *out_stats);
+
+/*!
+ * Get the number of IPC commands that call statistics are tracked for.
+ *
+ * Supported in version 1.5 and above.
+ *
+ * @param root           The libVRuska Engine state.
+ * @param[out] out_count Pointer to populate with the number of commands.
+ *
+ * @return MND_SUCCESS on success
+ */
+mnd_result_t
+mnd_root_get_ipc_command_count(mnd_root_t *root, uint32_t *out_count);
+
+/*!
+ * Get the name of an IPC command.
+ *
+ * Supported in version 1.5 and above.
+ *
+ * @param root          The libVRuska Engine state.
+ * @param command       Index of the command, less then @ref mnd_root_get_ipc_command_count.
+ * @param[out] out_name Pointer to populate with the name, valid as long as the library is loaded.
+ *
+ * @return MND_SUCCESS on success
+ */
+mnd_result_t
+mnd_root_get_ipc_command_name(mnd_root_t *root, uint32_t command, const char **out_name);
+
+/*!
+ * Get the IPC call statistics of a client for a single command.
+ *
+ * This result only changes on calls to @ref mnd_root_update_telemetry
+ *
+ * Supported in version 1.5 and above.
+ *
+ * @param root              The libVRuska Engine state.
+ * @param client_id         ID of client to retrieve statistics from.
+ * @param command           Index of the command, less then @ref mnd_root_get_ipc_command_count.
+ * @param[out] out_count    Pointer to populate with the number of calls.
+ * @param[out] out_total_ns Pointer to populate with the total time spent in the service handling the calls.
+ * @param[out] out_max_ns   Pointer to populate with the longest time spent handling a single call.
+ *
+ * @pre Called @ref mnd_root_update_telemetry at least once
+ *
+ * @return MND_SUCCESS on success
+ */
+mnd_result_t
+mnd_root_get_client_ipc_call_stats(mnd_root_t *root,
+                                   uint32_t client_id,
+                                   uint32_t command,
+                                   uint64_t *out_count,
+                                   uint64_t *out_total_ns,
+                                   uint64_t *out_max_ns);
+
+/*!
+ * Get the filtered GPU time of the compositor's frames.
+ *
+ * This result only changes on calls to @ref mnd_root_update_telemetry
+ *
+ * Supported in version 1.5 and above.
+ *
+ * @param root                 The libVRuska Engine state.
+ * @param[out] out_gpu_time_ns Pointer to populate with the GPU time.
+ *
+ * @pre Called @ref mnd_root_update_telemetry at least once
+ *
+ * @return MND_SUCCESS on success
+ */
+mnd_result_t
+mnd_root_get_compositor_gpu_time(mnd_root_t *root, int64_t *out_gpu_time_ns);
+
 #ifdef __cplusplus
 }
 #endif
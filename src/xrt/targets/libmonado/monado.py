@@ -85,6 +85,26 @@ class Client:
         self.io_active = io_active
 
 
+class FrameStats:
+    def __init__(self, stats):
+        self.delivered = stats.delivered_count
+        self.discarded = stats.discarded_count
+        self.missed = stats.missed_count
+        self.frame_rate_hz = stats.frame_rate_hz
+        self.app_cpu_ms = stats.app_cpu_time_ns / 1e6
+        self.app_draw_ms = stats.app_draw_time_ns / 1e6
+        self.app_gpu_ms = stats.app_gpu_time_ns / 1e6
+        self.latch_to_display_ms = stats.latch_to_display_ns / 1e6
+
+
+class IpcCallStats:
+    def __init__(self, name, count, total_ns, max_ns):
+        self.name = name
+        self.count = count
+        self.total_ms = total_ns / 1e6
+        self.max_ms = max_ns / 1e6
+
+
 class MonadoLibraryNotFoundError(Exception):
     pass
 
@@ -217,3 +237,48 @@ class Monado:
                 raise Exception(f"Could not get device role: {role_name}")
             role_map[role_name] = device_int_id_ptr[0]
         return role_map
+
+    def update_telemetry(self):
+        ret = self.lib.mnd_root_update_telemetry(self.root)
+        if ret != 0:
+            raise Exception("Could not update telemetry")
+
+    def get_client_frame_stats(self, client_id):
+        stats_ptr = self.ffi.new("mnd_client_frame_stats_t *")
+        ret = self.lib.mnd_root_get_client_frame_stats(self.root, client_id, stats_ptr)
+        if ret != 0:
+            raise Exception(f"Could not get frame stats for client id {client_id}")
+        return FrameStats(stats_ptr[0])
+
+    def get_client_ipc_call_stats(self, client_id):
+        count_ptr = self.ffi.new("uint32_t *")
+        ret = self.lib.mnd_root_get_ipc_command_count(self.root, count_ptr)
+        if ret != 0:
+            raise Exception("Could not get IPC command count")
+
+        name_ptr = self.ffi.new("char **")
+        calls_ptr = self.ffi.new("uint64_t *")
+        total_ptr = self.ffi.new("uint64_t *")
+        max_ptr = self.ffi.new("uint64_t *")
+        calls = []
+        for command in range(count_ptr[0]):
+            ret = self.lib.mnd_root_get_client_ipc_call_stats(self.root, client_id, command,
+                                                              calls_ptr, total_ptr, max_ptr)
+            if ret != 0:
+                raise Exception(f"Could not get IPC call stats for client id {client_id}")
+            if calls_ptr[0] == 0:
+                continue
+
+            ret = self.lib.mnd_root_get_ipc_command_name(self.root, command, name_ptr)
+            if ret != 0:
+                raise Exception(f"Could not get IPC command name for {command}")
+            name = self.ffi.string(name_ptr[0]).decode("utf-8")
+            calls.append(IpcCallStats(name, calls_ptr[0], total_ptr[0], max_ptr[0]))
+        return calls
+
+    def get_compositor_gpu_time_ms(self):
+        gpu_time_ptr = self.ffi.new("int64_t *")
+        ret = self.lib.mnd_root_get_compositor_gpu_time(self.root, gpu_time_ptr)
+        if ret != 0:
+            raise Exception("Could not get compositor GPU time")
+        return gpu_time_ptr[0] / 1e6
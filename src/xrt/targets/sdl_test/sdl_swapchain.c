@@ -100,6 +100,7 @@ sdl_swapchain_create(struct xrt_compositor *xc,
 	    really_destroy,                //
 	    &sp->c.base.vk,                //
 	    &sp->c.base.cscs,              //
+	    NULL,                          //
 	    info,                          //
 	    &xsccp);                       //
 	if (xret != XRT_SUCCESS) {
@@ -12,6 +12,7 @@
 #include "xrt/xrt_config_os.h"
 
 #include "util/u_metrics.h"
+#include "util/u_flight_recorder.h"
 #include "util/u_logging.h"
 #include "util/u_trace_marker.h"
 
@@ -37,6 +38,7 @@ main(int argc, char *argv[])
 
 	u_trace_marker_init();
 	u_metrics_init();
+	u_fr_init();
 
 	struct ipc_server_main_info ismi = {
 	    .udgci =
@@ -48,6 +50,7 @@ main(int argc, char *argv[])
 
 	int ret = ipc_server_main(argc, argv, &ismi);
 
+	u_fr_close();
 	u_metrics_close();
 
 	return ret;
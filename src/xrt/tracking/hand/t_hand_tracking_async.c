@@ -216,6 +216,38 @@ ht_async_receive_right(struct xrt_frame_sink *sink, struct xrt_frame *frame)
 	os_thread_helper_unlock(&hta->mainloop);
 }
 
+static void
+ht_async_receive_frame_set(struct xrt_frame_set_sink *sink, struct xrt_frame_set *set)
+{
+	struct ht_async_impl *hta = ht_async_impl(container_of(sink, struct t_hand_tracking_async, frame_set));
+
+	// Throw away this set, the hand tracking work is still running.
+	if (hta->hand_tracking_work_active) {
+		return;
+	}
+
+	if (set->frame_count < 2) {
+		U_LOG_W("Hand tracking needs a stereo frame set, got %u frames", set->frame_count);
+		return;
+	}
+
+	// Not mixed with the left and right sinks.
+	assert(hta->frames[0] == NULL);
+	assert(hta->frames[1] == NULL);
+
+	// Both frames arrive together, no ordering to enforce, just take references.
+	xrt_frame_reference(&hta->frames[0], set->frames[0]);
+	xrt_frame_reference(&hta->frames[1], set->frames[1]);
+
+	// We have both frames, now work is active.
+	hta->hand_tracking_work_active = true;
+
+	// Wake up the worker thread.
+	os_thread_helper_lock(&hta->mainloop);
+	os_thread_helper_signal_locked(&hta->mainloop);
+	os_thread_helper_unlock(&hta->mainloop);
+}
+
 
 /*
  *
@@ -327,6 +359,8 @@ t_hand_tracking_async_default_create(struct xrt_frame_context *xfctx, struct t_h
 	hta->base.sinks.cam_count = 2;
 	hta->base.sinks.cams[0] = &hta->base.left;
 	hta->base.sinks.cams[1] = &hta->base.right;
+	hta->base.frame_set.push_frame_set = ht_async_receive_frame_set;
+	hta->base.sinks.frame_set = &hta->base.frame_set;
 	hta->base.node.break_apart = ht_async_break_apart;
 	hta->base.node.destroy = ht_async_destroy;
 	hta->base.get_hand = ht_async_get_hand;
@@ -0,0 +1,290 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Binding resolution tests and attach microbenchmark.
+ */
+
+#include "catch_amalgamated.hpp"
+
+#include <util/u_misc.h>
+
+#include <oxr/oxr_objects.h>
+#include <oxr/oxr_logger.h>
+
+extern "C" {
+#include "bindings/b_generated_bindings.h"
+}
+
+#include <vector>
+#include <memory>
+#include <cstring>
+
+
+namespace {
+
+/*!
+ * Minimal instance with only the path and binding systems set up, enough to
+ * suggest bindings for every generated interaction profile.
+ */
+struct BindingsFixture
+{
+	oxr_logger log = {};
+	oxr_instance *inst = nullptr;
+
+	std::vector<std::unique_ptr<oxr_action_ref>> refs;
+	std::vector<std::unique_ptr<oxr_action>> acts;
+	std::vector<std::vector<XrActionSuggestedBinding>> suggested;
+
+	BindingsFixture()
+	{
+		oxr_log_init(&log, "test");
+
+		inst = U_TYPED_CALLOC(oxr_instance);
+		REQUIRE(oxr_path_init(&log, inst) == XR_SUCCESS);
+
+		const oxr_bindings_path_cache *path_cache = nullptr;
+		oxr_get_interaction_profile_path_cache(&path_cache);
+		for (const auto &elem : path_cache->path_cache) {
+			const char *str = *elem.path_cache_name;
+			REQUIRE(oxr_path_get_or_create(&log, inst, str, strlen(str), elem.path_cache) == XR_SUCCESS);
+		}
+
+		// One action per binding of every profile, suggested on the first path.
+		suggested.resize(OXR_BINDINGS_PROFILE_TEMPLATE_COUNT);
+		for (size_t x = 0; x < OXR_BINDINGS_PROFILE_TEMPLATE_COUNT; x++) {
+			const profile_template &templ = profile_templates[x];
+
+			for (size_t y = 0; y < templ.binding_count; y++) {
+				const binding_template &bt = templ.bindings[y];
+
+				auto ref = std::make_unique<oxr_action_ref>();
+				ref->act_key = (uint32_t)refs.size() + 1;
+				ref->action_type =
+				    bt.output != 0 ? XR_ACTION_TYPE_VIBRATION_OUTPUT : XR_ACTION_TYPE_FLOAT_INPUT;
+
+				auto act = std::make_unique<oxr_action>();
+				act->data = ref.get();
+				act->act_key = ref->act_key;
+
+				XrActionSuggestedBinding s = {};
+				s.action = XRT_CAST_PTR_TO_OXR_HANDLE(XrAction, act.get());
+				REQUIRE(oxr_path_get_or_create(&log, inst, bt.paths[0], strlen(bt.paths[0]), &s.binding) ==
+				        XR_SUCCESS);
+				suggested[x].push_back(s);
+
+				refs.push_back(std::move(ref));
+				acts.push_back(std::move(act));
+			}
+		}
+	}
+
+	~BindingsFixture()
+	{
+		oxr_binding_destroy_all(&log, inst);
+		oxr_path_destroy(&log, inst);
+		free(inst);
+	}
+
+	void
+	suggestAll()
+	{
+		for (size_t x = 0; x < OXR_BINDINGS_PROFILE_TEMPLATE_COUNT; x++) {
+			XrInteractionProfileSuggestedBinding sb = {};
+			sb.type = XR_TYPE_INTERACTION_PROFILE_SUGGESTED_BINDING;
+			sb.interactionProfile = profile_templates[x].path_cache;
+			sb.countSuggestedBindings = (uint32_t)suggested[x].size();
+			sb.suggestedBindings = suggested[x].data();
+
+			oxr_dpad_state dpad_state = {};
+			oxr_action_suggest_interaction_profile_bindings(&log, inst, &sb, &dpad_state);
+		}
+	}
+
+	//! What xrAttachSessionActionSets does with the profiles, minus the devices.
+	size_t
+	attachAll()
+	{
+		size_t total = 0;
+
+		oxr_session sess = {};
+		sess.profiles_on_attachment_size = inst->profile_count;
+		sess.profiles_on_attachment = U_TYPED_ARRAY_CALLOC(oxr_interaction_profile *, inst->profile_count);
+
+		for (size_t x = 0; x < inst->profile_count; x++) {
+			oxr_interaction_profile *p = oxr_clone_profile(inst->profiles[x]);
+			sess.profiles_on_attachment[x] = p;
+
+			for (const auto &ref : refs) {
+				oxr_binding *bindings[OXR_MAX_BINDINGS_PER_ACTION];
+				size_t count = 0;
+				oxr_binding_find_bindings_from_act_key(&log, p, ref->act_key, ARRAY_SIZE(bindings), bindings,
+				                                       &count);
+				total += count;
+			}
+		}
+
+		oxr_session_binding_destroy_all(&log, &sess);
+
+		return total;
+	}
+};
+
+} // namespace
+
+
+TEST_CASE("bindings_suggest_all_profiles")
+{
+	BindingsFixture f;
+	f.suggestAll();
+
+	CHECK(f.inst->profile_count == OXR_BINDINGS_PROFILE_TEMPLATE_COUNT);
+
+	for (size_t x = 0; x < f.inst->profile_count; x++) {
+		oxr_interaction_profile *p = f.inst->profiles[x];
+		CHECK(p->path_ref_count > 0);
+
+		// Path table is sorted and every entry points at the right path.
+		for (size_t i = 0; i < p->path_ref_count; i++) {
+			const oxr_binding_path_ref &ref = p->path_refs[i];
+			REQUIRE(ref.binding_index < p->binding_count);
+			REQUIRE(ref.path_index < p->bindings[ref.binding_index].path_count);
+			CHECK(p->bindings[ref.binding_index].paths[ref.path_index] == ref.path);
+			if (i > 0) {
+				CHECK(p->path_refs[i - 1].path <= ref.path);
+			}
+		}
+
+		// The lookup must agree with a plain scan over all bindings.
+		for (size_t b = 0; b < p->binding_count; b++) {
+			for (uint32_t k = 0; k < p->bindings[b].act_key_count; k++) {
+				uint32_t key = p->bindings[b].act_keys[k];
+
+				std::vector<oxr_binding *> expected;
+				for (size_t y = 0; y < p->binding_count; y++) {
+					for (uint32_t z = 0; z < p->bindings[y].act_key_count; z++) {
+						if (p->bindings[y].act_keys[z] == key) {
+							expected.push_back(&p->bindings[y]);
+							break;
+						}
+					}
+				}
+
+				oxr_binding *found[OXR_MAX_BINDINGS_PER_ACTION];
+				size_t count = 0;
+				oxr_binding_find_bindings_from_act_key(&f.log, p, key, ARRAY_SIZE(found), found, &count);
+
+				REQUIRE(count == expected.size());
+				for (size_t i = 0; i < count; i++) {
+					CHECK(found[i] == expected[i]);
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("bindings_component_selection")
+{
+	BindingsFixture f;
+
+	// Find a profile with a trigger that has both click and value.
+	const char *base = "/user/hand/right/input/trigger";
+	const char *click = "/user/hand/right/input/trigger/click";
+	const char *value = "/user/hand/right/input/trigger/value";
+
+	for (size_t x = 0; x < OXR_BINDINGS_PROFILE_TEMPLATE_COUNT; x++) {
+		const profile_template &templ = profile_templates[x];
+
+		bool has_click = false;
+		bool has_value = false;
+		for (size_t y = 0; y < templ.binding_count; y++) {
+			has_click = has_click || strcmp(templ.bindings[y].paths[0], click) == 0;
+			has_value = has_value || strcmp(templ.bindings[y].paths[0], value) == 0;
+		}
+		if (!has_click || !has_value) {
+			continue;
+		}
+
+		oxr_action_ref bool_ref = {};
+		bool_ref.act_key = 1000001;
+		bool_ref.action_type = XR_ACTION_TYPE_BOOLEAN_INPUT;
+		oxr_action bool_act = {};
+		bool_act.data = &bool_ref;
+		bool_act.act_key = bool_ref.act_key;
+
+		oxr_action_ref float_ref = {};
+		float_ref.act_key = 1000002;
+		float_ref.action_type = XR_ACTION_TYPE_FLOAT_INPUT;
+		oxr_action float_act = {};
+		float_act.data = &float_ref;
+		float_act.act_key = float_ref.act_key;
+
+		XrActionSuggestedBinding s[2] = {};
+		s[0].action = XRT_CAST_PTR_TO_OXR_HANDLE(XrAction, &bool_act);
+		s[1].action = XRT_CAST_PTR_TO_OXR_HANDLE(XrAction, &float_act);
+		oxr_path_get_or_create(&f.log, f.inst, base, strlen(base), &s[0].binding);
+		s[1].binding = s[0].binding;
+
+		XrInteractionProfileSuggestedBinding sb = {};
+		sb.type = XR_TYPE_INTERACTION_PROFILE_SUGGESTED_BINDING;
+		sb.interactionProfile = templ.path_cache;
+		sb.countSuggestedBindings = 2;
+		sb.suggestedBindings = s;
+
+		oxr_dpad_state dpad_state = {};
+		oxr_action_suggest_interaction_profile_bindings(&f.log, f.inst, &sb, &dpad_state);
+
+		REQUIRE(f.inst->profile_count == 1);
+		oxr_interaction_profile *p = f.inst->profiles[0];
+
+		oxr_binding *found[OXR_MAX_BINDINGS_PER_ACTION];
+		size_t count = 0;
+		const char *str = nullptr;
+		size_t length = 0;
+
+		// Boolean action on the bare identifier picks /click.
+		oxr_binding_find_bindings_from_act_key(&f.log, p, bool_ref.act_key, ARRAY_SIZE(found), found, &count);
+		REQUIRE(count == 1);
+		oxr_path_get_string(&f.log, f.inst, found[0]->paths[0], &str, &length);
+		CHECK(std::string(str) == click);
+		// But remembers what the app actually suggested.
+		CHECK(found[0]->paths[found[0]->preferred_binding_path_index[0]] == s[0].binding);
+
+		// Float action on the bare identifier picks /value.
+		oxr_binding_find_bindings_from_act_key(&f.log, p, float_ref.act_key, ARRAY_SIZE(found), found, &count);
+		REQUIRE(count == 1);
+		oxr_path_get_string(&f.log, f.inst, found[0]->paths[0], &str, &length);
+		CHECK(std::string(str) == value);
+
+		return;
+	}
+
+	SKIP("No profile with both trigger click and value");
+}
+
+TEST_CASE("bindings_input_name_lookup")
+{
+	CHECK(xrt_input_name_enum("XRT_INPUT_GENERIC_HEAD_POSE") == XRT_INPUT_GENERIC_HEAD_POSE);
+	CHECK(xrt_input_name_enum(xrt_input_name_string(XRT_INPUT_SIMPLE_SELECT_CLICK)) ==
+	      XRT_INPUT_SIMPLE_SELECT_CLICK);
+	CHECK(xrt_input_name_enum("not a input name") == XRT_INPUT_GENERIC_TRACKER_POSE);
+	CHECK(xrt_output_name_enum("not a output name") == XRT_OUTPUT_NAME_SIMPLE_VIBRATION);
+}
+
+TEST_CASE("bindings_attach_benchmark", "[.][benchmark]")
+{
+	BindingsFixture f;
+
+	BENCHMARK("xrSuggestInteractionProfileBindings all profiles")
+	{
+		f.suggestAll();
+		return f.inst->profile_count;
+	};
+
+	f.suggestAll();
+
+	BENCHMARK("xrAttachSessionActionSets all profiles")
+	{
+		return f.attachAll();
+	};
+}
@@ -0,0 +1,328 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Capture of device calls and their replay.
+ */
+
+#include "catch_amalgamated.hpp"
+
+#include <util/u_capture.h>
+#include <replay/replay_interface.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+
+namespace {
+
+//! Device with one pose and one button, both move on every update.
+struct FakeDevice
+{
+	xrt_device base = {};
+	xrt_input inputs[2] = {};
+	float x = 0.0f;
+	bool *destroyed = nullptr;
+
+	FakeDevice(bool *destroyed_flag) : destroyed(destroyed_flag)
+	{
+		base.name = XRT_DEVICE_SIMPLE_CONTROLLER;
+		base.device_type = XRT_DEVICE_TYPE_LEFT_HAND_CONTROLLER;
+		strcpy(base.str, "Fake");
+		strcpy(base.serial, "Fake-0");
+		base.supported.orientation_tracking = true;
+		base.supported.position_tracking = true;
+
+		inputs[0].name = XRT_INPUT_SIMPLE_GRIP_POSE;
+		inputs[0].active = true;
+		inputs[1].name = XRT_INPUT_SIMPLE_SELECT_CLICK;
+		inputs[1].active = true;
+		base.inputs = inputs;
+		base.input_count = 2;
+
+		base.update_inputs = update_inputs;
+		base.get_tracked_pose = get_tracked_pose;
+		base.destroy = destroy;
+	}
+
+	static xrt_result_t
+	update_inputs(xrt_device *xdev)
+	{
+		auto *d = reinterpret_cast<FakeDevice *>(xdev);
+		d->x += 1.0f;
+		d->inputs[1].timestamp += 1000;
+		d->inputs[1].value.boolean = !d->inputs[1].value.boolean;
+		return XRT_SUCCESS;
+	}
+
+	static xrt_result_t
+	get_tracked_pose(xrt_device *xdev, xrt_input_name name, int64_t at_timestamp_ns, xrt_space_relation *out)
+	{
+		auto *d = reinterpret_cast<FakeDevice *>(xdev);
+		if (name != XRT_INPUT_SIMPLE_GRIP_POSE) {
+			return XRT_ERROR_INPUT_UNSUPPORTED;
+		}
+
+		*out = {};
+		out->pose.orientation.w = 1.0f;
+		out->pose.position.x = d->x;
+		out->relation_flags = XRT_SPACE_RELATION_POSITION_VALID_BIT;
+		return XRT_SUCCESS;
+	}
+
+	static void
+	destroy(xrt_device *xdev)
+	{
+		auto *d = reinterpret_cast<FakeDevice *>(xdev);
+		*d->destroyed = true;
+		delete d;
+	}
+};
+
+std::string
+capture_path()
+{
+	return (std::filesystem::temp_directory_path() / "tests_capture.xrtcapt").string();
+}
+
+//! Record three updates and poses of a fake device.
+void
+record_capture(const std::string &path)
+{
+	bool destroyed = false;
+	u_capture_writer *writer = nullptr;
+	REQUIRE(u_capture_writer_create(path.c_str(), &writer));
+
+	xrt_device *xdev = nullptr;
+	REQUIRE(u_capture_device_wrap(writer, &(new FakeDevice(&destroyed))->base, &xdev) == XRT_SUCCESS);
+	u_capture_writer_reference(&writer, nullptr);
+
+	// Same device to the outside.
+	CHECK(xdev->name == XRT_DEVICE_SIMPLE_CONTROLLER);
+	CHECK(xdev->input_count == 2);
+	CHECK(xdev->get_hand_tracking == nullptr);
+
+	for (int i = 0; i < 3; i++) {
+		xrt_space_relation rel;
+		REQUIRE(xrt_device_update_inputs(xdev) == XRT_SUCCESS);
+		REQUIRE(xrt_device_get_tracked_pose(xdev, XRT_INPUT_SIMPLE_GRIP_POSE, 0, &rel) == XRT_SUCCESS);
+		CHECK(rel.pose.position.x == float(i + 1));
+	}
+
+	// Closes the file.
+	xrt_device_destroy(&xdev);
+	CHECK(destroyed);
+}
+
+} // namespace
+
+
+TEST_CASE("capture")
+{
+	const std::string path = capture_path();
+	record_capture(path);
+
+	SECTION("records are read back in order")
+	{
+		u_capture_reader reader;
+		REQUIRE(u_capture_reader_open(path.c_str(), &reader));
+
+		std::vector<uint32_t> types;
+		size_t offset = 0;
+		const u_capture_record_header *header = nullptr;
+		const void *payload = nullptr;
+		while (u_capture_reader_next(&reader, &offset, &header, &payload)) {
+			types.push_back(header->type);
+
+			if (header->type == U_CAPTURE_RECORD_DEVICE) {
+				auto *device = static_cast<const u_capture_device *>(payload);
+				CHECK(std::string(device->serial) == "Fake-0");
+				CHECK(device->input_count == 2);
+				CHECK(u_capture_device_input_names(device)[1] == XRT_INPUT_SIMPLE_SELECT_CLICK);
+			}
+
+			if (header->type == U_CAPTURE_RECORD_INPUTS) {
+				// The first update has every input, after that only the button changes.
+				auto *inputs = static_cast<const u_capture_inputs *>(payload);
+				bool first = types.size() == 2;
+				REQUIRE(inputs->count == (first ? 2 : 1));
+				CHECK(u_capture_inputs_array(inputs)[inputs->count - 1].index == 1);
+			}
+		}
+
+		const std::vector<uint32_t> expected = {
+		    U_CAPTURE_RECORD_DEVICE,       //
+		    U_CAPTURE_RECORD_INPUTS,       //
+		    U_CAPTURE_RECORD_TRACKED_POSE, //
+		    U_CAPTURE_RECORD_INPUTS,       //
+		    U_CAPTURE_RECORD_TRACKED_POSE, //
+		    U_CAPTURE_RECORD_INPUTS,       //
+		    U_CAPTURE_RECORD_TRACKED_POSE, //
+		};
+		CHECK(types == expected);
+
+		u_capture_reader_close(&reader);
+	}
+
+	SECTION("a truncated capture ends at the last complete record")
+	{
+		std::ifstream in(path, std::ios::binary);
+		std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		bytes.resize(bytes.size() - 8);
+
+		// The vector's storage is suitably aligned for the records.
+		u_capture_reader reader;
+		REQUIRE(u_capture_reader_init_from_memory(bytes.data(), bytes.size(), &reader));
+
+		int count = 0;
+		size_t offset = 0;
+		const u_capture_record_header *header = nullptr;
+		const void *payload = nullptr;
+		while (u_capture_reader_next(&reader, &offset, &header, &payload)) {
+			count++;
+		}
+		CHECK(count == 6);
+	}
+
+	SECTION("fast replay serves every recorded call once")
+	{
+		xrt_device *xdevs[4] = {};
+		uint32_t count = 0;
+		REQUIRE(replay_create_devices(path.c_str(), REPLAY_MODE_FAST, xdevs, 4, &count) == XRT_SUCCESS);
+		REQUIRE(count == 1);
+
+		xrt_device *xdev = xdevs[0];
+		CHECK(xdev->device_type == XRT_DEVICE_TYPE_LEFT_HAND_CONTROLLER);
+		CHECK(std::string(xdev->str) == "Fake");
+		REQUIRE(xdev->input_count == 2);
+		CHECK(xdev->inputs[1].name == XRT_INPUT_SIMPLE_SELECT_CLICK);
+
+		for (int i = 0; i < 3; i++) {
+			xrt_space_relation rel;
+			REQUIRE(xrt_device_update_inputs(xdev) == XRT_SUCCESS);
+			REQUIRE(xrt_device_get_tracked_pose(xdev, XRT_INPUT_SIMPLE_GRIP_POSE, 0, &rel) == XRT_SUCCESS);
+
+			// Exact recorded values and timestamps.
+			CHECK(rel.pose.position.x == float(i + 1));
+			CHECK(xdev->inputs[1].timestamp == (i + 1) * 1000);
+			CHECK(xdev->inputs[1].value.boolean == (i % 2 == 0));
+		}
+
+		// Past the end the last record is kept.
+		xrt_space_relation rel;
+		REQUIRE(xrt_device_get_tracked_pose(xdev, XRT_INPUT_SIMPLE_GRIP_POSE, 0, &rel) == XRT_SUCCESS);
+		CHECK(rel.pose.position.x == 3.0f);
+
+		CHECK(xrt_device_get_tracked_pose(xdev, XRT_INPUT_GENERIC_HEAD_POSE, 0, &rel) ==
+		      XRT_ERROR_INPUT_UNSUPPORTED);
+
+		xrt_device_destroy(&xdev);
+	}
+
+	SECTION("a record before its device record is rejected")
+	{
+		std::ifstream in(path, std::ios::binary);
+		std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		in.close();
+
+		u_capture_reader reader;
+		REQUIRE(u_capture_reader_init_from_memory(bytes.data(), bytes.size(), &reader));
+
+		// Byte ranges of the device record and the inputs record after it.
+		size_t offset = 0;
+		const u_capture_record_header *header = nullptr;
+		const void *payload = nullptr;
+		REQUIRE(u_capture_reader_next(&reader, &offset, &header, &payload));
+		REQUIRE(header->type == U_CAPTURE_RECORD_DEVICE);
+		size_t device_begin = (const char *)header - bytes.data();
+		size_t device_end = offset;
+		REQUIRE(u_capture_reader_next(&reader, &offset, &header, &payload));
+		REQUIRE(header->type == U_CAPTURE_RECORD_INPUTS);
+		size_t inputs_end = offset;
+
+		// Put the inputs first, like a capture written out of order.
+		std::rotate(bytes.begin() + device_begin, bytes.begin() + device_end, bytes.begin() + inputs_end);
+
+		const std::string swapped_path = path + ".swapped";
+		std::ofstream(swapped_path, std::ios::binary).write(bytes.data(), bytes.size());
+
+		xrt_device *xdevs[4] = {};
+		uint32_t count = 0;
+		CHECK(replay_create_devices(swapped_path.c_str(), REPLAY_MODE_FAST, xdevs, 4, &count) ==
+		      XRT_ERROR_DEVICE_CREATION_FAILED);
+		CHECK(xdevs[0] == nullptr);
+
+		std::filesystem::remove(swapped_path);
+	}
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("capture_failures")
+{
+	SECTION("a failed call records no outputs")
+	{
+		const std::string path = capture_path() + ".failed";
+
+		bool destroyed = false;
+		u_capture_writer *writer = nullptr;
+		REQUIRE(u_capture_writer_create(path.c_str(), &writer));
+
+		xrt_device *xdev = nullptr;
+		REQUIRE(u_capture_device_wrap(writer, &(new FakeDevice(&destroyed))->base, &xdev) == XRT_SUCCESS);
+		u_capture_writer_reference(&writer, nullptr);
+
+		// Garbage the device never writes over.
+		xrt_space_relation rel;
+		memset(&rel, 0xab, sizeof(rel));
+		CHECK(xrt_device_get_tracked_pose(xdev, XRT_INPUT_GENERIC_HEAD_POSE, 0, &rel) ==
+		      XRT_ERROR_INPUT_UNSUPPORTED);
+		xrt_device_destroy(&xdev);
+
+		u_capture_reader reader;
+		REQUIRE(u_capture_reader_open(path.c_str(), &reader));
+
+		const u_capture_tracked_pose *pose = nullptr;
+		size_t offset = 0;
+		const u_capture_record_header *header = nullptr;
+		const void *payload = nullptr;
+		while (u_capture_reader_next(&reader, &offset, &header, &payload)) {
+			if (header->type == U_CAPTURE_RECORD_TRACKED_POSE) {
+				pose = static_cast<const u_capture_tracked_pose *>(payload);
+			}
+		}
+
+		REQUIRE(pose != nullptr);
+		CHECK(pose->result == XRT_ERROR_INPUT_UNSUPPORTED);
+
+		const xrt_space_relation zero = {};
+		CHECK(memcmp(&pose->relation, &zero, sizeof(zero)) == 0);
+
+		u_capture_reader_close(&reader);
+		std::filesystem::remove(path);
+	}
+
+	SECTION("a short write fails the capture")
+	{
+		// Every write to it fails with ENOSPC.
+		if (!std::filesystem::exists("/dev/full")) {
+			SKIP("No /dev/full");
+		}
+
+		u_capture_writer *writer = nullptr;
+		REQUIRE(u_capture_writer_create("/dev/full", &writer));
+		CHECK_FALSE(u_capture_writer_has_failed(writer));
+
+		// Past the write buffer, so stdio has to flush.
+		const std::vector<char> payload(64 * 1024);
+		for (int i = 0; i < 32; i++) {
+			u_capture_writer_write(writer, U_CAPTURE_RECORD_OUTPUT, 0, i, payload.data(), payload.size());
+		}
+		CHECK(u_capture_writer_has_failed(writer));
+
+		u_capture_writer_reference(&writer, nullptr);
+	}
+}
@@ -0,0 +1,139 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Dynamic scratch resolution controller tests.
+ */
+
+#include "util/comp_dynamic_resolution.h"
+
+#include "catch_amalgamated.hpp"
+
+
+namespace {
+
+constexpr uint64_t kBudgetNs = 4'000'000;
+
+//! Feeds the same GPU time @p count times, returns how many changed the level.
+int
+feed(struct comp_dynamic_resolution *cdr, uint64_t gpu_ns, int count)
+{
+	int changes = 0;
+	for (int i = 0; i < count; i++) {
+		changes += comp_dynamic_resolution_update(cdr, gpu_ns, kBudgetNs) ? 1 : 0;
+	}
+	return changes;
+}
+
+} // namespace
+
+
+TEST_CASE("comp_dynamic_resolution")
+{
+	struct comp_dynamic_resolution cdr;
+	comp_dynamic_resolution_init(&cdr, true, 0.5f, 6);
+
+	SECTION("levels are spaced evenly from full size")
+	{
+		CHECK(cdr.level_count == 6);
+		CHECK(cdr.scales[0] == 1.0f);
+		CHECK(cdr.scales[1] == Catch::Approx(0.9f));
+		CHECK(cdr.scales[5] == Catch::Approx(0.5f));
+		CHECK(comp_dynamic_resolution_get_scale(&cdr) == 1.0f);
+	}
+
+	SECTION("init clamps its arguments")
+	{
+		comp_dynamic_resolution_init(&cdr, true, 0.0f, 100);
+		CHECK(cdr.level_count == COMP_DYNAMIC_RESOLUTION_MAX_LEVELS);
+		CHECK(cdr.scales[cdr.level_count - 1] == Catch::Approx(0.1f));
+
+		comp_dynamic_resolution_init(&cdr, true, 0.5f, 0);
+		CHECK(cdr.level_count == 1);
+		CHECK(feed(&cdr, 2 * kBudgetNs, 10) == 0);
+	}
+
+	SECTION("a single slow frame does not scale down")
+	{
+		CHECK(feed(&cdr, kBudgetNs, 1) == 0);
+		CHECK(feed(&cdr, kBudgetNs / 2, 1) == 0);
+		CHECK(feed(&cdr, kBudgetNs, 1) == 0);
+		CHECK(cdr.level == 0);
+	}
+
+	SECTION("sustained overload scales down to the smallest level")
+	{
+		CHECK(feed(&cdr, kBudgetNs, COMP_DYNAMIC_RESOLUTION_DOWN_FRAMES) == 1);
+		CHECK(cdr.level == 1);
+
+		feed(&cdr, kBudgetNs, 100);
+		CHECK(cdr.level == 5);
+		CHECK(cdr.stats.scale == Catch::Approx(0.5f));
+		CHECK(cdr.stats.scale_downs == 5);
+	}
+
+	SECTION("scaling up waits for headroom at the next level")
+	{
+		feed(&cdr, kBudgetNs, COMP_DYNAMIC_RESOLUTION_DOWN_FRAMES * 2);
+		REQUIRE(cdr.level == 2);
+
+		// 2.4ms at 0.8 is estimated at 3.04ms at 0.9, over 75% of the budget.
+		CHECK(feed(&cdr, 2'400'000, COMP_DYNAMIC_RESOLUTION_UP_FRAMES * 2) == 0);
+
+		// 2.0ms is estimated at 2.53ms, one frame short keeps the level.
+		CHECK(feed(&cdr, 2'000'000, COMP_DYNAMIC_RESOLUTION_UP_FRAMES - 1) == 0);
+		CHECK(feed(&cdr, 2'000'000, 1) == 1);
+		CHECK(cdr.level == 1);
+		CHECK(cdr.stats.scale_ups == 1);
+	}
+
+	SECTION("disabling resets to full size")
+	{
+		feed(&cdr, kBudgetNs, COMP_DYNAMIC_RESOLUTION_DOWN_FRAMES);
+		REQUIRE(cdr.level == 1);
+
+		cdr.enabled = false;
+		CHECK(comp_dynamic_resolution_update(&cdr, kBudgetNs, kBudgetNs));
+		CHECK(cdr.level == 0);
+		CHECK(feed(&cdr, kBudgetNs, 10) == 0);
+	}
+
+	SECTION("no budget keeps full size")
+	{
+		for (int i = 0; i < 10; i++) {
+			CHECK_FALSE(comp_dynamic_resolution_update(&cdr, kBudgetNs, 0));
+		}
+		CHECK(cdr.level == 0);
+	}
+
+	SECTION("region is rounded to whole pixels in the top left corner")
+	{
+		feed(&cdr, kBudgetNs, COMP_DYNAMIC_RESOLUTION_DOWN_FRAMES * 3);
+		REQUIRE(cdr.level == 3);
+
+		struct render_viewport_data vp;
+		struct xrt_normalized_rect rect;
+		comp_dynamic_resolution_get_region(&cdr, VkExtent2D{1001, 999}, &vp, &rect);
+
+		CHECK(vp.x == 0);
+		CHECK(vp.y == 0);
+		CHECK(vp.w == 701);
+		CHECK(vp.h == 699);
+		CHECK(rect.x == 0.0f);
+		CHECK(rect.y == 0.0f);
+		CHECK(rect.w == Catch::Approx(701.0 / 1001.0));
+		CHECK(rect.h == Catch::Approx(699.0 / 999.0));
+	}
+
+	SECTION("full size region covers the whole image")
+	{
+		struct render_viewport_data vp;
+		struct xrt_normalized_rect rect;
+		comp_dynamic_resolution_get_region(&cdr, VkExtent2D{1920, 1080}, &vp, &rect);
+
+		CHECK(vp.w == 1920);
+		CHECK(vp.h == 1080);
+		CHECK(rect.w == 1.0f);
+		CHECK(rect.h == 1.0f);
+	}
+}
@@ -0,0 +1,209 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Static layer cache planning tests.
+ */
+
+#include "util/comp_layer_cache.h"
+#include "util/comp_render.h"
+
+#include "catch_amalgamated.hpp"
+
+#include <cstdlib>
+#include <memory>
+
+
+namespace {
+
+//! Only the planning state is used, no images or targets are created.
+struct Fixture
+{
+	std::unique_ptr<struct comp_layer_cache> cache = std::make_unique<struct comp_layer_cache>();
+	std::unique_ptr<struct comp_swapchain> sc = std::make_unique<struct comp_swapchain>();
+	std::unique_ptr<struct comp_swapchain> other_sc = std::make_unique<struct comp_swapchain>();
+	comp_render_dispatch_data d = {};
+	comp_layer layers[3] = {};
+	uint32_t layer_count = 0;
+
+	Fixture()
+	{
+		sc->base.limited_unique_id.data = 1;
+		other_sc->base.limited_unique_id.data = 2;
+
+		d.view_count = 2;
+		for (uint32_t i = 0; i < d.view_count; i++) {
+			d.views[i].world_pose.orientation.w = 1.0f;
+			d.views[i].world_pose.position.x = i == 0 ? -0.03f : 0.03f;
+			d.views[i].eye_pose = d.views[i].world_pose;
+			d.views[i].fov = {-0.8f, 0.8f, 0.8f, -0.8f};
+		}
+	}
+
+	void
+	add(xrt_layer_type type, struct comp_swapchain *swapchain, bool view_space = false)
+	{
+		comp_layer &layer = layers[layer_count++];
+		layer.data.type = type;
+		layer.data.flags = view_space ? XRT_LAYER_COMPOSITION_VIEW_SPACE_BIT : (xrt_layer_composition_flags)0;
+		layer.data.quad.pose.orientation.w = 1.0f;
+		layer.data.quad.pose.position.z = -1.0f;
+		layer.sc_array[0] = &swapchain->base.base;
+	}
+
+	//! Moves and turns the head a bit, more than the cache allows.
+	void
+	move_head()
+	{
+		for (uint32_t i = 0; i < d.view_count; i++) {
+			d.views[i].world_pose.position.y += 0.01f;
+		}
+	}
+
+	struct comp_layer_cache_plan
+	plan()
+	{
+		struct comp_layer_cache_plan p;
+		comp_layer_cache_plan(cache.get(), layers, layer_count, &d, &p);
+		return p;
+	}
+};
+
+} // namespace
+
+
+TEST_CASE("comp_layer_cache")
+{
+	Fixture f;
+
+	SECTION("static quad is cached after being stable")
+	{
+		f.add(XRT_LAYER_QUAD, f.sc.get());
+
+		CHECK(f.plan().action == COMP_LAYER_CACHE_ACTION_NONE);
+		CHECK(f.plan().action == COMP_LAYER_CACHE_ACTION_NONE);
+
+		struct comp_layer_cache_plan p = f.plan();
+		CHECK(p.action == COMP_LAYER_CACHE_ACTION_REFRESH);
+		CHECK(p.layer_count == 1);
+
+		p = f.plan();
+		CHECK(p.action == COMP_LAYER_CACHE_ACTION_USE);
+		CHECK(p.layer_count == 1);
+
+		CHECK(f.cache->stats.refreshes == 1);
+		CHECK(f.cache->stats.hits == 1);
+		CHECK(f.cache->stats.layer_count == 1);
+	}
+
+	SECTION("only the timestamp changing keeps the cache")
+	{
+		f.add(XRT_LAYER_QUAD, f.sc.get());
+		for (int i = 0; i < 3; i++) {
+			f.plan();
+		}
+
+		f.layers[0].data.timestamp += 11'000'000;
+		CHECK(f.plan().action == COMP_LAYER_CACHE_ACTION_USE);
+	}
+
+	SECTION("releasing a new image invalidates the cache")
+	{
+		f.add(XRT_LAYER_QUAD, f.sc.get());
+		for (int i = 0; i < 4; i++) {
+			f.plan();
+		}
+
+		xrt_atomic_s32_inc_return(&f.sc->release_count);
+		CHECK(f.plan().action == COMP_LAYER_CACHE_ACTION_NONE);
+		CHECK(f.cache->cached_count == 0);
+
+		// Stable again.
+		CHECK(f.plan().action == COMP_LAYER_CACHE_ACTION_NONE);
+		CHECK(f.plan().action == COMP_LAYER_CACHE_ACTION_REFRESH);
+	}
+
+	SECTION("only the bottom-most run of static layers is cached")
+	{
+		f.add(XRT_LAYER_EQUIRECT2, f.sc.get());
+		f.add(XRT_LAYER_PROJECTION, f.other_sc.get());
+		f.add(XRT_LAYER_QUAD, f.sc.get());
+		for (int i = 0; i < 2; i++) {
+			f.plan();
+		}
+
+		struct comp_layer_cache_plan p = f.plan();
+		CHECK(p.action == COMP_LAYER_CACHE_ACTION_REFRESH);
+		CHECK(p.layer_count == 1);
+	}
+
+	SECTION("projection layers are never cached")
+	{
+		f.add(XRT_LAYER_PROJECTION, f.other_sc.get());
+		f.add(XRT_LAYER_QUAD, f.sc.get());
+		for (int i = 0; i < 4; i++) {
+			CHECK(f.plan().action == COMP_LAYER_CACHE_ACTION_NONE);
+		}
+	}
+
+	SECTION("world space layers are bypassed while the head moves")
+	{
+		f.add(XRT_LAYER_QUAD, f.sc.get());
+		for (int i = 0; i < 4; i++) {
+			f.plan();
+		}
+
+		f.move_head();
+		CHECK(f.plan().action == COMP_LAYER_CACHE_ACTION_NONE);
+		CHECK(f.cache->stats.bypasses == 1);
+
+		// At rest again, squash once and then reuse.
+		CHECK(f.plan().action == COMP_LAYER_CACHE_ACTION_REFRESH);
+		CHECK(f.plan().action == COMP_LAYER_CACHE_ACTION_USE);
+	}
+
+	SECTION("view space layers are kept while the head moves")
+	{
+		f.add(XRT_LAYER_QUAD, f.sc.get(), true);
+		for (int i = 0; i < 4; i++) {
+			f.plan();
+		}
+
+		for (int i = 0; i < 3; i++) {
+			f.move_head();
+			CHECK(f.plan().action == COMP_LAYER_CACHE_ACTION_USE);
+		}
+	}
+
+	SECTION("fov changes invalidate the cache")
+	{
+		f.add(XRT_LAYER_CYLINDER, f.sc.get(), true);
+		for (int i = 0; i < 4; i++) {
+			f.plan();
+		}
+
+		f.d.views[1].fov.angle_left = -0.7f;
+		CHECK(f.plan().action == COMP_LAYER_CACHE_ACTION_REFRESH);
+	}
+
+	SECTION("cache layer draws the cache images with the refresh poses")
+	{
+		f.add(XRT_LAYER_QUAD, f.sc.get());
+		for (int i = 0; i < 3; i++) {
+			f.plan();
+		}
+
+		comp_layer layer;
+		comp_layer_cache_get_layer(f.cache.get(), f.d.view_count, &layer);
+
+		CHECK(layer.data.type == XRT_LAYER_PROJECTION);
+		CHECK(layer.data.flags == 0);
+		for (uint32_t i = 0; i < f.d.view_count; i++) {
+			CHECK(layer.sc_array[i] == &f.cache->views[i].sc.base.base);
+			CHECK(layer.data.proj.v[i].pose.position.x == f.d.views[i].world_pose.position.x);
+			CHECK(layer.data.proj.v[i].fov.angle_right == 0.8f);
+			CHECK(layer.data.proj.v[i].sub.norm_rect.w == 1.0f);
+		}
+		CHECK(layer.sc_array[2] == nullptr);
+	}
+}
@@ -0,0 +1,561 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Parallel per view layer squashing recording tests and benchmark.
+ */
+
+#include "os/os_time.h"
+
+#include "render/render_interface.h"
+#include "util/comp_layer_accum.h"
+#include "util/comp_render.h"
+#include "util/comp_swapchain.h"
+
+#include "catch_amalgamated.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace {
+
+constexpr uint32_t kViewCount = XRT_MAX_VIEWS;
+constexpr uint32_t kLayerCount = 8;
+
+/*!
+ * What was recorded into one command buffer, the fake command buffer handles
+ * point to these so each thread only touches its own.
+ */
+struct Recorded
+{
+	VkCommandPool pool = VK_NULL_HANDLE;
+	bool secondary = false;
+	bool ended = false;
+	VkCommandBufferUsageFlags flags = 0;
+	VkFramebuffer inherited_framebuffer = VK_NULL_HANDLE;
+
+	int inline_passes = 0;
+	int secondary_passes = 0;
+	int viewports = 0;
+	int draws = 0;
+	std::vector<VkCommandBuffer> executed;
+	std::vector<uint32_t> timestamps;
+
+	void
+	reset()
+	{
+		Recorded fresh;
+		fresh.pool = pool;
+		fresh.secondary = secondary;
+		*this = fresh;
+	}
+};
+
+//! State of the fake device, there is only ever one fixture alive.
+struct Device
+{
+	std::mutex mutex;
+	std::vector<std::unique_ptr<Recorded>> secondaries;
+	std::atomic<uint64_t> next_handle{1};
+	VkCommandPool main_pool = VK_NULL_HANDLE;
+	int parallel_pool_resets = 0;
+
+	//! Busy time per recorded command, stands in for the driver's CPU cost.
+	std::atomic<uint64_t> cmd_cost_ns{0};
+} device;
+
+template <typename T>
+T
+fake_handle()
+{
+	return (T)(uintptr_t)device.next_handle++;
+}
+
+Recorded *
+rec(VkCommandBuffer cmd)
+{
+	return reinterpret_cast<Recorded *>(cmd);
+}
+
+VkCommandBuffer
+to_cmd(Recorded *recorded)
+{
+	return reinterpret_cast<VkCommandBuffer>(recorded);
+}
+
+void
+spend_cmd_cost()
+{
+	uint64_t cost_ns = device.cmd_cost_ns;
+	if (cost_ns == 0) {
+		return;
+	}
+
+	int64_t until_ns = os_monotonic_get_ns() + (int64_t)cost_ns;
+	while (os_monotonic_get_ns() < until_ns) {
+	}
+}
+
+
+/*
+ *
+ * Fake Vulkan functions.
+ *
+ */
+
+VKAPI_ATTR VkResult VKAPI_CALL
+create_command_pool(VkDevice,
+                    const VkCommandPoolCreateInfo *,
+                    const VkAllocationCallbacks *,
+                    VkCommandPool *out_pool)
+{
+	*out_pool = fake_handle<VkCommandPool>();
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL
+destroy_command_pool(VkDevice, VkCommandPool pool, const VkAllocationCallbacks *)
+{}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+reset_command_pool(VkDevice, VkCommandPool pool, VkCommandPoolResetFlags)
+{
+	std::lock_guard<std::mutex> lock(device.mutex);
+
+	if (pool == device.main_pool) {
+		return VK_SUCCESS;
+	}
+
+	device.parallel_pool_resets++;
+
+	auto &list = device.secondaries;
+	for (auto it = list.begin(); it != list.end();) {
+		it = (*it)->pool == pool ? list.erase(it) : it + 1;
+	}
+
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+allocate_command_buffers(VkDevice, const VkCommandBufferAllocateInfo *info, VkCommandBuffer *out_cmds)
+{
+	std::lock_guard<std::mutex> lock(device.mutex);
+
+	for (uint32_t i = 0; i < info->commandBufferCount; i++) {
+		auto recorded = std::make_unique<Recorded>();
+		recorded->pool = info->commandPool;
+		recorded->secondary = info->level == VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+		out_cmds[i] = to_cmd(recorded.get());
+		device.secondaries.push_back(std::move(recorded));
+	}
+
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+begin_command_buffer(VkCommandBuffer cmd, const VkCommandBufferBeginInfo *info)
+{
+	Recorded *r = rec(cmd);
+	r->reset();
+	r->flags = info->flags;
+	if (info->pInheritanceInfo != NULL) {
+		r->inherited_framebuffer = info->pInheritanceInfo->framebuffer;
+	}
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+end_command_buffer(VkCommandBuffer cmd)
+{
+	rec(cmd)->ended = true;
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+allocate_descriptor_sets(VkDevice, const VkDescriptorSetAllocateInfo *info, VkDescriptorSet *out_sets)
+{
+	for (uint32_t i = 0; i < info->descriptorSetCount; i++) {
+		out_sets[i] = fake_handle<VkDescriptorSet>();
+	}
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL
+update_descriptor_sets(VkDevice, uint32_t, const VkWriteDescriptorSet *, uint32_t, const VkCopyDescriptorSet *)
+{}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+reset_descriptor_pool(VkDevice, VkDescriptorPool, VkDescriptorPoolResetFlags)
+{
+	return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL
+cmd_begin_render_pass(VkCommandBuffer cmd, const VkRenderPassBeginInfo *, VkSubpassContents contents)
+{
+	spend_cmd_cost();
+	if (contents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS) {
+		rec(cmd)->secondary_passes++;
+	} else {
+		rec(cmd)->inline_passes++;
+	}
+}
+
+VKAPI_ATTR void VKAPI_CALL
+cmd_end_render_pass(VkCommandBuffer)
+{
+	spend_cmd_cost();
+}
+
+VKAPI_ATTR void VKAPI_CALL
+cmd_set_viewport(VkCommandBuffer cmd, uint32_t, uint32_t, const VkViewport *)
+{
+	spend_cmd_cost();
+	rec(cmd)->viewports++;
+}
+
+VKAPI_ATTR void VKAPI_CALL
+cmd_set_scissor(VkCommandBuffer, uint32_t, uint32_t, const VkRect2D *)
+{
+	spend_cmd_cost();
+}
+
+VKAPI_ATTR void VKAPI_CALL
+cmd_bind_descriptor_sets(VkCommandBuffer,
+                         VkPipelineBindPoint,
+                         VkPipelineLayout,
+                         uint32_t,
+                         uint32_t,
+                         const VkDescriptorSet *,
+                         uint32_t,
+                         const uint32_t *)
+{
+	spend_cmd_cost();
+}
+
+VKAPI_ATTR void VKAPI_CALL
+cmd_bind_pipeline(VkCommandBuffer, VkPipelineBindPoint, VkPipeline)
+{
+	spend_cmd_cost();
+}
+
+VKAPI_ATTR void VKAPI_CALL
+cmd_draw(VkCommandBuffer cmd, uint32_t, uint32_t, uint32_t, uint32_t)
+{
+	spend_cmd_cost();
+	rec(cmd)->draws++;
+}
+
+VKAPI_ATTR void VKAPI_CALL
+cmd_execute_commands(VkCommandBuffer cmd, uint32_t count, const VkCommandBuffer *cmds)
+{
+	spend_cmd_cost();
+	for (uint32_t i = 0; i < count; i++) {
+		rec(cmd)->executed.push_back(cmds[i]);
+	}
+}
+
+VKAPI_ATTR void VKAPI_CALL
+cmd_reset_query_pool(VkCommandBuffer, VkQueryPool, uint32_t, uint32_t)
+{}
+
+VKAPI_ATTR void VKAPI_CALL
+cmd_write_timestamp(VkCommandBuffer cmd, VkPipelineStageFlagBits, VkQueryPool, uint32_t query)
+{
+	rec(cmd)->timestamps.push_back(query);
+}
+
+VKAPI_ATTR void VKAPI_CALL
+cmd_pipeline_barrier(VkCommandBuffer,
+                     VkPipelineStageFlags,
+                     VkPipelineStageFlags,
+                     VkDependencyFlags,
+                     uint32_t,
+                     const VkMemoryBarrier *,
+                     uint32_t,
+                     const VkBufferMemoryBarrier *,
+                     uint32_t,
+                     const VkImageMemoryBarrier *)
+{}
+
+
+/*
+ *
+ * Fixture.
+ *
+ */
+
+//! Just enough resources for @ref comp_render_gfx_layers to record quads.
+struct Fixture
+{
+	vk_bundle vk = {};
+	std::unique_ptr<render_resources> r = std::make_unique<render_resources>();
+	std::vector<uint8_t> ubo_memory = std::vector<uint8_t>(1024 * 1024);
+	Recorded primary = {};
+
+	render_gfx_render_pass rgrp = {};
+	render_gfx_target_resources rtrs[kViewCount] = {};
+
+	std::unique_ptr<struct comp_swapchain> sc = std::make_unique<struct comp_swapchain>();
+	VkImageView layer_views[1] = {};
+	comp_layer layers[kLayerCount] = {};
+	comp_render_dispatch_data d = {};
+
+	Fixture()
+	{
+		{
+			std::lock_guard<std::mutex> lock(device.mutex);
+			device.secondaries.clear();
+		}
+		device.parallel_pool_resets = 0;
+		device.cmd_cost_ns = 0;
+		device.main_pool = fake_handle<VkCommandPool>();
+
+		vk.log_level = U_LOGGING_WARN;
+		vk.device = fake_handle<VkDevice>();
+		vk.vkCreateCommandPool = create_command_pool;
+		vk.vkDestroyCommandPool = destroy_command_pool;
+		vk.vkResetCommandPool = reset_command_pool;
+		vk.vkAllocateCommandBuffers = allocate_command_buffers;
+		vk.vkBeginCommandBuffer = begin_command_buffer;
+		vk.vkEndCommandBuffer = end_command_buffer;
+		vk.vkAllocateDescriptorSets = allocate_descriptor_sets;
+		vk.vkUpdateDescriptorSets = update_descriptor_sets;
+		vk.vkResetDescriptorPool = reset_descriptor_pool;
+		vk.vkCmdBeginRenderPass = cmd_begin_render_pass;
+		vk.vkCmdEndRenderPass = cmd_end_render_pass;
+		vk.vkCmdSetViewport = cmd_set_viewport;
+		vk.vkCmdSetScissor = cmd_set_scissor;
+		vk.vkCmdBindDescriptorSets = cmd_bind_descriptor_sets;
+		vk.vkCmdBindPipeline = cmd_bind_pipeline;
+		vk.vkCmdDraw = cmd_draw;
+		vk.vkCmdExecuteCommands = cmd_execute_commands;
+		vk.vkCmdResetQueryPool = cmd_reset_query_pool;
+		vk.vkCmdWriteTimestamp = cmd_write_timestamp;
+		vk.vkCmdPipelineBarrier = cmd_pipeline_barrier;
+
+		r->vk = &vk;
+		r->view_count = kViewCount;
+		r->cmd_pool = device.main_pool;
+		r->cmd = to_cmd(&primary);
+		r->query_pool = fake_handle<VkQueryPool>();
+		r->gfx.shared_ubo.buffer = fake_handle<VkBuffer>();
+		r->gfx.shared_ubo.size = ubo_memory.size();
+		r->gfx.shared_ubo.mapped = ubo_memory.data();
+		r->gfx.ubo_and_src_descriptor_pool = fake_handle<VkDescriptorPool>();
+		r->gfx.layer.shared.descriptor_set_layout = fake_handle<VkDescriptorSetLayout>();
+		r->gfx.layer.shared.pipeline_layout = fake_handle<VkPipelineLayout>();
+		r->samplers.clamp_to_edge = fake_handle<VkSampler>();
+		r->samplers.clamp_to_border_black = fake_handle<VkSampler>();
+
+		rgrp.r = r.get();
+		rgrp.render_pass = fake_handle<VkRenderPass>();
+		rgrp.layer.quad_premultiplied_alpha = fake_handle<VkPipeline>();
+		rgrp.layer.quad_unpremultiplied_alpha = fake_handle<VkPipeline>();
+
+		layer_views[0] = fake_handle<VkImageView>();
+		sc->images[0].views.alpha = layer_views;
+		sc->images[0].views.no_alpha = layer_views;
+		sc->images[0].array_size = 1;
+
+		for (uint32_t i = 0; i < kLayerCount; i++) {
+			xrt_layer_data &data = layers[i].data;
+			data.type = XRT_LAYER_QUAD;
+			data.quad.visibility = XRT_LAYER_EYE_VISIBILITY_BOTH;
+			data.quad.pose.orientation.w = 1.0f;
+			data.quad.pose.position.z = -1.0f - (float)i;
+			data.quad.size = {1.0f, 1.0f};
+			data.quad.sub.norm_rect = {0.0f, 0.0f, 1.0f, 1.0f};
+			layers[i].sc_array[0] = &sc->base.base;
+		}
+
+		comp_render_gfx_initial_init(&d, &rtrs[0], false, false);
+
+		for (uint32_t view = 0; view < kViewCount; view++) {
+			rtrs[view].r = r.get();
+			rtrs[view].rgrp = &rgrp;
+			rtrs[view].framebuffer = fake_handle<VkFramebuffer>();
+			rtrs[view].extent = {1024, 1024};
+
+			xrt_pose pose = XRT_POSE_IDENTITY;
+			pose.position.x = view == 0 ? -0.03f : 0.03f;
+			xrt_fov fov = {-0.8f, 0.8f, 0.8f, -0.8f};
+			render_viewport_data viewport = {0, 0, 1024, 1024};
+			xrt_normalized_rect rect = {0.0f, 0.0f, 1.0f, 1.0f};
+			xrt_matrix_2x2 rot = {{1.0f, 0.0f, 0.0f, 1.0f}};
+
+			comp_render_gfx_add_view(       //
+			    &d,                         //
+			    &pose,                      // world_pose
+			    &pose,                      // eye_pose
+			    &fov,                       //
+			    &rtrs[view],                //
+			    &viewport,                  // layer_viewport_data
+			    &rect,                      // layer_norm_rect
+			    fake_handle<VkImage>(),     // image
+			    fake_handle<VkImageView>(), // srgb_view
+			    &rot,                       // vertex_rot
+			    &viewport);                 // target_viewport_data
+		}
+	}
+
+	~Fixture()
+	{
+		render_resources_parallel_fini(r.get());
+	}
+
+	//! Records one frame of layer squashing like the renderer does.
+	bool
+	frame()
+	{
+		struct render_gfx render = {};
+		render_gfx_init(&render, r.get());
+
+		if (!render_gfx_begin(&render)) {
+			return false;
+		}
+
+		comp_render_gfx_layers(&render, layers, kLayerCount, &d, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+		bool ok = render_gfx_end(&render);
+		render_gfx_fini(&render);
+
+		return ok;
+	}
+
+	void
+	enable_timing()
+	{
+		r->timing.enabled = true;
+		r->timing.query_pool = fake_handle<VkQueryPool>();
+		r->timing.max_scopes = RENDER_TIMING_MAX_SCOPES;
+	}
+};
+
+} // namespace
+
+
+TEST_CASE("comp_render_gfx_parallel")
+{
+	Fixture f;
+
+	SECTION("without workers every view is recorded inline")
+	{
+		REQUIRE(f.frame());
+
+		CHECK(f.primary.ended);
+		CHECK(f.primary.inline_passes == (int)kViewCount);
+		CHECK(f.primary.secondary_passes == 0);
+		CHECK(f.primary.draws == (int)(kViewCount * kLayerCount));
+		CHECK(f.primary.executed.empty());
+	}
+
+	SECTION("with workers each view is one secondary")
+	{
+		REQUIRE(render_resources_parallel_init(f.r.get(), kViewCount));
+		REQUIRE(f.r->parallel.cmd_pool_count == kViewCount);
+		REQUIRE(f.frame());
+
+		CHECK(f.primary.ended);
+		CHECK(f.primary.inline_passes == 0);
+		CHECK(f.primary.secondary_passes == (int)kViewCount);
+		CHECK(f.primary.draws == 0);
+		REQUIRE(f.primary.executed.size() == kViewCount);
+
+		for (uint32_t view = 0; view < kViewCount; view++) {
+			CAPTURE(view);
+			Recorded *sub = rec(f.primary.executed[view]);
+
+			CHECK(sub->secondary);
+			CHECK(sub->ended);
+			CHECK((sub->flags & VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT) != 0);
+			CHECK(sub->inherited_framebuffer == f.rtrs[view].framebuffer);
+			CHECK(sub->viewports == 1);
+			CHECK(sub->draws == (int)kLayerCount);
+		}
+
+		CHECK(f.primary.executed[0] != f.primary.executed[1]);
+	}
+
+	SECTION("secondaries are freed by the next frame")
+	{
+		REQUIRE(render_resources_parallel_init(f.r.get(), kViewCount));
+
+		REQUIRE(f.frame());
+		CHECK(device.parallel_pool_resets == (int)kViewCount);
+		CHECK(device.secondaries.size() == kViewCount);
+
+		REQUIRE(f.frame());
+		CHECK(device.parallel_pool_resets == (int)(2 * kViewCount));
+		CHECK(device.secondaries.size() == kViewCount);
+	}
+
+	SECTION("timing scopes stay in view order")
+	{
+		f.enable_timing();
+		REQUIRE(render_resources_parallel_init(f.r.get(), kViewCount));
+		REQUIRE(f.frame());
+
+		REQUIRE(f.r->timing.scope_count == kViewCount * kLayerCount);
+		REQUIRE(f.primary.executed.size() == kViewCount);
+
+		for (uint32_t view = 0; view < kViewCount; view++) {
+			CAPTURE(view);
+			Recorded *sub = rec(f.primary.executed[view]);
+
+			std::vector<uint32_t> expected;
+			for (uint32_t i = 0; i < kLayerCount; i++) {
+				uint32_t scope = view * kLayerCount + i;
+				CHECK(f.r->timing.scopes[scope].pass == RENDER_TIMING_PASS_LAYERS);
+				CHECK(f.r->timing.scopes[scope].layer_index == i);
+
+				expected.push_back(scope * 2);
+				expected.push_back(scope * 2 + 1);
+			}
+
+			CHECK(sub->timestamps == expected);
+		}
+	}
+
+	SECTION("too few pools falls back to inline")
+	{
+		REQUIRE(render_resources_parallel_init(f.r.get(), 1));
+		CHECK(f.r->parallel.group == NULL);
+		REQUIRE(f.frame());
+
+		CHECK(f.primary.inline_passes == (int)kViewCount);
+		CHECK(f.primary.executed.empty());
+	}
+}
+
+TEST_CASE("comp_render_gfx_parallel_benchmark", "[.][benchmark]")
+{
+	// Roughly what a desktop driver spends per recorded command.
+	constexpr uint64_t kCmdCostNs = 2'000;
+
+	SECTION("inline")
+	{
+		Fixture f;
+		device.cmd_cost_ns = kCmdCostNs;
+
+		BENCHMARK("layer squashing CPU time per frame, inline")
+		{
+			return f.frame();
+		};
+	}
+
+	SECTION("parallel")
+	{
+		Fixture f;
+		REQUIRE(render_resources_parallel_init(f.r.get(), kViewCount));
+		device.cmd_cost_ns = kCmdCostNs;
+
+		BENCHMARK("layer squashing CPU time per frame, parallel")
+		{
+			return f.frame();
+		};
+	}
+}
@@ -0,0 +1,280 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Swapchain image pool tests.
+ */
+
+#include "util/comp_swapchain_pool.h"
+
+#include "catch_amalgamated.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+
+
+namespace {
+
+//! How many of each object the pool freed, through the stubbed functions.
+struct Freed
+{
+	int images = 0;
+	int memories = 0;
+	int views = 0;
+} freed;
+
+VKAPI_ATTR void VKAPI_CALL
+destroy_image(VkDevice device, VkImage image, const VkAllocationCallbacks *allocator)
+{
+	freed.images++;
+}
+
+VKAPI_ATTR void VKAPI_CALL
+free_memory(VkDevice device, VkDeviceMemory memory, const VkAllocationCallbacks *allocator)
+{
+	freed.memories++;
+}
+
+VKAPI_ATTR void VKAPI_CALL
+destroy_image_view(VkDevice device, VkImageView view, const VkAllocationCallbacks *allocator)
+{
+	freed.views++;
+}
+
+//! Only the functions the pool uses to free things, no real device.
+vk_bundle
+make_vk()
+{
+	vk_bundle vk = {};
+	vk.vkDestroyImage = destroy_image;
+	vk.vkFreeMemory = free_memory;
+	vk.vkDestroyImageView = destroy_image_view;
+	freed = {};
+	return vk;
+}
+
+constexpr VkDeviceSize MB = 1024 * 1024;
+
+xrt_swapchain_create_info
+make_info(uint32_t width)
+{
+	xrt_swapchain_create_info info = {};
+	info.bits = (xrt_swapchain_usage_bits)(XRT_SWAPCHAIN_USAGE_COLOR | XRT_SWAPCHAIN_USAGE_SAMPLED);
+	info.format = 43; // VK_FORMAT_R8G8B8A8_SRGB
+	info.sample_count = 1;
+	info.width = width;
+	info.height = 1024;
+	info.face_count = 1;
+	info.array_size = 1;
+	info.mip_count = 1;
+	return info;
+}
+
+//! Fake images with non-null handles, @p id tells entries apart.
+comp_swapchain_pool_entry
+make_entry(const xrt_swapchain_create_info &info, uint32_t image_count, VkDeviceSize image_size, uintptr_t id)
+{
+	comp_swapchain_pool_entry entry = {};
+	entry.vkic.info = info;
+	entry.vkic.image_count = image_count;
+	entry.array_size = info.array_size;
+
+	for (uint32_t i = 0; i < image_count; i++) {
+		entry.vkic.images[i].handle = (VkImage)(id * 16 + i + 1);
+		entry.vkic.images[i].memory = (VkDeviceMemory)(id * 16 + i + 1);
+		entry.vkic.images[i].size = image_size;
+		entry.size += image_size;
+
+		entry.views[i].alpha = static_cast<VkImageView *>(calloc(info.array_size, sizeof(VkImageView)));
+		entry.views[i].no_alpha = static_cast<VkImageView *>(calloc(info.array_size, sizeof(VkImageView)));
+		for (uint32_t layer = 0; layer < info.array_size; layer++) {
+			entry.views[i].alpha[layer] = (VkImageView)(id * 16 + i + 1);
+			entry.views[i].no_alpha[layer] = (VkImageView)(id * 16 + i + 1);
+		}
+	}
+
+	return entry;
+}
+
+comp_swapchain_pool_stats
+get_stats(comp_swapchain_pool &pool)
+{
+	comp_swapchain_pool_stats stats;
+	comp_swapchain_pool_get_stats(&pool, &stats);
+	return stats;
+}
+
+} // namespace
+
+
+TEST_CASE("comp_swapchain_pool")
+{
+	vk_bundle vk = make_vk();
+	comp_swapchain_pool pool;
+	comp_swapchain_pool_init(&pool, 16 * MB);
+
+	const xrt_swapchain_create_info info = make_info(1024);
+
+	SECTION("empty pool misses")
+	{
+		comp_swapchain_pool_entry entry;
+		CHECK_FALSE(comp_swapchain_pool_take(&pool, &info, 3, &entry));
+		CHECK(get_stats(pool).misses == 1);
+		CHECK(get_stats(pool).hits == 0);
+	}
+
+	SECTION("same info and image count hits")
+	{
+		comp_swapchain_pool_entry given = make_entry(info, 3, 1 * MB, 1);
+		CHECK(comp_swapchain_pool_give(&pool, &vk, &given));
+
+		// Ownership moved to the pool.
+		CHECK(given.vkic.image_count == 0);
+		CHECK(given.views[0].alpha == nullptr);
+		CHECK(get_stats(pool).recycled == 1);
+		CHECK(get_stats(pool).bytes == 3 * MB);
+		CHECK(get_stats(pool).entry_count == 1);
+
+		comp_swapchain_pool_entry entry;
+		REQUIRE(comp_swapchain_pool_take(&pool, &info, 3, &entry));
+		CHECK(entry.vkic.images[0].handle == (VkImage)17);
+		CHECK(entry.views[2].no_alpha[0] == (VkImageView)19);
+		CHECK(entry.array_size == 1);
+		CHECK(get_stats(pool).hits == 1);
+		CHECK(get_stats(pool).bytes == 0);
+		CHECK(get_stats(pool).entry_count == 0);
+
+		// Nothing was freed on the way.
+		CHECK(freed.images == 0);
+		CHECK(freed.views == 0);
+
+		comp_swapchain_pool_entry_destroy(&vk, &entry);
+		CHECK(freed.images == 3);
+		CHECK(freed.memories == 3);
+		CHECK(freed.views == 6);
+	}
+
+	SECTION("different info or image count misses")
+	{
+		comp_swapchain_pool_entry given = make_entry(info, 3, 1 * MB, 1);
+		comp_swapchain_pool_give(&pool, &vk, &given);
+
+		const xrt_swapchain_create_info other = make_info(2048);
+
+		comp_swapchain_pool_entry entry;
+		CHECK_FALSE(comp_swapchain_pool_take(&pool, &other, 3, &entry));
+		CHECK_FALSE(comp_swapchain_pool_take(&pool, &info, 2, &entry));
+		CHECK(get_stats(pool).misses == 2);
+		CHECK(get_stats(pool).entry_count == 1);
+	}
+
+	SECTION("least recently given is evicted when over budget")
+	{
+		for (uintptr_t id = 1; id <= 3; id++) {
+			comp_swapchain_pool_entry given = make_entry(make_info(1024 * id), 2, 2 * MB, id);
+			CHECK(comp_swapchain_pool_give(&pool, &vk, &given));
+		}
+		CHECK(get_stats(pool).bytes == 12 * MB);
+
+		// 2MB over budget, only the oldest one has to go.
+		comp_swapchain_pool_entry given = make_entry(make_info(1024 * 4), 2, 3 * MB, 4);
+		CHECK(comp_swapchain_pool_give(&pool, &vk, &given));
+
+		CHECK(get_stats(pool).evicted == 1);
+		CHECK(get_stats(pool).entry_count == 3);
+		CHECK(get_stats(pool).bytes == 14 * MB);
+		CHECK(freed.images == 2);
+		CHECK(freed.memories == 2);
+
+		comp_swapchain_pool_entry entry;
+		CHECK_FALSE(comp_swapchain_pool_take(&pool, &info, 2, &entry));
+
+		const xrt_swapchain_create_info second = make_info(2048);
+		REQUIRE(comp_swapchain_pool_take(&pool, &second, 2, &entry));
+		comp_swapchain_pool_entry_destroy(&vk, &entry);
+	}
+
+	SECTION("too large to keep is freed right away")
+	{
+		comp_swapchain_pool_entry given = make_entry(info, 2, 9 * MB, 1);
+		CHECK_FALSE(comp_swapchain_pool_give(&pool, &vk, &given));
+		CHECK(get_stats(pool).evicted == 1);
+		CHECK(get_stats(pool).entry_count == 0);
+		CHECK(freed.images == 2);
+		CHECK(freed.views == 4);
+	}
+
+	SECTION("fini frees everything held")
+	{
+		for (uintptr_t id = 1; id <= 2; id++) {
+			comp_swapchain_pool_entry given = make_entry(make_info(1024 * id), 3, 1 * MB, id);
+			comp_swapchain_pool_give(&pool, &vk, &given);
+		}
+		CHECK(freed.images == 0);
+		CHECK(pool.entry_count == 2);
+	}
+
+	// Everything given and not taken back is freed.
+	int held_images = 0;
+	for (uint32_t i = 0; i < pool.entry_count; i++) {
+		held_images += (int)pool.entries[i].vkic.image_count;
+	}
+	int freed_before = freed.images;
+
+	comp_swapchain_pool_fini(&pool, &vk);
+
+	CHECK(freed.images == freed_before + held_images);
+	CHECK(freed.memories == freed.images);
+	CHECK(freed.views == freed.images * 2);
+}
+
+TEST_CASE("comp_swapchain_pool_disabled")
+{
+	vk_bundle vk = make_vk();
+	comp_swapchain_pool pool;
+	comp_swapchain_pool_init(&pool, 0);
+
+	const xrt_swapchain_create_info info = make_info(1024);
+
+	comp_swapchain_pool_entry given = make_entry(info, 3, 1 * MB, 1);
+	CHECK_FALSE(comp_swapchain_pool_give(&pool, &vk, &given));
+	CHECK(freed.images == 3);
+	CHECK(freed.views == 6);
+
+	// Not counted as a miss, the pool is not in use.
+	comp_swapchain_pool_entry entry;
+	CHECK_FALSE(comp_swapchain_pool_take(&pool, &info, 3, &entry));
+	CHECK(get_stats(pool).misses == 0);
+	CHECK(get_stats(pool).recycled == 0);
+
+	comp_swapchain_pool_fini(&pool, &vk);
+}
+
+TEST_CASE("comp_swapchain_pool_reference")
+{
+	vk_bundle vk = make_vk();
+	vk.log_level = U_LOGGING_WARN;
+
+	comp_swapchain_pool *pool = nullptr;
+	REQUIRE(comp_swapchain_pool_create(&vk, 16 * MB, &pool) == XRT_SUCCESS);
+	REQUIRE(pool != nullptr);
+
+	const xrt_swapchain_create_info info = make_info(1024);
+	comp_swapchain_pool_entry given = make_entry(info, 3, 1 * MB, 1);
+	CHECK(comp_swapchain_pool_give(pool, &vk, &given));
+
+	// Like a swapchain outliving the client that created the pool.
+	comp_swapchain_pool *swapchain_ref = nullptr;
+	comp_swapchain_pool_reference(&swapchain_ref, pool);
+	comp_swapchain_pool_reference(&pool, nullptr);
+	CHECK(pool == nullptr);
+	CHECK(freed.images == 0);
+	CHECK(get_stats(*swapchain_ref).entry_count == 1);
+
+	// Last reference frees everything held.
+	comp_swapchain_pool_reference(&swapchain_ref, nullptr);
+	CHECK(swapchain_ref == nullptr);
+	CHECK(freed.images == 3);
+	CHECK(freed.memories == 3);
+	CHECK(freed.views == 6);
+}
@@ -0,0 +1,215 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Filter fifo tests, checked against a plain reference scan.
+ */
+
+#include <math/m_filter_fifo.h>
+
+#include "catch_amalgamated.hpp"
+
+#include <vector>
+#include <random>
+
+
+namespace {
+
+struct Sample
+{
+	xrt_vec3 value;
+	uint64_t timestamp_ns;
+};
+
+/*!
+ * What the fifo used to do: walk from the latest sample, skip everything
+ * after @p stop_ns and stop at the first sample before @p start_ns.
+ */
+size_t
+reference_filter(const std::vector<Sample> &pushed, size_t num, uint64_t start_ns, uint64_t stop_ns, xrt_vec3 *out)
+{
+	double x = 0, y = 0, z = 0;
+	size_t count = 0;
+
+	if (start_ns <= stop_ns) {
+		for (size_t i = 0; i < num; i++) {
+			// Samples never pushed are zero at time zero.
+			Sample s = {};
+			if (i < pushed.size()) {
+				s = pushed[pushed.size() - 1 - i];
+			}
+
+			if (s.timestamp_ns > stop_ns) {
+				continue;
+			}
+			if (s.timestamp_ns < start_ns) {
+				break;
+			}
+
+			x += s.value.x;
+			y += s.value.y;
+			z += s.value.z;
+			count++;
+		}
+	}
+
+	if (count > 0) {
+		x /= count;
+		y /= count;
+		z /= count;
+	}
+	*out = {(float)x, (float)y, (float)z};
+
+	return count;
+}
+
+} // namespace
+
+
+TEST_CASE("m_filter_fifo_vec3")
+{
+	const bool prefix_sum = GENERATE(false, true);
+	const size_t num = GENERATE(1, 7, 64, 1000);
+	CAPTURE(prefix_sum, num);
+
+	m_ff_vec3_f32 *ff = nullptr;
+	if (prefix_sum) {
+		m_ff_vec3_f32_alloc_prefix_sum(&ff, num);
+	} else {
+		m_ff_vec3_f32_alloc(&ff, num);
+	}
+	REQUIRE(m_ff_vec3_f32_get_num(ff) == num);
+
+	std::mt19937 rng(1337);
+	std::uniform_real_distribution<float> value(-10.f, 10.f);
+	std::uniform_int_distribution<uint64_t> step(0, 3);
+
+	std::vector<Sample> pushed;
+	uint64_t now = 10;
+
+	for (size_t i = 0; i < num * 5 + 3; i++) {
+		// Steps of zero gives duplicate timestamps.
+		now += step(rng);
+		Sample s = {{value(rng), value(rng), value(rng)}, now};
+		m_ff_vec3_f32_push(ff, &s.value, s.timestamp_ns);
+		pushed.push_back(s);
+
+		xrt_vec3 got = {};
+		uint64_t ts = 0;
+		REQUIRE(m_ff_vec3_f32_get(ff, 0, &got, &ts));
+		CHECK(ts == now);
+		CHECK(got.x == s.value.x);
+		CHECK_FALSE(m_ff_vec3_f32_get(ff, num, &got, &ts));
+
+		uint64_t windows[][2] = {
+		    {now - 5, now},     // Recent samples.
+		    {0, now},           // Everything, including never pushed ones.
+		    {now - 8, now - 2}, // Skip some at the start.
+		    {now + 1, now + 9}, // Empty, in the future.
+		    {now, now - 1},     // Error, start after stop.
+		};
+
+		for (auto &w : windows) {
+			xrt_vec3 expected = {};
+			xrt_vec3 average = {1, 1, 1};
+			size_t expected_count = reference_filter(pushed, num, w[0], w[1], &expected);
+			size_t count = m_ff_vec3_f32_filter(ff, w[0], w[1], &average);
+
+			CAPTURE(i, w[0], w[1]);
+			REQUIRE(count == expected_count);
+			CHECK(average.x == Catch::Approx(expected.x).margin(1e-4));
+			CHECK(average.y == Catch::Approx(expected.y).margin(1e-4));
+			CHECK(average.z == Catch::Approx(expected.z).margin(1e-4));
+		}
+	}
+
+	m_ff_vec3_f32_free(&ff);
+	CHECK(ff == nullptr);
+}
+
+TEST_CASE("m_filter_fifo_f64")
+{
+	const bool prefix_sum = GENERATE(false, true);
+	CAPTURE(prefix_sum);
+
+	m_ff_f64 *ff = nullptr;
+	if (prefix_sum) {
+		m_ff_f64_alloc_prefix_sum(&ff, 16);
+	} else {
+		m_ff_f64_alloc(&ff, 16);
+	}
+
+	double average = 1;
+	CHECK(m_ff_f64_filter(ff, 1, 100, &average) == 0);
+	CHECK(average == 0);
+
+	// Fill past one lap so the window straddles the end of the ring.
+	for (uint64_t t = 1; t <= 40; t++) {
+		double v = (double)t;
+		m_ff_f64_push(ff, &v, t * 10);
+	}
+
+	// Samples 30..40 inclusive.
+	CHECK(m_ff_f64_filter(ff, 300, 400, &average) == 11);
+	CHECK(average == Catch::Approx(35.0));
+
+	// Only the oldest sample still in the fifo.
+	CHECK(m_ff_f64_filter(ff, 0, 250, &average) == 1);
+	CHECK(average == Catch::Approx(25.0));
+
+	double sample = 0;
+	uint64_t ts = 0;
+	REQUIRE(m_ff_f64_get(ff, 15, &sample, &ts));
+	CHECK(sample == 25.0);
+	CHECK(ts == 250);
+
+	m_ff_f64_free(&ff);
+}
+
+TEST_CASE("m_filter_fifo_benchmark", "[.][benchmark]")
+{
+	const size_t num = 1000;
+	const uint64_t period_ns = 1000 * 1000; // 1kHz IMU.
+
+	m_ff_vec3_f32 *plain = nullptr;
+	m_ff_vec3_f32 *prefix = nullptr;
+	m_ff_vec3_f32_alloc(&plain, num);
+	m_ff_vec3_f32_alloc_prefix_sum(&prefix, num);
+
+	uint64_t now = 0;
+	for (size_t i = 0; i < num + num / 2; i++) {
+		xrt_vec3 v = {(float)i, 9.81f, -(float)i};
+		now += period_ns;
+		m_ff_vec3_f32_push(plain, &v, now);
+		m_ff_vec3_f32_push(prefix, &v, now);
+	}
+
+	xrt_vec3 average;
+
+	BENCHMARK("filter 300ms window")
+	{
+		return m_ff_vec3_f32_filter(plain, now - 300 * period_ns, now, &average);
+	};
+
+	BENCHMARK("filter 300ms window, prefix sum")
+	{
+		return m_ff_vec3_f32_filter(prefix, now - 300 * period_ns, now, &average);
+	};
+
+	BENCHMARK("push")
+	{
+		xrt_vec3 v = {1, 2, 3};
+		m_ff_vec3_f32_push(plain, &v, ++now);
+		return now;
+	};
+
+	BENCHMARK("push, prefix sum")
+	{
+		xrt_vec3 v = {1, 2, 3};
+		m_ff_vec3_f32_push(prefix, &v, ++now);
+		return now;
+	};
+
+	m_ff_vec3_f32_free(&plain);
+	m_ff_vec3_f32_free(&prefix);
+}
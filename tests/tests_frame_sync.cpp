@@ -0,0 +1,202 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Frame set matching of the sync sink.
+ */
+
+#include "catch_amalgamated.hpp"
+
+#include <util/u_sink.h>
+#include <util/u_time.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+struct ReceivedSet
+{
+	int64_t timestamp;
+	int64_t skew_ns;
+	std::vector<int64_t> frame_timestamps;
+};
+
+struct CollectingSink
+{
+	xrt_frame_set_sink base = {};
+	std::mutex mutex;
+	std::vector<ReceivedSet> sets;
+
+	CollectingSink()
+	{
+		base.push_frame_set = push;
+	}
+
+	static void
+	push(xrt_frame_set_sink *xfss, xrt_frame_set *set)
+	{
+		auto *self = reinterpret_cast<CollectingSink *>(xfss);
+
+		ReceivedSet r{set->timestamp, set->skew_ns, {}};
+		for (uint32_t i = 0; i < set->frame_count; i++) {
+			r.frame_timestamps.push_back(set->frames[i]->timestamp);
+		}
+
+		std::lock_guard<std::mutex> lock(self->mutex);
+		self->sets.push_back(r);
+	}
+
+	size_t
+	count()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return sets.size();
+	}
+
+	//! The sets are pushed on the sync sink's thread.
+	bool
+	wait_for(size_t n)
+	{
+		for (int i = 0; i < 1000 && count() < n; i++) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return count() == n;
+	}
+};
+
+std::atomic<int> created_frames{0};
+std::atomic<int> destroyed_frames{0};
+
+void
+destroy_frame(xrt_frame *xf)
+{
+	destroyed_frames++;
+	delete xf;
+}
+
+void
+push_frame(xrt_frame_sink *xfs, int64_t timestamp)
+{
+	xrt_frame *xf = new xrt_frame{};
+	created_frames++;
+	xf->destroy = destroy_frame;
+	xf->timestamp = timestamp;
+
+	xrt_frame *ref = nullptr;
+	xrt_frame_reference(&ref, xf);
+	xrt_sink_push_frame(xfs, ref);
+	xrt_frame_reference(&ref, nullptr);
+}
+
+constexpr int64_t us = U_TIME_1MS_IN_NS / 1000;
+constexpr int64_t frame_period_ns = 16 * U_TIME_1MS_IN_NS;
+
+} // namespace
+
+
+TEST_CASE("frame_sync")
+{
+	created_frames = 0;
+	destroyed_frames = 0;
+
+	xrt_frame_context xfctx = {};
+	CollectingSink collector;
+	xrt_frame_sink *inputs[3] = {};
+
+	REQUIRE(u_sink_sync_create(&xfctx, 3, U_TIME_1MS_IN_NS, &collector.base, inputs));
+
+	SECTION("matches frames within the tolerance")
+	{
+		const int64_t offsets[3] = {0, 300 * us, -600 * us};
+
+		for (int round = 0; round < 10; round++) {
+			const int64_t base = (round + 1) * frame_period_ns;
+
+			// Cameras arrive in any order.
+			push_frame(inputs[2], base + offsets[2]);
+			push_frame(inputs[0], base + offsets[0]);
+			push_frame(inputs[1], base + offsets[1]);
+
+			REQUIRE(collector.wait_for(round + 1));
+		}
+
+		for (int round = 0; round < 10; round++) {
+			const int64_t base = (round + 1) * frame_period_ns;
+			const ReceivedSet &r = collector.sets[round];
+
+			// In camera order, not arrival order, and untouched.
+			REQUIRE(r.frame_timestamps.size() == 3);
+			CHECK(r.frame_timestamps[0] == base + offsets[0]);
+			CHECK(r.frame_timestamps[1] == base + offsets[1]);
+			CHECK(r.frame_timestamps[2] == base + offsets[2]);
+
+			CHECK(r.timestamp == base + (offsets[0] + offsets[1] + offsets[2]) / 3);
+			CHECK(r.skew_ns == 900 * us);
+		}
+
+		u_sink_sync_stats stats;
+		u_sink_sync_get_stats(inputs[1], &stats);
+		CHECK(stats.sets == 10);
+		CHECK(stats.dropped_frames == 0);
+		CHECK(stats.dropped_sets == 0);
+		CHECK(stats.last_skew_ns == 900 * us);
+		CHECK(stats.max_skew_ns == 900 * us);
+		CHECK(stats.mean_skew_ns == Catch::Approx(900.0 * us));
+	}
+
+	SECTION("drops frames that can not be matched")
+	{
+		// Round 1 is missing camera 1.
+		push_frame(inputs[0], 1 * frame_period_ns);
+		push_frame(inputs[2], 1 * frame_period_ns);
+
+		push_frame(inputs[0], 2 * frame_period_ns);
+		push_frame(inputs[1], 2 * frame_period_ns);
+		push_frame(inputs[2], 2 * frame_period_ns);
+		REQUIRE(collector.wait_for(1));
+
+		// Camera 2 is too far off.
+		push_frame(inputs[0], 3 * frame_period_ns);
+		push_frame(inputs[1], 3 * frame_period_ns);
+		push_frame(inputs[2], 3 * frame_period_ns + 2 * U_TIME_1MS_IN_NS);
+
+		push_frame(inputs[0], 4 * frame_period_ns);
+		push_frame(inputs[1], 4 * frame_period_ns);
+		push_frame(inputs[2], 4 * frame_period_ns);
+		REQUIRE(collector.wait_for(2));
+
+		CHECK(collector.sets[0].timestamp == 2 * frame_period_ns);
+		CHECK(collector.sets[1].timestamp == 4 * frame_period_ns);
+
+		u_sink_sync_stats stats;
+		u_sink_sync_get_stats(inputs[0], &stats);
+		CHECK(stats.sets == 2);
+		CHECK(stats.dropped_frames == 5);
+		CHECK(stats.max_skew_ns == 0);
+	}
+
+	SECTION("a camera running ahead is bounded")
+	{
+		for (int i = 0; i < 20; i++) {
+			push_frame(inputs[0], (i + 1) * frame_period_ns);
+		}
+
+		// Nothing matched yet, only the newest frames are held.
+		CHECK(collector.count() == 0);
+		CHECK(destroyed_frames == 20 - 4);
+
+		u_sink_sync_stats stats;
+		u_sink_sync_get_stats(inputs[0], &stats);
+		CHECK(stats.dropped_frames == 20 - 4);
+	}
+
+	xrt_frame_context_destroy_nodes(&xfctx);
+
+	// Every reference was released, nothing leaked.
+	CHECK(destroyed_frames == created_frames);
+}
@@ -0,0 +1,226 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Structure of arrays hand joint kernel tests and benchmark.
+ */
+
+#include "catch_amalgamated.hpp"
+
+#include <math/m_api.h>
+#include <math/m_space.h>
+#include <math/m_hand_joints.h>
+
+#include <random>
+
+
+using Catch::Approx;
+
+namespace {
+
+const uint32_t all_flags[] = {
+    XRT_SPACE_RELATION_ORIENTATION_VALID_BIT,     XRT_SPACE_RELATION_POSITION_VALID_BIT,
+    XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT, XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT,
+    XRT_SPACE_RELATION_ORIENTATION_TRACKED_BIT,   XRT_SPACE_RELATION_POSITION_TRACKED_BIT,
+};
+
+xrt_space_relation
+random_relation(std::mt19937 &rng, bool all_valid)
+{
+	std::uniform_real_distribution<float> dist(-1.f, 1.f);
+	std::uniform_int_distribution<int> coin(0, 3);
+
+	xrt_space_relation r = {};
+	r.pose.position = {dist(rng), dist(rng), dist(rng)};
+	r.pose.orientation = {dist(rng), dist(rng), dist(rng), dist(rng)};
+	math_quat_normalize(&r.pose.orientation);
+	r.linear_velocity = {dist(rng), dist(rng), dist(rng)};
+	r.angular_velocity = {dist(rng), dist(rng), dist(rng)};
+
+	uint32_t flags = 0;
+	for (uint32_t f : all_flags) {
+		if (all_valid || coin(rng) != 0) {
+			flags |= f;
+		}
+	}
+	r.relation_flags = (xrt_space_relation_flags)flags;
+
+	return r;
+}
+
+xrt_hand_joint_set
+random_set(std::mt19937 &rng, bool all_valid)
+{
+	std::uniform_real_distribution<float> radius(0.001f, 0.02f);
+
+	xrt_hand_joint_set set = {};
+	for (auto &v : set.values.hand_joint_set_default) {
+		v.relation = random_relation(rng, all_valid);
+		v.radius = radius(rng);
+	}
+	set.is_active = true;
+
+	return set;
+}
+
+void
+check_relation(const xrt_space_relation &expected, const xrt_space_relation &actual)
+{
+	const float margin = 1e-5f;
+
+	CHECK(expected.relation_flags == actual.relation_flags);
+	CHECK(expected.pose.position.x == Approx(actual.pose.position.x).margin(margin));
+	CHECK(expected.pose.position.y == Approx(actual.pose.position.y).margin(margin));
+	CHECK(expected.pose.position.z == Approx(actual.pose.position.z).margin(margin));
+	CHECK(expected.pose.orientation.x == Approx(actual.pose.orientation.x).margin(margin));
+	CHECK(expected.pose.orientation.y == Approx(actual.pose.orientation.y).margin(margin));
+	CHECK(expected.pose.orientation.z == Approx(actual.pose.orientation.z).margin(margin));
+	CHECK(expected.pose.orientation.w == Approx(actual.pose.orientation.w).margin(margin));
+	CHECK(expected.linear_velocity.x == Approx(actual.linear_velocity.x).margin(margin));
+	CHECK(expected.linear_velocity.y == Approx(actual.linear_velocity.y).margin(margin));
+	CHECK(expected.linear_velocity.z == Approx(actual.linear_velocity.z).margin(margin));
+	CHECK(expected.angular_velocity.x == Approx(actual.angular_velocity.x).margin(margin));
+	CHECK(expected.angular_velocity.y == Approx(actual.angular_velocity.y).margin(margin));
+	CHECK(expected.angular_velocity.z == Approx(actual.angular_velocity.z).margin(margin));
+}
+
+xrt_space_relation
+resolve(const xrt_space_relation &joint, const xrt_space_relation &base)
+{
+	xrt_space_relation result;
+	xrt_relation_chain xrc = {};
+	m_relation_chain_push_relation(&xrc, &joint);
+	m_relation_chain_push_relation(&xrc, &base);
+	m_relation_chain_resolve(&xrc, &result);
+	return result;
+}
+
+} // namespace
+
+
+TEST_CASE("hand_joints_soa_round_trip")
+{
+	std::mt19937 rng(26);
+	xrt_hand_joint_set set = random_set(rng, false);
+
+	m_hand_joints_soa joints;
+	m_hand_joints_soa_from_set(&set, &joints);
+
+	for (uint32_t i = 0; i < XRT_HAND_JOINT_COUNT; i++) {
+		xrt_space_relation r;
+		float radius;
+		m_hand_joints_soa_get(&joints, i, &r, &radius);
+
+		const xrt_hand_joint_value &v = set.values.hand_joint_set_default[i];
+		CHECK(radius == v.radius);
+		CHECK(memcmp(&r, &v.relation, sizeof(r)) == 0);
+	}
+
+	for (uint32_t i = XRT_HAND_JOINT_COUNT; i < M_HAND_JOINTS_SOA_LANES; i++) {
+		CHECK(joints.flags[i] == 0);
+		CHECK(joints.radius[i] == 0.0f);
+	}
+}
+
+TEST_CASE("hand_joints_soa_transform_matches_chain")
+{
+	std::mt19937 rng(0xc4a1);
+
+	for (int iter = 0; iter < 2000; iter++) {
+		// Mix of fully valid and random flags on both sides.
+		xrt_hand_joint_set set = random_set(rng, iter % 2 == 0);
+		xrt_space_relation base = random_relation(rng, iter % 3 == 0);
+
+		m_hand_joints_soa joints;
+		m_hand_joints_soa_from_set(&set, &joints);
+		m_hand_joints_soa_transform(&base, &joints);
+
+		// A base without any pose zeroes the joints, radius included.
+		const bool base_has_pose = (base.relation_flags & (XRT_SPACE_RELATION_ORIENTATION_VALID_BIT |
+		                                                   XRT_SPACE_RELATION_POSITION_VALID_BIT)) != 0;
+
+		for (uint32_t i = 0; i < XRT_HAND_JOINT_COUNT; i++) {
+			xrt_space_relation expected = resolve(set.values.hand_joint_set_default[i].relation, base);
+
+			xrt_space_relation actual;
+			float radius;
+			m_hand_joints_soa_get(&joints, i, &actual, &radius);
+
+			check_relation(expected, actual);
+			CHECK(radius == (base_has_pose ? set.values.hand_joint_set_default[i].radius : 0.0f));
+		}
+	}
+}
+
+TEST_CASE("hand_joints_soa_transform_special_cases")
+{
+	std::mt19937 rng(3);
+	xrt_hand_joint_set set = random_set(rng, true);
+
+	// Joints without any pose become zero relations.
+	set.values.hand_joint_set_default[0].relation.relation_flags = XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT;
+
+	// Orientation only joints get a zero position.
+	set.values.hand_joint_set_default[1].relation.relation_flags = XRT_SPACE_RELATION_ORIENTATION_VALID_BIT;
+
+	SECTION("orientation only base")
+	{
+		xrt_space_relation base = random_relation(rng, true);
+		base.relation_flags = XRT_SPACE_RELATION_ORIENTATION_VALID_BIT;
+
+		m_hand_joints_soa joints;
+		m_hand_joints_soa_from_set(&set, &joints);
+		m_hand_joints_soa_transform(&base, &joints);
+
+		for (uint32_t i = 0; i < XRT_HAND_JOINT_COUNT; i++) {
+			xrt_space_relation actual;
+			m_hand_joints_soa_get(&joints, i, &actual, nullptr);
+			check_relation(resolve(set.values.hand_joint_set_default[i].relation, base), actual);
+		}
+
+		CHECK(joints.flags[0] == 0);
+	}
+
+	SECTION("base without pose")
+	{
+		xrt_space_relation base = random_relation(rng, true);
+		base.relation_flags = XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT;
+
+		m_hand_joints_soa joints;
+		m_hand_joints_soa_from_set(&set, &joints);
+		m_hand_joints_soa_transform(&base, &joints);
+
+		for (uint32_t i = 0; i < XRT_HAND_JOINT_COUNT; i++) {
+			xrt_space_relation actual;
+			float radius;
+			m_hand_joints_soa_get(&joints, i, &actual, &radius);
+			check_relation(resolve(set.values.hand_joint_set_default[i].relation, base), actual);
+			CHECK(actual.relation_flags == 0);
+			CHECK(radius == 0.0f);
+		}
+	}
+}
+
+TEST_CASE("hand_joints_benchmark", "[.][benchmark]")
+{
+	std::mt19937 rng(1);
+	xrt_hand_joint_set set = random_set(rng, true);
+	xrt_space_relation base = random_relation(rng, true);
+
+	BENCHMARK("relation chain per joint")
+	{
+		xrt_space_relation out[XRT_HAND_JOINT_COUNT];
+		for (uint32_t i = 0; i < XRT_HAND_JOINT_COUNT; i++) {
+			out[i] = resolve(set.values.hand_joint_set_default[i].relation, base);
+		}
+		return out[XRT_HAND_JOINT_COUNT - 1].pose.position.x;
+	};
+
+	BENCHMARK("m_hand_joints_soa_transform")
+	{
+		m_hand_joints_soa joints;
+		m_hand_joints_soa_from_set(&set, &joints);
+		m_hand_joints_soa_transform(&base, &joints);
+		return joints.px[XRT_HAND_JOINT_COUNT - 1];
+	};
+}
@@ -9,10 +9,16 @@
 #include <math/m_relation_history.h>
 #include <util/u_time.h>
 #include <util/u_template_historybuf.hpp>
+#include <util/u_template_historybuf_soa.hpp>
 #include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
 
 
 using xrt::auxiliary::util::HistoryBuffer;
+using xrt::auxiliary::util::HistoryBufferSoA;
 
 template <typename Container>
 static inline std::ostream &
@@ -426,3 +432,197 @@ TEST_CASE("IteratorBase")
 		CHECK_FALSE((++end_constructed).is_cleared());
 	}
 }
+
+TEST_CASE("u_template_historybuf_soa")
+{
+	HistoryBufferSoA<4, int, float> buffer;
+	SECTION("behavior when empty")
+	{
+		CHECK(buffer.empty());
+		CHECK(0 == buffer.size()); // NOLINT
+		CHECK_FALSE(buffer.begin().valid());
+		CHECK(buffer.begin() == buffer.end());
+		CHECK(buffer.timestamp_at_index(0) == nullptr);
+		CHECK(buffer.get_at_index(0) == nullptr);
+		CHECK_THROWS_AS(buffer.front_timestamp(), std::logic_error);
+		CHECK_THROWS_AS(buffer.back(), std::logic_error);
+		CHECK_THROWS_AS(*buffer.begin(), std::out_of_range);
+		CHECK(buffer.lower_bound_index(10) == 0);
+		CHECK(buffer.interpolation_lower_bound_index(10) == 0);
+		CHECK(buffer.lower_bound(10) == buffer.end());
+	}
+	SECTION("behavior with two")
+	{
+		buffer.push_back(10, 1, 1.5f);
+		buffer.push_back(20, 2, 2.5f);
+		CHECK(buffer.size() == 2);
+
+		CHECK(*buffer.timestamp_at_index(0) == 10);
+		CHECK(*buffer.timestamp_at_age(0) == 20);
+		CHECK(*buffer.get_at_index(1) == 2);
+		CHECK(*buffer.get_at_index<1>(1) == 2.5f);
+		CHECK(*buffer.get_at_age<1>(1) == 1.5f);
+		CHECK(buffer.get_at_age(2) == nullptr);
+
+		CHECK(buffer.front_timestamp() == 10);
+		CHECK(buffer.back_timestamp() == 20);
+		CHECK(buffer.front() == 1);
+		CHECK(buffer.back<1>() == 2.5f);
+
+		// Rows and iterators.
+		auto it = buffer.begin();
+		CHECK((*it).timestamp == 10);
+		CHECK(it->get() == 1);
+		CHECK(it.timestamp() == 10);
+		++it;
+		CHECK(it->get<1>() == 2.5f);
+		it->get() = 3;
+		CHECK(buffer.back() == 3);
+		++it;
+		CHECK(it == buffer.end());
+		CHECK(buffer.begin() == buffer.cbegin());
+		CHECK(buffer.begin() == --(--(buffer.end())));
+
+		REQUIRE(buffer.pop_back());
+		CHECK(buffer.size() == 1);
+		CHECK(buffer.back_timestamp() == 10);
+	}
+	SECTION("wraps around")
+	{
+		for (int i = 0; i < 6; i++) {
+			buffer.push_back(i * 10, i, (float)i);
+		}
+		CHECK(buffer.size() == 4);
+		CHECK(buffer.front_timestamp() == 20);
+		CHECK(buffer.back() == 5);
+
+		int expected = 2;
+		for (const auto &row : buffer) {
+			CHECK(row.timestamp == expected * 10);
+			CHECK(row.get() == expected);
+			expected++;
+		}
+		CHECK(expected == 6);
+
+		CHECK(buffer.lower_bound_index(0) == 0);
+		CHECK(buffer.lower_bound_index(20) == 0);
+		CHECK(buffer.lower_bound_index(21) == 1);
+		CHECK(buffer.lower_bound_index(40) == 2);
+		CHECK(buffer.lower_bound_index(51) == 4);
+		CHECK(buffer.lower_bound(35)->get() == 4);
+		CHECK(buffer.interpolation_lower_bound(35)->get() == 4);
+	}
+}
+
+TEST_CASE("u_template_historybuf_soa_search")
+{
+	constexpr size_t size = 1000;
+	auto buffer = std::make_unique<HistoryBufferSoA<size, int>>();
+	std::mt19937 rng(38);
+
+	// Evenly spaced with jitter, a burst, repeated timestamps and a long gap, wrapped around a few times.
+	std::uniform_int_distribution<int64_t> jitter(-300, 300);
+	std::vector<int64_t> timestamps;
+	int64_t t = 1000000;
+	for (size_t i = 0; i < size * 3 + 123; i++) {
+		if (i % 700 == 0) {
+			t += 5000000;
+		} else if (i % 50 < 5) {
+			t += 1;
+		} else if (i % 97 != 0) {
+			t += 1000 + jitter(rng);
+		}
+		buffer->push_back(t, (int)i);
+		timestamps.push_back(t);
+	}
+	timestamps.erase(timestamps.begin(), timestamps.end() - size);
+	REQUIRE(buffer->size() == size);
+
+	std::uniform_int_distribution<int64_t> query(timestamps.front() - 5000, timestamps.back() + 5000);
+	for (int i = 0; i < 20000; i++) {
+		// Also hit the exact timestamps.
+		const int64_t q = i % 4 == 0 ? timestamps[i % size] : query(rng);
+		const size_t expected = std::lower_bound(timestamps.begin(), timestamps.end(), q) - timestamps.begin();
+
+		CHECK(buffer->lower_bound_index(q) == expected);
+		CHECK(buffer->interpolation_lower_bound_index(q) == expected);
+		CHECK(std::lower_bound(buffer->begin(), buffer->end(), q,
+		                       [](const auto &row, int64_t v) { return row.timestamp < v; }) -
+		          buffer->begin() ==
+		      (std::ptrdiff_t)expected);
+	}
+}
+
+namespace {
+
+struct aos_entry
+{
+	xrt_space_relation relation;
+	int64_t timestamp;
+};
+
+template <size_t Size>
+void
+benchmark_lookup()
+{
+	auto aos = std::make_unique<HistoryBuffer<aos_entry, Size>>();
+	auto soa = std::make_unique<HistoryBufferSoA<Size, xrt_space_relation>>();
+
+	// A 1 kHz IMU like stream, wrapped around once.
+	std::mt19937 rng(39);
+	std::uniform_int_distribution<int64_t> jitter(-20000, 20000);
+	int64_t t = U_TIME_1S_IN_NS;
+	for (size_t i = 0; i < Size + Size / 2; i++) {
+		t += U_TIME_1MS_IN_NS + jitter(rng);
+		xrt_space_relation relation = XRT_SPACE_RELATION_ZERO;
+		relation.pose.position.x = (float)i;
+		aos->push_back({relation, t});
+		soa->push_back(t, relation);
+	}
+
+	// Random queries, as from many different callers.
+	std::uniform_int_distribution<int64_t> dist(soa->front_timestamp(), soa->back_timestamp());
+	std::vector<int64_t> queries(1024);
+	for (int64_t &q : queries) {
+		q = dist(rng);
+	}
+
+	const std::string n = " x" + std::to_string(Size);
+
+	BENCHMARK("HistoryBuffer std::lower_bound" + n)
+	{
+		float sum = 0;
+		for (int64_t q : queries) {
+			auto it = std::lower_bound(aos->begin(), aos->end(), q,
+			                           [](const aos_entry &e, int64_t v) { return e.timestamp < v; });
+			sum += it->relation.pose.position.x;
+		}
+		return sum;
+	};
+
+	BENCHMARK("HistoryBufferSoA lower_bound_index" + n)
+	{
+		float sum = 0;
+		for (int64_t q : queries) {
+			sum += soa->get_at_index(soa->lower_bound_index(q))->pose.position.x;
+		}
+		return sum;
+	};
+
+	BENCHMARK("HistoryBufferSoA interpolation_lower_bound_index" + n)
+	{
+		float sum = 0;
+		for (int64_t q : queries) {
+			sum += soa->get_at_index(soa->interpolation_lower_bound_index(q))->pose.position.x;
+		}
+		return sum;
+	};
+}
+
+} // namespace
+
+TEST_CASE("u_template_historybuf_soa_benchmark", "[.][benchmark]")
+{
+	benchmark_lookup<4096>();
+	benchmark_lookup<65536>();
+}
@@ -0,0 +1,215 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief IMU preintegration tests, checked against integrating every sample again.
+ */
+
+#include "math/m_api.h"
+#include "math/m_filter_fifo.h"
+#include "math/m_imu_integration.h"
+
+#include "catch_amalgamated.hpp"
+
+#include <cmath>
+#include <cstring>
+
+
+namespace {
+
+//! Same as the SLAM tracker.
+constexpr size_t kFifoSize = 1000;
+
+constexpr int64_t kMs = 1000 * 1000;
+
+//! 1 kHz IMU, starting a second in.
+constexpr int64_t kImuPeriod = kMs;
+constexpr int64_t kStart = 1000 * kMs;
+
+//! SLAM poses at 30 Hz, known 15 ms after they were taken.
+constexpr int64_t kSlamPeriod = 33 * kMs;
+constexpr int64_t kSlamLatency = 15 * kMs;
+
+//! Head moving around, so every sample is different.
+void
+imu_sample(int64_t ts, xrt_vec3 &gyro, xrt_vec3 &accel)
+{
+	double t = (double)(ts - kStart) / 1e9;
+
+	gyro = {(float)(0.8 * std::sin(t * 3.1)), (float)(1.3 * std::cos(t * 1.7)), (float)(0.4 * std::sin(t * 5.3))};
+	accel = {(float)(0.5 * std::cos(t * 2.3)), (float)(9.81 + 0.3 * std::sin(t * 4.1)),
+	         (float)(0.7 * std::sin(t * 0.9))};
+}
+
+//! Where SLAM says the head was at @p ts, only needs to differ between poses.
+xrt_space_relation
+slam_pose(int64_t ts)
+{
+	double t = (double)(ts - kStart) / 1e9;
+
+	xrt_space_relation rel = XRT_SPACE_RELATION_ZERO;
+	rel.relation_flags = (enum xrt_space_relation_flags)(
+	    XRT_SPACE_RELATION_ORIENTATION_VALID_BIT | XRT_SPACE_RELATION_POSITION_VALID_BIT |
+	    XRT_SPACE_RELATION_ORIENTATION_TRACKED_BIT | XRT_SPACE_RELATION_POSITION_TRACKED_BIT |
+	    XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT | XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT);
+
+	xrt_vec3 axis = {(float)std::sin(t), 1.0f, (float)std::cos(t)};
+	math_vec3_normalize(&axis);
+	math_quat_from_angle_vector((float)(0.3 * std::sin(t * 0.5)), &axis, &rel.pose.orientation);
+	rel.pose.position = {(float)(0.1 * std::sin(t)), 1.6f, (float)(0.2 * std::cos(t))};
+	rel.linear_velocity = {(float)(0.1 * std::cos(t)), 0.0f, (float)(-0.2 * std::sin(t))};
+	rel.angular_velocity = {0.1f, (float)(0.2 * std::sin(t)), 0.0f};
+
+	return rel;
+}
+
+struct Counts
+{
+	//! Queries answered from the preintegration, all compared with the fifo path.
+	int cached = 0;
+
+	//! Queries where the fifos no longer reach back to the base pose.
+	int fallback = 0;
+};
+
+/*!
+ * Feeds @p duration of IMU samples like the SLAM tracker does, updating the
+ * base pose as SLAM poses come in unless in the gap, and queries a few times
+ * per sample at times between the base pose and 20 ms past the newest sample.
+ */
+Counts
+run(int64_t duration, int64_t gap_begin, int64_t gap_end, int64_t gravity_change)
+{
+	m_ff_vec3_f32 *gyro_ff = nullptr;
+	m_ff_vec3_f32 *accel_ff = nullptr;
+	m_ff_vec3_f32_alloc(&gyro_ff, kFifoSize);
+	m_ff_vec3_f32_alloc(&accel_ff, kFifoSize);
+
+	m_imu_preintegration *pre = nullptr;
+	m_imu_preintegration_create(kFifoSize, &pre);
+
+	xrt_vec3 gravity_correction = {0.0f, -9.81f, 0.0f};
+	int64_t base_ts = kStart;
+	xrt_space_relation base_rel = slam_pose(base_ts);
+
+	Counts counts;
+
+	for (int64_t now = kStart + kImuPeriod; now < kStart + duration; now += kImuPeriod) {
+		xrt_vec3 gyro;
+		xrt_vec3 accel;
+		imu_sample(now, gyro, accel);
+		m_ff_vec3_f32_push(gyro_ff, &gyro, now);
+		m_ff_vec3_f32_push(accel_ff, &accel, now);
+		m_imu_preintegration_push(pre, now, &gyro, &accel);
+
+		// Newest SLAM pose known by now.
+		int64_t known_ts = kStart + ((now - kSlamLatency - kStart) / kSlamPeriod) * kSlamPeriod;
+		bool in_gap = now >= gap_begin && now < gap_end;
+		if (!in_gap && known_ts > base_ts) {
+			base_ts = known_ts;
+			base_rel = slam_pose(base_ts);
+		}
+
+		if (now == gravity_change) {
+			gravity_correction.y = -9.79f;
+		}
+
+		// On a sample, between samples, and predicting past the newest one.
+		const int64_t offsets[] = {0, -kImuPeriod / 3, -7 * kImuPeriod, 5 * kMs, 20 * kMs};
+		for (int64_t offset : offsets) {
+			int64_t when_ns = now + offset;
+			if (when_ns <= base_ts) {
+				continue;
+			}
+
+			xrt_space_relation expected = {};
+			m_imu_integration_predict_from_fifos(gyro_ff, accel_ff, &gravity_correction, &base_rel, base_ts,
+			                                     when_ns, &expected);
+
+			xrt_space_relation got = {};
+			bool cached = m_imu_preintegration_predict(pre, gyro_ff, accel_ff, &gravity_correction,
+			                                           &base_rel, base_ts, when_ns, &got);
+			if (!cached) {
+				// Integrates from the oldest sample there is.
+				CHECK(std::isfinite(expected.pose.position.x));
+				CHECK(std::isfinite(expected.pose.orientation.w));
+				counts.fallback++;
+				continue;
+			}
+
+			counts.cached++;
+
+			// Bit identical, not just close.
+			CHECK(std::memcmp(&got, &expected, sizeof(got)) == 0);
+		}
+	}
+
+	m_imu_preintegration_destroy(&pre);
+	CHECK(pre == nullptr);
+
+	m_ff_vec3_f32_free(&gyro_ff);
+	m_ff_vec3_f32_free(&accel_ff);
+
+	return counts;
+}
+
+} // namespace
+
+
+TEST_CASE("m_imu_preintegration")
+{
+	SECTION("same as integrating every sample")
+	{
+		Counts counts = run(3000 * kMs, 0, 0, 0);
+
+		CHECK(counts.cached > 10000);
+		CHECK(counts.fallback == 0);
+	}
+
+	SECTION("gravity correction change rebuilds")
+	{
+		Counts counts = run(1000 * kMs, 0, 0, kStart + 500 * kMs);
+
+		CHECK(counts.cached > 3000);
+		CHECK(counts.fallback == 0);
+	}
+
+	SECTION("falls back during a long SLAM gap")
+	{
+		// The fifos only hold a second of samples.
+		Counts counts = run(5000 * kMs, kStart + 1000 * kMs, kStart + 3000 * kMs, 0);
+
+		CHECK(counts.cached > 10000);
+		CHECK(counts.fallback > 1000);
+	}
+
+	SECTION("no samples after the base pose")
+	{
+		m_ff_vec3_f32 *gyro_ff = nullptr;
+		m_ff_vec3_f32 *accel_ff = nullptr;
+		m_ff_vec3_f32_alloc(&gyro_ff, kFifoSize);
+		m_ff_vec3_f32_alloc(&accel_ff, kFifoSize);
+
+		m_imu_preintegration *pre = nullptr;
+		m_imu_preintegration_create(kFifoSize, &pre);
+
+		xrt_vec3 gravity_correction = {0.0f, -9.81f, 0.0f};
+		xrt_space_relation base_rel = slam_pose(kStart);
+
+		xrt_space_relation expected = {};
+		int64_t when_ns = kStart + 10 * kMs;
+		bool had_samples = m_imu_integration_predict_from_fifos(gyro_ff, accel_ff, &gravity_correction,
+		                                                        &base_rel, kStart, when_ns, &expected);
+		CHECK_FALSE(had_samples);
+
+		xrt_space_relation got = {};
+		REQUIRE(m_imu_preintegration_predict(pre, gyro_ff, accel_ff, &gravity_correction, &base_rel, kStart,
+		                                     when_ns, &got));
+		CHECK(m_imu_preintegration_get_step_count(pre) == 0);
+		CHECK(std::memcmp(&got, &expected, sizeof(got)) == 0);
+
+		m_imu_preintegration_destroy(&pre);
+		m_ff_vec3_f32_free(&gyro_ff);
+		m_ff_vec3_f32_free(&accel_ff);
+	}
+}
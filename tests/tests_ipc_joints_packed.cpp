@@ -0,0 +1,308 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Accuracy of the packed IPC joint format against the plain one.
+ */
+
+#include "catch_amalgamated.hpp"
+
+#include <math/m_api.h>
+#include <shared/ipc_joints_packed.h>
+
+#include <cmath>
+#include <random>
+
+
+namespace {
+
+// Bounds for hand sized joint sets, about 25 cm from the wrist.
+constexpr float hand_position_margin = 2e-5f;
+constexpr float body_position_margin = 1e-4f;
+constexpr double orientation_margin_rad = 2e-4;
+constexpr float linear_velocity_margin = 1e-4f;
+constexpr float angular_velocity_margin = 5e-4f;
+constexpr float radius_margin = 1e-5f;
+
+const uint32_t all_flags[] = {
+    XRT_SPACE_RELATION_ORIENTATION_VALID_BIT,     XRT_SPACE_RELATION_POSITION_VALID_BIT,
+    XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT, XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT,
+    XRT_SPACE_RELATION_ORIENTATION_TRACKED_BIT,   XRT_SPACE_RELATION_POSITION_TRACKED_BIT,
+};
+
+xrt_quat
+random_quat(std::mt19937 &rng)
+{
+	std::uniform_real_distribution<float> dist(-1.f, 1.f);
+	xrt_quat q = {dist(rng), dist(rng), dist(rng), dist(rng)};
+	math_quat_normalize(&q);
+	return q;
+}
+
+/*!
+ * A joint within @p extent of @p center, velocities like a hand being waved.
+ */
+xrt_space_relation
+random_relation(std::mt19937 &rng, const xrt_vec3 &center, float extent, bool all_valid)
+{
+	std::uniform_real_distribution<float> offset(-extent, extent);
+	std::uniform_real_distribution<float> linear(-2.f, 2.f);
+	std::uniform_real_distribution<float> angular(-10.f, 10.f);
+	std::uniform_int_distribution<int> coin(0, 3);
+
+	xrt_space_relation r = {};
+	r.pose.position = {center.x + offset(rng), center.y + offset(rng), center.z + offset(rng)};
+	r.pose.orientation = random_quat(rng);
+	r.linear_velocity = {linear(rng), linear(rng), linear(rng)};
+	r.angular_velocity = {angular(rng), angular(rng), angular(rng)};
+
+	uint32_t flags = 0;
+	for (uint32_t f : all_flags) {
+		if (all_valid || coin(rng) != 0) {
+			flags |= f;
+		}
+	}
+	r.relation_flags = (xrt_space_relation_flags)flags;
+
+	return r;
+}
+
+bool
+has(const xrt_space_relation &r, uint32_t bit)
+{
+	return (r.relation_flags & bit) != 0;
+}
+
+double
+angle_between(const xrt_quat &a, const xrt_quat &b)
+{
+	// Vector part of conj(a) * b, more precise than acos of the dot product.
+	const double x = (double)a.w * b.x - (double)a.x * b.w - (double)a.y * b.z + (double)a.z * b.y;
+	const double y = (double)a.w * b.y + (double)a.x * b.z - (double)a.y * b.w - (double)a.z * b.x;
+	const double z = (double)a.w * b.z - (double)a.x * b.y + (double)a.y * b.x - (double)a.z * b.w;
+
+	return 2.0 * std::asin(std::fmin(1.0, std::sqrt(x * x + y * y + z * z)));
+}
+
+void
+check_vec3(const xrt_vec3 &expected, const xrt_vec3 &actual, float margin)
+{
+	CHECK(std::fabs(expected.x - actual.x) <= margin);
+	CHECK(std::fabs(expected.y - actual.y) <= margin);
+	CHECK(std::fabs(expected.z - actual.z) <= margin);
+}
+
+void
+check_relation(const xrt_space_relation &expected, const xrt_space_relation &actual, float position_margin)
+{
+	REQUIRE(expected.relation_flags == actual.relation_flags);
+
+	if (has(expected, XRT_SPACE_RELATION_ORIENTATION_VALID_BIT)) {
+		CHECK(angle_between(expected.pose.orientation, actual.pose.orientation) <= orientation_margin_rad);
+	} else {
+		CHECK(actual.pose.orientation.w == 1.f);
+	}
+
+	if (has(expected, XRT_SPACE_RELATION_POSITION_VALID_BIT)) {
+		check_vec3(expected.pose.position, actual.pose.position, position_margin);
+	} else {
+		check_vec3({0, 0, 0}, actual.pose.position, 0.f);
+	}
+
+	if (has(expected, XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT)) {
+		check_vec3(expected.linear_velocity, actual.linear_velocity, linear_velocity_margin);
+	} else {
+		check_vec3({0, 0, 0}, actual.linear_velocity, 0.f);
+	}
+
+	if (has(expected, XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT)) {
+		check_vec3(expected.angular_velocity, actual.angular_velocity, angular_velocity_margin);
+	} else {
+		check_vec3({0, 0, 0}, actual.angular_velocity, 0.f);
+	}
+}
+
+xrt_hand_joint_set
+random_hand(std::mt19937 &rng, bool all_valid)
+{
+	std::uniform_real_distribution<float> radius(0.002f, 0.03f);
+	const xrt_vec3 wrist = {0.2f, 1.3f, -0.4f};
+
+	xrt_hand_joint_set set = {};
+	for (auto &v : set.values.hand_joint_set_default) {
+		v.relation = random_relation(rng, wrist, 0.25f, all_valid);
+		v.radius = radius(rng);
+	}
+	set.hand_pose = set.values.hand_joint_set_default[XRT_HAND_JOINT_WRIST].relation;
+	set.is_active = true;
+
+	return set;
+}
+
+xrt_hand_joint_set
+round_trip(const xrt_hand_joint_set &set)
+{
+	ipc_packed_hand_joint_set packed;
+	ipc_pack_hand_joint_set(&set, &packed);
+
+	xrt_hand_joint_set out;
+	ipc_unpack_hand_joint_set(&packed, &out);
+	return out;
+}
+
+void
+check_hand(const xrt_hand_joint_set &expected, const xrt_hand_joint_set &actual, float position_margin)
+{
+	CHECK(expected.is_active == actual.is_active);
+	CHECK(memcmp(&expected.hand_pose, &actual.hand_pose, sizeof(expected.hand_pose)) == 0);
+
+	for (uint32_t i = 0; i < XRT_HAND_JOINT_COUNT; i++) {
+		const xrt_hand_joint_value &e = expected.values.hand_joint_set_default[i];
+		const xrt_hand_joint_value &a = actual.values.hand_joint_set_default[i];
+
+		check_relation(e.relation, a.relation, position_margin);
+		CHECK(std::fabs(e.radius - a.radius) <= radius_margin);
+	}
+}
+
+} // namespace
+
+
+TEST_CASE("packed_sizes")
+{
+	// The whole point, about half of the plain structs.
+	CHECK(sizeof(ipc_packed_hand_joint_set) * 2 <= sizeof(xrt_hand_joint_set) + 64);
+	CHECK(sizeof(ipc_packed_body_joint_set) * 2 <= sizeof(xrt_body_joint_set) + 256);
+}
+
+TEST_CASE("packed_hand_all_valid")
+{
+	std::mt19937 rng(37);
+
+	for (int i = 0; i < 100; i++) {
+		const xrt_hand_joint_set set = random_hand(rng, true);
+		check_hand(set, round_trip(set), hand_position_margin);
+	}
+}
+
+TEST_CASE("packed_hand_some_valid")
+{
+	std::mt19937 rng(38);
+
+	for (int i = 0; i < 100; i++) {
+		const xrt_hand_joint_set set = random_hand(rng, false);
+
+		// Without a valid wrist the joints are stored relative to the origin.
+		const xrt_space_relation &wrist = set.values.hand_joint_set_default[XRT_HAND_JOINT_WRIST].relation;
+		const bool root_valid = has(wrist, XRT_SPACE_RELATION_ORIENTATION_VALID_BIT) &&
+		                        has(wrist, XRT_SPACE_RELATION_POSITION_VALID_BIT);
+
+		check_hand(set, round_trip(set), root_valid ? hand_position_margin : hand_position_margin * 4);
+	}
+}
+
+TEST_CASE("packed_hand_exact_cases")
+{
+	std::mt19937 rng(39);
+	xrt_hand_joint_set set = random_hand(rng, true);
+
+	SECTION("root joint is exact")
+	{
+		const xrt_hand_joint_set out = round_trip(set);
+		const xrt_pose &e = set.values.hand_joint_set_default[XRT_HAND_JOINT_WRIST].relation.pose;
+		const xrt_pose &a = out.values.hand_joint_set_default[XRT_HAND_JOINT_WRIST].relation.pose;
+		CHECK(angle_between(e.orientation, a.orientation) <= 1e-6);
+		check_vec3(e.position, a.position, 1e-6f);
+	}
+
+	SECTION("inactive and not valid")
+	{
+		for (auto &v : set.values.hand_joint_set_default) {
+			v.relation.relation_flags = XRT_SPACE_RELATION_BITMASK_NONE;
+		}
+		set.is_active = false;
+
+		check_hand(set, round_trip(set), 0.f);
+	}
+
+	SECTION("non finite values are dropped")
+	{
+		set.values.hand_joint_set_default[5].relation.pose.position.x = NAN;
+		set.values.hand_joint_set_default[6].relation.linear_velocity.y = INFINITY;
+
+		const xrt_hand_joint_set out = round_trip(set);
+		for (const auto &v : out.values.hand_joint_set_default) {
+			CHECK(std::isfinite(v.relation.pose.position.x));
+			CHECK(std::isfinite(v.relation.linear_velocity.y));
+		}
+	}
+}
+
+TEST_CASE("packed_body")
+{
+	std::mt19937 rng(40);
+	const xrt_vec3 hips = {1.f, 1.f, -2.f};
+
+	for (xrt_input_name name : {XRT_INPUT_FB_BODY_TRACKING, XRT_INPUT_META_FULL_BODY_TRACKING}) {
+		DYNAMIC_SECTION((name == XRT_INPUT_FB_BODY_TRACKING ? "fb" : "meta_full_body"))
+		{
+			const uint32_t count = ipc_body_joint_count(name);
+
+			xrt_body_joint_set set = {};
+			xrt_full_body_joint_set_meta &full = set.full_body_joint_set_meta;
+			for (uint32_t i = 0; i < count; i++) {
+				full.joint_locations[i].relation = random_relation(rng, hips, 1.f, i % 5 != 0);
+			}
+			full.base.sample_time_ns = 123456789;
+			full.base.confidence = 0.75f;
+			full.base.skeleton_changed_count = 3;
+			full.base.is_active = true;
+			set.body_pose = full.joint_locations[XRT_FULL_BODY_JOINT_HIPS_META].relation;
+
+			ipc_packed_body_joint_set packed;
+			ipc_pack_body_joint_set(&set, count, &packed);
+			CHECK(packed.joint_count == count);
+
+			xrt_body_joint_set out;
+			memset(&out, 0xff, sizeof(out));
+			ipc_unpack_body_joint_set(&packed, &out);
+
+			const xrt_full_body_joint_set_meta &out_full = out.full_body_joint_set_meta;
+			CHECK(out_full.base.sample_time_ns == full.base.sample_time_ns);
+			CHECK(out_full.base.confidence == full.base.confidence);
+			CHECK(out_full.base.skeleton_changed_count == full.base.skeleton_changed_count);
+			CHECK(out_full.base.is_active == full.base.is_active);
+			CHECK(memcmp(&out.body_pose, &set.body_pose, sizeof(set.body_pose)) == 0);
+
+			for (uint32_t i = 0; i < count; i++) {
+				check_relation(full.joint_locations[i].relation, out_full.joint_locations[i].relation,
+				               body_position_margin);
+			}
+
+			// Not sent, zeroed.
+			for (uint32_t i = count; i < XRT_FULL_BODY_JOINT_COUNT_META; i++) {
+				CHECK(out_full.joint_locations[i].relation.relation_flags == 0);
+			}
+		}
+	}
+}
+
+TEST_CASE("packed_benchmark", "[.][benchmark]")
+{
+	std::mt19937 rng(41);
+	const xrt_hand_joint_set set = random_hand(rng, true);
+	ipc_packed_hand_joint_set packed;
+	xrt_hand_joint_set out;
+
+	BENCHMARK("ipc_pack_hand_joint_set")
+	{
+		ipc_pack_hand_joint_set(&set, &packed);
+		return packed.joints[0].flags;
+	};
+
+	BENCHMARK("ipc_unpack_hand_joint_set")
+	{
+		ipc_unpack_hand_joint_set(&packed, &out);
+		return out.values.hand_joint_set_default[0].radius;
+	};
+}
@@ -0,0 +1,341 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief OpenGloves alpha encoding parser tests and benchmark.
+ */
+
+#include "catch_amalgamated.hpp"
+
+#include "opengloves/encoding/alpha_encoding.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+/*
+ *
+ * The original std::map based parser, kept as a reference.
+ *
+ */
+
+// clang-format off
+const std::map<std::string, int> reference_keys{
+    {"A", 0}, {"(AB)", 1}, {"B", 2}, {"(BB)", 3}, {"C", 4}, {"(CB)", 5}, {"D", 6}, {"(DB)", 7}, {"E", 8}, {"(EB)", 9},
+    {"(AAA)", 10}, {"(AAB)", 11}, {"(AAC)", 12}, {"(AAD)", 13},
+    {"(BAA)", 14}, {"(BAB)", 15}, {"(BAC)", 16}, {"(BAD)", 17},
+    {"(CAA)", 18}, {"(CAB)", 19}, {"(CAC)", 20}, {"(CAD)", 21},
+    {"(DAA)", 22}, {"(DAB)", 23}, {"(DAC)", 24}, {"(DAD)", 25},
+    {"(EAA)", 26}, {"(EAB)", 27}, {"(EAC)", 28}, {"(EAD)", 29},
+    {"F", 30}, {"G", 31}, {"H", 32}, {"P", 33}, {"I", 34}, {"J", 35}, {"K", 36}, {"L", 37}, {"M", 38}, {"N", 39},
+    {"O", 40},
+};
+// clang-format on
+
+enum
+{
+	REF_JOINT0 = 10,
+	REF_JOY_X = 30,
+	REF_JOY_Y = 31,
+	REF_JOY_BTN = 32,
+	REF_TRG_VALUE = 33,
+	REF_BTN_TRG = 34,
+	REF_BTN_A = 35,
+	REF_BTN_B = 36,
+	REF_GES_GRAB = 37,
+	REF_GES_PINCH = 38,
+	REF_BTN_MENU = 39,
+};
+
+bool
+reference_is_key_character(char c)
+{
+	return std::string("ABCDEFGHIJKLMNOPQRSTUVWXYZ()").find(c) != std::string::npos;
+}
+
+std::map<int, std::string>
+reference_parse_to_map(const std::string &str)
+{
+	std::map<int, std::string> result;
+
+	size_t i = 0;
+	while (i < str.length()) {
+		if (str[i] >= 0 && reference_is_key_character(str[i])) {
+			std::string key = {str[i]};
+			i++;
+
+			if (key[0] == '(') {
+				while (str[i] >= 0 && reference_is_key_character(str[i]) && i < str.length()) {
+					key += str[i];
+					i++;
+				}
+			}
+
+			std::string value;
+			while (str[i] >= 0 && isdigit(str[i]) && i < str.length()) {
+				value += str[i];
+				i++;
+			}
+
+			if (reference_keys.find(key) != reference_keys.end()) {
+				result.insert_or_assign(reference_keys.at(key), value);
+			}
+		} else {
+			i++;
+		}
+	}
+
+	return result;
+}
+
+void
+reference_decode(const char *data, opengloves_input *out)
+{
+	std::map<int, std::string> m = reference_parse_to_map(data);
+	auto has = [&](int k) { return m.find(k) != m.end(); };
+	auto val = [&](int k) { return std::stof(m.at(k)); };
+
+	for (int i = 0; i < 5; i++) {
+		int enum_position = i * 2;
+		if (has(enum_position)) {
+			float fin_curl_value = val(enum_position);
+			std::fill(std::begin(out->flexion[i]), std::begin(out->flexion[i]) + 4,
+			          fin_curl_value / OPENGLOVES_ENCODING_MAX_ANALOG_VALUE);
+		}
+		if (has(enum_position + 1)) {
+			out->splay[i] = (val(enum_position + 1) / OPENGLOVES_ENCODING_MAX_ANALOG_VALUE - 0.5f) * 2.0f;
+		}
+	}
+
+	int current_finger_joint = REF_JOINT0;
+	for (int i = 0; i < 5; i++) {
+		for (int j = 0; j < 4; j++) {
+			out->flexion[i][j] = has(current_finger_joint)
+			                         ? (val(current_finger_joint) / OPENGLOVES_ENCODING_MAX_ANALOG_VALUE)
+			                         : out->flexion[i][j > 0 ? j - 1 : 0];
+			current_finger_joint++;
+		}
+	}
+
+	if (has(REF_JOY_X)) {
+		out->joysticks.main.x = 2 * val(REF_JOY_X) / OPENGLOVES_ENCODING_MAX_ANALOG_VALUE - 1;
+	}
+	if (has(REF_JOY_Y)) {
+		out->joysticks.main.y = 2 * val(REF_JOY_Y) / OPENGLOVES_ENCODING_MAX_ANALOG_VALUE - 1;
+	}
+	out->joysticks.main.pressed = has(REF_JOY_BTN);
+
+	if (has(REF_TRG_VALUE)) {
+		out->buttons.trigger.value = val(REF_TRG_VALUE) / OPENGLOVES_ENCODING_MAX_ANALOG_VALUE;
+	}
+	out->buttons.trigger.pressed = has(REF_BTN_TRG);
+	out->buttons.A.pressed = has(REF_BTN_A);
+	out->buttons.B.pressed = has(REF_BTN_B);
+	out->gestures.grab.activated = has(REF_GES_GRAB);
+	out->gestures.pinch.activated = has(REF_GES_PINCH);
+	out->buttons.menu.pressed = has(REF_BTN_MENU);
+}
+
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+const char *analog_keys[] = {
+    "A",     "(AB)",  "B",     "(BB)",  "C",     "(CB)",  "D",     "(DB)",  "E",     "(EB)",  "(AAA)",
+    "(AAB)", "(AAC)", "(AAD)", "(BAA)", "(BAB)", "(BAC)", "(BAD)", "(CAA)", "(CAB)", "(CAC)", "(CAD)",
+    "(DAA)", "(DAB)", "(DAC)", "(DAD)", "(EAA)", "(EAB)", "(EAC)", "(EAD)", "F",     "G",     "P",
+};
+
+const char *button_keys[] = {"H", "I", "J", "K", "L", "M", "N", "O"};
+
+const char junk_characters[] = " ,.;#-+\t\r\n0123456789\x80\xff";
+
+void
+check_same(const opengloves_input &expected, const opengloves_input &actual)
+{
+	CHECK(std::memcmp(expected.flexion, actual.flexion, sizeof(expected.flexion)) == 0);
+	CHECK(std::memcmp(expected.splay, actual.splay, sizeof(expected.splay)) == 0);
+	CHECK(expected.joysticks.main.x == actual.joysticks.main.x);
+	CHECK(expected.joysticks.main.y == actual.joysticks.main.y);
+	CHECK(expected.joysticks.main.pressed == actual.joysticks.main.pressed);
+	CHECK(expected.buttons.trigger.value == actual.buttons.trigger.value);
+	CHECK(expected.buttons.trigger.pressed == actual.buttons.trigger.pressed);
+	CHECK(expected.buttons.A.pressed == actual.buttons.A.pressed);
+	CHECK(expected.buttons.B.pressed == actual.buttons.B.pressed);
+	CHECK(expected.buttons.menu.pressed == actual.buttons.menu.pressed);
+	CHECK(expected.gestures.grab.activated == actual.gestures.grab.activated);
+	CHECK(expected.gestures.pinch.activated == actual.gestures.pinch.activated);
+}
+
+/*!
+ * Random packet that the reference parser can handle: analog keys always have
+ * a value (it throws otherwise), junk never contains key characters.
+ */
+std::string
+random_packet(std::mt19937 &rng)
+{
+	std::uniform_int_distribution<int> token_count(0, 48);
+	std::uniform_int_distribution<int> kind(0, 9);
+	std::uniform_int_distribution<size_t> analog(0, std::size(analog_keys) - 1);
+	std::uniform_int_distribution<size_t> button(0, std::size(button_keys) - 1);
+	std::uniform_int_distribution<size_t> junk(0, sizeof(junk_characters) - 2);
+	std::uniform_int_distribution<int> digits(0, 4);
+	std::uniform_int_distribution<int> digit(0, 9);
+
+	std::string str;
+	int count = token_count(rng);
+	for (int t = 0; t < count; t++) {
+		int k = kind(rng);
+		if (k < 6) {
+			str += analog_keys[analog(rng)];
+			int n = 1 + digits(rng);
+			for (int d = 0; d < n; d++) {
+				str += (char)('0' + digit(rng));
+			}
+		} else if (k < 8) {
+			str += button_keys[button(rng)];
+			int n = digits(rng);
+			for (int d = 0; d < n; d++) {
+				str += (char)('0' + digit(rng));
+			}
+		} else {
+			str += junk_characters[junk(rng)];
+		}
+	}
+
+	return str;
+}
+
+opengloves_input
+random_input(std::mt19937 &rng)
+{
+	std::uniform_real_distribution<float> dist(-1.f, 1.f);
+
+	opengloves_input in;
+	std::memset(&in, 0, sizeof(in));
+	for (auto &finger : in.flexion) {
+		for (float &f : finger) {
+			f = dist(rng);
+		}
+	}
+	for (float &f : in.splay) {
+		f = dist(rng);
+	}
+	in.joysticks.main.x = dist(rng);
+	in.joysticks.main.y = dist(rng);
+	in.buttons.trigger.value = dist(rng);
+
+	return in;
+}
+
+} // namespace
+
+
+TEST_CASE("opengloves_alpha_encoding_full_packet")
+{
+	const char *packet = "A512(AB)1023B100(BB)0C200D300E400(AAB)800F1023G0HIJKLMNP700\n";
+
+	opengloves_input in = {};
+	opengloves_alpha_encoding_decode(packet, &in);
+
+	CHECK(in.flexion[0][0] == Catch::Approx(512 / 1023.f));
+	CHECK(in.flexion[0][1] == Catch::Approx(800 / 1023.f));
+	CHECK(in.flexion[0][3] == Catch::Approx(800 / 1023.f));
+	CHECK(in.flexion[1][2] == Catch::Approx(100 / 1023.f));
+	CHECK(in.flexion[4][0] == Catch::Approx(400 / 1023.f));
+	CHECK(in.splay[0] == Catch::Approx(1.f));
+	CHECK(in.splay[1] == Catch::Approx(-1.f));
+	CHECK(in.joysticks.main.x == Catch::Approx(1.f));
+	CHECK(in.joysticks.main.y == Catch::Approx(-1.f));
+	CHECK(in.joysticks.main.pressed);
+	CHECK(in.buttons.trigger.pressed);
+	CHECK(in.buttons.trigger.value == Catch::Approx(700 / 1023.f));
+	CHECK(in.buttons.A.pressed);
+	CHECK(in.buttons.B.pressed);
+	CHECK(in.buttons.menu.pressed);
+	CHECK(in.gestures.grab.activated);
+	CHECK(in.gestures.pinch.activated);
+
+	opengloves_input ref = {};
+	reference_decode(packet, &ref);
+	check_same(ref, in);
+}
+
+TEST_CASE("opengloves_alpha_encoding_malformed")
+{
+	opengloves_input in = {};
+	in.buttons.trigger.value = 0.25f;
+	in.splay[2] = 0.5f;
+
+	// Analog keys without a value, unknown and unterminated keys are ignored.
+	opengloves_alpha_encoding_decode("P(CB)Z99(ZZ)12(AB", &in);
+	CHECK(in.buttons.trigger.value == 0.25f);
+	CHECK(in.splay[2] == 0.5f);
+
+	// Huge values saturate rather than overflow.
+	opengloves_alpha_encoding_decode("P99999999999999999999", &in);
+	CHECK(in.buttons.trigger.value > 1000.f);
+
+	// Empty packet releases all buttons.
+	in.buttons.A.pressed = true;
+	opengloves_alpha_encoding_decode("", &in);
+	CHECK_FALSE(in.buttons.A.pressed);
+}
+
+TEST_CASE("opengloves_alpha_encoding_encode")
+{
+	opengloves_output out = {};
+	out.force_feedback = {0.1f, 0.2f, 0.3f, 0.4f, 1.0f};
+
+	char buff[64];
+	opengloves_alpha_encoding_encode(&out, buff);
+	CHECK(std::string(buff) == "A100B200C300D400E1000\n");
+}
+
+TEST_CASE("opengloves_alpha_encoding_fuzz")
+{
+	std::mt19937 rng(0x0b1055);
+
+	for (int i = 0; i < 20000; i++) {
+		std::string packet = random_packet(rng);
+		INFO("Packet: " << packet);
+
+		opengloves_input expected = random_input(rng);
+		opengloves_input actual = expected;
+
+		reference_decode(packet.c_str(), &expected);
+		opengloves_alpha_encoding_decode(packet.c_str(), &actual);
+
+		check_same(expected, actual);
+	}
+}
+
+TEST_CASE("opengloves_alpha_encoding_benchmark", "[.][benchmark]")
+{
+	const char *packet =
+	    "A512(AB)511B100(BB)520C200(CB)530D300(DB)540E400(EB)550(AAA)10(AAB)20(AAC)30(BAA)40(BAB)50(BAC)60"
+	    "(BAD)70(CAA)80(CAB)90(CAC)100(CAD)110(DAA)120(DAB)130(DAC)140(DAD)150(EAA)160(EAB)170(EAC)180"
+	    "(EAD)190F600G400HIJP700\n";
+	opengloves_input in = {};
+
+	BENCHMARK("reference")
+	{
+		reference_decode(packet, &in);
+		return in.flexion[0][0];
+	};
+
+	BENCHMARK("opengloves_alpha_encoding_decode")
+	{
+		opengloves_alpha_encoding_decode(packet, &in);
+		return in.flexion[0][0];
+	};
+}
@@ -17,6 +17,9 @@
 #include <sstream>
 #include <iomanip>
 #include <queue>
+#include <random>
+#include <functional>
+#include <deque>
 
 using namespace std::chrono_literals;
 using namespace std::chrono;
@@ -402,3 +405,595 @@ TEST_CASE("u_pacing_compositor_fake")
 	}
 	u_pc_destroy(&upc);
 }
+
+//! Like doFrame but squashes first and then sleeps until the late warp, returns when the late warp woke.
+static int64_t
+doLateWarpFrame(SimulatedDisplayTimingQueue &display_timing_queue,
+                u_pacing_compositor *upc,
+                MockClock &clock,
+                CompositorPredictions const &predictions,
+                unanoseconds squash_delay,
+                unanoseconds warp_delay,
+                unanoseconds warp_gpu_time)
+{
+	auto frame_id = predictions.frame_id;
+
+	REQUIRE(clock.now() <= predictions.wake_up_time_ns);
+	clock.advance_to(predictions.wake_up_time_ns);
+	clock.advance(wakeDelay);
+	processDisplayTimingQueue(display_timing_queue, clock.now(), upc);
+	u_pc_mark_point(upc, U_TIMING_POINT_WAKE_UP, frame_id, clock.now());
+
+	clock.advance(shortBeginDelay);
+	u_pc_mark_point(upc, U_TIMING_POINT_BEGIN, frame_id, clock.now());
+
+	// record and submit the squash
+	clock.advance(squash_delay);
+	u_pc_mark_point(upc, U_TIMING_POINT_SQUASH_SUBMIT_END, frame_id, clock.now());
+
+	int64_t late_wake_ns = 0;
+	u_pc_predict_late_warp(upc, frame_id, &late_wake_ns);
+	CHECK(late_wake_ns < predictions.desired_present_time_ns);
+	CHECK(late_wake_ns >= predictions.wake_up_time_ns);
+
+	// sleep until the late warp, if not already late
+	if (late_wake_ns > clock.now()) {
+		clock.advance_to(late_wake_ns);
+	}
+	clock.advance(wakeDelay);
+	int64_t woke_ns = clock.now();
+	u_pc_mark_point(upc, U_TIMING_POINT_LATE_WARP_WAKE_UP, frame_id, woke_ns);
+
+	// wait on the squash, sample poses and record the distortion
+	clock.advance(warp_delay);
+	u_pc_mark_point(upc, U_TIMING_POINT_SUBMIT_BEGIN, frame_id, clock.now());
+	clock.advance(shortSubmitDelay);
+	u_pc_mark_point(upc, U_TIMING_POINT_SUBMIT_END, frame_id, clock.now());
+
+	auto gpu_start = clock.now();
+	clock.advance(warp_gpu_time);
+	auto gpu_finish = clock.now();
+	u_pc_info_gpu(upc, frame_id, gpu_start, gpu_finish, clock.now());
+
+	auto next_scanout_timepoint =
+	    getNextPresentAfterTimestampAndKnownPresent(gpu_finish, predictions.desired_present_time_ns);
+
+	MockClock infoClock;
+	infoClock.advance_to(next_scanout_timepoint);
+	infoClock.advance(1ms);
+	display_timing_queue.push({frame_id, predictions.desired_present_time_ns, gpu_finish, infoClock.now()});
+
+	return woke_ns;
+}
+
+//! Runs @p count late warped frames, returns how long before the desired present the last late warp woke.
+static unanoseconds
+runLateWarpFrames(SimulatedDisplayTimingQueue &queue,
+                  u_pacing_compositor *upc,
+                  MockClock &clock,
+                  int count,
+                  unanoseconds warp_delay,
+                  unanoseconds warp_gpu_time)
+{
+	int64_t ahead_ns = 0;
+	for (int i = 0; i < count; ++i) {
+		CompositorPredictions predictions;
+		u_pc_predict(upc, clock.now(), &predictions.frame_id, &predictions.wake_up_time_ns,
+		             &predictions.desired_present_time_ns, &predictions.present_slop_ns,
+		             &predictions.predicted_display_time_ns, &predictions.predicted_display_period_ns,
+		             &predictions.min_display_period_ns);
+		INFO(predictions.frame_id);
+		INFO(clock.now());
+		basicPredictionConsistencyChecks(clock.now(), predictions);
+
+		int64_t woke_ns = doLateWarpFrame(queue, upc, clock, predictions, longDrawDelay, warp_delay,
+		                                  warp_gpu_time);
+		ahead_ns = predictions.desired_present_time_ns - woke_ns;
+	}
+	return unanoseconds(ahead_ns);
+}
+
+TEST_CASE("u_pacing_compositor_late_warp")
+{
+	MockClock clock;
+	SimulatedDisplayTimingQueue queue;
+	u_pacing_compositor *upc = nullptr;
+
+	SECTION("display timing")
+	{
+		REQUIRE(XRT_SUCCESS == u_pc_display_timing_create(frame_interval_ns.count(),
+		                                                  &U_PC_DISPLAY_TIMING_CONFIG_DEFAULT, &upc));
+		clock.advance(1ms);
+
+		// A slow late warp pushes the wake up earlier, once the compositor time allows.
+		auto ahead = runLateWarpFrames(queue, upc, clock, 30, 1ms, 2ms);
+		CHECK(ahead > unanoseconds(1ms + shortSubmitDelay + 2ms));
+
+		// Once it is fast it moves back towards the present.
+		auto fast_ahead = runLateWarpFrames(queue, upc, clock, 30, 100us, 300us);
+		CHECK(fast_ahead < ahead);
+		CHECK(fast_ahead > unanoseconds(100us + shortSubmitDelay + 300us));
+
+		// Still well after the squash, that is the latency gained.
+		CHECK(fast_ahead < unanoseconds(frame_interval_ns / 4));
+	}
+
+	SECTION("fake")
+	{
+		REQUIRE(XRT_SUCCESS == u_pc_fake_create(frame_interval_ns.count(), clock.now(), &upc));
+		clock.advance(1ms);
+
+		// No feedback, the late warp always wakes the same time before present.
+		auto ahead = runLateWarpFrames(queue, upc, clock, 5, 100us, 300us);
+		auto again = runLateWarpFrames(queue, upc, clock, 5, 1ms, 2ms);
+		CHECK(ahead == again);
+	}
+
+	drainDisplayTimingQueue(queue, clock.now(), upc);
+	u_pc_destroy(&upc);
+}
+
+
+/*
+ *
+ * App pacing.
+ *
+ */
+
+namespace {
+
+//! Time each phase of one app frame takes.
+struct AppFrameTimes
+{
+	unanoseconds cpu;
+	unanoseconds draw;
+	unanoseconds gpu;
+};
+
+//! Fixed seed random, the distributions in <random> differ between standard libraries.
+struct TraceRandom
+{
+	std::mt19937 rng{1234};
+
+	//! In [0, 1).
+	double
+	next()
+	{
+		return (double)(rng() >> 8) / (double)(1u << 24);
+	}
+
+	//! Scaled by up to +-5%.
+	unanoseconds
+	jitter(unanoseconds value)
+	{
+		return unanoseconds((int64_t)((double)value.count() * (0.95 + 0.1 * next())));
+	}
+};
+
+using AppTrace = std::function<AppFrameTimes(TraceRandom &)>;
+
+struct AppPacingResult
+{
+	int frames{0};
+	int missed{0};
+	//! Mean time from the wake up the app was given to the display time.
+	double latency_ms{0};
+
+	double
+	miss_rate() const
+	{
+		return (double)missed / (double)frames;
+	}
+};
+
+static constexpr unanoseconds appCompositorTime(4ms);
+
+//! Every frame about the same.
+AppFrameTimes
+steadyFrame(TraceRandom &random)
+{
+	return {random.jitter(1ms), random.jitter(2ms), random.jitter(3ms)};
+}
+
+//! Like a game that does extra work on every few frames, 15% of the frames take almost twice as long.
+AppFrameTimes
+bimodalFrame(TraceRandom &random)
+{
+	if (random.next() < 0.15) {
+		return {random.jitter(2ms), random.jitter(4ms), random.jitter(5ms)};
+	}
+	return steadyFrame(random);
+}
+
+/*!
+ * Plays an app that waits, begins, submits and has its GPU work complete
+ * as timed by @p trace, against a compositor that needs @ref
+ * appCompositorTime. The first frames are left out while the pacer warms up.
+ */
+AppPacingResult
+runAppTrace(const u_pa_config &config, const AppTrace &trace, int frame_count)
+{
+	u_pacing_app_factory *upaf = nullptr;
+	REQUIRE(XRT_SUCCESS == u_pa_factory_create_with_config(&config, &upaf));
+
+	u_pacing_app *upa = nullptr;
+	u_paf_create(upaf, &upa);
+	REQUIRE(upa != nullptr);
+
+	const int warm_up = 64;
+	const int64_t period_ns = frame_interval_ns.count();
+
+	MockClock clock;
+	TraceRandom random;
+	AppPacingResult result;
+	int64_t first_display_ns = clock.now() + period_ns;
+	double latency_ns = 0;
+
+	for (int i = 0; i < warm_up + frame_count; i++) {
+		// What the compositor passes on from its own pacing.
+		int64_t next_display_ns = getNextPresentAfterTimestampAndKnownPresent(clock.now(), first_display_ns);
+		u_pa_info(upa, next_display_ns, period_ns, appCompositorTime.count());
+
+		int64_t frame_id = 0;
+		int64_t wake_up_ns = 0;
+		int64_t display_ns = 0;
+		int64_t display_period_ns = 0;
+		u_pa_predict(upa, clock.now(), &frame_id, &wake_up_ns, &display_ns, &display_period_ns);
+		CHECK(wake_up_ns >= clock.now());
+		CHECK(display_ns > wake_up_ns);
+
+		AppFrameTimes times = trace(random);
+
+		clock.advance_to(wake_up_ns);
+		clock.advance(wakeDelay);
+		u_pa_mark_point(upa, frame_id, U_TIMING_POINT_WAKE_UP, clock.now());
+		clock.advance(times.cpu);
+		u_pa_mark_point(upa, frame_id, U_TIMING_POINT_BEGIN, clock.now());
+		clock.advance(times.draw);
+		u_pa_mark_delivered(upa, frame_id, clock.now(), display_ns);
+		clock.advance(times.gpu);
+		u_pa_mark_gpu_done(upa, frame_id, clock.now());
+
+		if (i < warm_up) {
+			continue;
+		}
+
+		result.frames++;
+		if (clock.now() > display_ns - appCompositorTime.count()) {
+			result.missed++;
+		}
+		latency_ns += (double)(display_ns - wake_up_ns);
+	}
+
+	result.latency_ms = latency_ns / (double)result.frames / 1e6;
+
+	u_pa_destroy(&upa);
+	u_paf_destroy(&upaf);
+
+	return result;
+}
+
+u_pa_config
+percentileConfig(float miss_target_percentage)
+{
+	u_pa_config config = U_PA_CONFIG_DEFAULT;
+	config.mode = U_PA_MODE_PERCENTILE;
+	config.min_margin_ms = 0.5f;
+	config.miss_target_percentage = miss_target_percentage;
+	return config;
+}
+
+void
+printAppPacingResult(const char *name, const AppPacingResult &result)
+{
+	std::cout << std::left << std::setw(24) << name << " latency: " << std::fixed << std::setprecision(2)
+	          << result.latency_ms << "ms, missed: " << result.missed << "/" << result.frames << std::endl;
+}
+
+} // namespace
+
+TEST_CASE("u_pacing_app")
+{
+	const int frame_count = 2000;
+
+	SECTION("steady app")
+	{
+		AppPacingResult iir = runAppTrace(U_PA_CONFIG_DEFAULT, steadyFrame, frame_count);
+		AppPacingResult percentile = runAppTrace(percentileConfig(1.0f), steadyFrame, frame_count);
+		printAppPacingResult("steady iir", iir);
+		printAppPacingResult("steady percentile 1%", percentile);
+
+		// Neither misses, but the fixed margin is more than the app needs.
+		CHECK(iir.missed == 0);
+		CHECK(percentile.missed == 0);
+		CHECK(percentile.latency_ms < iir.latency_ms - 1.0);
+	}
+
+	SECTION("bimodal app")
+	{
+		AppPacingResult iir = runAppTrace(U_PA_CONFIG_DEFAULT, bimodalFrame, frame_count);
+		AppPacingResult percentile = runAppTrace(percentileConfig(1.0f), bimodalFrame, frame_count);
+		AppPacingResult relaxed = runAppTrace(percentileConfig(20.0f), bimodalFrame, frame_count);
+		printAppPacingResult("bimodal iir", iir);
+		printAppPacingResult("bimodal percentile 1%", percentile);
+		printAppPacingResult("bimodal percentile 20%", relaxed);
+
+		// The average plus a fixed margin misses most of the slow frames.
+		CHECK(iir.miss_rate() > 0.10);
+
+		// Starts the app early enough for the slow frames, at some latency.
+		CHECK(percentile.miss_rate() < 0.01);
+		CHECK(percentile.latency_ms > iir.latency_ms);
+
+		// A looser target trades the latency back for misses, while staying under it.
+		CHECK(relaxed.latency_ms < percentile.latency_ms);
+		CHECK(relaxed.miss_rate() > 0.10);
+		CHECK(relaxed.miss_rate() < 0.20);
+	}
+}
+
+
+/*
+ *
+ * Compositor trace replay.
+ *
+ */
+
+namespace {
+
+//! Time the compositor's CPU and GPU take for one frame.
+struct CompFrameTimes
+{
+	unanoseconds cpu;
+	unanoseconds gpu;
+};
+
+using CompTrace = std::function<CompFrameTimes(TraceRandom &)>;
+
+//! A display with exactly periodic vblanks, that are reported with some jitter.
+struct SimulatedDisplay
+{
+	//! What the display says its period is.
+	unanoseconds nominal_period;
+	//! What it actually runs at.
+	unanoseconds period;
+	//! Reported vblanks are off by up to this, either way.
+	unanoseconds report_jitter;
+
+	int64_t first_vblank_ns{0};
+
+	//! The first vblank at or after @p time_ns.
+	int64_t
+	nextVblank(int64_t time_ns) const
+	{
+		int64_t periods = (time_ns - first_vblank_ns + period.count() - 1) / period.count();
+		return first_vblank_ns + periods * period.count();
+	}
+
+	int64_t
+	report(int64_t vblank_ns, TraceRandom &random) const
+	{
+		return vblank_ns + (int64_t)((random.next() * 2.0 - 1.0) * (double)report_jitter.count());
+	}
+};
+
+struct PendingInfo
+{
+	int64_t when_ns;
+	int64_t frame_id;
+	int64_t desired_present_time_ns;
+	int64_t actual_present_time_ns;
+	int64_t earliest_present_time_ns;
+	int64_t present_margin_ns;
+};
+
+struct CompPacingResult
+{
+	int frames{0};
+	int missed{0};
+	//! Mean time from the compositor waking up to its frame being presented.
+	double latency_ms{0};
+	//! Largest distance between a desired present time and the vblank it was meant for.
+	double max_present_error_us{0};
+	//! The last display period the pacer predicted.
+	int64_t display_period_ns{0};
+
+	double
+	miss_rate() const
+	{
+		return (double)missed / (double)frames;
+	}
+};
+
+//! Every frame about the same.
+CompFrameTimes
+steadyCompFrame(TraceRandom &random)
+{
+	return {random.jitter(1ms), random.jitter(2ms)};
+}
+
+/*!
+ * Like other work on the GPU getting in the way now and then, 5% of the frames
+ * take 1.5ms more GPU time. Lighter than the steady trace so even the spikes
+ * stay under the largest compositor time.
+ */
+CompFrameTimes
+spikyCompFrame(TraceRandom &random)
+{
+	CompFrameTimes times = {random.jitter(500us), random.jitter(1ms)};
+	if (random.next() < 0.05) {
+		times.gpu += 1500us;
+	}
+	return times;
+}
+
+/*!
+ * Replays @p trace through a compositor loop on @p display: predict, sleep,
+ * render, and get present feedback a millisecond after each present. With
+ * @p display_control the vblanks are also passed on like the vblank thread
+ * does. The first frames are left out while the pacer settles.
+ */
+CompPacingResult
+replayCompTrace(const u_pc_display_timing_config &config,
+                SimulatedDisplay display,
+                const CompTrace &trace,
+                int frame_count,
+                bool display_control)
+{
+	const int warm_up = 100;
+
+	MockClock clock;
+	TraceRandom random;
+	CompPacingResult result;
+	std::deque<PendingInfo> infos;
+	double latency_ns = 0;
+
+	display.first_vblank_ns = clock.now() + unanoseconds(1ms).count();
+
+	u_pacing_compositor *upc = nullptr;
+	REQUIRE(XRT_SUCCESS == u_pc_display_timing_create(display.nominal_period.count(), &config, &upc));
+
+	for (int i = 0; i < warm_up + frame_count; i++) {
+		while (!infos.empty() && infos.front().when_ns <= clock.now()) {
+			const PendingInfo &info = infos.front();
+			u_pc_info(upc, info.frame_id, info.desired_present_time_ns, info.actual_present_time_ns,
+			          info.earliest_present_time_ns, info.present_margin_ns, info.when_ns);
+			infos.pop_front();
+		}
+
+		if (display_control) {
+			int64_t last_vblank_ns = display.nextVblank(clock.now()) - display.period.count();
+			u_pc_update_vblank_from_display_control(upc, display.report(last_vblank_ns, random));
+		}
+
+		CompositorPredictions predictions;
+		u_pc_predict(upc, clock.now(), &predictions.frame_id, &predictions.wake_up_time_ns,
+		             &predictions.desired_present_time_ns, &predictions.present_slop_ns,
+		             &predictions.predicted_display_time_ns, &predictions.predicted_display_period_ns,
+		             &predictions.min_display_period_ns);
+		REQUIRE(predictions.desired_present_time_ns > predictions.wake_up_time_ns);
+
+		CompFrameTimes times = trace(random);
+
+		if (predictions.wake_up_time_ns > clock.now()) {
+			clock.advance_to(predictions.wake_up_time_ns);
+		}
+		clock.advance(wakeDelay);
+		int64_t woke_ns = clock.now();
+		u_pc_mark_point(upc, U_TIMING_POINT_WAKE_UP, predictions.frame_id, clock.now());
+		clock.advance(shortBeginDelay);
+		u_pc_mark_point(upc, U_TIMING_POINT_BEGIN, predictions.frame_id, clock.now());
+		clock.advance(times.cpu);
+		u_pc_mark_point(upc, U_TIMING_POINT_SUBMIT_BEGIN, predictions.frame_id, clock.now());
+		clock.advance(shortSubmitDelay);
+		u_pc_mark_point(upc, U_TIMING_POINT_SUBMIT_END, predictions.frame_id, clock.now());
+
+		int64_t gpu_start_ns = clock.now();
+		int64_t gpu_end_ns = gpu_start_ns + times.gpu.count();
+		u_pc_info_gpu(upc, predictions.frame_id, gpu_start_ns, gpu_end_ns, gpu_end_ns);
+
+		// Presented on the vblank asked for, unless the GPU is still busy then.
+		int64_t intended_ns =
+		    display.nextVblank(predictions.desired_present_time_ns - predictions.present_slop_ns);
+		int64_t earliest_ns = display.nextVblank(gpu_end_ns);
+		int64_t actual_ns = std::max(intended_ns, earliest_ns);
+
+		int64_t reported_ns = display.report(actual_ns, random);
+		int64_t reported_earliest_ns = earliest_ns + (reported_ns - actual_ns);
+		infos.push_back({actual_ns + unanoseconds(1ms).count(), predictions.frame_id,
+		                 predictions.desired_present_time_ns, reported_ns, reported_earliest_ns,
+		                 earliest_ns - gpu_end_ns});
+
+		if (i < warm_up) {
+			continue;
+		}
+
+		result.frames++;
+		if (actual_ns > intended_ns) {
+			result.missed++;
+		}
+		latency_ns += (double)(actual_ns - woke_ns);
+
+		double error_us = (double)std::abs(predictions.desired_present_time_ns - intended_ns) / 1e3;
+		result.max_present_error_us = std::max(result.max_present_error_us, error_us);
+		result.display_period_ns = predictions.predicted_display_period_ns;
+	}
+
+	result.latency_ms = latency_ns / (double)result.frames / 1e6;
+
+	u_pc_destroy(&upc);
+
+	return result;
+}
+
+u_pc_display_timing_config
+modelConfig()
+{
+	u_pc_display_timing_config config = U_PC_DISPLAY_TIMING_CONFIG_DEFAULT;
+	config.fit_model = true;
+	return config;
+}
+
+void
+printCompPacingResult(const char *name, const CompPacingResult &result)
+{
+	std::cout << std::left << std::setw(24) << name << " latency: " << std::fixed << std::setprecision(2)
+	          << result.latency_ms << "ms, missed: " << result.missed << "/" << result.frames
+	          << ", present error: " << result.max_present_error_us << "us" << std::endl;
+}
+
+} // namespace
+
+TEST_CASE("u_pacing_compositor_model")
+{
+	const int frame_count = 2000;
+
+	SECTION("steady compositor")
+	{
+		SimulatedDisplay display = {11111111ns, 11111111ns, 50us};
+
+		CompPacingResult stepped =
+		    replayCompTrace(U_PC_DISPLAY_TIMING_CONFIG_DEFAULT, display, steadyCompFrame, frame_count, false);
+		CompPacingResult model = replayCompTrace(modelConfig(), display, steadyCompFrame, frame_count, false);
+		printCompPacingResult("steady stepped", stepped);
+		printCompPacingResult("steady model", model);
+
+		// Neither misses, but the model wakes up later.
+		CHECK(stepped.missed == 0);
+		CHECK(model.missed == 0);
+		CHECK(model.latency_ms < stepped.latency_ms - 0.5);
+	}
+
+	SECTION("gpu spikes")
+	{
+		SimulatedDisplay display = {11111111ns, 11111111ns, 50us};
+
+		CompPacingResult stepped =
+		    replayCompTrace(U_PC_DISPLAY_TIMING_CONFIG_DEFAULT, display, spikyCompFrame, frame_count, false);
+		CompPacingResult model = replayCompTrace(modelConfig(), display, spikyCompFrame, frame_count, false);
+		printCompPacingResult("spiky stepped", stepped);
+		printCompPacingResult("spiky model", model);
+
+		// Stepping towards the margin misses the spikes, the distribution covers them.
+		CHECK(stepped.miss_rate() > 0.02);
+		CHECK(model.miss_rate() < 0.01);
+	}
+
+	SECTION("display slower than reported")
+	{
+		// Says 60Hz but runs at 59.94Hz, like many TV modes.
+		SimulatedDisplay display = {16666667ns, 16683350ns, 50us};
+
+		CompPacingResult stepped =
+		    replayCompTrace(U_PC_DISPLAY_TIMING_CONFIG_DEFAULT, display, steadyCompFrame, frame_count, true);
+		CompPacingResult model = replayCompTrace(modelConfig(), display, steadyCompFrame, frame_count, true);
+		printCompPacingResult("slower stepped", stepped);
+		printCompPacingResult("slower model", model);
+
+		// The fit finds the real period and phase.
+		CHECK(model.missed == 0);
+		CHECK(std::abs(model.display_period_ns - display.period.count()) < 2000);
+		CHECK(model.max_present_error_us < 100.0);
+		CHECK(model.max_present_error_us < stepped.max_present_error_us);
+	}
+}
@@ -0,0 +1,287 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Test the batch pose and quaternion functions against the single ones.
+ */
+
+#include "catch_amalgamated.hpp"
+
+#include <math/m_api.h>
+#include <math/m_batch.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+
+using Catch::Approx;
+
+namespace {
+
+constexpr float margin = 1e-5f;
+
+std::vector<const m_batch_funcs *>
+all_funcs()
+{
+	std::vector<const m_batch_funcs *> ret;
+	for (uint32_t i = 0; i < M_BATCH_ISA_COUNT; i++) {
+		const m_batch_funcs *funcs = m_batch_get_funcs((m_batch_isa)i);
+		if (funcs != nullptr) {
+			ret.push_back(funcs);
+		}
+	}
+	return ret;
+}
+
+xrt_quat
+random_quat(std::mt19937 &rng)
+{
+	std::uniform_real_distribution<float> dist(-1.f, 1.f);
+	xrt_quat q = {dist(rng), dist(rng), dist(rng), dist(rng)};
+	math_quat_normalize(&q);
+	return q;
+}
+
+xrt_vec3
+random_vec3(std::mt19937 &rng)
+{
+	std::uniform_real_distribution<float> dist(-10.f, 10.f);
+	return {dist(rng), dist(rng), dist(rng)};
+}
+
+xrt_pose
+random_pose(std::mt19937 &rng)
+{
+	return {random_quat(rng), random_vec3(rng)};
+}
+
+void
+check_quat(const xrt_quat &expected, const xrt_quat &actual)
+{
+	CHECK(expected.x == Approx(actual.x).margin(margin));
+	CHECK(expected.y == Approx(actual.y).margin(margin));
+	CHECK(expected.z == Approx(actual.z).margin(margin));
+	CHECK(expected.w == Approx(actual.w).margin(margin));
+}
+
+void
+check_vec3(const xrt_vec3 &expected, const xrt_vec3 &actual)
+{
+	// Vectors are up to 10 long, so allow a bit more.
+	CHECK(expected.x == Approx(actual.x).margin(margin * 10));
+	CHECK(expected.y == Approx(actual.y).margin(margin * 10));
+	CHECK(expected.z == Approx(actual.z).margin(margin * 10));
+}
+
+} // namespace
+
+
+TEST_CASE("batch_funcs_available")
+{
+	// Scalar is always there and the best pick is one of the available ones.
+	REQUIRE(m_batch_get_funcs(M_BATCH_ISA_SCALAR) != nullptr);
+
+	const m_batch_funcs *best = m_batch_get_best();
+	REQUIRE(best != nullptr);
+
+	bool found = false;
+	for (const m_batch_funcs *funcs : all_funcs()) {
+		found = found || funcs == best;
+	}
+	CHECK(found);
+}
+
+TEST_CASE("batch_pose_transform")
+{
+	std::mt19937 rng(33);
+
+	for (const m_batch_funcs *funcs : all_funcs()) {
+		DYNAMIC_SECTION(funcs->name)
+		{
+			// Cover empty, partial and several full blocks.
+			for (uint32_t count = 0; count < 37; count++) {
+				const xrt_pose transform = random_pose(rng);
+				std::vector<xrt_pose> poses(count);
+				for (xrt_pose &p : poses) {
+					p = random_pose(rng);
+				}
+
+				std::vector<xrt_pose> out(count);
+				funcs->pose_transform(&transform, poses.data(), count, out.data());
+
+				for (uint32_t i = 0; i < count; i++) {
+					xrt_pose expected;
+					math_pose_transform(&transform, &poses[i], &expected);
+					check_quat(expected.orientation, out[i].orientation);
+					check_vec3(expected.position, out[i].position);
+				}
+
+				// In place gives the same result.
+				funcs->pose_transform(&transform, poses.data(), count, poses.data());
+				CHECK(memcmp(poses.data(), out.data(), count * sizeof(xrt_pose)) == 0);
+			}
+		}
+	}
+}
+
+TEST_CASE("batch_quat_rotate")
+{
+	std::mt19937 rng(34);
+
+	for (const m_batch_funcs *funcs : all_funcs()) {
+		DYNAMIC_SECTION(funcs->name)
+		{
+			for (uint32_t count = 0; count < 37; count++) {
+				const xrt_quat left = random_quat(rng);
+				std::vector<xrt_quat> quats(count);
+				std::vector<xrt_vec3> vecs(count);
+				for (uint32_t i = 0; i < count; i++) {
+					quats[i] = random_quat(rng);
+					vecs[i] = random_vec3(rng);
+				}
+
+				std::vector<xrt_quat> out_quats(count);
+				std::vector<xrt_vec3> out_vecs(count);
+				funcs->quat_rotate(&left, quats.data(), count, out_quats.data());
+				funcs->quat_rotate_vec3(&left, vecs.data(), count, out_vecs.data());
+
+				for (uint32_t i = 0; i < count; i++) {
+					xrt_quat expected_quat;
+					math_quat_rotate(&left, &quats[i], &expected_quat);
+					check_quat(expected_quat, out_quats[i]);
+
+					xrt_vec3 expected_vec;
+					math_quat_rotate_vec3(&left, &vecs[i], &expected_vec);
+					check_vec3(expected_vec, out_vecs[i]);
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("batch_quat_slerp")
+{
+	std::mt19937 rng(35);
+	std::uniform_real_distribution<float> small(-1e-4f, 1e-4f);
+
+	const uint32_t count = 64;
+	std::vector<xrt_quat> lefts(count);
+	std::vector<xrt_quat> rights(count);
+
+	for (uint32_t i = 0; i < count; i++) {
+		lefts[i] = random_quat(rng);
+
+		switch (i % 4) {
+		case 0: rights[i] = random_quat(rng); break;
+		// Same orientation, takes the lerp path.
+		case 1: rights[i] = lefts[i]; break;
+		// Other hemisphere.
+		case 2: rights[i] = {-lefts[i].x, -lefts[i].y, -lefts[i].z, -lefts[i].w}; break;
+		// Very close but not the same.
+		case 3:
+			rights[i] = {lefts[i].x + small(rng), lefts[i].y + small(rng), lefts[i].z + small(rng),
+			             lefts[i].w + small(rng)};
+			math_quat_normalize(&rights[i]);
+			break;
+		}
+	}
+
+	// Including extrapolation.
+	const float ts[] = {0.f, 0.25f, 0.5f, 0.9f, 1.f, -0.5f, 1.5f, 3.f};
+
+	for (const m_batch_funcs *funcs : all_funcs()) {
+		DYNAMIC_SECTION(funcs->name)
+		{
+			for (float t : ts) {
+				std::vector<xrt_quat> out(count);
+				funcs->quat_slerp(lefts.data(), rights.data(), t, count, out.data());
+
+				for (uint32_t i = 0; i < count; i++) {
+					xrt_quat expected;
+					math_quat_slerp(&lefts[i], &rights[i], t, &expected);
+					check_quat(expected, out[i]);
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("batch_public_functions")
+{
+	std::mt19937 rng(36);
+
+	const xrt_pose transform = random_pose(rng);
+	xrt_pose poses[26];
+	xrt_quat quats[26];
+	for (uint32_t i = 0; i < 26; i++) {
+		poses[i] = random_pose(rng);
+		quats[i] = random_quat(rng);
+	}
+
+	xrt_pose out_poses[26];
+	math_pose_transform_batch(&transform, poses, 26, out_poses);
+
+	xrt_quat out_quats[26];
+	math_quat_slerp_batch(quats, quats, 0.5f, 26, out_quats);
+
+	for (uint32_t i = 0; i < 26; i++) {
+		xrt_pose expected;
+		math_pose_transform(&transform, &poses[i], &expected);
+		check_quat(expected.orientation, out_poses[i].orientation);
+		check_vec3(expected.position, out_poses[i].position);
+		check_quat(quats[i], out_quats[i]);
+	}
+}
+
+TEST_CASE("batch_benchmark", "[.][benchmark]")
+{
+	std::mt19937 rng(37);
+
+	// A hand worth of joints and a large array.
+	for (uint32_t count : {26u, 1024u}) {
+		const xrt_pose transform = random_pose(rng);
+		std::vector<xrt_pose> poses(count);
+		std::vector<xrt_quat> lefts(count);
+		std::vector<xrt_quat> rights(count);
+		for (uint32_t i = 0; i < count; i++) {
+			poses[i] = random_pose(rng);
+			lefts[i] = random_quat(rng);
+			rights[i] = random_quat(rng);
+		}
+
+		std::vector<xrt_pose> out_poses(count);
+		std::vector<xrt_quat> out_quats(count);
+		const std::string n = std::to_string(count);
+
+		BENCHMARK("math_pose_transform x" + n)
+		{
+			for (uint32_t i = 0; i < count; i++) {
+				math_pose_transform(&transform, &poses[i], &out_poses[i]);
+			}
+			return out_poses[0].position.x;
+		};
+
+		BENCHMARK("math_quat_slerp x" + n)
+		{
+			for (uint32_t i = 0; i < count; i++) {
+				math_quat_slerp(&lefts[i], &rights[i], 0.3f, &out_quats[i]);
+			}
+			return out_quats[0].x;
+		};
+
+		for (const m_batch_funcs *funcs : all_funcs()) {
+			BENCHMARK(std::string("pose_transform ") + funcs->name + " x" + n)
+			{
+				funcs->pose_transform(&transform, poses.data(), count, out_poses.data());
+				return out_poses[0].position.x;
+			};
+
+			BENCHMARK(std::string("quat_slerp ") + funcs->name + " x" + n)
+			{
+				funcs->quat_slerp(lefts.data(), rights.data(), 0.3f, count, out_quats.data());
+				return out_quats[0].x;
+			};
+		}
+	}
+}
@@ -0,0 +1,171 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Test the relation history prediction evaluation and model selection.
+ */
+
+#include "catch_amalgamated.hpp"
+
+#include <math/m_api.h>
+#include <math/m_relation_history.h>
+#include <util/u_time.h>
+
+
+using Catch::Approx;
+
+namespace {
+
+constexpr xrt_space_relation_flags kFlagsAll = (xrt_space_relation_flags)( //
+    XRT_SPACE_RELATION_ORIENTATION_VALID_BIT |                             //
+    XRT_SPACE_RELATION_POSITION_VALID_BIT |                                //
+    XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT |                         //
+    XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT);                        //
+
+constexpr int64_t kSecondNs = U_TIME_1S_IN_NS;
+constexpr int64_t kStepNs = 2 * U_TIME_1MS_IN_NS;
+constexpr int64_t kHorizonNs = 20 * U_TIME_1MS_IN_NS;
+
+/*!
+ * Moves along x with the given velocity and acceleration, pushing a sample
+ * every step and asking for a prediction @ref kHorizonNs out after each one,
+ * like a compositor would.
+ */
+void
+run_motion(m_relation_history *rh, float velocity, float acceleration, int steps)
+{
+	for (int i = 1; i <= steps; i++) {
+		const int64_t ts = i * kStepNs;
+		const float t = (float)time_ns_to_s(ts);
+
+		xrt_space_relation rel = {};
+		rel.relation_flags = kFlagsAll;
+		rel.pose.orientation.w = 1.0f;
+		rel.pose.position.x = velocity * t + 0.5f * acceleration * t * t;
+		rel.linear_velocity.x = velocity + acceleration * t;
+		REQUIRE(m_relation_history_push(rh, &rel, ts));
+
+		xrt_space_relation out = {};
+		CHECK(m_relation_history_get(rh, ts + kHorizonNs, &out) == M_RELATION_HISTORY_RESULT_PREDICTED);
+	}
+}
+
+} // namespace
+
+
+TEST_CASE("relation_history_get")
+{
+	m_relation_history *rh = nullptr;
+	m_relation_history_create(&rh, nullptr);
+
+	xrt_space_relation out = {};
+	CHECK(m_relation_history_get(rh, 1, &out) == M_RELATION_HISTORY_RESULT_INVALID);
+
+	xrt_space_relation rel = {};
+	rel.relation_flags = kFlagsAll;
+	rel.pose.orientation.w = 1.0f;
+	rel.linear_velocity.x = 1.0f;
+	REQUIRE(m_relation_history_push(rh, &rel, kSecondNs));
+	rel.pose.position.x = 1.0f;
+	REQUIRE(m_relation_history_push(rh, &rel, 2 * kSecondNs));
+
+	// Not monotonic.
+	CHECK_FALSE(m_relation_history_push(rh, &rel, 2 * kSecondNs));
+
+	CHECK(m_relation_history_get(rh, kSecondNs, &out) == M_RELATION_HISTORY_RESULT_EXACT);
+	CHECK(out.pose.position.x == 0.0f);
+
+	CHECK(m_relation_history_get(rh, kSecondNs + kSecondNs / 4, &out) ==
+	      M_RELATION_HISTORY_RESULT_INTERPOLATED);
+	CHECK(out.pose.position.x == Approx(0.25f));
+
+	CHECK(m_relation_history_get(rh, 3 * kSecondNs, &out) == M_RELATION_HISTORY_RESULT_PREDICTED);
+	CHECK(out.pose.position.x == Approx(2.0f));
+
+	CHECK(m_relation_history_get(rh, kSecondNs / 2, &out) ==
+	      M_RELATION_HISTORY_RESULT_REVERSE_PREDICTED);
+	CHECK(out.pose.position.x == Approx(-0.5f));
+
+	m_relation_history_destroy(&rh);
+	CHECK(rh == nullptr);
+}
+
+TEST_CASE("relation_history_prediction_eval")
+{
+	m_relation_history *rh = nullptr;
+	m_relation_history_create(&rh, nullptr);
+	m_relation_history_set_prediction_model(rh, M_PREDICT_MODEL_CONSTANT_VELOCITY, false);
+
+	m_relation_history_prediction_stats stats[M_PREDICT_MODEL_COUNT];
+
+	SECTION("off")
+	{
+		m_relation_history_set_prediction_eval(rh, false);
+		run_motion(rh, 1.0f, 0.0f, 100);
+
+		m_relation_history_get_prediction_stats(rh, stats);
+		for (const auto &s : stats) {
+			CHECK(s.count == 0);
+		}
+	}
+
+	SECTION("constant velocity")
+	{
+		m_relation_history_set_prediction_eval(rh, true);
+		run_motion(rh, 1.0f, 0.0f, 100);
+
+		// The last predictions are still waiting for their samples.
+		const uint64_t expected = 100 - kHorizonNs / kStepNs;
+
+		m_relation_history_get_prediction_stats(rh, stats);
+		for (const auto &s : stats) {
+			CHECK(s.count == expected);
+			CHECK(s.position_error_m == Approx(0.0f).margin(1e-4f));
+			CHECK(s.orientation_error_rad == Approx(0.0f).margin(1e-4f));
+		}
+	}
+
+	SECTION("constant acceleration")
+	{
+		m_relation_history_set_prediction_eval(rh, true);
+		run_motion(rh, 0.0f, 10.0f, 100);
+
+		m_relation_history_get_prediction_stats(rh, stats);
+
+		// Constant velocity is off by half the acceleration times the horizon squared.
+		const float h = (float)time_ns_to_s(kHorizonNs);
+		const float cv_error = 0.5f * 10.0f * h * h;
+		CHECK(stats[M_PREDICT_MODEL_CONSTANT_VELOCITY].position_error_m == Approx(cv_error).epsilon(0.01));
+		CHECK(stats[M_PREDICT_MODEL_CONSTANT_ACCELERATION].position_error_m < 1e-3f);
+		CHECK(stats[M_PREDICT_MODEL_FILTERED].position_error_m >
+		      stats[M_PREDICT_MODEL_CONSTANT_VELOCITY].position_error_m);
+
+		// Not adaptive so it stays.
+		CHECK(m_relation_history_get_prediction_model(rh) == M_PREDICT_MODEL_CONSTANT_VELOCITY);
+	}
+
+	m_relation_history_destroy(&rh);
+}
+
+TEST_CASE("relation_history_adaptive")
+{
+	m_relation_history *rh = nullptr;
+	m_relation_history_create(&rh, nullptr);
+	m_relation_history_set_prediction_model(rh, M_PREDICT_MODEL_CONSTANT_VELOCITY, true);
+
+	run_motion(rh, 0.0f, 10.0f, 100);
+	CHECK(m_relation_history_get_prediction_model(rh) == M_PREDICT_MODEL_CONSTANT_ACCELERATION);
+
+	// The prediction now uses the acceleration.
+	int64_t ts = 0;
+	xrt_space_relation latest = {};
+	REQUIRE(m_relation_history_get_latest(rh, &ts, &latest));
+
+	xrt_space_relation out = {};
+	CHECK(m_relation_history_get(rh, ts + kHorizonNs, &out) == M_RELATION_HISTORY_RESULT_PREDICTED);
+
+	const float t = (float)time_ns_to_s(ts + kHorizonNs);
+	CHECK(out.pose.position.x == Approx(0.5f * 10.0f * t * t).epsilon(1e-3));
+
+	m_relation_history_destroy(&rh);
+}
@@ -0,0 +1,215 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Packed half float distortion image tests.
+ */
+
+#include "render/render_interface.h"
+
+#include "catch_amalgamated.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+
+namespace {
+
+constexpr int kDim = RENDER_DISTORTION_IMAGE_DIMENSIONS;
+
+//! Source image width used to turn UV errors into pixels.
+constexpr float kSourcePixels = 2048.0f;
+
+float
+half_to_float(uint16_t h)
+{
+	uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+	uint32_t exponent = (h >> 10) & 0x1f;
+	uint32_t mantissa = h & 0x3ff;
+
+	if (exponent == 0) {
+		float value = std::ldexp((float)mantissa, -24);
+		return sign != 0 ? -value : value;
+	}
+	if (exponent == 31) {
+		uint32_t bits = sign | 0x7f800000 | (mantissa << 13);
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	uint32_t bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+	float value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+uint16_t
+pack_one(float value)
+{
+	xrt_uv_triplet result = {};
+	result.r.x = value;
+	xrt_vec2 grid_uv = {0.0f, 0.0f};
+
+	uint16_t rg[4];
+	uint16_t b[2];
+	render_distortion_pack_half(&result, &grid_uv, rg, b);
+
+	return rg[0];
+}
+
+//! Barrel distortion with lateral chromatic aberration, like a typical lens.
+xrt_vec2
+distort(float u, float v, float channel_scale)
+{
+	float x = u - 0.5f;
+	float y = v - 0.5f;
+	float r2 = x * x + y * y;
+	float f = channel_scale * (1.0f + 0.22f * r2 + 0.24f * r2 * r2);
+
+	return {0.5f + x * f, 0.5f + y * f};
+}
+
+//! Same filtering the sampler does, texel centres are at k / (dim - 1) in UV.
+template <typename Fetch>
+xrt_vec2
+sample_bilinear(float u, float v, Fetch fetch)
+{
+	float tx = u * (kDim - 1);
+	float ty = v * (kDim - 1);
+	int x0 = std::min((int)tx, kDim - 2);
+	int y0 = std::min((int)ty, kDim - 2);
+	float fx = tx - (float)x0;
+	float fy = ty - (float)y0;
+
+	xrt_vec2 a = fetch(x0, y0);
+	xrt_vec2 b = fetch(x0 + 1, y0);
+	xrt_vec2 c = fetch(x0, y0 + 1);
+	xrt_vec2 d = fetch(x0 + 1, y0 + 1);
+
+	xrt_vec2 top = {a.x + (b.x - a.x) * fx, a.y + (b.y - a.y) * fx};
+	xrt_vec2 bottom = {c.x + (d.x - c.x) * fx, c.y + (d.y - c.y) * fx};
+
+	return {top.x + (bottom.x - top.x) * fy, top.y + (bottom.y - top.y) * fy};
+}
+
+} // namespace
+
+
+TEST_CASE("render_distortion_pack_half")
+{
+	SECTION("exact values")
+	{
+		CHECK(pack_one(0.0f) == 0x0000);
+		CHECK(pack_one(-0.0f) == 0x8000);
+		CHECK(pack_one(1.0f) == 0x3c00);
+		CHECK(pack_one(-2.0f) == 0xc000);
+		CHECK(pack_one(0.5f) == 0x3800);
+		CHECK(pack_one(65504.0f) == 0x7bff);
+	}
+
+	SECTION("rounding")
+	{
+		// Exactly halfway between 1.0 and the next half, rounds to even.
+		CHECK(pack_one(1.0f + std::ldexp(1.0f, -11)) == 0x3c00);
+		CHECK(pack_one(1.0f + 3.0f * std::ldexp(1.0f, -11)) == 0x3c02);
+		CHECK(half_to_float(pack_one(1.0f / 3.0f)) == Catch::Approx(1.0f / 3.0f).margin(1e-4));
+
+		// Rounding up carries into the exponent.
+		CHECK(pack_one(std::nextafter(2.0f, 0.0f)) == 0x4000);
+	}
+
+	SECTION("out of range")
+	{
+		CHECK(pack_one(65520.0f) == 0x7c00);
+		CHECK(pack_one(-1e9f) == 0xfc00);
+		CHECK(pack_one(INFINITY) == 0x7c00);
+		CHECK((pack_one(NAN) & 0x7c00) == 0x7c00);
+		CHECK((pack_one(NAN) & 0x3ff) != 0);
+	}
+
+	SECTION("subnormals")
+	{
+		CHECK(pack_one(std::ldexp(1.0f, -24)) == 0x0001);
+		CHECK(pack_one(std::ldexp(1.0f, -14)) == 0x0400);
+		CHECK(pack_one(std::ldexp(3.0f, -25)) == 0x0002);
+		CHECK(pack_one(std::ldexp(1.0f, -26)) == 0x0000);
+	}
+
+	SECTION("offsets are from the grid position")
+	{
+		xrt_uv_triplet result = {{0.25f, 0.75f}, {0.5f, 0.5f}, {1.0f, 0.0f}};
+		xrt_vec2 grid_uv = {0.5f, 0.5f};
+
+		uint16_t rg[4];
+		uint16_t b[2];
+		render_distortion_pack_half(&result, &grid_uv, rg, b);
+
+		CHECK(half_to_float(rg[0]) == -0.25f);
+		CHECK(half_to_float(rg[1]) == 0.25f);
+		CHECK(half_to_float(rg[2]) == 0.0f);
+		CHECK(half_to_float(rg[3]) == 0.0f);
+		CHECK(half_to_float(b[0]) == 0.5f);
+		CHECK(half_to_float(b[1]) == -0.5f);
+	}
+}
+
+TEST_CASE("render_distortion_packed_matches_float")
+{
+	const float channel_scales[3] = {0.99f, 1.0f, 1.012f};
+
+	std::vector<xrt_uv_triplet> full(kDim * kDim);
+	std::vector<uint16_t> rg(kDim * kDim * 4);
+	std::vector<uint16_t> b(kDim * kDim * 2);
+
+	// Fill in both formats like render_distortion.c does.
+	for (int row = 0; row < kDim; row++) {
+		float v = (float)(row / (double)(kDim - 1));
+		for (int col = 0; col < kDim; col++) {
+			float u = (float)(col / (double)(kDim - 1));
+			size_t i = (size_t)row * kDim + (size_t)col;
+
+			xrt_uv_triplet &result = full[i];
+			result.r = distort(u, v, channel_scales[0]);
+			result.g = distort(u, v, channel_scales[1]);
+			result.b = distort(u, v, channel_scales[2]);
+
+			xrt_vec2 grid_uv = {u, v};
+			render_distortion_pack_half(&result, &grid_uv, &rg[i * 4], &b[i * 2]);
+		}
+	}
+
+	// Walk the target like a 1000x1100 pixel view, sampling at pixel centres.
+	const int width = 1000;
+	const int height = 1100;
+	float max_error_px = 0.0f;
+
+	for (int y = 0; y < height; y++) {
+		float v = ((float)y + 0.5f) / (float)height;
+		for (int x = 0; x < width; x++) {
+			float u = ((float)x + 0.5f) / (float)width;
+
+			for (int channel = 0; channel < 3; channel++) {
+				xrt_vec2 expected = sample_bilinear(u, v, [&](int tx, int ty) {
+					const xrt_uv_triplet &t = full[(size_t)ty * kDim + (size_t)tx];
+					return channel == 0 ? t.r : channel == 1 ? t.g : t.b;
+				});
+
+				xrt_vec2 offset = sample_bilinear(u, v, [&](int tx, int ty) {
+					size_t i = (size_t)ty * kDim + (size_t)tx;
+					const uint16_t *h = channel == 2 ? &b[i * 2] : &rg[i * 4 + channel * 2];
+					return xrt_vec2{half_to_float(h[0]), half_to_float(h[1])};
+				});
+
+				float dx = (u + offset.x - expected.x) * kSourcePixels;
+				float dy = (v + offset.y - expected.y) * kSourcePixels;
+				max_error_px = std::max(max_error_px, std::sqrt(dx * dx + dy * dy));
+			}
+		}
+	}
+
+	// Offsets stay under 0.25 so half float rounding is within 2^-14, an eighth of a pixel per axis.
+	CHECK(max_error_px < 0.2f);
+}
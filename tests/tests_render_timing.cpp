@@ -0,0 +1,128 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Per pass GPU timing resolve tests.
+ */
+
+#include "catch_amalgamated.hpp"
+
+#include "render/render_interface.h"
+
+
+namespace {
+
+struct Frame
+{
+	render_timing_scope scopes[RENDER_TIMING_MAX_SCOPES] = {};
+	uint64_t ticks[RENDER_TIMING_MAX_SCOPES * 2] = {};
+	bool available[RENDER_TIMING_MAX_SCOPES] = {};
+	uint32_t count = 0;
+
+	void
+	add(render_timing_pass pass, uint32_t layer_index, uint64_t start, uint64_t end)
+	{
+		scopes[count] = {pass, layer_index};
+		ticks[count * 2 + 0] = start;
+		ticks[count * 2 + 1] = end;
+		available[count] = true;
+		count++;
+	}
+
+	render_timing_results
+	resolve(uint32_t valid_bits, float period_ns, bool use_available = true)
+	{
+		render_timing_results res = {};
+		render_timing_resolve(scopes, count, ticks, use_available ? available : nullptr, valid_bits, period_ns,
+		                      &res);
+		return res;
+	}
+};
+
+} // namespace
+
+
+TEST_CASE("render_timing_resolve")
+{
+	Frame f;
+
+	SECTION("passes and layers are summed")
+	{
+		// Two views, layer 0 and 2 drawn in both.
+		f.add(RENDER_TIMING_PASS_LAYERS, 0, 100, 150);
+		f.add(RENDER_TIMING_PASS_LAYERS, 2, 150, 300);
+		f.add(RENDER_TIMING_PASS_LAYERS, 0, 300, 360);
+		f.add(RENDER_TIMING_PASS_LAYERS, 2, 360, 500);
+		f.add(RENDER_TIMING_PASS_DISTORTION, RENDER_TIMING_NO_LAYER, 500, 800);
+
+		render_timing_results res = f.resolve(64, 2.0f);
+
+		CHECK(res.scope_count == 5);
+		CHECK(res.layer_ns[0] == (50 + 60) * 2);
+		CHECK(res.layer_ns[1] == 0);
+		CHECK(res.layer_ns[2] == (150 + 140) * 2);
+		CHECK(res.pass_ns[RENDER_TIMING_PASS_LAYERS] == 400 * 2);
+		CHECK(res.pass_ns[RENDER_TIMING_PASS_DISTORTION] == 300 * 2);
+		CHECK(res.pass_ns[RENDER_TIMING_PASS_CLEAR] == 0);
+		CHECK(res.total_ns == 700 * 2);
+	}
+
+	SECTION("fractional period")
+	{
+		f.add(RENDER_TIMING_PASS_CLEAR, RENDER_TIMING_NO_LAYER, 0, 1000);
+
+		render_timing_results res = f.resolve(64, 0.5f);
+
+		CHECK(res.pass_ns[RENDER_TIMING_PASS_CLEAR] == 500);
+		CHECK(res.total_ns == 500);
+	}
+
+	SECTION("counter wrapping within the valid bits")
+	{
+		// 36 valid bits, wraps from near the top back to a small value.
+		uint64_t top = (UINT64_C(1) << 36) - 10;
+		f.add(RENDER_TIMING_PASS_DISTORTION, RENDER_TIMING_NO_LAYER, top, 30);
+
+		render_timing_results res = f.resolve(36, 1.0f);
+
+		CHECK(res.pass_ns[RENDER_TIMING_PASS_DISTORTION] == 40);
+	}
+
+	SECTION("bits above the valid bits are ignored")
+	{
+		uint64_t junk = UINT64_C(0xabc) << 48;
+		f.add(RENDER_TIMING_PASS_LAYERS, 1, junk | 1000, 1200);
+
+		render_timing_results res = f.resolve(48, 1.0f);
+
+		CHECK(res.layer_ns[1] == 200);
+	}
+
+	SECTION("unavailable scopes are skipped")
+	{
+		f.add(RENDER_TIMING_PASS_LAYERS, 0, 0, 100);
+		f.add(RENDER_TIMING_PASS_DISTORTION, RENDER_TIMING_NO_LAYER, 100, 400);
+		f.available[1] = false;
+
+		render_timing_results res = f.resolve(64, 1.0f);
+		CHECK(res.scope_count == 1);
+		CHECK(res.pass_ns[RENDER_TIMING_PASS_DISTORTION] == 0);
+		CHECK(res.total_ns == 100);
+
+		res = f.resolve(64, 1.0f, false);
+		CHECK(res.scope_count == 2);
+		CHECK(res.total_ns == 400);
+	}
+
+	SECTION("results are reset between frames")
+	{
+		f.add(RENDER_TIMING_PASS_LAYERS, 0, 0, 100);
+
+		render_timing_results res = f.resolve(64, 1.0f);
+		render_timing_resolve(f.scopes, f.count, f.ticks, f.available, 64, 1.0f, &res);
+
+		CHECK(res.layer_ns[0] == 100);
+		CHECK(res.total_ns == 100);
+		CHECK(res.scope_count == 1);
+	}
+}
@@ -0,0 +1,289 @@
+// Copyright 2026, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Visible span tests, checked against the masks they are made from.
+ */
+
+#include "xrt/xrt_visibility_mask.h"
+
+#include "util/u_visibility_mask.h"
+
+#include "render/render_interface.h"
+
+#include "catch_amalgamated.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+
+namespace {
+
+//! Like a typical lens, a bit taller than wide and not centred.
+constexpr xrt_fov kFov = {-0.90f, 0.78f, 0.87f, -0.92f};
+
+//! View size in pixels the spans are checked at, the same as the scratch images.
+constexpr int kWidth = 1000;
+constexpr int kHeight = 1100;
+
+struct MaskDeleter
+{
+	void
+	operator()(xrt_visibility_mask *mask) const
+	{
+		free(mask);
+	}
+};
+
+using Mask = std::unique_ptr<xrt_visibility_mask, MaskDeleter>;
+
+//! Outline of the visible area, in view UV.
+using Polygon = std::vector<xrt_vec2>;
+
+//! Ellipse touching the edges of the view, as a fan of triangles in tangent lengths.
+Mask
+make_round_mask(const xrt_fov &fov, uint32_t segments, Polygon &out_outline)
+{
+	uint32_t vertex_count = segments + 1;
+	uint32_t index_count = segments * 3;
+
+	size_t size = sizeof(xrt_visibility_mask) + sizeof(uint32_t) * index_count + sizeof(xrt_vec2) * vertex_count;
+	Mask mask((xrt_visibility_mask *)calloc(1, size));
+	mask->type = XRT_VISIBILITY_MASK_TYPE_VISIBLE_TRIANGLE_MESH;
+	mask->index_count = index_count;
+	mask->vertex_count = vertex_count;
+
+	float tan_left = std::tan(fov.angle_left);
+	float tan_right = std::tan(fov.angle_right);
+	float tan_up = std::tan(fov.angle_up);
+	float tan_down = std::tan(fov.angle_down);
+
+	xrt_vec2 *vertices = xrt_visibility_mask_get_vertices(mask.get());
+	uint32_t *indices = xrt_visibility_mask_get_indices(mask.get());
+
+	out_outline.clear();
+	vertices[0] = {(tan_left + tan_right) / 2.0f, -(tan_up + tan_down) / 2.0f};
+	for (uint32_t i = 0; i < segments; i++) {
+		float angle = (float)(2.0 * M_PI * i / segments);
+		float u = 0.5f + 0.5f * std::cos(angle);
+		float v = 0.5f + 0.5f * std::sin(angle);
+
+		// Y goes down, see u_visibility_mask.c.
+		vertices[1 + i] = {tan_left + u * (tan_right - tan_left), v * (tan_up - tan_down) - tan_up};
+		out_outline.push_back({u, v});
+
+		indices[i * 3 + 0] = 0;
+		indices[i * 3 + 1] = 1 + i;
+		indices[i * 3 + 2] = 1 + (i + 1) % segments;
+	}
+
+	return mask;
+}
+
+//! The default mask, an octagon with the corners of the view cut off.
+Mask
+make_default_mask(const xrt_fov &fov, Polygon &out_outline)
+{
+	xrt_visibility_mask *mask = nullptr;
+	u_visibility_mask_get_default(XRT_VISIBILITY_MASK_TYPE_VISIBLE_TRIANGLE_MESH, &fov, &mask);
+
+	out_outline = {
+	    {0.125f, 0.0f}, {0.875f, 0.0f}, {1.0f, 0.125f}, {1.0f, 0.875f},
+	    {0.875f, 1.0f}, {0.125f, 1.0f}, {0.0f, 0.875f}, {0.0f, 0.125f},
+	};
+
+	return Mask(mask);
+}
+
+//! Signed distance to a convex polygon, negative inside.
+float
+distance_to(const Polygon &polygon, const xrt_vec2 &p)
+{
+	// Winding of the outline, so the inside is always on the same side.
+	float area = 0.0f;
+	for (size_t i = 0; i < polygon.size(); i++) {
+		const xrt_vec2 &a = polygon[i];
+		const xrt_vec2 &b = polygon[(i + 1) % polygon.size()];
+		area += a.x * b.y - b.x * a.y;
+	}
+	float winding = area > 0.0f ? 1.0f : -1.0f;
+
+	float outside = -INFINITY;
+	for (size_t i = 0; i < polygon.size(); i++) {
+		const xrt_vec2 &a = polygon[i];
+		const xrt_vec2 &b = polygon[(i + 1) % polygon.size()];
+
+		float ex = b.x - a.x;
+		float ey = b.y - a.y;
+		float len = std::sqrt(ex * ex + ey * ey);
+
+		// Positive on the outside of this edge.
+		float d = winding * ((p.x - a.x) * ey - (p.y - a.y) * ex) / len;
+		outside = std::max(outside, d);
+	}
+
+	return outside;
+}
+
+struct Counts
+{
+	//! Pixels inside the mask that the spans hide, must be zero.
+	int wrongly_hidden = 0;
+
+	//! Pixels hidden by the spans.
+	int hidden = 0;
+
+	//! Pixels outside of the mask.
+	int outside = 0;
+};
+
+//! Walks the pixel centres of the view, like the layer squasher does.
+Counts
+count_pixels(const render_visibility_spans &spans, const Polygon &outline, float margin)
+{
+	Counts counts = {};
+
+	for (int y = 0; y < kHeight; y++) {
+		for (int x = 0; x < kWidth; x++) {
+			xrt_vec2 uv = {((float)x + 0.5f) / (float)kWidth, ((float)y + 0.5f) / (float)kHeight};
+
+			float distance = distance_to(outline, uv);
+			bool hidden = render_visibility_spans_is_hidden(&spans, &uv);
+
+			// Small slack for rounding in the float conversions.
+			if (hidden && distance < margin - 1e-4f) {
+				counts.wrongly_hidden++;
+			}
+			if (hidden) {
+				counts.hidden++;
+			}
+			if (distance > 0.0f) {
+				counts.outside++;
+			}
+		}
+	}
+
+	return counts;
+}
+
+} // namespace
+
+
+TEST_CASE("render_visibility_spans")
+{
+	render_visibility_spans spans;
+
+	SECTION("full spans hide nothing")
+	{
+		render_visibility_spans_init_full(&spans);
+
+		Polygon everything = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+		Counts counts = count_pixels(spans, everything, 0.0f);
+
+		CHECK(counts.hidden == 0);
+		CHECK(render_visibility_spans_hidden_fraction(&spans) == 0.0f);
+	}
+
+	SECTION("round lens")
+	{
+		Polygon outline;
+		Mask mask = make_round_mask(kFov, 64, outline);
+		REQUIRE(render_visibility_spans_calc(mask.get(), &kFov, 0.0f, &spans));
+
+		Counts counts = count_pixels(spans, outline, 0.0f);
+		float exact = (float)counts.outside / (float)(kWidth * kHeight);
+		float skipped = (float)counts.hidden / (float)(kWidth * kHeight);
+
+		// Never hides what the lens shows, and skips most of what it doesn't.
+		CHECK(counts.wrongly_hidden == 0);
+		CHECK(exact == Catch::Approx(1.0f - M_PI / 4.0f).margin(0.005f));
+		CHECK(skipped > exact - 0.02f);
+		CHECK(skipped <= exact);
+
+		// Which is what the work estimate says.
+		CHECK(render_visibility_spans_hidden_fraction(&spans) == Catch::Approx(skipped).margin(0.005f));
+	}
+
+	SECTION("margin grows the visible area")
+	{
+		Polygon outline;
+		Mask mask = make_round_mask(kFov, 64, outline);
+		REQUIRE(render_visibility_spans_calc(mask.get(), &kFov, RENDER_VISIBILITY_MARGIN, &spans));
+
+		Counts counts = count_pixels(spans, outline, RENDER_VISIBILITY_MARGIN);
+		float skipped = (float)counts.hidden / (float)(kWidth * kHeight);
+
+		CHECK(counts.wrongly_hidden == 0);
+		CHECK(skipped > 0.15f);
+	}
+
+	SECTION("default mask")
+	{
+		Polygon outline;
+		Mask mask = make_default_mask(kFov, outline);
+		REQUIRE(render_visibility_spans_calc(mask.get(), &kFov, 0.0f, &spans));
+
+		Counts counts = count_pixels(spans, outline, 0.0f);
+		float skipped = (float)counts.hidden / (float)(kWidth * kHeight);
+
+		// The four cut off corners are 1/32 of the view.
+		CHECK(counts.wrongly_hidden == 0);
+		CHECK(skipped > 1.0f / 32.0f - 0.01f);
+		CHECK(skipped <= 1.0f / 32.0f);
+	}
+
+	SECTION("default mask is the same for any fov")
+	{
+		Polygon outline;
+		Mask mask = make_default_mask(kFov, outline);
+		REQUIRE(render_visibility_spans_calc(mask.get(), &kFov, 0.0f, &spans));
+
+		xrt_fov symmetric = {-0.8f, 0.8f, 0.8f, -0.8f};
+		Mask other_mask = make_default_mask(symmetric, outline);
+		render_visibility_spans other;
+		REQUIRE(render_visibility_spans_calc(other_mask.get(), &symmetric, 0.0f, &other));
+
+		// Only rounding on the exact step edges differ.
+		for (uint32_t i = 0; i < RENDER_VISIBILITY_ROWS / 2; i++) {
+			for (uint32_t shift = 0; shift < 32; shift += 8) {
+				int a = (int)((spans.packed[i] >> shift) & 0xff);
+				int b = (int)((other.packed[i] >> shift) & 0xff);
+				CHECK(std::abs(a - b) <= 1);
+			}
+		}
+	}
+
+	SECTION("outside of the view is never hidden")
+	{
+		Polygon outline;
+		Mask mask = make_round_mask(kFov, 64, outline);
+		REQUIRE(render_visibility_spans_calc(mask.get(), &kFov, 0.0f, &spans));
+
+		xrt_vec2 corner = {0.01f, 0.01f};
+		CHECK(render_visibility_spans_is_hidden(&spans, &corner));
+
+		xrt_vec2 outside[4] = {{-0.01f, 0.01f}, {1.0f, 0.01f}, {0.01f, -0.01f}, {0.01f, 1.0f}};
+		for (const xrt_vec2 &uv : outside) {
+			CHECK_FALSE(render_visibility_spans_is_hidden(&spans, &uv));
+		}
+	}
+
+	SECTION("bad masks show everything")
+	{
+		Polygon outline;
+		Mask mask = make_round_mask(kFov, 8, outline);
+
+		uint32_t index_count = mask->index_count;
+		mask->index_count = 2;
+		CHECK_FALSE(render_visibility_spans_calc(mask.get(), &kFov, 0.0f, &spans));
+		CHECK(render_visibility_spans_hidden_fraction(&spans) == 0.0f);
+
+		mask->index_count = index_count;
+		xrt_visibility_mask_get_indices(mask.get())[5] = mask->vertex_count;
+		CHECK_FALSE(render_visibility_spans_calc(mask.get(), &kFov, 0.0f, &spans));
+		CHECK(render_visibility_spans_hidden_fraction(&spans) == 0.0f);
+	}
+}